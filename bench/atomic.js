@@ -0,0 +1,210 @@
+'use strict';
+
+const path = require('path');
+const {Worker, isMainThread, workerData, parentPort} = require('worker_threads');
+
+/*
+ * Atomic Scaling
+ *
+ * Every worker increments a shared 64 bit counter
+ * `ops` times. The same work is done with JS Atomics
+ * on a BigUint64Array, with N64 atomics on a single
+ * slot and with a striped counter which gives each
+ * thread its own cache line.
+ */
+
+const USAGE = `
+  Usage: node bench/atomic.js [options]
+
+  Options:
+    --backend <name>    n64 backend: native or js (default: native)
+    --workers <list>    comma separated worker counts (default: 1,2,4,8)
+    --ops <n>           increments per worker (default: 1000000)
+    -h, --help          output usage information
+`;
+
+const MODES = ['bigint', 'atomic', 'counter'];
+
+/*
+ * Worker
+ */
+
+function make(mode, U64, buffer) {
+  switch (mode) {
+    case 'bigint': {
+      const words = new BigUint64Array(buffer);
+      const one = BigInt(1);
+      return () => Atomics.add(words, 0, one);
+    }
+    case 'atomic': {
+      return () => U64.atomic.add(buffer, 0, 1);
+    }
+    case 'counter': {
+      const counter = U64.atomic.counter(buffer);
+      return () => counter.add(1);
+    }
+  }
+
+  throw new Error(`Unknown mode: ${mode}.`);
+}
+
+function work() {
+  const {mode, backend, buffer, flag, ops} = workerData;
+  const {U64} = require(path.resolve(__dirname, '..', 'lib', backend));
+  const start = new Int32Array(flag);
+
+  // Warm up on a private buffer so that the
+  // JIT is done before the clock starts.
+  const warm = make(mode, U64, new SharedArrayBuffer(buffer.byteLength));
+
+  for (let i = 0; i < 10000; i++)
+    warm();
+
+  const fn = make(mode, U64, buffer);
+
+  parentPort.postMessage('ready');
+
+  Atomics.wait(start, 0, 0);
+
+  const now = process.hrtime();
+
+  for (let i = 0; i < ops; i++)
+    fn();
+
+  const [sec, ns] = process.hrtime(now);
+
+  parentPort.postMessage(sec * 1e9 + ns);
+}
+
+/*
+ * Main
+ */
+
+function parseArgs(argv) {
+  const options = {
+    backend: 'native',
+    workers: [1, 2, 4, 8],
+    ops: 1000000
+  };
+
+  for (let i = 0; i < argv.length; i++) {
+    const arg = argv[i];
+
+    const next = () => {
+      if (i + 1 >= argv.length)
+        throw new Error(`Missing value for ${arg}.`);
+      return argv[++i];
+    };
+
+    switch (arg) {
+      case '--backend':
+        options.backend = next() === 'js' ? 'n64' : 'native';
+        break;
+      case '--workers':
+        options.workers = next().split(',').map(n => Math.max(1, n >>> 0));
+        break;
+      case '--ops':
+        options.ops = Math.max(1, Number(next()) >>> 0);
+        break;
+      case '-h':
+      case '--help':
+        process.stdout.write(USAGE + '\n');
+        process.exit(0);
+        break;
+      default:
+        throw new Error(`Unknown option: ${arg}.`);
+    }
+  }
+
+  return options;
+}
+
+function run(mode, count, options) {
+  // The striped counter needs a cache line per thread.
+  const size = mode === 'counter' ? 64 * Math.max(16, count + 1) : 64;
+  const buffer = new SharedArrayBuffer(size);
+  const flag = new SharedArrayBuffer(4);
+  const workers = [];
+
+  for (let i = 0; i < count; i++) {
+    workers.push(new Worker(__filename, {
+      workerData: {
+        mode: mode,
+        backend: options.backend,
+        buffer: buffer,
+        flag: flag,
+        ops: options.ops
+      }
+    }));
+  }
+
+  const ready = workers.map(w => new Promise((resolve, reject) => {
+    w.once('message', resolve);
+    w.once('error', reject);
+  }));
+
+  return Promise.all(ready).then(() => {
+    const done = workers.map(w => new Promise((resolve, reject) => {
+      w.once('message', resolve);
+      w.once('error', reject);
+    }));
+
+    const now = process.hrtime();
+    const start = new Int32Array(flag);
+
+    Atomics.store(start, 0, 1);
+    Atomics.notify(start, 0);
+
+    return Promise.all(done).then((times) => {
+      const [sec, ns] = process.hrtime(now);
+      const wall = sec * 1e9 + ns;
+      const words = new BigUint64Array(buffer);
+
+      let total = BigInt(0);
+
+      for (let i = 0; i < words.length; i++)
+        total += words[i];
+
+      if (total !== BigInt(count * options.ops))
+        throw new Error(`${mode}: expected ${count * options.ops}, got ${total}.`);
+
+      return Promise.all(workers.map(w => w.terminate())).then(() => ({
+        wall: wall,
+        worst: Math.max(...times)
+      }));
+    });
+  });
+}
+
+async function main() {
+  const options = parseArgs(process.argv.slice(2));
+  const pad = (str, n) => String(str).padStart(n);
+
+  process.stdout.write(`backend: ${options.backend === 'n64' ? 'js' : 'native'}`
+                     + `, ops/worker: ${options.ops}\n\n`);
+
+  process.stdout.write('mode       workers     Mops/s   ns/op/worker\n');
+
+  for (const mode of MODES) {
+    for (const count of options.workers) {
+      const {wall, worst} = await run(mode, count, options);
+      const mops = (count * options.ops) / wall * 1e3;
+      const per = worst / options.ops;
+
+      process.stdout.write(mode.padEnd(10)
+                         + pad(count, 8)
+                         + pad(mops.toFixed(2), 11)
+                         + pad(per.toFixed(2), 15)
+                         + '\n');
+    }
+  }
+}
+
+if (isMainThread) {
+  main().catch((err) => {
+    process.stderr.write(err.stack + '\n');
+    process.exit(1);
+  });
+} else {
+  work();
+}
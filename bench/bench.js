@@ -1,13 +1,198 @@
 'use strict';
 
-module.exports = function bench(name) {
-  const start = process.hrtime();
-  return function end(ops) {
-    const elapsed = process.hrtime(start);
-    const time = elapsed[0] + elapsed[1] / 1e9;
-    const rate = ops / time;
-
-    console.log('%s: ops=%d, time=%d, rate=%s',
-      name, ops, time, rate.toFixed(5));
+/*
+ * Timing
+ */
+
+function now() {
+  const [sec, nsec] = process.hrtime();
+  return sec * 1e9 + nsec;
+}
+
+function flush() {
+  // GC entries are delivered to observers
+  // asynchronously, so give them a tick.
+  return new Promise(resolve => setImmediate(resolve));
+}
+
+/*
+ * Statistics
+ */
+
+function percentile(sorted, q) {
+  // Nearest-rank: with fewer than 100 samples
+  // the p99 is simply the slowest sample.
+  const i = Math.ceil(q * sorted.length) - 1;
+  return sorted[Math.max(0, Math.min(sorted.length - 1, i))];
+}
+
+function summarize(times) {
+  const sorted = times.slice().sort((a, b) => a - b);
+  const n = sorted.length;
+
+  let sum = 0;
+  let sq = 0;
+
+  for (const t of sorted)
+    sum += t;
+
+  const mean = sum / n;
+
+  for (const t of sorted)
+    sq += (t - mean) * (t - mean);
+
+  const median = n & 1
+    ? sorted[n >>> 1]
+    : (sorted[(n >>> 1) - 1] + sorted[n >>> 1]) / 2;
+
+  return {
+    min: sorted[0],
+    max: sorted[n - 1],
+    mean: mean,
+    median: median,
+    p99: percentile(sorted, 0.99),
+    stddev: n > 1 ? Math.sqrt(sq / (n - 1)) : 0
   };
-};
+}
+
+/*
+ * Bench
+ */
+
+class Bench {
+  constructor(options) {
+    if (options == null)
+      options = {};
+
+    this.warmup = options.warmup != null ? options.warmup : 50;
+    this.time = options.time != null ? options.time : 10;
+    this.samples = options.samples != null ? options.samples : 15;
+    this.observer = null;
+    this.gcCount = 0;
+    this.gcTime = 0;
+  }
+
+  open() {
+    let perf = null;
+
+    try {
+      perf = require('perf_hooks');
+    } catch (e) {
+      return this;
+    }
+
+    if (!perf.PerformanceObserver)
+      return this;
+
+    this.observer = new perf.PerformanceObserver((list) => {
+      for (const entry of list.getEntries()) {
+        this.gcCount += 1;
+        this.gcTime += entry.duration;
+      }
+    });
+
+    try {
+      this.observer.observe({ entryTypes: ['gc'] });
+    } catch (e) {
+      this.observer = null;
+    }
+
+    return this;
+  }
+
+  close() {
+    if (this.observer) {
+      this.observer.disconnect();
+      this.observer = null;
+    }
+  }
+
+  calibrate(fn) {
+    // Find an iteration count which fills one sample
+    // window, warming up the JIT along the way.
+    const target = this.time * 1e6;
+    const start = now();
+
+    let n = 1;
+    let elapsed = 0;
+
+    for (;;) {
+      const t = now();
+      fn(n);
+      elapsed = now() - t;
+
+      if (elapsed >= target / 4 || n >= 1 << 30)
+        break;
+
+      n *= 2;
+    }
+
+    n = Math.max(1, Math.round(n * target / Math.max(elapsed, 1)));
+
+    while (now() - start < this.warmup * 1e6)
+      fn(Math.max(1, n >>> 2));
+
+    return n;
+  }
+
+  heap(fn, n) {
+    // Bytes retained per op across a short run. This
+    // is a lower bound: scavenges during the run will
+    // hide short-lived garbage.
+    const count = Math.min(n, 1000);
+
+    if (global.gc)
+      global.gc();
+
+    const before = process.memoryUsage().heapUsed;
+
+    fn(count);
+
+    const after = process.memoryUsage().heapUsed;
+
+    return Math.max(0, (after - before) / count);
+  }
+
+  async measure(fn) {
+    const n = this.calibrate(fn);
+    const times = [];
+
+    await flush();
+
+    this.gcCount = 0;
+    this.gcTime = 0;
+
+    for (let i = 0; i < this.samples; i++) {
+      const t = now();
+      fn(n);
+      times.push((now() - t) / n);
+    }
+
+    await flush();
+
+    const gcCount = this.gcCount;
+    const gcTime = this.gcTime;
+    const stats = summarize(times);
+
+    return {
+      iterations: n,
+      samples: times.length,
+      ns: stats,
+      opsPerSec: 1e9 / stats.median,
+      gc: {
+        count: gcCount,
+        time: gcTime
+      },
+      heapPerOp: this.heap(fn, n)
+    };
+  }
+}
+
+/*
+ * Expose
+ */
+
+exports.Bench = Bench;
+exports.summarize = summarize;
+exports.percentile = percentile;
+exports.now = now;
@@ -0,0 +1,1203 @@
+'use strict';
+
+const BN = require('../vendor/bn.js');
+
+/*
+ * Cases
+ *
+ * Every case is an expression evaluated once per
+ * iteration. Each one is compiled into its own
+ * function so that V8 keeps separate type feedback
+ * per case rather than sharing a megamorphic loop.
+ * The `a` operand is reloaded from a two element
+ * array every iteration so that pure operations
+ * (BigInt arithmetic in particular) cannot be
+ * hoisted out of the loop.
+ *
+ * Available bindings:
+ *   N     - constructor (U64 or I64)
+ *   a, b  - int64 operands (b is small and non-zero)
+ *   e     - exponent (3) as an int64
+ *   k     - shift amount (13) as an int64
+ *   s     - safe integer operand
+ *   t     - scratch int64 for in-place ops
+ *   x     - 32 bit number operand
+ *   d     - 8 byte buffer
+ *   view  - DataView over `d`
+ *   str   - decimal string of `a`
+ *   hex   - hex string of `a`
+ *   json  - json string of `a`
+ *   obj   - {hi, lo} of `a`
+ *   bn    - `a` as a bn.js number
+ *   rng   - RNG for the constructor
+ *   buf   - 1kb buffer
+ *   slots - 64 int64 slots in a buffer
+ *   v     - view onto `slots`
+ *   i     - iteration counter
+ */
+
+const methods = [
+  // Arithmetic
+  ['add', 'a.add(b)'],
+  ['iadd', 't.inject(a).iadd(b)'],
+  ['addn', 'a.addn(x)'],
+  ['iaddn', 't.inject(a).iaddn(x)'],
+  ['sub', 'a.sub(b)'],
+  ['isub', 't.inject(a).isub(b)'],
+  ['subn', 'a.subn(x)'],
+  ['isubn', 't.inject(a).isubn(x)'],
+  ['mul', 'a.mul(b)'],
+  ['imul', 't.inject(a).imul(b)'],
+  ['muln', 'a.muln(x)'],
+  ['imuln', 't.inject(a).imuln(x)'],
+  ['div', 'a.div(b)'],
+  ['idiv', 't.inject(a).idiv(b)'],
+  ['divn', 'a.divn(x)'],
+  ['idivn', 't.inject(a).idivn(x)'],
+  ['mod', 'a.mod(b)'],
+  ['imod', 't.inject(a).imod(b)'],
+  ['modn', 'a.modn(x)'],
+  ['imodn', 't.inject(a).imodn(x)'],
+  ['pow', 'a.pow(e)'],
+  ['ipow', 't.inject(a).ipow(e)'],
+  ['pown', 'a.pown(3)'],
+  ['ipown', 't.inject(a).ipown(3)'],
+  ['sqr', 'a.sqr()'],
+  ['isqr', 't.inject(a).isqr()'],
+  ['muldiv', 'a.mul(b).div(b)'],
+
+  // Bitwise
+  ['and', 'a.and(b)'],
+  ['iand', 't.inject(a).iand(b)'],
+  ['andn', 'a.andn(x)'],
+  ['iandn', 't.inject(a).iandn(x)'],
+  ['or', 'a.or(b)'],
+  ['ior', 't.inject(a).ior(b)'],
+  ['orn', 'a.orn(x)'],
+  ['iorn', 't.inject(a).iorn(x)'],
+  ['xor', 'a.xor(b)'],
+  ['ixor', 't.inject(a).ixor(b)'],
+  ['xorn', 'a.xorn(x)'],
+  ['ixorn', 't.inject(a).ixorn(x)'],
+  ['not', 'a.not()'],
+  ['inot', 't.inject(a).inot()'],
+  ['shl', 'a.shl(k)'],
+  ['ishl', 't.inject(a).ishl(k)'],
+  ['shln', 'a.shln(13)'],
+  ['ishln', 't.inject(a).ishln(13)'],
+  ['shr', 'a.shr(k)'],
+  ['ishr', 't.inject(a).ishr(k)'],
+  ['shrn', 'a.shrn(13)'],
+  ['ishrn', 't.inject(a).ishrn(13)'],
+  ['ushr', 'a.ushr(k)'],
+  ['iushr', 't.inject(a).iushr(k)'],
+  ['ushrn', 'a.ushrn(13)'],
+  ['iushrn', 't.inject(a).iushrn(13)'],
+  ['setn', 't.setn(13, i & 1)'],
+  ['testn', 'a.testn(13)'],
+  ['setb', 't.setb(3, 0xff)'],
+  ['orb', 't.orb(3, 0x0f)'],
+  ['getb', 'a.getb(3)'],
+  ['maskn', 'a.maskn(40)'],
+  ['imaskn', 't.inject(a).imaskn(40)'],
+  ['andln', 'a.andln(0xffff)'],
+
+  // Negation
+  ['neg', 'a.neg()'],
+  ['ineg', 't.inject(a).ineg()'],
+  ['abs', 'a.abs()'],
+  ['iabs', 't.inject(a).iabs()'],
+
+  // Comparison
+  ['cmp', 'a.cmp(b)'],
+  ['cmpn', 'a.cmpn(x)'],
+  ['eq', 'a.eq(b)'],
+  ['eqn', 'a.eqn(x)'],
+  ['gt', 'a.gt(b)'],
+  ['gtn', 'a.gtn(x)'],
+  ['gte', 'a.gte(b)'],
+  ['gten', 'a.gten(x)'],
+  ['lt', 'a.lt(b)'],
+  ['ltn', 'a.ltn(x)'],
+  ['lte', 'a.lte(b)'],
+  ['lten', 'a.lten(x)'],
+  ['isZero', 'a.isZero()'],
+  ['isNeg', 'a.isNeg()'],
+  ['isOdd', 'a.isOdd()'],
+  ['isEven', 'a.isEven()'],
+
+  // Helpers
+  ['clone', 'a.clone()'],
+  ['inject', 't.inject(a)'],
+  ['set', 't.set(0x1fffffffffffff)'],
+  ['join', 't.join(0x12345678, 0x9abcdef0)'],
+  ['bitLength', 'a.bitLength()'],
+  ['byteLength', 'a.byteLength()'],
+  ['isSafe', 'a.isSafe()'],
+  ['inspect', 'a.inspect()'],
+
+  // Encoding
+  ['readLE', 't.readLE(d, 0)'],
+  ['readBE', 't.readBE(d, 0)'],
+  ['readRaw', 't.readRaw(d, 0)'],
+  ['writeLE', 'a.writeLE(d, 0)'],
+  ['writeBE', 'a.writeBE(d, 0)'],
+  ['writeRaw', 'a.writeRaw(d, 0)'],
+
+  // Conversion
+  ['toU64', 'a.toU64()'],
+  ['toI64', 'a.toI64()'],
+  ['toNumber', 's.toNumber()'],
+  ['toDouble', 'a.toDouble()'],
+  ['toInt', 'a.toInt()'],
+  ['toBool', 'a.toBool()'],
+  ['toBits', 'a.toBits()'],
+  ['toObject', 'a.toObject()'],
+  ['toString', 'a.toString(10)'],
+  ['toString(16)', 'a.toString(16)'],
+  ['toJSON', 'a.toJSON()'],
+  ['toBN', 'a.toBN(BN)'],
+  ['toLE', 'a.toLE(Buffer)'],
+  ['toBE', 'a.toBE(Buffer)'],
+  ['toRaw', 'a.toRaw(Buffer)'],
+
+  // Decoding
+  ['fromNumber', 't.fromNumber(0x1fffffffffffff)'],
+  ['fromInt', 't.fromInt(-5)'],
+  ['fromBool', 't.fromBool(true)'],
+  ['fromBits', 't.fromBits(0x12345678, 0x9abcdef0)'],
+  ['fromObject', 't.fromObject(obj)'],
+  ['fromString', 't.fromString(str)'],
+  ['fromString(16)', 't.fromString(hex, 16)'],
+  ['fromJSON', 't.fromJSON(json)'],
+  ['fromBN', 't.fromBN(bn)'],
+  ['fromLE', 't.fromLE(d)'],
+  ['fromBE', 't.fromBE(d)'],
+  ['fromRaw', 't.fromRaw(d)'],
+  ['from', 't.from(str)'],
+
+  // Static
+  ['new', 'new N()'],
+  ['min', 'N.min(a, b)'],
+  ['max', 'N.max(a, b)'],
+  ['random', 'N.random()'],
+  ['N.pow', 'N.pow(3, 20)'],
+  ['shift', 'N.shift(1, 40)'],
+  ['N.readLE', 'N.readLE(d, 0)'],
+  ['N.fromString', 'N.fromString(str)'],
+  ['isN64', 'N.isN64(a)'],
+
+  // Views
+  ['slot.iadd', 't.readLE(slots, i << 3 & 511),'
+    + 't.iadd(b).writeLE(slots, i << 3 & 511)'],
+  ['view.iadd', 'v.seek(i << 3 & 511).iadd(b)'],
+  ['slot.iaddn', 't.readLE(slots, i << 3 & 511),'
+    + 't.iaddn(x).writeLE(slots, i << 3 & 511)'],
+  ['view.iaddn', 'v.seek(i << 3 & 511).iaddn(x)'],
+
+  // RNG
+  ['rng.next', 'rng.next(t)'],
+  ['rng.nextBelow', 'rng.nextBelow(b, t)'],
+  ['rng.fill(1k)', 'rng.fill(buf)']
+];
+
+// 128 bit cases. Each entry carries the n64, bn.js
+// and BigInt forms. bn.js and BigInt are wrapped to
+// 128 bits where the result can overflow.
+const wideMethods = [
+  ['add', 'a.add(b)', 'a.add(b).imaskn(128)', 'W(128, a + b)'],
+  ['iadd', 't.inject(a).iadd(b)', '(a.copy(t), t.iadd(b).imaskn(128))', null],
+  ['sub', 'a.sub(b)', 'a.sub(b)', 'W(128, a - b)'],
+  ['mul', 'a.mul(b)', 'a.mul(b).imaskn(128)', 'W(128, a * b)'],
+  ['imul', 't.inject(a).imul(b)', '(a.copy(t), t.imul(b).imaskn(128))', null],
+  ['muln', 'a.muln(x)', 'a.muln(x).imaskn(128)', 'W(128, a * X)'],
+  ['div', 'a.div(b)', 'a.div(b)', 'a / b'],
+  ['divn', 'a.divn(x)', 'a.divn(x)', 'a / X'],
+  ['div(64)', 'a.div(c)', 'a.div(c)', 'a / c'],
+  ['mod', 'a.mod(b)', 'a.mod(b)', 'a % b'],
+  ['muldiv', 'a.mul(b).div(b)', 'a.mul(b).imaskn(128).div(b)',
+   'W(128, a * b) / b'],
+  ['shln', 'a.shln(13)', 'a.shln(13).imaskn(128)', 'W(128, a << 13n)'],
+  ['ushrn', 'a.ushrn(13)', 'a.ushrn(13)', 'a >> 13n'],
+  ['cmp', 'a.cmp(b)', 'a.cmp(b)', 'a < b ? -1 : (a > b ? 1 : 0)'],
+  ['bitLength', 'a.bitLength()', 'a.bitLength()', null],
+  ['toDouble', 'a.toDouble()', null, 'Number(a)'],
+  ['toString', 'a.toString(10)', 'a.toString(10)', 'a.toString(10)'],
+  ['toString(16)', 'a.toString(16)', 'a.toString(16)', 'a.toString(16)'],
+  ['fromString', 'N.fromString(str)', 'new N(str, 10)', 'BigInt(str)'],
+  ['toLE', 'a.toLE(Buffer)', 'a.toArrayLike(Buffer, "le", 16)', null],
+  ['fromLE', 'N.fromLE(d)', 'new N(d, "le")', null],
+  ['toU64', 'c.toU64()', 'c.clone()', 'W(64, c)']
+];
+
+// bn.js has no fixed width, so only methods with
+// a reasonable equivalent are included. Its bitwise
+// methods require non-negative operands and are
+// skipped for I64.
+const bnUnsigned = new Set([
+  'and', 'iand', 'or', 'ior', 'xor', 'ixor', 'not', 'inot',
+  'shln', 'ishln', 'shrn', 'ishrn', 'setn', 'testn', 'maskn', 'imaskn', 'andln'
+]);
+
+const bnMethods = {
+  'add': 'a.add(b)',
+  'iadd': '(a.copy(t), t.iadd(b))',
+  'addn': 'a.addn(x)',
+  'iaddn': '(a.copy(t), t.iaddn(x))',
+  'sub': 'a.sub(b)',
+  'isub': '(a.copy(t), t.isub(b))',
+  'subn': 'a.subn(x)',
+  'isubn': '(a.copy(t), t.isubn(x))',
+  'mul': 'a.mul(b)',
+  'imul': '(a.copy(t), t.imul(b))',
+  'muln': 'a.muln(x)',
+  'imuln': '(a.copy(t), t.imuln(x))',
+  'div': 'a.div(b)',
+  'divn': 'a.divn(x)',
+  'mod': 'a.mod(b)',
+  'modn': 'a.modn(x)',
+  'pow': 'a.pow(e)',
+  'sqr': 'a.sqr()',
+  'isqr': '(a.copy(t), t.isqr())',
+  'muldiv': 'a.mul(b).div(b)',
+  'and': 'a.and(b)',
+  'iand': '(a.copy(t), t.iand(b))',
+  'or': 'a.or(b)',
+  'ior': '(a.copy(t), t.ior(b))',
+  'xor': 'a.xor(b)',
+  'ixor': '(a.copy(t), t.ixor(b))',
+  'not': 'a.notn(64)',
+  'inot': '(a.copy(t), t.inotn(64))',
+  'shln': 'a.shln(13)',
+  'ishln': '(a.copy(t), t.ishln(13))',
+  'shrn': 'a.shrn(13)',
+  'ishrn': '(a.copy(t), t.ishrn(13))',
+  'setn': 't.setn(13, i & 1)',
+  'testn': 'a.testn(13)',
+  'maskn': 'a.maskn(40)',
+  'imaskn': '(a.copy(t), t.imaskn(40))',
+  'andln': 'a.andln(0xffff)',
+  'neg': 'a.neg()',
+  'ineg': '(a.copy(t), t.ineg())',
+  'abs': 'a.abs()',
+  'iabs': '(a.copy(t), t.iabs())',
+  'cmp': 'a.cmp(b)',
+  'cmpn': 'a.cmpn(x)',
+  'eq': 'a.eq(b)',
+  'eqn': 'a.eqn(x)',
+  'gt': 'a.gt(b)',
+  'gtn': 'a.gtn(x)',
+  'gte': 'a.gte(b)',
+  'gten': 'a.gten(x)',
+  'lt': 'a.lt(b)',
+  'ltn': 'a.ltn(x)',
+  'lte': 'a.lte(b)',
+  'lten': 'a.lten(x)',
+  'isZero': 'a.isZero()',
+  'isNeg': 'a.isNeg()',
+  'isOdd': 'a.isOdd()',
+  'isEven': 'a.isEven()',
+  'clone': 'a.clone()',
+  'inject': 'a.copy(t)',
+  'bitLength': 'a.bitLength()',
+  'byteLength': 'a.byteLength()',
+  'toNumber': 's.toNumber()',
+  'toString': 'a.toString(10)',
+  'toString(16)': 'a.toString(16)',
+  'toJSON': 'a.toJSON()',
+  'toLE': 'a.toArrayLike(Buffer, "le", 8)',
+  'toBE': 'a.toArrayLike(Buffer, "be", 8)',
+  'fromNumber': 'new N(0x1fffffffffffff)',
+  'fromString': 'new N(str, 10)',
+  'fromString(16)': 'new N(hex, 16)',
+  'fromLE': 'new N(d, "le")',
+  'fromBE': 'new N(d, "be")',
+  'new': 'new N()'
+};
+
+// Native BigInts are immutable, so in-place
+// variants map to their allocating forms.
+const bigMethods = {
+  'add': 'W(64, a + b)',
+  'addn': 'W(64, a + x)',
+  'sub': 'W(64, a - b)',
+  'subn': 'W(64, a - x)',
+  'mul': 'W(64, a * b)',
+  'muln': 'W(64, a * x)',
+  'div': 'a / b',
+  'divn': 'a / x',
+  'mod': 'a % b',
+  'modn': 'a % x',
+  'pow': 'W(64, a ** e)',
+  'sqr': 'W(64, a * a)',
+  'muldiv': 'W(64, a * b) / b',
+  'and': 'a & b',
+  'andn': 'a & x',
+  'or': 'a | b',
+  'orn': 'W(64, a | x)',
+  'xor': 'a ^ b',
+  'xorn': 'W(64, a ^ x)',
+  'not': 'W(64, ~a)',
+  'shl': 'W(64, a << k)',
+  'shln': 'W(64, a << 13n)',
+  'shr': 'a >> k',
+  'shrn': 'a >> 13n',
+  'ushr': 'BigInt.asUintN(64, a) >> k',
+  'ushrn': 'BigInt.asUintN(64, a) >> 13n',
+  'testn': '((a >> 13n) & 1n) !== 0n',
+  'maskn': 'W(40, a)',
+  'andln': 'Number(a & 0xffffn)',
+  'neg': 'W(64, -a)',
+  'abs': 'a < 0n ? W(64, -a) : a',
+  'cmp': 'a < b ? -1 : (a > b ? 1 : 0)',
+  'eq': 'a === b',
+  'gt': 'a > b',
+  'gte': 'a >= b',
+  'lt': 'a < b',
+  'lte': 'a <= b',
+  'isZero': 'a === 0n',
+  'isNeg': 'a < 0n',
+  'isOdd': '(a & 1n) === 1n',
+  'isEven': '(a & 1n) === 0n',
+  'readLE': 'R.call(view, 0, true)',
+  'readBE': 'R.call(view, 0, false)',
+  'writeLE': 'S.call(view, 0, a, true)',
+  'writeBE': 'S.call(view, 0, a, false)',
+  'toNumber': 'Number(s)',
+  'toDouble': 'Number(a)',
+  'toInt': 'Number(BigInt.asIntN(32, a))',
+  'toBool': 'a !== 0n',
+  'toString': 'a.toString(10)',
+  'toString(16)': 'a.toString(16)',
+  'toJSON': 'BigInt.asUintN(64, a).toString(16).padStart(16, "0")',
+  'fromNumber': 'BigInt(0x1fffffffffffff)',
+  'fromInt': 'W(64, BigInt(-5))',
+  'fromString': 'BigInt(str)',
+  'fromString(16)': 'BigInt("0x" + hex)',
+  'random': 'W(64, (BigInt(Math.random() * 0x100000000 >>> 0) << 32n)'
+          + ' | BigInt(Math.random() * 0x100000000 >>> 0))'
+};
+
+/*
+ * Compilation
+ */
+
+function compile(expr, ctx) {
+  const names = Object.keys(ctx)
+    .filter(name => name !== 'a' && name !== 'pair')
+    .join(', ');
+
+  ctx.pair = [ctx.a, ctx.a];
+
+  // eslint-disable-next-line no-new-func
+  const make = new Function('ctx', `
+    const {pair, ${names}} = ctx;
+    return function run(n) {
+      let r = null;
+      for (let i = 0; i < n; i++) {
+        const a = pair[i & 1];
+        r = ${expr};
+      }
+      ctx.sink = r;
+    };
+  `);
+
+  return make(ctx);
+}
+
+/*
+ * Backends
+ */
+
+function n64Cases(lib, backend) {
+  const cases = [];
+
+  for (const type of ['U64', 'I64']) {
+    const N = lib[type];
+    const a = type === 'U64'
+      ? N.fromBits(0x12345678, 0x9abcdef0)
+      : N.fromBits(0xedcba987, 0x65432110);
+
+    const ctx = {
+      BN: BN,
+      N: N,
+      a: a,
+      b: N.fromInt(0x1234567),
+      e: N.fromInt(3),
+      k: N.fromInt(13),
+      s: N.fromNumber(0x1fffffffffffff),
+      t: new N(),
+      x: 0x1234567,
+      d: a.toLE(Buffer),
+      str: a.toString(10),
+      hex: a.toString(16),
+      json: a.toJSON(),
+      obj: a.toObject(),
+      bn: a.toBN(BN),
+      rng: N.rng ? N.rng(1) : null,
+      buf: Buffer.alloc(1024),
+      slots: null,
+      v: null,
+      sink: null
+    };
+
+    ctx.slots = Buffer.alloc(8 * 64);
+    ctx.v = N.view ? N.view(ctx.slots) : null;
+
+    for (const [method, expr] of methods) {
+      // The BigInt backend has no views or RNG.
+      if (method.startsWith('view.') && !ctx.v)
+        continue;
+
+      if (method.startsWith('rng.') && !ctx.rng)
+        continue;
+
+      cases.push({
+        name: `${type}#${method}`,
+        backend: backend,
+        fn: compile(expr, ctx)
+      });
+    }
+  }
+
+  if (lib.Dec64) {
+    const D = lib.Dec64;
+    const ctx = {
+      D: D,
+      a: D.fromString('1234567.89'),
+      b: D.fromString('1.0825'),
+      str: '1234567.89',
+      sink: null
+    };
+
+    const decimals = [
+      ['add', 'a.add(b)'],
+      ['mul', 'a.mul(b)'],
+      ['div', 'a.div(b)'],
+      ['rescale', 'a.rescale(1)'],
+      ['cmp', 'a.cmp(b)'],
+      ['toString', 'a.toString()'],
+      ['fromString', 'D.fromString(str)']
+    ];
+
+    for (const [method, expr] of decimals) {
+      cases.push({
+        name: `Dec64#${method}`,
+        backend: backend,
+        fn: compile(expr, ctx)
+      });
+    }
+  }
+
+  if (lib.U64Array) {
+    const A = lib.U64Array;
+    const U = lib.U64;
+    const ctx = {
+      A: A,
+      a: U.fromBits(0x12345678, 0x9abcdef0),
+      t: new U(),
+      arr: new A(1024),
+      list: [],
+      fill: (arr, a) => {
+        for (let j = 0; j < 1024; j++)
+          arr.push(a);
+        return arr;
+      },
+      clones: (list, a) => {
+        for (let j = 0; j < 1024; j++)
+          list.push(a.clone());
+        return list;
+      },
+      sink: null
+    };
+
+    for (let j = 0; j < 1024; j++)
+      ctx.list.push(new U());
+
+    // Plain arrays of U64 objects are the baseline.
+    const arrays = [
+      ['get', 'arr.get(i & 1023, t)'],
+      ['get(alloc)', 'arr.get(i & 1023)'],
+      ['list.get', 't.inject(list[i & 1023])'],
+      ['set', 'arr.set(i & 1023, a)'],
+      ['list.set', 'list[i & 1023].inject(a)'],
+      ['push(1k)', 'fill(new A(), a)'],
+      ['list.push(1k)', 'clones([], a)']
+    ];
+
+    for (const [method, expr] of arrays) {
+      cases.push({
+        name: `U64Array#${method}`,
+        backend: backend,
+        fn: compile(expr, ctx)
+      });
+    }
+  }
+
+  if (lib.U64Array && lib.U64.tryFromString) {
+    const U = lib.U64;
+    const rng = U.rng(1);
+    const ctx = {
+      A: lib.U64Array,
+      t: new U(),
+      fields: [],
+      nums: [],
+      catching: (t, fields) => {
+        let bad = 0;
+        for (let j = 0; j < fields.length; j++) {
+          try {
+            t.fromString(fields[j]);
+          } catch (e) {
+            bad += 1;
+          }
+        }
+        return bad;
+      },
+      trying: (t, fields) => {
+        let bad = 0;
+        for (let j = 0; j < fields.length; j++) {
+          if (!t.tryFromString(fields[j]))
+            bad += 1;
+        }
+        return bad;
+      },
+      converting: (nums) => {
+        let bad = 0;
+        for (let j = 0; j < nums.length; j++) {
+          try {
+            nums[j].toNumber();
+          } catch (e) {
+            bad += 1;
+          }
+        }
+        return bad;
+      },
+      tryConverting: (nums) => {
+        let bad = 0;
+        for (let j = 0; j < nums.length; j++) {
+          if (nums[j].tryToNumber() !== nums[j].tryToNumber())
+            bad += 1;
+        }
+        return bad;
+      },
+      sink: null
+    };
+
+    // 1k fields of which one in twenty is malformed.
+    for (let j = 0; j < 1024; j++) {
+      const num = rng.next();
+      const str = num.toString(10);
+
+      if (j % 20 === 0) {
+        ctx.fields.push(str.slice(0, 5) + 'x' + str.slice(6));
+        ctx.nums.push(num);
+      } else {
+        ctx.fields.push(str);
+        ctx.nums.push(num.iushrn(12));
+      }
+    }
+
+    const dirty = [
+      ['fromString(1k)', 'catching(t, fields)'],
+      ['tryFromString(1k)', 'trying(t, fields)'],
+      ['U64Array.parse(1k)', 'A.parse(fields)'],
+      ['toNumber(1k)', 'converting(nums)'],
+      ['tryToNumber(1k)', 'tryConverting(nums)']
+    ];
+
+    for (const [method, expr] of dirty) {
+      cases.push({
+        name: `Dirty#${method}`,
+        backend: backend,
+        fn: compile(expr, ctx)
+      });
+    }
+  }
+
+  if (lib.N64.bswap64) {
+    const U = lib.U64;
+    const src = Buffer.alloc(8 * 1024 + 1).subarray(1);
+    const ctx = {
+      N: lib.N64,
+      t: new U(),
+      src: src,
+      dst: Buffer.alloc(src.length),
+      hi: new Int32Array(1024),
+      lo: new Int32Array(1024),
+      swapping: (t, src, dst) => {
+        for (let j = 0; j < 1024; j++) {
+          t.readBE(src, j * 8);
+          t.writeLE(dst, j * 8);
+        }
+        return dst;
+      },
+      splitting: (t, src, hi, lo) => {
+        for (let j = 0; j < 1024; j++) {
+          t.readLE(src, j * 8);
+          hi[j] = t.hi;
+          lo[j] = t.lo;
+        }
+        return hi;
+      },
+      joining: (t, dst, hi, lo) => {
+        for (let j = 0; j < 1024; j++)
+          t.fromBits(hi[j], lo[j]).writeLE(dst, j * 8);
+        return dst;
+      },
+      sink: null
+    };
+
+    U.rng(1).fill(src);
+
+    // 1k words, from an unaligned slice.
+    const bulk = [
+      ['readBE/writeLE(1k)', 'swapping(t, src, dst)'],
+      ['bswap64(1k)', 'N.bswap64(dst, src)'],
+      ['bswap64(1k, in place)', 'N.bswap64(dst)'],
+      ['readLE/hi/lo(1k)', 'splitting(t, src, hi, lo)'],
+      ['split(1k)', 'N.split(hi, lo, src)'],
+      ['fromBits/writeLE(1k)', 'joining(t, dst, hi, lo)'],
+      ['join(1k)', 'N.join(dst, hi, lo)']
+    ];
+
+    for (const [method, expr] of bulk) {
+      cases.push({
+        name: `Bulk#${method}`,
+        backend: backend,
+        fn: compile(expr, ctx)
+      });
+    }
+  }
+
+  if (lib.I64.toFloat64) {
+    const I = lib.I64;
+    const rng = I.rng(2);
+    const src = Buffer.alloc(8 * 1024);
+    const ctx = {
+      I: I,
+      t: new I(),
+      src: src,
+      dst: Buffer.alloc(src.length),
+      out: new Float64Array(1024),
+      safe: new Float64Array(1024),
+      narrowing: (t, src, out) => {
+        for (let j = 0; j < 1024; j++) {
+          t.readLE(src, j * 8);
+          out[j] = t.toDouble();
+        }
+        return out;
+      },
+      widening: (t, out, dst) => {
+        for (let j = 0; j < 1024; j++)
+          t.fromNumber(out[j]).writeLE(dst, j * 8);
+        return dst;
+      },
+      sink: null
+    };
+
+    // Mostly safe values: one in eight is unsafe.
+    for (let j = 0; j < 1024; j++)
+      rng.next().ishrn(j & 7 ? 12 : 0).writeLE(src, j * 8);
+
+    for (let j = 0; j < 1024; j++)
+      ctx.safe[j] = rng.next().ishrn(12).toDouble();
+
+    const float64 = [
+      ['readLE/toDouble(1k)', 'narrowing(t, src, out)'],
+      ['toFloat64(1k)', 'I.toFloat64(out, src)'],
+      ['toFloat64(1k, half even)', 'I.toFloat64(out, src, 6)'],
+      ['toFloat64(1k, half up)', 'I.toFloat64(out, src, 4)'],
+      ['fromNumber/writeLE(1k)', 'widening(t, safe, dst)'],
+      ['fromFloat64(1k)', 'I.fromFloat64(dst, safe)'],
+      ['fromFloat64(1k, down)', 'I.fromFloat64(dst, out, 0)']
+    ];
+
+    for (const [method, expr] of float64) {
+      cases.push({
+        name: `Float64#${method}`,
+        backend: backend,
+        fn: compile(expr, ctx)
+      });
+    }
+  }
+
+  if (lib.I64.dot) {
+    const I = lib.I64;
+    const rng = I.rng(3);
+    const a = Buffer.alloc(8 * 1024);
+    const b = Buffer.alloc(8 * 1024);
+    const ctx = {
+      I: I,
+      a: a,
+      b: b,
+      dst: Buffer.alloc(8 * 1024),
+      m: a.subarray(0, 8 * 32 * 32),
+      x: b.subarray(0, 8 * 32),
+      t: new I(),
+      u: new I(),
+      v: new I(),
+      k: I.fromInt(-3),
+      summing: (t, u, v, a, b) => {
+        t.fromInt(0);
+        for (let j = 0; j < 1024; j++) {
+          u.readLE(a, j * 8);
+          v.readLE(b, j * 8);
+          t.iadd(u.imul(v));
+        }
+        return t;
+      },
+      scaling: (u, v, k, dst, x) => {
+        for (let j = 0; j < 1024; j++) {
+          u.readLE(x, j * 8);
+          v.readLE(dst, j * 8);
+          v.iadd(u.imul(k)).writeLE(dst, j * 8);
+        }
+        return dst;
+      },
+      sink: null
+    };
+
+    // Small values, so the per-element loop
+    // computes the same thing without wrapping.
+    for (let j = 0; j < 1024; j++) {
+      rng.next().ishrn(40).writeLE(a, j * 8);
+      rng.next().ishrn(40).writeLE(b, j * 8);
+    }
+
+    const linear = [
+      ['imul/iadd(1k)', 'summing(t, u, v, a, b)'],
+      ['dot(1k)', 'I.dot(a, b)'],
+      ['readLE/imul/writeLE(1k)', 'scaling(u, v, k, dst, b)'],
+      ['axpy(1k)', 'I.axpy(dst, k, b)'],
+      ['matvec(32x32)', 'I.matvec(dst, m, x)']
+    ];
+
+    for (const [method, expr] of linear) {
+      cases.push({
+        name: `Linear#${method}`,
+        backend: backend,
+        fn: compile(expr, ctx)
+      });
+    }
+  }
+
+  if (lib.U64.math) {
+    const N = lib.U64;
+    const rng = N.rng(7);
+    const a = Buffer.alloc(1024 * 8);
+    const b = Buffer.alloc(1024 * 8);
+
+    rng.fill(a);
+    rng.fill(b);
+
+    const ctx = {
+      N: N,
+      a: a,
+      b: b,
+      q: Buffer.alloc(1024 * 8),
+      rem: Buffer.alloc(1024 * 8),
+      l: new Int32Array(1024),
+      x: N.readLE(a, 0),
+      y: N.readLE(b, 0).ishrn(20),
+      sink: null
+    };
+
+    const math = [
+      ['sqrt', 'x.sqrt()'],
+      ['cbrt', 'x.cbrt()'],
+      ['log10', 'x.log10()'],
+      ['gcd', 'x.gcd(y)'],
+      ['divmod', 'x.divmod(y)'],
+      ['math.sqrt(1k)', 'N.math.sqrt(q, a)'],
+      ['math.log10(1k)', 'N.math.log10(l, a)'],
+      ['math.gcd(1k)', 'N.math.gcd(q, a, b)'],
+      ['math.divmod(1k)', 'N.math.divmod(q, rem, a, b)']
+    ];
+
+    for (const [method, expr] of math) {
+      cases.push({
+        name: `Math#${method}`,
+        backend: backend,
+        fn: compile(expr, ctx)
+      });
+    }
+  }
+
+  if (lib.U64.where) {
+    const N = lib.I64;
+    const rng = lib.U64.rng(8);
+    const d = Buffer.alloc(1024 * 8);
+
+    rng.fill(d);
+
+    const ctx = {
+      N: N,
+      N64: lib.N64,
+      d: d,
+      lo: N.readLE(d, 0).ishrn(1),
+      hi: N.readLE(d, 8).ishrn(1).iabs(),
+      set: [N.readLE(d, 16), N.readLE(d, 24), 1, 2, 3, 4, 5, 6],
+      bits: Buffer.alloc(1024 / 8),
+      sel: new Uint32Array(1024),
+      out: Buffer.alloc(1024 * 8),
+      t: new N(),
+      // What callers write by hand today.
+      scanning: (t, d, lo, hi) => {
+        let n = 0;
+        for (let j = 0; j < 1024; j++) {
+          t.readLE(d, j * 8);
+          if (t.gte(lo) && t.lte(hi))
+            n += 1;
+        }
+        return n;
+      },
+      sink: null
+    };
+
+    const where = [
+      ['readLE/gte/lte(1k)', 'scanning(t, d, lo, hi)'],
+      ['countWhere(1k)', 'N.countWhere(d, "between", lo, hi)'],
+      ['where(bitmap,1k)', 'N.where(bits, d, "between", lo, hi)'],
+      ['where(selection,1k)', 'N.where(sel, d, "between", lo, hi)'],
+      ['where(in,1k)', 'N.where(bits, d, "in", set)'],
+      ['compact(1k)', 'N64.compact(out, d, bits)']
+    ];
+
+    for (const [method, expr] of where) {
+      cases.push({
+        name: `Where#${method}`,
+        backend: backend,
+        fn: compile(expr, ctx)
+      });
+    }
+  }
+
+  if (lib.U64.serializeJSON) {
+    const N = lib.U64;
+    const rng = N.rng(12);
+    const d = Buffer.alloc(1024 * 8);
+
+    rng.fill(d);
+
+    const arr = lib.U64Array.fromBuffer(d);
+    const json = N.serializeJSON(d);
+
+    const ctx = {
+      N: N,
+      d: d,
+      arr: arr,
+      json: json,
+      text: json.toString(),
+      num: N.readLE(d, 0),
+      buf: Buffer.alloc(32),
+      // What callers write by hand today.
+      stringify: arr => JSON.stringify(arr.toArray()),
+      parse: (N, text) => JSON.parse(text).map(s => N.fromString(s, 16)),
+      sink: null
+    };
+
+    const formats = [
+      ['JSON.stringify(1k)', 'stringify(arr)'],
+      ['serializeJSON(1k)', 'N.serializeJSON(d)'],
+      ['JSON.parse(1k)', 'parse(N, text)'],
+      ['parseJSON(1k)', 'N.parseJSON(json)'],
+      ['toString(10)', 'num.toString(10)'],
+      ['writeDecimal', 'num.writeDecimal(buf, 0)']
+    ];
+
+    for (const [method, expr] of formats) {
+      cases.push({
+        name: `JSON#${method}`,
+        backend: backend,
+        fn: compile(expr, ctx)
+      });
+    }
+  }
+
+  if (lib.U64.histogram) {
+    const N = lib.U64;
+    const rng = N.rng(9);
+    const d = Buffer.alloc(1024 * 8);
+    const v = new Float64Array(1024);
+
+    // Nanosecond latencies below one second.
+    for (let i = 0; i < 1024; i++) {
+      const x = rng.nextBelow(1e9);
+      x.writeLE(d, i * 8);
+      v[i] = x.toNumber();
+    }
+
+    const ctx = {
+      h: N.histogram({ highest: 3600e9, significantDigits: 3 }),
+      d: d,
+      v: v,
+      s: new Float64Array(1024),
+      t: new N(),
+      x: N.readLE(d, 0),
+      ranking: (s, v) => {
+        s.set(v);
+        s.sort();
+        return s[(s.length * 0.99) | 0];
+      },
+      sink: null
+    };
+
+    const histogram = [
+      ['record', 'h.record(x)'],
+      ['recordMany(1k)', 'h.recordMany(d)'],
+      ['percentile', 'h.percentile(99, t)'],
+      ['reset/recordMany/percentile(1k)',
+       'h.reset().recordMany(d) && h.percentile(99, t)'],
+      ['sort/pick(1k)', 'ranking(s, v)']
+    ];
+
+    for (const [method, expr] of histogram) {
+      cases.push({
+        name: `Histogram#${method}`,
+        backend: backend,
+        fn: compile(expr, ctx)
+      });
+    }
+  }
+
+  if (lib.struct) {
+    const s = lib.struct([
+      { name: 'ts', type: 'i64be' },
+      { name: 'id', type: 'u64' },
+      { name: 'qty', type: 'i32' },
+      { name: 'side', type: 'u8' },
+      { type: 'pad', size: 3 }
+    ]);
+
+    const d = Buffer.alloc(1024 * s.size);
+
+    lib.U64.rng(11).fill(d);
+
+    const ctx = {
+      s: s,
+      d: d,
+      o: s.create(),
+      cols: s.decodeMany(d),
+      out: Buffer.alloc(d.length),
+      // What callers write by hand today.
+      manual: (d, off) => {
+        return {
+          ts: lib.I64.readBE(d, off),
+          id: lib.U64.readLE(d, off + 8),
+          qty: d.readInt32LE(off + 16),
+          side: d[off + 20]
+        };
+      },
+      sink: null
+    };
+
+    const struct = [
+      ['decode', 's.decode(d, 64, o)'],
+      ['manual', 'manual(d, 64)'],
+      ['encode', 's.encode(o, out, 64)'],
+      ['decodeMany(1k)', 's.decodeMany(d)'],
+      ['encodeMany(1k)', 's.encodeMany(cols, out)']
+    ];
+
+    for (const [method, expr] of struct) {
+      cases.push({
+        name: `Struct#${method}`,
+        backend: backend,
+        fn: compile(expr, ctx)
+      });
+    }
+  }
+
+  if (lib.U128) {
+    const U = lib.U128;
+    const a = U.fromString('123456789abcdef0fedcba9876543210', 16);
+
+    const ctx = {
+      N: U,
+      a: a,
+      b: U.fromString('1234567890abcdef1', 16),
+      c: U.fromString('123456789abcdef', 16),
+      t: new U(),
+      x: 0x1234567,
+      d: a.toLE(Buffer),
+      str: a.toString(10),
+      sink: null
+    };
+
+    for (const [method, expr] of wideMethods) {
+      cases.push({
+        name: `U128#${method}`,
+        backend: backend,
+        fn: compile(expr, ctx)
+      });
+    }
+  }
+
+  return cases;
+}
+
+function bnCases() {
+  const cases = [];
+
+  for (const type of ['U64', 'I64']) {
+    const a = type === 'U64'
+      ? new BN('123456789abcdef0', 16)
+      : new BN('-123456789abcdef0', 16);
+
+    const ctx = {
+      N: BN,
+      a: a,
+      b: new BN(0x1234567),
+      e: new BN(3),
+      s: new BN(0x1fffffffffffff),
+      t: new BN(0),
+      x: 0x1234567,
+      d: a.abs().toArrayLike(Buffer, 'le', 8),
+      str: a.toString(10),
+      hex: a.abs().toString(16),
+      sink: null
+    };
+
+    for (const [method] of methods) {
+      const expr = bnMethods[method];
+
+      if (!expr)
+        continue;
+
+      if (type === 'I64' && bnUnsigned.has(method))
+        continue;
+
+      cases.push({
+        name: `${type}#${method}`,
+        backend: 'bn.js',
+        fn: compile(expr, ctx)
+      });
+    }
+  }
+
+  {
+    const a = new BN('123456789abcdef0fedcba9876543210', 16);
+
+    const ctx = {
+      N: BN,
+      a: a,
+      b: new BN('1234567890abcdef1', 16),
+      c: new BN('123456789abcdef', 16),
+      t: new BN(0),
+      x: 0x1234567,
+      d: a.toArrayLike(Buffer, 'le', 16),
+      str: a.toString(10),
+      sink: null
+    };
+
+    for (const [method, , expr] of wideMethods) {
+      if (!expr)
+        continue;
+
+      cases.push({
+        name: `U128#${method}`,
+        backend: 'bn.js',
+        fn: compile(expr, ctx)
+      });
+    }
+  }
+
+  return cases;
+}
+
+function bigintCases() {
+  const cases = [];
+
+  if (typeof BigInt !== 'function')
+    return cases;
+
+  for (const type of ['U64', 'I64']) {
+    const W = type === 'U64' ? BigInt.asUintN : BigInt.asIntN;
+    const a = type === 'U64'
+      ? BigInt('0x123456789abcdef0')
+      : -BigInt('0x123456789abcdef0');
+
+    const d = Buffer.alloc(8);
+    const view = new DataView(d.buffer, d.byteOffset, 8);
+    const proto = DataView.prototype;
+
+    const ctx = {
+      W: W,
+      R: type === 'U64' ? proto.getBigUint64 : proto.getBigInt64,
+      S: type === 'U64' ? proto.setBigUint64 : proto.setBigInt64,
+      a: a,
+      b: BigInt(0x1234567),
+      e: BigInt(3),
+      k: BigInt(13),
+      s: BigInt(0x1fffffffffffff),
+      x: BigInt(0x1234567),
+      view: view,
+      str: a.toString(10),
+      hex: W(64, a).toString(16).replace('-', ''),
+      sink: null
+    };
+
+    for (const [method] of methods) {
+      const expr = bigMethods[method];
+
+      if (!expr)
+        continue;
+
+      cases.push({
+        name: `${type}#${method}`,
+        backend: 'bigint',
+        fn: compile(expr, ctx)
+      });
+    }
+  }
+
+  {
+    const a = BigInt('0x123456789abcdef0fedcba9876543210');
+
+    const ctx = {
+      W: BigInt.asUintN,
+      a: a,
+      b: BigInt('0x1234567890abcdef1'),
+      c: BigInt('0x123456789abcdef'),
+      X: BigInt(0x1234567),
+      str: a.toString(10),
+      sink: null
+    };
+
+    for (const [method, , , expr] of wideMethods) {
+      if (!expr)
+        continue;
+
+      cases.push({
+        name: `U128#${method}`,
+        backend: 'bigint',
+        fn: compile(expr, ctx)
+      });
+    }
+  }
+
+  return cases;
+}
+
+/*
+ * Expose
+ */
+
+exports.backends = ['native', 'js', 'js-bigint', 'bn.js', 'bigint'];
+
+exports.load = function load(backend) {
+  switch (backend) {
+    case 'native':
+      return n64Cases(require('../lib/native'), 'native');
+    case 'js':
+      return n64Cases(require('../lib/n64'), 'js');
+    case 'js-bigint':
+      return n64Cases(require('../lib/bigint'), 'js-bigint');
+    case 'bn.js':
+      return bnCases();
+    case 'bigint':
+      return bigintCases();
+  }
+
+  throw new Error(`Unknown backend: ${backend}.`);
+};
@@ -0,0 +1,187 @@
+'use strict';
+
+const path = require('path');
+
+/*
+ * Column Parsing
+ *
+ * Parses one int64 column out of a generated CSV
+ * file: by splitting lines in JS and calling
+ * fromString per cell, and with parseColumn on one
+ * and on several threads. One record in fifty is
+ * malformed. Each mode is run a few times and the
+ * best run is reported.
+ */
+
+const USAGE = `
+  Usage: node bench/column.js [options]
+
+  Options:
+    --backend <name>    n64 backend: native or js (default: native)
+    --rows <list>       comma separated row counts (default: 1000,100000,1000000)
+    --threads <list>    comma separated thread counts (default: 1,2,4)
+    --base <n>          base of the parsed column (default: 10)
+    --runs <n>          runs per mode (default: 5)
+    -h, --help          output usage information
+`;
+
+/*
+ * Modes
+ */
+
+function split(n64, data, base) {
+  // What we'd write without parseColumn.
+  const lines = data.toString('latin1').split('\n');
+  const array = new n64.U64Array();
+  const num = new n64.U64();
+
+  let invalid = 0;
+
+  if (lines[lines.length - 1] === '')
+    lines.pop();
+
+  for (const line of lines) {
+    const cell = line.split(',')[2];
+
+    try {
+      array.push(num.fromString(cell, base));
+    } catch (e) {
+      array.push(num.set(0));
+      invalid += 1;
+    }
+  }
+
+  return invalid;
+}
+
+function column(n64, data, base, threads) {
+  return n64.U64.parseColumn(data, {
+    column: 2,
+    base: base,
+    threads: threads
+  }).invalid;
+}
+
+/*
+ * Main
+ */
+
+function parseArgs(argv) {
+  const options = {
+    backend: 'native',
+    rows: [1000, 100000, 1000000],
+    threads: [1, 2, 4],
+    base: 10,
+    runs: 5
+  };
+
+  for (let i = 0; i < argv.length; i++) {
+    const arg = argv[i];
+    const next = () => {
+      if (i + 1 >= argv.length)
+        throw new Error(`Missing value for ${arg}.`);
+      return argv[++i];
+    };
+
+    switch (arg) {
+      case '--backend':
+        options.backend = next() === 'js' ? 'n64' : 'native';
+        break;
+      case '--rows':
+        options.rows = next().split(',').map(n => Math.max(1, n >>> 0));
+        break;
+      case '--threads':
+        options.threads = next().split(',').map(n => Math.max(1, n >>> 0));
+        break;
+      case '--base':
+        options.base = next() >>> 0;
+        break;
+      case '--runs':
+        options.runs = Math.max(1, Number(next()) >>> 0);
+        break;
+      case '-h':
+      case '--help':
+        process.stdout.write(USAGE + '\n');
+        process.exit(0);
+        break;
+      default:
+        throw new Error(`Unknown option: ${arg}.`);
+    }
+  }
+
+  return options;
+}
+
+function generate(n64, rows, base) {
+  const rng = n64.U64.rng(1);
+  const lines = [];
+
+  for (let i = 0; i < rows; i++) {
+    const cell = rng.next().toString(base);
+    const bad = i % 50 === 0 ? 'z' : '';
+
+    lines.push(`${i},user${i & 1023},${cell}${bad},${i * 3}`);
+  }
+
+  return Buffer.from(lines.join('\n') + '\n', 'latin1');
+}
+
+function time(fn, runs) {
+  let best = Infinity;
+  let result = 0;
+
+  for (let i = 0; i < runs; i++) {
+    const now = process.hrtime();
+
+    result = fn();
+
+    const [sec, ns] = process.hrtime(now);
+
+    best = Math.min(best, sec * 1e9 + ns);
+  }
+
+  return [best, result];
+}
+
+function main() {
+  const options = parseArgs(process.argv.slice(2));
+  const n64 = require(path.resolve(__dirname, '..', 'lib', options.backend));
+  const pad = (str, n) => String(str).padStart(n);
+
+  process.stdout.write(`backend: ${options.backend === 'n64' ? 'js' : 'native'}`
+                     + `, base: ${options.base}\n\n`);
+
+  process.stdout.write('mode              rows        ms     MB/s   Mrows/s\n');
+
+  for (const rows of options.rows) {
+    const data = generate(n64, rows, options.base);
+    const expect = Math.ceil(rows / 50);
+    const modes = [['split', () => split(n64, data, options.base)]];
+
+    for (const threads of options.threads) {
+      modes.push([`column(${threads})`,
+                  () => column(n64, data, options.base, threads)]);
+    }
+
+    for (const [name, fn] of modes) {
+      const [ns, invalid] = time(fn, options.runs);
+
+      if (invalid !== expect)
+        throw new Error(`${name}: expected ${expect} bad rows, got ${invalid}.`);
+
+      process.stdout.write(name.padEnd(12)
+                         + pad(rows, 10)
+                         + pad((ns / 1e6).toFixed(2), 10)
+                         + pad((data.length / ns * 1e3).toFixed(1), 9)
+                         + pad((rows / ns * 1e3).toFixed(2), 10)
+                         + '\n');
+    }
+  }
+}
+
+try {
+  main();
+} catch (err) {
+  process.stderr.write(err.stack + '\n');
+  process.exit(1);
+}
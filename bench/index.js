@@ -1,209 +1,275 @@
 'use strict';
 
-const bench = require('./bench');
-const Native = require('../lib/native').U64;
-const N64 = require('../lib/n64').U64;
-const BN = require('../vendor/bn.js');
-
-function addn(N, name) {
-  const end = bench('addn (' + name + ')');
-  const A = new BN(0);
-
-  for (let i = 0; i < 1000000; i++) {
-    const a = A.clone();
-    for (let j = 0; j < 5; j++)
-      a.iaddn(0x3ffffff);
+const fs = require('fs');
+const {Bench} = require('./bench');
+const cases = require('./cases');
+
+/*
+ * Options
+ */
+
+const USAGE = `
+  Usage: node bench [options] [filter]
+
+  Options:
+    --backend <list>    comma separated backends (default: ${cases.backends})
+    --samples <n>       samples per case (default: 15)
+    --time <ms>         target time per sample (default: 10)
+    --warmup <ms>       warmup time per case (default: 50)
+    --json <file>       write results as json ("-" for stdout)
+    --compare <file>    compare against a saved json baseline
+    --threshold <pct>   regression threshold for --compare (default: 10)
+    --list              list cases and exit
+    -h, --help          output usage information
+
+  The filter is a regular expression matched against case
+  names, e.g. \`node bench '^U64#(i?div|toString)'\`.
+
+  Run node with --expose-gc for more accurate heap figures.
+`;
+
+function parseArgs(argv) {
+  const options = {
+    backends: cases.backends.slice(),
+    samples: 15,
+    time: 10,
+    warmup: 50,
+    json: null,
+    compare: null,
+    threshold: 10,
+    list: false,
+    filter: null
+  };
+
+  for (let i = 0; i < argv.length; i++) {
+    const arg = argv[i];
+
+    const next = () => {
+      if (i + 1 >= argv.length)
+        throw new Error(`Missing value for ${arg}.`);
+      return argv[++i];
+    };
+
+    switch (arg) {
+      case '--backend':
+        options.backends = next().split(',');
+        break;
+      case '--samples':
+        options.samples = Math.max(1, Number(next()) >>> 0);
+        break;
+      case '--time':
+        options.time = Number(next());
+        break;
+      case '--warmup':
+        options.warmup = Number(next());
+        break;
+      case '--json':
+        options.json = next();
+        break;
+      case '--compare':
+        options.compare = next();
+        break;
+      case '--threshold':
+        options.threshold = Number(next());
+        break;
+      case '--list':
+        options.list = true;
+        break;
+      case '-h':
+      case '--help':
+        process.stdout.write(USAGE + '\n');
+        process.exit(0);
+        break;
+      default:
+        if (arg[0] === '-')
+          throw new Error(`Unknown option: ${arg}.`);
+        options.filter = new RegExp(arg);
+        break;
+    }
   }
 
-  end(1000000 * 5);
+  return options;
 }
 
-function add(N, name) {
-  const end = bench('add (' + name + ')');
-  const A = new N(0);
-  const B = new N(0x100000000);
+/*
+ * Formatting
+ */
 
-  for (let i = 0; i < 1000000; i++) {
-    const a = A.clone();
-    const b = B.clone();
-    for (let j = 0; j < 5; j++)
-      a.iadd(b);
-  }
-
-  end(1000000 * 5);
-}
-
-function muln(N, name) {
-  const end = bench('muln (' + name + ')');
-  const A = new N(1);
-
-  for (let i = 0; i < 1000000; i++) {
-    const a = A.clone();
-    for (let j = 0; j < 3; j++)
-      a.imuln(0xffffff);
-  }
-
-  end(1000000 * 3);
-}
-
-function mul(N, name) {
-  const end = bench('mul (' + name + ')');
-  const A = new N(0);
-  const B = new N(0xffffff);
+function pad(str, width, right) {
+  str = String(str);
 
-  for (let i = 0; i < 1000000; i++) {
-    const a = A.clone();
-    const b = B.clone();
-    for (let j = 0; j < 3; j++)
-      a.imul(b);
-  }
+  while (str.length < width)
+    str = right ? str + ' ' : ' ' + str;
 
-  end(1000000 * 3);
+  return str;
 }
 
-function divn(N, name) {
-  const end = bench('divn (' + name + ')');
-  const A = new N('ffffffffffffffff', 16);
-
-  for (let i = 0; i < 1000000; i++) {
-    const a = A.clone();
-    for (let j = 0; j < 2; j++)
-      a.idivn(0xffffff);
-  }
-
-  end(1000000 * 2);
+function fixed(num, digits) {
+  return num.toFixed(digits);
 }
 
-function div(N, name) {
-  const end = bench('div (' + name + ')');
-  const A = new N('ffffffffffffffff', 16);
-  const B = new N(0xffffff);
-
-  for (let i = 0; i < 1000000; i++) {
-    let a = A.clone();
-    const b = B.clone();
-    for (let j = 0; j < 2; j++)
-      a = a.div(b);
-  }
-
-  end(1000000 * 2);
+function log(json, ...args) {
+  // Keep stdout clean when it carries the json.
+  if (json === '-')
+    console.error(...args);
+  else
+    console.log(...args);
 }
 
-function modn(N, name) {
-  if (!N.prototype.imodn)
-    return;
-
-  const end = bench('modn (' + name + ')');
-  const A = new N('ffffffffffffffff', 16);
-
-  for (let i = 0; i < 1000000; i++) {
-    const a = A.clone();
-    for (let j = 0; j < 2; j++)
-      a.imodn(0xffffff);
-  }
-
-  end(1000000 * 2);
+function header(options) {
+  log(options.json,
+      '%s %s %s %s %s %s %s',
+      pad('case', 24, true),
+      pad('backend', 9, true),
+      pad('median ns', 11),
+      pad('p99 ns', 11),
+      pad('ops/sec', 14),
+      pad('gc', 6),
+      pad('heap B/op', 10));
 }
 
-function mod(N, name) {
-  const end = bench('mod (' + name + ')');
-  const A = new N('ffffffffffffffff', 16);
-  const B = new N(0xffffff);
-
-  for (let i = 0; i < 1000000; i++) {
-    const a = A.clone();
-    const b = B.clone();
-    for (let j = 0; j < 2; j++)
-      a.mod(b);
-  }
-
-  end(1000000 * 2);
+function report(options, result) {
+  log(options.json,
+      '%s %s %s %s %s %s %s',
+      pad(result.name, 24, true),
+      pad(result.backend, 9, true),
+      pad(fixed(result.ns.median, 2), 11),
+      pad(fixed(result.ns.p99, 2), 11),
+      pad(fixed(result.opsPerSec, 0), 14),
+      pad(result.gc.count, 6),
+      pad(fixed(result.heapPerOp, 1), 10));
 }
 
-function muldiv(N, name) {
-  const end = bench('muldiv (' + name + ')');
-  const ten = new N(10);
-
-  let n = new N(10);
-
-  for (let i = 0; i < 1000000; i++) {
-    n.imul(ten);
-    n = n.div(ten);
-  }
+/*
+ * Comparison
+ */
 
-  end(1000000 * 2);
-}
+function compare(options, results) {
+  const baseline = JSON.parse(fs.readFileSync(options.compare, 'utf8'));
+  const map = new Map();
+  const threshold = options.threshold / 100;
 
-function muldivn(N, name) {
-  const end = bench('muldivn (' + name + ')');
-  const n = new N(10);
+  let regressions = 0;
+  let improvements = 0;
 
-  for (let i = 0; i < 1000000; i++) {
-    n.imuln(10);
-    n.idivn(10);
-  }
+  for (const result of baseline.results)
+    map.set(`${result.name} ${result.backend}`, result);
 
-  end(1000000 * 2);
-}
+  log(options.json, '');
+  log(options.json, 'Comparing against %s (threshold %d%%):',
+      options.compare, options.threshold);
 
-function run() {
-  addn(N64, 'js');
-  addn(Native, 'native');
-  addn(BN, 'bn.js');
+  for (const result of results) {
+    const base = map.get(`${result.name} ${result.backend}`);
 
-  console.log('--');
+    if (!base)
+      continue;
 
-  add(N64, 'js');
-  add(Native, 'native');
-  add(BN, 'bn.js');
+    const ratio = result.ns.median / base.ns.median;
 
-  console.log('--');
+    let status = null;
 
-  muln(N64, 'js');
-  muln(Native, 'native');
-  muln(BN, 'bn.js');
+    if (ratio > 1 + threshold) {
+      status = 'REGRESSION';
+      regressions += 1;
+    } else if (ratio < 1 - threshold) {
+      status = 'improvement';
+      improvements += 1;
+    }
 
-  console.log('--');
+    result.baseline = {
+      median: base.ns.median,
+      ratio: ratio
+    };
 
-  mul(N64, 'js');
-  mul(Native, 'native');
-  mul(BN, 'bn.js');
+    if (!status)
+      continue;
 
-  console.log('--');
+    log(options.json, '  %s %s %s -> %s ns (%sx) %s',
+        pad(result.name, 24, true),
+        pad(result.backend, 9, true),
+        fixed(base.ns.median, 2),
+        fixed(result.ns.median, 2),
+        fixed(ratio, 2),
+        status);
+  }
 
-  divn(N64, 'js');
-  divn(Native, 'native');
-  divn(BN, 'bn.js');
+  log(options.json, '%d regression(s), %d improvement(s).',
+      regressions, improvements);
 
-  console.log('--');
+  return regressions;
+}
 
-  div(N64, 'js');
-  div(Native, 'native');
-  div(BN, 'bn.js');
+/*
+ * Main
+ */
 
-  console.log('--');
+async function main() {
+  const options = parseArgs(process.argv.slice(2));
+  const bench = new Bench(options);
+  const results = [];
 
-  modn(N64, 'js');
-  modn(Native, 'native');
-  modn(BN, 'bn.js');
+  let all = [];
 
-  console.log('--');
+  for (const backend of options.backends)
+    all = all.concat(cases.load(backend));
 
-  mod(N64, 'js');
-  mod(Native, 'native');
-  mod(BN, 'bn.js');
+  if (options.filter)
+    all = all.filter(c => options.filter.test(c.name));
 
-  console.log('--');
+  if (options.list) {
+    for (const c of all)
+      console.log('%s (%s)', c.name, c.backend);
+    return;
+  }
 
-  muldiv(N64, 'js');
-  muldiv(Native, 'native');
-  muldiv(BN, 'bn.js');
+  bench.open();
+  header(options);
+
+  try {
+    for (const c of all) {
+      const result = Object.assign({
+        name: c.name,
+        backend: c.backend
+      }, await bench.measure(c.fn));
+
+      report(options, result);
+      results.push(result);
+    }
+  } finally {
+    bench.close();
+  }
 
-  console.log('--');
+  let regressions = 0;
+
+  if (options.compare)
+    regressions = compare(options, results);
+
+  if (options.json) {
+    const json = JSON.stringify({
+      version: 1,
+      date: new Date().toISOString(),
+      node: process.version,
+      platform: `${process.platform}-${process.arch}`,
+      options: {
+        samples: options.samples,
+        time: options.time,
+        warmup: options.warmup
+      },
+      results: results
+    }, null, 2);
+
+    if (options.json === '-')
+      process.stdout.write(json + '\n');
+    else
+      fs.writeFileSync(options.json, json + '\n');
+  }
 
-  muldivn(N64, 'js');
-  muldivn(Native, 'native');
-  muldivn(BN, 'bn.js');
+  if (regressions > 0)
+    process.exitCode = 1;
 }
 
-run();
+main().catch((err) => {
+  console.error(err.stack);
+  process.exit(1);
+});
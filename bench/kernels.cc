@@ -0,0 +1,677 @@
+/**
+ * kernels.cc - standalone benchmark for the n64 core kernels.
+ * Copyright (c) 2017, Christopher Jeffrey (MIT License)
+ *
+ * Times the routines in src/core.cc without V8 so that the
+ * cost of the arithmetic can be told apart from the cost of
+ * crossing the binding. Build with:
+ *
+ *   $ node-gyp rebuild -- -Dn64_bench=true
+ *   $ ./build/Release/n64_bench [filter]
+ *
+ * Cycle counts come from the TSC where available. Note that
+ * the TSC ticks at a constant reference rate, which differs
+ * from the core clock when frequency scaling is active.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_TSC 1
+#endif
+
+#include "../src/core.h"
+#include "../src/cpu.h"
+
+#define COUNT 4096
+#define MASK (COUNT - 1)
+#define SAMPLES 15
+#define SAMPLE_NS 20000000.0
+
+/*
+ * Inputs
+ */
+
+static uint64_t values[COUNT];
+static uint64_t divisors[COUNT];
+static uint64_t small[COUNT];
+static char dec_str[COUNT][N64_STR_SIZE];
+static char hex_str[COUNT][N64_STR_SIZE];
+static size_t dec_len[COUNT];
+static size_t hex_len[COUNT];
+static int64_t dec_val[COUNT];
+static uint32_t dec_scale[COUNT];
+static char dec_text[COUNT][DEC64_STR_SIZE];
+static size_t dec_text_len[COUNT];
+static uint8_t fill_buf[8192];
+static uint8_t bulk_src[COUNT * 8 + 1];
+static uint8_t bulk_dst[COUNT * 8 + 1];
+static int32_t bulk_hi[COUNT];
+static int32_t bulk_lo[COUNT];
+static rng_t rng;
+
+static volatile uint64_t sink;
+
+// Read on every op so the compiler cannot fold
+// the sign, as was the case for the bindings
+// before U64 and I64 were specialized.
+static volatile int runtime_sign = 1;
+
+static void
+init(void) {
+  rng_t r;
+
+  rng_seed(&r, 1);
+  rng_seed(&rng, 2);
+
+  for (size_t i = 0; i < COUNT; i++) {
+    values[i] = rng_next(&r);
+    divisors[i] = rng_next(&r) >> (rng_next(&r) & 63);
+    small[i] = (rng_next(&r) & 0xffffffff) | 1;
+
+    if (divisors[i] == 0)
+      divisors[i] = 1;
+
+    dec_len[i] = n64_write(dec_str[i], values[i], 0, 10, 0);
+    hex_len[i] = n64_write(hex_str[i], values[i], 0, 16, 0);
+
+    // Keep magnitudes modest so that products fit.
+    dec_val[i] = (int64_t)(rng_next(&r) >> 34) - (1ll << 29);
+    dec_scale[i] = (uint32_t)(rng_next(&r) % 7);
+    dec_text_len[i] = dec_format(dec_text[i], dec_val[i], dec_scale[i]);
+  }
+
+  rng_fill(&r, bulk_src, sizeof(bulk_src));
+}
+
+/*
+ * Kernels
+ */
+
+static size_t
+k_write_dec(size_t n) {
+  char buf[N64_STR_SIZE];
+  size_t r = 0;
+
+  for (size_t i = 0; i < n; i++)
+    r += n64_write(buf, values[i & MASK], 0, 10, 0);
+
+  sink = r;
+  return n;
+}
+
+static size_t
+k_write_dec_signed(size_t n) {
+  char buf[N64_STR_SIZE];
+  size_t r = 0;
+
+  for (size_t i = 0; i < n; i++)
+    r += n64_write(buf, values[i & MASK], 1, 10, 0);
+
+  sink = r;
+  return n;
+}
+
+static size_t
+k_write_hex(size_t n) {
+  char buf[N64_STR_SIZE];
+  size_t r = 0;
+
+  for (size_t i = 0; i < n; i++)
+    r += n64_write(buf, values[i & MASK], 0, 16, 0);
+
+  sink = r;
+  return n;
+}
+
+static size_t
+k_write_bin(size_t n) {
+  char buf[N64_STR_SIZE];
+  size_t r = 0;
+
+  for (size_t i = 0; i < n; i++)
+    r += n64_write(buf, values[i & MASK], 0, 2, 0);
+
+  sink = r;
+  return n;
+}
+
+static size_t
+k_read_dec(size_t n) {
+  uint64_t r = 0;
+  uint64_t x;
+
+  for (size_t i = 0; i < n; i++) {
+    n64_read(&x, dec_str[i & MASK], dec_len[i & MASK], 10);
+    r += x;
+  }
+
+  sink = r;
+  return n;
+}
+
+static size_t
+k_read_hex(size_t n) {
+  uint64_t r = 0;
+  uint64_t x;
+
+  for (size_t i = 0; i < n; i++) {
+    n64_read(&x, hex_str[i & MASK], hex_len[i & MASK], 16);
+    r += x;
+  }
+
+  sink = r;
+  return n;
+}
+
+static size_t
+k_div_u64(size_t n) {
+  uint64_t r = 0;
+
+  for (size_t i = 0; i < n; i++)
+    r += n64_div(values[i & MASK], divisors[i & MASK], 0);
+
+  sink = r;
+  return n;
+}
+
+static size_t
+k_div_i64(size_t n) {
+  uint64_t r = 0;
+
+  for (size_t i = 0; i < n; i++)
+    r += n64_div(values[i & MASK], divisors[i & MASK], 1);
+
+  sink = r;
+  return n;
+}
+
+static size_t
+k_div_u32(size_t n) {
+  uint64_t r = 0;
+
+  for (size_t i = 0; i < n; i++)
+    r += n64_div(values[i & MASK], small[i & MASK], 0);
+
+  sink = r;
+  return n;
+}
+
+static size_t
+k_mod_u64(size_t n) {
+  uint64_t r = 0;
+
+  for (size_t i = 0; i < n; i++)
+    r += n64_mod(values[i & MASK], divisors[i & MASK], 0);
+
+  sink = r;
+  return n;
+}
+
+static size_t
+k_pow(size_t n) {
+  uint64_t r = 0;
+
+  for (size_t i = 0; i < n; i++)
+    r += n64_pow(values[i & MASK], 13);
+
+  sink = r;
+  return n;
+}
+
+static size_t
+k_cmp(size_t n) {
+  int64_t r = 0;
+
+  for (size_t i = 0; i < n; i++)
+    r += n64_cmp(values[i & MASK], divisors[i & MASK], 1);
+
+  sink = (uint64_t)r;
+  return n;
+}
+
+static size_t
+k_sign_cmp(size_t n) {
+  int64_t r = 0;
+
+  for (size_t i = 0; i < n; i++)
+    r += n64_cmp(values[i & MASK], divisors[i & MASK], runtime_sign);
+
+  sink = (uint64_t)r;
+  return n;
+}
+
+static size_t
+k_sign_div(size_t n) {
+  uint64_t r = 0;
+
+  for (size_t i = 0; i < n; i++)
+    r += n64_div(values[i & MASK], divisors[i & MASK], runtime_sign);
+
+  sink = r;
+  return n;
+}
+
+static size_t
+k_sign_bitlen(size_t n) {
+  uint64_t r = 0;
+
+  for (size_t i = 0; i < n; i++)
+    r += n64_bitlen(divisors[i & MASK], runtime_sign);
+
+  sink = r;
+  return n;
+}
+
+static size_t
+k_sign_safe(size_t n) {
+  uint64_t r = 0;
+
+  for (size_t i = 0; i < n; i++)
+    r += n64_is_safe(divisors[i & MASK], runtime_sign);
+
+  sink = r;
+  return n;
+}
+
+static size_t
+k_bitlen(size_t n) {
+  uint64_t r = 0;
+
+  for (size_t i = 0; i < n; i++)
+    r += n64_bitlen(divisors[i & MASK], 0);
+
+  sink = r;
+  return n;
+}
+
+static size_t
+k_is_safe(size_t n) {
+  uint64_t r = 0;
+
+  for (size_t i = 0; i < n; i++)
+    r += n64_is_safe(divisors[i & MASK], 1);
+
+  sink = r;
+  return n;
+}
+
+static size_t
+k_rng_next(size_t n) {
+  uint64_t r = 0;
+
+  for (size_t i = 0; i < n; i++)
+    r += rng_next(&rng);
+
+  sink = r;
+  return n;
+}
+
+static size_t
+k_rng_below(size_t n) {
+  uint64_t r = 0;
+
+  for (size_t i = 0; i < n; i++)
+    r += rng_below(&rng, small[i & MASK]);
+
+  sink = r;
+  return n;
+}
+
+static size_t
+k_rng_fill(size_t n) {
+  // One op is one 64 bit word.
+  size_t words = sizeof(fill_buf) / 8;
+  size_t calls = n / words + 1;
+
+  for (size_t i = 0; i < calls; i++)
+    rng_fill(&rng, fill_buf, sizeof(fill_buf));
+
+  sink = fill_buf[0];
+  return calls * words;
+}
+
+static size_t
+k_dec_add(size_t n) {
+  int64_t r = 0;
+  int64_t x;
+  uint32_t s;
+
+  for (size_t i = 0; i < n; i++) {
+    size_t j = i & MASK;
+    size_t k = (i + 1) & MASK;
+    dec_add(dec_val[j], dec_scale[j], dec_val[k], dec_scale[k], 0, &x, &s);
+    r += x;
+  }
+
+  sink = (uint64_t)r;
+  return n;
+}
+
+static size_t
+k_dec_mul(size_t n) {
+  int64_t r = 0;
+  int64_t x;
+
+  for (size_t i = 0; i < n; i++) {
+    size_t j = i & MASK;
+    size_t k = (i + 1) & MASK;
+    dec_mul(dec_val[j], dec_val[k], dec_scale[k], ROUND_HALF_EVEN, &x);
+    r += x;
+  }
+
+  sink = (uint64_t)r;
+  return n;
+}
+
+static size_t
+k_dec_div(size_t n) {
+  int64_t r = 0;
+  int64_t x;
+
+  for (size_t i = 0; i < n; i++) {
+    size_t j = i & MASK;
+    size_t k = (i + 1) & MASK;
+
+    if (dec_val[k] == 0)
+      continue;
+
+    dec_div(dec_val[j], dec_val[k], dec_scale[k], ROUND_HALF_EVEN, &x);
+    r += x;
+  }
+
+  sink = (uint64_t)r;
+  return n;
+}
+
+static size_t
+k_dec_rescale(size_t n) {
+  int64_t r = 0;
+  int64_t x;
+
+  for (size_t i = 0; i < n; i++) {
+    size_t j = i & MASK;
+    dec_rescale(dec_val[j], dec_scale[j], 2, ROUND_HALF_EVEN, &x);
+    r += x;
+  }
+
+  sink = (uint64_t)r;
+  return n;
+}
+
+static size_t
+k_dec_format(size_t n) {
+  char buf[DEC64_STR_SIZE];
+  size_t r = 0;
+
+  for (size_t i = 0; i < n; i++)
+    r += dec_format(buf, dec_val[i & MASK], dec_scale[i & MASK]);
+
+  sink = r;
+  return n;
+}
+
+static size_t
+k_dec_parse(size_t n) {
+  int64_t r = 0;
+  int64_t x;
+
+  for (size_t i = 0; i < n; i++) {
+    size_t j = i & MASK;
+    int32_t scale = -1;
+    dec_parse(dec_text[j], dec_text_len[j], &scale, ROUND_HALF_EVEN, &x);
+    r += x;
+  }
+
+  sink = (uint64_t)r;
+  return n;
+}
+
+// The bulk kernels run over a buffer of COUNT words
+// at an odd offset, as for a Buffer slice. The plain
+// loops are what the bindings would otherwise do
+// (and what the compiler makes of them).
+
+// Keeps repeated passes over the same buffer from
+// being folded into one.
+static inline void
+clobber(void) {
+#if defined(__GNUC__)
+  __asm__ __volatile__("" ::: "memory");
+#endif
+}
+
+static size_t
+k_bswap64(size_t n) {
+  size_t calls = n / COUNT + 1;
+
+  for (size_t i = 0; i < calls; i++)
+    n64_bswap64(bulk_dst + 1, bulk_src + 1, COUNT);
+
+  sink = bulk_dst[1];
+  return calls * COUNT;
+}
+
+static size_t
+k_bswap64_inplace(size_t n) {
+  size_t calls = n / COUNT + 1;
+
+  for (size_t i = 0; i < calls; i++)
+    n64_bswap64(bulk_dst + 1, bulk_dst + 1, COUNT);
+
+  sink = bulk_dst[1];
+  return calls * COUNT;
+}
+
+static size_t
+k_bswap64_loop(size_t n) {
+  size_t calls = n / COUNT + 1;
+
+  for (size_t i = 0; i < calls; i++) {
+    for (size_t j = 0; j < COUNT; j++) {
+      const uint8_t *s = bulk_src + 1 + j * 8;
+      uint8_t *d = bulk_dst + 1 + j * 8;
+
+      for (int k = 0; k < 8; k++)
+        d[k] = s[7 - k];
+    }
+
+    clobber();
+  }
+
+  sink = bulk_dst[1];
+  return calls * COUNT;
+}
+
+static size_t
+k_split(size_t n) {
+  size_t calls = n / COUNT + 1;
+
+  for (size_t i = 0; i < calls; i++)
+    n64_split(bulk_hi, bulk_lo, bulk_src + 1, COUNT);
+
+  sink = (uint64_t)bulk_hi[0];
+  return calls * COUNT;
+}
+
+static size_t
+k_split_loop(size_t n) {
+  size_t calls = n / COUNT + 1;
+
+  for (size_t i = 0; i < calls; i++) {
+    for (size_t j = 0; j < COUNT; j++) {
+      uint64_t x;
+      memcpy(&x, bulk_src + 1 + j * 8, 8);
+      bulk_lo[j] = (int32_t)x;
+      bulk_hi[j] = (int32_t)(x >> 32);
+    }
+
+    clobber();
+  }
+
+  sink = (uint64_t)bulk_hi[0];
+  return calls * COUNT;
+}
+
+static size_t
+k_join(size_t n) {
+  size_t calls = n / COUNT + 1;
+
+  for (size_t i = 0; i < calls; i++)
+    n64_join(bulk_dst + 1, bulk_hi, bulk_lo, COUNT);
+
+  sink = bulk_dst[1];
+  return calls * COUNT;
+}
+
+static size_t
+k_join_loop(size_t n) {
+  size_t calls = n / COUNT + 1;
+
+  for (size_t i = 0; i < calls; i++) {
+    for (size_t j = 0; j < COUNT; j++) {
+      uint64_t x = ((uint64_t)(uint32_t)bulk_hi[j] << 32) | (uint32_t)bulk_lo[j];
+      memcpy(bulk_dst + 1 + j * 8, &x, 8);
+    }
+
+    clobber();
+  }
+
+  sink = bulk_dst[1];
+  return calls * COUNT;
+}
+
+/*
+ * Harness
+ */
+
+typedef size_t (*kernel_t)(size_t n);
+
+struct bench_s {
+  const char *name;
+  kernel_t kernel;
+};
+
+static const bench_s benches[] = {
+  { "format/dec", k_write_dec },
+  { "format/dec-signed", k_write_dec_signed },
+  { "format/hex", k_write_hex },
+  { "format/bin", k_write_bin },
+  { "parse/dec", k_read_dec },
+  { "parse/hex", k_read_hex },
+  { "div/u64", k_div_u64 },
+  { "div/i64", k_div_i64 },
+  { "div/u64-by-u32", k_div_u32 },
+  { "mod/u64", k_mod_u64 },
+  { "bit/pow", k_pow },
+  { "bit/cmp", k_cmp },
+  { "bit/bitlen", k_bitlen },
+  { "bit/is-safe", k_is_safe },
+  { "sign/cmp-runtime", k_sign_cmp },
+  { "sign/div-runtime", k_sign_div },
+  { "sign/bitlen-runtime", k_sign_bitlen },
+  { "sign/is-safe-runtime", k_sign_safe },
+  { "batch/rng-next", k_rng_next },
+  { "batch/rng-below", k_rng_below },
+  { "batch/rng-fill", k_rng_fill },
+  { "batch/dec-add", k_dec_add },
+  { "batch/dec-mul", k_dec_mul },
+  { "batch/dec-div", k_dec_div },
+  { "batch/dec-rescale", k_dec_rescale },
+  { "batch/dec-format", k_dec_format },
+  { "batch/dec-parse", k_dec_parse },
+  { "bulk/bswap64", k_bswap64 },
+  { "bulk/bswap64-inplace", k_bswap64_inplace },
+  { "bulk/bswap64-loop", k_bswap64_loop },
+  { "bulk/split", k_split },
+  { "bulk/split-loop", k_split_loop },
+  { "bulk/join", k_join },
+  { "bulk/join-loop", k_join_loop }
+};
+
+static inline double
+now_ns(void) {
+  using namespace std::chrono;
+  return (double)duration_cast<nanoseconds>(
+    steady_clock::now().time_since_epoch()).count();
+}
+
+static inline uint64_t
+now_cycles(void) {
+#ifdef HAVE_TSC
+  return __rdtsc();
+#else
+  return 0;
+#endif
+}
+
+static void
+run(const bench_s *b) {
+  double ns[SAMPLES];
+  double cycles[SAMPLES];
+  size_t n = 1024;
+
+  // Calibrate (and warm up) until one
+  // run fills the sample window.
+  for (;;) {
+    double start = now_ns();
+    b->kernel(n);
+    double elapsed = now_ns() - start;
+
+    if (elapsed >= SAMPLE_NS || n >= ((size_t)1 << 34))
+      break;
+
+    n *= 2;
+  }
+
+  for (int i = 0; i < SAMPLES; i++) {
+    double start = now_ns();
+    uint64_t c0 = now_cycles();
+    size_t ops = b->kernel(n);
+    uint64_t c1 = now_cycles();
+    double elapsed = now_ns() - start;
+
+    ns[i] = elapsed / (double)ops;
+    cycles[i] = (double)(c1 - c0) / (double)ops;
+  }
+
+  std::sort(ns, ns + SAMPLES);
+  std::sort(cycles, cycles + SAMPLES);
+
+#ifdef HAVE_TSC
+  printf("%-22s %10.2f %10.2f %10.2f\n",
+         b->name, ns[SAMPLES / 2], ns[SAMPLES - 1], cycles[SAMPLES / 2]);
+#else
+  printf("%-22s %10.2f %10.2f %10s\n",
+         b->name, ns[SAMPLES / 2], ns[SAMPLES - 1], "-");
+#endif
+}
+
+int
+main(int argc, char **argv) {
+  const char *filter = argc > 1 ? argv[1] : NULL;
+  const char *scalar = getenv("N64_FORCE_SCALAR");
+
+  n64_cpu_init(scalar != NULL && scalar[0] != '\0'
+               && strcmp(scalar, "0") != 0);
+  init();
+
+  printf("kernels: %s (format: %s)\n\n", n64_cpu()->path, n64_cpu()->format);
+
+  printf("%-22s %10s %10s %10s\n", "kernel", "ns/op", "max ns", "cycles/op");
+
+  for (size_t i = 0; i < sizeof(benches) / sizeof(benches[0]); i++) {
+    if (filter && strstr(benches[i].name, filter) == NULL)
+      continue;
+
+    run(&benches[i]);
+  }
+
+  return 0;
+}
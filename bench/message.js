@@ -0,0 +1,235 @@
+'use strict';
+
+const path = require('path');
+const {Worker, isMainThread, workerData, parentPort} = require('worker_threads');
+
+/*
+ * Message Throughput
+ *
+ * The main thread posts `messages` batches of `size`
+ * values to a worker, which decodes every batch and
+ * replies to the `null` which follows the last one.
+ * Lists of values are sent as JSON and serialized;
+ * arrays are serialized (one copy) and transferred
+ * (none). Arrays are built before the clock starts,
+ * since a transferred array is gone once sent.
+ */
+
+const USAGE = `
+  Usage: node bench/message.js [options]
+
+  Options:
+    --backend <name>    n64 backend: native or js (default: native)
+    --size <list>       comma separated batch sizes (default: 1,100,10000)
+    --messages <n>      batches per run (default: 1000)
+    -h, --help          output usage information
+`;
+
+const MODES = ['json', 'list', 'array', 'transfer'];
+
+/*
+ * Codecs
+ */
+
+function source(mode, n64, items) {
+  if (mode === 'array' || mode === 'transfer')
+    return n64.U64Array.from(items);
+  return items;
+}
+
+function encode(mode, n64, value) {
+  switch (mode) {
+    case 'json': {
+      return [JSON.stringify(value.map(num => num.toJSON())), []];
+    }
+    case 'list':
+    case 'array': {
+      // Transferring costs more than copying a few bytes.
+      const data = n64.serialize(value);
+      return [data, data.length > 4096 ? [data.buffer] : []];
+    }
+    case 'transfer': {
+      const buffer = value.transfer();
+      return [buffer, [buffer]];
+    }
+  }
+
+  throw new Error(`Unknown mode: ${mode}.`);
+}
+
+function decode(mode, n64, msg) {
+  switch (mode) {
+    case 'json':
+      return JSON.parse(msg).map(str => n64.U64.fromJSON(str));
+    case 'list':
+    case 'array':
+      return n64.deserialize(msg);
+    case 'transfer':
+      return n64.U64Array.fromBuffer(msg);
+  }
+
+  throw new Error(`Unknown mode: ${mode}.`);
+}
+
+function checksum(n64, items) {
+  const sum = new n64.U64();
+  const num = new n64.U64();
+
+  if (Array.isArray(items)) {
+    for (const item of items)
+      sum.iadd(item);
+  } else {
+    for (let i = 0; i < items.length; i++)
+      sum.iadd(items.get(i, num));
+  }
+
+  return sum.toString();
+}
+
+/*
+ * Worker
+ */
+
+function work() {
+  const {mode, backend} = workerData;
+  const n64 = require(path.resolve(__dirname, '..', 'lib', backend));
+
+  let last = null;
+
+  parentPort.on('message', (msg) => {
+    if (msg === null)
+      parentPort.postMessage(checksum(n64, last));
+    else
+      last = decode(mode, n64, msg);
+  });
+}
+
+/*
+ * Main
+ */
+
+function parseArgs(argv) {
+  const options = {
+    backend: 'native',
+    size: [1, 100, 10000],
+    messages: 1000
+  };
+
+  for (let i = 0; i < argv.length; i++) {
+    const arg = argv[i];
+
+    const next = () => {
+      if (i + 1 >= argv.length)
+        throw new Error(`Missing value for ${arg}.`);
+      return argv[++i];
+    };
+
+    switch (arg) {
+      case '--backend':
+        options.backend = next() === 'js' ? 'n64' : 'native';
+        break;
+      case '--size':
+        options.size = next().split(',').map(n => Math.max(1, n >>> 0));
+        break;
+      case '--messages':
+        options.messages = Math.max(1, Number(next()) >>> 0);
+        break;
+      case '-h':
+      case '--help':
+        process.stdout.write(USAGE + '\n');
+        process.exit(0);
+        break;
+      default:
+        throw new Error(`Unknown option: ${arg}.`);
+    }
+  }
+
+  return options;
+}
+
+function round(worker, mode, n64, items, messages) {
+  const values = [];
+
+  for (let i = 0; i < messages; i++)
+    values.push(source(mode, n64, items));
+
+  const done = new Promise((resolve, reject) => {
+    worker.once('message', resolve);
+    worker.once('error', reject);
+  });
+
+  const now = process.hrtime();
+
+  // Encoding is part of the cost of sending.
+  for (let i = 0; i < messages; i++) {
+    const [msg, transfer] = encode(mode, n64, values[i]);
+    worker.postMessage(msg, transfer);
+  }
+
+  worker.postMessage(null);
+
+  return done.then((sum) => {
+    const [sec, ns] = process.hrtime(now);
+    return [sec * 1e9 + ns, sum];
+  });
+}
+
+async function run(mode, size, options) {
+  const n64 = require(path.resolve(__dirname, '..', 'lib', options.backend));
+  const rng = n64.U64.rng(1);
+  const items = [];
+
+  for (let i = 0; i < size; i++)
+    items.push(rng.next());
+
+  const worker = new Worker(__filename, {
+    workerData: {
+      mode: mode,
+      backend: options.backend
+    }
+  });
+
+  // Warm up both sides first.
+  await round(worker, mode, n64, items, Math.min(options.messages, 100));
+
+  const [time, sum] = await round(worker, mode, n64, items, options.messages);
+
+  await worker.terminate();
+
+  if (sum !== checksum(n64, items))
+    throw new Error(`${mode}: bad checksum.`);
+
+  return time;
+}
+
+async function main() {
+  const options = parseArgs(process.argv.slice(2));
+  const pad = (str, n) => String(str).padStart(n);
+
+  process.stdout.write(`backend: ${options.backend === 'n64' ? 'js' : 'native'}`
+                     + `, messages: ${options.messages}\n\n`);
+
+  process.stdout.write('mode          size     msgs/s   Mvalues/s\n');
+
+  for (const size of options.size) {
+    for (const mode of MODES) {
+      const time = await run(mode, size, options);
+      const rate = options.messages / time * 1e9;
+
+      process.stdout.write(mode.padEnd(10)
+                         + pad(size, 8)
+                         + pad(rate.toFixed(0), 11)
+                         + pad((rate * size / 1e6).toFixed(2), 12)
+                         + '\n');
+    }
+  }
+}
+
+if (isMainThread) {
+  main().catch((err) => {
+    process.stderr.write(err.stack + '\n');
+    process.exit(1);
+  });
+} else {
+  work();
+}
@@ -1,8 +1,25 @@
 {
+  "variables": {
+    "n64_bench%": "false",
+    "n64_stats%": "false"
+  },
   "targets": [{
     "target_name": "n64",
     "sources": [
-      "./src/n64.cc"
+      "./src/core.cc",
+      "./src/cpu.cc",
+      "./src/env.cc",
+      "./src/n64.cc",
+      "./src/n128.cc",
+      "./src/rng.cc",
+      "./src/histogram.cc",
+      "./src/struct.cc",
+      "./src/json.cc",
+      "./src/dec64.cc",
+      "./src/array.cc",
+      "./src/atomic.cc",
+      "./src/bulk.cc",
+      "./src/stats.cc"
     ],
     "cflags": [
       "-Wall",
@@ -21,6 +38,32 @@
     ],
     "include_dirs": [
       "<!(node -e \"require('nan')\")"
+    ],
+    "conditions": [
+      ["n64_stats=='true'", {
+        "defines": ["N64_STATS"]
+      }]
     ]
-  }]
+  }],
+  "conditions": [
+    ["n64_bench=='true'", {
+      "targets": [{
+        "target_name": "n64_bench",
+        "type": "executable",
+        "sources": [
+          "./src/core.cc",
+          "./src/cpu.cc",
+          "./bench/kernels.cc"
+        ],
+        "cflags": [
+          "-Wall",
+          "-Wextra",
+          "-O3"
+        ],
+        "cflags_cc+": [
+          "-std=c++0x"
+        ]
+      }]
+    }]
+  ]
 }
@@ -0,0 +1,189 @@
+/*!
+ * backend.js - backend selection for n64.
+ * Copyright (c) 2017, Christopher Jeffrey (MIT License).
+ * https://github.com/chjj/n64
+ */
+
+'use strict';
+
+/*
+ * Constants
+ */
+
+const BACKENDS = ['native', 'js', 'bigint'];
+
+// Default calibration time per backend in ms,
+// rounds per timed batch, and untimed rounds per
+// backend beforehand.
+const BUDGET = 20;
+const BATCH = 16;
+const WARMUP = 1000;
+
+/*
+ * Selection
+ */
+
+let selected = null;
+
+// Calibration is only done when asked for,
+// through `auto` or N64_BACKEND=auto.
+function load(name) {
+  if (name == null)
+    name = process.env.N64_BACKEND || 'js';
+
+  enforce(typeof name === 'string', 'name', 'string');
+
+  if (name === 'auto')
+    name = select();
+
+  switch (name) {
+    case 'native':
+      return require('./native');
+    case 'js':
+      return require('./n64');
+    case 'bigint':
+      return require('./bigint');
+  }
+
+  throw new Error(`Unknown backend: ${name}.`);
+}
+
+function available() {
+  const names = [];
+
+  for (const name of BACKENDS) {
+    if (tryLoad(name))
+      names.push(name);
+  }
+
+  return names;
+}
+
+function select(budget) {
+  if (selected)
+    return selected;
+
+  const timings = calibrate(budget);
+
+  let best = null;
+
+  for (const name of Object.keys(timings)) {
+    if (!best || timings[name] < timings[best])
+      best = name;
+  }
+
+  selected = best;
+
+  return best;
+}
+
+function calibrate(budget) {
+  return measure(available(), budget);
+}
+
+/*
+ * Calibration
+ */
+
+// A mix of the scalar operations which
+// differ the most between backends.
+function round(U64, I64, data) {
+  for (const N of [U64, I64]) {
+    const a = N.fromBits(0x12345678, 0x9abcdef0);
+    const b = N.fromInt(0x1234567);
+    const c = a.mul(b).iadd(b).idiv(b);
+    const d = a.mod(b).ixor(c).ishln(7);
+
+    N.fromString(c.toString(10), 10);
+    N.fromString(d.toString(16), 16);
+
+    d.writeLE(data, 0);
+    c.readLE(data, 0);
+    c.cmp(d);
+  }
+}
+
+function measure(names, budget) {
+  if (budget == null)
+    budget = BUDGET;
+
+  enforce(typeof budget === 'number' && budget > 0, 'budget', 'number');
+
+  const libs = names.map(name => load(name));
+  const best = names.map(() => Infinity);
+  const data = new Uint8Array(8);
+
+  // Until V8 has optimized round() and what it calls,
+  // the native backend, already compiled, looks the
+  // fastest. The warmup is counted rather than timed,
+  // so that a busy machine delays it but cannot cut it
+  // short.
+  for (let i = 0; i < WARMUP; i++) {
+    for (const {U64, I64} of libs)
+      round(U64, I64, data);
+  }
+
+  const start = process.hrtime();
+
+  // The fastest batch of each, in ns per round, since
+  // some are slowed by GC or compilation. The backends
+  // share the call sites in round(), so they take turns
+  // in order to see the same feedback.
+  for (;;) {
+    for (let j = 0; j < libs.length; j++) {
+      const {U64, I64} = libs[j];
+      const time = process.hrtime();
+
+      for (let i = 0; i < BATCH; i++)
+        round(U64, I64, data);
+
+      best[j] = Math.min(best[j], elapsed(time) / BATCH);
+    }
+
+    if (elapsed(start) >= budget * 1e6 * libs.length)
+      break;
+  }
+
+  const timings = {};
+
+  for (let j = 0; j < names.length; j++)
+    timings[names[j]] = best[j];
+
+  return timings;
+}
+
+function elapsed(time) {
+  const [sec, nsec] = process.hrtime(time);
+  return sec * 1e9 + nsec;
+}
+
+/*
+ * Helpers
+ */
+
+function tryLoad(name) {
+  try {
+    return load(name);
+  } catch (e) {
+    return null;
+  }
+}
+
+function enforce(value, name, type) {
+  if (!value) {
+    const err = new TypeError(`'${name}' must be a(n) ${type}.`);
+    if (Error.captureStackTrace)
+      Error.captureStackTrace(err, enforce);
+    throw err;
+  }
+}
+
+/*
+ * Expose
+ */
+
+exports.backends = BACKENDS;
+exports.load = load;
+exports.available = available;
+exports.select = select;
+exports.calibrate = calibrate;
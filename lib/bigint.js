@@ -0,0 +1,1651 @@
+/*!
+ * bigint.js - bigint int64 object for javascript.
+ * Copyright (c) 2017, Christopher Jeffrey (MIT License).
+ * https://github.com/chjj/n64
+ */
+
+/* global BigInt */
+
+'use strict';
+
+if (typeof BigInt !== 'function')
+  throw new Error('BigInt is not supported.');
+
+const js = require('./n64');
+
+/*
+ * Constants
+ */
+
+const ZERO = BigInt(0);
+const ONE = BigInt(1);
+const BYTE = BigInt(0xff);
+const WORD = BigInt(32);
+const MAX_SAFE = BigInt(Number.MAX_SAFE_INTEGER);
+const U64_MAX = (ONE << BigInt(64)) - ONE;
+const I64_MAX = (ONE << BigInt(63)) - ONE;
+const SCRATCH = new DataView(new ArrayBuffer(8));
+const SCRATCH_BYTES = new Uint8Array(SCRATCH.buffer);
+const SHIFTS = [];
+const POW10 = [];
+
+for (let i = 0; i < 64; i++)
+  SHIFTS.push(BigInt(i));
+
+for (let i = 0; i < 20; i++)
+  POW10.push(BigInt(10) ** BigInt(i));
+
+/*
+ * N64 (abstract)
+ *
+ * The value is kept as a single BigInt, wrapped to
+ * 64 bits after every operation: unsigned for U64
+ * and two's complement for I64. Operands of the
+ * other signedness are reinterpreted where it
+ * matters (division, comparison).
+ */
+
+function N64(sign) {
+  enforce(this instanceof N64, 'this', 'N64');
+  enforce(sign === 0 || sign === 1, 'sign', 'bit');
+
+  this.n = ZERO;
+  this._sign = sign;
+}
+
+// Set up front, so that V8 keeps the prototypes
+// fast (see "Fallback" below).
+N64.prototype.__proto__ = js.N64.prototype;
+
+/*
+ * Internal
+ */
+
+N64.prototype.__defineGetter__('sign', function() {
+  return this._sign;
+});
+
+N64.prototype.__defineSetter__('sign', function(value) {
+  enforce(value === 0 || value === 1, 'sign', 'bit');
+  this._sign = value;
+  this.n = wrap(value, this.n);
+});
+
+N64.prototype.__defineGetter__('hi', function() {
+  return Number(BigInt.asIntN(32, this.n >> WORD));
+});
+
+N64.prototype.__defineSetter__('hi', function(value) {
+  this.n = fromWords(this._sign, value, Number(BigInt.asIntN(32, this.n)));
+});
+
+N64.prototype.__defineGetter__('lo', function() {
+  return Number(BigInt.asIntN(32, this.n));
+});
+
+N64.prototype.__defineSetter__('lo', function(value) {
+  this.n = fromWords(this._sign, this.hi, value);
+});
+
+/*
+ * Addition
+ */
+
+N64.prototype.iadd = function iadd(b) {
+  enforce(N64.isN64(b), 'operand', 'int64');
+  this.n = wrap(this._sign, this.n + value(b));
+  return this;
+};
+
+N64.prototype.iaddn = function iaddn(num) {
+  enforce(isNumber(num), 'operand', 'number');
+  this.n = wrap(this._sign, this.n + small(this._sign, num));
+  return this;
+};
+
+N64.prototype.add = function add(b) {
+  return this.clone().iadd(b);
+};
+
+N64.prototype.addn = function addn(num) {
+  return this.clone().iaddn(num);
+};
+
+/*
+ * Subtraction
+ */
+
+N64.prototype.isub = function isub(b) {
+  enforce(N64.isN64(b), 'operand', 'int64');
+  this.n = wrap(this._sign, this.n - value(b));
+  return this;
+};
+
+N64.prototype.isubn = function isubn(num) {
+  enforce(isNumber(num), 'operand', 'number');
+  this.n = wrap(this._sign, this.n - small(this._sign, num));
+  return this;
+};
+
+N64.prototype.sub = function sub(b) {
+  return this.clone().isub(b);
+};
+
+N64.prototype.subn = function subn(num) {
+  return this.clone().isubn(num);
+};
+
+/*
+ * Multiplication
+ */
+
+N64.prototype.imul = function imul(b) {
+  enforce(N64.isN64(b), 'multiplicand', 'int64');
+  this.n = wrap(this._sign, this.n * value(b));
+  return this;
+};
+
+N64.prototype.imuln = function imuln(num) {
+  enforce(isNumber(num), 'multiplicand', 'number');
+  this.n = wrap(this._sign, this.n * small(this._sign, num));
+  return this;
+};
+
+N64.prototype.mul = function mul(b) {
+  return this.clone().imul(b);
+};
+
+N64.prototype.muln = function muln(num) {
+  return this.clone().imuln(num);
+};
+
+/*
+ * Division
+ */
+
+N64.prototype.idiv = function idiv(b) {
+  enforce(N64.isN64(b), 'divisor', 'int64');
+
+  const n = operand(this, b);
+
+  if (n === ZERO)
+    throw new Error('Cannot divide by zero.');
+
+  // BigInt division truncates, as C does. The
+  // only overflow (INT64_MIN / -1) wraps back.
+  this.n = wrap(this._sign, this.n / n);
+
+  return this;
+};
+
+N64.prototype.idivn = function idivn(num) {
+  enforce(isNumber(num), 'divisor', 'number');
+
+  if ((num | 0) === 0)
+    throw new Error('Cannot divide by zero.');
+
+  this.n = wrap(this._sign, this.n / small(this._sign, num));
+
+  return this;
+};
+
+N64.prototype.div = function div(b) {
+  return this.clone().idiv(b);
+};
+
+N64.prototype.divn = function divn(num) {
+  return this.clone().idivn(num);
+};
+
+N64.prototype.tryIdiv = function tryIdiv(b) {
+  enforce(N64.isN64(b), 'divisor', 'int64');
+
+  if (b.isZero())
+    return false;
+
+  this.idiv(b);
+
+  return true;
+};
+
+N64.prototype.tryDiv = function tryDiv(b) {
+  enforce(N64.isN64(b), 'divisor', 'int64');
+
+  if (b.isZero())
+    return null;
+
+  return this.clone().idiv(b);
+};
+
+/*
+ * Modulo
+ */
+
+N64.prototype.imod = function imod(b) {
+  enforce(N64.isN64(b), 'divisor', 'int64');
+
+  const n = operand(this, b);
+
+  if (n === ZERO)
+    throw new Error('Cannot divide by zero.');
+
+  this.n %= n;
+
+  return this;
+};
+
+N64.prototype.imodn = function imodn(num) {
+  enforce(isNumber(num), 'divisor', 'number');
+
+  if ((num | 0) === 0)
+    throw new Error('Cannot divide by zero.');
+
+  this.n %= small(this._sign, num);
+
+  return this;
+};
+
+N64.prototype.mod = function mod(b) {
+  return this.clone().imod(b);
+};
+
+N64.prototype.modn = function modn(num) {
+  return this.clone().imodn(num);
+};
+
+N64.prototype.tryImod = function tryImod(b) {
+  enforce(N64.isN64(b), 'divisor', 'int64');
+
+  if (b.isZero())
+    return false;
+
+  this.imod(b);
+
+  return true;
+};
+
+N64.prototype.tryMod = function tryMod(b) {
+  enforce(N64.isN64(b), 'divisor', 'int64');
+
+  if (b.isZero())
+    return null;
+
+  return this.clone().imod(b);
+};
+
+/*
+ * Exponentiation
+ */
+
+N64.prototype.ipow = function ipow(b) {
+  enforce(N64.isN64(b), 'exponent', 'int64');
+  return this.ipown(b.lo);
+};
+
+N64.prototype.ipown = function ipown(num) {
+  enforce(isNumber(num), 'exponent', 'number');
+
+  if (this.n === ZERO)
+    return this;
+
+  let x = this.n;
+  let y = num >>> 0;
+  let r = ONE;
+
+  // Wrapping as we go keeps
+  // every product small.
+  while (y > 0) {
+    if (y & 1)
+      r = BigInt.asUintN(64, r * x);
+
+    y >>>= 1;
+    x = BigInt.asUintN(64, x * x);
+  }
+
+  this.n = wrap(this._sign, r);
+
+  return this;
+};
+
+N64.prototype.pow = function pow(b) {
+  return this.clone().ipow(b);
+};
+
+N64.prototype.pown = function pown(num) {
+  return this.clone().ipown(num);
+};
+
+N64.prototype.sqr = function sqr() {
+  return this.mul(this);
+};
+
+N64.prototype.isqr = function isqr() {
+  return this.imul(this);
+};
+
+/*
+ * Integer Math
+ */
+
+N64.prototype.isqrt = function isqrt() {
+  if (this.n < ZERO)
+    throw new Error('Square root of negative number.');
+
+  this.n = rootOf(this.n, 2, 0xffffffff);
+
+  return this;
+};
+
+N64.prototype.sqrt = function sqrt() {
+  return this.clone().isqrt();
+};
+
+N64.prototype.icbrt = function icbrt() {
+  const r = rootOf(magnitude(this.n), 3, 2642245);
+
+  this.n = wrap(this._sign, this.n < ZERO ? -r : r);
+
+  return this;
+};
+
+N64.prototype.cbrt = function cbrt() {
+  return this.clone().icbrt();
+};
+
+N64.prototype.log2 = function log2() {
+  if (this.n <= ZERO)
+    throw new Error('Logarithm of non-positive number.');
+
+  return bitsOf(this.n) - 1;
+};
+
+N64.prototype.log10 = function log10() {
+  if (this.n <= ZERO)
+    throw new Error('Logarithm of non-positive number.');
+
+  // As in the JS backend: `t` is
+  // either the answer or one more.
+  let t = (bitsOf(this.n) * 1233) >>> 12;
+
+  if (this.n < POW10[t])
+    t -= 1;
+
+  return t;
+};
+
+N64.prototype.igcd = function igcd(b) {
+  enforce(N64.isN64(b), 'operand', 'int64');
+
+  const r = ugcd(magnitude(this.n), magnitude(operand(this, b)));
+
+  // gcd(INT64_MIN, 0) is 2^63.
+  if (r > maxOf(this._sign))
+    throw new Error('Number out of range.');
+
+  this.n = r;
+
+  return this;
+};
+
+N64.prototype.gcd = function gcd(b) {
+  return this.clone().igcd(b);
+};
+
+N64.prototype.ilcm = function ilcm(b) {
+  enforce(N64.isN64(b), 'operand', 'int64');
+
+  const x = magnitude(this.n);
+  const y = magnitude(operand(this, b));
+
+  if (x === ZERO || y === ZERO) {
+    this.n = ZERO;
+    return this;
+  }
+
+  const r = (x / ugcd(x, y)) * y;
+
+  if (r > maxOf(this._sign))
+    throw new Error('Number out of range.');
+
+  this.n = r;
+
+  return this;
+};
+
+N64.prototype.lcm = function lcm(b) {
+  return this.clone().ilcm(b);
+};
+
+N64.prototype.isPowerOfTwo = function isPowerOfTwo() {
+  return this.n > ZERO && (this.n & (this.n - ONE)) === ZERO;
+};
+
+N64.prototype.inextPowerOfTwo = function inextPowerOfTwo() {
+  if (this.n <= ONE) {
+    this.n = ONE;
+    return this;
+  }
+
+  const bits = bitsOf(this.n - ONE);
+
+  if (bits >= (this._sign ? 63 : 64))
+    throw new Error('Number out of range.');
+
+  this.n = ONE << SHIFTS[bits];
+
+  return this;
+};
+
+N64.prototype.nextPowerOfTwo = function nextPowerOfTwo() {
+  return this.clone().inextPowerOfTwo();
+};
+
+N64.prototype.divmod = function divmod(b) {
+  const q = this.div(b);
+  const r = this.sub(q.mul(b));
+  return [q, r];
+};
+
+N64.prototype.divmodn = function divmodn(num) {
+  enforce(isNumber(num), 'divisor', 'number');
+  return this.divmod(this._small(num));
+};
+
+/*
+ * AND
+ */
+
+N64.prototype.iand = function iand(b) {
+  enforce(N64.isN64(b), 'operand', 'int64');
+  this.n = wrap(this._sign, this.n & value(b));
+  return this;
+};
+
+N64.prototype.iandn = function iandn(num) {
+  enforce(isNumber(num), 'operand', 'number');
+  this.n = wrap(this._sign, this.n & small(this._sign, num));
+  return this;
+};
+
+N64.prototype.and = function and(b) {
+  return this.clone().iand(b);
+};
+
+N64.prototype.andn = function andn(num) {
+  return this.clone().iandn(num);
+};
+
+/*
+ * OR
+ */
+
+N64.prototype.ior = function ior(b) {
+  enforce(N64.isN64(b), 'operand', 'int64');
+  this.n = wrap(this._sign, this.n | value(b));
+  return this;
+};
+
+N64.prototype.iorn = function iorn(num) {
+  enforce(isNumber(num), 'operand', 'number');
+  this.n = wrap(this._sign, this.n | small(this._sign, num));
+  return this;
+};
+
+N64.prototype.or = function or(b) {
+  return this.clone().ior(b);
+};
+
+N64.prototype.orn = function orn(num) {
+  return this.clone().iorn(num);
+};
+
+/*
+ * XOR
+ */
+
+N64.prototype.ixor = function ixor(b) {
+  enforce(N64.isN64(b), 'operand', 'int64');
+  this.n = wrap(this._sign, this.n ^ value(b));
+  return this;
+};
+
+N64.prototype.ixorn = function ixorn(num) {
+  enforce(isNumber(num), 'operand', 'number');
+  this.n = wrap(this._sign, this.n ^ small(this._sign, num));
+  return this;
+};
+
+N64.prototype.xor = function xor(b) {
+  return this.clone().ixor(b);
+};
+
+N64.prototype.xorn = function xorn(num) {
+  return this.clone().ixorn(num);
+};
+
+/*
+ * NOT
+ */
+
+N64.prototype.inot = function inot() {
+  this.n = wrap(this._sign, ~this.n);
+  return this;
+};
+
+N64.prototype.not = function not() {
+  return this.clone().inot();
+};
+
+/*
+ * Left Shift
+ */
+
+N64.prototype.ishl = function ishl(b) {
+  enforce(N64.isN64(b), 'bits', 'int64');
+  return this.ishln(b.lo);
+};
+
+N64.prototype.ishln = function ishln(bits) {
+  enforce(isNumber(bits), 'bits', 'number');
+  this.n = wrap(this._sign, this.n << SHIFTS[bits & 63]);
+  return this;
+};
+
+N64.prototype.shl = function shl(b) {
+  return this.clone().ishl(b);
+};
+
+N64.prototype.shln = function shln(bits) {
+  return this.clone().ishln(bits);
+};
+
+/*
+ * Right Shift
+ */
+
+N64.prototype.ishr = function ishr(b) {
+  enforce(N64.isN64(b), 'bits', 'int64');
+  return this.ishrn(b.lo);
+};
+
+N64.prototype.ishrn = function ishrn(bits) {
+  enforce(isNumber(bits), 'bits', 'number');
+
+  // Signed values are already sign extended,
+  // so this is arithmetic for I64 only.
+  this.n >>= SHIFTS[bits & 63];
+
+  return this;
+};
+
+N64.prototype.shr = function shr(b) {
+  return this.clone().ishr(b);
+};
+
+N64.prototype.shrn = function shrn(bits) {
+  return this.clone().ishrn(bits);
+};
+
+/*
+ * Unsigned Right Shift
+ */
+
+N64.prototype.iushr = function iushr(b) {
+  enforce(N64.isN64(b), 'bits', 'int64');
+  return this.iushrn(b.lo);
+};
+
+N64.prototype.iushrn = function iushrn(bits) {
+  enforce(isNumber(bits), 'bits', 'number');
+
+  const n = BigInt.asUintN(64, this.n) >> SHIFTS[bits & 63];
+
+  this.n = wrap(this._sign, n);
+
+  return this;
+};
+
+N64.prototype.ushr = function ushr(b) {
+  return this.clone().iushr(b);
+};
+
+N64.prototype.ushrn = function ushrn(bits) {
+  return this.clone().iushrn(bits);
+};
+
+/*
+ * Bit Manipulation
+ */
+
+N64.prototype.setn = function setn(bit, val) {
+  enforce(isNumber(bit), 'bit', 'number');
+
+  const mask = ONE << SHIFTS[bit & 63];
+
+  if (val)
+    this.n = wrap(this._sign, this.n | mask);
+  else
+    this.n = wrap(this._sign, this.n & ~mask);
+
+  return this;
+};
+
+N64.prototype.testn = function testn(bit) {
+  enforce(isNumber(bit), 'bit', 'number');
+  return Number((this.n >> SHIFTS[bit & 63]) & ONE);
+};
+
+N64.prototype.setb = function setb(pos, ch) {
+  enforce(isNumber(pos), 'pos', 'number');
+  enforce(isNumber(ch), 'ch', 'number');
+
+  const shift = SHIFTS[(pos & 7) * 8];
+  const n = (this.n & ~(BYTE << shift)) | (BigInt(ch & 0xff) << shift);
+
+  this.n = wrap(this._sign, n);
+
+  return this;
+};
+
+N64.prototype.orb = function orb(pos, ch) {
+  enforce(isNumber(pos), 'pos', 'number');
+  enforce(isNumber(ch), 'ch', 'number');
+
+  const shift = SHIFTS[(pos & 7) * 8];
+
+  this.n = wrap(this._sign, this.n | (BigInt(ch & 0xff) << shift));
+
+  return this;
+};
+
+N64.prototype.getb = function getb(pos) {
+  enforce(isNumber(pos), 'pos', 'number');
+  return Number((this.n >> SHIFTS[(pos & 7) * 8]) & BYTE);
+};
+
+N64.prototype.imaskn = function imaskn(bit) {
+  enforce(isNumber(bit), 'bit', 'number');
+  this.n = BigInt.asUintN(bit & 63, this.n);
+  return this;
+};
+
+N64.prototype.maskn = function maskn(bit) {
+  return this.clone().imaskn(bit);
+};
+
+N64.prototype.andln = function andln(num) {
+  enforce(isNumber(num), 'operand', 'number');
+  return this.lo & num;
+};
+
+/*
+ * Negation
+ */
+
+N64.prototype.ineg = function ineg() {
+  this.n = wrap(this._sign, -this.n);
+  return this;
+};
+
+N64.prototype.neg = function neg() {
+  return this.clone().ineg();
+};
+
+N64.prototype.iabs = function iabs() {
+  if (this.n < ZERO)
+    this.n = wrap(this._sign, -this.n);
+  return this;
+};
+
+N64.prototype.abs = function abs() {
+  return this.clone().iabs();
+};
+
+/*
+ * Comparison
+ */
+
+N64.prototype.cmp = function cmp(b) {
+  enforce(N64.isN64(b), 'value', 'int64');
+
+  const n = operand(this, b);
+
+  if (this.n < n)
+    return -1;
+
+  if (this.n > n)
+    return 1;
+
+  return 0;
+};
+
+N64.prototype.cmpn = function cmpn(num) {
+  enforce(isNumber(num), 'value', 'number');
+
+  const n = small(this._sign, num);
+
+  if (this.n < n)
+    return -1;
+
+  if (this.n > n)
+    return 1;
+
+  return 0;
+};
+
+N64.prototype.eq = function eq(b) {
+  enforce(N64.isN64(b), 'value', 'int64');
+  return this.n === operand(this, b);
+};
+
+N64.prototype.eqn = function eqn(num) {
+  enforce(isNumber(num), 'value', 'number');
+  return this.n === small(this._sign, num);
+};
+
+N64.prototype.gt = function gt(b) {
+  return this.cmp(b) > 0;
+};
+
+N64.prototype.gtn = function gtn(num) {
+  return this.cmpn(num) > 0;
+};
+
+N64.prototype.gte = function gte(b) {
+  return this.cmp(b) >= 0;
+};
+
+N64.prototype.gten = function gten(num) {
+  return this.cmpn(num) >= 0;
+};
+
+N64.prototype.lt = function lt(b) {
+  return this.cmp(b) < 0;
+};
+
+N64.prototype.ltn = function ltn(num) {
+  return this.cmpn(num) < 0;
+};
+
+N64.prototype.lte = function lte(b) {
+  return this.cmp(b) <= 0;
+};
+
+N64.prototype.lten = function lten(num) {
+  return this.cmpn(num) <= 0;
+};
+
+N64.prototype.isZero = function isZero() {
+  return this.n === ZERO;
+};
+
+N64.prototype.isNeg = function isNeg() {
+  return this.n < ZERO;
+};
+
+N64.prototype.isOdd = function isOdd() {
+  return (this.n & ONE) === ONE;
+};
+
+N64.prototype.isEven = function isEven() {
+  return (this.n & ONE) === ZERO;
+};
+
+/*
+ * Helpers
+ */
+
+N64.prototype.clone = function clone() {
+  const n = new this.constructor();
+  n.n = this.n;
+  return n;
+};
+
+N64.prototype.inject = function inject(b) {
+  enforce(N64.isN64(b), 'value', 'int64');
+  this.n = operand(this, b);
+  return this;
+};
+
+N64.prototype.set = function set(num) {
+  enforce(isSafeInteger(num), 'number', 'integer');
+  this.n = wrap(this._sign, BigInt(num));
+  return this;
+};
+
+N64.prototype.join = function join(hi, lo) {
+  enforce(isNumber(hi), 'hi', 'number');
+  enforce(isNumber(lo), 'lo', 'number');
+  this.n = fromWords(this._sign, hi, lo);
+  return this;
+};
+
+N64.prototype._small = function _small(num) {
+  const n = new this.constructor();
+  n.n = small(this._sign, num);
+  return n;
+};
+
+N64.prototype.bitLength = function bitLength() {
+  return bitsOf(magnitude(this.n));
+};
+
+N64.prototype.byteLength = function byteLength() {
+  return Math.ceil(this.bitLength() / 8);
+};
+
+N64.prototype.isSafe = function isSafe() {
+  return this.n <= MAX_SAFE && this.n >= -MAX_SAFE;
+};
+
+N64.prototype.inspect = function inspect() {
+  let prefix = 'I64';
+
+  if (!this._sign)
+    prefix = 'U64';
+
+  return `<${prefix}: ${this.toString(10)}>`;
+};
+
+/*
+ * Encoding
+ */
+
+N64.prototype.readLE = function readLE(data, off) {
+  enforce(data && typeof data.length === 'number', 'data', 'arraylike');
+  enforce((off >> 0) === off, 'offset', 'integer');
+  enforce(off + 8 <= data.length, 'offset', 'valid offset');
+  this.n = readWord(data, off, this._sign, true);
+  return off + 8;
+};
+
+N64.prototype.readBE = function readBE(data, off) {
+  enforce(data && typeof data.length === 'number', 'data', 'arraylike');
+  enforce((off >> 0) === off, 'offset', 'integer');
+  enforce(off + 8 <= data.length, 'offset', 'valid offset');
+  this.n = readWord(data, off, this._sign, false);
+  return off + 8;
+};
+
+N64.prototype.readRaw = function readRaw(data, off) {
+  return this.readLE(data, off);
+};
+
+N64.prototype.writeLE = function writeLE(data, off) {
+  enforce(data && typeof data.length === 'number', 'data', 'arraylike');
+  enforce((off >> 0) === off, 'offset', 'integer');
+  enforce(off + 8 <= data.length, 'offset', 'valid offset');
+  writeWord(data, off, this.n, true);
+  return off + 8;
+};
+
+N64.prototype.writeBE = function writeBE(data, off) {
+  enforce(data && typeof data.length === 'number', 'data', 'arraylike');
+  enforce((off >> 0) === off, 'offset', 'integer');
+  enforce(off + 8 <= data.length, 'offset', 'valid offset');
+  writeWord(data, off, this.n, false);
+  return off + 8;
+};
+
+N64.prototype.writeRaw = function writeRaw(data, off) {
+  return this.writeLE(data, off);
+};
+
+N64.prototype.writeDecimal = function writeDecimal(data, off, pad) {
+  return this._writeString(data, off, 10, pad);
+};
+
+N64.prototype.writeHex = function writeHex(data, off, pad) {
+  return this._writeString(data, off, 16, pad);
+};
+
+// Writes the digits as ASCII, returning the new offset.
+N64.prototype._writeString = function _writeString(data, off, base, pad) {
+  enforce(data instanceof Uint8Array, 'data', 'buffer');
+  enforce((off >>> 0) === off, 'offset', 'integer');
+
+  const str = this.toString(base, pad);
+
+  if (off + str.length > data.length)
+    throw new Error('Invalid offset.');
+
+  for (let i = 0; i < str.length; i++)
+    data[off + i] = str.charCodeAt(i);
+
+  return off + str.length;
+};
+
+/*
+ * Conversion
+ */
+
+N64.prototype.toU64 = function toU64() {
+  const n = new U64();
+  n.n = BigInt.asUintN(64, this.n);
+  return n;
+};
+
+N64.prototype.toI64 = function toI64() {
+  const n = new I64();
+  n.n = BigInt.asIntN(64, this.n);
+  return n;
+};
+
+N64.prototype.toNumber = function toNumber() {
+  if (!this.isSafe())
+    throw new Error('Number exceeds 53 bits.');
+
+  return Number(this.n);
+};
+
+N64.prototype.tryToNumber = function tryToNumber() {
+  if (!this.isSafe())
+    return NaN;
+
+  return Number(this.n);
+};
+
+N64.prototype.toDouble = function toDouble() {
+  return Number(this.n);
+};
+
+N64.prototype.toInt = function toInt() {
+  if (this._sign)
+    return Number(BigInt.asIntN(32, this.n));
+
+  return Number(BigInt.asUintN(32, this.n));
+};
+
+N64.prototype.toBool = function toBool() {
+  return this.n !== ZERO;
+};
+
+N64.prototype.toBits = function toBits() {
+  return [this.hi, this.lo];
+};
+
+N64.prototype.toObject = function toObject() {
+  return { hi: this.hi, lo: this.lo };
+};
+
+N64.prototype.toString = function toString(base, pad) {
+  base = getBase(base);
+
+  if (pad == null)
+    pad = 0;
+
+  enforce((base >>> 0) === base, 'base', 'integer');
+  enforce((pad >>> 0) === pad, 'pad', 'integer');
+
+  if (base < 2 || base > 16)
+    throw new Error('Base ranges between 2 and 16.');
+
+  if (pad > 64)
+    throw new Error('Maximum padding is 64 characters.');
+
+  const neg = this.n < ZERO;
+
+  let str = (neg ? -this.n : this.n).toString(base);
+
+  while (str.length < pad)
+    str = '0' + str;
+
+  if (neg)
+    str = '-' + str;
+
+  return str;
+};
+
+N64.prototype.toJSON = function toJSON() {
+  return this.toString(16, 16);
+};
+
+N64.prototype.toBN = function toBN(BN) {
+  const num = new BN(magnitude(this.n).toString(16), 16);
+
+  if (this.n < ZERO)
+    num.ineg();
+
+  return num;
+};
+
+N64.prototype.toLE = function toLE(ArrayLike) {
+  enforce(typeof ArrayLike === 'function', 'ArrayLike', 'constructor');
+  const data = alloc(ArrayLike, 8);
+  this.writeLE(data, 0);
+  return data;
+};
+
+N64.prototype.toBE = function toBE(ArrayLike) {
+  enforce(typeof ArrayLike === 'function', 'ArrayLike', 'constructor');
+  const data = alloc(ArrayLike, 8);
+  this.writeBE(data, 0);
+  return data;
+};
+
+N64.prototype.toRaw = function toRaw(ArrayLike) {
+  return this.toLE(ArrayLike);
+};
+
+/*
+ * Instantiation
+ */
+
+N64.prototype.fromNumber = function fromNumber(num) {
+  return this.set(num);
+};
+
+N64.prototype.fromInt = function fromInt(num) {
+  enforce(isNumber(num), 'integer', 'number');
+  this.n = small(this._sign, num);
+  return this;
+};
+
+N64.prototype.fromBool = function fromBool(value) {
+  enforce(typeof value === 'boolean', 'value', 'boolean');
+  this.n = value ? ONE : ZERO;
+  return this;
+};
+
+N64.prototype.fromBits = function fromBits(hi, lo) {
+  return this.join(hi, lo);
+};
+
+N64.prototype.fromObject = function fromObject(num) {
+  enforce(num && typeof num === 'object', 'number', 'object');
+  return this.fromBits(num.hi, num.lo);
+};
+
+N64.prototype._read = function _read(str, base) {
+  // Returns an error message instead of throwing,
+  // so that the try* methods stay cheap on bad input.
+  if (base < 2 || base > 16)
+    return 'Base ranges between 2 and 16.';
+
+  let neg = false;
+  let i = 0;
+
+  if (str.length > 0 && str[0] === '-') {
+    i += 1;
+    neg = true;
+  }
+
+  if (str.length === i || str.length > i + 64)
+    return 'Invalid string (bad length).';
+
+  let end = i;
+
+  while (end < str.length && toDigit(str.charCodeAt(end)) < base)
+    end += 1;
+
+  const n = parseDigits(str, i, end, base);
+
+  // Overflow in the digits before a bad
+  // character wins, as in the other backends.
+  if (n > U64_MAX)
+    return 'Invalid string (overflow).';
+
+  if (end < str.length)
+    return 'Invalid string (parse error).';
+
+  this.n = wrap(this._sign, neg ? -n : n);
+
+  return null;
+};
+
+N64.prototype.fromString = function fromString(str, base) {
+  base = getBase(base);
+
+  enforce(typeof str === 'string', 'string', 'string');
+  enforce((base >>> 0) === base, 'base', 'integer');
+
+  const err = this._read(str, base);
+
+  if (err !== null)
+    throw new Error(err);
+
+  return this;
+};
+
+N64.prototype.tryFromString = function tryFromString(str, base) {
+  base = getBase(base);
+
+  enforce((base >>> 0) === base, 'base', 'integer');
+
+  if (base < 2 || base > 16)
+    throw new Error('Base ranges between 2 and 16.');
+
+  if (typeof str !== 'string')
+    return false;
+
+  return this._read(str, base) === null;
+};
+
+N64.prototype.tryFromNumber = function tryFromNumber(num) {
+  if (!isSafeInteger(num))
+    return false;
+
+  this.set(num);
+
+  return true;
+};
+
+N64.prototype.fromJSON = function fromJSON(json) {
+  return this.fromString(json, 16);
+};
+
+N64.prototype.fromBN = function fromBN(num) {
+  enforce(num && isArray(num.words), 'number', 'big number');
+
+  const neg = num.isNeg();
+  const n = BigInt('0x' + num.abs().toString(16));
+
+  if (this._sign && ((n >> SHIFTS[63]) & ONE) === ONE)
+    throw new Error('Big number overflow.');
+
+  if (n > U64_MAX)
+    throw new Error('Big number overflow.');
+
+  // The bytes are OR'd in, as in the other backends.
+  this.n = wrap(this._sign, this.n | n);
+
+  if (neg)
+    this.ineg();
+
+  return this;
+};
+
+N64.prototype.fromLE = function fromLE(data) {
+  this.readLE(data, 0);
+  return this;
+};
+
+N64.prototype.fromBE = function fromBE(data) {
+  this.readBE(data, 0);
+  return this;
+};
+
+N64.prototype.fromRaw = function fromRaw(data) {
+  return this.fromLE(data);
+};
+
+N64.prototype.from = function from(num, base) {
+  if (num == null)
+    return this;
+
+  if (typeof num === 'number') {
+    if (typeof base === 'number')
+      return this.fromBits(num, base);
+    return this.fromNumber(num);
+  }
+
+  if (typeof num === 'string')
+    return this.fromString(num, base);
+
+  if (typeof num === 'object') {
+    if (isArray(num.words))
+      return this.fromBN(num);
+
+    if (typeof num.length === 'number')
+      return this.fromRaw(num);
+
+    return this.fromObject(num);
+  }
+
+  if (typeof num === 'boolean')
+    return this.fromBool(num);
+
+  throw new TypeError('Non-numeric object passed to N64.');
+};
+
+/*
+ * Static Methods
+ */
+
+N64.min = function min(a, b) {
+  return a.cmp(b) < 0 ? a : b;
+};
+
+N64.max = function max(a, b) {
+  return a.cmp(b) > 0 ? a : b;
+};
+
+N64.random = function random() {
+  const n = new this();
+  n.join((Math.random() * 0x100000000) | 0,
+         (Math.random() * 0x100000000) | 0);
+  return n;
+};
+
+N64.pow = function pow(num, exp) {
+  return new this().fromInt(num).ipown(exp);
+};
+
+N64.shift = function shift(num, bits) {
+  return new this().fromInt(num).ishln(bits);
+};
+
+N64.readLE = function readLE(data, off) {
+  const n = new this();
+  n.readLE(data, off);
+  return n;
+};
+
+N64.readBE = function readBE(data, off) {
+  const n = new this();
+  n.readBE(data, off);
+  return n;
+};
+
+N64.readRaw = function readRaw(data, off) {
+  const n = new this();
+  n.readRaw(data, off);
+  return n;
+};
+
+N64.fromNumber = function fromNumber(num) {
+  return new this().fromNumber(num);
+};
+
+N64.tryFromNumber = function tryFromNumber(num) {
+  const n = new this();
+  return n.tryFromNumber(num) ? n : null;
+};
+
+N64.fromInt = function fromInt(num) {
+  return new this().fromInt(num);
+};
+
+N64.fromBool = function fromBool(value) {
+  return new this().fromBool(value);
+};
+
+N64.fromBits = function fromBits(hi, lo) {
+  return new this().fromBits(hi, lo);
+};
+
+N64.fromObject = function fromObject(obj) {
+  return new this().fromObject(obj);
+};
+
+N64.fromString = function fromString(str, base) {
+  return new this().fromString(str, base);
+};
+
+N64.tryFromString = function tryFromString(str, base) {
+  const n = new this();
+  return n.tryFromString(str, base) ? n : null;
+};
+
+N64.fromJSON = function fromJSON(json) {
+  return new this().fromJSON(json);
+};
+
+N64.fromBN = function fromBN(num) {
+  return new this().fromBN(num);
+};
+
+N64.fromLE = function fromLE(data) {
+  return new this().fromLE(data);
+};
+
+N64.fromBE = function fromBE(data) {
+  return new this().fromBE(data);
+};
+
+N64.fromRaw = function fromRaw(data) {
+  return new this().fromRaw(data);
+};
+
+N64.from = function from(num, base) {
+  return new this().from(num, base);
+};
+
+N64.isN64 = function isN64(obj) {
+  // Covers both backends (see "Fallback").
+  return obj instanceof js.N64;
+};
+
+N64.isU64 = function isU64(obj) {
+  return obj instanceof U64 || obj instanceof js.U64;
+};
+
+N64.isI64 = function isI64(obj) {
+  return obj instanceof I64 || obj instanceof js.I64;
+};
+
+/*
+ * U64
+ */
+
+function U64(num, base) {
+  if (!(this instanceof U64))
+    return new U64(num, base);
+
+  N64.call(this, 0);
+
+  this.from(num, base);
+}
+
+U64.__proto__ = N64;
+U64.prototype.__proto__ = N64.prototype;
+
+/*
+ * Constants
+ */
+
+U64.ULONG_MIN = 0x00000000;
+U64.ULONG_MAX = 0xffffffff;
+
+U64.UINT32_MIN = U64(0x00000000, 0x00000000);
+U64.UINT32_MAX = U64(0x00000000, 0xffffffff);
+
+U64.UINT64_MIN = U64(0x00000000, 0x00000000);
+U64.UINT64_MAX = U64(0xffffffff, 0xffffffff);
+
+/*
+ * I64
+ */
+
+function I64(num, base) {
+  if (!(this instanceof I64))
+    return new I64(num, base);
+
+  N64.call(this, 1);
+
+  this.from(num, base);
+}
+
+I64.__proto__ = N64;
+I64.prototype.__proto__ = N64.prototype;
+
+/*
+ * Constants
+ */
+
+I64.LONG_MIN = -0x80000000;
+I64.LONG_MAX = 0x7fffffff;
+
+I64.INT32_MIN = I64(0xffffffff, 0x80000000);
+I64.INT32_MAX = I64(0x00000000, 0x7fffffff);
+
+I64.INT64_MIN = I64(0x80000000, 0x00000000);
+I64.INT64_MAX = I64(0x7fffffff, 0xffffffff);
+
+/*
+ * Fallback
+ *
+ * The rest of the API is borrowed from the JS backend.
+ * BigInt values inherit from its N64 and expose the
+ * same hi, lo and sign, so they pass its type checks
+ * and work as its operands. Values it creates are JS
+ * backend values, which the BigInt methods accept in
+ * turn.
+ */
+
+// Views route hi and lo through the buffer,
+// which the BigInt methods would never read.
+N64.view = function view(data, off) {
+  if (this === U64)
+    return js.U64.view(data, off);
+
+  if (this === I64)
+    return js.I64.view(data, off);
+
+  return js.N64.view.call(this, data, off);
+};
+
+// Assigned one by one, as keyed stores would
+// leave the constructors slow to look up.
+N64.rng = js.N64.rng;
+N64.histogram = js.N64.histogram;
+N64.stats = js.N64.stats;
+N64.resetStats = js.N64.resetStats;
+N64.cpuFeatures = js.N64.cpuFeatures;
+N64.bswap64 = js.N64.bswap64;
+N64.split = js.N64.split;
+N64.join = js.N64.join;
+N64.compact = js.N64.compact;
+
+U64.parseColumn = js.U64.parseColumn;
+U64.toFloat64 = js.U64.toFloat64;
+U64.fromFloat64 = js.U64.fromFloat64;
+U64.dot = js.U64.dot;
+U64.tryDot = js.U64.tryDot;
+U64.axpy = js.U64.axpy;
+U64.matvec = js.U64.matvec;
+U64.where = js.U64.where;
+U64.countWhere = js.U64.countWhere;
+U64.serializeJSON = js.U64.serializeJSON;
+U64.parseJSON = js.U64.parseJSON;
+U64.jsonParser = js.U64.jsonParser;
+U64.atomic = js.U64.atomic;
+U64.math = js.U64.math;
+
+I64.parseColumn = js.I64.parseColumn;
+I64.toFloat64 = js.I64.toFloat64;
+I64.fromFloat64 = js.I64.fromFloat64;
+I64.dot = js.I64.dot;
+I64.tryDot = js.I64.tryDot;
+I64.axpy = js.I64.axpy;
+I64.matvec = js.I64.matvec;
+I64.where = js.I64.where;
+I64.countWhere = js.I64.countWhere;
+I64.serializeJSON = js.I64.serializeJSON;
+I64.parseJSON = js.I64.parseJSON;
+I64.jsonParser = js.I64.jsonParser;
+I64.atomic = js.I64.atomic;
+I64.math = js.I64.math;
+
+/*
+ * Helpers
+ */
+
+function wrap(sign, n) {
+  if (sign)
+    return BigInt.asIntN(64, n);
+
+  return BigInt.asUintN(64, n);
+}
+
+function small(sign, num) {
+  // Sign extended for I64, zero
+  // extended for U64, as natively.
+  if (sign)
+    return BigInt(num | 0);
+
+  return BigInt(num >>> 0);
+}
+
+function value(b) {
+  // Values from the borrowed features
+  // are read through hi and lo.
+  if (b instanceof N64)
+    return b.n;
+
+  return fromWords(b.sign, b.hi, b.lo);
+}
+
+function operand(a, b) {
+  if (!(b instanceof N64))
+    return fromWords(a._sign, b.hi, b.lo);
+
+  if (a._sign === b._sign)
+    return b.n;
+
+  return wrap(a._sign, b.n);
+}
+
+function fromWords(sign, hi, lo) {
+  hi = sign ? hi | 0 : hi >>> 0;
+  return (BigInt(hi) << WORD) | BigInt(lo >>> 0);
+}
+
+function magnitude(n) {
+  return n < ZERO ? -n : n;
+}
+
+function maxOf(sign) {
+  return sign ? I64_MAX : U64_MAX;
+}
+
+function bitsOf(n) {
+  // `n` is a non-negative magnitude.
+  const hi = Number(n >> WORD);
+
+  if (hi === 0)
+    return countBits(Number(n));
+
+  return countBits(hi) + 32;
+}
+
+function rootOf(n, k, max) {
+  // The double is within one of the root.
+  let s = BigInt(Math.min(Math.floor(Math.pow(Number(n), 1 / k)), max));
+
+  while (s ** BigInt(k) > n)
+    s -= ONE;
+
+  while (s < BigInt(max) && (s + ONE) ** BigInt(k) <= n)
+    s += ONE;
+
+  return s;
+}
+
+function ugcd(x, y) {
+  while (y !== ZERO) {
+    const t = x % y;
+    x = y;
+    y = t;
+  }
+
+  return x;
+}
+
+function parseDigits(str, start, end, base) {
+  if (start === end)
+    return ZERO;
+
+  const digits = str.slice(start, end);
+
+  switch (base) {
+    case 2:
+      return BigInt('0b' + digits);
+    case 8:
+      return BigInt('0o' + digits);
+    case 10:
+      return BigInt(digits);
+    case 16:
+      return BigInt('0x' + digits);
+  }
+
+  // Eight digits fit in a double in any base.
+  let n = ZERO;
+
+  for (let i = 0; i < digits.length; i += 8) {
+    const chunk = digits.slice(i, i + 8);
+    const mul = BigInt(Math.pow(base, chunk.length));
+
+    n = n * mul + BigInt(parseInt(chunk, base));
+  }
+
+  return n;
+}
+
+function getBase(base) {
+  if (base == null)
+    return 10;
+
+  if (typeof base === 'number')
+    return base;
+
+  switch (base) {
+    case 'bin':
+      return 2;
+    case 'oct':
+      return 8;
+    case 'dec':
+      return 10;
+    case 'hex':
+      return 16;
+  }
+
+  return 0;
+}
+
+function toDigit(ch) {
+  if (ch >= 0x30 && ch <= 0x39)
+    return ch - 0x30;
+
+  if (ch >= 0x41 && ch <= 0x5a)
+    return ch - 0x41 + 10;
+
+  if (ch >= 0x61 && ch <= 0x7a)
+    return ch - 0x61 + 10;
+
+  return 36;
+}
+
+function countBits(word) {
+  return 32 - Math.clz32(word);
+}
+
+function enforce(value, name, type) {
+  if (!value) {
+    const err = new TypeError(`'${name}' must be a(n) ${type}.`);
+    if (Error.captureStackTrace)
+      Error.captureStackTrace(err, enforce);
+    throw err;
+  }
+}
+
+function isNumber(num) {
+  return typeof num === 'number' && isFinite(num);
+}
+
+function isArray(num) {
+  return Array.isArray(num);
+}
+
+function isSafeInteger(num) {
+  return Number.isSafeInteger(num);
+}
+
+function alloc(ArrayLike, size) {
+  if (ArrayLike.allocUnsafe)
+    return ArrayLike.allocUnsafe(size);
+
+  return new ArrayLike(size);
+}
+
+function readWord(data, off, sign, le) {
+  // A DataView does the conversion in
+  // one call, already wrapped for `sign`.
+  for (let i = 0; i < 8; i++)
+    SCRATCH_BYTES[i] = data[off + i];
+
+  if (sign)
+    return SCRATCH.getBigInt64(0, le);
+
+  return SCRATCH.getBigUint64(0, le);
+}
+
+function writeWord(data, off, n, le) {
+  SCRATCH.setBigUint64(0, n, le);
+
+  for (let i = 0; i < 8; i++)
+    data[off + i] = SCRATCH_BYTES[i];
+}
+
+/*
+ * Expose
+ */
+
+exports.N64 = N64;
+exports.U64 = U64;
+exports.I64 = I64;
+
+for (const key of Object.keys(js)) {
+  if (!(key in exports))
+    exports[key] = js[key];
+}
@@ -107,47 +107,25 @@ N64.prototype._mul = function _mul(bhi, blo) {
   const ahi = this.hi;
   const alo = this.lo;
 
-  const a48 = ahi >>> 16;
-  const a32 = ahi & 0xffff;
+  // The low words need the full 64 bit product, taken
+  // in 16 bit halves so that every term is exact. The
+  // cross terms only reach the high word, where
+  // Math.imul's wrapping is what we want.
   const a16 = alo >>> 16;
   const a00 = alo & 0xffff;
-
-  const b48 = bhi >>> 16;
-  const b32 = bhi & 0xffff;
   const b16 = blo >>> 16;
   const b00 = blo & 0xffff;
 
-  let c48 = 0;
-  let c32 = 0;
-  let c16 = 0;
-  let c00 = 0;
-
-  c00 += a00 * b00;
-  c16 += c00 >>> 16;
-  c00 &= 0xffff;
-  c16 += a16 * b00;
-  c32 += c16 >>> 16;
-  c16 &= 0xffff;
-  c16 += a00 * b16;
-  c32 += c16 >>> 16;
-  c16 &= 0xffff;
-  c32 += a32 * b00;
-  c48 += c32 >>> 16;
-  c32 &= 0xffff;
-  c32 += a16 * b16;
-  c48 += c32 >>> 16;
-  c32 &= 0xffff;
-  c32 += a00 * b32;
-  c48 += c32 >>> 16;
-  c32 &= 0xffff;
-  c48 += a48 * b00 + a32 * b16 + a16 * b32 + a00 * b48;
-  c48 &= 0xffff;
-
-  const hi = (c48 << 16) | c32;
-  const lo = (c16 << 16) | c00;
+  const c00 = a00 * b00;
+  const c16 = a16 * b00;
+  const d16 = a00 * b16;
+  const mid = (c00 >>> 16) + (c16 & 0xffff) + (d16 & 0xffff);
 
-  this.hi = hi;
-  this.lo = lo;
+  const hi = a16 * b16 + (c16 >>> 16) + (d16 >>> 16) + (mid >>> 16)
+           + Math.imul(ahi, blo) + Math.imul(alo, bhi);
+
+  this.hi = hi | 0;
+  this.lo = (mid << 16) | (c00 & 0xffff);
 
   return this;
 };
@@ -174,79 +152,65 @@ N64.prototype.muln = function muln(num) {
  * Division
  */
 
-N64.prototype.idiv = function idiv(b) {
-  let a = this;
-
-  enforce(N64.isN64(b), 'divisor', 'int64');
-
-  if (b.isZero())
-    throw new Error('Cannot divide by zero.');
-
-  if (a.isZero())
-    return a;
-
-  if (a.eq(b))
-    return a.set(1);
-
-  if (a.isSafe() && b.isSafe()) {
-    const n = a.toDouble();
-    const d = b.toDouble();
-    const q = floor(n / d);
-    return a.set(q);
-  }
-
-  let neg = false;
+N64.prototype._div = function _div(bhi, blo, rem) {
+  let ahi = this.hi;
+  let alo = this.lo;
+  let qneg = false;
+  let rneg = false;
+
+  // Truncates, as C does: the quotient is negative
+  // when the signs differ and the remainder takes
+  // the sign of the dividend.
+  if (this.sign) {
+    if (ahi < 0) {
+      ahi = ~ahi + (alo === 0 ? 1 : 0);
+      alo = -alo;
+      qneg = true;
+      rneg = true;
+    }
 
-  if (a.sign) {
-    if (a.hi < 0) {
-      if (b.hi < 0) {
-        a = a.ineg();
-        b = b.neg();
-      } else {
-        a = a.ineg();
-        neg = true;
-      }
-    } else if (b.hi < 0) {
-      b = b.neg();
-      neg = true;
+    if (bhi < 0) {
+      bhi = ~bhi + (blo === 0 ? 1 : 0);
+      blo = -blo;
+      qneg = !qneg;
     }
   }
 
-  const n = a.toU64();
-  const d = b.toU64();
-
-  if (n.lt(d))
-    return a.set(0);
-
-  if (n.ushrn(1).lt(d))
-    return a.set(neg ? -1 : 1);
+  udivmod64(ahi >>> 0, alo >>> 0, bhi >>> 0, blo >>> 0);
 
-  const q = new U64();
-  const r = new U64();
+  if (rem) {
+    this.hi = DIVMOD[2];
+    this.lo = DIVMOD[3];
 
-  let bit = n.bitLength();
+    if (rneg)
+      this.ineg();
+  } else {
+    this.hi = DIVMOD[0];
+    this.lo = DIVMOD[1];
 
-  while (bit--) {
-    r.ishln(1);
-    r.lo |= n.testn(bit);
-    if (r.gte(d)) {
-      r.isub(d);
-      q.setn(bit, 1);
-    }
+    if (qneg)
+      this.ineg();
   }
 
-  a.hi = q.hi;
-  a.lo = q.lo;
+  return this;
+};
+
+N64.prototype.idiv = function idiv(b) {
+  enforce(N64.isN64(b), 'divisor', 'int64');
 
-  if (neg)
-    a.ineg();
+  if (b.isZero())
+    throw new Error('Cannot divide by zero.');
 
-  return a;
+  return this._div(b.hi, b.lo, false);
 };
 
 N64.prototype.idivn = function idivn(num) {
   enforce(isNumber(num), 'divisor', 'number');
-  return this.idiv(this._small(num));
+
+  if ((num | 0) === 0)
+    throw new Error('Cannot divide by zero.');
+
+  return this._div((num >> 31) & -this.sign, num | 0, false);
 };
 
 N64.prototype.div = function div(b) {
@@ -257,37 +221,46 @@ N64.prototype.divn = function divn(num) {
   return this.clone().idivn(num);
 };
 
+N64.prototype.tryIdiv = function tryIdiv(b) {
+  enforce(N64.isN64(b), 'divisor', 'int64');
+
+  if (b.isZero())
+    return false;
+
+  this.idiv(b);
+
+  return true;
+};
+
+N64.prototype.tryDiv = function tryDiv(b) {
+  enforce(N64.isN64(b), 'divisor', 'int64');
+
+  if (b.isZero())
+    return null;
+
+  return this.clone().idiv(b);
+};
+
 /*
  * Modulo
  */
 
 N64.prototype.imod = function imod(b) {
-  const a = this;
-
   enforce(N64.isN64(b), 'divisor', 'int64');
 
   if (b.isZero())
     throw new Error('Cannot divide by zero.');
 
-  if (a.isZero())
-    return a;
-
-  if (a.eq(b))
-    return a.set(0);
-
-  if (a.isSafe() && b.isSafe()) {
-    const n = a.toDouble();
-    const d = b.toDouble();
-    const r = n % d;
-    return a.set(r);
-  }
-
-  return a.isub(a.div(b).imul(b));
+  return this._div(b.hi, b.lo, true);
 };
 
 N64.prototype.imodn = function imodn(num) {
   enforce(isNumber(num), 'divisor', 'number');
-  return this.imod(this._small(num));
+
+  if ((num | 0) === 0)
+    throw new Error('Cannot divide by zero.');
+
+  return this._div((num >> 31) & -this.sign, num | 0, true);
 };
 
 N64.prototype.mod = function mod(b) {
@@ -298,6 +271,26 @@ N64.prototype.modn = function modn(num) {
   return this.clone().imodn(num);
 };
 
+N64.prototype.tryImod = function tryImod(b) {
+  enforce(N64.isN64(b), 'divisor', 'int64');
+
+  if (b.isZero())
+    return false;
+
+  this.imod(b);
+
+  return true;
+};
+
+N64.prototype.tryMod = function tryMod(b) {
+  enforce(N64.isN64(b), 'divisor', 'int64');
+
+  if (b.isZero())
+    return null;
+
+  return this.clone().imod(b);
+};
+
 /*
  * Exponentiation
  */
@@ -346,6 +339,106 @@ N64.prototype.isqr = function isqr() {
   return this.imul(this);
 };
 
+/*
+ * Integer Math
+ */
+
+N64.prototype.isqrt = function isqrt() {
+  if (!sqrtTo(this))
+    throw new Error('Square root of negative number.');
+
+  return this;
+};
+
+N64.prototype.sqrt = function sqrt() {
+  return this.clone().isqrt();
+};
+
+N64.prototype.icbrt = function icbrt() {
+  cbrtTo(this);
+  return this;
+};
+
+N64.prototype.cbrt = function cbrt() {
+  return this.clone().icbrt();
+};
+
+N64.prototype.log2 = function log2() {
+  const r = log2Of(this);
+
+  if (r < 0)
+    throw new Error('Logarithm of non-positive number.');
+
+  return r;
+};
+
+N64.prototype.log10 = function log10() {
+  const r = log10Of(this);
+
+  if (r < 0)
+    throw new Error('Logarithm of non-positive number.');
+
+  return r;
+};
+
+N64.prototype.igcd = function igcd(b) {
+  enforce(N64.isN64(b), 'operand', 'int64');
+
+  if (!gcdTo(this, b))
+    throw new Error('Number out of range.');
+
+  return this;
+};
+
+N64.prototype.gcd = function gcd(b) {
+  return this.clone().igcd(b);
+};
+
+N64.prototype.ilcm = function ilcm(b) {
+  enforce(N64.isN64(b), 'operand', 'int64');
+
+  if (!lcmTo(this, b))
+    throw new Error('Number out of range.');
+
+  return this;
+};
+
+N64.prototype.lcm = function lcm(b) {
+  return this.clone().ilcm(b);
+};
+
+N64.prototype.isPowerOfTwo = function isPowerOfTwo() {
+  if (this.isZero() || this.isNeg())
+    return false;
+
+  if (this.hi === 0)
+    return (this.lo & (this.lo - 1)) === 0;
+
+  return this.lo === 0 && (this.hi & (this.hi - 1)) === 0;
+};
+
+N64.prototype.inextPowerOfTwo = function inextPowerOfTwo() {
+  if (!nextPow2To(this))
+    throw new Error('Number out of range.');
+
+  return this;
+};
+
+N64.prototype.nextPowerOfTwo = function nextPowerOfTwo() {
+  return this.clone().inextPowerOfTwo();
+};
+
+N64.prototype.divmod = function divmod(b) {
+  const q = this.div(b);
+  const r = this.sub(q.mul(b));
+  return [q, r];
+};
+
+N64.prototype.divmodn = function divmodn(num) {
+  enforce(isNumber(num), 'divisor', 'number');
+  return this.divmod(this._small(num));
+};
+
 /*
  * AND
  */
@@ -879,15 +972,18 @@ N64.prototype._small = function _small(num) {
 };
 
 N64.prototype.bitLength = function bitLength() {
-  let a = this;
+  let hi = this.hi;
+  let lo = this.lo;
 
-  if (this.isNeg())
-    a = this.neg();
+  if (this.isNeg()) {
+    hi = ~hi + (lo === 0 ? 1 : 0);
+    lo = -lo;
+  }
 
-  if (a.hi === 0)
-    return countBits(a.lo);
+  if (hi === 0)
+    return countBits(lo);
 
-  return countBits(a.hi) + 32;
+  return countBits(hi) + 32;
 };
 
 N64.prototype.byteLength = function byteLength() {
@@ -963,6 +1059,47 @@ N64.prototype.writeRaw = function writeRaw(data, off) {
   return this.writeLE(data, off);
 };
 
+N64.prototype.writeDecimal = function writeDecimal(data, off, pad) {
+  return this._writeString(data, off, 10, pad);
+};
+
+N64.prototype.writeHex = function writeHex(data, off, pad) {
+  return this._writeString(data, off, 16, pad);
+};
+
+// Writes the digits as ASCII, returning the new offset.
+N64.prototype._writeString = function _writeString(data, off, base, pad) {
+  enforce(data instanceof Uint8Array, 'data', 'buffer');
+  enforce((off >>> 0) === off, 'offset', 'integer');
+
+  const str = this.toString(base, pad);
+
+  if (off + str.length > data.length)
+    throw new Error('Invalid offset.');
+
+  for (let i = 0; i < str.length; i++)
+    data[off + i] = str.charCodeAt(i);
+
+  return off + str.length;
+};
+
+/*
+ * Views
+ */
+
+N64.prototype.seek = function seek(off) {
+  enforce((off >>> 0) === off, 'offset', 'integer');
+
+  if (!this.view)
+    throw new Error('Object is not a view.');
+
+  checkSlot(this.view.data, off);
+
+  this.view.off = off;
+
+  return this;
+};
+
 /*
  * Conversion
  */
@@ -988,6 +1125,13 @@ N64.prototype.toNumber = function toNumber() {
   return this.toDouble();
 };
 
+N64.prototype.tryToNumber = function tryToNumber() {
+  if (!this.isSafe())
+    return NaN;
+
+  return this.toDouble();
+};
+
 N64.prototype.toDouble = function toDouble() {
   let hi = this.hi;
 
@@ -1028,37 +1172,52 @@ N64.prototype.toString = function toString(base, pad) {
   if (pad > 64)
     throw new Error('Maximum padding is 64 characters.');
 
-  let n = this;
+  let hi = this.hi;
+  let lo = this.lo;
   let neg = false;
 
-  if (n.isNeg()) {
-    n = n.neg();
+  if (this.isNeg()) {
+    hi = ~hi + (lo === 0 ? 1 : 0);
+    lo = -lo;
     neg = true;
   }
 
-  let hi = n.hi >>> 0;
-  let lo = n.lo >>> 0;
-  let str = '';
+  hi >>>= 0;
+  lo >>>= 0;
 
-  do {
-    const mhi = hi % base;
-    hi -= mhi;
-    hi /= base;
-    lo += mhi * 0x100000000;
+  const chunk = CHUNK_POWERS[base];
+  const digits = CHUNK_DIGITS[base];
+
+  let str = '';
+  let n = 0;
+  let r = '';
+
+  // Numbers format themselves quickly in decimal below
+  // 2^53, and in other bases as small integers. The
+  // rest is peeled off a chunk of digits at a time.
+  if (hi < 0x200000) {
+    n = hi * 0x100000000 + lo;
+  } else {
+    const qhi = Math.floor(hi / chunk);
+    const t = (hi - qhi * chunk) * 0x100000000 + lo;
+    const qlo = Math.floor(t / chunk);
 
-    const mlo = lo % base;
-    lo -= mlo;
-    lo /= base;
+    r = (t - qlo * chunk).toString(base);
+    str = CHUNK_ZEROS.slice(0, digits - r.length) + r;
+    n = qhi * 0x100000000 + qlo;
+  }
 
-    let ch = mlo;
+  if (base !== 10) {
+    while (n >= chunk) {
+      const q = Math.floor(n / chunk);
 
-    if (ch < 10)
-      ch += 0x30;
-    else
-      ch += 0x61 - 10;
+      r = (n - q * chunk).toString(base);
+      str = CHUNK_ZEROS.slice(0, digits - r.length) + r + str;
+      n = q;
+    }
+  }
 
-    str = String.fromCharCode(ch) + str;
-  } while (lo > 0 || hi > 0);
+  str = n.toString(base) + str;
 
   while (str.length < pad)
     str = '0' + str;
@@ -1151,14 +1310,11 @@ N64.prototype.fromObject = function fromObject(num) {
   return this.fromBits(num.hi, num.lo);
 };
 
-N64.prototype.fromString = function fromString(str, base) {
-  base = getBase(base);
-
-  enforce(typeof str === 'string', 'string', 'string');
-  enforce((base >>> 0) === base, 'base', 'integer');
-
+N64.prototype._read = function _read(str, base) {
+  // Returns an error message instead of throwing,
+  // so that the try* methods stay cheap on bad input.
   if (base < 2 || base > 16)
-    throw new Error('Base ranges between 2 and 16.');
+    return 'Base ranges between 2 and 16.';
 
   let neg = false;
   let i = 0;
@@ -1169,39 +1325,49 @@ N64.prototype.fromString = function fromString(str, base) {
   }
 
   if (str.length === i || str.length > i + 64)
-    throw new Error('Invalid string (bad length).');
+    return 'Invalid string (bad length).';
+
+  const size = CHUNK_DIGITS[base];
 
   let hi = 0;
   let lo = 0;
 
-  for (; i < str.length; i++) {
-    let ch = str.charCodeAt(i);
+  // A chunk of digits at a time, each
+  // folded into the words at once.
+  while (i < str.length) {
+    const end = Math.min(i + size, str.length);
 
-    if (ch >= 0x30 && ch <= 0x39)
-      ch -= 0x30;
-    else if (ch >= 0x41 && ch <= 0x5a)
-      ch -= 0x41 - 10;
-    else if (ch >= 0x61 && ch <= 0x7a)
-      ch -= 0x61 - 10;
-    else
-      ch = base;
+    let chunk = 0;
+    let mul = 1;
+    let bad = false;
 
-    if (ch >= base)
-      throw new Error('Invalid string (parse error).');
+    for (; i < end; i++) {
+      const ch = toDigit(str.charCodeAt(i));
 
-    lo *= base;
-    lo += ch;
+      if (ch >= base) {
+        bad = true;
+        break;
+      }
+
+      chunk = chunk * base + ch;
+      mul *= base;
+    }
 
-    hi *= base;
+    lo = lo * mul + chunk;
+    hi *= mul;
 
     if (lo > 0xffffffff) {
-      ch = lo % 0x100000000;
-      hi += (lo - ch) / 0x100000000;
-      lo = ch;
+      const carry = Math.floor(lo / 0x100000000);
+      hi += carry;
+      lo -= carry * 0x100000000;
     }
 
+    // Whichever came first wins, as natively.
     if (hi > 0xffffffff)
-      throw new Error('Invalid string (overflow).');
+      return 'Invalid string (overflow).';
+
+    if (bad)
+      return 'Invalid string (parse error).';
   }
 
   this.hi = hi | 0;
@@ -1210,9 +1376,46 @@ N64.prototype.fromString = function fromString(str, base) {
   if (neg)
     this.ineg();
 
+  return null;
+};
+
+N64.prototype.fromString = function fromString(str, base) {
+  base = getBase(base);
+
+  enforce(typeof str === 'string', 'string', 'string');
+  enforce((base >>> 0) === base, 'base', 'integer');
+
+  const err = this._read(str, base);
+
+  if (err !== null)
+    throw new Error(err);
+
   return this;
 };
 
+N64.prototype.tryFromString = function tryFromString(str, base) {
+  base = getBase(base);
+
+  enforce((base >>> 0) === base, 'base', 'integer');
+
+  if (base < 2 || base > 16)
+    throw new Error('Base ranges between 2 and 16.');
+
+  if (typeof str !== 'string')
+    return false;
+
+  return this._read(str, base) === null;
+};
+
+N64.prototype.tryFromNumber = function tryFromNumber(num) {
+  if (!isSafeInteger(num))
+    return false;
+
+  this.set(num);
+
+  return true;
+};
+
 N64.prototype.fromJSON = function fromJSON(json) {
   return this.fromString(json, 16);
 };
@@ -1336,6 +1539,11 @@ N64.fromNumber = function fromNumber(num) {
   return new this().fromNumber(num);
 };
 
+N64.tryFromNumber = function tryFromNumber(num) {
+  const n = new this();
+  return n.tryFromNumber(num) ? n : null;
+};
+
 N64.fromInt = function fromInt(num) {
   return new this().fromInt(num);
 };
@@ -1356,6 +1564,11 @@ N64.fromString = function fromString(str, base) {
   return new this().fromString(str, base);
 };
 
+N64.tryFromString = function tryFromString(str, base) {
+  const n = new this();
+  return n.tryFromString(str, base) ? n : null;
+};
+
 N64.fromJSON = function fromJSON(json) {
   return new this().fromJSON(json);
 };
@@ -1376,10 +1589,36 @@ N64.fromRaw = function fromRaw(data) {
   return new this().fromRaw(data);
 };
 
+N64.view = function view(data, off) {
+  if (off == null)
+    off = 0;
+
+  const bytes = toBytes(data);
+
+  enforce((off >>> 0) === off, 'offset', 'integer');
+  checkSlot(bytes, off);
+
+  const [proto, sign] = viewProto(this);
+  const num = Object.create(proto);
+
+  num.sign = sign;
+  num.view = { data: bytes, off: off };
+
+  return num;
+};
+
 N64.from = function from(num, base) {
   return new this().from(num, base);
 };
 
+N64.rng = function rng(seed) {
+  return new RNG(this, seed);
+};
+
+N64.histogram = function histogram(options) {
+  return new Histogram(this, options);
+};
+
 N64.isN64 = function isN64(obj) {
   return obj instanceof N64;
 };
@@ -1392,6 +1631,45 @@ N64.isI64 = function isI64(obj) {
   return obj instanceof I64;
 };
 
+N64.stats = function stats() {
+  // Instrumentation is only
+  // available natively.
+  return {
+    enabled: false,
+    sampleRate: 0,
+    allocations: 0,
+    calls: 0,
+    throws: {
+      type: 0,
+      divzero: 0,
+      overflow: 0,
+      parse: 0,
+      other: 0
+    },
+    methods: {}
+  };
+};
+
+N64.resetStats = function resetStats() {};
+
+N64.cpuFeatures = function cpuFeatures() {
+  // Kernel selection only
+  // happens natively.
+  return {
+    path: 'js',
+    scalar: false,
+    features: [],
+    kernels: {
+      bswap64: 'js',
+      split: 'js',
+      join: 'js',
+      toFloat64: 'js',
+      format: 'js',
+      where: 'js'
+    }
+  };
+};
+
 /*
  * U64
  */
@@ -1451,17 +1729,5757 @@ I64.INT64_MIN = I64(0x80000000, 0x00000000);
 I64.INT64_MAX = I64(0x7fffffff, 0xffffffff);
 
 /*
- * Helpers
+ * N64 Helpers
  */
 
-function getBase(base) {
-  if (base == null)
-    return 10;
+// Largest divisor for which a remainder times 2^32
+// plus a word still fits in a double's mantissa.
+const SHORT_DIVISOR = 0x200000;
 
-  if (typeof base === 'number')
-    return base;
+// Quotient and remainder of udivmod64, as
+// [qhi, qlo, rhi, rlo], to avoid allocating.
+const DIVMOD = new Int32Array(4);
 
-  switch (base) {
+function udivmod64(nhi, nlo, dhi, dlo) {
+  // Unsigned words; d is non-zero.
+  let qhi = 0;
+  let qlo = 0;
+  let rhi = 0;
+  let rlo = 0;
+
+  if (dhi === 0) {
+    // Long division by one 32 bit digit. Small
+    // divisors take the low word in one step,
+    // others in two 16 bit halves.
+    qhi = Math.floor(nhi / dlo);
+
+    let r = nhi - qhi * dlo;
+
+    if (dlo < SHORT_DIVISOR) {
+      const t = r * 0x100000000 + nlo;
+
+      qlo = Math.floor(t / dlo);
+      rlo = t - qlo * dlo;
+    } else {
+      let t = r * 0x10000 + (nlo >>> 16);
+      const q1 = Math.floor(t / dlo);
+
+      r = t - q1 * dlo;
+      t = r * 0x10000 + (nlo & 0xffff);
+
+      const q0 = Math.floor(t / dlo);
+
+      qlo = q1 * 0x10000 + q0;
+      rlo = t - q0 * dlo;
+    }
+  } else if (nhi < dhi || (nhi === dhi && nlo < dlo)) {
+    rhi = nhi;
+    rlo = nlo;
+  } else {
+    // The quotient is a single 32 bit digit. As in
+    // Knuth's algorithm D, estimate it and correct:
+    // in doubles the estimate is off by at most one
+    // either way, so start one below and count up.
+    let q = Math.floor((nhi * 0x100000000 + nlo)
+                     / (dhi * 0x100000000 + dlo));
+
+    if (q > 0)
+      q -= 1;
+
+    // q * d, which cannot exceed n.
+    const x = (q & 0xffff) * dlo;
+    const y = (q >>> 16) * dlo;
+
+    let plo = x % 0x100000000 + (y % 0x10000) * 0x10000;
+    let phi = Math.floor(x / 0x100000000) + Math.floor(y / 0x10000);
+
+    if (plo >= 0x100000000) {
+      plo -= 0x100000000;
+      phi += 1;
+    }
+
+    phi = (phi + Math.imul(q, dhi)) >>> 0;
+
+    rlo = nlo - plo;
+    rhi = nhi - phi;
+
+    if (rlo < 0) {
+      rlo += 0x100000000;
+      rhi -= 1;
+    }
+
+    while (rhi > dhi || (rhi === dhi && rlo >= dlo)) {
+      rlo -= dlo;
+      rhi -= dhi;
+
+      if (rlo < 0) {
+        rlo += 0x100000000;
+        rhi -= 1;
+      }
+
+      q += 1;
+    }
+
+    qlo = q;
+  }
+
+  DIVMOD[0] = qhi;
+  DIVMOD[1] = qlo;
+  DIVMOD[2] = rhi;
+  DIVMOD[3] = rlo;
+}
+
+// Digits per chunk when formatting and parsing,
+// as many as stay below SHORT_DIVISOR.
+const CHUNK_DIGITS = new Uint8Array(17);
+const CHUNK_POWERS = new Float64Array(17);
+
+for (let base = 2; base <= 16; base++) {
+  let k = 0;
+  let m = 1;
+
+  while (m * base < SHORT_DIVISOR) {
+    k += 1;
+    m *= base;
+  }
+
+  CHUNK_DIGITS[base] = k;
+  CHUNK_POWERS[base] = m;
+}
+
+const CHUNK_ZEROS = '000000000000000000000';
+
+/*
+ * N128 (abstract)
+ *
+ * Kept as four int32 words, most significant
+ * first (w3 holds bits 96-127).
+ */
+
+function N128(sign) {
+  enforce(this instanceof N128, 'this', 'N128');
+  enforce(sign === 0 || sign === 1, 'sign', 'bit');
+
+  this.w3 = 0;
+  this.w2 = 0;
+  this.w1 = 0;
+  this.w0 = 0;
+  this.sign = sign;
+}
+
+/*
+ * Addition
+ */
+
+N128.prototype._add = function _add(b3, b2, b1, b0) {
+  let t = (this.w0 >>> 0) + (b0 >>> 0);
+  let c = t > 0xffffffff ? 1 : 0;
+
+  this.w0 = t | 0;
+
+  t = (this.w1 >>> 0) + (b1 >>> 0) + c;
+  c = t > 0xffffffff ? 1 : 0;
+  this.w1 = t | 0;
+
+  t = (this.w2 >>> 0) + (b2 >>> 0) + c;
+  c = t > 0xffffffff ? 1 : 0;
+  this.w2 = t | 0;
+
+  this.w3 = (this.w3 + b3 + c) | 0;
+
+  return this;
+};
+
+N128.prototype.iadd = function iadd(b) {
+  enforce(N128.isN128(b), 'operand', 'int128');
+  return this._add(b.w3, b.w2, b.w1, b.w0);
+};
+
+N128.prototype.iaddn = function iaddn(num) {
+  enforce(isNumber(num), 'operand', 'number');
+  const ext = (num >> 31) & -this.sign;
+  return this._add(ext, ext, ext, num | 0);
+};
+
+N128.prototype.add = function add(b) {
+  return this.clone().iadd(b);
+};
+
+N128.prototype.addn = function addn(num) {
+  return this.clone().iaddn(num);
+};
+
+/*
+ * Subtraction
+ */
+
+N128.prototype._sub = function _sub(b3, b2, b1, b0) {
+  let t = (this.w0 >>> 0) - (b0 >>> 0);
+  let c = t < 0 ? 1 : 0;
+
+  this.w0 = t | 0;
+
+  t = (this.w1 >>> 0) - (b1 >>> 0) - c;
+  c = t < 0 ? 1 : 0;
+  this.w1 = t | 0;
+
+  t = (this.w2 >>> 0) - (b2 >>> 0) - c;
+  c = t < 0 ? 1 : 0;
+  this.w2 = t | 0;
+
+  this.w3 = (this.w3 - b3 - c) | 0;
+
+  return this;
+};
+
+N128.prototype.isub = function isub(b) {
+  enforce(N128.isN128(b), 'operand', 'int128');
+  return this._sub(b.w3, b.w2, b.w1, b.w0);
+};
+
+N128.prototype.isubn = function isubn(num) {
+  enforce(isNumber(num), 'operand', 'number');
+  const ext = (num >> 31) & -this.sign;
+  return this._sub(ext, ext, ext, num | 0);
+};
+
+N128.prototype.sub = function sub(b) {
+  return this.clone().isub(b);
+};
+
+N128.prototype.subn = function subn(num) {
+  return this.clone().isubn(num);
+};
+
+/*
+ * Multiplication
+ */
+
+N128.prototype._mul = function _mul(b3, b2, b1, b0) {
+  // Schoolbook over 16 bit limbs, dropping everything
+  // above 128 bits. Eight partial products of 32 bits
+  // each fit comfortably in a double.
+  const a = LIMBS_A;
+  const b = LIMBS_B;
+
+  toLimbs(a, this.w3, this.w2, this.w1, this.w0);
+  toLimbs(b, b3, b2, b1, b0);
+
+  let carry = 0;
+
+  for (let k = 0; k < 8; k++) {
+    let sum = carry;
+
+    for (let i = 0; i <= k; i++)
+      sum += a[i] * b[k - i];
+
+    const lo = sum % 0x10000;
+
+    carry = (sum - lo) / 0x10000;
+
+    if (k & 1)
+      LIMBS_R[k >>> 1] |= lo << 16;
+    else
+      LIMBS_R[k >>> 1] = lo;
+  }
+
+  this.w0 = LIMBS_R[0];
+  this.w1 = LIMBS_R[1];
+  this.w2 = LIMBS_R[2];
+  this.w3 = LIMBS_R[3];
+
+  return this;
+};
+
+N128.prototype.imul = function imul(b) {
+  enforce(N128.isN128(b), 'multiplicand', 'int128');
+  return this._mul(b.w3, b.w2, b.w1, b.w0);
+};
+
+N128.prototype.imuln = function imuln(num) {
+  enforce(isNumber(num), 'multiplicand', 'number');
+  const ext = (num >> 31) & -this.sign;
+  return this._mul(ext, ext, ext, num | 0);
+};
+
+N128.prototype.mul = function mul(b) {
+  return this.clone().imul(b);
+};
+
+N128.prototype.muln = function muln(num) {
+  return this.clone().imuln(num);
+};
+
+/*
+ * Division
+ */
+
+N128.prototype._divmod = function _divmod(b, mod) {
+  // Divides magnitudes and fixes up the signs after,
+  // which truncates toward zero like the native code.
+  const nneg = this.isNeg();
+  const dneg = b.isNeg();
+  const n = this.toU128();
+  const d = b.toU128();
+
+  if (nneg)
+    n.ineg();
+
+  if (dneg)
+    d.ineg();
+
+  const r = udivmod(n, d);
+  const neg = mod ? nneg : nneg !== dneg;
+  const out = mod ? r : n;
+
+  this.w3 = out.w3;
+  this.w2 = out.w2;
+  this.w1 = out.w1;
+  this.w0 = out.w0;
+
+  if (neg)
+    this.ineg();
+
+  return this;
+};
+
+N128.prototype.idiv = function idiv(b) {
+  enforce(N128.isN128(b), 'divisor', 'int128');
+
+  if (b.isZero())
+    throw new Error('Cannot divide by zero.');
+
+  return this._divmod(b, false);
+};
+
+N128.prototype.idivn = function idivn(num) {
+  enforce(isNumber(num), 'divisor', 'number');
+  return this.idiv(this._small(num));
+};
+
+N128.prototype.div = function div(b) {
+  return this.clone().idiv(b);
+};
+
+N128.prototype.divn = function divn(num) {
+  return this.clone().idivn(num);
+};
+
+N128.prototype.tryIdiv = function tryIdiv(b) {
+  enforce(N128.isN128(b), 'divisor', 'int128');
+
+  if (b.isZero())
+    return false;
+
+  this._divmod(b, false);
+
+  return true;
+};
+
+N128.prototype.tryDiv = function tryDiv(b) {
+  enforce(N128.isN128(b), 'divisor', 'int128');
+
+  if (b.isZero())
+    return null;
+
+  return this.clone().idiv(b);
+};
+
+/*
+ * Modulo
+ */
+
+N128.prototype.imod = function imod(b) {
+  enforce(N128.isN128(b), 'divisor', 'int128');
+
+  if (b.isZero())
+    throw new Error('Cannot divide by zero.');
+
+  return this._divmod(b, true);
+};
+
+N128.prototype.imodn = function imodn(num) {
+  enforce(isNumber(num), 'divisor', 'number');
+  return this.imod(this._small(num));
+};
+
+N128.prototype.mod = function mod(b) {
+  return this.clone().imod(b);
+};
+
+N128.prototype.modn = function modn(num) {
+  return this.clone().imodn(num);
+};
+
+N128.prototype.tryImod = function tryImod(b) {
+  enforce(N128.isN128(b), 'divisor', 'int128');
+
+  if (b.isZero())
+    return false;
+
+  this._divmod(b, true);
+
+  return true;
+};
+
+N128.prototype.tryMod = function tryMod(b) {
+  enforce(N128.isN128(b), 'divisor', 'int128');
+
+  if (b.isZero())
+    return null;
+
+  return this.clone().imod(b);
+};
+
+/*
+ * Exponentiation
+ */
+
+N128.prototype.ipow = function ipow(b) {
+  enforce(N128.isN128(b), 'exponent', 'int128');
+  return this.ipown(b.w0);
+};
+
+N128.prototype.ipown = function ipown(num) {
+  enforce(isNumber(num), 'exponent', 'number');
+
+  if (this.isZero())
+    return this;
+
+  const x = this.clone();
+  const n = this;
+
+  let y = num >>> 0;
+
+  n.join(0, 0, 0, 1);
+
+  while (y > 0) {
+    if (y & 1)
+      n.imul(x);
+    y >>>= 1;
+    x.imul(x);
+  }
+
+  return n;
+};
+
+N128.prototype.pow = function pow(b) {
+  return this.clone().ipow(b);
+};
+
+N128.prototype.pown = function pown(num) {
+  return this.clone().ipown(num);
+};
+
+N128.prototype.sqr = function sqr() {
+  return this.mul(this);
+};
+
+N128.prototype.isqr = function isqr() {
+  return this.imul(this);
+};
+
+/*
+ * AND
+ */
+
+N128.prototype.iand = function iand(b) {
+  enforce(N128.isN128(b), 'operand', 'int128');
+  this.w3 &= b.w3;
+  this.w2 &= b.w2;
+  this.w1 &= b.w1;
+  this.w0 &= b.w0;
+  return this;
+};
+
+N128.prototype.iandn = function iandn(num) {
+  enforce(isNumber(num), 'operand', 'number');
+  const ext = (num >> 31) & -this.sign;
+  this.w3 &= ext;
+  this.w2 &= ext;
+  this.w1 &= ext;
+  this.w0 &= num;
+  return this;
+};
+
+N128.prototype.and = function and(b) {
+  return this.clone().iand(b);
+};
+
+N128.prototype.andn = function andn(num) {
+  return this.clone().iandn(num);
+};
+
+/*
+ * OR
+ */
+
+N128.prototype.ior = function ior(b) {
+  enforce(N128.isN128(b), 'operand', 'int128');
+  this.w3 |= b.w3;
+  this.w2 |= b.w2;
+  this.w1 |= b.w1;
+  this.w0 |= b.w0;
+  return this;
+};
+
+N128.prototype.iorn = function iorn(num) {
+  enforce(isNumber(num), 'operand', 'number');
+  const ext = (num >> 31) & -this.sign;
+  this.w3 |= ext;
+  this.w2 |= ext;
+  this.w1 |= ext;
+  this.w0 |= num;
+  return this;
+};
+
+N128.prototype.or = function or(b) {
+  return this.clone().ior(b);
+};
+
+N128.prototype.orn = function orn(num) {
+  return this.clone().iorn(num);
+};
+
+/*
+ * XOR
+ */
+
+N128.prototype.ixor = function ixor(b) {
+  enforce(N128.isN128(b), 'operand', 'int128');
+  this.w3 ^= b.w3;
+  this.w2 ^= b.w2;
+  this.w1 ^= b.w1;
+  this.w0 ^= b.w0;
+  return this;
+};
+
+N128.prototype.ixorn = function ixorn(num) {
+  enforce(isNumber(num), 'operand', 'number');
+  const ext = (num >> 31) & -this.sign;
+  this.w3 ^= ext;
+  this.w2 ^= ext;
+  this.w1 ^= ext;
+  this.w0 ^= num;
+  return this;
+};
+
+N128.prototype.xor = function xor(b) {
+  return this.clone().ixor(b);
+};
+
+N128.prototype.xorn = function xorn(num) {
+  return this.clone().ixorn(num);
+};
+
+/*
+ * NOT
+ */
+
+N128.prototype.inot = function inot() {
+  this.w3 = ~this.w3;
+  this.w2 = ~this.w2;
+  this.w1 = ~this.w1;
+  this.w0 = ~this.w0;
+  return this;
+};
+
+N128.prototype.not = function not() {
+  return this.clone().inot();
+};
+
+/*
+ * Left Shift
+ */
+
+N128.prototype.ishl = function ishl(b) {
+  enforce(N128.isN128(b), 'bits', 'int128');
+  return this.ishln(b.w0);
+};
+
+N128.prototype.ishln = function ishln(bits) {
+  enforce(isNumber(bits), 'bits', 'number');
+
+  bits &= 127;
+
+  const words = bits >>> 5;
+  const shift = bits & 31;
+  const w = [this.w0, this.w1, this.w2, this.w3];
+
+  for (let i = 3; i >= 0; i--) {
+    const j = i - words;
+
+    let x = 0;
+
+    if (j >= 0) {
+      x = w[j] << shift;
+      if (shift !== 0 && j > 0)
+        x |= w[j - 1] >>> (32 - shift);
+    }
+
+    w[i] = x;
+  }
+
+  this.w0 = w[0];
+  this.w1 = w[1];
+  this.w2 = w[2];
+  this.w3 = w[3];
+
+  return this;
+};
+
+N128.prototype.shl = function shl(b) {
+  return this.clone().ishl(b);
+};
+
+N128.prototype.shln = function shln(bits) {
+  return this.clone().ishln(bits);
+};
+
+/*
+ * Right Shift
+ */
+
+N128.prototype._shr = function _shr(bits, fill) {
+  const words = bits >>> 5;
+  const shift = bits & 31;
+  const w = [this.w0, this.w1, this.w2, this.w3];
+
+  for (let i = 0; i < 4; i++) {
+    const j = i + words;
+    const x = j < 4 ? w[j] : fill;
+    const y = j + 1 < 4 ? w[j + 1] : fill;
+
+    if (shift === 0)
+      w[i] = x;
+    else
+      w[i] = (x >>> shift) | (y << (32 - shift));
+  }
+
+  this.w0 = w[0];
+  this.w1 = w[1];
+  this.w2 = w[2];
+  this.w3 = w[3];
+
+  return this;
+};
+
+N128.prototype.ishr = function ishr(b) {
+  enforce(N128.isN128(b), 'bits', 'int128');
+  return this.ishrn(b.w0);
+};
+
+N128.prototype.ishrn = function ishrn(bits) {
+  enforce(isNumber(bits), 'bits', 'number');
+  return this._shr(bits & 127, this.isNeg() ? -1 : 0);
+};
+
+N128.prototype.shr = function shr(b) {
+  return this.clone().ishr(b);
+};
+
+N128.prototype.shrn = function shrn(bits) {
+  return this.clone().ishrn(bits);
+};
+
+/*
+ * Unsigned Right Shift
+ */
+
+N128.prototype.iushr = function iushr(b) {
+  enforce(N128.isN128(b), 'bits', 'int128');
+  return this.iushrn(b.w0);
+};
+
+N128.prototype.iushrn = function iushrn(bits) {
+  enforce(isNumber(bits), 'bits', 'number');
+  return this._shr(bits & 127, 0);
+};
+
+N128.prototype.ushr = function ushr(b) {
+  return this.clone().iushr(b);
+};
+
+N128.prototype.ushrn = function ushrn(bits) {
+  return this.clone().iushrn(bits);
+};
+
+/*
+ * Bit Manipulation
+ */
+
+N128.prototype._word = function _word(i) {
+  switch (i & 3) {
+    case 0:
+      return this.w0;
+    case 1:
+      return this.w1;
+    case 2:
+      return this.w2;
+  }
+  return this.w3;
+};
+
+N128.prototype._setWord = function _setWord(i, w) {
+  switch (i & 3) {
+    case 0:
+      this.w0 = w | 0;
+      break;
+    case 1:
+      this.w1 = w | 0;
+      break;
+    case 2:
+      this.w2 = w | 0;
+      break;
+    default:
+      this.w3 = w | 0;
+      break;
+  }
+};
+
+N128.prototype.setn = function setn(bit, val) {
+  enforce(isNumber(bit), 'bit', 'number');
+
+  bit &= 127;
+
+  const i = bit >>> 5;
+  const w = this._word(i);
+
+  if (val)
+    this._setWord(i, w | (1 << (bit & 31)));
+  else
+    this._setWord(i, w & ~(1 << (bit & 31)));
+
+  return this;
+};
+
+N128.prototype.testn = function testn(bit) {
+  enforce(isNumber(bit), 'bit', 'number');
+  bit &= 127;
+  return (this._word(bit >>> 5) >>> (bit & 31)) & 1;
+};
+
+N128.prototype.setb = function setb(pos, ch) {
+  enforce(isNumber(pos), 'pos', 'number');
+  enforce(isNumber(ch), 'ch', 'number');
+
+  pos &= 15;
+
+  const i = pos >>> 2;
+  const s = (pos & 3) * 8;
+
+  this._setWord(i, (this._word(i) & ~(0xff << s)) | ((ch & 0xff) << s));
+
+  return this;
+};
+
+N128.prototype.orb = function orb(pos, ch) {
+  enforce(isNumber(pos), 'pos', 'number');
+  enforce(isNumber(ch), 'ch', 'number');
+
+  pos &= 15;
+
+  const i = pos >>> 2;
+
+  this._setWord(i, this._word(i) | ((ch & 0xff) << ((pos & 3) * 8)));
+
+  return this;
+};
+
+N128.prototype.getb = function getb(pos) {
+  enforce(isNumber(pos), 'pos', 'number');
+  pos &= 15;
+  return (this._word(pos >>> 2) >>> ((pos & 3) * 8)) & 0xff;
+};
+
+N128.prototype.imaskn = function imaskn(bit) {
+  enforce(isNumber(bit), 'bit', 'number');
+
+  bit &= 127;
+
+  const i = bit >>> 5;
+
+  if ((bit & 31) !== 0)
+    this._setWord(i, this._word(i) & ((1 << (bit & 31)) - 1));
+  else
+    this._setWord(i, 0);
+
+  for (let j = i + 1; j < 4; j++)
+    this._setWord(j, 0);
+
+  return this;
+};
+
+N128.prototype.maskn = function maskn(bit) {
+  return this.clone().imaskn(bit);
+};
+
+N128.prototype.andln = function andln(num) {
+  enforce(isNumber(num), 'operand', 'number');
+  return this.w0 & num;
+};
+
+/*
+ * Negation
+ */
+
+N128.prototype.ineg = function ineg() {
+  return this.inot()._add(0, 0, 0, 1);
+};
+
+N128.prototype.neg = function neg() {
+  return this.clone().ineg();
+};
+
+N128.prototype.iabs = function iabs() {
+  if (this.isNeg())
+    this.ineg();
+  return this;
+};
+
+N128.prototype.abs = function abs() {
+  return this.clone().iabs();
+};
+
+/*
+ * Comparison
+ */
+
+N128.prototype._cmp = function _cmp(b3, b2, b1, b0) {
+  let a3 = this.w3;
+
+  if (!this.sign) {
+    a3 >>>= 0;
+    b3 >>>= 0;
+  }
+
+  if (a3 !== b3)
+    return a3 < b3 ? -1 : 1;
+
+  if (this.w2 !== b2)
+    return (this.w2 >>> 0) < (b2 >>> 0) ? -1 : 1;
+
+  if (this.w1 !== b1)
+    return (this.w1 >>> 0) < (b1 >>> 0) ? -1 : 1;
+
+  if (this.w0 !== b0)
+    return (this.w0 >>> 0) < (b0 >>> 0) ? -1 : 1;
+
+  return 0;
+};
+
+N128.prototype.cmp = function cmp(b) {
+  enforce(N128.isN128(b), 'value', 'int128');
+  return this._cmp(b.w3, b.w2, b.w1, b.w0);
+};
+
+N128.prototype.cmpn = function cmpn(num) {
+  enforce(isNumber(num), 'value', 'number');
+  const ext = (num >> 31) & -this.sign;
+  return this._cmp(ext, ext, ext, num | 0);
+};
+
+N128.prototype.eq = function eq(b) {
+  enforce(N128.isN128(b), 'value', 'int128');
+  return this.w3 === b.w3 && this.w2 === b.w2
+      && this.w1 === b.w1 && this.w0 === b.w0;
+};
+
+N128.prototype.eqn = function eqn(num) {
+  enforce(isNumber(num), 'value', 'number');
+  return this.cmpn(num) === 0;
+};
+
+N128.prototype.gt = function gt(b) {
+  return this.cmp(b) > 0;
+};
+
+N128.prototype.gtn = function gtn(num) {
+  return this.cmpn(num) > 0;
+};
+
+N128.prototype.gte = function gte(b) {
+  return this.cmp(b) >= 0;
+};
+
+N128.prototype.gten = function gten(num) {
+  return this.cmpn(num) >= 0;
+};
+
+N128.prototype.lt = function lt(b) {
+  return this.cmp(b) < 0;
+};
+
+N128.prototype.ltn = function ltn(num) {
+  return this.cmpn(num) < 0;
+};
+
+N128.prototype.lte = function lte(b) {
+  return this.cmp(b) <= 0;
+};
+
+N128.prototype.lten = function lten(num) {
+  return this.cmpn(num) <= 0;
+};
+
+N128.prototype.isZero = function isZero() {
+  return (this.w3 | this.w2 | this.w1 | this.w0) === 0;
+};
+
+N128.prototype.isNeg = function isNeg() {
+  return this.sign === 1 && this.w3 < 0;
+};
+
+N128.prototype.isOdd = function isOdd() {
+  return (this.w0 & 1) === 1;
+};
+
+N128.prototype.isEven = function isEven() {
+  return (this.w0 & 1) === 0;
+};
+
+/*
+ * Helpers
+ */
+
+N128.prototype.clone = function clone() {
+  const n = new this.constructor();
+  n.w3 = this.w3;
+  n.w2 = this.w2;
+  n.w1 = this.w1;
+  n.w0 = this.w0;
+  return n;
+};
+
+N128.prototype.inject = function inject(b) {
+  enforce(N128.isN128(b), 'value', 'int128');
+  this.w3 = b.w3;
+  this.w2 = b.w2;
+  this.w1 = b.w1;
+  this.w0 = b.w0;
+  return this;
+};
+
+N128.prototype.set = function set(num) {
+  enforce(isSafeInteger(num), 'number', 'integer');
+
+  let neg = false;
+
+  if (num < 0) {
+    num = -num;
+    neg = true;
+  }
+
+  this.w3 = 0;
+  this.w2 = 0;
+  this.w1 = (num * (1 / 0x100000000)) | 0;
+  this.w0 = num | 0;
+
+  if (neg)
+    this.ineg();
+
+  return this;
+};
+
+N128.prototype.join = function join(w3, w2, w1, w0) {
+  enforce(isNumber(w3), 'word', 'number');
+  enforce(isNumber(w2), 'word', 'number');
+  enforce(isNumber(w1), 'word', 'number');
+  enforce(isNumber(w0), 'word', 'number');
+  this.w3 = w3 | 0;
+  this.w2 = w2 | 0;
+  this.w1 = w1 | 0;
+  this.w0 = w0 | 0;
+  return this;
+};
+
+N128.prototype._small = function _small(num) {
+  const n = new this.constructor();
+  const ext = (num >> 31) & -this.sign;
+  return n.join(ext, ext, ext, num);
+};
+
+N128.prototype.bitLength = function bitLength() {
+  let a = this;
+
+  if (this.isNeg())
+    a = this.neg();
+
+  if (a.w3 !== 0)
+    return countBits(a.w3) + 96;
+
+  if (a.w2 !== 0)
+    return countBits(a.w2) + 64;
+
+  if (a.w1 !== 0)
+    return countBits(a.w1) + 32;
+
+  return countBits(a.w0);
+};
+
+N128.prototype.byteLength = function byteLength() {
+  return Math.ceil(this.bitLength() / 8);
+};
+
+N128.prototype.isSafe = function isSafe() {
+  return this.bitLength() <= 53;
+};
+
+N128.prototype.inspect = function inspect() {
+  let prefix = 'I128';
+
+  if (!this.sign)
+    prefix = 'U128';
+
+  return `<${prefix}: ${this.toString(10)}>`;
+};
+
+/*
+ * Encoding
+ */
+
+N128.prototype.readLE = function readLE(data, off) {
+  enforce(data && typeof data.length === 'number', 'data', 'arraylike');
+  enforce((off >> 0) === off, 'offset', 'integer');
+  enforce(off + 16 <= data.length, 'offset', 'valid offset');
+  this.w0 = readI32LE(data, off);
+  this.w1 = readI32LE(data, off + 4);
+  this.w2 = readI32LE(data, off + 8);
+  this.w3 = readI32LE(data, off + 12);
+  return off + 16;
+};
+
+N128.prototype.readBE = function readBE(data, off) {
+  enforce(data && typeof data.length === 'number', 'data', 'arraylike');
+  enforce((off >> 0) === off, 'offset', 'integer');
+  enforce(off + 16 <= data.length, 'offset', 'valid offset');
+  this.w3 = readI32BE(data, off);
+  this.w2 = readI32BE(data, off + 4);
+  this.w1 = readI32BE(data, off + 8);
+  this.w0 = readI32BE(data, off + 12);
+  return off + 16;
+};
+
+N128.prototype.readRaw = function readRaw(data, off) {
+  return this.readLE(data, off);
+};
+
+N128.prototype.writeLE = function writeLE(data, off) {
+  enforce(data && typeof data.length === 'number', 'data', 'arraylike');
+  enforce((off >> 0) === off, 'offset', 'integer');
+  enforce(off + 16 <= data.length, 'offset', 'valid offset');
+  writeI32LE(data, this.w0, off);
+  writeI32LE(data, this.w1, off + 4);
+  writeI32LE(data, this.w2, off + 8);
+  writeI32LE(data, this.w3, off + 12);
+  return off + 16;
+};
+
+N128.prototype.writeBE = function writeBE(data, off) {
+  enforce(data && typeof data.length === 'number', 'data', 'arraylike');
+  enforce((off >> 0) === off, 'offset', 'integer');
+  enforce(off + 16 <= data.length, 'offset', 'valid offset');
+  writeI32BE(data, this.w3, off);
+  writeI32BE(data, this.w2, off + 4);
+  writeI32BE(data, this.w1, off + 8);
+  writeI32BE(data, this.w0, off + 12);
+  return off + 16;
+};
+
+N128.prototype.writeRaw = function writeRaw(data, off) {
+  return this.writeLE(data, off);
+};
+
+/*
+ * Conversion
+ */
+
+N128.prototype.toU128 = function toU128() {
+  return new U128().join(this.w3, this.w2, this.w1, this.w0);
+};
+
+N128.prototype.toI128 = function toI128() {
+  return new I128().join(this.w3, this.w2, this.w1, this.w0);
+};
+
+N128.prototype._fits = function _fits(sign) {
+  // Whether the value narrows to a U64 or I64 as is.
+  if (this.isNeg())
+    return sign === 1 && this.w3 === -1 && this.w2 === -1 && this.w1 < 0;
+
+  return this.w3 === 0 && this.w2 === 0 && (sign === 0 || this.w1 >= 0);
+};
+
+N128.prototype.toU64 = function toU64() {
+  const n = this.tryToU64();
+
+  if (!n)
+    throw new Error('Number out of range.');
+
+  return n;
+};
+
+N128.prototype.toI64 = function toI64() {
+  const n = this.tryToI64();
+
+  if (!n)
+    throw new Error('Number out of range.');
+
+  return n;
+};
+
+N128.prototype.tryToU64 = function tryToU64() {
+  if (!this._fits(0))
+    return null;
+
+  return U64.fromBits(this.w1, this.w0);
+};
+
+N128.prototype.tryToI64 = function tryToI64() {
+  if (!this._fits(1))
+    return null;
+
+  return I64.fromBits(this.w1, this.w0);
+};
+
+N128.prototype.toNumber = function toNumber() {
+  if (!this.isSafe())
+    throw new Error('Number exceeds 53 bits.');
+
+  return this.toDouble();
+};
+
+N128.prototype.tryToNumber = function tryToNumber() {
+  if (!this.isSafe())
+    return NaN;
+
+  return this.toDouble();
+};
+
+N128.prototype.toDouble = function toDouble() {
+  // Rounds half to even from the full value, so
+  // that both backends agree on every input.
+  const neg = this.isNeg();
+  const n = this.toU128();
+
+  if (neg)
+    n.ineg();
+
+  const shift = n.bitLength() - 53;
+
+  let z;
+
+  if (shift <= 0) {
+    z = (n.w1 >>> 0) * 0x100000000 + (n.w0 >>> 0);
+  } else {
+    const rest = n.maskn(shift);
+    const half = new U128().setn(shift - 1, 1);
+    const cmp = rest.cmp(half);
+
+    n.iushrn(shift);
+
+    z = (n.w1 >>> 0) * 0x100000000 + (n.w0 >>> 0);
+
+    if (cmp > 0 || (cmp === 0 && (n.w0 & 1)))
+      z += 1;
+
+    z *= Math.pow(2, shift);
+  }
+
+  return neg ? -z : z;
+};
+
+N128.prototype.toInt = function toInt() {
+  return this.sign ? this.w0 : this.w0 >>> 0;
+};
+
+N128.prototype.toBool = function toBool() {
+  return !this.isZero();
+};
+
+N128.prototype.toBits = function toBits() {
+  return [this.w3, this.w2, this.w1, this.w0];
+};
+
+N128.prototype.toObject = function toObject() {
+  const hi = this.sign ? new I64() : new U64();
+  return { hi: hi.join(this.w3, this.w2), lo: U64.fromBits(this.w1, this.w0) };
+};
+
+N128.prototype.toString = function toString(base, pad) {
+  base = getBase(base);
+
+  if (pad == null)
+    pad = 0;
+
+  enforce((base >>> 0) === base, 'base', 'integer');
+  enforce((pad >>> 0) === pad, 'pad', 'integer');
+
+  if (base < 2 || base > 16)
+    throw new Error('Base ranges between 2 and 16.');
+
+  if (pad > 128)
+    throw new Error('Maximum padding is 128 characters.');
+
+  const neg = this.isNeg();
+  const n = this.toU128();
+
+  if (neg)
+    n.ineg();
+
+  // Peel off a chunk of digits per division.
+  let chunk = base;
+  let digits = 1;
+
+  while (chunk * base < SHORT_DIVISOR) {
+    chunk *= base;
+    digits += 1;
+  }
+
+  let str = '';
+
+  for (;;) {
+    let r = shortDiv(n, chunk);
+
+    if (n.isZero()) {
+      str = r.toString(base) + str;
+      break;
+    }
+
+    for (let i = 0; i < digits; i++) {
+      const ch = r % base;
+      r = (r - ch) / base;
+      str = ch.toString(base) + str;
+    }
+  }
+
+  while (str.length < pad)
+    str = '0' + str;
+
+  if (neg)
+    str = '-' + str;
+
+  return str;
+};
+
+N128.prototype.toJSON = function toJSON() {
+  return this.toString(16, 32);
+};
+
+N128.prototype.toBN = function toBN(BN) {
+  const neg = this.isNeg();
+  const n = neg ? this.neg() : this;
+  const num = new BN(0);
+
+  for (const w of [n.w3, n.w2, n.w1, n.w0]) {
+    num.ishln(32);
+    num.iadd(new BN(w >>> 0));
+  }
+
+  if (neg)
+    num.ineg();
+
+  return num;
+};
+
+N128.prototype.toLE = function toLE(ArrayLike) {
+  enforce(typeof ArrayLike === 'function', 'ArrayLike', 'constructor');
+  const data = alloc(ArrayLike, 16);
+  this.writeLE(data, 0);
+  return data;
+};
+
+N128.prototype.toBE = function toBE(ArrayLike) {
+  enforce(typeof ArrayLike === 'function', 'ArrayLike', 'constructor');
+  const data = alloc(ArrayLike, 16);
+  this.writeBE(data, 0);
+  return data;
+};
+
+N128.prototype.toRaw = function toRaw(ArrayLike) {
+  return this.toLE(ArrayLike);
+};
+
+/*
+ * Instantiation
+ */
+
+N128.prototype.fromNumber = function fromNumber(num) {
+  return this.set(num);
+};
+
+N128.prototype.fromInt = function fromInt(num) {
+  enforce(isNumber(num), 'integer', 'number');
+  const ext = (num >> 31) & -this.sign;
+  return this.join(ext, ext, ext, num);
+};
+
+N128.prototype.fromBool = function fromBool(value) {
+  enforce(typeof value === 'boolean', 'value', 'boolean');
+  return this.join(0, 0, 0, value ? 1 : 0);
+};
+
+N128.prototype.fromBits = function fromBits(w3, w2, w1, w0) {
+  return this.join(w3, w2, w1, w0);
+};
+
+N128.prototype.fromN64 = function fromN64(num) {
+  enforce(N64.isN64(num), 'number', 'int64');
+
+  if (!this.sign && num.isNeg())
+    throw new Error('Number out of range.');
+
+  const ext = num.isNeg() ? -1 : 0;
+
+  return this.join(ext, ext, num.hi, num.lo);
+};
+
+N128.prototype.fromObject = function fromObject(num) {
+  enforce(num && typeof num === 'object', 'number', 'object');
+  enforce(N64.isN64(num.hi), 'hi', 'int64');
+  enforce(N64.isN64(num.lo), 'lo', 'int64');
+  return this.join(num.hi.hi, num.hi.lo, num.lo.hi, num.lo.lo);
+};
+
+N128.prototype._read = function _read(str, base) {
+  if (base < 2 || base > 16)
+    return 'Base ranges between 2 and 16.';
+
+  let neg = false;
+  let i = 0;
+
+  if (str.length > 0 && str[0] === '-') {
+    i += 1;
+    neg = true;
+  }
+
+  if (str.length === i || str.length > i + 128)
+    return 'Invalid string (bad length).';
+
+  const w = [0, 0, 0, 0];
+
+  for (; i < str.length; i++) {
+    let ch = str.charCodeAt(i);
+
+    if (ch >= 0x30 && ch <= 0x39)
+      ch -= 0x30;
+    else if (ch >= 0x41 && ch <= 0x5a)
+      ch -= 0x41 - 10;
+    else if (ch >= 0x61 && ch <= 0x7a)
+      ch -= 0x61 - 10;
+    else
+      ch = base;
+
+    if (ch >= base)
+      return 'Invalid string (parse error).';
+
+    let carry = ch;
+
+    for (let j = 0; j < 4; j++) {
+      const t = w[j] * base + carry;
+      const lo = t % 0x100000000;
+
+      carry = (t - lo) / 0x100000000;
+      w[j] = lo;
+    }
+
+    if (carry !== 0)
+      return 'Invalid string (overflow).';
+  }
+
+  this.join(w[3], w[2], w[1], w[0]);
+
+  if (neg)
+    this.ineg();
+
+  return null;
+};
+
+N128.prototype.fromString = function fromString(str, base) {
+  base = getBase(base);
+
+  enforce(typeof str === 'string', 'string', 'string');
+  enforce((base >>> 0) === base, 'base', 'integer');
+
+  const err = this._read(str, base);
+
+  if (err !== null)
+    throw new Error(err);
+
+  return this;
+};
+
+N128.prototype.tryFromString = function tryFromString(str, base) {
+  base = getBase(base);
+
+  enforce((base >>> 0) === base, 'base', 'integer');
+
+  if (base < 2 || base > 16)
+    throw new Error('Base ranges between 2 and 16.');
+
+  if (typeof str !== 'string')
+    return false;
+
+  return this._read(str, base) === null;
+};
+
+N128.prototype.tryFromNumber = function tryFromNumber(num) {
+  if (!isSafeInteger(num))
+    return false;
+
+  this.set(num);
+
+  return true;
+};
+
+N128.prototype.fromJSON = function fromJSON(json) {
+  return this.fromString(json, 16);
+};
+
+N128.prototype.fromBN = function fromBN(num) {
+  enforce(num && isArray(num.words), 'number', 'big number');
+
+  const a = this;
+  const b = num.clone();
+  const neg = b.isNeg();
+
+  if (a.sign && b.testn(127))
+    throw new Error('Big number overflow.');
+
+  a.join(0, 0, 0, 0);
+
+  let i = 0;
+
+  while (!b.isZero()) {
+    if (i === 16)
+      throw new Error('Big number overflow.');
+
+    a.orb(i, b.andln(0xff));
+    b.iushrn(8);
+    i++;
+  }
+
+  if (neg)
+    a.ineg();
+
+  return a;
+};
+
+N128.prototype.fromLE = function fromLE(data) {
+  this.readLE(data, 0);
+  return this;
+};
+
+N128.prototype.fromBE = function fromBE(data) {
+  this.readBE(data, 0);
+  return this;
+};
+
+N128.prototype.fromRaw = function fromRaw(data) {
+  return this.fromLE(data);
+};
+
+N128.prototype.from = function from(num, base) {
+  if (num == null)
+    return this;
+
+  if (typeof num === 'number')
+    return this.fromNumber(num);
+
+  if (typeof num === 'string')
+    return this.fromString(num, base);
+
+  if (typeof num === 'object') {
+    if (N64.isN64(num))
+      return this.fromN64(num);
+
+    if (N128.isN128(num))
+      return this.inject(num);
+
+    if (isArray(num.words))
+      return this.fromBN(num);
+
+    if (typeof num.length === 'number')
+      return this.fromRaw(num);
+
+    return this.fromObject(num);
+  }
+
+  if (typeof num === 'boolean')
+    return this.fromBool(num);
+
+  throw new TypeError('Non-numeric object passed to N128.');
+};
+
+/*
+ * Static Methods
+ */
+
+N128.min = function min(a, b) {
+  return a.cmp(b) < 0 ? a : b;
+};
+
+N128.max = function max(a, b) {
+  return a.cmp(b) > 0 ? a : b;
+};
+
+N128.random = function random() {
+  return new this().join((Math.random() * 0x100000000) | 0,
+                         (Math.random() * 0x100000000) | 0,
+                         (Math.random() * 0x100000000) | 0,
+                         (Math.random() * 0x100000000) | 0);
+};
+
+N128.pow = function pow(num, exp) {
+  return new this().fromInt(num).ipown(exp);
+};
+
+N128.shift = function shift(num, bits) {
+  return new this().fromInt(num).ishln(bits);
+};
+
+N128.readLE = function readLE(data, off) {
+  const n = new this();
+  n.readLE(data, off);
+  return n;
+};
+
+N128.readBE = function readBE(data, off) {
+  const n = new this();
+  n.readBE(data, off);
+  return n;
+};
+
+N128.readRaw = function readRaw(data, off) {
+  const n = new this();
+  n.readRaw(data, off);
+  return n;
+};
+
+N128.fromNumber = function fromNumber(num) {
+  return new this().fromNumber(num);
+};
+
+N128.tryFromNumber = function tryFromNumber(num) {
+  const n = new this();
+  return n.tryFromNumber(num) ? n : null;
+};
+
+N128.fromInt = function fromInt(num) {
+  return new this().fromInt(num);
+};
+
+N128.fromBool = function fromBool(value) {
+  return new this().fromBool(value);
+};
+
+N128.fromBits = function fromBits(w3, w2, w1, w0) {
+  return new this().fromBits(w3, w2, w1, w0);
+};
+
+N128.fromN64 = function fromN64(num) {
+  return new this().fromN64(num);
+};
+
+N128.fromObject = function fromObject(obj) {
+  return new this().fromObject(obj);
+};
+
+N128.fromString = function fromString(str, base) {
+  return new this().fromString(str, base);
+};
+
+N128.tryFromString = function tryFromString(str, base) {
+  const n = new this();
+  return n.tryFromString(str, base) ? n : null;
+};
+
+N128.fromJSON = function fromJSON(json) {
+  return new this().fromJSON(json);
+};
+
+N128.fromBN = function fromBN(num) {
+  return new this().fromBN(num);
+};
+
+N128.fromLE = function fromLE(data) {
+  return new this().fromLE(data);
+};
+
+N128.fromBE = function fromBE(data) {
+  return new this().fromBE(data);
+};
+
+N128.fromRaw = function fromRaw(data) {
+  return new this().fromRaw(data);
+};
+
+N128.from = function from(num, base) {
+  return new this().from(num, base);
+};
+
+N128.isN128 = function isN128(obj) {
+  return obj instanceof N128;
+};
+
+N128.isU128 = function isU128(obj) {
+  return obj instanceof U128;
+};
+
+N128.isI128 = function isI128(obj) {
+  return obj instanceof I128;
+};
+
+/*
+ * U128
+ */
+
+function U128(num, base) {
+  if (!(this instanceof U128))
+    return new U128(num, base);
+
+  N128.call(this, 0);
+
+  this.from(num, base);
+}
+
+U128.__proto__ = N128;
+U128.prototype.__proto__ = N128.prototype;
+
+/*
+ * Constants
+ */
+
+U128.UINT128_MIN = U128.fromBits(0, 0, 0, 0);
+U128.UINT128_MAX = U128.fromBits(-1, -1, -1, -1);
+
+/*
+ * I128
+ */
+
+function I128(num, base) {
+  if (!(this instanceof I128))
+    return new I128(num, base);
+
+  N128.call(this, 1);
+
+  this.from(num, base);
+}
+
+I128.__proto__ = N128;
+I128.prototype.__proto__ = N128.prototype;
+
+/*
+ * Constants
+ */
+
+I128.INT128_MIN = I128.fromBits(0x80000000, 0, 0, 0);
+I128.INT128_MAX = I128.fromBits(0x7fffffff, -1, -1, -1);
+
+/*
+ * N128 Helpers
+ */
+
+const LIMBS_A = new Array(8);
+const LIMBS_B = new Array(8);
+const LIMBS_R = new Int32Array(4);
+
+function toLimbs(out, w3, w2, w1, w0) {
+  out[0] = w0 & 0xffff;
+  out[1] = w0 >>> 16;
+  out[2] = w1 & 0xffff;
+  out[3] = w1 >>> 16;
+  out[4] = w2 & 0xffff;
+  out[5] = w2 >>> 16;
+  out[6] = w3 & 0xffff;
+  out[7] = w3 >>> 16;
+}
+
+function shortDiv(n, d) {
+  // Divides an unsigned value in place by d < 2^21
+  // and returns the remainder.
+  let r = 0;
+
+  for (let i = 3; i >= 0; i--) {
+    const t = r * 0x100000000 + (n._word(i) >>> 0);
+    const q = Math.floor(t / d);
+
+    r = t - q * d;
+
+    n._setWord(i, q);
+  }
+
+  return r;
+}
+
+function udivmod(n, d) {
+  // Unsigned. Leaves the quotient in n and
+  // returns the remainder.
+  if (d.w3 === 0 && d.w2 === 0 && d.w1 === 0
+      && (d.w0 >>> 0) < SHORT_DIVISOR) {
+    return new U128().join(0, 0, 0, shortDiv(n, d.w0 >>> 0));
+  }
+
+  const shift = n.bitLength() - d.bitLength();
+
+  if (shift < 0) {
+    const r = n.clone();
+    n.join(0, 0, 0, 0);
+    return r;
+  }
+
+  // Shift and subtract, starting from the divisor
+  // lined up with the top bit. Words are kept in
+  // locals as unsigned values to avoid allocating.
+  const s = d.shln(shift);
+
+  let r3 = n.w3 >>> 0;
+  let r2 = n.w2 >>> 0;
+  let r1 = n.w1 >>> 0;
+  let r0 = n.w0 >>> 0;
+  let s3 = s.w3 >>> 0;
+  let s2 = s.w2 >>> 0;
+  let s1 = s.w1 >>> 0;
+  let s0 = s.w0 >>> 0;
+  let q3 = 0;
+  let q2 = 0;
+  let q1 = 0;
+  let q0 = 0;
+
+  for (let i = shift; i >= 0; i--) {
+    if (r3 > s3 || (r3 === s3
+        && (r2 > s2 || (r2 === s2
+        && (r1 > s1 || (r1 === s1 && r0 >= s0)))))) {
+      let t = r0 - s0;
+      r0 = t >>> 0;
+      t = r1 - s1 - (t < 0);
+      r1 = t >>> 0;
+      t = r2 - s2 - (t < 0);
+      r2 = t >>> 0;
+      r3 = (r3 - s3 - (t < 0)) >>> 0;
+
+      const bit = 1 << (i & 31);
+
+      switch (i >>> 5) {
+        case 0: q0 |= bit; break;
+        case 1: q1 |= bit; break;
+        case 2: q2 |= bit; break;
+        case 3: q3 |= bit; break;
+      }
+    }
+
+    s0 = ((s0 >>> 1) | (s1 << 31)) >>> 0;
+    s1 = ((s1 >>> 1) | (s2 << 31)) >>> 0;
+    s2 = ((s2 >>> 1) | (s3 << 31)) >>> 0;
+    s3 >>>= 1;
+  }
+
+  n.join(q3, q2, q1, q0);
+
+  return s.join(r3, r2, r1, r0);
+}
+
+/*
+ * Widening
+ */
+
+N64.prototype.toU128 = function toU128() {
+  return U128.fromN64(this);
+};
+
+N64.prototype.toI128 = function toI128() {
+  return I128.fromN64(this);
+};
+
+/*
+ * RNG
+ *
+ * xoshiro256** by David Blackman and Sebastiano Vigna:
+ *   http://prng.di.unimi.it/xoshiro256starstar.c
+ *
+ * The state is kept as eight int32 words to
+ * avoid allocating during generation.
+ */
+
+function RNG(ctor, seed) {
+  if (!(this instanceof RNG))
+    return new RNG(ctor, seed);
+
+  if (ctor == null)
+    ctor = U64;
+
+  enforce(typeof ctor === 'function', 'ctor', 'constructor');
+
+  this.ctor = ctor;
+
+  this.s0h = 0;
+  this.s0l = 0;
+  this.s1h = 0;
+  this.s1l = 0;
+  this.s2h = 0;
+  this.s2l = 0;
+  this.s3h = 0;
+  this.s3l = 0;
+
+  this.seed(seed);
+}
+
+RNG.prototype.seed = function seed(value) {
+  const x = toSeed(value);
+  const s = [];
+
+  // Expand the seed with splitmix64.
+  for (let i = 0; i < 4; i++) {
+    const z = x.iadd(SPLITMIX_GAMMA).clone();
+    z.ixor(z.ushrn(30)).imul(SPLITMIX_MUL1);
+    z.ixor(z.ushrn(27)).imul(SPLITMIX_MUL2);
+    z.ixor(z.ushrn(31));
+    s.push(z);
+  }
+
+  this.s0h = s[0].hi;
+  this.s0l = s[0].lo;
+  this.s1h = s[1].hi;
+  this.s1l = s[1].lo;
+  this.s2h = s[2].hi;
+  this.s2l = s[2].lo;
+  this.s3h = s[3].hi;
+  this.s3l = s[3].lo;
+
+  return this;
+};
+
+RNG.prototype._next = function _next(out) {
+  const s1h = this.s1h;
+  const s1l = this.s1l;
+
+  // r = rotl(s1 * 5, 7) * 9
+  let l = (s1l >>> 0) + ((s1l << 2) >>> 0);
+  let h = (s1h + ((s1h << 2) | (s1l >>> 30)) + (l > 0xffffffff ? 1 : 0)) | 0;
+
+  l |= 0;
+
+  const rh = (h << 7) | (l >>> 25);
+  const rl = (l << 7) | (h >>> 25);
+
+  l = (rl >>> 0) + ((rl << 3) >>> 0);
+  h = (rh + ((rh << 3) | (rl >>> 29)) + (l > 0xffffffff ? 1 : 0)) | 0;
+
+  out.hi = h;
+  out.lo = l | 0;
+
+  // t = s1 << 17
+  const th = (s1h << 17) | (s1l >>> 15);
+  const tl = s1l << 17;
+
+  this.s2h ^= this.s0h;
+  this.s2l ^= this.s0l;
+  this.s3h ^= s1h;
+  this.s3l ^= s1l;
+  this.s1h = s1h ^ this.s2h;
+  this.s1l = s1l ^ this.s2l;
+  this.s0h ^= this.s3h;
+  this.s0l ^= this.s3l;
+
+  this.s2h ^= th;
+  this.s2l ^= tl;
+
+  // s3 = rotl(s3, 45)
+  h = this.s3h;
+  l = this.s3l;
+
+  this.s3h = (l << 13) | (h >>> 19);
+  this.s3l = (h << 13) | (l >>> 19);
+
+  return out;
+};
+
+RNG.prototype.next = function next(out) {
+  if (out == null)
+    out = new this.ctor();
+
+  enforce(N64.isN64(out), 'out', 'int64');
+
+  return this._next(out);
+};
+
+RNG.prototype.nextBelow = function nextBelow(bound, out) {
+  if (typeof bound === 'number')
+    bound = I64.fromNumber(bound);
+
+  enforce(N64.isN64(bound), 'bound', 'int64');
+
+  if (bound.isZero() || bound.isNeg())
+    throw new RangeError('Bound must be positive.');
+
+  if (out == null)
+    out = new this.ctor();
+
+  enforce(N64.isN64(out), 'out', 'int64');
+
+  // Reject the low `2^64 % bound` outputs
+  // so that every residue is equally likely.
+  const b = bound.toU64();
+  const threshold = b.neg().imod(b);
+  const r = new U64();
+
+  do {
+    this._next(r);
+  } while (r.lt(threshold));
+
+  return out.inject(r.imod(b));
+};
+
+RNG.prototype.jump = function jump() {
+  const r = { hi: 0, lo: 0 };
+
+  let s0h = 0;
+  let s0l = 0;
+  let s1h = 0;
+  let s1l = 0;
+  let s2h = 0;
+  let s2l = 0;
+  let s3h = 0;
+  let s3l = 0;
+
+  for (let i = 0; i < RNG_JUMP.length; i++) {
+    for (let b = 0; b < 32; b++) {
+      if ((RNG_JUMP[i] >>> b) & 1) {
+        s0h ^= this.s0h;
+        s0l ^= this.s0l;
+        s1h ^= this.s1h;
+        s1l ^= this.s1l;
+        s2h ^= this.s2h;
+        s2l ^= this.s2l;
+        s3h ^= this.s3h;
+        s3l ^= this.s3l;
+      }
+      this._next(r);
+    }
+  }
+
+  this.s0h = s0h;
+  this.s0l = s0l;
+  this.s1h = s1h;
+  this.s1l = s1l;
+  this.s2h = s2h;
+  this.s2l = s2l;
+  this.s3h = s3h;
+  this.s3l = s3l;
+
+  return this;
+};
+
+RNG.prototype.fill = function fill(data) {
+  if (data instanceof N64Array) {
+    const {words, off, length} = data;
+    this.fill(words.subarray(off * 2, (off + length) * 2));
+    return data;
+  }
+
+  enforce(data && typeof data.byteLength === 'number', 'data', 'typed array');
+
+  const bytes = new Uint8Array(data.buffer, data.byteOffset, data.byteLength);
+  const r = { hi: 0, lo: 0 };
+
+  let i = 0;
+
+  for (; i + 8 <= bytes.length; i += 8) {
+    this._next(r);
+    writeI32LE(bytes, r.lo, i);
+    writeI32LE(bytes, r.hi, i + 4);
+  }
+
+  if (i < bytes.length) {
+    const tail = new Uint8Array(8);
+
+    this._next(r);
+
+    writeI32LE(tail, r.lo, 0);
+    writeI32LE(tail, r.hi, 4);
+
+    for (let j = 0; i < bytes.length; i++, j++)
+      bytes[i] = tail[j];
+  }
+
+  return data;
+};
+
+RNG.prototype.clone = function clone() {
+  const r = new RNG(this.ctor, 0);
+  r.s0h = this.s0h;
+  r.s0l = this.s0l;
+  r.s1h = this.s1h;
+  r.s1l = this.s1l;
+  r.s2h = this.s2h;
+  r.s2l = this.s2l;
+  r.s3h = this.s3h;
+  r.s3l = this.s3l;
+  return r;
+};
+
+/*
+ * RNG Constants
+ */
+
+const SPLITMIX_GAMMA = U64(0x9e3779b9, 0x7f4a7c15);
+const SPLITMIX_MUL1 = U64(0xbf58476d, 0x1ce4e5b9);
+const SPLITMIX_MUL2 = U64(0x94d049bb, 0x133111eb);
+
+// Jump polynomial as little-endian 32 bit words.
+const RNG_JUMP = [
+  0x3cfd0aba, 0x180ec6d3,
+  0xf0c9392c, 0xd5a61266,
+  0xe03fc9aa, 0xa9582618,
+  0x29b1661c, 0x39abdc45
+];
+
+/*
+ * Histogram
+ *
+ * A log-linear (HDR) histogram, laid out as in
+ * HdrHistogram by Gil Tene:
+ *   https://github.com/HdrHistogram/HdrHistogram
+ *
+ * Counts are kept as pairs of uint32 words (low
+ * word first) so that they wrap like the native
+ * uint64 counters, and values are only ever read
+ * from their halves to avoid allocating.
+ */
+
+function Histogram(ctor, options) {
+  if (!(this instanceof Histogram))
+    return new Histogram(ctor, options);
+
+  if (ctor == null)
+    ctor = U64;
+
+  enforce(typeof ctor === 'function', 'ctor', 'constructor');
+
+  const [lowest, highest, digits] = toLayout(options);
+
+  this.ctor = ctor;
+  this.sign = new ctor().sign;
+  this.tmp = new U64();
+
+  this.lowest = null;
+  this.highest = null;
+  this.digits = 0;
+  this.unit = 0;
+  this.shift = 0;
+  this.maskHi = 0;
+  this.maskLo = 0;
+  this.len = 0;
+  this.counts = null;
+
+  this.totalHi = 0;
+  this.totalLo = 0;
+  this.minHi = 0;
+  this.minLo = 0;
+  this.maxHi = 0;
+  this.maxLo = 0;
+
+  if (!this._layout(lowest, highest, digits))
+    throw new Error('Invalid histogram range.');
+}
+
+Histogram.prototype._layout = function _layout(lowest, highest, digits) {
+  if (lowest.isZero() || highest.ushrn(1).lt(lowest))
+    return false;
+
+  // Values below 2 * 10^digits get a slot each.
+  const shift = countBits(2 * Math.pow(10, digits) - 1) - 1;
+  const unit = lowest.bitLength() - 1;
+
+  if (unit + shift > 61)
+    return false;
+
+  const smallest = U64.fromNumber(2).ishln(shift + unit);
+  const mask = U64.fromNumber(2 * (1 << shift) - 1).ishln(unit);
+
+  let buckets = 1;
+
+  while (smallest.lte(highest)) {
+    if (smallest.testn(63)) {
+      buckets += 1;
+      break;
+    }
+
+    smallest.ishln(1);
+    buckets += 1;
+  }
+
+  this.lowest = lowest.toU64();
+  this.highest = highest.toU64();
+  this.digits = digits;
+  this.unit = unit;
+  this.shift = shift;
+  this.maskHi = mask.hi;
+  this.maskLo = mask.lo;
+  this.len = (buckets + 1) << shift;
+  this.counts = new Uint32Array(this.len * 2);
+
+  this._clear();
+
+  return true;
+};
+
+Histogram.prototype._clear = function _clear() {
+  this.totalHi = 0;
+  this.totalLo = 0;
+  this.minHi = 0xffffffff;
+  this.minLo = 0xffffffff;
+  this.maxHi = 0;
+  this.maxLo = 0;
+};
+
+Histogram.prototype._index = function _index(hi, lo) {
+  const mh = hi | this.maskHi;
+  const bits = mh !== 0
+    ? 64 - Math.clz32(mh)
+    : 32 - Math.clz32(lo | this.maskLo);
+  const bucket = bits - this.unit - (this.shift + 1);
+  const s = bucket + this.unit;
+
+  let sub;
+
+  if (s >= 32)
+    sub = hi >>> (s - 32);
+  else if (s === 0)
+    sub = lo >>> 0;
+  else
+    sub = ((lo >>> s) | (hi << (32 - s))) >>> 0;
+
+  return ((bucket + 1) << this.shift) + (sub - (1 << this.shift));
+};
+
+// Writes the lowest value in a slot to HIST_SLOT,
+// along with log2 of the number sharing it.
+Histogram.prototype._value = function _value(index) {
+  const half = 1 << this.shift;
+
+  let bucket = (index >>> this.shift) - 1;
+  let sub = (index & (half - 1)) + half;
+
+  if (bucket < 0) {
+    sub -= half;
+    bucket = 0;
+  }
+
+  const e = bucket + this.unit;
+
+  if (e >= 32) {
+    HIST_SLOT[0] = sub << (e - 32);
+    HIST_SLOT[1] = 0;
+  } else if (e === 0) {
+    HIST_SLOT[0] = 0;
+    HIST_SLOT[1] = sub;
+  } else {
+    HIST_SLOT[0] = sub >>> (32 - e);
+    HIST_SLOT[1] = sub << e;
+  }
+
+  HIST_SLOT[2] = e;
+};
+
+Histogram.prototype._add = function _add(index, hi, lo) {
+  const c = this.counts;
+  const j = index * 2;
+  const sum = c[j] + (lo >>> 0);
+
+  c[j] = sum;
+  c[j + 1] += (hi >>> 0) + (sum > 0xffffffff ? 1 : 0);
+};
+
+Histogram.prototype._total = function _total(hi, lo) {
+  const sum = this.totalLo + (lo >>> 0);
+
+  this.totalLo = sum >>> 0;
+  this.totalHi = (this.totalHi + (hi >>> 0) + (sum > 0xffffffff ? 1 : 0)) >>> 0;
+};
+
+Histogram.prototype._bound = function _bound(hi, lo) {
+  hi >>>= 0;
+  lo >>>= 0;
+
+  if (hi < this.minHi || (hi === this.minHi && lo < this.minLo)) {
+    this.minHi = hi;
+    this.minLo = lo;
+  }
+
+  if (hi > this.maxHi || (hi === this.maxHi && lo > this.maxLo)) {
+    this.maxHi = hi;
+    this.maxLo = lo;
+  }
+};
+
+// The slots holding the smallest and largest values
+// recorded. Only meaningful for a non-empty histogram.
+Histogram.prototype._span = function _span() {
+  let first = this._index(this.minHi, this.minLo);
+  let last = this._index(this.maxHi, this.maxLo);
+
+  if (last >= this.len)
+    last = this.len - 1;
+
+  if (first > last)
+    first = 0;
+
+  return [first, last];
+};
+
+Histogram.prototype._end = function _end() {
+  const c = this.counts;
+
+  let end = this.len;
+
+  while (end > 0 && c[end * 2 - 2] === 0 && c[end * 2 - 1] === 0)
+    end -= 1;
+
+  return end;
+};
+
+Histogram.prototype.record = function record(value, count) {
+  const num = toHistValue(value, this.tmp);
+  const hi = num.hi;
+  const lo = num.lo;
+
+  if (count == null)
+    count = 1;
+
+  const index = this._index(hi, lo);
+
+  if ((this.sign && hi < 0) || index >= this.len)
+    throw new Error('Value out of range.');
+
+  const n = toHistValue(count, this.tmp);
+
+  if (n.hi === 0 && n.lo === 0)
+    return this;
+
+  this._add(index, n.hi, n.lo);
+  this._total(n.hi, n.lo);
+  this._bound(hi, lo);
+
+  return this;
+};
+
+Histogram.prototype.recordMany = function recordMany(data) {
+  const bytes = toBytes(data);
+  const bad = [];
+
+  let recorded = 0;
+
+  if (bytes.length & 7)
+    throw new Error('Invalid buffer length.');
+
+  for (let i = 0; i < bytes.length; i += 8) {
+    const lo = readI32LE(bytes, i);
+    const hi = readI32LE(bytes, i + 4);
+    const index = this._index(hi, lo);
+
+    if ((this.sign && hi < 0) || index >= this.len) {
+      bad.push(i >>> 3);
+      continue;
+    }
+
+    this._add(index, 0, 1);
+    this._bound(hi, lo);
+
+    recorded += 1;
+  }
+
+  this._total(0, recorded);
+
+  return new Uint32Array(bad);
+};
+
+Histogram.prototype.percentile = function percentile(p, out) {
+  enforce(typeof p === 'number' && p >= 0 && p <= 100, 'p', 'percentage');
+
+  if (out == null)
+    out = new this.ctor();
+
+  enforce(N64.isN64(out), 'out', 'int64');
+
+  if (this.totalHi === 0 && this.totalLo === 0)
+    return out.join(0, 0);
+
+  const c = this.counts;
+  const total = this.totalHi * 0x100000000 + this.totalLo;
+  const want = Math.floor((p / 100) * total + 0.5);
+
+  let th = this.totalHi;
+  let tl = this.totalLo;
+  let sh = 0;
+  let sl = 0;
+
+  if (want < 0x10000000000000000) {
+    const wh = Math.floor(want / 0x100000000);
+    const wl = want - wh * 0x100000000;
+
+    if (wh < th || (wh === th && wl < tl)) {
+      th = wh;
+      tl = wl;
+    }
+  }
+
+  if (th === 0 && tl === 0)
+    tl = 1;
+
+  const [first, last] = this._span();
+  const hh = this.totalHi >>> 1;
+  const hl = ((this.totalLo >>> 1) | (this.totalHi << 31)) >>> 0;
+
+  let i;
+
+  // High percentiles are found from the top.
+  if (th > hh || (th === hh && tl > hl)) {
+    const rl = this.totalLo - tl;
+    const rh = this.totalHi - th - (rl < 0 ? 1 : 0);
+    const restLo = rl >>> 0;
+
+    for (i = last; i >= first; i--) {
+      const sum = sl + c[i * 2];
+
+      sl = sum >>> 0;
+      sh = (sh + c[i * 2 + 1] + (sum > 0xffffffff ? 1 : 0)) >>> 0;
+
+      if (sh > rh || (sh === rh && sl > restLo))
+        break;
+    }
+  } else {
+    for (i = first; i <= last; i++) {
+      const sum = sl + c[i * 2];
+
+      sl = sum >>> 0;
+      sh = (sh + c[i * 2 + 1] + (sum > 0xffffffff ? 1 : 0)) >>> 0;
+
+      if (sh > th || (sh === th && sl >= tl))
+        break;
+    }
+  }
+
+  if (i < first || i > last)
+    return out.join(this.maxHi, this.maxLo);
+
+  this._value(i);
+
+  const e = HIST_SLOT[2];
+
+  let hi = HIST_SLOT[0] >>> 0;
+  let lo = HIST_SLOT[1] >>> 0;
+
+  if (e >= 32) {
+    hi = (hi | (2 ** (e - 32) - 1)) >>> 0;
+    lo = 0xffffffff;
+  } else {
+    lo = (lo | (2 ** e - 1)) >>> 0;
+  }
+
+  // Capped at the largest value recorded.
+  if (hi > this.maxHi || (hi === this.maxHi && lo > this.maxLo)) {
+    hi = this.maxHi;
+    lo = this.maxLo;
+  }
+
+  return out.join(hi, lo);
+};
+
+Histogram.prototype.mean = function mean() {
+  if (this.totalHi === 0 && this.totalLo === 0)
+    return 0;
+
+  const c = this.counts;
+  const [first, last] = this._span();
+
+  let sum = 0;
+
+  for (let i = first; i <= last; i++) {
+    const cl = c[i * 2];
+    const ch = c[i * 2 + 1];
+
+    if (cl === 0 && ch === 0)
+      continue;
+
+    this._value(i);
+
+    const e = HIST_SLOT[2];
+
+    let hi = HIST_SLOT[0] >>> 0;
+    let lo = HIST_SLOT[1] >>> 0;
+
+    // The middle of the slot.
+    if (e > 32)
+      hi = (hi | (1 << (e - 33))) >>> 0;
+    else if (e > 0)
+      lo = (lo | (2 ** (e - 1))) >>> 0;
+
+    sum += (hi * 0x100000000 + lo) * (ch * 0x100000000 + cl);
+  }
+
+  return sum / (this.totalHi * 0x100000000 + this.totalLo);
+};
+
+Histogram.prototype.count = function count(out) {
+  if (out == null)
+    out = new U64();
+
+  enforce(N64.isN64(out), 'out', 'int64');
+
+  return out.join(this.totalHi, this.totalLo);
+};
+
+Histogram.prototype.min = function min(out) {
+  if (out == null)
+    out = new this.ctor();
+
+  enforce(N64.isN64(out), 'out', 'int64');
+
+  if (this.totalHi === 0 && this.totalLo === 0)
+    return out.join(0, 0);
+
+  return out.join(this.minHi, this.minLo);
+};
+
+Histogram.prototype.max = function max(out) {
+  if (out == null)
+    out = new this.ctor();
+
+  enforce(N64.isN64(out), 'out', 'int64');
+
+  if (this.totalHi === 0 && this.totalLo === 0)
+    return out.join(0, 0);
+
+  return out.join(this.maxHi, this.maxLo);
+};
+
+Histogram.prototype.merge = function merge(other) {
+  enforce(other instanceof Histogram, 'other', 'histogram');
+
+  const end = other._end();
+  const c = other.counts;
+
+  if (end === 0)
+    return this;
+
+  // Slots are monotonic, so checking the
+  // last one covers every other.
+  other._value(end - 1);
+
+  const top = this._index(HIST_SLOT[0], HIST_SLOT[1]);
+
+  if ((this.sign && HIST_SLOT[0] < 0) || top >= this.len)
+    throw new Error('Value out of range.');
+
+  const same = this.unit === other.unit && this.shift === other.shift;
+
+  for (let i = 0; i < end; i++) {
+    const cl = c[i * 2];
+    const ch = c[i * 2 + 1];
+
+    if (cl === 0 && ch === 0)
+      continue;
+
+    if (same) {
+      this._add(i, ch, cl);
+    } else {
+      other._value(i);
+      this._add(this._index(HIST_SLOT[0], HIST_SLOT[1]), ch, cl);
+    }
+  }
+
+  const {minHi, minLo, maxHi, maxLo, totalHi, totalLo} = other;
+
+  this._total(totalHi, totalLo);
+
+  if (totalHi !== 0 || totalLo !== 0) {
+    this._bound(minHi, minLo);
+    this._bound(maxHi, maxLo);
+  }
+
+  return this;
+};
+
+Histogram.prototype.reset = function reset() {
+  this.counts.fill(0);
+  this._clear();
+  return this;
+};
+
+Histogram.prototype.clone = function clone() {
+  const h = Object.create(Histogram.prototype);
+
+  Object.assign(h, this);
+
+  h.tmp = new U64();
+  h.counts = this.counts.slice();
+
+  return h;
+};
+
+// A count is written as is. Zeros are written as
+// a 0 followed by the length of the run.
+Histogram.prototype.encode = function encode(reserve) {
+  const end = this._end();
+
+  let size = reserve;
+
+  for (let pass = 0; pass < 2; pass++) {
+    const data = pass ? new Uint8Array(size) : null;
+    const c = this.counts;
+
+    let off = reserve;
+
+    if (data)
+      data[off] = this.digits;
+
+    off += 1;
+    off = writeVarint(data, off, this.lowest.hi, this.lowest.lo);
+    off = writeVarint(data, off, this.highest.hi, this.highest.lo);
+    off = writeVarint(data, off, this.minHi, this.minLo);
+    off = writeVarint(data, off, this.maxHi, this.maxLo);
+    off = writeVarint(data, off, 0, end);
+
+    for (let i = 0; i < end;) {
+      if (c[i * 2] !== 0 || c[i * 2 + 1] !== 0) {
+        off = writeVarint(data, off, c[i * 2 + 1], c[i * 2]);
+        i += 1;
+        continue;
+      }
+
+      let run = 0;
+
+      while (c[(i + run) * 2] === 0 && c[(i + run) * 2 + 1] === 0)
+        run += 1;
+
+      off = writeVarint(data, off, 0, 0);
+      off = writeVarint(data, off, 0, run);
+
+      i += run;
+    }
+
+    if (data)
+      return data;
+
+    size = off;
+  }
+
+  return null;
+};
+
+Histogram.decode = function decode(ctor, data) {
+  const h = Object.create(Histogram.prototype);
+  const v = HIST_SLOT;
+
+  let pos = 1;
+
+  h.ctor = ctor;
+  h.sign = new ctor().sign;
+  h.tmp = new U64();
+
+  if (data.length < 1)
+    throw new Error('Invalid message.');
+
+  const bounds = [];
+
+  for (let i = 0; i < 4; i++) {
+    pos = readVarint(data, pos);
+
+    if (pos < 0)
+      throw new Error('Invalid message.');
+
+    bounds.push(v[0] >>> 0, v[1] >>> 0);
+  }
+
+  const digits = data[0];
+  const lowest = U64.fromBits(bounds[0], bounds[1]);
+  const highest = U64.fromBits(bounds[2], bounds[3]);
+
+  if (digits < 1 || digits > 5 || !h._layout(lowest, highest, digits))
+    throw new Error('Invalid message.');
+
+  pos = readVarint(data, pos);
+
+  if (pos < 0 || v[0] !== 0 || (v[1] >>> 0) > h.len)
+    throw new Error('Invalid message.');
+
+  const end = v[1] >>> 0;
+
+  let i = 0;
+
+  while (i < end) {
+    pos = readVarint(data, pos);
+
+    if (pos < 0)
+      throw new Error('Invalid message.');
+
+    if (v[0] !== 0 || v[1] !== 0) {
+      h._add(i, v[0], v[1]);
+      h._total(v[0], v[1]);
+      i += 1;
+      continue;
+    }
+
+    pos = readVarint(data, pos);
+
+    if (pos < 0 || v[0] !== 0 || v[1] === 0 || (v[1] >>> 0) > end - i)
+      throw new Error('Invalid message.');
+
+    i += v[1] >>> 0;
+  }
+
+  if (pos !== data.length)
+    throw new Error('Invalid message.');
+
+  h.minHi = bounds[4];
+  h.minLo = bounds[5];
+  h.maxHi = bounds[6];
+  h.maxLo = bounds[7];
+
+  return h;
+};
+
+/*
+ * Histogram Helpers
+ */
+
+function toHistValue(value, tmp) {
+  if (N64.isN64(value))
+    return value;
+
+  if (typeof value === 'number')
+    return tmp.set(value);
+
+  enforce(value && typeof value === 'object', 'value', 'int64');
+
+  return U64.fromObject(value);
+}
+
+function writeVarint(data, off, hi, lo) {
+  hi >>>= 0;
+  lo >>>= 0;
+
+  for (;;) {
+    const ch = lo & 0x7f;
+
+    lo = ((lo >>> 7) | (hi << 25)) >>> 0;
+    hi >>>= 7;
+
+    if (hi === 0 && lo === 0) {
+      if (data)
+        data[off] = ch;
+      return off + 1;
+    }
+
+    if (data)
+      data[off] = ch | 0x80;
+
+    off += 1;
+  }
+}
+
+// Reads into HIST_SLOT. Returns -1 on malformed input.
+function readVarint(data, pos) {
+  let hi = 0;
+  let lo = 0;
+
+  for (let i = 0; i < 10; i++) {
+    if (pos >= data.length)
+      return -1;
+
+    const ch = data[pos++];
+    const bits = ch & 0x7f;
+    const s = i * 7;
+
+    // Only one bit is left for the tenth byte.
+    if (i === 9 && ch > 1)
+      return -1;
+
+    if (s < 32) {
+      lo |= bits << s;
+
+      if (s > 25)
+        hi |= bits >>> (32 - s);
+    } else {
+      hi |= bits << (s - 32);
+    }
+
+    if ((ch & 0x80) === 0) {
+      HIST_SLOT[0] = hi;
+      HIST_SLOT[1] = lo;
+      return pos;
+    }
+  }
+
+  return -1;
+}
+
+/*
+ * Histogram Constants
+ */
+
+const HIST_SLOT = new Int32Array(3);
+
+/*
+ * Struct
+ */
+
+function Struct(fields) {
+  if (!(this instanceof Struct))
+    return new Struct(fields);
+
+  const [items, size] = toFields(fields);
+
+  this.size = size;
+  this.fields = items;
+}
+
+Struct.prototype.create = function create() {
+  const out = {};
+
+  for (const field of this.fields) {
+    if (field.width === 8)
+      out[field.name] = field.sign ? new I64() : new U64();
+    else
+      out[field.name] = 0;
+  }
+
+  return out;
+};
+
+Struct.prototype.decode = function decode(data, off, out) {
+  const bytes = toBytes(data);
+
+  if (off == null)
+    off = 0;
+
+  if (out == null)
+    out = this.create();
+
+  enforce((off >>> 0) === off, 'offset', 'integer');
+  enforce(out && typeof out === 'object', 'out', 'object');
+
+  if (off + this.size > bytes.length)
+    throw new Error('Invalid range.');
+
+  for (const field of this.fields) {
+    const pos = off + field.offset;
+
+    if (field.width !== 8) {
+      out[field.name] = readField(bytes, pos, field);
+      continue;
+    }
+
+    let num = out[field.name];
+
+    if (!N64.isN64(num)) {
+      num = field.sign ? new I64() : new U64();
+      out[field.name] = num;
+    }
+
+    if (field.be) {
+      num.hi = readI32BE(bytes, pos);
+      num.lo = readI32BE(bytes, pos + 4);
+    } else {
+      num.lo = readI32LE(bytes, pos);
+      num.hi = readI32LE(bytes, pos + 4);
+    }
+  }
+
+  return out;
+};
+
+Struct.prototype.decodeMany = function decodeMany(data, off, count) {
+  const bytes = toBytes(data);
+  const {size} = this;
+
+  if (off == null)
+    off = 0;
+
+  enforce((off >>> 0) === off, 'offset', 'integer');
+
+  if (count == null)
+    count = Math.floor(Math.max(0, bytes.length - off) / size);
+
+  enforce((count >>> 0) === count, 'count', 'integer');
+
+  if (off + count * size > bytes.length)
+    throw new Error('Invalid range.');
+
+  const columns = {};
+
+  for (const field of this.fields) {
+    const column = toColumn(field, count);
+
+    let pos = off + field.offset;
+
+    if (field.width === 8) {
+      const {words} = column;
+
+      for (let i = 0; i < count * 2; i += 2) {
+        if (field.be) {
+          words[i + 1] = readI32BE(bytes, pos);
+          words[i] = readI32BE(bytes, pos + 4);
+        } else {
+          words[i] = readI32LE(bytes, pos);
+          words[i + 1] = readI32LE(bytes, pos + 4);
+        }
+
+        pos += size;
+      }
+    } else {
+      for (let i = 0; i < count; i++) {
+        column[i] = readField(bytes, pos, field);
+        pos += size;
+      }
+    }
+
+    columns[field.name] = column;
+  }
+
+  return columns;
+};
+
+Struct.prototype.encode = function encode(value, data, off) {
+  if (off == null)
+    off = 0;
+
+  if (data == null)
+    data = new Uint8Array(off + this.size);
+
+  enforce(value && typeof value === 'object', 'value', 'object');
+
+  const bytes = toBytes(data);
+
+  enforce((off >>> 0) === off, 'offset', 'integer');
+
+  if (off + this.size > bytes.length)
+    throw new Error('Invalid range.');
+
+  for (const field of this.fields) {
+    const pos = off + field.offset;
+    const num = value[field.name];
+
+    if (field.width !== 8) {
+      // Wraps like the typed array of the same width.
+      enforce(typeof num === 'number', 'value', 'number');
+      writeField(bytes, pos, field, num | 0);
+      continue;
+    }
+
+    let hi, lo;
+
+    if (N64.isN64(num)) {
+      hi = num.hi;
+      lo = num.lo;
+    } else {
+      enforce(Number.isSafeInteger(num), 'value', 'int64');
+      hi = Math.floor(num / 0x100000000) | 0;
+      lo = num | 0;
+    }
+
+    if (field.be) {
+      writeI32BE(bytes, hi, pos);
+      writeI32BE(bytes, lo, pos + 4);
+    } else {
+      writeI32LE(bytes, lo, pos);
+      writeI32LE(bytes, hi, pos + 4);
+    }
+  }
+
+  return data;
+};
+
+Struct.prototype.encodeMany = function encodeMany(columns, data, off) {
+  enforce(columns && typeof columns === 'object', 'columns', 'object');
+
+  if (off == null)
+    off = 0;
+
+  enforce((off >>> 0) === off, 'offset', 'integer');
+
+  const {size} = this;
+
+  let count = -1;
+
+  for (const field of this.fields) {
+    const column = columns[field.name];
+
+    enforce(isColumn(column, field), field.name, 'column');
+
+    if (count === -1)
+      count = column.length;
+
+    if (column.length !== count)
+      throw new Error('Invalid columns.');
+  }
+
+  if (data == null)
+    data = new Uint8Array(off + count * size);
+
+  const bytes = toBytes(data);
+
+  if (off + count * size > bytes.length)
+    throw new Error('Invalid range.');
+
+  for (const field of this.fields) {
+    const column = columns[field.name];
+
+    let pos = off + field.offset;
+
+    if (field.width === 8) {
+      const {words} = column;
+      const start = column.off * 2;
+
+      for (let i = start; i < start + count * 2; i += 2) {
+        if (field.be) {
+          writeI32BE(bytes, words[i + 1], pos);
+          writeI32BE(bytes, words[i], pos + 4);
+        } else {
+          writeI32LE(bytes, words[i], pos);
+          writeI32LE(bytes, words[i + 1], pos + 4);
+        }
+
+        pos += size;
+      }
+    } else {
+      for (let i = 0; i < count; i++) {
+        writeField(bytes, pos, field, column[i]);
+        pos += size;
+      }
+    }
+  }
+
+  return data;
+};
+
+/*
+ * Dec64
+ *
+ * A fixed-point decimal stored as an I64 in units
+ * of 10^-scale. Products and quotients go through
+ * 128 bit intermediates, so only the final result
+ * must fit in 64 bits.
+ */
+
+function Dec64(scale) {
+  if (!(this instanceof Dec64))
+    return new Dec64(scale);
+
+  if (scale == null)
+    scale = 0;
+
+  enforce(isScale(scale), 'scale', 'scale');
+
+  this.n = new I64();
+  this.scale = scale;
+}
+
+/*
+ * Rounding Modes
+ */
+
+Dec64.ROUND_DOWN = 0;
+Dec64.ROUND_UP = 1;
+Dec64.ROUND_FLOOR = 2;
+Dec64.ROUND_CEIL = 3;
+Dec64.ROUND_HALF_UP = 4;
+Dec64.ROUND_HALF_DOWN = 5;
+Dec64.ROUND_HALF_EVEN = 6;
+
+/*
+ * Arithmetic
+ */
+
+Dec64.prototype._add = function _add(b, sub) {
+  const s = Math.max(this.scale, b.scale);
+  const x = decScale(this.n, s - this.scale);
+  const y = decScale(b.n, s - b.scale);
+
+  if (!x || !y)
+    throw new Error('Decimal overflow.');
+
+  const r = sub ? x.sub(y) : x.add(y);
+  const xs = x.hi >> 31;
+  const ys = y.hi >> 31;
+  const rs = r.hi >> 31;
+
+  if (sub ? ((xs ^ ys) & (xs ^ rs)) : (~(xs ^ ys) & (xs ^ rs)))
+    throw new Error('Decimal overflow.');
+
+  this.n = r;
+  this.scale = s;
+
+  return this;
+};
+
+Dec64.prototype.iadd = function iadd(b) {
+  enforce(Dec64.isDec64(b), 'operand', 'decimal');
+  return this._add(b, false);
+};
+
+Dec64.prototype.add = function add(b) {
+  return this.clone().iadd(b);
+};
+
+Dec64.prototype.isub = function isub(b) {
+  enforce(Dec64.isDec64(b), 'operand', 'decimal');
+  return this._add(b, true);
+};
+
+Dec64.prototype.sub = function sub(b) {
+  return this.clone().isub(b);
+};
+
+Dec64.prototype.imul = function imul(b, mode) {
+  enforce(Dec64.isDec64(b), 'multiplicand', 'decimal');
+
+  mode = getMode(mode);
+
+  const neg = this.n.isNeg() !== b.n.isNeg();
+  const [hi, lo] = mul128(decAbs(this.n), decAbs(b.n));
+
+  let r = null;
+
+  if (b.scale === 0) {
+    if (hi.isZero())
+      r = decPack(neg, lo);
+  } else {
+    r = divRound(neg, hi, lo, DEC_POW10[b.scale], mode);
+  }
+
+  if (!r)
+    throw new Error('Decimal overflow.');
+
+  this.n = r;
+
+  return this;
+};
+
+Dec64.prototype.mul = function mul(b, mode) {
+  return this.clone().imul(b, mode);
+};
+
+Dec64.prototype.idiv = function idiv(b, mode) {
+  enforce(Dec64.isDec64(b), 'divisor', 'decimal');
+
+  mode = getMode(mode);
+
+  if (b.n.isZero())
+    throw new Error('Cannot divide by zero.');
+
+  const neg = this.n.isNeg() !== b.n.isNeg();
+  const [hi, lo] = mul128(decAbs(this.n), DEC_POW10[b.scale]);
+  const r = divRound(neg, hi, lo, decAbs(b.n), mode);
+
+  if (!r)
+    throw new Error('Decimal overflow.');
+
+  this.n = r;
+
+  return this;
+};
+
+Dec64.prototype.div = function div(b, mode) {
+  return this.clone().idiv(b, mode);
+};
+
+Dec64.prototype.irescale = function irescale(scale, mode) {
+  enforce(isScale(scale), 'scale', 'scale');
+
+  mode = getMode(mode);
+
+  let r;
+
+  if (scale >= this.scale) {
+    r = decScale(this.n, scale - this.scale);
+  } else {
+    r = divRound(this.n.isNeg(), new U64(), decAbs(this.n),
+                 DEC_POW10[this.scale - scale], mode);
+  }
+
+  if (!r)
+    throw new Error('Decimal overflow.');
+
+  this.n = r;
+  this.scale = scale;
+
+  return this;
+};
+
+Dec64.prototype.rescale = function rescale(scale, mode) {
+  return this.clone().irescale(scale, mode);
+};
+
+Dec64.prototype.ineg = function ineg() {
+  if (this.n.eq(I64.INT64_MIN))
+    throw new Error('Decimal overflow.');
+
+  this.n.ineg();
+
+  return this;
+};
+
+Dec64.prototype.neg = function neg() {
+  return this.clone().ineg();
+};
+
+Dec64.prototype.iabs = function iabs() {
+  if (this.n.isNeg())
+    this.ineg();
+  return this;
+};
+
+Dec64.prototype.abs = function abs() {
+  return this.clone().iabs();
+};
+
+/*
+ * Comparison
+ */
+
+Dec64.prototype.cmp = function cmp(b) {
+  enforce(Dec64.isDec64(b), 'value', 'decimal');
+
+  const a = this.n;
+  const an = a.isNeg();
+  const bn = b.n.isNeg();
+
+  if (an !== bn)
+    return an ? -1 : 1;
+
+  if (this.scale === b.scale)
+    return a.cmp(b.n);
+
+  if (a.isZero() || b.n.isZero())
+    return a.isZero() ? (b.n.isZero() ? 0 : -1) : 1;
+
+  const s = Math.max(this.scale, b.scale);
+  const [ahi, alo] = mul128(decAbs(a), DEC_POW10[s - this.scale]);
+  const [bhi, blo] = mul128(decAbs(b.n), DEC_POW10[s - b.scale]);
+  const r = ahi.cmp(bhi) || alo.cmp(blo);
+
+  return an ? -r : r;
+};
+
+Dec64.prototype.eq = function eq(b) {
+  return this.cmp(b) === 0;
+};
+
+Dec64.prototype.lt = function lt(b) {
+  return this.cmp(b) < 0;
+};
+
+Dec64.prototype.lte = function lte(b) {
+  return this.cmp(b) <= 0;
+};
+
+Dec64.prototype.gt = function gt(b) {
+  return this.cmp(b) > 0;
+};
+
+Dec64.prototype.gte = function gte(b) {
+  return this.cmp(b) >= 0;
+};
+
+Dec64.prototype.isZero = function isZero() {
+  return this.n.isZero();
+};
+
+Dec64.prototype.isNeg = function isNeg() {
+  return this.n.isNeg();
+};
+
+/*
+ * Helpers
+ */
+
+Dec64.prototype.clone = function clone() {
+  return new Dec64(this.scale).inject(this);
+};
+
+Dec64.prototype.inject = function inject(b) {
+  enforce(Dec64.isDec64(b), 'value', 'decimal');
+  this.n = b.n.clone();
+  this.scale = b.scale;
+  return this;
+};
+
+Dec64.prototype.inspect = function inspect() {
+  return `<Dec64: ${this.toString()}>`;
+};
+
+/*
+ * Encoding
+ */
+
+Dec64.prototype.toI64 = function toI64() {
+  return this.n.clone();
+};
+
+Dec64.prototype.toDouble = function toDouble() {
+  return this.n.toDouble() / DEC_POW10[this.scale].toDouble();
+};
+
+Dec64.prototype.toString = function toString() {
+  const scale = this.scale;
+
+  let str = decAbs(this.n).toString(10);
+
+  if (scale > 0) {
+    while (str.length < scale + 1)
+      str = '0' + str;
+
+    str = str.slice(0, -scale) + '.' + str.slice(-scale);
+  }
+
+  if (this.n.isNeg())
+    str = '-' + str;
+
+  return str;
+};
+
+Dec64.prototype.toJSON = function toJSON() {
+  return this.toString();
+};
+
+/*
+ * Decoding
+ */
+
+Dec64.prototype.fromI64 = function fromI64(num, scale) {
+  if (scale == null)
+    scale = 0;
+
+  enforce(isScale(scale), 'scale', 'scale');
+
+  if (typeof num === 'number')
+    num = I64.fromNumber(num);
+
+  enforce(N64.isN64(num), 'number', 'int64');
+
+  this.n = num.toI64();
+  this.scale = scale;
+
+  return this;
+};
+
+Dec64.prototype.fromString = function fromString(str, scale, mode) {
+  enforce(typeof str === 'string', 'string', 'string');
+  enforce(scale == null || isScale(scale), 'scale', 'scale');
+
+  mode = getMode(mode);
+
+  const m = /^([-+]?)(\d*)(?:\.(\d*))?$/.exec(str);
+
+  if (!m || (m[2].length === 0 && (m[3] || '').length === 0))
+    throw new Error('Invalid decimal string.');
+
+  const neg = m[1] === '-';
+  const frac = m[3] || '';
+
+  if (scale == null) {
+    if (frac.length > DEC64_MAX_SCALE)
+      throw new Error('Scale ranges between 0 and 18.');
+    scale = frac.length;
+  }
+
+  const digits = m[2] + frac.substring(0, scale);
+  const mag = new U64();
+
+  for (let i = 0; i < digits.length; i++) {
+    if (!decMul10(mag, digits.charCodeAt(i) - 0x30))
+      throw new Error('Decimal overflow.');
+  }
+
+  for (let i = frac.length; i < scale; i++) {
+    if (!decMul10(mag, 0))
+      throw new Error('Decimal overflow.');
+  }
+
+  if (frac.length > scale) {
+    const first = frac.charCodeAt(scale) - 0x30;
+    const sticky = /[1-9]/.test(frac.substring(scale + 1));
+
+    if (first !== 0 || sticky) {
+      let inc = false;
+
+      switch (mode) {
+        case Dec64.ROUND_DOWN:
+          inc = false;
+          break;
+        case Dec64.ROUND_UP:
+          inc = true;
+          break;
+        case Dec64.ROUND_FLOOR:
+          inc = neg;
+          break;
+        case Dec64.ROUND_CEIL:
+          inc = !neg;
+          break;
+        case Dec64.ROUND_HALF_UP:
+          inc = first >= 5;
+          break;
+        case Dec64.ROUND_HALF_DOWN:
+          inc = first > 5 || (first === 5 && sticky);
+          break;
+        case Dec64.ROUND_HALF_EVEN:
+          inc = first > 5 || (first === 5 && (sticky || mag.isOdd()));
+          break;
+      }
+
+      if (inc) {
+        if (mag.eq(U64.UINT64_MAX))
+          throw new Error('Decimal overflow.');
+        mag.iaddn(1);
+      }
+    }
+  }
+
+  const r = decPack(neg, mag);
+
+  if (!r)
+    throw new Error('Decimal overflow.');
+
+  this.n = r;
+  this.scale = scale;
+
+  return this;
+};
+
+Dec64.prototype.fromJSON = function fromJSON(json) {
+  return this.fromString(json);
+};
+
+/*
+ * Static Methods
+ */
+
+Dec64.fromI64 = function fromI64(num, scale) {
+  return new this().fromI64(num, scale);
+};
+
+Dec64.fromString = function fromString(str, scale, mode) {
+  return new this().fromString(str, scale, mode);
+};
+
+Dec64.fromJSON = function fromJSON(json) {
+  return new this().fromJSON(json);
+};
+
+Dec64.isDec64 = function isDec64(obj) {
+  return obj instanceof Dec64;
+};
+
+/*
+ * Dec64 Constants
+ */
+
+const DEC64_MAX_SCALE = 18;
+
+const DEC_POW10 = (() => {
+  const pow = [U64(1)];
+
+  for (let i = 1; i < 20; i++)
+    pow.push(pow[i - 1].muln(10));
+
+  return pow;
+})();
+
+const DEC_MUL10_MAX = U64.UINT64_MAX.divn(10);
+const DEC_NEG_MAX = U64(0x80000000, 0x00000000);
+
+/*
+ * Dec64 Helpers
+ */
+
+function decAbs(n) {
+  const r = n.toU64();
+
+  if (n.isNeg())
+    r.ineg();
+
+  return r;
+}
+
+function decPack(neg, mag) {
+  if (neg) {
+    if (mag.gt(DEC_NEG_MAX))
+      return null;
+    return mag.toI64().ineg();
+  }
+
+  if (mag.hi < 0)
+    return null;
+
+  return mag.toI64();
+}
+
+function decScale(n, k) {
+  const [hi, lo] = mul128(decAbs(n), DEC_POW10[k]);
+
+  if (!hi.isZero())
+    return null;
+
+  return decPack(n.isNeg(), lo);
+}
+
+function decMul10(mag, digit) {
+  // 2^64 - 1 = 1844674407370955161 * 10 + 5
+  if (mag.gt(DEC_MUL10_MAX))
+    return false;
+
+  if (mag.eq(DEC_MUL10_MAX) && digit > 5)
+    return false;
+
+  mag.imuln(10).iaddn(digit);
+
+  return true;
+}
+
+function mul128(a, b) {
+  // Schoolbook multiplication over 16 bit limbs.
+  const x = [a.lo & 0xffff, a.lo >>> 16, a.hi & 0xffff, a.hi >>> 16];
+  const y = [b.lo & 0xffff, b.lo >>> 16, b.hi & 0xffff, b.hi >>> 16];
+  const z = [0, 0, 0, 0, 0, 0, 0, 0];
+
+  for (let i = 0; i < 4; i++) {
+    let carry = 0;
+
+    for (let j = 0; j < 4; j++) {
+      const t = z[i + j] + x[i] * y[j] + carry;
+      z[i + j] = t & 0xffff;
+      carry = t >>> 16;
+    }
+
+    z[i + 4] = carry;
+  }
+
+  return [
+    U64.fromBits((z[7] << 16) | z[6], (z[5] << 16) | z[4]),
+    U64.fromBits((z[3] << 16) | z[2], (z[1] << 16) | z[0])
+  ];
+}
+
+function div128(hi, lo, d) {
+  // Quotient would not fit in 64 bits.
+  if (hi.gte(d))
+    return null;
+
+  if (hi.isZero())
+    return [lo.div(d), lo.mod(d)];
+
+  const r = hi.clone();
+  const n = lo.clone();
+  const q = new U64();
+
+  for (let i = 63; i >= 0; i--) {
+    const carry = r.hi >>> 31;
+
+    r.ishln(1);
+    r.lo |= n.hi >>> 31;
+    n.ishln(1);
+
+    if (carry || r.gte(d)) {
+      r.isub(d);
+      q.setn(i, 1);
+    }
+  }
+
+  return [q, r];
+}
+
+function divRound(neg, hi, lo, d, mode) {
+  const qr = div128(hi, lo, d);
+
+  if (!qr)
+    return null;
+
+  const [q, r] = qr;
+
+  if (!r.isZero()) {
+    // Compare the remainder to half the divisor
+    // without overflowing: `2r > d` <=> `r > d - r`.
+    const half = r.cmp(d.sub(r));
+
+    let inc = false;
+
+    switch (mode) {
+      case Dec64.ROUND_DOWN:
+        inc = false;
+        break;
+      case Dec64.ROUND_UP:
+        inc = true;
+        break;
+      case Dec64.ROUND_FLOOR:
+        inc = neg;
+        break;
+      case Dec64.ROUND_CEIL:
+        inc = !neg;
+        break;
+      case Dec64.ROUND_HALF_UP:
+        inc = half >= 0;
+        break;
+      case Dec64.ROUND_HALF_DOWN:
+        inc = half > 0;
+        break;
+      case Dec64.ROUND_HALF_EVEN:
+        inc = half > 0 || (half === 0 && q.isOdd());
+        break;
+    }
+
+    if (inc) {
+      if (q.eq(U64.UINT64_MAX))
+        return null;
+      q.iaddn(1);
+    }
+  }
+
+  return decPack(neg, q);
+}
+
+/*
+ * N64Array (abstract)
+ *
+ * Elements are kept as pairs of int32 words (low
+ * word first) in an Int32Array which grows by
+ * doubling. Once the words are shared with a
+ * subarray or exposed through toBuffer(), the
+ * next push moves the array to a private copy.
+ */
+
+function N64Array(sign, length) {
+  enforce(this instanceof N64Array, 'this', 'N64Array');
+  enforce(sign === 0 || sign === 1, 'sign', 'bit');
+
+  if (length == null)
+    length = 0;
+
+  enforce((length >>> 0) === length, 'length', 'integer');
+
+  this.sign = sign;
+  this.ctor = sign ? I64 : U64;
+  this.length = length;
+  this.words = new Int32Array(length * 2);
+  this.off = 0;
+  this.owner = true;
+}
+
+/*
+ * Internal
+ */
+
+N64Array.prototype._grow = function _grow(need) {
+  if (need > 0xffffffff)
+    throw new Error('Array length exceeds limit.');
+
+  const cap = this.words.length >>> 1;
+
+  if (this.owner && this.off === 0 && need <= cap)
+    return;
+
+  let size = Math.max(cap, ARRAY_MIN_CAP);
+
+  while (size < need)
+    size *= 2;
+
+  const words = new Int32Array(size * 2);
+  const start = this.off * 2;
+
+  words.set(this.words.subarray(start, start + this.length * 2));
+
+  this.words = words;
+  this.off = 0;
+  this.owner = true;
+};
+
+N64Array.prototype._index = function _index(index) {
+  enforce((index >>> 0) === index, 'index', 'integer');
+
+  if (index >= this.length)
+    throw new Error('Invalid index.');
+
+  return (this.off + index) * 2;
+};
+
+/*
+ * Elements
+ */
+
+N64Array.prototype.push = function push(num) {
+  enforce(N64.isN64(num), 'value', 'int64');
+
+  this._grow(this.length + 1);
+
+  const i = (this.off + this.length) * 2;
+
+  this.words[i] = num.lo;
+  this.words[i + 1] = num.hi;
+
+  return ++this.length;
+};
+
+N64Array.prototype.pushn = function pushn(num) {
+  enforce(isNumber(num), 'value', 'number');
+
+  this._grow(this.length + 1);
+
+  const i = (this.off + this.length) * 2;
+
+  this.words[i] = num | 0;
+  this.words[i + 1] = (num >> 31) & -this.sign;
+
+  return ++this.length;
+};
+
+N64Array.prototype.get = function get(index, out) {
+  if (out == null)
+    out = new this.ctor();
+
+  enforce(N64.isN64(out), 'out', 'int64');
+
+  const i = this._index(index);
+
+  out.lo = this.words[i];
+  out.hi = this.words[i + 1];
+
+  return out;
+};
+
+N64Array.prototype.set = function set(index, num) {
+  enforce(N64.isN64(num), 'value', 'int64');
+
+  const i = this._index(index);
+
+  this.words[i] = num.lo;
+  this.words[i + 1] = num.hi;
+
+  return this;
+};
+
+N64Array.prototype.setn = function setn(index, num) {
+  enforce(isNumber(num), 'value', 'number');
+
+  const i = this._index(index);
+
+  this.words[i] = num | 0;
+  this.words[i + 1] = (num >> 31) & -this.sign;
+
+  return this;
+};
+
+/*
+ * Slicing
+ */
+
+N64Array.prototype.subarray = function subarray(start, end) {
+  start = toIndex(start, this.length, 0, 'start');
+  end = toIndex(end, this.length, this.length, 'end');
+
+  if (end < start)
+    end = start;
+
+  const arr = Object.create(Object.getPrototypeOf(this));
+
+  arr.sign = this.sign;
+  arr.ctor = this.ctor;
+  arr.length = end - start;
+  arr.words = this.words;
+  arr.off = this.off + start;
+  arr.owner = false;
+
+  this.owner = false;
+
+  return arr;
+};
+
+N64Array.prototype.slice = function slice(start, end) {
+  return this.subarray(start, end);
+};
+
+/*
+ * Iteration
+ */
+
+N64Array.prototype.values = function* values() {
+  for (let i = 0; i < this.length; i++)
+    yield this.get(i);
+};
+
+N64Array.prototype[Symbol.iterator] = N64Array.prototype.values;
+
+/*
+ * Encoding
+ */
+
+N64Array.prototype.toBuffer = function toBuffer() {
+  const {buffer, byteOffset} = this.words;
+  const off = byteOffset + this.off * 8;
+  const size = this.length * 8;
+
+  this.owner = false;
+
+  if (typeof Buffer === 'function')
+    return Buffer.from(buffer, off, size);
+
+  return new Uint8Array(buffer, off, size);
+};
+
+N64Array.prototype.toArray = function toArray() {
+  return Array.from(this);
+};
+
+N64Array.prototype.transfer = function transfer() {
+  const {words, off, length} = this;
+
+  let buffer = words.buffer;
+
+  // Hand over the buffer only if nothing else sees it
+  // and it holds no spare capacity; otherwise copy.
+  if (!this.owner || off !== 0 || words.byteOffset !== 0
+      || buffer.byteLength !== length * 8) {
+    buffer = words.slice(off * 2, (off + length) * 2).buffer;
+  }
+
+  this.length = 0;
+  this.words = new Int32Array(0);
+  this.off = 0;
+  this.owner = true;
+
+  return buffer;
+};
+
+/*
+ * Static Methods
+ */
+
+N64Array.from = function from(items) {
+  enforce(items != null && typeof items[Symbol.iterator] === 'function',
+          'items', 'iterable');
+
+  const arr = new this();
+
+  for (const item of items)
+    arr.push(N64.isN64(item) ? item : arr.ctor.from(item));
+
+  return arr;
+};
+
+N64Array.fromBuffer = function fromBuffer(data) {
+  let buffer = data;
+  let off = 0;
+  let size = 0;
+
+  if (ArrayBuffer.isView(data)) {
+    buffer = data.buffer;
+    off = data.byteOffset;
+    size = data.byteLength;
+  } else {
+    enforce(data instanceof ArrayBuffer, 'data', 'buffer');
+    size = data.byteLength;
+  }
+
+  if (size & 7)
+    throw new Error('Invalid buffer length.');
+
+  if (size / 8 > 0xffffffff)
+    throw new Error('Array length exceeds limit.');
+
+  if (off & 7)
+    throw new Error('Unaligned offset.');
+
+  const arr = new this();
+
+  arr.length = size / 8;
+  arr.words = new Int32Array(buffer, off, size / 4);
+  arr.owner = false;
+
+  return arr;
+};
+
+N64Array.parse = function parse(items, base) {
+  enforce(Array.isArray(items), 'items', 'array');
+
+  base = getBase(base);
+
+  enforce((base >>> 0) === base, 'base', 'integer');
+
+  if (base < 2 || base > 16)
+    throw new Error('Base ranges between 2 and 16.');
+
+  const array = new this(items.length);
+  const valid = new Uint8Array((items.length + 7) >>> 3);
+  const {words} = array;
+  const num = new array.ctor();
+
+  let invalid = 0;
+
+  // Bad elements are left as zero and clear their bit.
+  for (let i = 0; i < items.length; i++) {
+    const item = items[i];
+
+    let ok = false;
+
+    if (typeof item === 'string')
+      ok = num._read(item, base) === null;
+    else
+      ok = num.tryFromNumber(item);
+
+    if (!ok) {
+      invalid += 1;
+      continue;
+    }
+
+    valid[i >>> 3] |= 1 << (i & 7);
+    words[i * 2] = num.lo;
+    words[i * 2 + 1] = num.hi;
+  }
+
+  return { array, valid, invalid };
+};
+
+N64Array.isN64Array = function isN64Array(obj) {
+  return obj instanceof N64Array;
+};
+
+/*
+ * U64Array
+ */
+
+function U64Array(length) {
+  if (!(this instanceof U64Array))
+    return new U64Array(length);
+
+  N64Array.call(this, 0, length);
+}
+
+Object.setPrototypeOf(U64Array, N64Array);
+Object.setPrototypeOf(U64Array.prototype, N64Array.prototype);
+
+/*
+ * I64Array
+ */
+
+function I64Array(length) {
+  if (!(this instanceof I64Array))
+    return new I64Array(length);
+
+  N64Array.call(this, 1, length);
+}
+
+Object.setPrototypeOf(I64Array, N64Array);
+Object.setPrototypeOf(I64Array.prototype, N64Array.prototype);
+
+/*
+ * Columns
+ */
+
+N64Array.parseColumn = function parseColumn(data, options) {
+  enforce(data instanceof Uint8Array, 'data', 'buffer');
+
+  const opts = columnOptions(options);
+  const base = getBase(opts.base);
+  const {delimiter, column} = opts;
+
+  enforce((base >>> 0) === base, 'base', 'integer');
+
+  if (base < 2 || base > 16)
+    throw new Error('Base ranges between 2 and 16.');
+
+  if (opts.header)
+    data = skipRecord(data);
+
+  const rows = countRecords(data);
+  const array = new this(rows);
+  const valid = new Uint8Array((rows + 7) >>> 3);
+  const {words} = array;
+  const num = new array.ctor();
+
+  let invalid = 0;
+  let pos = 0;
+
+  // Fields are split on every delimiter; there is
+  // no quoting. Missing and bad fields are left as
+  // zero and clear their bit.
+  for (let i = 0; i < rows; i++) {
+    let eol = data.indexOf(0x0a, pos);
+    let start = pos;
+    let ok = true;
+
+    if (eol === -1)
+      eol = data.length;
+
+    for (let j = 0; j < column; j++) {
+      const sep = findByte(data, delimiter, start, eol);
+
+      if (sep === -1) {
+        ok = false;
+        break;
+      }
+
+      start = sep + 1;
+    }
+
+    if (ok) {
+      let stop = findByte(data, delimiter, start, eol);
+
+      if (stop === -1) {
+        stop = eol;
+
+        // CRLF line endings.
+        if (stop > start && data[stop - 1] === 0x0d)
+          stop -= 1;
+      }
+
+      ok = stop - start <= 65
+        && num._read(latin1(data, start, stop), base) === null;
+    }
+
+    pos = eol + 1;
+
+    if (!ok) {
+      invalid += 1;
+      continue;
+    }
+
+    valid[i >>> 3] |= 1 << (i & 7);
+    words[i * 2] = num.lo;
+    words[i * 2 + 1] = num.hi;
+  }
+
+  return { array, valid, invalid };
+};
+
+U64.parseColumn = function parseColumn(data, options) {
+  return U64Array.parseColumn(data, options);
+};
+
+I64.parseColumn = function parseColumn(data, options) {
+  return I64Array.parseColumn(data, options);
+};
+
+/*
+ * Bulk
+ */
+
+N64.bswap64 = function bswap64(dst, src) {
+  if (src == null)
+    src = dst;
+
+  const d = toBytes(dst);
+
+  let s = toBytes(src);
+
+  if (s.length & 7)
+    throw new Error('Invalid buffer length.');
+
+  if (d.length < s.length)
+    throw new Error('Invalid range.');
+
+  // Overlapping views swap in place after a move.
+  if (d !== s && overlaps(d, s)) {
+    d.set(s);
+    s = d;
+  }
+
+  for (let i = 0; i < s.length; i += 8) {
+    const lo = readI32LE(s, i);
+    const hi = readI32LE(s, i + 4);
+
+    writeI32BE(d, hi, i);
+    writeI32BE(d, lo, i + 4);
+  }
+
+  return dst;
+};
+
+N64.split = function split(hi, lo, src) {
+  enforce(isWords(hi), 'hi', 'int32array');
+  enforce(isWords(lo), 'lo', 'int32array');
+
+  let s = toBytes(src);
+
+  const count = s.length / 8;
+
+  if (s.length & 7)
+    throw new Error('Invalid buffer length.');
+
+  if (hi.length < count || lo.length < count)
+    throw new Error('Invalid range.');
+
+  if (overlaps(hi.subarray(0, count), lo.subarray(0, count)))
+    throw new Error('Invalid range.');
+
+  if (overlaps(s, hi) || overlaps(s, lo))
+    s = s.slice();
+
+  for (let i = 0; i < count; i++) {
+    lo[i] = readI32LE(s, i * 8);
+    hi[i] = readI32LE(s, i * 8 + 4);
+  }
+
+  return count;
+};
+
+N64.join = function join(dst, hi, lo) {
+  enforce(isWords(hi), 'hi', 'int32array');
+  enforce(isWords(lo), 'lo', 'int32array');
+
+  const d = toBytes(dst);
+
+  if (hi.length !== lo.length || (d.length >>> 3) < hi.length)
+    throw new Error('Invalid range.');
+
+  if (overlaps(d, hi))
+    hi = hi.slice();
+
+  if (overlaps(d, lo))
+    lo = lo.slice();
+
+  for (let i = 0; i < hi.length; i++) {
+    writeI32LE(d, lo[i], i * 8);
+    writeI32LE(d, hi[i], i * 8 + 4);
+  }
+
+  return dst;
+};
+
+U64.toFloat64 = function toFloat64(dst, src, mode) {
+  return convertTo(dst, src, 0, mode);
+};
+
+I64.toFloat64 = function toFloat64(dst, src, mode) {
+  return convertTo(dst, src, 1, mode);
+};
+
+U64.fromFloat64 = function fromFloat64(dst, src, mode) {
+  return convertFrom(dst, src, 0, mode);
+};
+
+I64.fromFloat64 = function fromFloat64(dst, src, mode) {
+  return convertFrom(dst, src, 1, mode);
+};
+
+const ROUND_STRICT = -1;
+
+function convertTo(dst, src, sign, mode) {
+  enforce(dst instanceof Float64Array, 'dst', 'float64array');
+
+  let s = toBytes(src);
+
+  mode = getRound(mode);
+
+  const count = s.length / 8;
+  const bad = [];
+
+  if (s.length & 7)
+    throw new Error('Invalid buffer length.');
+
+  if (dst.length < count)
+    throw new Error('Invalid range.');
+
+  if (overlaps(dst, s) && dst.byteOffset !== s.byteOffset)
+    s = s.slice();
+
+  for (let i = 0; i < count; i++) {
+    const lo = readI32LE(s, i * 8) >>> 0;
+    const hi = readI32LE(s, i * 8 + 4);
+    const x = (sign ? hi : hi >>> 0) * 0x100000000 + lo;
+
+    // Unsafe words are exactly those which
+    // round to an unsafe double.
+    if (mode === ROUND_STRICT) {
+      if (!Number.isSafeInteger(x)) {
+        dst[i] = NaN;
+        bad.push(i);
+        continue;
+      }
+    } else if (mode !== Dec64.ROUND_HALF_EVEN && !Number.isSafeInteger(x)) {
+      dst[i] = roundWord(hi, lo, sign, mode);
+      continue;
+    }
+
+    dst[i] = x;
+  }
+
+  return new Uint32Array(bad);
+}
+
+function convertFrom(dst, src, sign, mode) {
+  enforce(src instanceof Float64Array, 'src', 'float64array');
+
+  const d = toBytes(dst);
+  const num = new N64(sign);
+  const bad = [];
+
+  let s = src;
+
+  mode = getRound(mode);
+
+  if (d.length / 8 < s.length)
+    throw new Error('Invalid range.');
+
+  if (overlaps(d, s) && d.byteOffset !== s.byteOffset)
+    s = s.slice();
+
+  for (let i = 0; i < s.length; i++) {
+    let x = s[i];
+    let ok = true;
+
+    if (mode === ROUND_STRICT) {
+      // Negative values wrap when unsigned,
+      // as with fromNumber.
+      ok = Number.isSafeInteger(x);
+    } else if (x === x) {
+      x = roundDouble(x, mode);
+
+      // Out of range values saturate.
+      if (sign)
+        ok = x >= -0x8000000000000000 && x < 0x8000000000000000;
+      else
+        ok = x >= 0 && x < 0x10000000000000000;
+    } else {
+      ok = false;
+      x = 0;
+    }
+
+    if (!ok) {
+      bad.push(i);
+
+      if (mode === ROUND_STRICT)
+        x = 0;
+    }
+
+    if (sign && x >= 0x8000000000000000) {
+      num.hi = 0x7fffffff;
+      num.lo = -1;
+    } else if (x >= 0x10000000000000000) {
+      num.hi = -1;
+      num.lo = -1;
+    } else if (sign && x < -0x8000000000000000) {
+      num.hi = 0x80000000 | 0;
+      num.lo = 0;
+    } else if (!sign && x < 0 && !ok) {
+      num.hi = 0;
+      num.lo = 0;
+    } else {
+      // Integral doubles split exactly.
+      const m = Math.abs(x);
+      const hi = Math.floor(m / 0x100000000);
+
+      num.hi = hi | 0;
+      num.lo = (m - hi * 0x100000000) | 0;
+
+      if (x < 0)
+        num.ineg();
+    }
+
+    writeI32LE(d, num.lo, i * 8);
+    writeI32LE(d, num.hi, i * 8 + 4);
+  }
+
+  return new Uint32Array(bad);
+}
+
+/*
+ * Linear Algebra
+ *
+ * Sums are kept in doubles as eight 16 bit columns
+ * of partial products (plus a count of carries out
+ * of the top) and normalized every 1024 products,
+ * long before a column could lose precision.
+ */
+
+const ACC_COLS = new Float64Array(9);
+const ACC_TOP = 8;
+const ACC_FLUSH = 1024;
+
+U64.dot = function dot(a, b) {
+  return checkDot(U64.tryDot(a, b));
+};
+
+I64.dot = function dot(a, b) {
+  return checkDot(I64.tryDot(a, b));
+};
+
+U64.tryDot = function tryDot(a, b) {
+  return dotProduct(new U128(), a, b, 0);
+};
+
+I64.tryDot = function tryDot(a, b) {
+  return dotProduct(new I128(), a, b, 1);
+};
+
+U64.axpy = function axpy(dst, alpha, x) {
+  return addScaled(dst, alpha, x, 0);
+};
+
+I64.axpy = function axpy(dst, alpha, x) {
+  return addScaled(dst, alpha, x, 1);
+};
+
+U64.matvec = function matvec(dst, m, x) {
+  return mulMatrix(dst, m, x, 0);
+};
+
+I64.matvec = function matvec(dst, m, x) {
+  return mulMatrix(dst, m, x, 1);
+};
+
+function checkDot(r) {
+  if (!r)
+    throw new Error('Dot product overflow.');
+
+  return r;
+}
+
+function dotProduct(r, a, b, sign) {
+  const x = toBytes(a);
+  const y = toBytes(b);
+  const acc = ACC_COLS;
+
+  if ((x.length & 7) || (y.length & 7))
+    throw new Error('Invalid buffer length.');
+
+  if (x.length !== y.length)
+    throw new Error('Invalid range.');
+
+  accClear(acc);
+  accDot(acc, x, 0, y, x.length >>> 3, sign);
+
+  if (!accFits(acc, 16, sign))
+    return null;
+
+  return r.join(accWord(acc, 3), accWord(acc, 2),
+                accWord(acc, 1), accWord(acc, 0));
+}
+
+function addScaled(dst, alpha, x, sign) {
+  const d = toBytes(dst);
+  const k = toAlpha(alpha);
+  const bad = [];
+
+  let s = toBytes(x);
+
+  if (s.length & 7)
+    throw new Error('Invalid buffer length.');
+
+  if (d.length < s.length)
+    throw new Error('Invalid range.');
+
+  // Each word is read before it is written,
+  // so only a partial overlap needs a copy.
+  if (overlaps(d, s) && d.byteOffset !== s.byteOffset)
+    s = s.slice();
+
+  const k0 = k.lo & 0xffff;
+  const k1 = k.lo >>> 16;
+  const k2 = k.hi & 0xffff;
+  const k3 = k.hi >>> 16;
+  const kneg = sign && k.hi < 0;
+
+  // One product at a time, so the columns
+  // live in locals rather than ACC_COLS.
+  for (let i = 0; i < s.length; i += 8) {
+    const ylo = readI32LE(d, i);
+    const yhi = readI32LE(d, i + 4);
+    const xlo = readI32LE(s, i);
+    const xhi = readI32LE(s, i + 4);
+    const x0 = xlo & 0xffff;
+    const x1 = xlo >>> 16;
+    const x2 = xhi & 0xffff;
+    const x3 = xhi >>> 16;
+
+    let c0 = (ylo & 0xffff) + k0 * x0;
+    let c1 = (ylo >>> 16) + k0 * x1 + k1 * x0;
+    let c2 = (yhi & 0xffff) + k0 * x2 + k1 * x1 + k2 * x0;
+    let c3 = (yhi >>> 16) + k0 * x3 + k1 * x2 + k2 * x1 + k3 * x0;
+    let c4 = k1 * x3 + k2 * x2 + k3 * x1;
+    let c5 = k2 * x3 + k3 * x2;
+    let c6 = k3 * x3;
+    let c7 = 0;
+    let top = 0;
+
+    if (sign) {
+      if (yhi < 0)
+        c4 -= 1;
+
+      if (kneg) {
+        c4 -= x0;
+        c5 -= x1;
+        c6 -= x2;
+        c7 -= x3;
+      }
+
+      if (xhi < 0) {
+        c4 -= k0;
+        c5 -= k1;
+        c6 -= k2;
+        c7 -= k3;
+
+        if (kneg)
+          top += 1;
+      }
+    }
+
+    c1 += Math.floor(c0 / 0x10000);
+    c2 += Math.floor(c1 / 0x10000);
+    c3 += Math.floor(c2 / 0x10000);
+    c4 += Math.floor(c3 / 0x10000);
+
+    const lo = (c0 & 0xffff) | ((c1 & 0xffff) << 16);
+    const hi = (c2 & 0xffff) | ((c3 & 0xffff) << 16);
+
+    // Everything above the low 64 bits must
+    // be the sign extension of what is left.
+    c5 += Math.floor(c4 / 0x10000);
+    c6 += Math.floor(c5 / 0x10000);
+    c7 += Math.floor(c6 / 0x10000);
+    top += Math.floor(c7 / 0x10000);
+
+    const ext = sign && hi < 0 ? 0xffff : 0;
+
+    if ((c4 & 0xffff) !== ext || (c5 & 0xffff) !== ext
+        || (c6 & 0xffff) !== ext || (c7 & 0xffff) !== ext
+        || top !== (ext ? -1 : 0)) {
+      bad.push(i >>> 3);
+    }
+
+    writeI32LE(d, lo, i);
+    writeI32LE(d, hi, i + 4);
+  }
+
+  return new Uint32Array(bad);
+}
+
+function mulMatrix(dst, m, x, sign) {
+  const d = toBytes(dst);
+  const acc = ACC_COLS;
+  const bad = [];
+
+  let a = toBytes(m);
+  let b = toBytes(x);
+
+  const cols = b.length >>> 3;
+
+  if ((a.length & 7) || (b.length & 7))
+    throw new Error('Invalid buffer length.');
+
+  if (cols === 0 || (a.length >>> 3) % cols !== 0)
+    throw new Error('Invalid buffer length.');
+
+  const rows = (a.length >>> 3) / cols;
+
+  if ((d.length >>> 3) < rows)
+    throw new Error('Invalid range.');
+
+  // Rows are read after earlier results are
+  // written, so any overlap needs a copy.
+  if (overlaps(d.subarray(0, rows * 8), a))
+    a = a.slice();
+
+  if (overlaps(d.subarray(0, rows * 8), b))
+    b = b.slice();
+
+  for (let i = 0; i < rows; i++) {
+    accClear(acc);
+    accDot(acc, a, i * cols * 8, b, cols, sign);
+
+    if (!accFits(acc, 8, sign))
+      bad.push(i);
+
+    writeI32LE(d, accWord(acc, 0), i * 8);
+    writeI32LE(d, accWord(acc, 1), i * 8 + 4);
+  }
+
+  return new Uint32Array(bad);
+}
+
+function toAlpha(alpha) {
+  if (typeof alpha === 'number') {
+    enforce(Number.isSafeInteger(alpha), 'alpha', 'integer');
+    return U64.fromNumber(alpha);
+  }
+
+  enforce(alpha && typeof alpha === 'object', 'alpha', 'int64');
+
+  return U64.fromObject(alpha);
+}
+
+function accClear(acc) {
+  for (let i = 0; i < 9; i++)
+    acc[i] = 0;
+}
+
+function accDot(acc, a, off, b, count, sign) {
+  for (let i = 0; i < count; i++) {
+    const p = off + i * 8;
+    const q = i * 8;
+
+    accMul(acc, readI32LE(a, p + 4), readI32LE(a, p),
+           readI32LE(b, q + 4), readI32LE(b, q), sign);
+
+    if ((i & (ACC_FLUSH - 1)) === ACC_FLUSH - 1)
+      accNormalize(acc);
+  }
+
+  accNormalize(acc);
+}
+
+function accMul(acc, ahi, alo, bhi, blo, sign) {
+  const a0 = alo & 0xffff;
+  const a1 = alo >>> 16;
+  const a2 = ahi & 0xffff;
+  const a3 = ahi >>> 16;
+  const b0 = blo & 0xffff;
+  const b1 = blo >>> 16;
+  const b2 = bhi & 0xffff;
+  const b3 = bhi >>> 16;
+
+  acc[0] += a0 * b0;
+  acc[1] += a0 * b1 + a1 * b0;
+  acc[2] += a0 * b2 + a1 * b1 + a2 * b0;
+  acc[3] += a0 * b3 + a1 * b2 + a2 * b1 + a3 * b0;
+  acc[4] += a1 * b3 + a2 * b2 + a3 * b1;
+  acc[5] += a2 * b3 + a3 * b2;
+  acc[6] += a3 * b3;
+
+  // A negative operand is its unsigned value
+  // minus 2^64: subtract the other one from
+  // the upper half (and add back 2^128 if
+  // both are negative).
+  if (sign) {
+    if (ahi < 0 && bhi < 0)
+      acc[ACC_TOP] += 1;
+
+    if (ahi < 0) {
+      acc[4] -= b0;
+      acc[5] -= b1;
+      acc[6] -= b2;
+      acc[7] -= b3;
+    }
+
+    if (bhi < 0) {
+      acc[4] -= a0;
+      acc[5] -= a1;
+      acc[6] -= a2;
+      acc[7] -= a3;
+    }
+  }
+}
+
+function accNormalize(acc) {
+  let carry = 0;
+
+  for (let i = 0; i < 8; i++) {
+    const c = acc[i] + carry;
+
+    carry = Math.floor(c / 0x10000);
+
+    acc[i] = c - carry * 0x10000;
+  }
+
+  acc[ACC_TOP] += carry;
+}
+
+function accWord(acc, i) {
+  return acc[i * 2] | (acc[i * 2 + 1] << 16);
+}
+
+function accFits(acc, bytes, sign) {
+  // Whether a normalized sum fits in `bytes`
+  // bytes as a signed or unsigned value.
+  const cols = bytes >>> 1;
+  const neg = sign && acc[cols - 1] >= 0x8000;
+  const ext = neg ? 0xffff : 0;
+
+  for (let i = cols; i < 8; i++) {
+    if (acc[i] !== ext)
+      return false;
+  }
+
+  return acc[ACC_TOP] === (neg ? -1 : 0);
+}
+
+/*
+ * IntMath
+ */
+
+function IntMath(ctor) {
+  if (!(this instanceof IntMath))
+    return new IntMath(ctor);
+
+  enforce(typeof ctor === 'function', 'ctor', 'constructor');
+
+  this.ctor = ctor;
+}
+
+IntMath.prototype.sqrt = function sqrt(dst, src) {
+  return mapUnary(this.ctor, dst, src, sqrtTo);
+};
+
+IntMath.prototype.cbrt = function cbrt(dst, src) {
+  return mapUnary(this.ctor, dst, src, cbrtTo);
+};
+
+IntMath.prototype.nextPowerOfTwo = function nextPowerOfTwo(dst, src) {
+  return mapUnary(this.ctor, dst, src, nextPow2To);
+};
+
+IntMath.prototype.log2 = function log2(dst, src) {
+  return mapLog(this.ctor, dst, src, log2Of);
+};
+
+IntMath.prototype.log10 = function log10(dst, src) {
+  return mapLog(this.ctor, dst, src, log10Of);
+};
+
+IntMath.prototype.gcd = function gcd(dst, a, b) {
+  return mapBinary(this.ctor, dst, a, b, gcdTo);
+};
+
+IntMath.prototype.lcm = function lcm(dst, a, b) {
+  return mapBinary(this.ctor, dst, a, b, lcmTo);
+};
+
+IntMath.prototype.divmod = function divmod(q, r, a, b) {
+  const qb = toBytes(q);
+  const rb = toBytes(r);
+  const x = new this.ctor();
+  const y = new this.ctor();
+  const bad = [];
+
+  let ab = toBytes(a);
+  let bb = toBytes(b);
+
+  if ((ab.length & 7) || (bb.length & 7))
+    throw new Error('Invalid buffer length.');
+
+  if (bb.length !== ab.length
+      || qb.length < ab.length
+      || rb.length < ab.length) {
+    throw new Error('Invalid range.');
+  }
+
+  if (overlaps(qb.subarray(0, ab.length), rb.subarray(0, ab.length)))
+    throw new Error('Invalid range.');
+
+  // Both outputs are written after both inputs
+  // are read, so only partial overlaps are copied.
+  if (isPartial(qb, ab) || isPartial(rb, ab))
+    ab = ab.slice();
+
+  if (isPartial(qb, bb) || isPartial(rb, bb))
+    bb = bb.slice();
+
+  for (let i = 0; i < ab.length; i += 8) {
+    x.lo = readI32LE(ab, i);
+    x.hi = readI32LE(ab, i + 4);
+    y.lo = readI32LE(bb, i);
+    y.hi = readI32LE(bb, i + 4);
+
+    let u = x;
+    let v = y;
+
+    if (y.isZero()) {
+      u.set(0);
+      v.set(0);
+      bad.push(i >>> 3);
+    } else {
+      [u, v] = x.divmod(y);
+    }
+
+    writeI32LE(qb, u.lo, i);
+    writeI32LE(qb, u.hi, i + 4);
+    writeI32LE(rb, v.lo, i);
+    writeI32LE(rb, v.hi, i + 4);
+  }
+
+  return new Uint32Array(bad);
+};
+
+function mapUnary(ctor, dst, src, func) {
+  const d = toBytes(dst);
+  const n = new ctor();
+  const bad = [];
+
+  let s = toBytes(src);
+
+  if (s.length & 7)
+    throw new Error('Invalid buffer length.');
+
+  if (d.length < s.length)
+    throw new Error('Invalid range.');
+
+  if (isPartial(d, s))
+    s = s.slice();
+
+  for (let i = 0; i < s.length; i += 8) {
+    n.lo = readI32LE(s, i);
+    n.hi = readI32LE(s, i + 4);
+
+    if (!func(n)) {
+      n.set(0);
+      bad.push(i >>> 3);
+    }
+
+    writeI32LE(d, n.lo, i);
+    writeI32LE(d, n.hi, i + 4);
+  }
+
+  return new Uint32Array(bad);
+}
+
+function mapLog(ctor, dst, src, func) {
+  enforce(isWords(dst), 'dst', 'int32array');
+
+  const n = new ctor();
+  const bad = [];
+
+  let s = toBytes(src);
+
+  const count = s.length / 8;
+
+  if (s.length & 7)
+    throw new Error('Invalid buffer length.');
+
+  if (dst.length < count)
+    throw new Error('Invalid range.');
+
+  // The output is half the width of
+  // the input, so any overlap is copied.
+  if (overlaps(dst.subarray(0, count), s))
+    s = s.slice();
+
+  for (let i = 0; i < count; i++) {
+    n.lo = readI32LE(s, i * 8);
+    n.hi = readI32LE(s, i * 8 + 4);
+
+    const r = func(n);
+
+    if (r < 0)
+      bad.push(i);
+
+    dst[i] = r;
+  }
+
+  return new Uint32Array(bad);
+}
+
+function mapBinary(ctor, dst, a, b, func) {
+  const d = toBytes(dst);
+  const x = new ctor();
+  const y = new ctor();
+  const bad = [];
+
+  let ab = toBytes(a);
+  let bb = toBytes(b);
+
+  if ((ab.length & 7) || (bb.length & 7))
+    throw new Error('Invalid buffer length.');
+
+  if (bb.length !== ab.length || d.length < ab.length)
+    throw new Error('Invalid range.');
+
+  if (isPartial(d, ab))
+    ab = ab.slice();
+
+  if (isPartial(d, bb))
+    bb = bb.slice();
+
+  for (let i = 0; i < ab.length; i += 8) {
+    x.lo = readI32LE(ab, i);
+    x.hi = readI32LE(ab, i + 4);
+    y.lo = readI32LE(bb, i);
+    y.hi = readI32LE(bb, i + 4);
+
+    if (!func(x, y)) {
+      x.set(0);
+      bad.push(i >>> 3);
+    }
+
+    writeI32LE(d, x.lo, i);
+    writeI32LE(d, x.hi, i + 4);
+  }
+
+  return new Uint32Array(bad);
+}
+
+// Element-wise kernels may share an exact
+// offset with their output but nothing else.
+function isPartial(dst, src) {
+  return overlaps(dst, src) && dst.byteOffset !== src.byteOffset;
+}
+
+/*
+ * Integer Math Helpers
+ *
+ * Each works on the magnitude as a U64 and
+ * reports failure rather than throwing, so
+ * the batch forms can collect indexes.
+ */
+
+let POW10 = null;
+
+function pow10(i) {
+  if (!POW10) {
+    POW10 = [new U64(1)];
+
+    for (let j = 1; j < 20; j++)
+      POW10.push(POW10[j - 1].muln(10));
+  }
+
+  return POW10[i];
+}
+
+function magnitude(n, sign) {
+  const m = n.toU64();
+
+  if (sign && n.hi < 0)
+    m.ineg();
+
+  return m;
+}
+
+function zeroBits(n) {
+  if (n.lo !== 0)
+    return 31 - Math.clz32(n.lo & -n.lo);
+
+  return 63 - Math.clz32(n.hi & -n.hi);
+}
+
+function ugcd(x, y) {
+  // Stein's algorithm.
+  if (x.isZero())
+    return y;
+
+  if (y.isZero())
+    return x;
+
+  const shift = zeroBits(x.clone().ior(y));
+
+  x.iushrn(zeroBits(x));
+
+  do {
+    y.iushrn(zeroBits(y));
+
+    if (x.gt(y)) {
+      const t = x;
+      x = y;
+      y = t;
+    }
+
+    y.isub(x);
+  } while (!y.isZero());
+
+  return x.ishln(shift);
+}
+
+function sqrtTo(n) {
+  if (n.isNeg())
+    return false;
+
+  const m = n.toU64();
+  const t = new U64();
+
+  // The double is within one of the root.
+  let s = Math.min(Math.floor(Math.sqrt(m.toDouble())), 0xffffffff);
+
+  while (t.set(s).isqr().gt(m))
+    s -= 1;
+
+  while (s < 0xffffffff && t.set(s + 1).isqr().lte(m))
+    s += 1;
+
+  n.set(s);
+
+  return true;
+}
+
+function cbrtTo(n) {
+  const neg = n.isNeg();
+  const m = magnitude(n, n.sign);
+  const t = new U64();
+
+  // 2642245^3 is the largest cube below 2^64.
+  let s = Math.min(Math.floor(Math.cbrt(m.toDouble())), 2642245);
+
+  while (t.set(s).ipown(3).gt(m))
+    s -= 1;
+
+  while (s < 2642245 && t.set(s + 1).ipown(3).lte(m))
+    s += 1;
+
+  n.set(neg ? -s : s);
+
+  return true;
+}
+
+function log2Of(n) {
+  if (n.isZero() || n.isNeg())
+    return -1;
+
+  return n.toU64().bitLength() - 1;
+}
+
+function log10Of(n) {
+  if (n.isZero() || n.isNeg())
+    return -1;
+
+  const m = n.toU64();
+
+  // 1233 / 4096 is close enough to log10(2) that
+  // `t` is either the answer or one more.
+  let t = (m.bitLength() * 1233) >>> 12;
+
+  if (m.lt(pow10(t)))
+    t -= 1;
+
+  return t;
+}
+
+function gcdTo(n, b) {
+  const r = ugcd(magnitude(n, n.sign), magnitude(b, n.sign));
+
+  // gcd(INT64_MIN, 0) is 2^63.
+  if (n.sign && r.hi < 0)
+    return false;
+
+  n.hi = r.hi;
+  n.lo = r.lo;
+
+  return true;
+}
+
+function lcmTo(n, b) {
+  const x = magnitude(n, n.sign);
+  const y = magnitude(b, n.sign);
+
+  if (x.isZero() || y.isZero()) {
+    n.set(0);
+    return true;
+  }
+
+  const q = x.div(ugcd(x.clone(), y.clone()));
+  const max = new U64().join(n.sign ? 0x7fffffff : -1, -1);
+
+  if (q.gt(max.div(y)))
+    return false;
+
+  q.imul(y);
+
+  n.hi = q.hi;
+  n.lo = q.lo;
+
+  return true;
+}
+
+function nextPow2To(n) {
+  if (n.isNeg() || n.lten(1)) {
+    n.set(1);
+    return true;
+  }
+
+  const bits = n.toU64().isubn(1).bitLength();
+
+  if (bits >= (n.sign ? 63 : 64))
+    return false;
+
+  n.set(0);
+  n.setn(bits, 1);
+
+  return true;
+}
+
+/*
+ * Filtering
+ */
+
+U64.where = function where(out, src, op, a, b) {
+  return filterWords(out, src, op, a, b, 0);
+};
+
+I64.where = function where(out, src, op, a, b) {
+  return filterWords(out, src, op, a, b, 1);
+};
+
+U64.countWhere = function countWhere(src, op, a, b) {
+  return filterWords(null, src, op, a, b, 0);
+};
+
+I64.countWhere = function countWhere(src, op, a, b) {
+  return filterWords(null, src, op, a, b, 1);
+};
+
+N64.compact = function compact(dst, src, selection) {
+  const d = toBytes(dst);
+
+  let s = toBytes(src);
+  let sel = selection;
+
+  enforce(isSelection(sel), 'selection', 'selection');
+
+  if (s.length & 7)
+    throw new Error('Invalid buffer length.');
+
+  const count = s.length >>> 3;
+
+  if (sel instanceof Uint8Array) {
+    if (sel.length < ((count + 7) >>> 3))
+      throw new Error('Invalid range.');
+
+    const n = countSelected(sel, count);
+
+    if (d.length < n * 8)
+      throw new Error('Invalid range.');
+
+    if (overlaps(d, sel))
+      sel = new Uint8Array(sel);
+
+    // Words only move toward the front, so
+    // compacting in place needs no copy.
+    if (overlaps(d, s) && d.byteOffset !== s.byteOffset)
+      s = new Uint8Array(s);
+
+    let j = 0;
+
+    for (let i = 0; i < count; i++) {
+      if (sel[i >>> 3] & (1 << (i & 7)))
+        copyWord(d, j++, s, i);
+    }
+
+    return n;
+  }
+
+  if (d.length < sel.length * 8)
+    throw new Error('Invalid range.');
+
+  for (let i = 0; i < sel.length; i++) {
+    if (sel[i] >= count)
+      throw new Error('Invalid range.');
+  }
+
+  // Indexes may point anywhere, so any overlap is
+  // copied (Buffer#slice would not copy).
+  if (overlaps(d, sel))
+    sel = new Uint32Array(sel);
+
+  if (overlaps(d, s))
+    s = new Uint8Array(s);
+
+  for (let i = 0; i < sel.length; i++)
+    copyWord(d, i, s, sel[i]);
+
+  return sel.length;
+};
+
+/*
+ * Filtering Helpers
+ */
+
+function filterWords(out, src, op, a, b, sign) {
+  const p = toPredicate(op, a, b, sign);
+
+  if (out != null)
+    enforce(isSelection(out), 'out', 'selection');
+
+  let s = toBytes(src);
+
+  if (s.length & 7)
+    throw new Error('Invalid buffer length.');
+
+  const count = s.length >>> 3;
+  const bitmap = out instanceof Uint8Array;
+
+  if (out != null) {
+    if (bitmap ? out.length < ((count + 7) >>> 3) : out.length < count)
+      throw new Error('Invalid range.');
+
+    if (overlaps(out, s))
+      s = new Uint8Array(s);
+
+    if (bitmap)
+      out.fill(0, 0, (count + 7) >>> 3);
+  }
+
+  let n = 0;
+
+  for (let i = 0; i < count; i++) {
+    const hi = readI32LE(s, i * 8 + 4);
+    const lo = readI32LE(s, i * 8);
+
+    if (!testPredicate(p, hi, lo))
+      continue;
+
+    if (bitmap)
+      out[i >>> 3] |= 1 << (i & 7);
+    else if (out != null)
+      out[n] = i;
+
+    n += 1;
+  }
+
+  return n;
+}
+
+// As natively, every comparison but `in` is a test of
+// whether a word lies in an inclusive range, with the
+// sign bit flipped to map signed order onto unsigned.
+function toPredicate(op, a, b, sign) {
+  const code = PREDICATES.indexOf(op);
+
+  enforce(code !== -1, 'op', 'operator');
+
+  const p = {
+    bias: sign ? 0x80000000 : 0,
+    lohi: 0,
+    lolo: 0,
+    hihi: 0xffffffff,
+    hilo: 0xffffffff,
+    invert: false,
+    none: false,
+    set: null
+  };
+
+  if (op === 'in') {
+    p.set = toValueSet(a);
+    p.none = p.set.size === 0;
+    return p;
+  }
+
+  const x = toBound(a);
+  const xhi = (x.hi ^ p.bias) >>> 0;
+  const xlo = x.lo >>> 0;
+
+  switch (op) {
+    case 'eq':
+    case 'ne':
+      p.lohi = p.hihi = xhi;
+      p.lolo = p.hilo = xlo;
+      p.invert = op === 'ne';
+      break;
+    case 'lt':
+      p.none = xhi === 0 && xlo === 0;
+      p.hihi = xlo === 0 ? xhi - 1 : xhi;
+      p.hilo = (xlo - 1) >>> 0;
+      break;
+    case 'lte':
+      p.hihi = xhi;
+      p.hilo = xlo;
+      break;
+    case 'gt':
+      p.none = xhi === 0xffffffff && xlo === 0xffffffff;
+      p.lohi = xlo === 0xffffffff ? xhi + 1 : xhi;
+      p.lolo = (xlo + 1) >>> 0;
+      break;
+    case 'gte':
+      p.lohi = xhi;
+      p.lolo = xlo;
+      break;
+    case 'between': {
+      const y = toBound(b);
+
+      p.lohi = xhi;
+      p.lolo = xlo;
+      p.hihi = (y.hi ^ p.bias) >>> 0;
+      p.hilo = y.lo >>> 0;
+      p.none = p.lohi > p.hihi || (p.lohi === p.hihi && p.lolo > p.hilo);
+
+      break;
+    }
+  }
+
+  return p;
+}
+
+function testPredicate(p, hi, lo) {
+  if (p.none)
+    return false;
+
+  if (p.set) {
+    const los = p.set.get(hi | 0);
+    return los !== undefined && los.has(lo | 0);
+  }
+
+  const h = (hi ^ p.bias) >>> 0;
+  const l = lo >>> 0;
+
+  const above = h > p.lohi || (h === p.lohi && l >= p.lolo);
+  const below = h < p.hihi || (h === p.hihi && l <= p.hilo);
+
+  return (above && below) !== p.invert;
+}
+
+function toBound(value) {
+  if (typeof value === 'number') {
+    enforce(Number.isSafeInteger(value), 'value', 'integer');
+    return U64.fromNumber(value);
+  }
+
+  enforce(value && typeof value === 'object', 'value', 'int64');
+
+  return U64.fromObject(value);
+}
+
+// Maps each hi word to the set of lo words.
+function toValueSet(values) {
+  const set = new Map();
+
+  if (Array.isArray(values)) {
+    for (const value of values) {
+      const x = toBound(value);
+      addValue(set, x.hi | 0, x.lo | 0);
+    }
+
+    return set;
+  }
+
+  enforce(values instanceof N64Array
+          || ArrayBuffer.isView(values)
+          || isBuffer(values), 'values', 'array');
+
+  const data = toBytes(values);
+
+  if (data.length & 7)
+    throw new Error('Invalid buffer length.');
+
+  for (let i = 0; i < data.length; i += 8)
+    addValue(set, readI32LE(data, i + 4), readI32LE(data, i));
+
+  return set;
+}
+
+function addValue(set, hi, lo) {
+  let los = set.get(hi);
+
+  if (los === undefined) {
+    los = new Set();
+    set.set(hi, los);
+  }
+
+  los.add(lo);
+}
+
+function isSelection(arr) {
+  return arr instanceof Uint8Array || arr instanceof Uint32Array;
+}
+
+function countSelected(bits, count) {
+  let n = 0;
+
+  for (let i = 0; i < count; i++) {
+    if (bits[i >>> 3] & (1 << (i & 7)))
+      n += 1;
+  }
+
+  return n;
+}
+
+function copyWord(dst, i, src, j) {
+  for (let k = 0; k < 8; k++)
+    dst[i * 8 + k] = src[j * 8 + k];
+}
+
+/*
+ * Filtering Constants
+ */
+
+const PREDICATES = [
+  'eq', 'ne', 'lt', 'lte', 'gt', 'gte', 'between', 'in'
+];
+
+/*
+ * JSON
+ */
+
+U64.serializeJSON = function serializeJSON(column, options) {
+  return writeJSON(column, options, U64);
+};
+
+I64.serializeJSON = function serializeJSON(column, options) {
+  return writeJSON(column, options, I64);
+};
+
+U64.parseJSON = function parseJSON(data, options) {
+  return new JSONParser(U64Array, options).end(data);
+};
+
+I64.parseJSON = function parseJSON(data, options) {
+  return new JSONParser(I64Array, options).end(data);
+};
+
+U64.jsonParser = function jsonParser(options) {
+  return new JSONParser(U64Array, options);
+};
+
+I64.jsonParser = function jsonParser(options) {
+  return new JSONParser(I64Array, options);
+};
+
+/*
+ * JSONParser
+ */
+
+// Values may be split across chunks anywhere. The
+// states are those of n64_json_parse in src/core.cc.
+function JSONParser(ctor, options) {
+  const {base} = toJSONOptions(options);
+
+  this.array = new ctor();
+  this.num = new this.array.ctor();
+  this.base = base;
+  this.state = JSON_OPEN;
+  this.str = '';
+}
+
+JSONParser.prototype.write = function write(chunk) {
+  const isString = typeof chunk === 'string';
+
+  enforce(isString || chunk instanceof Uint8Array, 'data', 'buffer');
+
+  for (let i = 0; i < chunk.length; i++) {
+    const ch = isString ? chunk.charCodeAt(i) : chunk[i];
+
+    switch (this.state) {
+      case JSON_OPEN:
+        if (ch === 0x5b /* [ */)
+          this.state = JSON_FIRST;
+        else if (!isSpace(ch))
+          this.fail();
+        break;
+
+      case JSON_FIRST:
+        if (ch === 0x5d /* ] */) {
+          this.state = JSON_DONE;
+          break;
+        }
+
+        // Fall through.
+
+      case JSON_VALUE:
+        if (isSpace(ch))
+          break;
+
+        if (ch === 0x22 /* " */) {
+          this.state = JSON_STRING;
+        } else if (ch === 0x2d /* - */ || (ch >= 0x30 && ch <= 0x39)) {
+          this.str = String.fromCharCode(ch);
+          this.state = JSON_NUMBER;
+        } else {
+          this.fail();
+        }
+
+        break;
+
+      case JSON_STRING:
+        if (ch !== 0x22 /* " */) {
+          // A sign and 64 binary digits at most.
+          if (this.str.length === 65)
+            this.fail();
+
+          this.str += String.fromCharCode(ch);
+
+          break;
+        }
+
+        this.push(this.base);
+        this.state = JSON_NEXT;
+
+        break;
+
+      case JSON_NUMBER:
+        if (ch >= 0x30 && ch <= 0x39) {
+          if (this.str.length === 21)
+            this.fail();
+
+          this.str += String.fromCharCode(ch);
+
+          break;
+        }
+
+        if (ch !== 0x2c /* , */ && ch !== 0x5d /* ] */ && !isSpace(ch))
+          this.fail();
+
+        if (!isBareNumber(this.str))
+          this.fail();
+
+        // Bare numbers are always decimal.
+        this.push(10);
+        this.state = JSON_NEXT;
+
+        // Fall through.
+
+      case JSON_NEXT:
+        if (ch === 0x2c /* , */)
+          this.state = JSON_VALUE;
+        else if (ch === 0x5d /* ] */)
+          this.state = JSON_DONE;
+        else if (!isSpace(ch))
+          this.fail();
+        break;
+
+      case JSON_DONE:
+        if (!isSpace(ch))
+          this.fail();
+        break;
+
+      default:
+        this.fail();
+        break;
+    }
+  }
+
+  return this;
+};
+
+JSONParser.prototype.push = function push(base) {
+  if (this.num._read(this.str, base) !== null)
+    this.fail();
+
+  this.array.push(this.num);
+  this.str = '';
+};
+
+JSONParser.prototype.fail = function fail() {
+  this.state = JSON_ERROR;
+  throw new Error('Invalid JSON.');
+};
+
+JSONParser.prototype.end = function end(chunk) {
+  if (chunk != null)
+    this.write(chunk);
+
+  if (this.state !== JSON_DONE)
+    this.fail();
+
+  // The parser is spent.
+  this.state = JSON_ERROR;
+
+  return this.array;
+};
+
+/*
+ * JSON Helpers
+ */
+
+function writeJSON(column, options, ctor) {
+  const {base, pad, quoted} = toJSONOptions(options);
+  const data = toBytes(column);
+
+  if (data.length & 7)
+    throw new Error('Invalid buffer length.');
+
+  const num = new ctor();
+  const parts = [];
+
+  for (let i = 0; i < data.length; i += 8) {
+    num.readLE(data, i);
+
+    const str = num.toString(base, pad);
+
+    parts.push(quoted ? `"${str}"` : str);
+  }
+
+  const str = `[${parts.join(',')}]`;
+  const out = typeof Buffer === 'function'
+    ? Buffer.allocUnsafe(str.length)
+    : new Uint8Array(str.length);
+
+  for (let i = 0; i < str.length; i++)
+    out[i] = str.charCodeAt(i);
+
+  return out;
+}
+
+// Defaults to what JSON.stringify makes of toJSON().
+function toJSONOptions(options) {
+  if (options == null)
+    options = {};
+
+  enforce(typeof options === 'object', 'options', 'object');
+
+  const base = options.base != null ? getBase(options.base) : 16;
+  const quoted = options.quoted != null ? Boolean(options.quoted) : true;
+  const pad = options.pad != null ? options.pad : (base === 16 ? 16 : 0);
+
+  enforce((base >>> 0) === base, 'base', 'integer');
+  enforce((pad >>> 0) === pad, 'pad', 'integer');
+
+  if (base < 2 || base > 16)
+    throw new Error('Base ranges between 2 and 16.');
+
+  if (pad > 64)
+    throw new Error('Maximum padding is 64 characters.');
+
+  // JSON numbers are decimal.
+  if (!quoted && base !== 10)
+    throw new Error('Unquoted values must be decimal.');
+
+  return { base, pad, quoted };
+}
+
+function isSpace(ch) {
+  return ch === 0x20 || ch === 0x09 || ch === 0x0a || ch === 0x0d;
+}
+
+// Bare numbers follow the JSON grammar, which
+// allows no leading zeros (the digits and the
+// sign are checked as they are read).
+function isBareNumber(str) {
+  const start = str.charCodeAt(0) === 0x2d /* - */ ? 1 : 0;
+
+  if (start === str.length)
+    return false;
+
+  return str.charCodeAt(start) !== 0x30 /* 0 */ || str.length === start + 1;
+}
+
+/*
+ * JSON Constants
+ */
+
+const JSON_OPEN = 0;
+const JSON_FIRST = 1;
+const JSON_VALUE = 2;
+const JSON_STRING = 3;
+const JSON_NUMBER = 4;
+const JSON_NEXT = 5;
+const JSON_DONE = 6;
+const JSON_ERROR = 7;
+
+/*
+ * N64Array Constants
+ */
+
+const ARRAY_MIN_CAP = 8;
+
+/*
+ * Atomic
+ *
+ * Implemented with Atomics on a BigUint64Array,
+ * which allocates a BigInt per operation. The
+ * native backend operates on the memory directly.
+ */
+
+function Atomic(ctor) {
+  if (!(this instanceof Atomic))
+    return new Atomic(ctor);
+
+  enforce(typeof ctor === 'function', 'ctor', 'constructor');
+
+  this.ctor = ctor;
+}
+
+Atomic.prototype._rmw = function _rmw(op, data, index, value, out) {
+  const words = toWords(data, index);
+  const num = toBig(value);
+
+  enforce(out == null || N64.isN64(out), 'out', 'int64');
+
+  const prev = op(words, index, num);
+
+  if (out != null)
+    fromBig(out, prev);
+
+  return out;
+};
+
+Atomic.prototype.add = function add(data, index, value, out) {
+  return this._rmw(Atomics.add, data, index, value, out);
+};
+
+Atomic.prototype.sub = function sub(data, index, value, out) {
+  return this._rmw(Atomics.sub, data, index, value, out);
+};
+
+Atomic.prototype.and = function and(data, index, value, out) {
+  return this._rmw(Atomics.and, data, index, value, out);
+};
+
+Atomic.prototype.or = function or(data, index, value, out) {
+  return this._rmw(Atomics.or, data, index, value, out);
+};
+
+Atomic.prototype.xor = function xor(data, index, value, out) {
+  return this._rmw(Atomics.xor, data, index, value, out);
+};
+
+Atomic.prototype.exchange = function exchange(data, index, value, out) {
+  return this._rmw(Atomics.exchange, data, index, value, out);
+};
+
+Atomic.prototype.compareExchange = function compareExchange(data, index,
+                                                            expected,
+                                                            replacement,
+                                                            out) {
+  const words = toWords(data, index);
+  const exp = toBig(expected);
+  const rep = toBig(replacement);
+
+  enforce(out == null || N64.isN64(out), 'out', 'int64');
+
+  const prev = Atomics.compareExchange(words, index, exp, rep);
+
+  if (out != null)
+    fromBig(out, prev);
+
+  return prev === exp;
+};
+
+Atomic.prototype.load = function load(data, index, out) {
+  if (out == null)
+    out = new this.ctor();
+
+  enforce(N64.isN64(out), 'out', 'int64');
+
+  const words = toWords(data, index);
+
+  return fromBig(out, Atomics.load(words, index));
+};
+
+Atomic.prototype.store = function store(data, index, value) {
+  const words = toWords(data, index);
+  Atomics.store(words, index, toBig(value));
+};
+
+Atomic.prototype.counter = function counter(data) {
+  return new Counter(this.ctor, data);
+};
+
+U64.atomic = new Atomic(U64);
+I64.atomic = new Atomic(I64);
+
+U64.math = new IntMath(U64);
+I64.math = new IntMath(I64);
+
+/*
+ * Counter
+ */
+
+function Counter(ctor, data) {
+  if (!(this instanceof Counter))
+    return new Counter(ctor, data);
+
+  enforce(typeof ctor === 'function', 'ctor', 'constructor');
+
+  if (data == null)
+    data = COUNTER_STRIPES;
+
+  if (typeof data === 'number') {
+    enforce((data >>> 0) === data && data > 0, 'stripes', 'integer');
+    data = new SharedArrayBuffer(data * COUNTER_STRIDE);
+  }
+
+  enforce(isBuffer(data), 'data', 'shared buffer');
+
+  if (data.byteLength === 0 || (data.byteLength % COUNTER_STRIDE) !== 0)
+    throw new Error('Invalid counter buffer.');
+
+  this.ctor = ctor;
+  this.atomic = ctor.atomic;
+  this.buffer = data;
+  this.stripes = data.byteLength / COUNTER_STRIDE;
+  this.index = (THREAD_ID % this.stripes) * (COUNTER_STRIDE / 8);
+}
+
+Counter.prototype.add = function add(value) {
+  this.atomic.add(this.buffer, this.index, value);
+  return this;
+};
+
+Counter.prototype.sub = function sub(value) {
+  this.atomic.sub(this.buffer, this.index, value);
+  return this;
+};
+
+Counter.prototype.value = function value(out) {
+  if (out == null)
+    out = new this.ctor();
+
+  enforce(N64.isN64(out), 'out', 'int64');
+
+  const tmp = new this.ctor();
+
+  out.fromInt(0);
+
+  for (let i = 0; i < this.stripes; i++) {
+    this.atomic.load(this.buffer, i * (COUNTER_STRIDE / 8), tmp);
+    out.iadd(tmp);
+  }
+
+  return out;
+};
+
+Counter.prototype.reset = function reset() {
+  for (let i = 0; i < this.stripes; i++)
+    this.atomic.store(this.buffer, i * (COUNTER_STRIDE / 8), 0);
+
+  return this;
+};
+
+/*
+ * Counter Constants
+ */
+
+// One stripe per cache line.
+const COUNTER_STRIDE = 64;
+const COUNTER_STRIPES = 16;
+
+// No thread id without node; spread
+// threads across stripes at random.
+const THREAD_ID = (Math.random() * 0x100000000) >>> 0;
+
+/*
+ * Messaging
+ */
+
+function serialize(value) {
+  if (N64.isN64(value)) {
+    const data = new Uint8Array(16);
+
+    data[0] = value.sign ? MESSAGE_I64 : MESSAGE_U64;
+
+    value.writeRaw(data, 8);
+
+    return data;
+  }
+
+  if (value instanceof N64Array) {
+    const data = new Uint8Array(8 + value.length * 8);
+
+    data[0] = value.sign ? MESSAGE_I64_ARRAY : MESSAGE_U64_ARRAY;
+
+    writeI32LE(data, value.length, 4);
+
+    data.set(value.toBuffer(), 8);
+
+    return data;
+  }
+
+  if (value instanceof Histogram) {
+    const data = value.encode(8);
+
+    data[0] = value.sign ? MESSAGE_I64_HISTOGRAM : MESSAGE_U64_HISTOGRAM;
+
+    writeI32LE(data, data.length - 8, 4);
+
+    return data;
+  }
+
+  enforce(Array.isArray(value), 'value', 'int64');
+
+  // Signs first, then the values on an 8 byte boundary.
+  const count = value.length;
+  const start = 8 + ((count + 7) & ~7);
+  const data = new Uint8Array(start + count * 8);
+
+  data[0] = MESSAGE_LIST;
+
+  writeI32LE(data, count, 4);
+
+  for (let i = 0; i < count; i++) {
+    const num = value[i];
+
+    enforce(N64.isN64(num), 'value', 'int64');
+
+    data[8 + i] = num.sign;
+
+    num.writeRaw(data, start + i * 8);
+  }
+
+  return data;
+}
+
+function deserialize(data) {
+  data = toBytes(data);
+
+  if (data.length < 8)
+    throw new Error('Invalid message.');
+
+  const count = readI32LE(data, 4) >>> 0;
+
+  switch (data[0]) {
+    case MESSAGE_U64:
+    case MESSAGE_I64: {
+      if (data.length < 16)
+        throw new Error('Invalid message.');
+
+      const ctor = data[0] === MESSAGE_I64 ? I64 : U64;
+
+      return ctor.readRaw(data, 8);
+    }
+
+    case MESSAGE_U64_ARRAY:
+    case MESSAGE_I64_ARRAY: {
+      const ctor = data[0] === MESSAGE_I64_ARRAY ? I64Array : U64Array;
+      const end = 8 + count * 8;
+
+      if (data.length < end)
+        throw new Error('Invalid message.');
+
+      // Read in place where the payload is aligned.
+      let body = data.subarray(8, end);
+
+      if (body.byteOffset & 7)
+        body = new Uint8Array(body);
+
+      return ctor.fromBuffer(body);
+    }
+
+    case MESSAGE_U64_HISTOGRAM:
+    case MESSAGE_I64_HISTOGRAM: {
+      const ctor = data[0] === MESSAGE_I64_HISTOGRAM ? I64 : U64;
+
+      if (data.length < 8 + count)
+        throw new Error('Invalid message.');
+
+      return Histogram.decode(ctor, data.subarray(8, 8 + count));
+    }
+
+    case MESSAGE_LIST: {
+      const start = 8 + ((count + 7) & ~7);
+      const items = [];
+
+      if (data.length < start + count * 8)
+        throw new Error('Invalid message.');
+
+      for (let i = 0; i < count; i++) {
+        const ctor = data[8 + i] ? I64 : U64;
+        items.push(ctor.readRaw(data, start + i * 8));
+      }
+
+      return items;
+    }
+  }
+
+  throw new Error('Invalid message.');
+}
+
+/*
+ * Messaging Constants
+ */
+
+const MESSAGE_U64 = 1;
+const MESSAGE_I64 = 2;
+const MESSAGE_U64_ARRAY = 3;
+const MESSAGE_I64_ARRAY = 4;
+const MESSAGE_LIST = 5;
+const MESSAGE_U64_HISTOGRAM = 6;
+const MESSAGE_I64_HISTOGRAM = 7;
+
+/*
+ * Helpers
+ */
+
+function getBase(base) {
+  if (base == null)
+    return 10;
+
+  if (typeof base === 'number')
+    return base;
+
+  switch (base) {
     case 'bin':
       return 2;
     case 'oct':
@@ -1475,6 +7493,59 @@ function getBase(base) {
   return 0;
 }
 
+function toSeed(seed) {
+  if (seed == null) {
+    return U64.fromBits((Math.random() * 0x100000000) | 0,
+                        (Math.random() * 0x100000000) | 0);
+  }
+
+  if (N64.isN64(seed))
+    return U64.fromBits(seed.hi, seed.lo);
+
+  return U64.from(seed);
+}
+
+function toLayout(options) {
+  if (options == null)
+    options = {};
+
+  enforce(typeof options === 'object', 'options', 'object');
+
+  let {lowest, highest, significantDigits} = options;
+
+  if (lowest == null)
+    lowest = 1;
+
+  if (highest == null)
+    highest = Number.MAX_SAFE_INTEGER;
+
+  if (significantDigits == null)
+    significantDigits = 3;
+
+  enforce((significantDigits >>> 0) === significantDigits,
+          'significantDigits', 'integer');
+
+  if (significantDigits < 1 || significantDigits > 5)
+    throw new Error('Invalid significant digits.');
+
+  return [toHistValue(lowest, new U64()).toU64(),
+          toHistValue(highest, new U64()).toU64(),
+          significantDigits];
+}
+
+function toDigit(ch) {
+  if (ch >= 0x30 && ch <= 0x39)
+    return ch - 0x30;
+
+  if (ch >= 0x41 && ch <= 0x5a)
+    return ch - 0x41 + 10;
+
+  if (ch >= 0x61 && ch <= 0x7a)
+    return ch - 0x61 + 10;
+
+  return 36;
+}
+
 function countBits(word) {
   if (Math.clz32)
     return 32 - Math.clz32(word);
@@ -1489,12 +7560,6 @@ function countBits(word) {
   return bit + 1;
 }
 
-function floor(n) {
-  if (n < 0)
-    return -Math.floor(-n);
-  return Math.floor(n);
-}
-
 function enforce(value, name, type) {
   if (!value) {
     const err = new TypeError(`'${name}' must be a(n) ${type}.`);
@@ -1504,6 +7569,20 @@ function enforce(value, name, type) {
   }
 }
 
+function isScale(scale) {
+  return (scale >>> 0) === scale && scale <= DEC64_MAX_SCALE;
+}
+
+function getMode(mode) {
+  if (mode == null)
+    return Dec64.ROUND_HALF_EVEN;
+
+  enforce((mode >>> 0) === mode && mode <= Dec64.ROUND_HALF_EVEN,
+          'mode', 'rounding mode');
+
+  return mode;
+}
+
 function isNumber(num) {
   return typeof num === 'number' && isFinite(num);
 }
@@ -1525,6 +7604,126 @@ function isSafeInteger(num) {
     && num <= 0x001fffffffffffff;
 }
 
+function toFields(fields) {
+  enforce(Array.isArray(fields), 'fields', 'array');
+
+  const items = [];
+  const seen = new Set();
+
+  let offset = 0;
+
+  for (const field of fields) {
+    enforce(field && typeof field === 'object', 'field', 'object');
+
+    const {name, type, size} = field;
+
+    if (type === 'pad') {
+      enforce((size >>> 0) === size, 'size', 'integer');
+      offset += size;
+      continue;
+    }
+
+    enforce(typeof name === 'string' && name.length > 0, 'name', 'string');
+    enforce(typeof type === 'string', 'type', 'string');
+
+    const m = /^([iu])(8|16|32|64)(le|be)?$/.exec(type);
+
+    if (!m)
+      throw new Error(`Invalid field type: ${type}.`);
+
+    if (name === '__proto__' || seen.has(name))
+      throw new Error(`Invalid field name: ${name}.`);
+
+    const width = m[2] >>> 3;
+    const be = width > 1 && m[3] === 'be' ? 1 : 0;
+
+    seen.add(name);
+
+    items.push({
+      name,
+      type: m[1] + m[2] + (width > 1 ? (be ? 'be' : 'le') : ''),
+      offset,
+      width,
+      sign: m[1] === 'i' ? 1 : 0,
+      be
+    });
+
+    offset += width;
+  }
+
+  if (items.length === 0)
+    throw new Error('Struct has no fields.');
+
+  if (offset > 0xffffffff)
+    throw new Error('Struct size exceeds limit.');
+
+  return [items, offset];
+}
+
+function toColumn(field, length) {
+  switch (field.width) {
+    case 1:
+      return field.sign ? new Int8Array(length) : new Uint8Array(length);
+    case 2:
+      return field.sign ? new Int16Array(length) : new Uint16Array(length);
+    case 4:
+      return field.sign ? new Int32Array(length) : new Uint32Array(length);
+  }
+
+  return field.sign ? new I64Array(length) : new U64Array(length);
+}
+
+function isColumn(column, field) {
+  if (field.width === 8)
+    return column instanceof N64Array;
+
+  return ArrayBuffer.isView(column)
+      && column.BYTES_PER_ELEMENT === field.width;
+}
+
+function readField(data, off, field) {
+  let num;
+
+  switch (field.width) {
+    case 1:
+      num = data[off];
+      return field.sign ? (num << 24) >> 24 : num;
+    case 2:
+      if (field.be)
+        num = (data[off] << 8) | data[off + 1];
+      else
+        num = data[off] | (data[off + 1] << 8);
+      return field.sign ? (num << 16) >> 16 : num;
+  }
+
+  num = field.be ? readI32BE(data, off) : readI32LE(data, off);
+
+  return field.sign ? num : num >>> 0;
+}
+
+function writeField(data, off, field, num) {
+  switch (field.width) {
+    case 1:
+      data[off] = num & 0xff;
+      break;
+    case 2:
+      if (field.be) {
+        data[off] = (num >>> 8) & 0xff;
+        data[off + 1] = num & 0xff;
+      } else {
+        data[off] = num & 0xff;
+        data[off + 1] = (num >>> 8) & 0xff;
+      }
+      break;
+    default:
+      if (field.be)
+        writeI32BE(data, num, off);
+      else
+        writeI32LE(data, num, off);
+      break;
+  }
+}
+
 function alloc(ArrayLike, size) {
   if (ArrayLike.allocUnsafe)
     return ArrayLike.allocUnsafe(size);
@@ -1532,6 +7731,320 @@ function alloc(ArrayLike, size) {
   return new ArrayLike(size);
 }
 
+const VIEWS = new WeakMap();
+
+function viewProto(ctor) {
+  // Views inherit from the constructor's prototype
+  // but route hi/lo through the buffer so that every
+  // method operates on the slot.
+  if (!VIEWS.has(ctor)) {
+    const proto = Object.create(ctor.prototype, {
+      lo: {
+        get: function() {
+          return readI32LE(this.view.data, this.view.off);
+        },
+        set: function(lo) {
+          writeI32LE(this.view.data, lo, this.view.off);
+        }
+      },
+      hi: {
+        get: function() {
+          return readI32LE(this.view.data, this.view.off + 4);
+        },
+        set: function(hi) {
+          writeI32LE(this.view.data, hi, this.view.off + 4);
+        }
+      }
+    });
+
+    VIEWS.set(ctor, [proto, new ctor().sign]);
+  }
+
+  return VIEWS.get(ctor);
+}
+
+function toBytes(data) {
+  if (data instanceof N64Array)
+    return data.toBuffer();
+
+  if (data instanceof ArrayBuffer)
+    return new Uint8Array(data);
+
+  if (typeof SharedArrayBuffer === 'function'
+      && data instanceof SharedArrayBuffer) {
+    return new Uint8Array(data);
+  }
+
+  enforce(ArrayBuffer.isView(data), 'data', 'buffer');
+
+  if (data instanceof Uint8Array)
+    return data;
+
+  return new Uint8Array(data.buffer, data.byteOffset, data.byteLength);
+}
+
+function toWords(data, index) {
+  if (typeof BigUint64Array !== 'function')
+    throw new Error('Atomics are not supported.');
+
+  let bytes;
+
+  if (data instanceof N64Array) {
+    const {words, off, length} = data;
+    bytes = new Uint8Array(words.buffer, words.byteOffset + off * 8, length * 8);
+  } else {
+    bytes = toBytes(data);
+  }
+
+  enforce((index >>> 0) === index, 'index', 'integer');
+
+  if (index >= (bytes.length >>> 3))
+    throw new Error('Invalid index.');
+
+  if (bytes.byteOffset & 7)
+    throw new Error('Unaligned offset.');
+
+  return new BigUint64Array(bytes.buffer, bytes.byteOffset,
+                            bytes.length >>> 3);
+}
+
+function toBig(value) {
+  if (typeof value === 'number') {
+    enforce(Number.isSafeInteger(value), 'value', 'integer');
+    return BigInt.asUintN(64, BigInt(value));
+  }
+
+  enforce(value && typeof value === 'object', 'value', 'int64');
+
+  const hi = BigInt(value.hi >>> 0);
+  const lo = BigInt(value.lo >>> 0);
+
+  return (hi << BigInt(32)) | lo;
+}
+
+function fromBig(out, value) {
+  const hi = Number(value >> BigInt(32));
+  const lo = Number(value & BigInt(0xffffffff));
+
+  return out.join(hi, lo);
+}
+
+function columnOptions(options) {
+  if (options == null)
+    options = {};
+
+  enforce(typeof options === 'object', 'options', 'object');
+
+  const {delimiter, column, base, header, threads} = options;
+  const opts = {
+    delimiter: 0x2c,
+    column: 0,
+    base: base,
+    header: false,
+    threads: 1
+  };
+
+  if (delimiter != null) {
+    enforce(typeof delimiter === 'string'
+            && delimiter.length === 1, 'delimiter', 'character');
+
+    opts.delimiter = delimiter.charCodeAt(0);
+
+    if (opts.delimiter === 0
+        || opts.delimiter >= 0x80
+        || opts.delimiter === 0x0a
+        || opts.delimiter === 0x0d) {
+      throw new Error('Invalid delimiter.');
+    }
+  }
+
+  if (column != null) {
+    enforce((column >>> 0) === column, 'column', 'integer');
+    opts.column = column;
+  }
+
+  if (header != null) {
+    enforce(typeof header === 'boolean', 'header', 'boolean');
+    opts.header = header;
+  }
+
+  if (threads != null) {
+    enforce((threads >>> 0) === threads, 'threads', 'integer');
+    opts.threads = threads;
+  }
+
+  return opts;
+}
+
+function skipRecord(data) {
+  const nl = data.indexOf(0x0a);
+
+  if (nl === -1)
+    return data.subarray(data.length);
+
+  return data.subarray(nl + 1);
+}
+
+function countRecords(data) {
+  let count = 0;
+
+  for (let i = 0; i < data.length; i++) {
+    if (data[i] === 0x0a)
+      count += 1;
+  }
+
+  if (data.length > 0 && data[data.length - 1] !== 0x0a)
+    count += 1;
+
+  return count;
+}
+
+function findByte(data, ch, start, end) {
+  for (let i = start; i < end; i++) {
+    if (data[i] === ch)
+      return i;
+  }
+
+  return -1;
+}
+
+function latin1(data, start, end) {
+  return String.fromCharCode.apply(null, data.subarray(start, end));
+}
+
+function getRound(mode) {
+  if (mode == null)
+    return ROUND_STRICT;
+
+  enforce((mode >>> 0) === mode && mode <= Dec64.ROUND_HALF_EVEN,
+          'mode', 'rounding mode');
+
+  return mode;
+}
+
+function roundWord(hi, lo, sign, mode) {
+  // Rounds a word beyond 53 bits to a double with
+  // the given mode, keeping its top 53 bits.
+  const neg = sign && hi < 0;
+
+  if (neg) {
+    lo = (~lo + 1) >>> 0;
+    hi = (~hi + (lo === 0 ? 1 : 0)) >>> 0;
+  } else {
+    hi >>>= 0;
+  }
+
+  const shift = 11 - Math.clz32(hi);
+  const d = 2 ** shift;
+  const q = hi * 2 ** (32 - shift) + Math.floor(lo / d);
+  const r = lo % d;
+
+  let z = q;
+
+  if (roundUp(neg, q, r, d, mode))
+    z += 1;
+
+  z *= d;
+
+  return neg ? -z : z;
+}
+
+function roundDouble(x, mode) {
+  // `x - trunc(x)` is exact.
+  const t = Math.trunc(x);
+  const f = Math.abs(x - t);
+  const away = x < 0 ? t - 1 : t + 1;
+
+  if (f === 0)
+    return t;
+
+  switch (mode) {
+    case Dec64.ROUND_DOWN:
+      return t;
+    case Dec64.ROUND_UP:
+      return away;
+    case Dec64.ROUND_FLOOR:
+      return x < 0 ? away : t;
+    case Dec64.ROUND_CEIL:
+      return x < 0 ? t : away;
+    case Dec64.ROUND_HALF_UP:
+      return f >= 0.5 ? away : t;
+    case Dec64.ROUND_HALF_DOWN:
+      return f > 0.5 ? away : t;
+  }
+
+  return f > 0.5 || (f === 0.5 && t % 2 !== 0) ? away : t;
+}
+
+function roundUp(neg, q, r, d, mode) {
+  if (r === 0)
+    return false;
+
+  switch (mode) {
+    case Dec64.ROUND_DOWN:
+      return false;
+    case Dec64.ROUND_UP:
+      return true;
+    case Dec64.ROUND_FLOOR:
+      return neg;
+    case Dec64.ROUND_CEIL:
+      return !neg;
+    case Dec64.ROUND_HALF_UP:
+      return r >= d - r;
+    case Dec64.ROUND_HALF_DOWN:
+      return r > d - r;
+  }
+
+  return r > d - r || (r === d - r && q % 2 === 1);
+}
+
+function isWords(arr) {
+  return arr instanceof Int32Array || arr instanceof Uint32Array;
+}
+
+function overlaps(a, b) {
+  if (a.buffer !== b.buffer)
+    return false;
+
+  return a.byteLength > 0 && b.byteLength > 0
+      && a.byteOffset < b.byteOffset + b.byteLength
+      && b.byteOffset < a.byteOffset + a.byteLength;
+}
+
+function isBuffer(data) {
+  if (data instanceof ArrayBuffer)
+    return true;
+
+  return typeof SharedArrayBuffer === 'function'
+      && data instanceof SharedArrayBuffer;
+}
+
+function toIndex(index, length, def, name) {
+  if (index == null)
+    return def;
+
+  enforce(Number.isSafeInteger(index), name, 'integer');
+
+  if (index < 0)
+    index += length;
+
+  if (index < 0)
+    return 0;
+
+  if (index > length)
+    return length;
+
+  return index;
+}
+
+function checkSlot(bytes, off) {
+  if (off + 8 > bytes.length)
+    throw new Error('Invalid offset.');
+
+  if ((bytes.byteOffset + off) & 7)
+    throw new Error('Unaligned offset.');
+}
+
 function readI32LE(data, off) {
   return data[off]
     | (data[off + 1] << 8)
@@ -1567,3 +8080,18 @@ function writeI32BE(data, num, off) {
 exports.N64 = N64;
 exports.U64 = U64;
 exports.I64 = I64;
+exports.N128 = N128;
+exports.U128 = U128;
+exports.I128 = I128;
+exports.RNG = RNG;
+exports.Histogram = Histogram;
+exports.Struct = Struct;
+exports.Dec64 = Dec64;
+exports.N64Array = N64Array;
+exports.U64Array = U64Array;
+exports.I64Array = I64Array;
+exports.Atomic = Atomic;
+exports.Counter = Counter;
+exports.serialize = serialize;
+exports.deserialize = deserialize;
+exports.struct = Struct;
@@ -6,7 +6,7 @@
 
 'use strict';
 
-const Native = require('loady')('n64', __dirname).N64;
+const binding = require('loady')('n64', __dirname);
 
 /*
  * N64 (abstract)
@@ -14,7 +14,8 @@ const Native = require('loady')('n64', __dirname).N64;
 
 function N64(sign) {
   enforce(this instanceof N64, 'this', 'N64');
-  this.n = new Native(sign);
+  enforce(sign === 0 || sign === 1, 'sign', 'bit');
+  this.n = native(sign);
 }
 
 /*
@@ -42,7 +43,15 @@ N64.prototype.__defineGetter__('sign', function() {
 });
 
 N64.prototype.__defineSetter__('sign', function(value) {
-  return this.n.setSign(value);
+  enforce(value === 0 || value === 1, 'sign', 'bit');
+
+  // The native sign is fixed per class. Views
+  // keep their slot across the swap.
+  if (value !== this.n.getSign()) {
+    const n = native(value);
+    n.share(this.n);
+    this.n = n;
+  }
 });
 
 /*
@@ -133,6 +142,19 @@ N64.prototype.divn = function divn(num) {
   return this.clone().idivn(num);
 };
 
+N64.prototype.tryIdiv = function tryIdiv(b) {
+  return this.n.tryIdiv(b.n);
+};
+
+N64.prototype.tryDiv = function tryDiv(b) {
+  enforce(N64.isN64(b), 'divisor', 'int64');
+
+  if (b.isZero())
+    return null;
+
+  return this.clone().idiv(b);
+};
+
 /*
  * Modulo
  */
@@ -155,6 +177,19 @@ N64.prototype.modn = function modn(num) {
   return this.clone().imodn(num);
 };
 
+N64.prototype.tryImod = function tryImod(b) {
+  return this.n.tryImod(b.n);
+};
+
+N64.prototype.tryMod = function tryMod(b) {
+  enforce(N64.isN64(b), 'divisor', 'int64');
+
+  if (b.isZero())
+    return null;
+
+  return this.clone().imod(b);
+};
+
 /*
  * Exponentiation
  */
@@ -185,6 +220,84 @@ N64.prototype.isqr = function isqr() {
   return this.imul(this);
 };
 
+/*
+ * Integer Math
+ */
+
+N64.prototype.isqrt = function isqrt() {
+  this.n.isqrt();
+  return this;
+};
+
+N64.prototype.sqrt = function sqrt() {
+  return this.clone().isqrt();
+};
+
+N64.prototype.icbrt = function icbrt() {
+  this.n.icbrt();
+  return this;
+};
+
+N64.prototype.cbrt = function cbrt() {
+  return this.clone().icbrt();
+};
+
+N64.prototype.log2 = function log2() {
+  return this.n.log2();
+};
+
+N64.prototype.log10 = function log10() {
+  return this.n.log10();
+};
+
+N64.prototype.igcd = function igcd(b) {
+  enforce(N64.isN64(b), 'operand', 'int64');
+  this.n.igcd(b.n);
+  return this;
+};
+
+N64.prototype.gcd = function gcd(b) {
+  return this.clone().igcd(b);
+};
+
+N64.prototype.ilcm = function ilcm(b) {
+  enforce(N64.isN64(b), 'operand', 'int64');
+  this.n.ilcm(b.n);
+  return this;
+};
+
+N64.prototype.lcm = function lcm(b) {
+  return this.clone().ilcm(b);
+};
+
+N64.prototype.isPowerOfTwo = function isPowerOfTwo() {
+  return this.n.isPowerOfTwo();
+};
+
+N64.prototype.inextPowerOfTwo = function inextPowerOfTwo() {
+  this.n.inextPowerOfTwo();
+  return this;
+};
+
+N64.prototype.nextPowerOfTwo = function nextPowerOfTwo() {
+  return this.clone().inextPowerOfTwo();
+};
+
+N64.prototype.divmod = function divmod(b) {
+  enforce(N64.isN64(b), 'divisor', 'int64');
+
+  const q = this.clone();
+  const r = new this.constructor();
+
+  q.n.idivmod(b.n, r.n);
+
+  return [q, r];
+};
+
+N64.prototype.divmodn = function divmodn(num) {
+  return [this.divn(num), this.modn(num)];
+};
+
 /*
  * AND
  */
@@ -461,6 +574,215 @@ N64.prototype.isEven = function isEven() {
   return this.n.isEven();
 };
 
+/*
+ * Atomic
+ */
+
+function Atomic(ctor) {
+  if (!(this instanceof Atomic))
+    return new Atomic(ctor);
+
+  enforce(typeof ctor === 'function', 'ctor', 'constructor');
+
+  this.ctor = ctor;
+}
+
+Atomic.prototype.add = function add(data, index, value, out) {
+  binding.atomic.add(toShared(data), index, toOperand(value), toOut(out));
+  return out;
+};
+
+Atomic.prototype.sub = function sub(data, index, value, out) {
+  binding.atomic.sub(toShared(data), index, toOperand(value), toOut(out));
+  return out;
+};
+
+Atomic.prototype.and = function and(data, index, value, out) {
+  binding.atomic.and(toShared(data), index, toOperand(value), toOut(out));
+  return out;
+};
+
+Atomic.prototype.or = function or(data, index, value, out) {
+  binding.atomic.or(toShared(data), index, toOperand(value), toOut(out));
+  return out;
+};
+
+Atomic.prototype.xor = function xor(data, index, value, out) {
+  binding.atomic.xor(toShared(data), index, toOperand(value), toOut(out));
+  return out;
+};
+
+Atomic.prototype.exchange = function exchange(data, index, value, out) {
+  binding.atomic.exchange(toShared(data), index,
+                          toOperand(value), toOut(out));
+  return out;
+};
+
+Atomic.prototype.compareExchange = function compareExchange(data, index,
+                                                            expected,
+                                                            replacement,
+                                                            out) {
+  return binding.atomic.compareExchange(toShared(data), index,
+                                        toOperand(expected),
+                                        toOperand(replacement),
+                                        toOut(out));
+};
+
+Atomic.prototype.load = function load(data, index, out) {
+  if (out == null)
+    out = new this.ctor();
+
+  enforce(N64.isN64(out), 'out', 'int64');
+
+  binding.atomic.load(toShared(data), index, out.n);
+
+  return out;
+};
+
+Atomic.prototype.store = function store(data, index, value) {
+  binding.atomic.store(toShared(data), index, toOperand(value));
+};
+
+Atomic.prototype.counter = function counter(data) {
+  return new Counter(this.ctor, data);
+};
+
+U64.atomic = new Atomic(U64);
+I64.atomic = new Atomic(I64);
+
+/*
+ * IntMath
+ */
+
+function IntMath(ctor) {
+  if (!(this instanceof IntMath))
+    return new IntMath(ctor);
+
+  enforce(typeof ctor === 'function', 'ctor', 'constructor');
+
+  this.ctor = ctor;
+  this.sign = ctor === I64 ? 1 : 0;
+}
+
+IntMath.prototype.sqrt = function sqrt(dst, src) {
+  return binding.bulk.unary(0, toShared(dst), toShared(src), this.sign);
+};
+
+IntMath.prototype.cbrt = function cbrt(dst, src) {
+  return binding.bulk.unary(1, toShared(dst), toShared(src), this.sign);
+};
+
+IntMath.prototype.nextPowerOfTwo = function nextPowerOfTwo(dst, src) {
+  return binding.bulk.unary(2, toShared(dst), toShared(src), this.sign);
+};
+
+IntMath.prototype.log2 = function log2(dst, src) {
+  return binding.bulk.log(3, dst, toShared(src), this.sign);
+};
+
+IntMath.prototype.log10 = function log10(dst, src) {
+  return binding.bulk.log(4, dst, toShared(src), this.sign);
+};
+
+IntMath.prototype.gcd = function gcd(dst, a, b) {
+  return binding.bulk.binary(5, toShared(dst),
+                             toShared(a), toShared(b), this.sign);
+};
+
+IntMath.prototype.lcm = function lcm(dst, a, b) {
+  return binding.bulk.binary(6, toShared(dst),
+                             toShared(a), toShared(b), this.sign);
+};
+
+IntMath.prototype.divmod = function divmod(q, r, a, b) {
+  return binding.bulk.divmod(toShared(q), toShared(r),
+                             toShared(a), toShared(b), this.sign);
+};
+
+U64.math = new IntMath(U64);
+I64.math = new IntMath(I64);
+
+/*
+ * Counter
+ */
+
+function Counter(ctor, data) {
+  if (!(this instanceof Counter))
+    return new Counter(ctor, data);
+
+  enforce(typeof ctor === 'function', 'ctor', 'constructor');
+
+  if (data == null)
+    data = COUNTER_STRIPES;
+
+  if (typeof data === 'number') {
+    enforce((data >>> 0) === data && data > 0, 'stripes', 'integer');
+    data = new SharedArrayBuffer(data * COUNTER_STRIDE);
+  }
+
+  enforce(isBuffer(data), 'data', 'shared buffer');
+
+  if (data.byteLength === 0 || (data.byteLength % COUNTER_STRIDE) !== 0)
+    throw new Error('Invalid counter buffer.');
+
+  this.ctor = ctor;
+  this.atomic = ctor.atomic;
+  this.buffer = data;
+  this.stripes = data.byteLength / COUNTER_STRIDE;
+  this.index = (THREAD_ID % this.stripes) * (COUNTER_STRIDE / 8);
+}
+
+Counter.prototype.add = function add(value) {
+  this.atomic.add(this.buffer, this.index, value);
+  return this;
+};
+
+Counter.prototype.sub = function sub(value) {
+  this.atomic.sub(this.buffer, this.index, value);
+  return this;
+};
+
+Counter.prototype.value = function value(out) {
+  if (out == null)
+    out = new this.ctor();
+
+  enforce(N64.isN64(out), 'out', 'int64');
+
+  const tmp = new this.ctor();
+
+  out.fromInt(0);
+
+  for (let i = 0; i < this.stripes; i++) {
+    this.atomic.load(this.buffer, i * (COUNTER_STRIDE / 8), tmp);
+    out.iadd(tmp);
+  }
+
+  return out;
+};
+
+Counter.prototype.reset = function reset() {
+  for (let i = 0; i < this.stripes; i++)
+    this.atomic.store(this.buffer, i * (COUNTER_STRIDE / 8), 0);
+
+  return this;
+};
+
+/*
+ * Counter Constants
+ */
+
+// One stripe per cache line.
+const COUNTER_STRIDE = 64;
+const COUNTER_STRIPES = 16;
+
+const THREAD_ID = (() => {
+  try {
+    return require('worker_threads').threadId >>> 0;
+  } catch (e) {
+    return 0;
+  }
+})();
+
 /*
  * Helpers
  */
@@ -555,6 +877,23 @@ N64.prototype.writeRaw = function writeRaw(data, off) {
   return this.writeLE(data, off);
 };
 
+N64.prototype.writeDecimal = function writeDecimal(data, off, pad) {
+  return this.n.writeString(data, off, 10, pad);
+};
+
+N64.prototype.writeHex = function writeHex(data, off, pad) {
+  return this.n.writeString(data, off, 16, pad);
+};
+
+/*
+ * Views
+ */
+
+N64.prototype.seek = function seek(off) {
+  this.n.seek(off);
+  return this;
+};
+
 /*
  * Conversion
  */
@@ -575,6 +914,10 @@ N64.prototype.toNumber = function toNumber() {
   return this.n.toNumber();
 };
 
+N64.prototype.tryToNumber = function tryToNumber() {
+  return this.n.tryToNumber();
+};
+
 N64.prototype.toDouble = function toDouble() {
   return this.n.toDouble();
 };
@@ -661,6 +1004,10 @@ N64.prototype.fromNumber = function fromNumber(num) {
   return this;
 };
 
+N64.prototype.tryFromNumber = function tryFromNumber(num) {
+  return this.n.tryFromNumber(num);
+};
+
 N64.prototype.fromInt = function fromInt(num) {
   this.n.fromInt(num);
   return this;
@@ -686,6 +1033,10 @@ N64.prototype.fromString = function fromString(str, base) {
   return this;
 };
 
+N64.prototype.tryFromString = function tryFromString(str, base) {
+  return this.n.tryFromString(str, base);
+};
+
 N64.prototype.fromJSON = function fromJSON(json) {
   return this.fromString(json, 16);
 };
@@ -809,6 +1160,11 @@ N64.fromNumber = function fromNumber(num) {
   return new this().fromNumber(num);
 };
 
+N64.tryFromNumber = function tryFromNumber(num) {
+  const n = new this();
+  return n.tryFromNumber(num) ? n : null;
+};
+
 N64.fromInt = function fromInt(num) {
   return new this().fromInt(num);
 };
@@ -829,6 +1185,11 @@ N64.fromString = function fromString(str, base) {
   return new this().fromString(str, base);
 };
 
+N64.tryFromString = function tryFromString(str, base) {
+  const n = new this();
+  return n.tryFromString(str, base) ? n : null;
+};
+
 N64.fromJSON = function fromJSON(json) {
   return new this().fromJSON(json);
 };
@@ -849,10 +1210,30 @@ N64.fromRaw = function fromRaw(data) {
   return new this().fromRaw(data);
 };
 
+N64.view = function view(data, off) {
+  if (off == null)
+    off = 0;
+
+  const bytes = toBytes(data);
+  const num = new this();
+
+  num.n.attach(bytes, off);
+
+  return num;
+};
+
 N64.from = function from(num, base) {
   return new this().from(num, base);
 };
 
+N64.rng = function rng(seed) {
+  return new RNG(this, seed);
+};
+
+N64.histogram = function histogram(options) {
+  return new Histogram(this, options);
+};
+
 N64.isN64 = function isN64(obj) {
   return obj instanceof N64;
 };
@@ -865,6 +1246,18 @@ N64.isI64 = function isI64(obj) {
   return obj instanceof I64;
 };
 
+N64.stats = function stats() {
+  return binding.stats();
+};
+
+N64.resetStats = function resetStats() {
+  binding.resetStats();
+};
+
+N64.cpuFeatures = function cpuFeatures() {
+  return binding.cpuFeatures();
+};
+
 /*
  * U64
  */
@@ -924,12 +1317,2509 @@ I64.INT64_MIN = I64(0x80000000, 0x00000000);
 I64.INT64_MAX = I64(0x7fffffff, 0xffffffff);
 
 /*
- * Helpers
+ * N128 (abstract)
  */
 
-function enforce(value, name, type) {
-  if (!value)
-    throw new TypeError(`'${name}' must be a(n) ${type}.`);
+function N128(sign) {
+  enforce(this instanceof N128, 'this', 'N128');
+  enforce(sign === 0 || sign === 1, 'sign', 'bit');
+  this.n = native128(sign);
+}
+
+/*
+ * Internal
+ */
+
+N128.prototype.__defineGetter__('sign', function() {
+  return this.n.getSign();
+});
+
+/*
+ * Addition
+ */
+
+N128.prototype.iadd = function iadd(b) {
+  this.n.iadd(b.n);
+  return this;
+};
+
+N128.prototype.iaddn = function iaddn(num) {
+  this.n.iaddn(num);
+  return this;
+};
+
+N128.prototype.add = function add(b) {
+  return this.clone().iadd(b);
+};
+
+N128.prototype.addn = function addn(num) {
+  return this.clone().iaddn(num);
+};
+
+/*
+ * Subtraction
+ */
+
+N128.prototype.isub = function isub(b) {
+  this.n.isub(b.n);
+  return this;
+};
+
+N128.prototype.isubn = function isubn(num) {
+  this.n.isubn(num);
+  return this;
+};
+
+N128.prototype.sub = function sub(b) {
+  return this.clone().isub(b);
+};
+
+N128.prototype.subn = function subn(num) {
+  return this.clone().isubn(num);
+};
+
+/*
+ * Multiplication
+ */
+
+N128.prototype.imul = function imul(b) {
+  this.n.imul(b.n);
+  return this;
+};
+
+N128.prototype.imuln = function imuln(num) {
+  this.n.imuln(num);
+  return this;
+};
+
+N128.prototype.mul = function mul(b) {
+  return this.clone().imul(b);
+};
+
+N128.prototype.muln = function muln(num) {
+  return this.clone().imuln(num);
+};
+
+/*
+ * Division
+ */
+
+N128.prototype.idiv = function idiv(b) {
+  this.n.idiv(b.n);
+  return this;
+};
+
+N128.prototype.idivn = function idivn(num) {
+  this.n.idivn(num);
+  return this;
+};
+
+N128.prototype.div = function div(b) {
+  return this.clone().idiv(b);
+};
+
+N128.prototype.divn = function divn(num) {
+  return this.clone().idivn(num);
+};
+
+N128.prototype.tryIdiv = function tryIdiv(b) {
+  return this.n.tryIdiv(b.n);
+};
+
+N128.prototype.tryDiv = function tryDiv(b) {
+  enforce(N128.isN128(b), 'divisor', 'int128');
+
+  if (b.isZero())
+    return null;
+
+  return this.clone().idiv(b);
+};
+
+/*
+ * Modulo
+ */
+
+N128.prototype.imod = function imod(b) {
+  this.n.imod(b.n);
+  return this;
+};
+
+N128.prototype.imodn = function imodn(num) {
+  this.n.imodn(num);
+  return this;
+};
+
+N128.prototype.mod = function mod(b) {
+  return this.clone().imod(b);
+};
+
+N128.prototype.modn = function modn(num) {
+  return this.clone().imodn(num);
+};
+
+N128.prototype.tryImod = function tryImod(b) {
+  return this.n.tryImod(b.n);
+};
+
+N128.prototype.tryMod = function tryMod(b) {
+  enforce(N128.isN128(b), 'divisor', 'int128');
+
+  if (b.isZero())
+    return null;
+
+  return this.clone().imod(b);
+};
+
+/*
+ * Exponentiation
+ */
+
+N128.prototype.ipow = function ipow(b) {
+  enforce(N128.isN128(b), 'exponent', 'int128');
+  return this.ipown(b.n.getWord(0));
+};
+
+N128.prototype.ipown = function ipown(num) {
+  this.n.ipown(num);
+  return this;
+};
+
+N128.prototype.pow = function pow(b) {
+  return this.clone().ipow(b);
+};
+
+N128.prototype.pown = function pown(num) {
+  return this.clone().ipown(num);
+};
+
+N128.prototype.sqr = function sqr() {
+  return this.mul(this);
+};
+
+N128.prototype.isqr = function isqr() {
+  return this.imul(this);
+};
+
+/*
+ * AND
+ */
+
+N128.prototype.iand = function iand(b) {
+  this.n.iand(b.n);
+  return this;
+};
+
+N128.prototype.iandn = function iandn(num) {
+  this.n.iandn(num);
+  return this;
+};
+
+N128.prototype.and = function and(b) {
+  return this.clone().iand(b);
+};
+
+N128.prototype.andn = function andn(num) {
+  return this.clone().iandn(num);
+};
+
+/*
+ * OR
+ */
+
+N128.prototype.ior = function ior(b) {
+  this.n.ior(b.n);
+  return this;
+};
+
+N128.prototype.iorn = function iorn(num) {
+  this.n.iorn(num);
+  return this;
+};
+
+N128.prototype.or = function or(b) {
+  return this.clone().ior(b);
+};
+
+N128.prototype.orn = function orn(num) {
+  return this.clone().iorn(num);
+};
+
+/*
+ * XOR
+ */
+
+N128.prototype.ixor = function ixor(b) {
+  this.n.ixor(b.n);
+  return this;
+};
+
+N128.prototype.ixorn = function ixorn(num) {
+  this.n.ixorn(num);
+  return this;
+};
+
+N128.prototype.xor = function xor(b) {
+  return this.clone().ixor(b);
+};
+
+N128.prototype.xorn = function xorn(num) {
+  return this.clone().ixorn(num);
+};
+
+/*
+ * NOT
+ */
+
+N128.prototype.inot = function inot() {
+  this.n.inot();
+  return this;
+};
+
+N128.prototype.not = function not() {
+  return this.clone().inot();
+};
+
+/*
+ * Left Shift
+ */
+
+N128.prototype.ishl = function ishl(b) {
+  enforce(N128.isN128(b), 'bits', 'int128');
+  return this.ishln(b.n.getWord(0));
+};
+
+N128.prototype.ishln = function ishln(bits) {
+  this.n.ishln(bits);
+  return this;
+};
+
+N128.prototype.shl = function shl(b) {
+  return this.clone().ishl(b);
+};
+
+N128.prototype.shln = function shln(bits) {
+  return this.clone().ishln(bits);
+};
+
+/*
+ * Right Shift
+ */
+
+N128.prototype.ishr = function ishr(b) {
+  enforce(N128.isN128(b), 'bits', 'int128');
+  return this.ishrn(b.n.getWord(0));
+};
+
+N128.prototype.ishrn = function ishrn(bits) {
+  this.n.ishrn(bits);
+  return this;
+};
+
+N128.prototype.shr = function shr(b) {
+  return this.clone().ishr(b);
+};
+
+N128.prototype.shrn = function shrn(bits) {
+  return this.clone().ishrn(bits);
+};
+
+/*
+ * Unsigned Right Shift
+ */
+
+N128.prototype.iushr = function iushr(b) {
+  enforce(N128.isN128(b), 'bits', 'int128');
+  return this.iushrn(b.n.getWord(0));
+};
+
+N128.prototype.iushrn = function iushrn(bits) {
+  this.n.iushrn(bits);
+  return this;
+};
+
+N128.prototype.ushr = function ushr(b) {
+  return this.clone().iushr(b);
+};
+
+N128.prototype.ushrn = function ushrn(bits) {
+  return this.clone().iushrn(bits);
+};
+
+/*
+ * Bit Manipulation
+ */
+
+N128.prototype.setn = function setn(bit, val) {
+  this.n.setn(bit, val);
+  return this;
+};
+
+N128.prototype.testn = function testn(bit) {
+  return this.n.testn(bit);
+};
+
+N128.prototype.setb = function setb(pos, ch) {
+  this.n.setb(pos, ch);
+  return this;
+};
+
+N128.prototype.orb = function orb(pos, ch) {
+  this.n.orb(pos, ch);
+  return this;
+};
+
+N128.prototype.getb = function getb(pos) {
+  return this.n.getb(pos);
+};
+
+N128.prototype.imaskn = function imaskn(bit) {
+  this.n.imaskn(bit);
+  return this;
+};
+
+N128.prototype.maskn = function maskn(bit) {
+  return this.clone().imaskn(bit);
+};
+
+N128.prototype.andln = function andln(num) {
+  return this.n.andln(num);
+};
+
+/*
+ * Negation
+ */
+
+N128.prototype.ineg = function ineg() {
+  this.n.ineg();
+  return this;
+};
+
+N128.prototype.neg = function neg() {
+  return this.clone().ineg();
+};
+
+N128.prototype.iabs = function iabs() {
+  if (this.isNeg())
+    this.ineg();
+  return this;
+};
+
+N128.prototype.abs = function abs() {
+  return this.clone().iabs();
+};
+
+/*
+ * Comparison
+ */
+
+N128.prototype.cmp = function cmp(b) {
+  return this.n.cmp(b.n);
+};
+
+N128.prototype.cmpn = function cmpn(num) {
+  return this.n.cmpn(num);
+};
+
+N128.prototype.eq = function eq(b) {
+  return this.n.eq(b.n);
+};
+
+N128.prototype.eqn = function eqn(num) {
+  return this.n.eqn(num);
+};
+
+N128.prototype.gt = function gt(b) {
+  return this.cmp(b) > 0;
+};
+
+N128.prototype.gtn = function gtn(num) {
+  return this.cmpn(num) > 0;
+};
+
+N128.prototype.gte = function gte(b) {
+  return this.cmp(b) >= 0;
+};
+
+N128.prototype.gten = function gten(num) {
+  return this.cmpn(num) >= 0;
+};
+
+N128.prototype.lt = function lt(b) {
+  return this.cmp(b) < 0;
+};
+
+N128.prototype.ltn = function ltn(num) {
+  return this.cmpn(num) < 0;
+};
+
+N128.prototype.lte = function lte(b) {
+  return this.cmp(b) <= 0;
+};
+
+N128.prototype.lten = function lten(num) {
+  return this.cmpn(num) <= 0;
+};
+
+N128.prototype.isZero = function isZero() {
+  return this.n.isZero();
+};
+
+N128.prototype.isNeg = function isNeg() {
+  return this.n.isNeg();
+};
+
+N128.prototype.isOdd = function isOdd() {
+  return this.n.isOdd();
+};
+
+N128.prototype.isEven = function isEven() {
+  return this.n.isEven();
+};
+
+/*
+ * Helpers
+ */
+
+N128.prototype.clone = function clone() {
+  const n = new this.constructor();
+  n.n.inject(this.n);
+  return n;
+};
+
+N128.prototype.inject = function inject(b) {
+  this.n.inject(b.n);
+  return this;
+};
+
+N128.prototype.set = function set(num) {
+  this.n.set(num);
+  return this;
+};
+
+N128.prototype.join = function join(w3, w2, w1, w0) {
+  this.n.join(w3, w2, w1, w0);
+  return this;
+};
+
+N128.prototype.bitLength = function bitLength() {
+  return this.n.bitLength();
+};
+
+N128.prototype.byteLength = function byteLength() {
+  return Math.ceil(this.bitLength() / 8);
+};
+
+N128.prototype.isSafe = function isSafe() {
+  return this.n.isSafe();
+};
+
+N128.prototype.inspect = function inspect() {
+  let prefix = 'I128';
+
+  if (!this.sign)
+    prefix = 'U128';
+
+  return `<${prefix}: ${this.toString(10)}>`;
+};
+
+/*
+ * Encoding
+ */
+
+N128.prototype.readLE = function readLE(data, off) {
+  enforce(data && typeof data.length === 'number', 'data', 'arraylike');
+  enforce((off >> 0) === off, 'offset', 'integer');
+  enforce(off + 16 <= data.length, 'offset', 'valid offset');
+  this.n.join(readI32LE(data, off + 12),
+              readI32LE(data, off + 8),
+              readI32LE(data, off + 4),
+              readI32LE(data, off));
+  return off + 16;
+};
+
+N128.prototype.readBE = function readBE(data, off) {
+  enforce(data && typeof data.length === 'number', 'data', 'arraylike');
+  enforce((off >> 0) === off, 'offset', 'integer');
+  enforce(off + 16 <= data.length, 'offset', 'valid offset');
+  this.n.join(readI32BE(data, off),
+              readI32BE(data, off + 4),
+              readI32BE(data, off + 8),
+              readI32BE(data, off + 12));
+  return off + 16;
+};
+
+N128.prototype.readRaw = function readRaw(data, off) {
+  return this.readLE(data, off);
+};
+
+N128.prototype.writeLE = function writeLE(data, off) {
+  enforce(data && typeof data.length === 'number', 'data', 'arraylike');
+  enforce((off >> 0) === off, 'offset', 'integer');
+  enforce(off + 16 <= data.length, 'offset', 'valid offset');
+  for (let i = 0; i < 4; i++)
+    writeI32LE(data, this.n.getWord(i), off + i * 4);
+  return off + 16;
+};
+
+N128.prototype.writeBE = function writeBE(data, off) {
+  enforce(data && typeof data.length === 'number', 'data', 'arraylike');
+  enforce((off >> 0) === off, 'offset', 'integer');
+  enforce(off + 16 <= data.length, 'offset', 'valid offset');
+  for (let i = 0; i < 4; i++)
+    writeI32BE(data, this.n.getWord(3 - i), off + i * 4);
+  return off + 16;
+};
+
+N128.prototype.writeRaw = function writeRaw(data, off) {
+  return this.writeLE(data, off);
+};
+
+/*
+ * Conversion
+ */
+
+N128.prototype.toU128 = function toU128() {
+  const n = new U128();
+  n.n.inject(this.n);
+  return n;
+};
+
+N128.prototype.toI128 = function toI128() {
+  const n = new I128();
+  n.n.inject(this.n);
+  return n;
+};
+
+N128.prototype.toU64 = function toU64() {
+  const n = this.tryToU64();
+
+  if (!n)
+    throw new Error('Number out of range.');
+
+  return n;
+};
+
+N128.prototype.toI64 = function toI64() {
+  const n = this.tryToI64();
+
+  if (!n)
+    throw new Error('Number out of range.');
+
+  return n;
+};
+
+N128.prototype.tryToU64 = function tryToU64() {
+  const n = new U64();
+  return this.n.toN64(n.n) ? n : null;
+};
+
+N128.prototype.tryToI64 = function tryToI64() {
+  const n = new I64();
+  return this.n.toN64(n.n) ? n : null;
+};
+
+N128.prototype.toNumber = function toNumber() {
+  return this.n.toNumber();
+};
+
+N128.prototype.tryToNumber = function tryToNumber() {
+  return this.n.tryToNumber();
+};
+
+N128.prototype.toDouble = function toDouble() {
+  return this.n.toDouble();
+};
+
+N128.prototype.toInt = function toInt() {
+  return this.n.toInt();
+};
+
+N128.prototype.toBool = function toBool() {
+  return this.n.toBool();
+};
+
+N128.prototype.toBits = function toBits() {
+  return [
+    this.n.getWord(3),
+    this.n.getWord(2),
+    this.n.getWord(1),
+    this.n.getWord(0)
+  ];
+};
+
+N128.prototype.toObject = function toObject() {
+  const hi = this.sign ? new I64() : new U64();
+  const lo = new U64();
+
+  hi.n.join(this.n.getWord(3), this.n.getWord(2));
+  lo.n.join(this.n.getWord(1), this.n.getWord(0));
+
+  return { hi, lo };
+};
+
+N128.prototype.toString = function toString(base, pad) {
+  return this.n.toString(base, pad);
+};
+
+N128.prototype.toJSON = function toJSON() {
+  return this.toString(16, 32);
+};
+
+N128.prototype.toBN = function toBN(BN) {
+  const neg = this.isNeg();
+  const n = neg ? this.neg() : this;
+  const num = new BN(0);
+
+  for (let i = 3; i >= 0; i--) {
+    num.ishln(32);
+    num.iadd(new BN(n.n.getWord(i) >>> 0));
+  }
+
+  if (neg)
+    num.ineg();
+
+  return num;
+};
+
+N128.prototype.toLE = function toLE(ArrayLike) {
+  enforce(typeof ArrayLike === 'function', 'ArrayLike', 'constructor');
+  const data = alloc(ArrayLike, 16);
+  this.writeLE(data, 0);
+  return data;
+};
+
+N128.prototype.toBE = function toBE(ArrayLike) {
+  enforce(typeof ArrayLike === 'function', 'ArrayLike', 'constructor');
+  const data = alloc(ArrayLike, 16);
+  this.writeBE(data, 0);
+  return data;
+};
+
+N128.prototype.toRaw = function toRaw(ArrayLike) {
+  return this.toLE(ArrayLike);
+};
+
+/*
+ * Instantiation
+ */
+
+N128.prototype.fromNumber = function fromNumber(num) {
+  this.n.fromNumber(num);
+  return this;
+};
+
+N128.prototype.tryFromNumber = function tryFromNumber(num) {
+  return this.n.tryFromNumber(num);
+};
+
+N128.prototype.fromInt = function fromInt(num) {
+  this.n.fromInt(num);
+  return this;
+};
+
+N128.prototype.fromBool = function fromBool(value) {
+  this.n.fromBool(value);
+  return this;
+};
+
+N128.prototype.fromBits = function fromBits(w3, w2, w1, w0) {
+  this.n.join(w3, w2, w1, w0);
+  return this;
+};
+
+N128.prototype.fromN64 = function fromN64(num) {
+  enforce(N64.isN64(num), 'number', 'int64');
+
+  if (!this.sign && num.isNeg())
+    throw new Error('Number out of range.');
+
+  this.n.fromN64(num.n);
+
+  return this;
+};
+
+N128.prototype.fromObject = function fromObject(num) {
+  enforce(num && typeof num === 'object', 'number', 'object');
+  enforce(N64.isN64(num.hi), 'hi', 'int64');
+  enforce(N64.isN64(num.lo), 'lo', 'int64');
+  return this.fromBits(num.hi.n.getHi(), num.hi.n.getLo(),
+                       num.lo.n.getHi(), num.lo.n.getLo());
+};
+
+N128.prototype.fromString = function fromString(str, base) {
+  this.n.fromString(str, base);
+  return this;
+};
+
+N128.prototype.tryFromString = function tryFromString(str, base) {
+  return this.n.tryFromString(str, base);
+};
+
+N128.prototype.fromJSON = function fromJSON(json) {
+  return this.fromString(json, 16);
+};
+
+N128.prototype.fromBN = function fromBN(num) {
+  enforce(num && Array.isArray(num.words), 'number', 'big number');
+
+  const a = this;
+  const b = num.clone();
+  const neg = b.isNeg();
+
+  if (a.sign && b.testn(127))
+    throw new Error('Big number overflow.');
+
+  a.n.join(0, 0, 0, 0);
+
+  let i = 0;
+
+  while (!b.isZero()) {
+    if (i === 16)
+      throw new Error('Big number overflow.');
+
+    a.orb(i, b.andln(0xff));
+    b.iushrn(8);
+    i++;
+  }
+
+  if (neg)
+    a.ineg();
+
+  return a;
+};
+
+N128.prototype.fromLE = function fromLE(data) {
+  this.readLE(data, 0);
+  return this;
+};
+
+N128.prototype.fromBE = function fromBE(data) {
+  this.readBE(data, 0);
+  return this;
+};
+
+N128.prototype.fromRaw = function fromRaw(data) {
+  return this.fromLE(data);
+};
+
+N128.prototype.from = function from(num, base) {
+  if (num == null)
+    return this;
+
+  if (typeof num === 'number')
+    return this.fromNumber(num);
+
+  if (typeof num === 'string')
+    return this.fromString(num, base);
+
+  if (typeof num === 'object') {
+    if (N64.isN64(num))
+      return this.fromN64(num);
+
+    if (N128.isN128(num))
+      return this.inject(num);
+
+    if (Array.isArray(num.words))
+      return this.fromBN(num);
+
+    if (typeof num.length === 'number')
+      return this.fromRaw(num);
+
+    return this.fromObject(num);
+  }
+
+  if (typeof num === 'boolean')
+    return this.fromBool(num);
+
+  throw new TypeError('Non-numeric object passed to N128.');
+};
+
+/*
+ * Static Methods
+ */
+
+N128.min = function min(a, b) {
+  return a.cmp(b) < 0 ? a : b;
+};
+
+N128.max = function max(a, b) {
+  return a.cmp(b) > 0 ? a : b;
+};
+
+N128.random = function random() {
+  const n = new this();
+  n.n.join((Math.random() * 0x100000000) | 0,
+           (Math.random() * 0x100000000) | 0,
+           (Math.random() * 0x100000000) | 0,
+           (Math.random() * 0x100000000) | 0);
+  return n;
+};
+
+N128.pow = function pow(num, exp) {
+  return new this().fromInt(num).ipown(exp);
+};
+
+N128.shift = function shift(num, bits) {
+  return new this().fromInt(num).ishln(bits);
+};
+
+N128.readLE = function readLE(data, off) {
+  const n = new this();
+  n.readLE(data, off);
+  return n;
+};
+
+N128.readBE = function readBE(data, off) {
+  const n = new this();
+  n.readBE(data, off);
+  return n;
+};
+
+N128.readRaw = function readRaw(data, off) {
+  const n = new this();
+  n.readRaw(data, off);
+  return n;
+};
+
+N128.fromNumber = function fromNumber(num) {
+  return new this().fromNumber(num);
+};
+
+N128.tryFromNumber = function tryFromNumber(num) {
+  const n = new this();
+  return n.tryFromNumber(num) ? n : null;
+};
+
+N128.fromInt = function fromInt(num) {
+  return new this().fromInt(num);
+};
+
+N128.fromBool = function fromBool(value) {
+  return new this().fromBool(value);
+};
+
+N128.fromBits = function fromBits(w3, w2, w1, w0) {
+  return new this().fromBits(w3, w2, w1, w0);
+};
+
+N128.fromN64 = function fromN64(num) {
+  return new this().fromN64(num);
+};
+
+N128.fromObject = function fromObject(obj) {
+  return new this().fromObject(obj);
+};
+
+N128.fromString = function fromString(str, base) {
+  return new this().fromString(str, base);
+};
+
+N128.tryFromString = function tryFromString(str, base) {
+  const n = new this();
+  return n.tryFromString(str, base) ? n : null;
+};
+
+N128.fromJSON = function fromJSON(json) {
+  return new this().fromJSON(json);
+};
+
+N128.fromBN = function fromBN(num) {
+  return new this().fromBN(num);
+};
+
+N128.fromLE = function fromLE(data) {
+  return new this().fromLE(data);
+};
+
+N128.fromBE = function fromBE(data) {
+  return new this().fromBE(data);
+};
+
+N128.fromRaw = function fromRaw(data) {
+  return new this().fromRaw(data);
+};
+
+N128.from = function from(num, base) {
+  return new this().from(num, base);
+};
+
+N128.isN128 = function isN128(obj) {
+  return obj instanceof N128;
+};
+
+N128.isU128 = function isU128(obj) {
+  return obj instanceof U128;
+};
+
+N128.isI128 = function isI128(obj) {
+  return obj instanceof I128;
+};
+
+/*
+ * U128
+ */
+
+function U128(num, base) {
+  if (!(this instanceof U128))
+    return new U128(num, base);
+
+  N128.call(this, 0);
+
+  this.from(num, base);
+}
+
+Object.setPrototypeOf(U128, N128);
+Object.setPrototypeOf(U128.prototype, N128.prototype);
+
+/*
+ * Constants
+ */
+
+U128.UINT128_MIN = U128.fromBits(0, 0, 0, 0);
+U128.UINT128_MAX = U128.fromBits(-1, -1, -1, -1);
+
+/*
+ * I128
+ */
+
+function I128(num, base) {
+  if (!(this instanceof I128))
+    return new I128(num, base);
+
+  N128.call(this, 1);
+
+  this.from(num, base);
+}
+
+Object.setPrototypeOf(I128, N128);
+Object.setPrototypeOf(I128.prototype, N128.prototype);
+
+/*
+ * Constants
+ */
+
+I128.INT128_MIN = I128.fromBits(0x80000000, 0, 0, 0);
+I128.INT128_MAX = I128.fromBits(0x7fffffff, -1, -1, -1);
+
+/*
+ * Widening
+ */
+
+N64.prototype.toU128 = function toU128() {
+  return U128.fromN64(this);
+};
+
+N64.prototype.toI128 = function toI128() {
+  return I128.fromN64(this);
+};
+
+/*
+ * RNG
+ */
+
+function RNG(ctor, seed) {
+  if (!(this instanceof RNG))
+    return new RNG(ctor, seed);
+
+  if (ctor == null)
+    ctor = U64;
+
+  enforce(typeof ctor === 'function', 'ctor', 'constructor');
+
+  this.ctor = ctor;
+  this.r = new binding.RNG();
+
+  this.seed(seed);
+}
+
+RNG.prototype.seed = function seed(value) {
+  this.r.seed(toSeed(value).n);
+  return this;
+};
+
+RNG.prototype.next = function next(out) {
+  if (out == null)
+    out = new this.ctor();
+
+  enforce(N64.isN64(out), 'out', 'int64');
+
+  this.r.next(out.n);
+
+  return out;
+};
+
+RNG.prototype.nextBelow = function nextBelow(bound, out) {
+  if (typeof bound === 'number')
+    bound = I64.fromNumber(bound);
+
+  enforce(N64.isN64(bound), 'bound', 'int64');
+
+  if (out == null)
+    out = new this.ctor();
+
+  enforce(N64.isN64(out), 'out', 'int64');
+
+  this.r.nextBelow(out.n, bound.n);
+
+  return out;
+};
+
+RNG.prototype.jump = function jump() {
+  this.r.jump();
+  return this;
+};
+
+RNG.prototype.fill = function fill(data) {
+  this.r.fill(data instanceof N64Array ? data.a : data);
+  return data;
+};
+
+RNG.prototype.clone = function clone() {
+  const r = new RNG(this.ctor, 0);
+  r.r.inject(this.r);
+  return r;
+};
+
+/*
+ * Histogram
+ */
+
+function Histogram(ctor, options) {
+  if (!(this instanceof Histogram))
+    return new Histogram(ctor, options);
+
+  if (ctor == null)
+    ctor = U64;
+
+  enforce(typeof ctor === 'function', 'ctor', 'constructor');
+
+  const [lowest, highest, digits] = toLayout(options);
+
+  this.ctor = ctor;
+  this.sign = ctor === I64 ? 1 : 0;
+  this.h = new binding.Histogram(lowest, highest, digits, this.sign);
+}
+
+Histogram.prototype.record = function record(value, count) {
+  if (count == null)
+    count = 1;
+
+  if (!this.h.record(toOperand(value), toOperand(count)))
+    throw new Error('Value out of range.');
+
+  return this;
+};
+
+Histogram.prototype.recordMany = function recordMany(data) {
+  return this.h.recordMany(toShared(data));
+};
+
+Histogram.prototype.percentile = function percentile(p, out) {
+  enforce(typeof p === 'number' && p >= 0 && p <= 100, 'p', 'percentage');
+
+  if (out == null)
+    out = new this.ctor();
+
+  enforce(N64.isN64(out), 'out', 'int64');
+
+  this.h.percentile(p, out.n);
+
+  return out;
+};
+
+Histogram.prototype.mean = function mean() {
+  return this.h.mean();
+};
+
+Histogram.prototype.count = function count(out) {
+  if (out == null)
+    out = new U64();
+
+  enforce(N64.isN64(out), 'out', 'int64');
+
+  this.h.count(out.n);
+
+  return out;
+};
+
+Histogram.prototype.min = function min(out) {
+  if (out == null)
+    out = new this.ctor();
+
+  enforce(N64.isN64(out), 'out', 'int64');
+
+  this.h.min(out.n);
+
+  return out;
+};
+
+Histogram.prototype.max = function max(out) {
+  if (out == null)
+    out = new this.ctor();
+
+  enforce(N64.isN64(out), 'out', 'int64');
+
+  this.h.max(out.n);
+
+  return out;
+};
+
+Histogram.prototype.merge = function merge(other) {
+  enforce(other instanceof Histogram, 'other', 'histogram');
+
+  if (!this.h.merge(other.h))
+    throw new Error('Value out of range.');
+
+  return this;
+};
+
+Histogram.prototype.reset = function reset() {
+  this.h.reset();
+  return this;
+};
+
+Histogram.prototype.clone = function clone() {
+  const h = Object.create(Histogram.prototype);
+
+  h.ctor = this.ctor;
+  h.sign = this.sign;
+  h.h = new binding.Histogram();
+  h.h.inject(this.h);
+
+  return h;
+};
+
+Histogram.decode = function decode(ctor, data) {
+  const h = Object.create(Histogram.prototype);
+
+  h.ctor = ctor;
+  h.sign = ctor === I64 ? 1 : 0;
+  h.h = new binding.Histogram();
+  h.h.decode(data, h.sign);
+
+  return h;
+};
+
+/*
+ * Struct
+ */
+
+function Struct(fields) {
+  if (!(this instanceof Struct))
+    return new Struct(fields);
+
+  const [items, size] = toFields(fields);
+  const layout = new Uint32Array(items.length * 4);
+  const small = items.filter(field => field.width !== 8);
+
+  for (let i = 0; i < items.length; i++) {
+    const field = items[i];
+
+    layout[i * 4 + 0] = field.offset;
+    layout[i * 4 + 1] = field.width;
+    layout[i * 4 + 2] = field.sign;
+    layout[i * 4 + 3] = field.be;
+  }
+
+  this.size = size;
+  this.fields = items;
+  this.values = new Float64Array(Math.max(1, small.length));
+  this.s = new binding.Struct(layout, size, this.values);
+  this._decode = compileDecode(items);
+  this._encode = compileEncode(items);
+}
+
+Struct.prototype.create = function create() {
+  const out = {};
+
+  for (const field of this.fields) {
+    if (field.width === 8)
+      out[field.name] = field.sign ? new I64() : new U64();
+    else
+      out[field.name] = 0;
+  }
+
+  return out;
+};
+
+Struct.prototype.decode = function decode(data, off, out) {
+  if (off == null)
+    off = 0;
+
+  if (out == null)
+    out = this.create();
+
+  enforce(out && typeof out === 'object', 'out', 'object');
+
+  return this._decode(toShared(data), off, out);
+};
+
+Struct.prototype.decodeMany = function decodeMany(data, off, count) {
+  const bytes = toBytes(data);
+
+  if (off == null)
+    off = 0;
+
+  enforce((off >>> 0) === off, 'offset', 'integer');
+
+  if (count == null)
+    count = Math.floor(Math.max(0, bytes.byteLength - off) / this.size);
+
+  enforce((count >>> 0) === count, 'count', 'integer');
+
+  const columns = {};
+  const targets = [];
+
+  for (const field of this.fields) {
+    const column = toColumn(field, count);
+
+    columns[field.name] = column;
+    targets.push(toShared(column));
+  }
+
+  this.s.decodeMany(bytes, off, count, targets);
+
+  return columns;
+};
+
+Struct.prototype.encode = function encode(value, data, off) {
+  if (off == null)
+    off = 0;
+
+  if (data == null)
+    data = new Uint8Array(off + this.size);
+
+  enforce(value && typeof value === 'object', 'value', 'object');
+
+  this._encode(value, toShared(data), off);
+
+  return data;
+};
+
+Struct.prototype.encodeMany = function encodeMany(columns, data, off) {
+  enforce(columns && typeof columns === 'object', 'columns', 'object');
+
+  if (off == null)
+    off = 0;
+
+  enforce((off >>> 0) === off, 'offset', 'integer');
+
+  const targets = [];
+
+  let count = -1;
+
+  for (const field of this.fields) {
+    const column = columns[field.name];
+
+    enforce(isColumn(column, field), field.name, 'column');
+
+    if (count === -1)
+      count = column.length;
+
+    if (column.length !== count)
+      throw new Error('Invalid columns.');
+
+    targets.push(toShared(column));
+  }
+
+  if (data == null)
+    data = new Uint8Array(off + count * this.size);
+
+  this.s.encodeMany(targets, toShared(data), off, count);
+
+  return data;
+};
+
+/*
+ * Dec64
+ */
+
+function Dec64(scale) {
+  if (!(this instanceof Dec64))
+    return new Dec64(scale);
+
+  if (scale == null)
+    scale = 0;
+
+  this.d = new binding.Dec64(scale);
+}
+
+/*
+ * Rounding Modes
+ */
+
+Dec64.ROUND_DOWN = 0;
+Dec64.ROUND_UP = 1;
+Dec64.ROUND_FLOOR = 2;
+Dec64.ROUND_CEIL = 3;
+Dec64.ROUND_HALF_UP = 4;
+Dec64.ROUND_HALF_DOWN = 5;
+Dec64.ROUND_HALF_EVEN = 6;
+
+/*
+ * Internal
+ */
+
+Dec64.prototype.__defineGetter__('scale', function() {
+  return this.d.getScale();
+});
+
+/*
+ * Arithmetic
+ */
+
+Dec64.prototype.iadd = function iadd(b) {
+  enforce(Dec64.isDec64(b), 'operand', 'decimal');
+  this.d.iadd(b.d);
+  return this;
+};
+
+Dec64.prototype.add = function add(b) {
+  return this.clone().iadd(b);
+};
+
+Dec64.prototype.isub = function isub(b) {
+  enforce(Dec64.isDec64(b), 'operand', 'decimal');
+  this.d.isub(b.d);
+  return this;
+};
+
+Dec64.prototype.sub = function sub(b) {
+  return this.clone().isub(b);
+};
+
+Dec64.prototype.imul = function imul(b, mode) {
+  enforce(Dec64.isDec64(b), 'multiplicand', 'decimal');
+  this.d.imul(b.d, mode);
+  return this;
+};
+
+Dec64.prototype.mul = function mul(b, mode) {
+  return this.clone().imul(b, mode);
+};
+
+Dec64.prototype.idiv = function idiv(b, mode) {
+  enforce(Dec64.isDec64(b), 'divisor', 'decimal');
+  this.d.idiv(b.d, mode);
+  return this;
+};
+
+Dec64.prototype.div = function div(b, mode) {
+  return this.clone().idiv(b, mode);
+};
+
+Dec64.prototype.irescale = function irescale(scale, mode) {
+  this.d.rescale(scale, mode);
+  return this;
+};
+
+Dec64.prototype.rescale = function rescale(scale, mode) {
+  return this.clone().irescale(scale, mode);
+};
+
+Dec64.prototype.ineg = function ineg() {
+  this.d.ineg();
+  return this;
+};
+
+Dec64.prototype.neg = function neg() {
+  return this.clone().ineg();
+};
+
+Dec64.prototype.iabs = function iabs() {
+  if (this.d.isNeg())
+    this.d.ineg();
+  return this;
+};
+
+Dec64.prototype.abs = function abs() {
+  return this.clone().iabs();
+};
+
+/*
+ * Comparison
+ */
+
+Dec64.prototype.cmp = function cmp(b) {
+  enforce(Dec64.isDec64(b), 'value', 'decimal');
+  return this.d.cmp(b.d);
+};
+
+Dec64.prototype.eq = function eq(b) {
+  return this.cmp(b) === 0;
+};
+
+Dec64.prototype.lt = function lt(b) {
+  return this.cmp(b) < 0;
+};
+
+Dec64.prototype.lte = function lte(b) {
+  return this.cmp(b) <= 0;
+};
+
+Dec64.prototype.gt = function gt(b) {
+  return this.cmp(b) > 0;
+};
+
+Dec64.prototype.gte = function gte(b) {
+  return this.cmp(b) >= 0;
+};
+
+Dec64.prototype.isZero = function isZero() {
+  return this.d.isZero();
+};
+
+Dec64.prototype.isNeg = function isNeg() {
+  return this.d.isNeg();
+};
+
+/*
+ * Helpers
+ */
+
+Dec64.prototype.clone = function clone() {
+  return new Dec64().inject(this);
+};
+
+Dec64.prototype.inject = function inject(b) {
+  enforce(Dec64.isDec64(b), 'value', 'decimal');
+  this.d.inject(b.d);
+  return this;
+};
+
+Dec64.prototype.inspect = function inspect() {
+  return `<Dec64: ${this.toString()}>`;
+};
+
+/*
+ * Encoding
+ */
+
+Dec64.prototype.toI64 = function toI64() {
+  const n = new I64();
+  this.d.getRaw(n.n);
+  return n;
+};
+
+Dec64.prototype.toDouble = function toDouble() {
+  return this.d.toDouble();
+};
+
+Dec64.prototype.toString = function toString() {
+  return this.d.toString();
+};
+
+Dec64.prototype.toJSON = function toJSON() {
+  return this.toString();
+};
+
+/*
+ * Decoding
+ */
+
+Dec64.prototype.fromI64 = function fromI64(num, scale) {
+  if (scale == null)
+    scale = 0;
+
+  if (typeof num === 'number')
+    num = I64.fromNumber(num);
+
+  enforce(N64.isN64(num), 'number', 'int64');
+
+  this.d.setRaw(num.n, scale);
+
+  return this;
+};
+
+Dec64.prototype.fromString = function fromString(str, scale, mode) {
+  this.d.fromString(str, scale, mode);
+  return this;
+};
+
+Dec64.prototype.fromJSON = function fromJSON(json) {
+  return this.fromString(json);
+};
+
+/*
+ * Static Methods
+ */
+
+Dec64.fromI64 = function fromI64(num, scale) {
+  return new this().fromI64(num, scale);
+};
+
+Dec64.fromString = function fromString(str, scale, mode) {
+  return new this().fromString(str, scale, mode);
+};
+
+Dec64.fromJSON = function fromJSON(json) {
+  return new this().fromJSON(json);
+};
+
+Dec64.isDec64 = function isDec64(obj) {
+  return obj instanceof Dec64;
+};
+
+/*
+ * N64Array (abstract)
+ */
+
+function N64Array(sign, length) {
+  enforce(this instanceof N64Array, 'this', 'N64Array');
+  enforce(sign === 0 || sign === 1, 'sign', 'bit');
+
+  if (length == null)
+    length = 0;
+
+  this.sign = sign;
+  this.ctor = sign ? I64 : U64;
+  this.length = length;
+  this.a = new binding.N64Array(length, sign);
+}
+
+/*
+ * Elements
+ */
+
+N64Array.prototype.push = function push(num) {
+  enforce(N64.isN64(num), 'value', 'int64');
+  this.length = this.a.push(num.n);
+  return this.length;
+};
+
+N64Array.prototype.pushn = function pushn(num) {
+  this.length = this.a.pushn(num);
+  return this.length;
+};
+
+N64Array.prototype.get = function get(index, out) {
+  if (out == null)
+    out = new this.ctor();
+
+  enforce(N64.isN64(out), 'out', 'int64');
+
+  this.a.get(index, out.n);
+
+  return out;
+};
+
+N64Array.prototype.set = function set(index, num) {
+  enforce(N64.isN64(num), 'value', 'int64');
+  this.a.set(index, num.n);
+  return this;
+};
+
+N64Array.prototype.setn = function setn(index, num) {
+  this.a.setn(index, num);
+  return this;
+};
+
+/*
+ * Slicing
+ */
+
+N64Array.prototype.subarray = function subarray(start, end) {
+  start = toIndex(start, this.length, 0, 'start');
+  end = toIndex(end, this.length, this.length, 'end');
+
+  if (end < start)
+    end = start;
+
+  const arr = Object.create(Object.getPrototypeOf(this));
+
+  arr.sign = this.sign;
+  arr.ctor = this.ctor;
+  arr.length = end - start;
+  arr.a = this.a.subarray(start, end);
+
+  return arr;
+};
+
+N64Array.prototype.slice = function slice(start, end) {
+  return this.subarray(start, end);
+};
+
+/*
+ * Iteration
+ */
+
+N64Array.prototype.values = function* values() {
+  for (let i = 0; i < this.length; i++)
+    yield this.get(i);
+};
+
+N64Array.prototype[Symbol.iterator] = N64Array.prototype.values;
+
+/*
+ * Encoding
+ */
+
+N64Array.prototype.toBuffer = function toBuffer() {
+  return this.a.toBuffer();
+};
+
+N64Array.prototype.toArray = function toArray() {
+  return Array.from(this);
+};
+
+N64Array.prototype.transfer = function transfer() {
+  const buffer = this.a.transfer();
+  this.length = 0;
+  return buffer;
+};
+
+/*
+ * Static Methods
+ */
+
+N64Array.from = function from(items) {
+  enforce(items != null && typeof items[Symbol.iterator] === 'function',
+          'items', 'iterable');
+
+  const arr = new this();
+
+  for (const item of items)
+    arr.push(N64.isN64(item) ? item : arr.ctor.from(item));
+
+  return arr;
+};
+
+N64Array.fromBuffer = function fromBuffer(data) {
+  const arr = new this();
+  arr.length = arr.a.attach(data);
+  return arr;
+};
+
+N64Array.parse = function parse(items, base) {
+  enforce(Array.isArray(items), 'items', 'array');
+
+  const array = new this();
+  const valid = new Uint8Array((items.length + 7) >>> 3);
+
+  let invalid = -1;
+
+  // Strings are handed over joined, as one call.
+  if (isStrings(items))
+    invalid = array.a.parse(items.join('\n'), base, valid, items.length);
+
+  if (invalid < 0)
+    invalid = array.a.parse(items, base, valid);
+
+  array.length = items.length;
+
+  return { array, valid, invalid };
+};
+
+N64Array.isN64Array = function isN64Array(obj) {
+  return obj instanceof N64Array;
+};
+
+/*
+ * U64Array
+ */
+
+function U64Array(length) {
+  if (!(this instanceof U64Array))
+    return new U64Array(length);
+
+  N64Array.call(this, 0, length);
+}
+
+Object.setPrototypeOf(U64Array, N64Array);
+Object.setPrototypeOf(U64Array.prototype, N64Array.prototype);
+
+/*
+ * I64Array
+ */
+
+function I64Array(length) {
+  if (!(this instanceof I64Array))
+    return new I64Array(length);
+
+  N64Array.call(this, 1, length);
+}
+
+Object.setPrototypeOf(I64Array, N64Array);
+Object.setPrototypeOf(I64Array.prototype, N64Array.prototype);
+
+/*
+ * Columns
+ */
+
+N64Array.parseColumn = function parseColumn(data, options) {
+  enforce(data instanceof Uint8Array, 'data', 'buffer');
+
+  const opts = columnOptions(options);
+  const array = new this();
+
+  if (opts.header)
+    data = skipRecord(data);
+
+  const {length, valid, invalid} = array.a.parseColumn(data,
+                                                      opts.delimiter,
+                                                      opts.column,
+                                                      opts.base,
+                                                      opts.threads);
+
+  array.length = length;
+
+  return { array, valid, invalid };
+};
+
+U64.parseColumn = function parseColumn(data, options) {
+  return U64Array.parseColumn(data, options);
+};
+
+I64.parseColumn = function parseColumn(data, options) {
+  return I64Array.parseColumn(data, options);
+};
+
+/*
+ * Bulk
+ */
+
+N64.bswap64 = function bswap64(dst, src) {
+  if (src == null)
+    src = dst;
+
+  binding.bulk.bswap64(toShared(dst), toShared(src));
+
+  return dst;
+};
+
+N64.split = function split(hi, lo, src) {
+  return binding.bulk.split(hi, lo, toShared(src));
+};
+
+N64.join = function join(dst, hi, lo) {
+  binding.bulk.join(toShared(dst), hi, lo);
+  return dst;
+};
+
+U64.toFloat64 = function toFloat64(dst, src, mode) {
+  return binding.bulk.toFloat64(dst, toShared(src), 0, mode);
+};
+
+I64.toFloat64 = function toFloat64(dst, src, mode) {
+  return binding.bulk.toFloat64(dst, toShared(src), 1, mode);
+};
+
+U64.fromFloat64 = function fromFloat64(dst, src, mode) {
+  return binding.bulk.fromFloat64(toShared(dst), src, 0, mode);
+};
+
+I64.fromFloat64 = function fromFloat64(dst, src, mode) {
+  return binding.bulk.fromFloat64(toShared(dst), src, 1, mode);
+};
+
+/*
+ * Linear Algebra
+ */
+
+U64.dot = function dot(a, b) {
+  return checkDot(U64.tryDot(a, b));
+};
+
+I64.dot = function dot(a, b) {
+  return checkDot(I64.tryDot(a, b));
+};
+
+U64.tryDot = function tryDot(a, b) {
+  const r = new U128();
+
+  if (!binding.bulk.dot(toShared(a), toShared(b), 0, r.n))
+    return null;
+
+  return r;
+};
+
+I64.tryDot = function tryDot(a, b) {
+  const r = new I128();
+
+  if (!binding.bulk.dot(toShared(a), toShared(b), 1, r.n))
+    return null;
+
+  return r;
+};
+
+U64.axpy = function axpy(dst, alpha, x) {
+  return binding.bulk.axpy(toShared(dst), toOperand(alpha), toShared(x), 0);
+};
+
+I64.axpy = function axpy(dst, alpha, x) {
+  return binding.bulk.axpy(toShared(dst), toOperand(alpha), toShared(x), 1);
+};
+
+U64.matvec = function matvec(dst, m, x) {
+  return binding.bulk.matvec(toShared(dst), toShared(m), toShared(x), 0);
+};
+
+I64.matvec = function matvec(dst, m, x) {
+  return binding.bulk.matvec(toShared(dst), toShared(m), toShared(x), 1);
+};
+
+function checkDot(r) {
+  if (!r)
+    throw new Error('Dot product overflow.');
+
+  return r;
+}
+
+/*
+ * Filtering
+ */
+
+U64.where = function where(out, src, op, a, b) {
+  return binding.bulk.where(out, toShared(src), toPredicate(op),
+                            toBound(op, a), toUpper(op, b), 0);
+};
+
+I64.where = function where(out, src, op, a, b) {
+  return binding.bulk.where(out, toShared(src), toPredicate(op),
+                            toBound(op, a), toUpper(op, b), 1);
+};
+
+U64.countWhere = function countWhere(src, op, a, b) {
+  return binding.bulk.countWhere(toShared(src), toPredicate(op),
+                                 toBound(op, a), toUpper(op, b), 0);
+};
+
+I64.countWhere = function countWhere(src, op, a, b) {
+  return binding.bulk.countWhere(toShared(src), toPredicate(op),
+                                 toBound(op, a), toUpper(op, b), 1);
+};
+
+N64.compact = function compact(dst, src, selection) {
+  return binding.bulk.compact(toShared(dst), toShared(src), selection);
+};
+
+function toPredicate(op) {
+  const code = PREDICATES.indexOf(op);
+
+  enforce(code !== -1, 'op', 'operator');
+
+  return code;
+}
+
+// `in` takes an array or buffer of values.
+function toBound(op, value) {
+  if (op !== 'in')
+    return toOperand(value);
+
+  if (Array.isArray(value))
+    return value.map(toOperand);
+
+  enforce(value instanceof N64Array
+          || ArrayBuffer.isView(value)
+          || isBuffer(value), 'values', 'array');
+
+  return toShared(value);
+}
+
+// Only `between` has a second bound.
+function toUpper(op, value) {
+  if (op !== 'between')
+    return undefined;
+
+  return toOperand(value);
+}
+
+/*
+ * JSON
+ */
+
+U64.serializeJSON = function serializeJSON(column, options) {
+  const {base, pad, quoted} = toJSONOptions(options);
+  return binding.bulk.serializeJSON(toShared(column), 0, base, pad, quoted);
+};
+
+I64.serializeJSON = function serializeJSON(column, options) {
+  const {base, pad, quoted} = toJSONOptions(options);
+  return binding.bulk.serializeJSON(toShared(column), 1, base, pad, quoted);
+};
+
+U64.parseJSON = function parseJSON(data, options) {
+  return new JSONParser(U64Array, options).end(data);
+};
+
+I64.parseJSON = function parseJSON(data, options) {
+  return new JSONParser(I64Array, options).end(data);
+};
+
+U64.jsonParser = function jsonParser(options) {
+  return new JSONParser(U64Array, options);
+};
+
+I64.jsonParser = function jsonParser(options) {
+  return new JSONParser(I64Array, options);
+};
+
+/*
+ * JSONParser
+ */
+
+function JSONParser(ctor, options) {
+  const {base} = toJSONOptions(options);
+
+  this.ctor = ctor;
+  this.p = new binding.JSONParser(base);
+}
+
+JSONParser.prototype.write = function write(chunk) {
+  if (typeof chunk === 'string')
+    chunk = Buffer.from(chunk, 'utf8');
+
+  this.p.write(chunk);
+
+  return this;
+};
+
+JSONParser.prototype.end = function end(chunk) {
+  if (chunk != null)
+    this.write(chunk);
+
+  return this.ctor.fromBuffer(this.p.end());
+};
+
+/*
+ * JSON Helpers
+ */
+
+// Defaults to what JSON.stringify makes of toJSON().
+function toJSONOptions(options) {
+  if (options == null)
+    options = {};
+
+  enforce(typeof options === 'object', 'options', 'object');
+
+  const base = options.base != null ? getBase(options.base) : 16;
+  const quoted = options.quoted != null ? Boolean(options.quoted) : true;
+  const pad = options.pad != null ? options.pad : (base === 16 ? 16 : 0);
+
+  enforce((base >>> 0) === base, 'base', 'integer');
+  enforce((pad >>> 0) === pad, 'pad', 'integer');
+
+  if (base < 2 || base > 16)
+    throw new Error('Base ranges between 2 and 16.');
+
+  if (pad > 64)
+    throw new Error('Maximum padding is 64 characters.');
+
+  // JSON numbers are decimal.
+  if (!quoted && base !== 10)
+    throw new Error('Unquoted values must be decimal.');
+
+  return { base, pad, quoted };
+}
+
+/*
+ * Messaging
+ */
+
+function serialize(value) {
+  if (N64.isN64(value)) {
+    const data = new Uint8Array(16);
+
+    data[0] = value.sign ? MESSAGE_I64 : MESSAGE_U64;
+
+    value.writeRaw(data, 8);
+
+    return data;
+  }
+
+  if (value instanceof N64Array) {
+    const data = new Uint8Array(8 + value.length * 8);
+
+    data[0] = value.sign ? MESSAGE_I64_ARRAY : MESSAGE_U64_ARRAY;
+
+    writeI32LE(data, value.length, 4);
+
+    data.set(value.toBuffer(), 8);
+
+    return data;
+  }
+
+  if (value instanceof Histogram) {
+    const data = value.h.encode(8);
+
+    data[0] = value.sign ? MESSAGE_I64_HISTOGRAM : MESSAGE_U64_HISTOGRAM;
+
+    writeI32LE(data, data.length - 8, 4);
+
+    return data;
+  }
+
+  enforce(Array.isArray(value), 'value', 'int64');
+
+  // Signs first, then the values on an 8 byte boundary.
+  const count = value.length;
+  const start = 8 + ((count + 7) & ~7);
+  const data = new Uint8Array(start + count * 8);
+
+  data[0] = MESSAGE_LIST;
+
+  writeI32LE(data, count, 4);
+
+  for (let i = 0; i < count; i++) {
+    const num = value[i];
+
+    enforce(N64.isN64(num), 'value', 'int64');
+
+    data[8 + i] = num.sign;
+
+    num.writeRaw(data, start + i * 8);
+  }
+
+  return data;
+}
+
+function deserialize(data) {
+  data = toBytes(data);
+
+  if (data.length < 8)
+    throw new Error('Invalid message.');
+
+  const count = readI32LE(data, 4) >>> 0;
+
+  switch (data[0]) {
+    case MESSAGE_U64:
+    case MESSAGE_I64: {
+      if (data.length < 16)
+        throw new Error('Invalid message.');
+
+      const ctor = data[0] === MESSAGE_I64 ? I64 : U64;
+
+      return ctor.readRaw(data, 8);
+    }
+
+    case MESSAGE_U64_ARRAY:
+    case MESSAGE_I64_ARRAY: {
+      const ctor = data[0] === MESSAGE_I64_ARRAY ? I64Array : U64Array;
+      const end = 8 + count * 8;
+
+      if (data.length < end)
+        throw new Error('Invalid message.');
+
+      // Read in place where the payload is aligned.
+      let body = data.subarray(8, end);
+
+      if (body.byteOffset & 7)
+        body = new Uint8Array(body);
+
+      return ctor.fromBuffer(body);
+    }
+
+    case MESSAGE_U64_HISTOGRAM:
+    case MESSAGE_I64_HISTOGRAM: {
+      const ctor = data[0] === MESSAGE_I64_HISTOGRAM ? I64 : U64;
+
+      if (data.length < 8 + count)
+        throw new Error('Invalid message.');
+
+      return Histogram.decode(ctor, data.subarray(8, 8 + count));
+    }
+
+    case MESSAGE_LIST: {
+      const start = 8 + ((count + 7) & ~7);
+      const items = [];
+
+      if (data.length < start + count * 8)
+        throw new Error('Invalid message.');
+
+      for (let i = 0; i < count; i++) {
+        const ctor = data[8 + i] ? I64 : U64;
+        items.push(ctor.readRaw(data, start + i * 8));
+      }
+
+      return items;
+    }
+  }
+
+  throw new Error('Invalid message.');
+}
+
+/*
+ * Messaging Constants
+ */
+
+const MESSAGE_U64 = 1;
+const MESSAGE_I64 = 2;
+const MESSAGE_U64_ARRAY = 3;
+const MESSAGE_I64_ARRAY = 4;
+const MESSAGE_LIST = 5;
+const MESSAGE_U64_HISTOGRAM = 6;
+const MESSAGE_I64_HISTOGRAM = 7;
+
+/*
+ * Filtering Constants
+ */
+
+const PREDICATES = [
+  'eq', 'ne', 'lt', 'lte', 'gt', 'gte', 'between', 'in'
+];
+
+/*
+ * Helpers
+ */
+
+function toBytes(data) {
+  if (data instanceof N64Array)
+    return data.toBuffer();
+
+  if (data instanceof ArrayBuffer)
+    return new Uint8Array(data);
+
+  if (typeof SharedArrayBuffer === 'function'
+      && data instanceof SharedArrayBuffer) {
+    return new Uint8Array(data);
+  }
+
+  enforce(ArrayBuffer.isView(data), 'data', 'buffer');
+
+  return data;
+}
+
+function toShared(data) {
+  if (data instanceof N64Array)
+    return data.a;
+
+  return data;
+}
+
+function toOperand(value) {
+  if (N64.isN64(value))
+    return value.n;
+
+  if (typeof value === 'number') {
+    enforce(Number.isSafeInteger(value), 'value', 'integer');
+    return value;
+  }
+
+  enforce(value && typeof value === 'object', 'value', 'int64');
+
+  return U64.fromObject(value).n;
+}
+
+function toOut(out) {
+  if (out == null)
+    return undefined;
+
+  enforce(N64.isN64(out), 'out', 'int64');
+
+  return out.n;
+}
+
+function isStrings(items) {
+  for (let i = 0; i < items.length; i++) {
+    if (typeof items[i] !== 'string')
+      return false;
+  }
+
+  return items.length > 0;
+}
+
+function columnOptions(options) {
+  if (options == null)
+    options = {};
+
+  enforce(typeof options === 'object', 'options', 'object');
+
+  const {delimiter, column, base, header, threads} = options;
+  const opts = {
+    delimiter: 0x2c,
+    column: 0,
+    base: base,
+    header: false,
+    threads: 1
+  };
+
+  if (delimiter != null) {
+    enforce(typeof delimiter === 'string'
+            && delimiter.length === 1, 'delimiter', 'character');
+
+    opts.delimiter = delimiter.charCodeAt(0);
+
+    if (opts.delimiter === 0
+        || opts.delimiter >= 0x80
+        || opts.delimiter === 0x0a
+        || opts.delimiter === 0x0d) {
+      throw new Error('Invalid delimiter.');
+    }
+  }
+
+  if (column != null) {
+    enforce((column >>> 0) === column, 'column', 'integer');
+    opts.column = column;
+  }
+
+  if (header != null) {
+    enforce(typeof header === 'boolean', 'header', 'boolean');
+    opts.header = header;
+  }
+
+  if (threads != null) {
+    enforce((threads >>> 0) === threads, 'threads', 'integer');
+    opts.threads = threads;
+  }
+
+  return opts;
+}
+
+function skipRecord(data) {
+  const nl = data.indexOf(0x0a);
+
+  if (nl === -1)
+    return data.subarray(data.length);
+
+  return data.subarray(nl + 1);
+}
+
+function isBuffer(data) {
+  if (data instanceof ArrayBuffer)
+    return true;
+
+  return typeof SharedArrayBuffer === 'function'
+      && data instanceof SharedArrayBuffer;
+}
+
+function toIndex(index, length, def, name) {
+  if (index == null)
+    return def;
+
+  enforce(Number.isSafeInteger(index), name, 'integer');
+
+  if (index < 0)
+    index += length;
+
+  if (index < 0)
+    return 0;
+
+  if (index > length)
+    return length;
+
+  return index;
+}
+
+function native(sign) {
+  return sign ? new binding.I64() : new binding.U64();
+}
+
+function native128(sign) {
+  return sign ? new binding.I128() : new binding.U128();
+}
+
+function enforce(value, name, type) {
+  if (!value)
+    throw new TypeError(`'${name}' must be a(n) ${type}.`);
+}
+
+function getBase(base) {
+  if (base == null)
+    return 10;
+
+  if (typeof base === 'number')
+    return base;
+
+  switch (base) {
+    case 'bin':
+      return 2;
+    case 'oct':
+      return 8;
+    case 'dec':
+      return 10;
+    case 'hex':
+      return 16;
+  }
+
+  return 0;
+}
+
+function toSeed(seed) {
+  if (seed == null) {
+    return U64.fromBits((Math.random() * 0x100000000) | 0,
+                        (Math.random() * 0x100000000) | 0);
+  }
+
+  if (N64.isN64(seed))
+    return seed.toU64();
+
+  return U64.from(seed);
+}
+
+function toLayout(options) {
+  if (options == null)
+    options = {};
+
+  enforce(typeof options === 'object', 'options', 'object');
+
+  let {lowest, highest, significantDigits} = options;
+
+  if (lowest == null)
+    lowest = 1;
+
+  if (highest == null)
+    highest = Number.MAX_SAFE_INTEGER;
+
+  if (significantDigits == null)
+    significantDigits = 3;
+
+  enforce((significantDigits >>> 0) === significantDigits,
+          'significantDigits', 'integer');
+
+  if (significantDigits < 1 || significantDigits > 5)
+    throw new Error('Invalid significant digits.');
+
+  return [toOperand(lowest), toOperand(highest), significantDigits];
+}
+
+function toFields(fields) {
+  enforce(Array.isArray(fields), 'fields', 'array');
+
+  const items = [];
+  const seen = new Set();
+
+  let offset = 0;
+
+  for (const field of fields) {
+    enforce(field && typeof field === 'object', 'field', 'object');
+
+    const {name, type, size} = field;
+
+    if (type === 'pad') {
+      enforce((size >>> 0) === size, 'size', 'integer');
+      offset += size;
+      continue;
+    }
+
+    enforce(typeof name === 'string' && name.length > 0, 'name', 'string');
+    enforce(typeof type === 'string', 'type', 'string');
+
+    const m = /^([iu])(8|16|32|64)(le|be)?$/.exec(type);
+
+    if (!m)
+      throw new Error(`Invalid field type: ${type}.`);
+
+    if (name === '__proto__' || seen.has(name))
+      throw new Error(`Invalid field name: ${name}.`);
+
+    const width = m[2] >>> 3;
+    const be = width > 1 && m[3] === 'be' ? 1 : 0;
+
+    seen.add(name);
+
+    items.push({
+      name,
+      type: m[1] + m[2] + (width > 1 ? (be ? 'be' : 'le') : ''),
+      offset,
+      width,
+      sign: m[1] === 'i' ? 1 : 0,
+      be
+    });
+
+    offset += width;
+  }
+
+  if (items.length === 0)
+    throw new Error('Struct has no fields.');
+
+  if (offset > 0xffffffff)
+    throw new Error('Struct size exceeds limit.');
+
+  return [items, offset];
+}
+
+// Per layout decode() and encode() closures. The 64 bit
+// fields' native objects are passed after the offset,
+// gathered into an argument list kept with the closure.
+function compileDecode(items) {
+  const small = items.filter(field => field.width !== 8);
+  const wide = items.filter(field => field.width === 8);
+  const args = new Array(2 + wide.length);
+
+  return function decode(data, off, out) {
+    const values = this.values;
+
+    for (let i = 0; i < wide.length; i++) {
+      const {name, sign} = wide[i];
+
+      let num = out[name];
+
+      if (!N64.isN64(num))
+        out[name] = num = sign ? new I64() : new U64();
+
+      args[2 + i] = num.n;
+    }
+
+    args[0] = data;
+    args[1] = off;
+
+    this.s.decode.apply(this.s, args);
+
+    // Do not hold on to the buffer.
+    args[0] = null;
+
+    for (let i = 0; i < small.length; i++)
+      out[small[i].name] = values[i];
+
+    return out;
+  };
+}
+
+function compileEncode(items) {
+  const small = items.filter(field => field.width !== 8);
+  const wide = items.filter(field => field.width === 8);
+  const args = new Array(2 + wide.length);
+
+  return function encode(value, data, off) {
+    const values = this.values;
+
+    // Wraps like the typed array of the same width.
+    for (let i = 0; i < small.length; i++) {
+      const num = value[small[i].name];
+      enforce(typeof num === 'number', 'value', 'number');
+      values[i] = num | 0;
+    }
+
+    for (let i = 0; i < wide.length; i++)
+      args[2 + i] = toWide(value[wide[i].name]);
+
+    args[0] = data;
+    args[1] = off;
+
+    this.s.encode.apply(this.s, args);
+
+    args[0] = null;
+  };
+}
+
+function toWide(num) {
+  if (N64.isN64(num))
+    return num.n;
+
+  enforce(Number.isSafeInteger(num), 'value', 'int64');
+
+  return num;
+}
+
+function toColumn(field, length) {
+  switch (field.width) {
+    case 1:
+      return field.sign ? new Int8Array(length) : new Uint8Array(length);
+    case 2:
+      return field.sign ? new Int16Array(length) : new Uint16Array(length);
+    case 4:
+      return field.sign ? new Int32Array(length) : new Uint32Array(length);
+  }
+
+  return field.sign ? new I64Array(length) : new U64Array(length);
+}
+
+function isColumn(column, field) {
+  if (field.width === 8)
+    return column instanceof N64Array;
+
+  return ArrayBuffer.isView(column)
+      && column.BYTES_PER_ELEMENT === field.width;
 }
 
 function alloc(ArrayLike, size) {
@@ -974,3 +3864,18 @@ function writeI32BE(data, num, off) {
 exports.N64 = N64;
 exports.U64 = U64;
 exports.I64 = I64;
+exports.N128 = N128;
+exports.U128 = U128;
+exports.I128 = I128;
+exports.RNG = RNG;
+exports.Histogram = Histogram;
+exports.Struct = Struct;
+exports.Dec64 = Dec64;
+exports.N64Array = N64Array;
+exports.U64Array = U64Array;
+exports.I64Array = I64Array;
+exports.Atomic = Atomic;
+exports.Counter = Counter;
+exports.serialize = serialize;
+exports.deserialize = deserialize;
+exports.struct = Struct;
@@ -0,0 +1,1006 @@
+/**
+ * array.cc - native int64 array for node.js.
+ * Copyright (c) 2017, Christopher Jeffrey (MIT License)
+ *
+ * Elements are stored contiguously as uint64_t in a
+ * malloc'd store. Subarrays and buffers returned by
+ * toBuffer() share the store. An array only grows in
+ * place while it is the sole owner of its store;
+ * otherwise it moves to a private copy first, so that
+ * pushes are never visible through older references.
+ *
+ * transfer() hands the memory to an ArrayBuffer which
+ * can be moved to another thread without copying, and
+ * attach() wraps an ArrayBuffer as a store, so that a
+ * received array is read in place.
+ */
+
+#include <node.h>
+#include <nan.h>
+
+#include <inttypes.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include <uv.h>
+
+#include "core.h"
+#include "env.h"
+#include "stats.h"
+#include "n64.h"
+#include "array.h"
+
+#define ARG_ERROR(name, len) ("N64Array#" #name " requires " #len " argument(s).")
+#define TYPE_ERROR(name, type) ("'" #name "' must be a(n) " #type ".")
+
+#define ARRAY_MAX_LENGTH 0xffffffffull
+#define ARRAY_MIN_CAP 8
+#define COLUMN_MAX_THREADS 64
+#define COLUMN_MIN_CHUNK (256 * 1024)
+
+/*
+ * Store
+ */
+
+static void
+store_adjust(int64_t bytes) {
+  // Nan takes an int; report large stores in pieces.
+  while (bytes > INT_MAX) {
+    Nan::AdjustExternalMemory(INT_MAX);
+    bytes -= INT_MAX;
+  }
+
+  while (bytes < -INT_MAX) {
+    Nan::AdjustExternalMemory(-INT_MAX);
+    bytes += INT_MAX;
+  }
+
+  Nan::AdjustExternalMemory((int)bytes);
+}
+
+static n64_store_t *
+store_create(size_t cap) {
+  n64_store_t *s = (n64_store_t *)malloc(sizeof(n64_store_t));
+
+  if (s == NULL)
+    return NULL;
+
+  s->data = NULL;
+  s->cap = cap;
+  s->refs = 1;
+  s->ref = NULL;
+
+  if (cap > 0) {
+    s->data = (uint64_t *)calloc(cap, sizeof(uint64_t));
+
+    if (s->data == NULL) {
+      free(s);
+      return NULL;
+    }
+
+    store_adjust((int64_t)(cap * sizeof(uint64_t)));
+  }
+
+  return s;
+}
+
+// Keeps an attached buffer's memory alive. Holding
+// the backing store rather than the object means a
+// later detach of the buffer cannot free it under us.
+#if NODE_MAJOR_VERSION >= 14
+typedef std::shared_ptr<v8::BackingStore> store_ref_t;
+
+template <typename T>
+static store_ref_t *
+store_ref(v8::Local<T> buf) {
+  return new store_ref_t(buf->GetBackingStore());
+}
+#else
+typedef Nan::Persistent<v8::Object> store_ref_t;
+
+template <typename T>
+static store_ref_t *
+store_ref(v8::Local<T> buf) {
+  return new store_ref_t(buf);
+}
+#endif
+
+static void
+store_unref(n64_store_t *s) {
+  if (--s->refs > 0)
+    return;
+
+  if (s->ref != NULL) {
+    store_ref_t *ref = (store_ref_t *)s->ref;
+#if NODE_MAJOR_VERSION < 14
+    ref->Reset();
+#endif
+    delete ref;
+  } else if (s->data != NULL) {
+    store_adjust(-(int64_t)(s->cap * sizeof(uint64_t)));
+    free(s->data);
+  }
+
+  free(s);
+}
+
+static void
+store_free(char *data, void *hint) {
+  (void)data;
+  store_unref((n64_store_t *)hint);
+}
+
+/*
+ * Buffers
+ */
+
+// Fetching a backing store costs more than the
+// operation itself, so use Data() where it exists.
+#if NODE_MAJOR_VERSION >= 18
+template <typename T>
+static inline uint8_t *
+buffer_data(v8::Local<T> buf, size_t *len) {
+  *len = buf->ByteLength();
+  return (uint8_t *)buf->Data();
+}
+#elif NODE_MAJOR_VERSION >= 14
+template <typename T>
+static inline uint8_t *
+buffer_data(v8::Local<T> buf, size_t *len) {
+  std::shared_ptr<v8::BackingStore> store = buf->GetBackingStore();
+  *len = store->ByteLength();
+  return (uint8_t *)store->Data();
+}
+#else
+template <typename T>
+static inline uint8_t *
+buffer_data(v8::Local<T> buf, size_t *len) {
+  typename T::Contents contents = buf->GetContents();
+  *len = contents.ByteLength();
+  return (uint8_t *)contents.Data();
+}
+#endif
+
+// Returns the bytes of a buffer, view or array,
+// or NULL if `val` is none of them.
+uint8_t *
+get_buffer(v8::Local<v8::Value> val, size_t *len) {
+  if (val->IsSharedArrayBuffer())
+    return buffer_data(val.As<v8::SharedArrayBuffer>(), len);
+
+  if (val->IsArrayBufferView()) {
+    v8::Local<v8::ArrayBufferView> view = val.As<v8::ArrayBufferView>();
+    size_t size = 0;
+    uint8_t *base = buffer_data(view->Buffer(), &size);
+    *len = view->ByteLength();
+    return base + view->ByteOffset();
+  }
+
+  if (val->IsArrayBuffer())
+    return buffer_data(val.As<v8::ArrayBuffer>(), len);
+
+  if (N64Array::HasInstance(val)) {
+    N64Array *a = Nan::ObjectWrap::Unwrap<N64Array>(val.As<v8::Object>());
+    *len = a->len * sizeof(uint64_t);
+    return (uint8_t *)a->data();
+  }
+
+  return NULL;
+}
+
+/*
+ * N64Array
+ */
+
+N64Array::N64Array() {
+  sign = 0;
+  store = NULL;
+  off = 0;
+  len = 0;
+}
+
+N64Array::~N64Array() {
+  if (store != NULL)
+    store_unref(store);
+}
+
+void
+N64Array::Init(v8::Local<v8::Object> &target) {
+  Nan::HandleScope scope;
+
+  n64_env_t *env = env_get();
+
+  if (env->array.IsEmpty()) {
+    v8::Local<v8::FunctionTemplate> tpl =
+      stats_template("N64Array", N64Array::New);
+
+    tpl->SetClassName(Nan::New("N64Array").ToLocalChecked());
+    tpl->InstanceTemplate()->SetInternalFieldCount(1);
+
+    stats_method(tpl, "N64Array", "push", N64Array::Push);
+    stats_method(tpl, "N64Array", "pushn", N64Array::Pushn);
+    stats_method(tpl, "N64Array", "get", N64Array::Get);
+    stats_method(tpl, "N64Array", "set", N64Array::Set);
+    stats_method(tpl, "N64Array", "setn", N64Array::Setn);
+    stats_method(tpl, "N64Array", "subarray", N64Array::Subarray);
+    stats_method(tpl, "N64Array", "toBuffer", N64Array::ToBuffer);
+    stats_method(tpl, "N64Array", "transfer", N64Array::Transfer);
+    stats_method(tpl, "N64Array", "attach", N64Array::Attach);
+    stats_method(tpl, "N64Array", "parse", N64Array::Parse);
+    stats_method(tpl, "N64Array", "parseColumn", N64Array::ParseColumn);
+
+    env->array.Reset(tpl);
+  }
+
+  v8::Local<v8::FunctionTemplate> ctor = Nan::New(env->array);
+
+  Nan::Set(target, Nan::New("N64Array").ToLocalChecked(),
+    Nan::GetFunction(ctor).ToLocalChecked());
+}
+
+bool N64Array::HasInstance(v8::Local<v8::Value> val) {
+  Nan::HandleScope scope;
+  return Nan::New(env_get()->array)->HasInstance(val);
+}
+
+bool
+N64Array::Grow(size_t need) {
+  if (need > ARRAY_MAX_LENGTH)
+    return false;
+
+  if (store->refs == 1 && off == 0 && need <= store->cap)
+    return true;
+
+  size_t cap = store->cap > ARRAY_MIN_CAP ? store->cap : ARRAY_MIN_CAP;
+
+  while (cap < need)
+    cap *= 2;
+
+  if (store->refs == 1 && off == 0 && store->ref == NULL) {
+    uint64_t *data = (uint64_t *)realloc(store->data, cap * sizeof(uint64_t));
+
+    if (data == NULL)
+      return false;
+
+    store_adjust((int64_t)((cap - store->cap) * sizeof(uint64_t)));
+
+    store->data = data;
+    store->cap = cap;
+
+    return true;
+  }
+
+  n64_store_t *s = store_create(cap);
+
+  if (s == NULL)
+    return false;
+
+  if (len > 0)
+    memcpy(s->data, data(), len * sizeof(uint64_t));
+
+  store_unref(store);
+
+  store = s;
+  off = 0;
+
+  return true;
+}
+
+NAN_METHOD(N64Array::New) {
+  if (!info.IsConstructCall())
+    return Nan::ThrowError("N64Array must be called with `new`.");
+
+  uint32_t len = 0;
+  int sign = 0;
+
+  if (info.Length() > 0 && !info[0]->IsUndefined()) {
+    if (!info[0]->IsUint32())
+      return Nan::ThrowTypeError(TYPE_ERROR(length, integer));
+
+    len = Nan::To<uint32_t>(info[0]).FromJust();
+  }
+
+  if (info.Length() > 1)
+    sign = (int)Nan::To<bool>(info[1]).FromJust();
+
+  n64_store_t *store = store_create(len);
+
+  if (store == NULL)
+    return Nan::ThrowError("Allocation failed.");
+
+  N64Array *obj = new N64Array();
+  obj->sign = sign;
+  obj->store = store;
+  obj->len = len;
+  obj->Wrap(info.This());
+
+  stats_alloc();
+
+  info.GetReturnValue().Set(info.This());
+}
+
+NAN_METHOD(N64Array::Push) {
+  N64Array *a = ObjectWrap::Unwrap<N64Array>(info.Holder());
+
+  if (info.Length() < 1)
+    return Nan::ThrowError(ARG_ERROR(push, 1));
+
+  if (!N64::HasInstance(info[0]))
+    return Nan::ThrowTypeError(TYPE_ERROR(value, int64));
+
+  N64 *b = ObjectWrap::Unwrap<N64>(info[0].As<v8::Object>());
+
+  if (!a->Grow(a->len + 1))
+    return Nan::ThrowError("Array length exceeds limit.");
+
+  a->data()[a->len] = *b->n;
+  a->len += 1;
+
+  info.GetReturnValue().Set(Nan::New<v8::Number>((double)a->len));
+}
+
+NAN_METHOD(N64Array::Pushn) {
+  N64Array *a = ObjectWrap::Unwrap<N64Array>(info.Holder());
+
+  if (info.Length() < 1)
+    return Nan::ThrowError(ARG_ERROR(pushn, 1));
+
+  if (!info[0]->IsNumber())
+    return Nan::ThrowTypeError(TYPE_ERROR(value, number));
+
+  uint32_t num = Nan::To<uint32_t>(info[0]).FromJust();
+
+  if (!a->Grow(a->len + 1))
+    return Nan::ThrowError("Array length exceeds limit.");
+
+  a->data()[a->len] = a->sign
+    ? (uint64_t)((int64_t)((int32_t)num))
+    : (uint64_t)num;
+
+  a->len += 1;
+
+  info.GetReturnValue().Set(Nan::New<v8::Number>((double)a->len));
+}
+
+NAN_METHOD(N64Array::Get) {
+  N64Array *a = ObjectWrap::Unwrap<N64Array>(info.Holder());
+
+  if (info.Length() < 2)
+    return Nan::ThrowError(ARG_ERROR(get, 2));
+
+  if (!info[0]->IsUint32())
+    return Nan::ThrowTypeError(TYPE_ERROR(index, integer));
+
+  if (!N64::HasInstance(info[1]))
+    return Nan::ThrowTypeError(TYPE_ERROR(out, int64));
+
+  uint32_t i = Nan::To<uint32_t>(info[0]).FromJust();
+
+  if (i >= a->len)
+    return Nan::ThrowError("Invalid index.");
+
+  N64 *b = ObjectWrap::Unwrap<N64>(info[1].As<v8::Object>());
+
+  *b->n = a->data()[i];
+
+  info.GetReturnValue().Set(info[1]);
+}
+
+NAN_METHOD(N64Array::Set) {
+  N64Array *a = ObjectWrap::Unwrap<N64Array>(info.Holder());
+
+  if (info.Length() < 2)
+    return Nan::ThrowError(ARG_ERROR(set, 2));
+
+  if (!info[0]->IsUint32())
+    return Nan::ThrowTypeError(TYPE_ERROR(index, integer));
+
+  if (!N64::HasInstance(info[1]))
+    return Nan::ThrowTypeError(TYPE_ERROR(value, int64));
+
+  uint32_t i = Nan::To<uint32_t>(info[0]).FromJust();
+
+  if (i >= a->len)
+    return Nan::ThrowError("Invalid index.");
+
+  N64 *b = ObjectWrap::Unwrap<N64>(info[1].As<v8::Object>());
+
+  a->data()[i] = *b->n;
+
+  info.GetReturnValue().Set(info.Holder());
+}
+
+NAN_METHOD(N64Array::Setn) {
+  N64Array *a = ObjectWrap::Unwrap<N64Array>(info.Holder());
+
+  if (info.Length() < 2)
+    return Nan::ThrowError(ARG_ERROR(setn, 2));
+
+  if (!info[0]->IsUint32())
+    return Nan::ThrowTypeError(TYPE_ERROR(index, integer));
+
+  if (!info[1]->IsNumber())
+    return Nan::ThrowTypeError(TYPE_ERROR(value, number));
+
+  uint32_t i = Nan::To<uint32_t>(info[0]).FromJust();
+  uint32_t num = Nan::To<uint32_t>(info[1]).FromJust();
+
+  if (i >= a->len)
+    return Nan::ThrowError("Invalid index.");
+
+  a->data()[i] = a->sign
+    ? (uint64_t)((int64_t)((int32_t)num))
+    : (uint64_t)num;
+
+  info.GetReturnValue().Set(info.Holder());
+}
+
+NAN_METHOD(N64Array::Subarray) {
+  N64Array *a = ObjectWrap::Unwrap<N64Array>(info.Holder());
+
+  if (info.Length() < 2)
+    return Nan::ThrowError(ARG_ERROR(subarray, 2));
+
+  if (!info[0]->IsUint32())
+    return Nan::ThrowTypeError(TYPE_ERROR(start, integer));
+
+  if (!info[1]->IsUint32())
+    return Nan::ThrowTypeError(TYPE_ERROR(end, integer));
+
+  uint32_t start = Nan::To<uint32_t>(info[0]).FromJust();
+  uint32_t end = Nan::To<uint32_t>(info[1]).FromJust();
+
+  if (start > end || end > a->len)
+    return Nan::ThrowError("Invalid range.");
+
+  v8::Local<v8::Function> ctor =
+    Nan::GetFunction(Nan::New(env_get()->array)).ToLocalChecked();
+
+  v8::Local<v8::Object> obj = Nan::NewInstance(ctor).ToLocalChecked();
+  N64Array *b = ObjectWrap::Unwrap<N64Array>(obj);
+
+  store_unref(b->store);
+
+  a->store->refs += 1;
+
+  b->sign = a->sign;
+  b->store = a->store;
+  b->off = a->off + start;
+  b->len = end - start;
+
+  info.GetReturnValue().Set(obj);
+}
+
+NAN_METHOD(N64Array::ToBuffer) {
+  N64Array *a = ObjectWrap::Unwrap<N64Array>(info.Holder());
+
+  if (a->len == 0) {
+    info.GetReturnValue().Set(Nan::NewBuffer(0).ToLocalChecked());
+    return;
+  }
+
+  // The buffer holds a reference to the store
+  // and releases it once it is collected.
+  a->store->refs += 1;
+
+  info.GetReturnValue().Set(
+    Nan::NewBuffer((char *)a->data(), a->len * sizeof(uint64_t),
+                   store_free, a->store).ToLocalChecked());
+}
+
+#if NODE_MAJOR_VERSION >= 14
+static void
+transfer_free(void *data, size_t length, void *hint) {
+  (void)length;
+  (void)hint;
+  free(data);
+}
+#endif
+
+NAN_METHOD(N64Array::Transfer) {
+  N64Array *a = ObjectWrap::Unwrap<N64Array>(info.Holder());
+  v8::Isolate *isolate = v8::Isolate::GetCurrent();
+  n64_store_t *s = a->store;
+  size_t size = a->len * sizeof(uint64_t);
+  v8::Local<v8::ArrayBuffer> buf;
+
+#if NODE_MAJOR_VERSION >= 14
+  // A sole owner gives its memory away. The deleter may
+  // run on any thread, so it must not touch the isolate.
+  if (s->refs == 1 && a->off == 0 && s->ref == NULL && size > 0) {
+    uint64_t *data = s->data;
+
+    if (a->len < s->cap) {
+      data = (uint64_t *)realloc(data, size);
+
+      if (data == NULL)
+        data = s->data;
+    }
+
+    store_adjust(-(int64_t)(s->cap * sizeof(uint64_t)));
+
+    s->data = NULL;
+    s->cap = 0;
+
+    std::unique_ptr<v8::BackingStore> bs =
+      v8::ArrayBuffer::NewBackingStore(data, size, transfer_free, NULL);
+
+    buf = v8::ArrayBuffer::New(isolate, std::move(bs));
+  } else
+#endif
+  {
+    buf = v8::ArrayBuffer::New(isolate, size);
+
+    if (size > 0) {
+      size_t len = 0;
+      uint8_t *raw = NULL;
+#if NODE_MAJOR_VERSION >= 14
+      raw = (uint8_t *)buf->GetBackingStore()->Data();
+      len = size;
+#else
+      v8::ArrayBuffer::Contents contents = buf->GetContents();
+      raw = (uint8_t *)contents.Data();
+      len = contents.ByteLength();
+#endif
+      memcpy(raw, a->data(), len);
+    }
+  }
+
+  // Leave the array empty, like a detached buffer.
+  if (s->cap > 0 || s->ref != NULL) {
+    n64_store_t *e = store_create(0);
+
+    if (e == NULL)
+      return Nan::ThrowError("Allocation failed.");
+
+    store_unref(s);
+
+    a->store = e;
+  }
+
+  a->off = 0;
+  a->len = 0;
+
+  info.GetReturnValue().Set(buf);
+}
+
+NAN_METHOD(N64Array::Attach) {
+  N64Array *a = ObjectWrap::Unwrap<N64Array>(info.Holder());
+
+  if (info.Length() < 1)
+    return Nan::ThrowError(ARG_ERROR(attach, 1));
+
+  v8::Local<v8::Value> val = info[0];
+  v8::Local<v8::ArrayBuffer> buf;
+  size_t off = 0;
+  size_t size = 0;
+
+  if (val->IsArrayBufferView()) {
+    v8::Local<v8::ArrayBufferView> view = val.As<v8::ArrayBufferView>();
+    buf = view->Buffer();
+    off = view->ByteOffset();
+    size = view->ByteLength();
+  } else if (val->IsArrayBuffer()) {
+    buf = val.As<v8::ArrayBuffer>();
+    size = buf->ByteLength();
+  } else {
+    return Nan::ThrowTypeError(TYPE_ERROR(data, buffer));
+  }
+
+  if ((size & 7) != 0)
+    return Nan::ThrowError("Invalid buffer length.");
+
+  if (size / 8 > ARRAY_MAX_LENGTH)
+    return Nan::ThrowError("Array length exceeds limit.");
+
+  uint8_t *data = NULL;
+
+  if (size > 0) {
+#if NODE_MAJOR_VERSION >= 14
+    data = (uint8_t *)buf->GetBackingStore()->Data() + off;
+#else
+    data = (uint8_t *)buf->GetContents().Data() + off;
+#endif
+
+    if (((uintptr_t)data & 7) != 0)
+      return Nan::ThrowError("Unaligned offset.");
+  }
+
+  n64_store_t *s = (n64_store_t *)malloc(sizeof(n64_store_t));
+
+  if (s == NULL)
+    return Nan::ThrowError("Allocation failed.");
+
+  s->data = (uint64_t *)data;
+  s->cap = size / 8;
+  s->refs = 1;
+  s->ref = size > 0 ? (void *)store_ref(buf) : NULL;
+
+  store_unref(a->store);
+
+  a->store = s;
+  a->off = 0;
+  a->len = size / 8;
+
+  info.GetReturnValue().Set(Nan::New<v8::Number>((double)a->len));
+}
+
+// Copies a string out as bytes, with anything
+// outside of ASCII replaced by DEL so that it
+// fails to parse rather than aliasing a digit.
+static uint8_t *
+string_bytes(v8::Local<v8::String> str, size_t *len) {
+  size_t size = str->Length();
+  uint8_t *buf = (uint8_t *)malloc(size + 1);
+
+  if (buf == NULL)
+    return NULL;
+
+#if NODE_MAJOR_VERSION >= 12
+  v8::Isolate *isolate = v8::Isolate::GetCurrent();
+
+  if (str->IsOneByte()) {
+    str->WriteOneByte(isolate, buf, 0, size, v8::String::NO_NULL_TERMINATION);
+    *len = size;
+    return buf;
+  }
+#endif
+
+  uint16_t *wide = (uint16_t *)malloc((size + 1) * sizeof(uint16_t));
+
+  if (wide == NULL) {
+    free(buf);
+    return NULL;
+  }
+
+#if NODE_MAJOR_VERSION >= 12
+  str->Write(isolate, wide, 0, size, v8::String::NO_NULL_TERMINATION);
+#else
+  str->Write(wide, 0, size, v8::String::NO_NULL_TERMINATION);
+#endif
+
+  for (size_t i = 0; i < size; i++)
+    buf[i] = wide[i] < 0x80 ? (uint8_t)wide[i] : 0x7f;
+
+  free(wide);
+
+  *len = size;
+
+  return buf;
+}
+
+NAN_METHOD(N64Array::Parse) {
+  N64Array *a = ObjectWrap::Unwrap<N64Array>(info.Holder());
+
+  if (info.Length() < 3)
+    return Nan::ThrowError(ARG_ERROR(parse, 3));
+
+  // Either an array of items or, for strings, the
+  // same items joined by newlines plus their count.
+  // Reading array elements through the V8 API costs
+  // about as much as a call, so text is much faster.
+  bool text = info[0]->IsString();
+
+  if (!text && !info[0]->IsArray())
+    return Nan::ThrowTypeError(TYPE_ERROR(items, array));
+
+  uint32_t base = 10;
+
+  if (!read_base(info[1], &base))
+    return Nan::ThrowTypeError(TYPE_ERROR(base, integer));
+
+  if (!n64_is_base(base))
+    return Nan::ThrowError("Base ranges between 2 and 16.");
+
+  if (!info[2]->IsUint8Array())
+    return Nan::ThrowTypeError(TYPE_ERROR(valid, buffer));
+
+  uint32_t count = 0;
+
+  if (text) {
+    if (!info[3]->IsUint32())
+      return Nan::ThrowTypeError(TYPE_ERROR(count, integer));
+
+    count = info[3].As<v8::Uint32>()->Value();
+  } else {
+    count = info[0].As<v8::Array>()->Length();
+  }
+
+  v8::Local<v8::Uint8Array> valid = info[2].As<v8::Uint8Array>();
+
+  if (valid->ByteLength() < ((size_t)count + 7) / 8)
+    return Nan::ThrowError("Invalid range.");
+
+  if (!a->Grow((size_t)a->len + count))
+    return Nan::ThrowError("Array length exceeds limit.");
+
+  if (count == 0) {
+    info.GetReturnValue().Set(Nan::New<v8::Number>(0));
+    return;
+  }
+
+#if NODE_MAJOR_VERSION >= 14
+  uint8_t *bits = (uint8_t *)valid->Buffer()->GetBackingStore()->Data();
+#else
+  uint8_t *bits = (uint8_t *)valid->Buffer()->GetContents().Data();
+#endif
+
+  bits += valid->ByteOffset();
+
+  uint64_t *out = a->data() + a->len;
+  int64_t invalid = 0;
+
+  if (text) {
+    size_t len = 0;
+    uint8_t *buf = string_bytes(info[0].As<v8::String>(), &len);
+
+    if (buf == NULL)
+      return Nan::ThrowError("Allocation failed.");
+
+    invalid = n64_read_lines(out, bits, count, (const char *)buf, len, base);
+
+    free(buf);
+
+    // A field held a newline; the caller retries
+    // with the array.
+    if (invalid < 0) {
+      info.GetReturnValue().Set(Nan::New<v8::Number>(-1));
+      return;
+    }
+  } else {
+    v8::Local<v8::Array> items = info[0].As<v8::Array>();
+
+    memset(bits, 0, ((size_t)count + 7) / 8);
+
+    // Bad elements become zero and clear their bit;
+    // nothing is thrown for them.
+    for (uint32_t i = 0; i < count; i++) {
+      v8::Local<v8::Value> item;
+      uint64_t n = 0;
+      bool ok = false;
+
+      if (!Nan::Get(items, i).ToLocal(&item))
+        return;
+
+      if (item->IsString())
+        ok = read_string(item, base, &n) == N64_OK;
+      else
+        ok = read_number(item, &n);
+
+      if (ok)
+        bits[i >> 3] |= 1 << (i & 7);
+      else
+        invalid += 1;
+
+      out[i] = ok ? n : 0;
+    }
+  }
+
+  a->len += count;
+
+  info.GetReturnValue().Set(Nan::New<v8::Number>((double)invalid));
+}
+
+/*
+ * Columns
+ */
+
+// One contiguous run of records. Every run but the
+// first starts on a multiple of 8 rows, so that no
+// two threads ever write the same bitmap byte.
+typedef struct column_job_s {
+  const char *str;
+  const char *end;
+  size_t row;
+  size_t count;
+  uint64_t *out;
+  uint8_t *valid;
+  int delim;
+  uint32_t column;
+  uint32_t base;
+  int64_t invalid;
+} column_job_t;
+
+static void
+column_count(void *arg) {
+  column_job_t *job = (column_job_t *)arg;
+  job->count = n64_count_records(job->str, job->end - job->str);
+}
+
+static void
+column_parse(void *arg) {
+  column_job_t *job = (column_job_t *)arg;
+  job->invalid = n64_read_column(job->out + job->row,
+                                 job->valid + (job->row >> 3),
+                                 job->count,
+                                 job->str,
+                                 job->end - job->str,
+                                 job->delim,
+                                 job->column,
+                                 job->base);
+}
+
+static void
+column_run(column_job_t *jobs, size_t len, uv_thread_cb cb) {
+  // The calling thread takes the first job. A thread
+  // which fails to start has its job run inline.
+  uv_thread_t tids[COLUMN_MAX_THREADS];
+  bool started[COLUMN_MAX_THREADS];
+
+  for (size_t i = 1; i < len; i++)
+    started[i] = uv_thread_create(&tids[i], cb, &jobs[i]) == 0;
+
+  cb(&jobs[0]);
+
+  for (size_t i = 1; i < len; i++) {
+    if (started[i])
+      uv_thread_join(&tids[i]);
+    else
+      cb(&jobs[i]);
+  }
+}
+
+NAN_METHOD(N64Array::ParseColumn) {
+  N64Array *a = ObjectWrap::Unwrap<N64Array>(info.Holder());
+
+  if (info.Length() < 5)
+    return Nan::ThrowError(ARG_ERROR(parseColumn, 5));
+
+  if (!info[0]->IsUint8Array())
+    return Nan::ThrowTypeError(TYPE_ERROR(data, buffer));
+
+  if (!info[1]->IsUint32())
+    return Nan::ThrowTypeError(TYPE_ERROR(delimiter, integer));
+
+  if (!info[2]->IsUint32())
+    return Nan::ThrowTypeError(TYPE_ERROR(column, integer));
+
+  uint32_t base = 10;
+
+  if (!read_base(info[3], &base))
+    return Nan::ThrowTypeError(TYPE_ERROR(base, integer));
+
+  if (!n64_is_base(base))
+    return Nan::ThrowError("Base ranges between 2 and 16.");
+
+  if (!info[4]->IsUint32())
+    return Nan::ThrowTypeError(TYPE_ERROR(threads, integer));
+
+  uint32_t delim = info[1].As<v8::Uint32>()->Value();
+  uint32_t column = info[2].As<v8::Uint32>()->Value();
+  uint32_t threads = info[4].As<v8::Uint32>()->Value();
+
+  if (delim == 0 || delim >= 0x80 || delim == '\n' || delim == '\r')
+    return Nan::ThrowError("Invalid delimiter.");
+
+  v8::Local<v8::Uint8Array> view = info[0].As<v8::Uint8Array>();
+  size_t len = view->ByteLength();
+  const char *str = NULL;
+
+  if (len > 0) {
+#if NODE_MAJOR_VERSION >= 14
+    str = (const char *)view->Buffer()->GetBackingStore()->Data();
+#else
+    str = (const char *)view->Buffer()->GetContents().Data();
+#endif
+    str += view->ByteOffset();
+  }
+
+  // Small inputs are not worth a thread.
+  size_t n = len / COLUMN_MIN_CHUNK;
+
+  if (n > threads)
+    n = threads;
+
+  if (n > COLUMN_MAX_THREADS)
+    n = COLUMN_MAX_THREADS;
+
+  if (n == 0)
+    n = 1;
+
+  column_job_t jobs[COLUMN_MAX_THREADS];
+  const char *end = str + len;
+
+  // Split on bytes, then move each boundary forward
+  // to the start of the next record.
+  for (size_t i = 0; i < n; i++) {
+    column_job_t *job = &jobs[i];
+
+    job->str = str;
+
+    if (i > 0) {
+      size_t skip = 1;
+      job->str = n64_skip_records(str + (len / n) * i - 1, end, &skip);
+    }
+
+    job->end = end;
+    job->row = 0;
+    job->count = 0;
+    job->out = NULL;
+    job->valid = NULL;
+    job->delim = (int)delim;
+    job->column = column;
+    job->base = base;
+    job->invalid = 0;
+
+    if (i > 0)
+      jobs[i - 1].end = job->str;
+  }
+
+  if (n > 1)
+    column_run(jobs, n, column_count);
+  else
+    column_count(&jobs[0]);
+
+  // Number the rows, handing the first few records
+  // of each run to the run before it until it starts
+  // on a whole bitmap byte. Runs left empty by a very
+  // long record are passed over.
+  size_t last = 0;
+
+  for (size_t i = 1; i < n; i++) {
+    column_job_t *prev = &jobs[last];
+    column_job_t *job = &jobs[i];
+    size_t need = (8 - ((prev->row + prev->count) & 7)) & 7;
+    size_t skip = need;
+
+    job->str = n64_skip_records(job->str, job->end, &skip);
+    job->row = prev->row + prev->count + (need - skip);
+    job->count -= need - skip;
+
+    prev->end = job->str;
+    prev->count += need - skip;
+
+    if (job->count > 0)
+      last = i;
+  }
+
+  size_t rows = jobs[n - 1].row + jobs[n - 1].count;
+
+  if (!a->Grow(a->len + rows))
+    return Nan::ThrowError("Array length exceeds limit.");
+
+  v8::Isolate *isolate = v8::Isolate::GetCurrent();
+  size_t size = (rows + 7) / 8;
+  v8::Local<v8::ArrayBuffer> buf = v8::ArrayBuffer::New(isolate, size);
+  v8::Local<v8::Uint8Array> valid = v8::Uint8Array::New(buf, 0, size);
+  uint8_t *bits = NULL;
+
+  // New buffers are zeroed.
+  if (size > 0) {
+#if NODE_MAJOR_VERSION >= 14
+    bits = (uint8_t *)buf->GetBackingStore()->Data();
+#else
+    bits = (uint8_t *)buf->GetContents().Data();
+#endif
+  }
+
+  int64_t invalid = 0;
+
+  if (rows > 0) {
+    for (size_t i = 0; i < n; i++) {
+      jobs[i].out = a->data() + a->len;
+      jobs[i].valid = bits;
+    }
+
+    if (n > 1)
+      column_run(jobs, n, column_parse);
+    else
+      column_parse(&jobs[0]);
+
+    for (size_t i = 0; i < n; i++)
+      invalid += jobs[i].invalid;
+  }
+
+  a->len += rows;
+
+  v8::Local<v8::Object> ret = Nan::New<v8::Object>();
+
+  Nan::Set(ret, Nan::New("length").ToLocalChecked(),
+           Nan::New<v8::Number>((double)rows));
+  Nan::Set(ret, Nan::New("invalid").ToLocalChecked(),
+           Nan::New<v8::Number>((double)invalid));
+  Nan::Set(ret, Nan::New("valid").ToLocalChecked(), valid);
+
+  info.GetReturnValue().Set(ret);
+}
@@ -0,0 +1,61 @@
+/**
+ * array.h - native int64 array for node.js.
+ * Copyright (c) 2017, Christopher Jeffrey (MIT License)
+ */
+
+#ifndef _N64_ARRAY_H
+#define _N64_ARRAY_H
+
+#include <node.h>
+#include <nan.h>
+#include <inttypes.h>
+#include <stddef.h>
+
+// Reference counted so that subarrays and
+// exposed buffers can outlive their parent.
+// `ref` is set when the data belongs to an
+// attached ArrayBuffer rather than to us.
+typedef struct n64_store_s {
+  uint64_t *data;
+  size_t cap;
+  size_t refs;
+  void *ref;
+} n64_store_t;
+
+class N64Array : public Nan::ObjectWrap {
+public:
+  static void Init(v8::Local<v8::Object> &target);
+  static bool HasInstance(v8::Local<v8::Value> val);
+  static NAN_METHOD(New);
+
+  N64Array();
+  ~N64Array();
+
+  uint64_t *data() const {
+    return store->data + off;
+  }
+
+  int sign;
+  n64_store_t *store;
+  size_t off;
+  size_t len;
+
+private:
+  bool Grow(size_t need);
+  static NAN_METHOD(Push);
+  static NAN_METHOD(Pushn);
+  static NAN_METHOD(Get);
+  static NAN_METHOD(Set);
+  static NAN_METHOD(Setn);
+  static NAN_METHOD(Subarray);
+  static NAN_METHOD(ToBuffer);
+  static NAN_METHOD(Transfer);
+  static NAN_METHOD(Attach);
+  static NAN_METHOD(Parse);
+  static NAN_METHOD(ParseColumn);
+};
+
+uint8_t *
+get_buffer(v8::Local<v8::Value> val, size_t *len);
+
+#endif
@@ -0,0 +1,269 @@
+/**
+ * atomic.cc - 64 bit atomics on shared memory for n64.
+ * Copyright (c) 2017, Christopher Jeffrey (MIT License)
+ *
+ * Every function takes a buffer (a SharedArrayBuffer,
+ * ArrayBuffer, typed array or N64Array) and an index
+ * in 8 byte elements, like Atomics on a BigInt64Array.
+ * Operands are int64 objects or integers. The previous
+ * value is written to an optional `out` object so that
+ * nothing is allocated per operation.
+ */
+
+#include <node.h>
+#include <nan.h>
+
+#include <inttypes.h>
+#include <stddef.h>
+
+#include "core.h"
+#include "stats.h"
+#include "n64.h"
+#include "array.h"
+#include "atomic.h"
+
+#define ARG_ERROR(name, len) ("atomic." #name " requires " #len " argument(s).")
+#define TYPE_ERROR(name, type) ("'" #name "' must be a(n) " #type ".")
+
+typedef uint64_t (*atomic_op_t)(uint64_t *p, uint64_t v);
+
+/*
+ * Helpers
+ */
+
+// Throws and returns NULL on failure.
+static uint64_t *
+get_slot(v8::Local<v8::Value> data, v8::Local<v8::Value> index) {
+  size_t len = 0;
+  uint8_t *base = get_buffer(data, &len);
+
+  if (base == NULL) {
+    Nan::ThrowTypeError(TYPE_ERROR(data, buffer));
+    return NULL;
+  }
+
+  if (!index->IsUint32()) {
+    Nan::ThrowTypeError(TYPE_ERROR(index, integer));
+    return NULL;
+  }
+
+  size_t i = index.As<v8::Uint32>()->Value();
+
+  if (i >= len / 8) {
+    Nan::ThrowError("Invalid index.");
+    return NULL;
+  }
+
+  uint8_t *slot = base + i * 8;
+
+  if (((uintptr_t)slot & 7) != 0) {
+    Nan::ThrowError("Unaligned offset.");
+    return NULL;
+  }
+
+  return (uint64_t *)slot;
+}
+
+static bool
+get_value(v8::Local<v8::Value> val, uint64_t *r) {
+  if (val->IsInt32()) {
+    *r = (uint64_t)(int64_t)val.As<v8::Int32>()->Value();
+    return true;
+  }
+
+  if (val->IsNumber()) {
+    double num = val.As<v8::Number>()->Value();
+
+    if (!(num >= -9223372036854775808.0 && num < 9223372036854775808.0)
+        || num != (double)(int64_t)num) {
+      Nan::ThrowTypeError(TYPE_ERROR(value, integer));
+      return false;
+    }
+
+    *r = (uint64_t)(int64_t)num;
+
+    return true;
+  }
+
+  if (N64::HasInstance(val)) {
+    N64 *a = Nan::ObjectWrap::Unwrap<N64>(val.As<v8::Object>());
+    *r = *a->n;
+    return true;
+  }
+
+  Nan::ThrowTypeError(TYPE_ERROR(value, int64));
+
+  return false;
+}
+
+// Throws and returns NULL on failure. Returns
+// a scratch slot if no output was passed.
+static uint64_t *
+get_out(v8::Local<v8::Value> out, uint64_t *scratch) {
+  if (out->IsUndefined())
+    return scratch;
+
+  if (!N64::HasInstance(out)) {
+    Nan::ThrowTypeError(TYPE_ERROR(out, int64));
+    return NULL;
+  }
+
+  return Nan::ObjectWrap::Unwrap<N64>(out.As<v8::Object>())->n;
+}
+
+static uint64_t
+atomic_sub(uint64_t *p, uint64_t v) {
+  return n64_atomic_add(p, ~v + 1);
+}
+
+static void
+atomic_rmw(const Nan::FunctionCallbackInfo<v8::Value> &info, atomic_op_t op) {
+  uint64_t *slot = get_slot(info[0], info[1]);
+  uint64_t value, scratch;
+
+  if (slot == NULL)
+    return;
+
+  if (!get_value(info[2], &value))
+    return;
+
+  uint64_t *out = get_out(info[3], &scratch);
+
+  if (out == NULL)
+    return;
+
+  *out = op(slot, value);
+
+  info.GetReturnValue().Set(info[3]);
+}
+
+/*
+ * Methods
+ */
+
+static NAN_METHOD(atomic_add) {
+  if (info.Length() < 3)
+    return Nan::ThrowError(ARG_ERROR(add, 3));
+
+  atomic_rmw(info, n64_atomic_add);
+}
+
+static NAN_METHOD(atomic_sub) {
+  if (info.Length() < 3)
+    return Nan::ThrowError(ARG_ERROR(sub, 3));
+
+  atomic_rmw(info, atomic_sub);
+}
+
+static NAN_METHOD(atomic_and) {
+  if (info.Length() < 3)
+    return Nan::ThrowError(ARG_ERROR(and, 3));
+
+  atomic_rmw(info, n64_atomic_and);
+}
+
+static NAN_METHOD(atomic_or) {
+  if (info.Length() < 3)
+    return Nan::ThrowError(ARG_ERROR(or, 3));
+
+  atomic_rmw(info, n64_atomic_or);
+}
+
+static NAN_METHOD(atomic_xor) {
+  if (info.Length() < 3)
+    return Nan::ThrowError(ARG_ERROR(xor, 3));
+
+  atomic_rmw(info, n64_atomic_xor);
+}
+
+static NAN_METHOD(atomic_exchange) {
+  if (info.Length() < 3)
+    return Nan::ThrowError(ARG_ERROR(exchange, 3));
+
+  atomic_rmw(info, n64_atomic_exchange);
+}
+
+static NAN_METHOD(atomic_compare_exchange) {
+  if (info.Length() < 4)
+    return Nan::ThrowError(ARG_ERROR(compareExchange, 4));
+
+  uint64_t *slot = get_slot(info[0], info[1]);
+  uint64_t expected, replacement, scratch;
+
+  if (slot == NULL)
+    return;
+
+  if (!get_value(info[2], &expected))
+    return;
+
+  if (!get_value(info[3], &replacement))
+    return;
+
+  uint64_t *out = get_out(info[4], &scratch);
+
+  if (out == NULL)
+    return;
+
+  // On failure, `expected` receives the current value.
+  int ok = n64_atomic_cas(slot, &expected, replacement);
+
+  *out = expected;
+
+  info.GetReturnValue().Set(Nan::New<v8::Boolean>(ok != 0));
+}
+
+static NAN_METHOD(atomic_load) {
+  if (info.Length() < 3)
+    return Nan::ThrowError(ARG_ERROR(load, 3));
+
+  uint64_t *slot = get_slot(info[0], info[1]);
+
+  if (slot == NULL)
+    return;
+
+  if (!N64::HasInstance(info[2]))
+    return Nan::ThrowTypeError(TYPE_ERROR(out, int64));
+
+  N64 *a = Nan::ObjectWrap::Unwrap<N64>(info[2].As<v8::Object>());
+
+  *a->n = n64_atomic_load(slot);
+
+  info.GetReturnValue().Set(info[2]);
+}
+
+static NAN_METHOD(atomic_store) {
+  if (info.Length() < 3)
+    return Nan::ThrowError(ARG_ERROR(store, 3));
+
+  uint64_t *slot = get_slot(info[0], info[1]);
+  uint64_t value;
+
+  if (slot == NULL)
+    return;
+
+  if (!get_value(info[2], &value))
+    return;
+
+  n64_atomic_store(slot, value);
+}
+
+/*
+ * Init
+ */
+
+void
+atomic_init(v8::Local<v8::Object> &target) {
+  v8::Local<v8::Object> atomic = Nan::New<v8::Object>();
+
+  stats_function(atomic, "atomic", "add", atomic_add);
+  stats_function(atomic, "atomic", "sub", atomic_sub);
+  stats_function(atomic, "atomic", "and", atomic_and);
+  stats_function(atomic, "atomic", "or", atomic_or);
+  stats_function(atomic, "atomic", "xor", atomic_xor);
+  stats_function(atomic, "atomic", "exchange", atomic_exchange);
+  stats_function(atomic, "atomic", "compareExchange", atomic_compare_exchange);
+  stats_function(atomic, "atomic", "load", atomic_load);
+  stats_function(atomic, "atomic", "store", atomic_store);
+
+  Nan::Set(target, Nan::New("atomic").ToLocalChecked(), atomic);
+}
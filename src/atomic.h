@@ -0,0 +1,15 @@
+/**
+ * atomic.h - 64 bit atomics on shared memory for n64.
+ * Copyright (c) 2017, Christopher Jeffrey (MIT License)
+ */
+
+#ifndef _N64_ATOMIC_H
+#define _N64_ATOMIC_H
+
+#include <node.h>
+#include <nan.h>
+
+void
+atomic_init(v8::Local<v8::Object> &target);
+
+#endif
@@ -0,0 +1,1309 @@
+/**
+ * bulk.cc - bulk conversions over buffers for n64.
+ * Copyright (c) 2017, Christopher Jeffrey (MIT License)
+ *
+ * Every function takes buffers of 8 byte little endian
+ * words (a Buffer, typed array, ArrayBuffer or N64Array)
+ * and converts all of them in one call: swapping their
+ * byte order, or splitting them into and joining them
+ * from hi/lo Int32Arrays, the JS backend's layout,
+ * converting them to and from Float64Arrays,
+ * taking dot and matrix-vector products,
+ * applying integer math element by element, or
+ * filtering them by a predicate or formatting them
+ * as JSON.
+ */
+
+#include <node.h>
+#include <node_buffer.h>
+#include <nan.h>
+
+#include <inttypes.h>
+#include <mutex>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "core.h"
+#include "cpu.h"
+#include "stats.h"
+#include "n64.h"
+#include "n128.h"
+#include "array.h"
+#include "bulk.h"
+
+#define ARG_ERROR(name, len) ("bulk." #name " requires " #len " argument(s).")
+#define TYPE_ERROR(name, type) ("'" #name "' must be a(n) " #type ".")
+
+/*
+ * Helpers
+ */
+
+bool
+is_buffer(v8::Local<v8::Value> val) {
+  return val->IsArrayBufferView()
+      || val->IsArrayBuffer()
+      || val->IsSharedArrayBuffer()
+      || N64Array::HasInstance(val);
+}
+
+static bool
+is_words(v8::Local<v8::Value> val) {
+  return val->IsInt32Array() || val->IsUint32Array();
+}
+
+static int32_t *
+get_words(v8::Local<v8::Value> val, size_t *len) {
+  size_t size = 0;
+  uint8_t *data = get_buffer(val, &size);
+
+  *len = size / 4;
+
+  return (int32_t *)data;
+}
+
+static bool
+overlaps(const void *a, size_t alen, const void *b, size_t blen) {
+  const uint8_t *x = (const uint8_t *)a;
+  const uint8_t *y = (const uint8_t *)b;
+  return alen > 0 && blen > 0 && x < y + blen && y < x + alen;
+}
+
+static bool
+get_round(v8::Local<v8::Value> val, int *mode) {
+  if (val->IsNull() || val->IsUndefined()) {
+    *mode = N64_STRICT;
+    return true;
+  }
+
+  if (!val->IsUint32())
+    return false;
+
+  uint32_t m = val.As<v8::Uint32>()->Value();
+
+  if (m > ROUND_HALF_EVEN)
+    return false;
+
+  *mode = (int)m;
+
+  return true;
+}
+
+static double *
+get_doubles(v8::Local<v8::Value> val, size_t *len) {
+  size_t size = 0;
+  uint8_t *data = get_buffer(val, &size);
+
+  *len = size / 8;
+
+  return (double *)data;
+}
+
+// Hands the failed indexes to JS.
+v8::Local<v8::Uint32Array>
+indexes(const uint32_t *bad, size_t count) {
+  v8::Isolate *isolate = v8::Isolate::GetCurrent();
+  v8::Local<v8::ArrayBuffer> buf = v8::ArrayBuffer::New(isolate, count * 4);
+
+  if (count > 0) {
+    size_t len = 0;
+    memcpy(get_buffer(buf, &len), bad, count * 4);
+  }
+
+  return v8::Uint32Array::New(buf, 0, count);
+}
+
+// Copies an input which overlaps an output.
+// Returns NULL on allocation failure.
+static void *
+unalias(const void *data, size_t len, void **owned) {
+  void *copy = malloc(len);
+
+  if (copy != NULL)
+    memcpy(copy, data, len);
+
+  *owned = copy;
+
+  return copy;
+}
+
+/*
+ * Bulk
+ */
+
+static NAN_METHOD(bulk_bswap64) {
+  if (info.Length() < 2)
+    return Nan::ThrowError(ARG_ERROR(bswap64, 2));
+
+  if (!is_buffer(info[0]))
+    return Nan::ThrowTypeError(TYPE_ERROR(dst, buffer));
+
+  if (!is_buffer(info[1]))
+    return Nan::ThrowTypeError(TYPE_ERROR(src, buffer));
+
+  size_t dlen = 0;
+  size_t slen = 0;
+  uint8_t *dst = get_buffer(info[0], &dlen);
+  uint8_t *src = get_buffer(info[1], &slen);
+
+  if ((slen & 7) != 0)
+    return Nan::ThrowError("Invalid buffer length.");
+
+  if (dlen < slen)
+    return Nan::ThrowError("Invalid range.");
+
+  if (slen == 0)
+    return;
+
+  // Partially overlapping views swap in place
+  // after a move, like TypedArray#set.
+  if (dst != src && overlaps(dst, slen, src, slen)) {
+    memmove(dst, src, slen);
+    src = dst;
+  }
+
+  n64_bswap64(dst, src, slen / 8);
+}
+
+static NAN_METHOD(bulk_split) {
+  if (info.Length() < 3)
+    return Nan::ThrowError(ARG_ERROR(split, 3));
+
+  if (!is_words(info[0]))
+    return Nan::ThrowTypeError(TYPE_ERROR(hi, int32array));
+
+  if (!is_words(info[1]))
+    return Nan::ThrowTypeError(TYPE_ERROR(lo, int32array));
+
+  if (!is_buffer(info[2]))
+    return Nan::ThrowTypeError(TYPE_ERROR(src, buffer));
+
+  size_t hlen = 0;
+  size_t llen = 0;
+  size_t len = 0;
+  int32_t *hi = get_words(info[0], &hlen);
+  int32_t *lo = get_words(info[1], &llen);
+  const uint8_t *src = get_buffer(info[2], &len);
+  size_t count = len / 8;
+  void *owned = NULL;
+
+  if ((len & 7) != 0)
+    return Nan::ThrowError("Invalid buffer length.");
+
+  if (hlen < count || llen < count)
+    return Nan::ThrowError("Invalid range.");
+
+  if (overlaps(hi, count * 4, lo, count * 4))
+    return Nan::ThrowError("Invalid range.");
+
+  if (overlaps(src, len, hi, count * 4) || overlaps(src, len, lo, count * 4)) {
+    src = (const uint8_t *)unalias(src, len, &owned);
+
+    if (src == NULL)
+      return Nan::ThrowError("Allocation failed.");
+  }
+
+  if (count > 0)
+    n64_split(hi, lo, src, count);
+
+  free(owned);
+
+  info.GetReturnValue().Set(Nan::New<v8::Number>((double)count));
+}
+
+static NAN_METHOD(bulk_join) {
+  if (info.Length() < 3)
+    return Nan::ThrowError(ARG_ERROR(join, 3));
+
+  if (!is_buffer(info[0]))
+    return Nan::ThrowTypeError(TYPE_ERROR(dst, buffer));
+
+  if (!is_words(info[1]))
+    return Nan::ThrowTypeError(TYPE_ERROR(hi, int32array));
+
+  if (!is_words(info[2]))
+    return Nan::ThrowTypeError(TYPE_ERROR(lo, int32array));
+
+  size_t len = 0;
+  size_t hlen = 0;
+  size_t llen = 0;
+  uint8_t *dst = get_buffer(info[0], &len);
+  const int32_t *hi = get_words(info[1], &hlen);
+  const int32_t *lo = get_words(info[2], &llen);
+  void *hcopy = NULL;
+  void *lcopy = NULL;
+
+  if (hlen != llen || len / 8 < hlen)
+    return Nan::ThrowError("Invalid range.");
+
+  if (overlaps(dst, hlen * 8, hi, hlen * 4)) {
+    hi = (const int32_t *)unalias(hi, hlen * 4, &hcopy);
+
+    if (hi == NULL)
+      return Nan::ThrowError("Allocation failed.");
+  }
+
+  if (overlaps(dst, llen * 8, lo, llen * 4)) {
+    lo = (const int32_t *)unalias(lo, llen * 4, &lcopy);
+
+    if (lo == NULL) {
+      free(hcopy);
+      return Nan::ThrowError("Allocation failed.");
+    }
+  }
+
+  if (hlen > 0)
+    n64_join(dst, hi, lo, hlen);
+
+  free(hcopy);
+  free(lcopy);
+
+  info.GetReturnValue().Set(Nan::New<v8::Number>((double)hlen));
+}
+
+/*
+ * Float64
+ */
+
+// The index list is allocated at full size up front.
+// Its pages are only touched for failures, which are
+// expected to be rare.
+
+static NAN_METHOD(bulk_to_float64) {
+  if (info.Length() < 4)
+    return Nan::ThrowError(ARG_ERROR(toFloat64, 4));
+
+  if (!info[0]->IsFloat64Array())
+    return Nan::ThrowTypeError(TYPE_ERROR(dst, float64array));
+
+  if (!is_buffer(info[1]))
+    return Nan::ThrowTypeError(TYPE_ERROR(src, buffer));
+
+  int mode = N64_STRICT;
+
+  if (!get_round(info[3], &mode))
+    return Nan::ThrowTypeError(TYPE_ERROR(mode, rounding mode));
+
+  int sign = Nan::To<bool>(info[2]).FromJust();
+  size_t dlen = 0;
+  size_t len = 0;
+  double *dst = get_doubles(info[0], &dlen);
+  const uint8_t *src = get_buffer(info[1], &len);
+  size_t count = len / 8;
+  void *owned = NULL;
+
+  if ((len & 7) != 0)
+    return Nan::ThrowError("Invalid buffer length.");
+
+  if (dlen < count)
+    return Nan::ThrowError("Invalid range.");
+
+  if (count > 0xffffffff)
+    return Nan::ThrowError("Array length exceeds limit.");
+
+  // Converting in place is fine; a partial overlap
+  // is not.
+  if ((const void *)dst != (const void *)src
+      && overlaps(dst, count * 8, src, len)) {
+    src = (const uint8_t *)unalias(src, len, &owned);
+
+    if (src == NULL)
+      return Nan::ThrowError("Allocation failed.");
+  }
+
+  uint32_t *bad = (uint32_t *)malloc(count * 4 + 1);
+
+  if (bad == NULL) {
+    free(owned);
+    return Nan::ThrowError("Allocation failed.");
+  }
+
+  size_t fails = n64_to_float64(dst, src, count, sign, mode, bad);
+
+  free(owned);
+
+  v8::Local<v8::Uint32Array> ret = indexes(bad, fails);
+
+  free(bad);
+
+  info.GetReturnValue().Set(ret);
+}
+
+static NAN_METHOD(bulk_from_float64) {
+  if (info.Length() < 4)
+    return Nan::ThrowError(ARG_ERROR(fromFloat64, 4));
+
+  if (!is_buffer(info[0]))
+    return Nan::ThrowTypeError(TYPE_ERROR(dst, buffer));
+
+  if (!info[1]->IsFloat64Array())
+    return Nan::ThrowTypeError(TYPE_ERROR(src, float64array));
+
+  int mode = N64_STRICT;
+
+  if (!get_round(info[3], &mode))
+    return Nan::ThrowTypeError(TYPE_ERROR(mode, rounding mode));
+
+  int sign = Nan::To<bool>(info[2]).FromJust();
+  size_t len = 0;
+  size_t count = 0;
+  uint8_t *dst = get_buffer(info[0], &len);
+  const double *src = get_doubles(info[1], &count);
+  void *owned = NULL;
+
+  if (len / 8 < count)
+    return Nan::ThrowError("Invalid range.");
+
+  if (count > 0xffffffff)
+    return Nan::ThrowError("Array length exceeds limit.");
+
+  if ((const void *)dst != (const void *)src
+      && overlaps(dst, count * 8, src, count * 8)) {
+    src = (const double *)unalias(src, count * 8, &owned);
+
+    if (src == NULL)
+      return Nan::ThrowError("Allocation failed.");
+  }
+
+  uint32_t *bad = (uint32_t *)malloc(count * 4 + 1);
+
+  if (bad == NULL) {
+    free(owned);
+    return Nan::ThrowError("Allocation failed.");
+  }
+
+  size_t fails = n64_from_float64(dst, src, count, sign, mode, bad);
+
+  free(owned);
+
+  v8::Local<v8::Uint32Array> ret = indexes(bad, fails);
+
+  free(bad);
+
+  info.GetReturnValue().Set(ret);
+}
+
+/*
+ * Linear algebra
+ */
+
+static bool
+get_alpha(v8::Local<v8::Value> val, uint64_t *r) {
+  if (val->IsNumber()) {
+    double num = val.As<v8::Number>()->Value();
+
+    if (!(num >= -9223372036854775808.0 && num < 9223372036854775808.0))
+      return false;
+
+    *r = (uint64_t)(int64_t)num;
+
+    return true;
+  }
+
+  if (N64::HasInstance(val)) {
+    *r = *Nan::ObjectWrap::Unwrap<N64>(val.As<v8::Object>())->n;
+    return true;
+  }
+
+  return false;
+}
+
+static NAN_METHOD(bulk_dot) {
+  if (info.Length() < 4)
+    return Nan::ThrowError(ARG_ERROR(dot, 4));
+
+  if (!is_buffer(info[0]))
+    return Nan::ThrowTypeError(TYPE_ERROR(a, buffer));
+
+  if (!is_buffer(info[1]))
+    return Nan::ThrowTypeError(TYPE_ERROR(b, buffer));
+
+  if (!N128::HasInstance(info[3]))
+    return Nan::ThrowTypeError(TYPE_ERROR(out, int128));
+
+  int sign = Nan::To<bool>(info[2]).FromJust();
+  N128 *out = Nan::ObjectWrap::Unwrap<N128>(info[3].As<v8::Object>());
+  size_t alen = 0;
+  size_t blen = 0;
+  const uint8_t *a = get_buffer(info[0], &alen);
+  const uint8_t *b = get_buffer(info[1], &blen);
+
+  if ((alen & 7) != 0 || (blen & 7) != 0)
+    return Nan::ThrowError("Invalid buffer length.");
+
+  if (alen != blen)
+    return Nan::ThrowError("Invalid range.");
+
+  int ok = n64_dot(&out->n, a, b, alen / 8, sign);
+
+  info.GetReturnValue().Set(Nan::New<v8::Boolean>(ok != 0));
+}
+
+static NAN_METHOD(bulk_axpy) {
+  if (info.Length() < 4)
+    return Nan::ThrowError(ARG_ERROR(axpy, 4));
+
+  if (!is_buffer(info[0]))
+    return Nan::ThrowTypeError(TYPE_ERROR(dst, buffer));
+
+  uint64_t alpha = 0;
+
+  if (!get_alpha(info[1], &alpha))
+    return Nan::ThrowTypeError(TYPE_ERROR(alpha, int64));
+
+  if (!is_buffer(info[2]))
+    return Nan::ThrowTypeError(TYPE_ERROR(x, buffer));
+
+  int sign = Nan::To<bool>(info[3]).FromJust();
+  size_t dlen = 0;
+  size_t len = 0;
+  uint8_t *dst = get_buffer(info[0], &dlen);
+  const uint8_t *x = get_buffer(info[2], &len);
+  size_t count = len / 8;
+  void *owned = NULL;
+
+  if ((len & 7) != 0)
+    return Nan::ThrowError("Invalid buffer length.");
+
+  if (dlen < len)
+    return Nan::ThrowError("Invalid range.");
+
+  if (count > 0xffffffff)
+    return Nan::ThrowError("Array length exceeds limit.");
+
+  // Each word is read before it is written,
+  // so only a partial overlap needs a copy.
+  if ((const void *)dst != (const void *)x && overlaps(dst, len, x, len)) {
+    x = (const uint8_t *)unalias(x, len, &owned);
+
+    if (x == NULL)
+      return Nan::ThrowError("Allocation failed.");
+  }
+
+  uint32_t *bad = (uint32_t *)malloc(count * 4 + 1);
+
+  if (bad == NULL) {
+    free(owned);
+    return Nan::ThrowError("Allocation failed.");
+  }
+
+  size_t fails = n64_axpy(dst, alpha, x, count, sign, bad);
+
+  free(owned);
+
+  v8::Local<v8::Uint32Array> ret = indexes(bad, fails);
+
+  free(bad);
+
+  info.GetReturnValue().Set(ret);
+}
+
+static NAN_METHOD(bulk_matvec) {
+  if (info.Length() < 4)
+    return Nan::ThrowError(ARG_ERROR(matvec, 4));
+
+  if (!is_buffer(info[0]))
+    return Nan::ThrowTypeError(TYPE_ERROR(dst, buffer));
+
+  if (!is_buffer(info[1]))
+    return Nan::ThrowTypeError(TYPE_ERROR(m, buffer));
+
+  if (!is_buffer(info[2]))
+    return Nan::ThrowTypeError(TYPE_ERROR(x, buffer));
+
+  int sign = Nan::To<bool>(info[3]).FromJust();
+  size_t dlen = 0;
+  size_t mlen = 0;
+  size_t xlen = 0;
+  uint8_t *dst = get_buffer(info[0], &dlen);
+  const uint8_t *m = get_buffer(info[1], &mlen);
+  const uint8_t *x = get_buffer(info[2], &xlen);
+  size_t cols = xlen / 8;
+  void *mcopy = NULL;
+  void *xcopy = NULL;
+
+  if ((mlen & 7) != 0 || (xlen & 7) != 0)
+    return Nan::ThrowError("Invalid buffer length.");
+
+  if (cols == 0 || (mlen / 8) % cols != 0)
+    return Nan::ThrowError("Invalid buffer length.");
+
+  size_t rows = mlen / 8 / cols;
+
+  if (dlen / 8 < rows)
+    return Nan::ThrowError("Invalid range.");
+
+  if (rows > 0xffffffff)
+    return Nan::ThrowError("Array length exceeds limit.");
+
+  // Rows are read after earlier results are
+  // written, so any overlap needs a copy.
+  if (overlaps(dst, rows * 8, m, mlen)) {
+    m = (const uint8_t *)unalias(m, mlen, &mcopy);
+
+    if (m == NULL)
+      return Nan::ThrowError("Allocation failed.");
+  }
+
+  if (overlaps(dst, rows * 8, x, xlen)) {
+    x = (const uint8_t *)unalias(x, xlen, &xcopy);
+
+    if (x == NULL) {
+      free(mcopy);
+      return Nan::ThrowError("Allocation failed.");
+    }
+  }
+
+  uint32_t *bad = (uint32_t *)malloc(rows * 4 + 1);
+
+  if (bad == NULL) {
+    free(mcopy);
+    free(xcopy);
+    return Nan::ThrowError("Allocation failed.");
+  }
+
+  size_t fails = n64_matvec(dst, m, x, rows, cols, sign, bad);
+
+  free(mcopy);
+  free(xcopy);
+
+  v8::Local<v8::Uint32Array> ret = indexes(bad, fails);
+
+  free(bad);
+
+  info.GetReturnValue().Set(ret);
+}
+
+static bool
+get_op(v8::Local<v8::Value> val, int lo, int hi, int *op) {
+  if (!val->IsUint32())
+    return false;
+
+  uint32_t n = val.As<v8::Uint32>()->Value();
+
+  if (n < (uint32_t)lo || n > (uint32_t)hi)
+    return false;
+
+  *op = (int)n;
+
+  return true;
+}
+
+// Every element is read before its output is
+// written, so only a partial overlap needs a copy.
+static bool
+prepare(const uint8_t *dst, size_t dlen,
+        const uint8_t **src, size_t len, void **owned) {
+  *owned = NULL;
+
+  if ((const void *)dst == (const void *)*src)
+    return true;
+
+  if (!overlaps(dst, dlen, *src, len))
+    return true;
+
+  *src = (const uint8_t *)unalias(*src, len, owned);
+
+  return *src != NULL;
+}
+
+static NAN_METHOD(bulk_unary) {
+  if (info.Length() < 4)
+    return Nan::ThrowError(ARG_ERROR(unary, 4));
+
+  int op = 0;
+
+  if (!get_op(info[0], N64_MATH_SQRT, N64_MATH_NEXT_POW2, &op))
+    return Nan::ThrowTypeError(TYPE_ERROR(op, integer));
+
+  if (!is_buffer(info[1]))
+    return Nan::ThrowTypeError(TYPE_ERROR(dst, buffer));
+
+  if (!is_buffer(info[2]))
+    return Nan::ThrowTypeError(TYPE_ERROR(src, buffer));
+
+  int sign = Nan::To<bool>(info[3]).FromJust();
+  size_t dlen = 0;
+  size_t len = 0;
+  uint8_t *dst = get_buffer(info[1], &dlen);
+  const uint8_t *src = get_buffer(info[2], &len);
+  size_t count = len / 8;
+  void *owned = NULL;
+
+  if ((len & 7) != 0)
+    return Nan::ThrowError("Invalid buffer length.");
+
+  if (dlen < len)
+    return Nan::ThrowError("Invalid range.");
+
+  if (count > 0xffffffff)
+    return Nan::ThrowError("Array length exceeds limit.");
+
+  if (!prepare(dst, len, &src, len, &owned))
+    return Nan::ThrowError("Allocation failed.");
+
+  uint32_t *bad = (uint32_t *)malloc(count * 4 + 1);
+
+  if (bad == NULL) {
+    free(owned);
+    return Nan::ThrowError("Allocation failed.");
+  }
+
+  size_t fails = n64_math_unary(op, dst, src, count, sign, bad);
+
+  free(owned);
+
+  v8::Local<v8::Uint32Array> ret = indexes(bad, fails);
+
+  free(bad);
+
+  info.GetReturnValue().Set(ret);
+}
+
+static NAN_METHOD(bulk_log) {
+  if (info.Length() < 4)
+    return Nan::ThrowError(ARG_ERROR(log, 4));
+
+  int op = 0;
+
+  if (!get_op(info[0], N64_MATH_LOG2, N64_MATH_LOG10, &op))
+    return Nan::ThrowTypeError(TYPE_ERROR(op, integer));
+
+  if (!is_words(info[1]))
+    return Nan::ThrowTypeError(TYPE_ERROR(dst, int32array));
+
+  if (!is_buffer(info[2]))
+    return Nan::ThrowTypeError(TYPE_ERROR(src, buffer));
+
+  int sign = Nan::To<bool>(info[3]).FromJust();
+  size_t dlen = 0;
+  size_t len = 0;
+  int32_t *dst = get_words(info[1], &dlen);
+  const uint8_t *src = get_buffer(info[2], &len);
+  size_t count = len / 8;
+  void *owned = NULL;
+
+  if ((len & 7) != 0)
+    return Nan::ThrowError("Invalid buffer length.");
+
+  if (dlen < count)
+    return Nan::ThrowError("Invalid range.");
+
+  if (count > 0xffffffff)
+    return Nan::ThrowError("Array length exceeds limit.");
+
+  // The output is half the width of
+  // the input, so any overlap is copied.
+  if (overlaps(dst, count * 4, src, len)) {
+    src = (const uint8_t *)unalias(src, len, &owned);
+
+    if (src == NULL)
+      return Nan::ThrowError("Allocation failed.");
+  }
+
+  uint32_t *bad = (uint32_t *)malloc(count * 4 + 1);
+
+  if (bad == NULL) {
+    free(owned);
+    return Nan::ThrowError("Allocation failed.");
+  }
+
+  size_t fails = n64_math_log(op, dst, src, count, sign, bad);
+
+  free(owned);
+
+  v8::Local<v8::Uint32Array> ret = indexes(bad, fails);
+
+  free(bad);
+
+  info.GetReturnValue().Set(ret);
+}
+
+static NAN_METHOD(bulk_binary) {
+  if (info.Length() < 5)
+    return Nan::ThrowError(ARG_ERROR(binary, 5));
+
+  int op = 0;
+
+  if (!get_op(info[0], N64_MATH_GCD, N64_MATH_LCM, &op))
+    return Nan::ThrowTypeError(TYPE_ERROR(op, integer));
+
+  if (!is_buffer(info[1]))
+    return Nan::ThrowTypeError(TYPE_ERROR(dst, buffer));
+
+  if (!is_buffer(info[2]))
+    return Nan::ThrowTypeError(TYPE_ERROR(a, buffer));
+
+  if (!is_buffer(info[3]))
+    return Nan::ThrowTypeError(TYPE_ERROR(b, buffer));
+
+  int sign = Nan::To<bool>(info[4]).FromJust();
+  size_t dlen = 0;
+  size_t alen = 0;
+  size_t blen = 0;
+  uint8_t *dst = get_buffer(info[1], &dlen);
+  const uint8_t *a = get_buffer(info[2], &alen);
+  const uint8_t *b = get_buffer(info[3], &blen);
+  size_t count = alen / 8;
+  void *acopy = NULL;
+  void *bcopy = NULL;
+
+  if ((alen & 7) != 0 || (blen & 7) != 0)
+    return Nan::ThrowError("Invalid buffer length.");
+
+  if (blen != alen || dlen < alen)
+    return Nan::ThrowError("Invalid range.");
+
+  if (count > 0xffffffff)
+    return Nan::ThrowError("Array length exceeds limit.");
+
+  if (!prepare(dst, alen, &a, alen, &acopy))
+    return Nan::ThrowError("Allocation failed.");
+
+  if (!prepare(dst, alen, &b, blen, &bcopy)) {
+    free(acopy);
+    return Nan::ThrowError("Allocation failed.");
+  }
+
+  uint32_t *bad = (uint32_t *)malloc(count * 4 + 1);
+
+  if (bad == NULL) {
+    free(acopy);
+    free(bcopy);
+    return Nan::ThrowError("Allocation failed.");
+  }
+
+  size_t fails = n64_math_binary(op, dst, a, b, count, sign, bad);
+
+  free(acopy);
+  free(bcopy);
+
+  v8::Local<v8::Uint32Array> ret = indexes(bad, fails);
+
+  free(bad);
+
+  info.GetReturnValue().Set(ret);
+}
+
+static NAN_METHOD(bulk_divmod) {
+  if (info.Length() < 5)
+    return Nan::ThrowError(ARG_ERROR(divmod, 5));
+
+  if (!is_buffer(info[0]))
+    return Nan::ThrowTypeError(TYPE_ERROR(q, buffer));
+
+  if (!is_buffer(info[1]))
+    return Nan::ThrowTypeError(TYPE_ERROR(r, buffer));
+
+  if (!is_buffer(info[2]))
+    return Nan::ThrowTypeError(TYPE_ERROR(a, buffer));
+
+  if (!is_buffer(info[3]))
+    return Nan::ThrowTypeError(TYPE_ERROR(b, buffer));
+
+  int sign = Nan::To<bool>(info[4]).FromJust();
+  size_t qlen = 0;
+  size_t rlen = 0;
+  size_t alen = 0;
+  size_t blen = 0;
+  uint8_t *q = get_buffer(info[0], &qlen);
+  uint8_t *r = get_buffer(info[1], &rlen);
+  const uint8_t *a = get_buffer(info[2], &alen);
+  const uint8_t *b = get_buffer(info[3], &blen);
+  size_t count = alen / 8;
+  void *acopy = NULL;
+  void *bcopy = NULL;
+
+  if ((alen & 7) != 0 || (blen & 7) != 0)
+    return Nan::ThrowError("Invalid buffer length.");
+
+  if (blen != alen || qlen < alen || rlen < alen)
+    return Nan::ThrowError("Invalid range.");
+
+  if (overlaps(q, alen, r, alen))
+    return Nan::ThrowError("Invalid range.");
+
+  if (count > 0xffffffff)
+    return Nan::ThrowError("Array length exceeds limit.");
+
+  // Both outputs are written after both inputs
+  // are read, so only partial overlaps are copied.
+  if ((a != q && overlaps(q, alen, a, alen))
+      || (a != r && overlaps(r, alen, a, alen))) {
+    a = (const uint8_t *)unalias(a, alen, &acopy);
+
+    if (a == NULL)
+      return Nan::ThrowError("Allocation failed.");
+  }
+
+  if ((b != q && overlaps(q, alen, b, blen))
+      || (b != r && overlaps(r, alen, b, blen))) {
+    b = (const uint8_t *)unalias(b, blen, &bcopy);
+
+    if (b == NULL) {
+      free(acopy);
+      return Nan::ThrowError("Allocation failed.");
+    }
+  }
+
+  uint32_t *bad = (uint32_t *)malloc(count * 4 + 1);
+
+  if (bad == NULL) {
+    free(acopy);
+    free(bcopy);
+    return Nan::ThrowError("Allocation failed.");
+  }
+
+  size_t fails = n64_divmod_many(q, r, a, b, count, sign, bad);
+
+  free(acopy);
+  free(bcopy);
+
+  v8::Local<v8::Uint32Array> ret = indexes(bad, fails);
+
+  free(bad);
+
+  info.GetReturnValue().Set(ret);
+}
+
+/*
+ * Filtering
+ */
+
+static bool
+is_selection(v8::Local<v8::Value> val) {
+  return val->IsUint8Array() || val->IsUint32Array();
+}
+
+// Reads the operands of a predicate, throwing on failure.
+// For IN, `*owned` receives the copy of the set.
+static bool
+get_where(n64_where_t *w, int op, v8::Local<v8::Value> a,
+          v8::Local<v8::Value> b, int sign, uint64_t **owned) {
+  *owned = NULL;
+
+  if (op == N64_WHERE_IN) {
+    static const n64_field_t word = { 0, 8, 0, 0 };
+    size_t len = 0;
+    uint64_t *set = NULL;
+
+    if (a->IsArray()) {
+      v8::Local<v8::Array> items = a.As<v8::Array>();
+
+      len = items->Length();
+      set = (uint64_t *)malloc(len * 8 + 1);
+
+      if (set == NULL) {
+        Nan::ThrowError("Allocation failed.");
+        return false;
+      }
+
+      for (size_t i = 0; i < len; i++) {
+        v8::Local<v8::Value> item = Nan::Get(items, i).ToLocalChecked();
+
+        if (!get_alpha(item, &set[i])) {
+          free(set);
+          Nan::ThrowTypeError(TYPE_ERROR(value, int64));
+          return false;
+        }
+      }
+    } else if (is_buffer(a)) {
+      size_t size = 0;
+      const uint8_t *data = get_buffer(a, &size);
+
+      if ((size & 7) != 0) {
+        Nan::ThrowError("Invalid buffer length.");
+        return false;
+      }
+
+      len = size / 8;
+      set = (uint64_t *)malloc(size + 1);
+
+      if (set == NULL) {
+        Nan::ThrowError("Allocation failed.");
+        return false;
+      }
+
+      for (size_t i = 0; i < len; i++)
+        set[i] = n64_field_read(data + i * 8, &word);
+    } else {
+      Nan::ThrowTypeError(TYPE_ERROR(values, array));
+      return false;
+    }
+
+    n64_where_set(w, set, len, sign);
+
+    *owned = set;
+
+    return true;
+  }
+
+  uint64_t x = 0;
+  uint64_t y = 0;
+
+  if (!get_alpha(a, &x)) {
+    Nan::ThrowTypeError(TYPE_ERROR(value, int64));
+    return false;
+  }
+
+  if (op == N64_WHERE_BETWEEN && !get_alpha(b, &y)) {
+    Nan::ThrowTypeError(TYPE_ERROR(value, int64));
+    return false;
+  }
+
+  n64_where_init(w, op, x, y, sign);
+
+  return true;
+}
+
+static NAN_METHOD(bulk_where) {
+  if (info.Length() < 6)
+    return Nan::ThrowError(ARG_ERROR(where, 6));
+
+  if (!is_selection(info[0]))
+    return Nan::ThrowTypeError(TYPE_ERROR(out, selection));
+
+  if (!is_buffer(info[1]))
+    return Nan::ThrowTypeError(TYPE_ERROR(src, buffer));
+
+  int op = 0;
+
+  if (!get_op(info[2], N64_WHERE_EQ, N64_WHERE_IN, &op))
+    return Nan::ThrowTypeError(TYPE_ERROR(op, integer));
+
+  int sign = Nan::To<bool>(info[5]).FromJust();
+  bool bitmap = info[0]->IsUint8Array();
+  size_t olen = 0;
+  size_t len = 0;
+  uint8_t *out = get_buffer(info[0], &olen);
+  const uint8_t *src = get_buffer(info[1], &len);
+  size_t count = len / 8;
+  n64_where_t w;
+  uint64_t *set = NULL;
+  void *owned = NULL;
+
+  if (!get_where(&w, op, info[3], info[4], sign, &set))
+    return;
+
+  if ((len & 7) != 0) {
+    free(set);
+    return Nan::ThrowError("Invalid buffer length.");
+  }
+
+  if (bitmap ? olen < (count + 7) / 8 : olen / 4 < count) {
+    free(set);
+    return Nan::ThrowError("Invalid range.");
+  }
+
+  if (count > 0xffffffff) {
+    free(set);
+    return Nan::ThrowError("Array length exceeds limit.");
+  }
+
+  // Words are read in blocks ahead of
+  // the output, so any overlap is copied.
+  if (overlaps(out, olen, src, len)) {
+    src = (const uint8_t *)unalias(src, len, &owned);
+
+    if (src == NULL) {
+      free(set);
+      return Nan::ThrowError("Allocation failed.");
+    }
+  }
+
+  size_t n = 0;
+
+  if (bitmap) {
+    n64_where_bits(out, src, count, &w);
+    n = n64_bits_count(out, count);
+  } else {
+    n = n64_where_select((uint32_t *)out, src, count, &w);
+  }
+
+  free(owned);
+  free(set);
+
+  info.GetReturnValue().Set(Nan::New<v8::Number>((double)n));
+}
+
+static NAN_METHOD(bulk_count_where) {
+  if (info.Length() < 5)
+    return Nan::ThrowError(ARG_ERROR(countWhere, 5));
+
+  if (!is_buffer(info[0]))
+    return Nan::ThrowTypeError(TYPE_ERROR(src, buffer));
+
+  int op = 0;
+
+  if (!get_op(info[1], N64_WHERE_EQ, N64_WHERE_IN, &op))
+    return Nan::ThrowTypeError(TYPE_ERROR(op, integer));
+
+  int sign = Nan::To<bool>(info[4]).FromJust();
+  size_t len = 0;
+  const uint8_t *src = get_buffer(info[0], &len);
+  n64_where_t w;
+  uint64_t *set = NULL;
+
+  if (!get_where(&w, op, info[2], info[3], sign, &set))
+    return;
+
+  if ((len & 7) != 0) {
+    free(set);
+    return Nan::ThrowError("Invalid buffer length.");
+  }
+
+  size_t n = n64_where_count(src, len / 8, &w);
+
+  free(set);
+
+  info.GetReturnValue().Set(Nan::New<v8::Number>((double)n));
+}
+
+static NAN_METHOD(bulk_compact) {
+  if (info.Length() < 3)
+    return Nan::ThrowError(ARG_ERROR(compact, 3));
+
+  if (!is_buffer(info[0]))
+    return Nan::ThrowTypeError(TYPE_ERROR(dst, buffer));
+
+  if (!is_buffer(info[1]))
+    return Nan::ThrowTypeError(TYPE_ERROR(src, buffer));
+
+  if (!is_selection(info[2]))
+    return Nan::ThrowTypeError(TYPE_ERROR(selection, selection));
+
+  bool bitmap = info[2]->IsUint8Array();
+  size_t dlen = 0;
+  size_t len = 0;
+  size_t slen = 0;
+  uint8_t *dst = get_buffer(info[0], &dlen);
+  const uint8_t *src = get_buffer(info[1], &len);
+  const uint8_t *sel = get_buffer(info[2], &slen);
+  size_t count = len / 8;
+  void *scopy = NULL;
+  void *owned = NULL;
+
+  if ((len & 7) != 0)
+    return Nan::ThrowError("Invalid buffer length.");
+
+  if (bitmap) {
+    if (slen < (count + 7) / 8)
+      return Nan::ThrowError("Invalid range.");
+
+    size_t n = n64_bits_count(sel, count);
+
+    if (dlen < n * 8)
+      return Nan::ThrowError("Invalid range.");
+
+    if (overlaps(dst, n * 8, sel, slen)) {
+      sel = (const uint8_t *)unalias(sel, slen, &scopy);
+
+      if (sel == NULL)
+        return Nan::ThrowError("Allocation failed.");
+    }
+
+    // Words only move toward the front, so
+    // compacting in place needs no copy.
+    if (dst != src && overlaps(dst, n * 8, src, len)) {
+      src = (const uint8_t *)unalias(src, len, &owned);
+
+      if (src == NULL) {
+        free(scopy);
+        return Nan::ThrowError("Allocation failed.");
+      }
+    }
+
+    n64_compact_bits(dst, src, count, sel);
+
+    free(scopy);
+    free(owned);
+
+    info.GetReturnValue().Set(Nan::New<v8::Number>((double)n));
+
+    return;
+  }
+
+  size_t n = slen / 4;
+
+  if (dlen < n * 8)
+    return Nan::ThrowError("Invalid range.");
+
+  // Indexes may point anywhere, so
+  // any overlap is copied.
+  if (overlaps(dst, n * 8, sel, slen)) {
+    sel = (const uint8_t *)unalias(sel, slen, &scopy);
+
+    if (sel == NULL)
+      return Nan::ThrowError("Allocation failed.");
+  }
+
+  if (overlaps(dst, n * 8, src, len)) {
+    src = (const uint8_t *)unalias(src, len, &owned);
+
+    if (src == NULL) {
+      free(scopy);
+      return Nan::ThrowError("Allocation failed.");
+    }
+  }
+
+  int ok = n64_compact_select(dst, src, count, (const uint32_t *)sel, n);
+
+  free(scopy);
+  free(owned);
+
+  if (!ok)
+    return Nan::ThrowError("Invalid range.");
+
+  info.GetReturnValue().Set(Nan::New<v8::Number>((double)n));
+}
+
+/*
+ * JSON
+ */
+
+// The whole array is formatted into one allocation
+// which the returned buffer takes over.
+static NAN_METHOD(bulk_serialize_json) {
+  if (info.Length() < 5)
+    return Nan::ThrowError(ARG_ERROR(serializeJSON, 5));
+
+  if (!is_buffer(info[0]))
+    return Nan::ThrowTypeError(TYPE_ERROR(data, buffer));
+
+  if (!info[2]->IsUint32())
+    return Nan::ThrowTypeError(TYPE_ERROR(base, integer));
+
+  if (!info[3]->IsUint32())
+    return Nan::ThrowTypeError(TYPE_ERROR(pad, integer));
+
+  int sign = Nan::To<bool>(info[1]).FromJust();
+  uint32_t base = Nan::To<uint32_t>(info[2]).FromJust();
+  uint32_t pad = Nan::To<uint32_t>(info[3]).FromJust();
+  int quoted = Nan::To<bool>(info[4]).FromJust();
+  size_t len = 0;
+  const uint8_t *src = get_buffer(info[0], &len);
+
+  if (!n64_is_base(base))
+    return Nan::ThrowError("Base ranges between 2 and 16.");
+
+  if (pad > 64)
+    return Nan::ThrowError("Maximum padding is 64 characters.");
+
+  if ((len & 7) != 0)
+    return Nan::ThrowError("Invalid buffer length.");
+
+  size_t count = len / 8;
+  size_t width = n64_json_size(1, base, pad) - 3;
+
+  if (count > (node::Buffer::kMaxLength - 3) / width)
+    return Nan::ThrowError("Array length exceeds limit.");
+
+  char *data = (char *)malloc(n64_json_size(count, base, pad));
+
+  if (data == NULL)
+    return Nan::ThrowError("Allocation failed.");
+
+  size_t size = n64_json_write(data, src, count, sign, base, pad, quoted);
+  char *shrunk = (char *)realloc(data, size);
+
+  if (shrunk != NULL)
+    data = shrunk;
+
+  info.GetReturnValue().Set(Nan::NewBuffer(data, size).ToLocalChecked());
+}
+
+/*
+ * CPU
+ */
+
+static std::once_flag cpu_once;
+
+static void
+cpu_configure(void) {
+  // Forces the scalar kernels, to test them
+  // on machines which would not pick them.
+  const char *env = getenv("N64_FORCE_SCALAR");
+  n64_cpu_init(env != NULL && env[0] != '\0' && strcmp(env, "0") != 0);
+}
+
+static NAN_METHOD(bulk_cpu_features) {
+  static const struct {
+    unsigned bit;
+    const char *name;
+  } names[] = {
+    { N64_CPU_SSE2, "sse2" },
+    { N64_CPU_SSSE3, "ssse3" },
+    { N64_CPU_SSE41, "sse4.1" },
+    { N64_CPU_POPCNT, "popcnt" },
+    { N64_CPU_AVX2, "avx2" },
+    { N64_CPU_BMI2, "bmi2" },
+    { N64_CPU_AVX512, "avx512" },
+    { N64_CPU_NEON, "neon" }
+  };
+
+  const n64_cpu_t *cpu = n64_cpu();
+  v8::Local<v8::Object> ret = Nan::New<v8::Object>();
+  v8::Local<v8::Array> features = Nan::New<v8::Array>();
+  v8::Local<v8::Object> kernels = Nan::New<v8::Object>();
+  uint32_t count = 0;
+
+  for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+    if (cpu->features & names[i].bit)
+      Nan::Set(features, count++, Nan::New(names[i].name).ToLocalChecked());
+  }
+
+  Nan::Set(kernels, Nan::New("bswap64").ToLocalChecked(),
+           Nan::New(cpu->bswap64).ToLocalChecked());
+  Nan::Set(kernels, Nan::New("split").ToLocalChecked(),
+           Nan::New(cpu->split).ToLocalChecked());
+  Nan::Set(kernels, Nan::New("join").ToLocalChecked(),
+           Nan::New(cpu->join).ToLocalChecked());
+  Nan::Set(kernels, Nan::New("toFloat64").ToLocalChecked(),
+           Nan::New(cpu->to_float64).ToLocalChecked());
+  Nan::Set(kernels, Nan::New("format").ToLocalChecked(),
+           Nan::New(cpu->format).ToLocalChecked());
+  Nan::Set(kernels, Nan::New("where").ToLocalChecked(),
+           Nan::New(cpu->where).ToLocalChecked());
+
+  Nan::Set(ret, Nan::New("path").ToLocalChecked(),
+           Nan::New(cpu->path).ToLocalChecked());
+  Nan::Set(ret, Nan::New("scalar").ToLocalChecked(),
+           Nan::New<v8::Boolean>(cpu->scalar != 0));
+  Nan::Set(ret, Nan::New("features").ToLocalChecked(), features);
+  Nan::Set(ret, Nan::New("kernels").ToLocalChecked(), kernels);
+
+  info.GetReturnValue().Set(ret);
+}
+
+/*
+ * Init
+ */
+
+void
+bulk_init(v8::Local<v8::Object> &target) {
+  v8::Local<v8::Object> bulk = Nan::New<v8::Object>();
+
+  // Workers load the module again; the
+  // selection is made once per process.
+  std::call_once(cpu_once, cpu_configure);
+
+  stats_function(bulk, "bulk", "bswap64", bulk_bswap64);
+  stats_function(bulk, "bulk", "split", bulk_split);
+  stats_function(bulk, "bulk", "join", bulk_join);
+  stats_function(bulk, "bulk", "toFloat64", bulk_to_float64);
+  stats_function(bulk, "bulk", "fromFloat64", bulk_from_float64);
+  stats_function(bulk, "bulk", "dot", bulk_dot);
+  stats_function(bulk, "bulk", "axpy", bulk_axpy);
+  stats_function(bulk, "bulk", "matvec", bulk_matvec);
+  stats_function(bulk, "bulk", "unary", bulk_unary);
+  stats_function(bulk, "bulk", "log", bulk_log);
+  stats_function(bulk, "bulk", "binary", bulk_binary);
+  stats_function(bulk, "bulk", "divmod", bulk_divmod);
+  stats_function(bulk, "bulk", "where", bulk_where);
+  stats_function(bulk, "bulk", "countWhere", bulk_count_where);
+  stats_function(bulk, "bulk", "compact", bulk_compact);
+  stats_function(bulk, "bulk", "serializeJSON", bulk_serialize_json);
+
+  Nan::Set(target, Nan::New("bulk").ToLocalChecked(), bulk);
+  Nan::SetMethod(target, "cpuFeatures", bulk_cpu_features);
+}
@@ -0,0 +1,25 @@
+/**
+ * bulk.h - bulk conversions over buffers for n64.
+ * Copyright (c) 2017, Christopher Jeffrey (MIT License)
+ */
+
+#ifndef _N64_BULK_H
+#define _N64_BULK_H
+
+#include <node.h>
+#include <nan.h>
+#include <inttypes.h>
+#include <stddef.h>
+
+// Typed arrays, array buffers and N64Arrays.
+bool
+is_buffer(v8::Local<v8::Value> val);
+
+// Copies failed element indexes into a Uint32Array.
+v8::Local<v8::Uint32Array>
+indexes(const uint32_t *bad, size_t count);
+
+void
+bulk_init(v8::Local<v8::Object> &target);
+
+#endif
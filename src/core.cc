@@ -0,0 +1,3483 @@
+/**
+ * core.cc - int64 kernels for n64.
+ * Copyright (c) 2017, Christopher Jeffrey (MIT License)
+ */
+
+#include <assert.h>
+#include <inttypes.h>
+#include <limits.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "core.h"
+#include "cpu.h"
+
+#if defined(N64_SSE2)
+#include <emmintrin.h>
+#endif
+
+#if defined(N64_HAVE_SSSE3)
+#include <tmmintrin.h>
+#endif
+
+#if defined(N64_HAVE_AVX2) || defined(N64_HAVE_AVX512) \
+    || defined(N64_HAVE_BMI2)
+#include <immintrin.h>
+#endif
+
+#if defined(N64_NEON)
+#include <arm_neon.h>
+#endif
+
+/*
+ * N64
+ */
+
+uint64_t
+n64_pow(uint64_t x, uint32_t y) {
+  uint64_t r = 1;
+
+  if (x == 0)
+    return 0;
+
+  while (y > 0) {
+    if (y & 1)
+      r *= x;
+    y >>= 1;
+    x *= x;
+  }
+
+  return r;
+}
+
+// Fixed width hex and binary digits. The BMI2
+// versions deposit nibbles (or bits) into bytes
+// eight at a time and convert them to ASCII as a
+// single word.
+
+static const char n64_hex_chars[] = "0123456789abcdef";
+
+void
+n64_hex16_scalar(char *out, uint64_t n) {
+  for (int i = 15; i >= 0; i--) {
+    out[i] = n64_hex_chars[n & 15];
+    n >>= 4;
+  }
+}
+
+void
+n64_bin64_scalar(char *out, uint64_t n) {
+  for (int i = 63; i >= 0; i--) {
+    out[i] = '0' + (char)(n & 1);
+    n >>= 1;
+  }
+}
+
+#if defined(N64_HAVE_BMI2)
+static inline uint64_t
+hex_ascii(uint64_t x) {
+  // Bytes of 10 and up carry into bit 4 when 6 is
+  // added, and move on from '9' + 1 to 'a'.
+  uint64_t alpha = ((x + 0x0606060606060606ull) >> 4) & 0x0101010101010101ull;
+  return x + 0x3030303030303030ull + alpha * ('a' - '0' - 10);
+}
+
+N64_TARGET("bmi2") void
+n64_hex16_bmi2(char *out, uint64_t n) {
+  const uint64_t mask = 0x0f0f0f0f0f0f0f0full;
+  uint64_t hi = hex_ascii(_pdep_u64(n >> 32, mask));
+  uint64_t lo = hex_ascii(_pdep_u64(n & 0xffffffff, mask));
+
+  // The deposit puts the last digit first.
+  hi = __builtin_bswap64(hi);
+  lo = __builtin_bswap64(lo);
+
+  memcpy(out, &hi, 8);
+  memcpy(out + 8, &lo, 8);
+}
+
+N64_TARGET("bmi2") void
+n64_bin64_bmi2(char *out, uint64_t n) {
+  const uint64_t mask = 0x0101010101010101ull;
+
+  for (int i = 0; i < 8; i++) {
+    uint64_t x = _pdep_u64(n >> (56 - i * 8), mask);
+    x = __builtin_bswap64(x + 0x3030303030303030ull);
+    memcpy(out + i * 8, &x, 8);
+  }
+}
+#endif
+
+static const char n64_dec_pairs[] =
+  "00010203040506070809"
+  "10111213141516171819"
+  "20212223242526272829"
+  "30313233343536373839"
+  "40414243444546474849"
+  "50515253545556575859"
+  "60616263646566676869"
+  "70717273747576777879"
+  "80818283848586878889"
+  "90919293949596979899";
+
+// Writes the digits of `n` backwards from `end`, two at
+// a time, and returns the first. Only one 64 bit division
+// is needed per eight digits; the rest fit in 32 bits.
+static inline char *
+dec_write(char *end, uint64_t n) {
+  while (n >= 100000000) {
+    uint64_t q = n / 100000000;
+    uint32_t r = (uint32_t)(n - q * 100000000);
+
+    for (int i = 0; i < 4; i++) {
+      end -= 2;
+      memcpy(end, n64_dec_pairs + (r % 100) * 2, 2);
+      r /= 100;
+    }
+
+    n = q;
+  }
+
+  uint32_t m = (uint32_t)n;
+
+  while (m >= 100) {
+    end -= 2;
+    memcpy(end, n64_dec_pairs + (m % 100) * 2, 2);
+    m /= 100;
+  }
+
+  if (m >= 10) {
+    end -= 2;
+    memcpy(end, n64_dec_pairs + m * 2, 2);
+  } else {
+    *(--end) = '0' + (char)m;
+  }
+
+  return end;
+}
+
+size_t
+n64_write(char *out, uint64_t n, int sign, uint32_t base, uint32_t pad) {
+  char buf[N64_STR_SIZE];
+  char *str = (char *)buf + 1;
+  size_t size = 64;
+  bool neg = false;
+
+  assert(pad <= 64);
+
+  if (sign && (int64_t)n < 0) {
+    neg = true;
+    n = ~n + 1;
+  }
+
+  if (base == 2 || base == 16) {
+    // Fixed width digits at the end of the
+    // buffer; trim the zeros down to `pad`.
+    size_t width = base == 2 ? 64 : 16;
+    size_t bits = n64_bitlen(n, 0);
+    char *end = str + 64;
+
+    if (base == 2) {
+      n64_kernels.bin64(end - width, n);
+      size = bits;
+    } else {
+      n64_kernels.hex16(end - width, n);
+      size = (bits + 3) / 4;
+    }
+
+    if (size == 0)
+      size = 1;
+
+    if (pad > width)
+      memset(end - pad, '0', pad - width);
+
+    if (size < pad)
+      size = pad;
+
+    str = end - size;
+  } else {
+    char *end = str + 64;
+    char *start = NULL;
+
+    switch (base) {
+      case 8:
+        start = end;
+        do {
+          *(--start) = '0' + (char)(n & 7);
+          n >>= 3;
+        } while (n != 0);
+        break;
+      case 10:
+        start = dec_write(end, n);
+        break;
+      default:
+        return 0;
+    }
+
+    size = end - start;
+
+    if (size < pad) {
+      memset(end - pad, '0', pad - size);
+      size = pad;
+    }
+
+    str = end - size;
+  }
+
+  assert(size > 0);
+
+  if (neg) {
+    *(--str) = '-';
+    size++;
+  }
+
+  memcpy(out, str, size);
+  out[size] = '\0';
+
+  return size;
+}
+
+// Digit values for 0-9, A-Z and a-z. Everything
+// else maps past the largest base.
+static const uint8_t n64_digits[256] = {
+#define X 0xff
+  X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+  X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+  X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+  0, 1, 2, 3, 4, 5, 6, 7, 8, 9, X, X, X, X, X, X,
+  X, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24,
+  25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, X, X, X, X, X,
+  X, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24,
+  25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, X, X, X, X, X,
+  X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+  X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+  X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+  X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+  X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+  X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+  X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+  X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X
+#undef X
+};
+
+// The most digits which always fit in 64 bits.
+static const uint8_t n64_safe_digits[17] = {
+  0, 0, 64, 40, 32, 27, 24, 22, 21, 20, 19, 18, 17, 17, 16, 16, 16
+};
+
+int
+n64_read(uint64_t *r, const char *str, size_t len, uint32_t base) {
+  bool neg = false;
+  uint64_t n = 0;
+
+  if (!n64_is_base(base))
+    return N64_ERR_BASE;
+
+  if (len > 0 && *str == '-') {
+    neg = true;
+    str++;
+    len--;
+  }
+
+  if (len == 0 || len > 64)
+    return N64_ERR_LENGTH;
+
+  // Digits only: no whitespace, plus signs or prefixes,
+  // so that both backends accept the same strings. This
+  // never throws, which keeps it usable on dirty input.
+  // Strings short enough that they cannot overflow skip
+  // the overflow checks.
+  if (len <= n64_safe_digits[base]) {
+    for (size_t i = 0; i < len; i++) {
+      uint32_t ch = n64_digits[(uint8_t)str[i]];
+
+      if (ch >= base)
+        return N64_ERR_PARSE;
+
+      n = n * base + ch;
+    }
+  } else {
+    uint64_t limit = UINT64_MAX / base;
+
+    for (size_t i = 0; i < len; i++) {
+      uint32_t ch = n64_digits[(uint8_t)str[i]];
+
+      if (ch >= base)
+        return N64_ERR_PARSE;
+
+      if (n > limit || n * base > UINT64_MAX - ch)
+        return N64_ERR_OVERFLOW;
+
+      n = n * base + ch;
+    }
+  }
+
+  if (neg)
+    n = ~n + 1;
+
+  *r = n;
+
+  return N64_OK;
+}
+
+/*
+ * RNG
+ *
+ * xoshiro256** by David Blackman and Sebastiano Vigna:
+ *   http://prng.di.unimi.it/xoshiro256starstar.c
+ * Seeds are expanded with splitmix64, as recommended by the authors.
+ */
+
+static inline uint64_t
+rotl(uint64_t x, int k) {
+  return (x << k) | (x >> (64 - k));
+}
+
+static inline uint64_t
+splitmix64(uint64_t *x) {
+  uint64_t z = (*x += 0x9e3779b97f4a7c15ull);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+  return z ^ (z >> 31);
+}
+
+static inline void
+write64le(uint8_t *data, uint64_t x) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  memcpy(data, &x, 8);
+#else
+  int i;
+  for (i = 0; i < 8; i++)
+    data[i] = (uint8_t)(x >> (i * 8));
+#endif
+}
+
+void
+rng_seed(rng_t *r, uint64_t seed) {
+  uint64_t *s = r->s;
+
+  s[0] = splitmix64(&seed);
+  s[1] = splitmix64(&seed);
+  s[2] = splitmix64(&seed);
+  s[3] = splitmix64(&seed);
+}
+
+uint64_t
+rng_next(rng_t *r) {
+  uint64_t *s = r->s;
+  uint64_t x = rotl(s[1] * 5, 7) * 9;
+  uint64_t t = s[1] << 17;
+
+  s[2] ^= s[0];
+  s[3] ^= s[1];
+  s[1] ^= s[2];
+  s[0] ^= s[3];
+
+  s[2] ^= t;
+
+  s[3] = rotl(s[3], 45);
+
+  return x;
+}
+
+uint64_t
+rng_below(rng_t *r, uint64_t bound) {
+  // Reject the low `2^64 % bound` outputs
+  // so that every residue is equally likely.
+  uint64_t threshold = (0 - bound) % bound;
+
+  for (;;) {
+    uint64_t x = rng_next(r);
+
+    if (x >= threshold)
+      return x % bound;
+  }
+}
+
+void
+rng_jump(rng_t *r) {
+  static const uint64_t JUMP[4] = {
+    0x180ec6d33cfd0abaull,
+    0xd5a61266f0c9392cull,
+    0xa9582618e03fc9aaull,
+    0x39abdc4529b1661cull
+  };
+
+  uint64_t *s = r->s;
+  uint64_t s0 = 0;
+  uint64_t s1 = 0;
+  uint64_t s2 = 0;
+  uint64_t s3 = 0;
+
+  for (int i = 0; i < 4; i++) {
+    for (int b = 0; b < 64; b++) {
+      if (JUMP[i] & (1ull << b)) {
+        s0 ^= s[0];
+        s1 ^= s[1];
+        s2 ^= s[2];
+        s3 ^= s[3];
+      }
+      rng_next(r);
+    }
+  }
+
+  s[0] = s0;
+  s[1] = s1;
+  s[2] = s2;
+  s[3] = s3;
+}
+
+void
+rng_fill(rng_t *r, uint8_t *data, size_t len) {
+  // Values are written in little endian so that
+  // the output matches the javascript backend.
+  while (len >= 8) {
+    write64le(data, rng_next(r));
+    data += 8;
+    len -= 8;
+  }
+
+  if (len > 0) {
+    uint8_t tail[8];
+    write64le(tail, rng_next(r));
+    memcpy(data, tail, len);
+  }
+}
+
+/*
+ * Dec64
+ *
+ * A Dec64 is a signed int64 holding a value in units of 10^-scale.
+ * Multiplication and division go through 128 bit intermediates, so
+ * only the final result must fit in 64 bits.
+ */
+
+static const uint64_t POW10[20] = {
+  1ull,
+  10ull,
+  100ull,
+  1000ull,
+  10000ull,
+  100000ull,
+  1000000ull,
+  10000000ull,
+  100000000ull,
+  1000000000ull,
+  10000000000ull,
+  100000000000ull,
+  1000000000000ull,
+  10000000000000ull,
+  100000000000000ull,
+  1000000000000000ull,
+  10000000000000000ull,
+  100000000000000000ull,
+  1000000000000000000ull,
+  10000000000000000000ull
+};
+
+/*
+ * 128 bit helpers
+ */
+
+static inline uint64_t
+uabs(int64_t x) {
+  return x < 0 ? 0 - (uint64_t)x : (uint64_t)x;
+}
+
+static inline void
+mul64(uint64_t a, uint64_t b, uint64_t *hi, uint64_t *lo) {
+#ifdef __SIZEOF_INT128__
+  unsigned __int128 r = (unsigned __int128)a * b;
+  *hi = (uint64_t)(r >> 64);
+  *lo = (uint64_t)r;
+#else
+  uint64_t a0 = a & 0xffffffffull;
+  uint64_t a1 = a >> 32;
+  uint64_t b0 = b & 0xffffffffull;
+  uint64_t b1 = b >> 32;
+  uint64_t p00 = a0 * b0;
+  uint64_t p01 = a0 * b1;
+  uint64_t p10 = a1 * b0;
+  uint64_t p11 = a1 * b1;
+  uint64_t mid = (p00 >> 32) + (p01 & 0xffffffffull) + (p10 & 0xffffffffull);
+
+  *lo = (mid << 32) | (p00 & 0xffffffffull);
+  *hi = p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32);
+#endif
+}
+
+static inline int
+div128(uint64_t hi, uint64_t lo, uint64_t d, uint64_t *q, uint64_t *r) {
+  // Quotient would not fit in 64 bits.
+  if (hi >= d)
+    return 0;
+
+#ifdef __SIZEOF_INT128__
+  unsigned __int128 n = ((unsigned __int128)hi << 64) | lo;
+  *q = (uint64_t)(n / d);
+  *r = (uint64_t)(n % d);
+#else
+  uint64_t quo = 0;
+  int i;
+
+  for (i = 63; i >= 0; i--) {
+    uint64_t carry = hi >> 63;
+
+    hi = (hi << 1) | (lo >> 63);
+    lo <<= 1;
+
+    if (carry || hi >= d) {
+      hi -= d;
+      quo |= 1ull << i;
+    }
+  }
+
+  *q = quo;
+  *r = hi;
+#endif
+
+  return 1;
+}
+
+static inline int
+cmp128(uint64_t ahi, uint64_t alo, uint64_t bhi, uint64_t blo) {
+  if (ahi != bhi)
+    return ahi < bhi ? -1 : 1;
+
+  if (alo != blo)
+    return alo < blo ? -1 : 1;
+
+  return 0;
+}
+
+/*
+ * N128
+ */
+
+n128_t
+n128_mul(n128_t a, n128_t b) {
+#ifdef __SIZEOF_INT128__
+  return n128_pack(n128_unpack(a) * n128_unpack(b));
+#else
+  n128_t r;
+
+  mul64(a.lo, b.lo, &r.hi, &r.lo);
+
+  r.hi += a.lo * b.hi + a.hi * b.lo;
+
+  return r;
+#endif
+}
+
+static uint64_t
+divmod64(n128_t *n, uint64_t d) {
+  // Divides in place by a 64 bit divisor, one half
+  // at a time, and returns the remainder. Cheaper
+  // than a full 128 bit division.
+  uint64_t q, r;
+
+  r = n->hi % d;
+  n->hi /= d;
+
+  div128(r, n->lo, d, &q, &r);
+
+  n->lo = q;
+
+  return r;
+}
+
+static n128_t
+udivmod(n128_t n, n128_t d, n128_t *rem) {
+  n128_t q;
+
+  if (d.hi == 0) {
+    uint64_t r = divmod64(&n, d.lo);
+
+    *rem = n128_make(0, r);
+
+    return n;
+  }
+
+#ifdef __SIZEOF_INT128__
+  unsigned __int128 x = n128_unpack(n);
+  unsigned __int128 y = n128_unpack(d);
+
+  q = n128_pack(x / y);
+
+  *rem = n128_pack(x - n128_unpack(q) * y);
+#else
+  // The divisor has a high half, so the quotient
+  // is at most 64 bits: shift and subtract.
+  n128_t r = n128_make(0, 0);
+  int bit = n128_bitlen(n, 0);
+
+  q = n128_make(0, 0);
+
+  while (bit--) {
+    r = n128_shl(r, 1);
+    r.lo |= (bit >= 64 ? n.hi >> (bit - 64) : n.lo >> bit) & 1;
+
+    if (n128_cmp(r, d, 0) >= 0) {
+      r = n128_sub(r, d);
+      q.lo |= 1ull << bit;
+    }
+  }
+
+  *rem = r;
+#endif
+
+  return q;
+}
+
+n128_t
+n128_div(n128_t a, n128_t b, int sign) {
+  // Truncates toward zero. INT128_MIN / -1
+  // wraps, as with I64.
+  int neg = n128_is_neg(a, sign) ^ n128_is_neg(b, sign);
+  n128_t r;
+  n128_t q = udivmod(n128_abs(a, sign), n128_abs(b, sign), &r);
+
+  return neg ? n128_neg(q) : q;
+}
+
+n128_t
+n128_mod(n128_t a, n128_t b, int sign) {
+  // The remainder takes the sign of the dividend.
+  n128_t r;
+
+  udivmod(n128_abs(a, sign), n128_abs(b, sign), &r);
+
+  return n128_is_neg(a, sign) ? n128_neg(r) : r;
+}
+
+n128_t
+n128_pow(n128_t x, uint32_t y) {
+  n128_t r = n128_make(0, 1);
+
+  if (n128_is_zero(x))
+    return x;
+
+  while (y > 0) {
+    if (y & 1)
+      r = n128_mul(r, x);
+    y >>= 1;
+    x = n128_mul(x, x);
+  }
+
+  return r;
+}
+
+double
+n128_to_double(n128_t n, int sign) {
+  // Rounds half to even once, from the full value,
+  // like a conversion from a native integer would.
+  int neg = n128_is_neg(n, sign);
+  int shift;
+  double z;
+
+  n = n128_abs(n, sign);
+  shift = n128_bitlen(n, 0) - 53;
+
+  if (shift <= 0) {
+    z = (double)n.lo;
+  } else {
+    n128_t top = n128_shr(n, shift, 0);
+    n128_t low = n128_sub(n, n128_shl(top, shift));
+    n128_t half = n128_shl(n128_make(0, 1), shift - 1);
+    int cmp = n128_cmp(low, half, 0);
+
+    if (cmp > 0 || (cmp == 0 && (top.lo & 1)))
+      top.lo += 1;
+
+    z = ldexp((double)top.lo, shift);
+  }
+
+  return neg ? -z : z;
+}
+
+size_t
+n128_write(char *out, n128_t n, int sign, uint32_t base, uint32_t pad) {
+  char buf[N128_STR_SIZE];
+  char *str = buf + sizeof(buf);
+  size_t size = 0;
+  uint64_t big = base;
+  int digits = 1;
+  int neg = 0;
+
+  if (base < 2 || base > 16)
+    return 0;
+
+  assert(pad <= 128);
+
+  if (n128_is_neg(n, sign)) {
+    neg = 1;
+    n = n128_neg(n);
+  }
+
+  // Peel off as many digits as fit in a 64 bit
+  // word per division, then finish in 64 bits.
+  while (big <= UINT64_MAX / base) {
+    big *= base;
+    digits += 1;
+  }
+
+  while (n.hi != 0) {
+    uint64_t chunk = divmod64(&n, big);
+
+    for (int i = 0; i < digits; i++) {
+      *(--str) = "0123456789abcdef"[chunk % base];
+      chunk /= base;
+      size++;
+    }
+  }
+
+  do {
+    *(--str) = "0123456789abcdef"[n.lo % base];
+    n.lo /= base;
+    size++;
+  } while (n.lo != 0);
+
+  while (size < pad) {
+    *(--str) = '0';
+    size++;
+  }
+
+  if (neg) {
+    *(--str) = '-';
+    size++;
+  }
+
+  memcpy(out, str, size);
+  out[size] = '\0';
+
+  return size;
+}
+
+int
+n128_read(n128_t *r, const char *str, size_t len, uint32_t base) {
+  n128_t n = n128_make(0, 0);
+  int neg = 0;
+
+  if (base < 2 || base > 16)
+    return N64_ERR_BASE;
+
+  if (len > 0 && *str == '-') {
+    neg = 1;
+    str++;
+    len--;
+  }
+
+  if (len == 0 || len > 128)
+    return N64_ERR_LENGTH;
+
+  // Same rules as n64_read: digits only.
+  for (size_t i = 0; i < len; i++) {
+    uint32_t ch = n64_digits[(uint8_t)str[i]];
+    uint64_t hi, lo;
+
+    if (ch >= base)
+      return N64_ERR_PARSE;
+
+    if (n.hi > UINT64_MAX / base)
+      return N64_ERR_OVERFLOW;
+
+    mul64(n.lo, base, &hi, &lo);
+
+    n.hi = n.hi * base + hi;
+
+    if (n.hi < hi)
+      return N64_ERR_OVERFLOW;
+
+    n.lo = lo + ch;
+
+    if (n.lo < lo) {
+      if (n.hi == UINT64_MAX)
+        return N64_ERR_OVERFLOW;
+      n.hi += 1;
+    }
+  }
+
+  if (neg)
+    n = n128_neg(n);
+
+  *r = n;
+
+  return N64_OK;
+}
+
+/*
+ * Decimal helpers
+ */
+
+static inline int
+to_int64(int neg, uint64_t mag, int64_t *out) {
+  if (neg) {
+    if (mag > (1ull << 63))
+      return 0;
+    *out = (int64_t)(0 - mag);
+  } else {
+    if (mag > (uint64_t)INT64_MAX)
+      return 0;
+    *out = (int64_t)mag;
+  }
+  return 1;
+}
+
+static inline int
+round_inc(int neg, uint64_t q, uint64_t r, uint64_t d, int mode) {
+  if (r == 0)
+    return 0;
+
+  // Compare the remainder to half the divisor
+  // without overflowing: `2r > d` <=> `r > d - r`.
+  switch (mode) {
+    case ROUND_DOWN:
+      return 0;
+    case ROUND_UP:
+      return 1;
+    case ROUND_FLOOR:
+      return neg;
+    case ROUND_CEIL:
+      return !neg;
+    case ROUND_HALF_UP:
+      return r >= d - r;
+    case ROUND_HALF_DOWN:
+      return r > d - r;
+    case ROUND_HALF_EVEN:
+      return r > d - r || (r == d - r && (q & 1));
+  }
+
+  return 0;
+}
+
+static int
+div_round(int neg, uint64_t hi, uint64_t lo,
+          uint64_t d, int mode, int64_t *out) {
+  uint64_t q, r;
+
+  if (!div128(hi, lo, d, &q, &r))
+    return 0;
+
+  if (round_inc(neg, q, r, d, mode)) {
+    if (q == UINT64_MAX)
+      return 0;
+    q += 1;
+  }
+
+  return to_int64(neg, q, out);
+}
+
+static int
+scale_up(int64_t x, uint32_t k, int64_t *out) {
+  uint64_t hi, lo;
+
+  mul64(uabs(x), POW10[k], &hi, &lo);
+
+  if (hi != 0)
+    return 0;
+
+  return to_int64(x < 0, lo, out);
+}
+
+int
+dec_rescale(int64_t x, uint32_t from, uint32_t to, int mode, int64_t *out) {
+  if (to >= from)
+    return scale_up(x, to - from, out);
+
+  return div_round(x < 0, 0, uabs(x), POW10[from - to], mode, out);
+}
+
+int
+dec_add(int64_t a, uint32_t sa, int64_t b, uint32_t sb, int sub,
+        int64_t *out, uint32_t *so) {
+  uint32_t s = sa > sb ? sa : sb;
+  int64_t x, y, r;
+
+  if (!scale_up(a, s - sa, &x) || !scale_up(b, s - sb, &y))
+    return 0;
+
+  if (sub) {
+    r = (int64_t)((uint64_t)x - (uint64_t)y);
+    if (((x ^ y) & (x ^ r)) < 0)
+      return 0;
+  } else {
+    r = (int64_t)((uint64_t)x + (uint64_t)y);
+    if ((~(x ^ y) & (x ^ r)) < 0)
+      return 0;
+  }
+
+  *out = r;
+  *so = s;
+
+  return 1;
+}
+
+int
+dec_mul(int64_t a, int64_t b, uint32_t sb, int mode, int64_t *out) {
+  int neg = (a < 0) != (b < 0);
+  uint64_t hi, lo;
+
+  mul64(uabs(a), uabs(b), &hi, &lo);
+
+  if (sb == 0) {
+    if (hi != 0)
+      return 0;
+    return to_int64(neg, lo, out);
+  }
+
+  return div_round(neg, hi, lo, POW10[sb], mode, out);
+}
+
+int
+dec_div(int64_t a, int64_t b, uint32_t sb, int mode, int64_t *out) {
+  int neg = (a < 0) != (b < 0);
+  uint64_t hi, lo;
+
+  mul64(uabs(a), POW10[sb], &hi, &lo);
+
+  return div_round(neg, hi, lo, uabs(b), mode, out);
+}
+
+int
+dec_cmp(int64_t a, uint32_t sa, int64_t b, uint32_t sb) {
+  if (sa == sb || (a < 0) != (b < 0) || a == 0 || b == 0) {
+    if (a < 0 && b >= 0)
+      return -1;
+
+    if (a >= 0 && b < 0)
+      return 1;
+
+    if (sa == sb)
+      return a < b ? -1 : (a > b ? 1 : 0);
+
+    // One side is zero and the other is not negative.
+    return a == b ? 0 : (a == 0 ? -1 : 1);
+  }
+
+  uint32_t s = sa > sb ? sa : sb;
+  uint64_t ahi, alo, bhi, blo;
+
+  mul64(uabs(a), POW10[s - sa], &ahi, &alo);
+  mul64(uabs(b), POW10[s - sb], &bhi, &blo);
+
+  int r = cmp128(ahi, alo, bhi, blo);
+
+  return a < 0 ? -r : r;
+}
+
+double
+dec_to_double(int64_t n, uint32_t scale) {
+  return (double)n / (double)POW10[scale];
+}
+
+size_t
+dec_format(char *str, int64_t n, uint32_t scale) {
+  char digits[24];
+  uint64_t m = uabs(n);
+  size_t len = 0;
+  size_t size = 0;
+  size_t i;
+
+  do {
+    digits[len++] = '0' + (char)(m % 10);
+    m /= 10;
+  } while (m != 0);
+
+  while (len < scale + 1)
+    digits[len++] = '0';
+
+  if (n < 0)
+    str[size++] = '-';
+
+  for (i = len; i > scale; i--)
+    str[size++] = digits[i - 1];
+
+  if (scale > 0) {
+    str[size++] = '.';
+    for (i = scale; i > 0; i--)
+      str[size++] = digits[i - 1];
+  }
+
+  return size;
+}
+
+int
+dec_parse(const char *str, size_t len, int32_t *scale,
+          int mode, int64_t *out) {
+  size_t i = 0;
+  int neg = 0;
+
+  if (len > 0 && (str[0] == '-' || str[0] == '+')) {
+    neg = str[0] == '-';
+    i += 1;
+  }
+
+  size_t int_start = i;
+
+  while (i < len && str[i] >= '0' && str[i] <= '9')
+    i++;
+
+  size_t int_end = i;
+  size_t frac_start = i;
+  size_t frac_end = i;
+
+  if (i < len && str[i] == '.') {
+    frac_start = ++i;
+    while (i < len && str[i] >= '0' && str[i] <= '9')
+      i++;
+    frac_end = i;
+  }
+
+  if (i != len || (int_end == int_start && frac_end == frac_start))
+    return -1;
+
+  size_t frac_len = frac_end - frac_start;
+
+  if (*scale < 0) {
+    if (frac_len > DEC64_MAX_SCALE)
+      return -2;
+    *scale = (int32_t)frac_len;
+  }
+
+  size_t keep = frac_len < (size_t)*scale ? frac_len : (size_t)*scale;
+  uint64_t mag = 0;
+
+  for (i = int_start; i < frac_start + keep; i++) {
+    // Skip the decimal point.
+    if (i == int_end && i != frac_start)
+      continue;
+
+    uint64_t d = (uint64_t)(str[i] - '0');
+
+    if (mag > (UINT64_MAX - d) / 10)
+      return 0;
+
+    mag = mag * 10 + d;
+  }
+
+  for (i = keep; i < (size_t)*scale; i++) {
+    if (mag > UINT64_MAX / 10)
+      return 0;
+    mag *= 10;
+  }
+
+  if (keep < frac_len) {
+    int first = str[frac_start + keep] - '0';
+    int sticky = 0;
+    int inc = 0;
+
+    for (i = frac_start + keep + 1; i < frac_end; i++) {
+      if (str[i] != '0') {
+        sticky = 1;
+        break;
+      }
+    }
+
+    if (first != 0 || sticky) {
+      switch (mode) {
+        case ROUND_DOWN:
+          inc = 0;
+          break;
+        case ROUND_UP:
+          inc = 1;
+          break;
+        case ROUND_FLOOR:
+          inc = neg;
+          break;
+        case ROUND_CEIL:
+          inc = !neg;
+          break;
+        case ROUND_HALF_UP:
+          inc = first >= 5;
+          break;
+        case ROUND_HALF_DOWN:
+          inc = first > 5 || (first == 5 && sticky);
+          break;
+        case ROUND_HALF_EVEN:
+          inc = first > 5 || (first == 5 && (sticky || (mag & 1)));
+          break;
+      }
+    }
+
+    if (inc) {
+      if (mag == UINT64_MAX)
+        return 0;
+      mag += 1;
+    }
+  }
+
+  return to_int64(neg, mag, out);
+}
+
+int64_t
+n64_read_lines(uint64_t *out, uint8_t *valid, size_t count,
+               const char *str, size_t len, uint32_t base) {
+  // Parses `count` newline separated fields. Bad fields
+  // are zeroed and leave their bit in `valid` clear.
+  // Returns the number of bad fields, or -1 if `str`
+  // does not hold exactly `count` fields.
+  const char *end = str + len;
+  int64_t invalid = 0;
+
+  memset(valid, 0, (count + 7) / 8);
+
+  for (size_t i = 0; i < count; i++) {
+    const char *nl = (const char *)memchr(str, '\n', end - str);
+    uint64_t n = 0;
+
+    if (nl == NULL) {
+      if (i != count - 1)
+        return -1;
+      nl = end;
+    } else if (i == count - 1) {
+      return -1;
+    }
+
+    if (n64_read(&n, str, nl - str, base) == N64_OK) {
+      valid[i >> 3] |= 1 << (i & 7);
+    } else {
+      invalid += 1;
+      n = 0;
+    }
+
+    out[i] = n;
+    str = nl + 1;
+  }
+
+  return invalid;
+}
+
+size_t
+n64_count_records(const char *str, size_t len) {
+  // Every newline ends a record, as does the end of
+  // the input unless it follows a newline. A plain
+  // loop is vectorized where memchr would be called
+  // once per (usually short) line.
+  size_t count = 0;
+
+  for (size_t i = 0; i < len; i++)
+    count += str[i] == '\n';
+
+  if (len > 0 && str[len - 1] != '\n')
+    count += 1;
+
+  return count;
+}
+
+const char *
+n64_skip_records(const char *str, const char *end, size_t *count) {
+  // Skips up to `count` records, leaving the number
+  // that could not be skipped in `count`.
+  while (*count > 0 && str < end) {
+    const char *nl = (const char *)memchr(str, '\n', end - str);
+
+    str = nl != NULL ? nl + 1 : end;
+    *count -= 1;
+  }
+
+  return str;
+}
+
+int64_t
+n64_read_column(uint64_t *out, uint8_t *valid, size_t count,
+                const char *str, size_t len, int delim,
+                uint32_t column, uint32_t base) {
+  // Parses field `column` of each of the first `count`
+  // records. A missing field fails like a bad one: it
+  // is zeroed and its bit in `valid` stays clear. Bits
+  // are only ever set, so the caller clears `valid`.
+  // Returns the number of bad records.
+  const char *end = str + len;
+  int64_t invalid = 0;
+
+  for (size_t i = 0; i < count && str < end; i++) {
+    const char *eol = (const char *)memchr(str, '\n', end - str);
+    const char *field = str;
+    const char *stop = NULL;
+    uint64_t n = 0;
+    bool ok = true;
+
+    if (eol == NULL)
+      eol = end;
+
+    for (uint32_t j = 0; j < column; j++) {
+      const char *sep = (const char *)memchr(field, delim, eol - field);
+
+      if (sep == NULL) {
+        ok = false;
+        break;
+      }
+
+      field = sep + 1;
+    }
+
+    if (ok) {
+      stop = (const char *)memchr(field, delim, eol - field);
+
+      if (stop == NULL) {
+        stop = eol;
+
+        // CRLF line endings.
+        if (stop > field && stop[-1] == '\r')
+          stop -= 1;
+      }
+
+      ok = n64_read(&n, field, stop - field, base) == N64_OK;
+    }
+
+    if (ok)
+      valid[i >> 3] |= 1 << (i & 7);
+    else
+      invalid += 1;
+
+    out[i] = ok ? n : 0;
+    str = eol + 1;
+  }
+
+  return invalid;
+}
+
+/*
+ * Bulk
+ */
+
+static inline uint64_t
+bswap64(uint64_t x) {
+#if defined(__GNUC__)
+  return __builtin_bswap64(x);
+#else
+  x = ((x & 0x00ff00ff00ff00ffull) << 8) | ((x >> 8) & 0x00ff00ff00ff00ffull);
+  x = ((x & 0x0000ffff0000ffffull) << 16) | ((x >> 16) & 0x0000ffff0000ffffull);
+  return (x << 32) | (x >> 32);
+#endif
+}
+
+static inline uint32_t
+read32le(const uint8_t *data) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  uint32_t x;
+  memcpy(&x, data, 4);
+  return x;
+#else
+  return (uint32_t)data[0]
+       | ((uint32_t)data[1] << 8)
+       | ((uint32_t)data[2] << 16)
+       | ((uint32_t)data[3] << 24);
+#endif
+}
+
+static inline uint64_t
+read64le(const uint8_t *data) {
+  return (uint64_t)read32le(data) | ((uint64_t)read32le(data + 4) << 32);
+}
+
+static inline void
+write32le(uint8_t *data, uint32_t x) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  memcpy(data, &x, 4);
+#else
+  data[0] = (uint8_t)x;
+  data[1] = (uint8_t)(x >> 8);
+  data[2] = (uint8_t)(x >> 16);
+  data[3] = (uint8_t)(x >> 24);
+#endif
+}
+
+// The vector loops handle whole registers and
+// leave the tail to the scalar loop. Loads and
+// stores are unaligned; buffers are often slices.
+// Each ISA gets its own copy of a kernel, which
+// cpu.cc selects from at load time.
+
+static inline void
+bswap64_tail(uint8_t *dst, const uint8_t *src, size_t i, size_t count) {
+  for (; i < count; i++) {
+    uint64_t x;
+    memcpy(&x, src + i * 8, 8);
+    x = bswap64(x);
+    memcpy(dst + i * 8, &x, 8);
+  }
+}
+
+void
+n64_bswap64_scalar(uint8_t *dst, const uint8_t *src, size_t count) {
+  bswap64_tail(dst, src, 0, count);
+}
+
+#if defined(N64_SSE2)
+void
+n64_bswap64_sse2(uint8_t *dst, const uint8_t *src, size_t count) {
+  size_t i = 0;
+
+  // Swap the bytes of each 16 bit lane, then
+  // reverse the lanes of each word.
+  for (; i + 2 <= count; i += 2) {
+    __m128i x = _mm_loadu_si128((const __m128i *)(src + i * 8));
+
+    x = _mm_or_si128(_mm_slli_epi16(x, 8), _mm_srli_epi16(x, 8));
+    x = _mm_shufflelo_epi16(x, _MM_SHUFFLE(0, 1, 2, 3));
+    x = _mm_shufflehi_epi16(x, _MM_SHUFFLE(0, 1, 2, 3));
+
+    _mm_storeu_si128((__m128i *)(dst + i * 8), x);
+  }
+
+  bswap64_tail(dst, src, i, count);
+}
+#endif
+
+#if defined(N64_HAVE_SSSE3)
+N64_TARGET("ssse3") void
+n64_bswap64_ssse3(uint8_t *dst, const uint8_t *src, size_t count) {
+  const __m128i mask = _mm_set_epi8(8, 9, 10, 11, 12, 13, 14, 15,
+                                    0, 1, 2, 3, 4, 5, 6, 7);
+  size_t i = 0;
+
+  for (; i + 2 <= count; i += 2) {
+    __m128i x = _mm_loadu_si128((const __m128i *)(src + i * 8));
+    _mm_storeu_si128((__m128i *)(dst + i * 8), _mm_shuffle_epi8(x, mask));
+  }
+
+  bswap64_tail(dst, src, i, count);
+}
+#endif
+
+#if defined(N64_HAVE_AVX2)
+N64_TARGET("avx2") void
+n64_bswap64_avx2(uint8_t *dst, const uint8_t *src, size_t count) {
+  const __m256i mask = _mm256_set_epi8(8, 9, 10, 11, 12, 13, 14, 15,
+                                       0, 1, 2, 3, 4, 5, 6, 7,
+                                       8, 9, 10, 11, 12, 13, 14, 15,
+                                       0, 1, 2, 3, 4, 5, 6, 7);
+  size_t i = 0;
+
+  for (; i + 4 <= count; i += 4) {
+    __m256i x = _mm256_loadu_si256((const __m256i *)(src + i * 8));
+    _mm256_storeu_si256((__m256i *)(dst + i * 8),
+                        _mm256_shuffle_epi8(x, mask));
+  }
+
+  bswap64_tail(dst, src, i, count);
+}
+#endif
+
+#if defined(N64_HAVE_AVX512)
+N64_TARGET("avx512f,avx512bw") void
+n64_bswap64_avx512(uint8_t *dst, const uint8_t *src, size_t count) {
+  const __m512i mask = _mm512_set_epi64(0x08090a0b0c0d0e0fll,
+                                        0x0001020304050607ll,
+                                        0x08090a0b0c0d0e0fll,
+                                        0x0001020304050607ll,
+                                        0x08090a0b0c0d0e0fll,
+                                        0x0001020304050607ll,
+                                        0x08090a0b0c0d0e0fll,
+                                        0x0001020304050607ll);
+  size_t i = 0;
+
+  for (; i + 8 <= count; i += 8) {
+    __m512i x = _mm512_loadu_si512((const void *)(src + i * 8));
+    _mm512_storeu_si512((void *)(dst + i * 8), _mm512_shuffle_epi8(x, mask));
+  }
+
+  bswap64_tail(dst, src, i, count);
+}
+#endif
+
+#if defined(N64_NEON)
+void
+n64_bswap64_neon(uint8_t *dst, const uint8_t *src, size_t count) {
+  size_t i = 0;
+
+  for (; i + 2 <= count; i += 2)
+    vst1q_u8(dst + i * 8, vrev64q_u8(vld1q_u8(src + i * 8)));
+
+  bswap64_tail(dst, src, i, count);
+}
+#endif
+
+void
+n64_bswap64(uint8_t *dst, const uint8_t *src, size_t count) {
+  n64_kernels.bswap64(dst, src, count);
+}
+
+static inline void
+split_tail(int32_t *hi, int32_t *lo, const uint8_t *src,
+           size_t i, size_t count) {
+  for (; i < count; i++) {
+    uint64_t x = read64le(src + i * 8);
+
+    lo[i] = (int32_t)x;
+    hi[i] = (int32_t)(x >> 32);
+  }
+}
+
+void
+n64_split_scalar(int32_t *hi, int32_t *lo, const uint8_t *src, size_t count) {
+  split_tail(hi, lo, src, 0, count);
+}
+
+void
+n64_split(int32_t *hi, int32_t *lo, const uint8_t *src, size_t count) {
+  n64_kernels.split(hi, lo, src, count);
+}
+
+static inline void
+join_tail(uint8_t *dst, const int32_t *hi, const int32_t *lo,
+          size_t i, size_t count) {
+  for (; i < count; i++) {
+    uint64_t x = ((uint64_t)(uint32_t)hi[i] << 32) | (uint32_t)lo[i];
+
+    write64le(dst + i * 8, x);
+  }
+}
+
+void
+n64_join_scalar(uint8_t *dst, const int32_t *hi, const int32_t *lo,
+                size_t count) {
+  join_tail(dst, hi, lo, 0, count);
+}
+
+void
+n64_join(uint8_t *dst, const int32_t *hi, const int32_t *lo, size_t count) {
+  n64_kernels.join(dst, hi, lo, count);
+}
+
+// Doubles are built from the two halves of each
+// word, as hi * 2^32 + lo with a single rounding,
+// like the JS backend. The halves are placed in the
+// mantissas of 2^84 and 2^52 so that SSE2 and AVX2,
+// which have no 64 bit integer conversions, can do
+// several at once. AVX-512 DQ converts directly;
+// either way there is one rounding, to nearest even.
+
+static inline void
+to_float64_tail(double *dst, const uint8_t *src,
+                size_t i, size_t count, int sign) {
+  for (; i < count; i++) {
+    uint64_t x;
+
+    memcpy(&x, src + i * 8, 8);
+
+    if (sign)
+      dst[i] = (double)(int64_t)x;
+    else
+      dst[i] = (double)x;
+  }
+}
+
+void
+n64_to_float64_scalar(double *dst, const uint8_t *src,
+                      size_t count, int sign) {
+  to_float64_tail(dst, src, 0, count, sign);
+}
+
+#if defined(N64_SSE2)
+void
+n64_to_float64_sse2(double *dst, const uint8_t *src, size_t count, int sign) {
+  const __m128i lo_mask = _mm_set1_epi64x(0xffffffffll);
+  const __m128i lo_exp = _mm_set1_epi64x(0x4330000000000000ll);
+  const __m128i hi_exp = _mm_set1_epi64x(sign ? 0x4530000080000000ll
+                                              : 0x4530000000000000ll);
+  const __m128d bias = _mm_set1_pd(sign ? 19342822341709703277445120.0
+                                        : 19342813118337666422669312.0);
+  size_t i = 0;
+
+  for (; i + 2 <= count; i += 2) {
+    __m128i x = _mm_loadu_si128((const __m128i *)(src + i * 8));
+    __m128i lo = _mm_or_si128(_mm_and_si128(x, lo_mask), lo_exp);
+    __m128i hi = _mm_xor_si128(_mm_srli_epi64(x, 32), hi_exp);
+    __m128d d = _mm_sub_pd(_mm_castsi128_pd(hi), bias);
+
+    _mm_storeu_pd(dst + i, _mm_add_pd(d, _mm_castsi128_pd(lo)));
+  }
+
+  to_float64_tail(dst, src, i, count, sign);
+}
+#endif
+
+#if defined(N64_HAVE_AVX2)
+N64_TARGET("avx2") void
+n64_to_float64_avx2(double *dst, const uint8_t *src, size_t count, int sign) {
+  const __m256i lo_mask = _mm256_set1_epi64x(0xffffffffll);
+  const __m256i lo_exp = _mm256_set1_epi64x(0x4330000000000000ll);
+  const __m256i hi_exp = _mm256_set1_epi64x(sign ? 0x4530000080000000ll
+                                                 : 0x4530000000000000ll);
+  const __m256d bias = _mm256_set1_pd(sign ? 19342822341709703277445120.0
+                                           : 19342813118337666422669312.0);
+  size_t i = 0;
+
+  for (; i + 4 <= count; i += 4) {
+    __m256i x = _mm256_loadu_si256((const __m256i *)(src + i * 8));
+    __m256i lo = _mm256_or_si256(_mm256_and_si256(x, lo_mask), lo_exp);
+    __m256i hi = _mm256_xor_si256(_mm256_srli_epi64(x, 32), hi_exp);
+    __m256d d = _mm256_sub_pd(_mm256_castsi256_pd(hi), bias);
+
+    _mm256_storeu_pd(dst + i, _mm256_add_pd(d, _mm256_castsi256_pd(lo)));
+  }
+
+  to_float64_tail(dst, src, i, count, sign);
+}
+#endif
+
+#if defined(N64_HAVE_AVX512)
+N64_TARGET("avx512f,avx512dq") void
+n64_to_float64_avx512(double *dst, const uint8_t *src,
+                      size_t count, int sign) {
+  size_t i = 0;
+
+  if (sign) {
+    for (; i + 8 <= count; i += 8) {
+      __m512i x = _mm512_loadu_si512((const void *)(src + i * 8));
+      _mm512_storeu_pd(dst + i, _mm512_cvtepi64_pd(x));
+    }
+  } else {
+    for (; i + 8 <= count; i += 8) {
+      __m512i x = _mm512_loadu_si512((const void *)(src + i * 8));
+      _mm512_storeu_pd(dst + i, _mm512_cvtepu64_pd(x));
+    }
+  }
+
+  to_float64_tail(dst, src, i, count, sign);
+}
+#endif
+
+// Rounds a word which does not fit in 53 bits.
+static double
+to_float64_round(uint64_t x, int sign, int mode) {
+  int neg = sign && (int64_t)x < 0;
+  uint64_t m = neg ? ~x + 1 : x;
+  int shift = n64_bitlen(m, 0) - 53;
+  uint64_t d = (uint64_t)1 << shift;
+  uint64_t q = m >> shift;
+  uint64_t r = m & (d - 1);
+  double z;
+
+  q += round_inc(neg, q, r, d, mode);
+  z = ldexp((double)q, shift);
+
+  return neg ? -z : z;
+}
+
+size_t
+n64_to_float64(double *dst, const uint8_t *src, size_t count,
+               int sign, int mode, uint32_t *bad) {
+  // Works through blocks of 64 so that `dst` may
+  // be `src`: each block is checked (and its unsafe
+  // words saved) before it is overwritten.
+  size_t fails = 0;
+
+  if (mode == ROUND_HALF_EVEN) {
+    n64_kernels.to_float64(dst, src, count, sign);
+    return 0;
+  }
+
+  for (size_t start = 0; start < count; start += 64) {
+    size_t n = count - start < 64 ? count - start : 64;
+    const uint8_t *s = src + start * 8;
+    double *d = dst + start;
+    uint64_t saved[64];
+    uint64_t mask = 0;
+
+    for (size_t j = 0; j < n; j++) {
+      memcpy(&saved[j], s + j * 8, 8);
+
+      if (!n64_is_safe(saved[j], sign))
+        mask |= (uint64_t)1 << j;
+    }
+
+    n64_kernels.to_float64(d, s, n, sign);
+
+    while (mask != 0) {
+      size_t j = 0;
+
+      while (((mask >> j) & 1) == 0)
+        j++;
+
+      mask &= mask - 1;
+
+      if (mode == N64_STRICT) {
+        d[j] = NAN;
+        bad[fails++] = (uint32_t)(start + j);
+      } else {
+        d[j] = to_float64_round(saved[j], sign, mode);
+      }
+    }
+  }
+
+  return fails;
+}
+
+// Rounds to an integer with the same arithmetic as
+// the JS backend: `x - trunc(x)` is exact.
+static double
+round_float64(double x, int mode) {
+  double t = trunc(x);
+  double f = fabs(x - t);
+  double away = x < 0 ? t - 1 : t + 1;
+
+  if (f == 0)
+    return t;
+
+  switch (mode) {
+    case ROUND_DOWN:
+      return t;
+    case ROUND_UP:
+      return away;
+    case ROUND_FLOOR:
+      return x < 0 ? away : t;
+    case ROUND_CEIL:
+      return x < 0 ? t : away;
+    case ROUND_HALF_UP:
+      return f >= 0.5 ? away : t;
+    case ROUND_HALF_DOWN:
+      return f > 0.5 ? away : t;
+    case ROUND_HALF_EVEN:
+      return f > 0.5 || (f == 0.5 && fmod(t, 2) != 0) ? away : t;
+  }
+
+  return t;
+}
+
+size_t
+n64_from_float64(uint8_t *dst, const double *src, size_t count,
+                 int sign, int mode, uint32_t *bad) {
+  // Strictly, only safe integers convert (negative
+  // ones wrap when unsigned, as with fromNumber).
+  // Otherwise NaN fails and anything out of range
+  // saturates and fails. Failures never stop the
+  // loop. SSE2 has no packed conversion to 64 bit
+  // integers, so this is one cvttsd2si per element.
+  size_t fails = 0;
+
+  for (size_t i = 0; i < count; i++) {
+    double x = src[i];
+    uint64_t z = 0;
+    int ok = 1;
+
+    if (mode == N64_STRICT) {
+      ok = x >= -N64_MAX_SAFE_INTEGER
+        && x <= N64_MAX_SAFE_INTEGER
+        && x == trunc(x);
+
+      if (ok)
+        z = (uint64_t)(int64_t)x;
+    } else if (x != x) {
+      ok = 0;
+    } else {
+      x = round_float64(x, mode);
+
+      if (sign) {
+        if (x < -9223372036854775808.0) {
+          z = (uint64_t)INT64_MIN;
+          ok = 0;
+        } else if (x >= 9223372036854775808.0) {
+          z = (uint64_t)INT64_MAX;
+          ok = 0;
+        } else {
+          z = (uint64_t)(int64_t)x;
+        }
+      } else {
+        if (x < 0) {
+          z = 0;
+          ok = 0;
+        } else if (x >= 18446744073709551616.0) {
+          z = UINT64_MAX;
+          ok = 0;
+        } else {
+          z = (uint64_t)x;
+        }
+      }
+    }
+
+    if (!ok)
+      bad[fails++] = (uint32_t)i;
+
+    memcpy(dst + i * 8, &z, 8);
+  }
+
+  return fails;
+}
+
+/*
+ * Linear algebra
+ */
+
+// Neither SSE nor NEON has a 64x64->128 multiply,
+// so these are scalar. A sum is kept as a 128 bit
+// total plus a `top` word counting carries out of
+// it. A signed product sign-extends into `top`.
+
+typedef struct acc_s {
+  uint64_t lo;
+  uint64_t hi;
+  uint64_t top;
+} acc_t;
+
+static inline uint64_t
+load64(const uint8_t *data) {
+  uint64_t x;
+  memcpy(&x, data, 8);
+  return x;
+}
+
+static inline void
+acc_mul(acc_t *acc, uint64_t a, uint64_t b, int sign) {
+  uint64_t hi, lo, carry;
+
+  mul64(a, b, &hi, &lo);
+
+  // The unsigned product, corrected for
+  // two's complement operands.
+  if (sign) {
+    if ((int64_t)a < 0)
+      hi -= b;
+
+    if ((int64_t)b < 0)
+      hi -= a;
+
+    if ((int64_t)hi < 0)
+      acc->top -= 1;
+  }
+
+  acc->lo += lo;
+  carry = acc->lo < lo;
+
+  acc->hi += carry;
+  carry = acc->hi < carry;
+
+  acc->hi += hi;
+  carry += acc->hi < hi;
+
+  acc->top += carry;
+}
+
+static inline void
+acc_merge(acc_t *acc, const acc_t *b) {
+  uint64_t carry;
+
+  acc->lo += b->lo;
+  carry = acc->lo < b->lo;
+
+  acc->hi += carry;
+  carry = acc->hi < carry;
+
+  acc->hi += b->hi;
+  carry += acc->hi < b->hi;
+
+  acc->top += b->top + carry;
+}
+
+static inline int
+acc_fits128(const acc_t *acc, int sign) {
+  if (sign)
+    return acc->top == (uint64_t)((int64_t)acc->hi >> 63);
+
+  return acc->top == 0;
+}
+
+static inline int
+acc_fits64(const acc_t *acc, int sign) {
+  if (!acc_fits128(acc, sign))
+    return 0;
+
+  if (sign)
+    return acc->hi == (uint64_t)((int64_t)acc->lo >> 63);
+
+  return acc->hi == 0;
+}
+
+// Two sums run side by side to shorten the chain
+// of dependent carries.
+static void
+dot(acc_t *acc, const uint8_t *a, const uint8_t *b,
+    size_t count, int sign) {
+  acc_t odd = {0, 0, 0};
+  size_t i = 0;
+
+  acc->lo = 0;
+  acc->hi = 0;
+  acc->top = 0;
+
+  for (; i + 2 <= count; i += 2) {
+    acc_mul(acc, load64(a + i * 8), load64(b + i * 8), sign);
+    acc_mul(&odd, load64(a + i * 8 + 8), load64(b + i * 8 + 8), sign);
+  }
+
+  if (i < count)
+    acc_mul(acc, load64(a + i * 8), load64(b + i * 8), sign);
+
+  acc_merge(acc, &odd);
+}
+
+int
+n64_dot(n128_t *r, const uint8_t *a, const uint8_t *b,
+        size_t count, int sign) {
+  acc_t acc;
+
+  dot(&acc, a, b, count, sign);
+
+  r->lo = acc.lo;
+  r->hi = acc.hi;
+
+  return acc_fits128(&acc, sign);
+}
+
+size_t
+n64_axpy(uint8_t *dst, uint64_t alpha, const uint8_t *x,
+         size_t count, int sign, uint32_t *bad) {
+  size_t fails = 0;
+
+  for (size_t i = 0; i < count; i++) {
+    uint64_t y = load64(dst + i * 8);
+    acc_t acc;
+
+    acc.lo = y;
+    acc.hi = sign && (int64_t)y < 0 ? UINT64_MAX : 0;
+    acc.top = acc.hi;
+
+    acc_mul(&acc, alpha, load64(x + i * 8), sign);
+
+    if (!acc_fits64(&acc, sign))
+      bad[fails++] = (uint32_t)i;
+
+    memcpy(dst + i * 8, &acc.lo, 8);
+  }
+
+  return fails;
+}
+
+size_t
+n64_matvec(uint8_t *dst, const uint8_t *m, const uint8_t *x,
+           size_t rows, size_t cols, int sign, uint32_t *bad) {
+  size_t fails = 0;
+
+  for (size_t i = 0; i < rows; i++) {
+    acc_t acc;
+
+    dot(&acc, m + i * cols * 8, x, cols, sign);
+
+    if (!acc_fits64(&acc, sign))
+      bad[fails++] = (uint32_t)i;
+
+    memcpy(dst + i * 8, &acc.lo, 8);
+  }
+
+  return fails;
+}
+
+/*
+ * Integer math
+ */
+
+static inline int
+ctz64(uint64_t x) {
+#if defined(__GNUC__)
+  return __builtin_ctzll(x);
+#else
+  int n = 0;
+
+  while ((x & 1) == 0) {
+    x >>= 1;
+    n++;
+  }
+
+  return n;
+#endif
+}
+
+// Seeded from the double result, then corrected:
+// the double may be off by one either way.
+static uint64_t
+usqrt(uint64_t x) {
+  uint64_t r = (uint64_t)sqrt((double)x);
+
+  if (r > 0xffffffffull)
+    r = 0xffffffffull;
+
+  while (r * r > x)
+    r--;
+
+  while (r < 0xffffffffull && (r + 1) * (r + 1) <= x)
+    r++;
+
+  return r;
+}
+
+// The cube root of 2^64 - 1 is 2642245.9...
+static uint64_t
+ucbrt(uint64_t x) {
+  uint64_t r = (uint64_t)cbrt((double)x);
+
+  if (r > 2642245)
+    r = 2642245;
+
+  while (r * r * r > x)
+    r--;
+
+  while (r < 2642245 && (r + 1) * (r + 1) * (r + 1) <= x)
+    r++;
+
+  return r;
+}
+
+// Binary gcd: shifts and subtractions only.
+static uint64_t
+ugcd(uint64_t a, uint64_t b) {
+  int shift;
+
+  if (a == 0)
+    return b;
+
+  if (b == 0)
+    return a;
+
+  shift = ctz64(a | b);
+  a >>= ctz64(a);
+
+  do {
+    b >>= ctz64(b);
+
+    if (a > b) {
+      uint64_t t = a;
+      a = b;
+      b = t;
+    }
+
+    b -= a;
+  } while (b != 0);
+
+  return a << shift;
+}
+
+static inline uint64_t
+magnitude(uint64_t x, int sign) {
+  return sign ? uabs((int64_t)x) : x;
+}
+
+static inline int
+is_neg(uint64_t x, int sign) {
+  return sign && (int64_t)x < 0;
+}
+
+int
+n64_sqrt(uint64_t *r, uint64_t x, int sign) {
+  if (is_neg(x, sign))
+    return 0;
+
+  *r = usqrt(x);
+
+  return 1;
+}
+
+int
+n64_cbrt(uint64_t *r, uint64_t x, int sign) {
+  uint64_t z = ucbrt(magnitude(x, sign));
+
+  *r = is_neg(x, sign) ? 0 - z : z;
+
+  return 1;
+}
+
+int
+n64_log2(int *r, uint64_t x, int sign) {
+  if (x == 0 || is_neg(x, sign))
+    return 0;
+
+  *r = n64_bitlen(x, 0) - 1;
+
+  return 1;
+}
+
+// 1233 / 4096 is close enough to log10(2) that `t`
+// is either the answer or one more.
+int
+n64_log10(int *r, uint64_t x, int sign) {
+  int t;
+
+  if (x == 0 || is_neg(x, sign))
+    return 0;
+
+  t = (n64_bitlen(x, 0) * 1233) >> 12;
+
+  if (x < POW10[t])
+    t -= 1;
+
+  *r = t;
+
+  return 1;
+}
+
+int
+n64_gcd(uint64_t *r, uint64_t a, uint64_t b, int sign) {
+  uint64_t z = ugcd(magnitude(a, sign), magnitude(b, sign));
+
+  // gcd(INT64_MIN, 0) is 2^63.
+  if (sign && (int64_t)z < 0)
+    return 0;
+
+  *r = z;
+
+  return 1;
+}
+
+int
+n64_lcm(uint64_t *r, uint64_t a, uint64_t b, int sign) {
+  uint64_t x = magnitude(a, sign);
+  uint64_t y = magnitude(b, sign);
+  uint64_t hi, lo;
+
+  if (x == 0 || y == 0) {
+    *r = 0;
+    return 1;
+  }
+
+  mul64(x / ugcd(x, y), y, &hi, &lo);
+
+  if (hi != 0 || (sign && (int64_t)lo < 0))
+    return 0;
+
+  *r = lo;
+
+  return 1;
+}
+
+int
+n64_next_pow2(uint64_t *r, uint64_t x, int sign) {
+  int bits;
+
+  if (x <= 1 || is_neg(x, sign)) {
+    *r = 1;
+    return 1;
+  }
+
+  bits = n64_bitlen(x - 1, 0);
+
+  if (bits >= (sign ? 63 : 64))
+    return 0;
+
+  *r = 1ull << bits;
+
+  return 1;
+}
+
+size_t
+n64_math_unary(int op, uint8_t *dst, const uint8_t *src,
+               size_t count, int sign, uint32_t *bad) {
+  size_t fails = 0;
+
+  for (size_t i = 0; i < count; i++) {
+    uint64_t x = load64(src + i * 8);
+    uint64_t z = 0;
+    int ok = 0;
+
+    switch (op) {
+      case N64_MATH_SQRT:
+        ok = n64_sqrt(&z, x, sign);
+        break;
+      case N64_MATH_CBRT:
+        ok = n64_cbrt(&z, x, sign);
+        break;
+      case N64_MATH_NEXT_POW2:
+        ok = n64_next_pow2(&z, x, sign);
+        break;
+    }
+
+    if (!ok) {
+      z = 0;
+      bad[fails++] = (uint32_t)i;
+    }
+
+    memcpy(dst + i * 8, &z, 8);
+  }
+
+  return fails;
+}
+
+size_t
+n64_math_log(int op, int32_t *dst, const uint8_t *src,
+             size_t count, int sign, uint32_t *bad) {
+  size_t fails = 0;
+
+  for (size_t i = 0; i < count; i++) {
+    uint64_t x = load64(src + i * 8);
+    int z = -1;
+    int ok;
+
+    if (op == N64_MATH_LOG2)
+      ok = n64_log2(&z, x, sign);
+    else
+      ok = n64_log10(&z, x, sign);
+
+    if (!ok) {
+      z = -1;
+      bad[fails++] = (uint32_t)i;
+    }
+
+    dst[i] = z;
+  }
+
+  return fails;
+}
+
+size_t
+n64_math_binary(int op, uint8_t *dst, const uint8_t *a, const uint8_t *b,
+                size_t count, int sign, uint32_t *bad) {
+  size_t fails = 0;
+
+  for (size_t i = 0; i < count; i++) {
+    uint64_t x = load64(a + i * 8);
+    uint64_t y = load64(b + i * 8);
+    uint64_t z = 0;
+    int ok;
+
+    if (op == N64_MATH_GCD)
+      ok = n64_gcd(&z, x, y, sign);
+    else
+      ok = n64_lcm(&z, x, y, sign);
+
+    if (!ok) {
+      z = 0;
+      bad[fails++] = (uint32_t)i;
+    }
+
+    memcpy(dst + i * 8, &z, 8);
+  }
+
+  return fails;
+}
+
+size_t
+n64_divmod_many(uint8_t *q, uint8_t *r, const uint8_t *a, const uint8_t *b,
+                size_t count, int sign, uint32_t *bad) {
+  size_t fails = 0;
+
+  for (size_t i = 0; i < count; i++) {
+    uint64_t x = load64(a + i * 8);
+    uint64_t y = load64(b + i * 8);
+    uint64_t u = 0;
+    uint64_t v = 0;
+
+    if (y == 0) {
+      bad[fails++] = (uint32_t)i;
+    } else {
+      u = n64_div(x, y, sign);
+      v = n64_mod(x, y, sign);
+    }
+
+    memcpy(q + i * 8, &u, 8);
+    memcpy(r + i * 8, &v, 8);
+  }
+
+  return fails;
+}
+
+/*
+ * Histogram
+ *
+ * The layout follows HdrHistogram by Gil Tene:
+ *   https://github.com/HdrHistogram/HdrHistogram
+ *
+ * Each bucket covers twice the range of the one before
+ * it with the same number of sub-buckets, of which only
+ * the upper half is stored past the first. Finding a
+ * value's slot is a count of leading zeros and a shift.
+ */
+
+static inline size_t
+hist_index(const n64_hist_t *h, uint64_t value) {
+  int bucket = n64_bitlen(value | h->mask, 0) - h->unit - (h->shift + 1);
+  uint64_t sub = value >> (bucket + h->unit);
+  uint64_t half = (uint64_t)1 << h->shift;
+
+  return ((size_t)(bucket + 1) << h->shift) + (size_t)(sub - half);
+}
+
+// The lowest value in a slot, and the number
+// of values which share it.
+static inline uint64_t
+hist_value(const n64_hist_t *h, size_t index, uint64_t *size) {
+  int bucket = (int)(index >> h->shift) - 1;
+  uint64_t half = (uint64_t)1 << h->shift;
+  uint64_t sub = (uint64_t)(index & (half - 1)) + half;
+
+  if (bucket < 0) {
+    sub -= half;
+    bucket = 0;
+  }
+
+  *size = (uint64_t)1 << (bucket + h->unit);
+
+  return sub << (bucket + h->unit);
+}
+
+// The slots holding the smallest and largest values
+// recorded. Only meaningful for a non-empty histogram.
+static inline void
+hist_span(const n64_hist_t *h, size_t *first, size_t *last) {
+  *first = hist_index(h, h->min);
+  *last = hist_index(h, h->max);
+
+  if (*last >= h->len)
+    *last = h->len - 1;
+
+  if (*first > *last)
+    *first = 0;
+}
+
+int
+n64_hist_layout(n64_hist_t *h, uint64_t lowest, uint64_t highest, int digits) {
+  if (digits < 1 || digits > N64_HIST_MAX_DIGITS)
+    return 0;
+
+  if (lowest < 1 || highest / 2 < lowest)
+    return 0;
+
+  // Values below 2 * 10^digits get a slot each.
+  uint64_t single = 2;
+
+  for (int i = 0; i < digits; i++)
+    single *= 10;
+
+  int shift = n64_bitlen(single - 1, 0) - 1;
+  int unit = n64_bitlen(lowest, 0) - 1;
+
+  if (unit + shift > 61)
+    return 0;
+
+  uint64_t smallest = ((uint64_t)2 << shift) << unit;
+  int buckets = 1;
+
+  while (smallest <= highest) {
+    if (smallest > UINT64_MAX / 2) {
+      buckets += 1;
+      break;
+    }
+
+    smallest <<= 1;
+    buckets += 1;
+  }
+
+  h->lowest = lowest;
+  h->highest = highest;
+  h->digits = digits;
+  h->unit = unit;
+  h->shift = shift;
+  h->mask = (((uint64_t)2 << shift) - 1) << unit;
+  h->len = (size_t)(buckets + 1) << shift;
+  h->total = 0;
+  h->min = UINT64_MAX;
+  h->max = 0;
+
+  return 1;
+}
+
+void
+n64_hist_reset(n64_hist_t *h) {
+  memset(h->counts, 0, h->len * sizeof(uint64_t));
+
+  h->total = 0;
+  h->min = UINT64_MAX;
+  h->max = 0;
+}
+
+int
+n64_hist_record(n64_hist_t *h, uint64_t value, uint64_t count, int sign) {
+  if (sign && (int64_t)value < 0)
+    return 0;
+
+  size_t index = hist_index(h, value);
+
+  if (index >= h->len)
+    return 0;
+
+  if (count == 0)
+    return 1;
+
+  h->counts[index] += count;
+  h->total += count;
+
+  if (value < h->min)
+    h->min = value;
+
+  if (value > h->max)
+    h->max = value;
+
+  return 1;
+}
+
+size_t
+n64_hist_record_many(n64_hist_t *h, const uint8_t *data, size_t count,
+                     int sign, uint32_t *bad) {
+  uint64_t *counts = h->counts;
+  uint64_t min = h->min;
+  uint64_t max = h->max;
+  size_t recorded = 0;
+  size_t fails = 0;
+
+  for (size_t i = 0; i < count; i++) {
+    uint64_t value = load64(data + i * 8);
+    size_t index = hist_index(h, value);
+
+    if ((sign && (int64_t)value < 0) || index >= h->len) {
+      bad[fails++] = (uint32_t)i;
+      continue;
+    }
+
+    counts[index] += 1;
+    recorded += 1;
+
+    if (value < min)
+      min = value;
+
+    if (value > max)
+      max = value;
+  }
+
+  h->total += recorded;
+  h->min = min;
+  h->max = max;
+
+  return fails;
+}
+
+uint64_t
+n64_hist_percentile(const n64_hist_t *h, double p) {
+  if (h->total == 0)
+    return 0;
+
+  if (!(p >= 0))
+    p = 0;
+
+  if (p > 100)
+    p = 100;
+
+  double want = (p / 100) * (double)h->total + 0.5;
+  uint64_t target = h->total;
+  uint64_t seen = 0;
+
+  if (want < 18446744073709551616.0 && (uint64_t)want < target)
+    target = (uint64_t)want;
+
+  if (target == 0)
+    target = 1;
+
+  size_t first, last;
+  size_t i;
+
+  hist_span(h, &first, &last);
+
+  // High percentiles are found from the top.
+  if (target > h->total / 2) {
+    uint64_t rest = h->total - target;
+
+    for (i = last + 1; i-- > first;) {
+      seen += h->counts[i];
+
+      if (seen > rest)
+        break;
+    }
+  } else {
+    for (i = first; i <= last; i++) {
+      seen += h->counts[i];
+
+      if (seen >= target)
+        break;
+    }
+  }
+
+  if (i < first || i > last)
+    return h->max;
+
+  uint64_t size;
+  uint64_t value = hist_value(h, i, &size) | (size - 1);
+
+  return value < h->max ? value : h->max;
+}
+
+double
+n64_hist_mean(const n64_hist_t *h) {
+  if (h->total == 0)
+    return 0;
+
+  double sum = 0;
+  size_t first, last;
+
+  hist_span(h, &first, &last);
+
+  for (size_t i = first; i <= last; i++) {
+    if (h->counts[i] != 0) {
+      uint64_t size;
+      uint64_t value = hist_value(h, i, &size) | (size >> 1);
+
+      sum += (double)value * (double)h->counts[i];
+    }
+  }
+
+  return sum / (double)h->total;
+}
+
+int
+n64_hist_merge(n64_hist_t *h, const n64_hist_t *other, int sign) {
+  size_t end = other->len;
+  uint64_t size;
+
+  while (end > 0 && other->counts[end - 1] == 0)
+    end -= 1;
+
+  if (end == 0)
+    return 1;
+
+  // Slots are monotonic, so checking the
+  // last one covers every other.
+  uint64_t top = hist_value(other, end - 1, &size);
+
+  if (sign && (int64_t)top < 0)
+    return 0;
+
+  if (hist_index(h, top) >= h->len)
+    return 0;
+
+  int same = h->unit == other->unit && h->shift == other->shift;
+
+  for (size_t i = 0; i < end; i++) {
+    uint64_t count = other->counts[i];
+
+    if (count == 0)
+      continue;
+
+    if (same)
+      h->counts[i] += count;
+    else
+      h->counts[hist_index(h, hist_value(other, i, &size))] += count;
+  }
+
+  h->total += other->total;
+
+  if (other->min < h->min)
+    h->min = other->min;
+
+  if (other->max > h->max)
+    h->max = other->max;
+
+  return 1;
+}
+
+static size_t
+varint_write(uint8_t *out, uint64_t x) {
+  size_t len = 0;
+
+  do {
+    uint8_t ch = x & 0x7f;
+
+    x >>= 7;
+
+    if (x != 0)
+      ch |= 0x80;
+
+    if (out != NULL)
+      out[len] = ch;
+
+    len += 1;
+  } while (x != 0);
+
+  return len;
+}
+
+static int
+varint_read(uint64_t *x, const uint8_t *data, size_t len, size_t *pos) {
+  uint64_t r = 0;
+
+  for (int i = 0; i < 10; i++) {
+    if (*pos >= len)
+      return 0;
+
+    uint8_t ch = data[(*pos)++];
+
+    // Only one bit is left for the tenth byte.
+    if (i == 9 && ch > 1)
+      return 0;
+
+    r |= (uint64_t)(ch & 0x7f) << (i * 7);
+
+    if ((ch & 0x80) == 0) {
+      *x = r;
+      return 1;
+    }
+  }
+
+  return 0;
+}
+
+// A count is written as is. Zeros are written as
+// a 0 followed by the length of the run.
+static size_t
+hist_encode(uint8_t *out, const n64_hist_t *h) {
+  size_t end = h->len;
+  size_t len = 1;
+
+  while (end > 0 && h->counts[end - 1] == 0)
+    end -= 1;
+
+  if (out != NULL)
+    out[0] = (uint8_t)h->digits;
+
+  len += varint_write(out ? out + len : NULL, h->lowest);
+  len += varint_write(out ? out + len : NULL, h->highest);
+  len += varint_write(out ? out + len : NULL, h->min);
+  len += varint_write(out ? out + len : NULL, h->max);
+  len += varint_write(out ? out + len : NULL, end);
+
+  for (size_t i = 0; i < end;) {
+    if (h->counts[i] != 0) {
+      len += varint_write(out ? out + len : NULL, h->counts[i]);
+      i += 1;
+      continue;
+    }
+
+    size_t run = 0;
+
+    while (h->counts[i + run] == 0)
+      run += 1;
+
+    len += varint_write(out ? out + len : NULL, 0);
+    len += varint_write(out ? out + len : NULL, run);
+
+    i += run;
+  }
+
+  return len;
+}
+
+size_t
+n64_hist_encode_size(const n64_hist_t *h) {
+  return hist_encode(NULL, h);
+}
+
+size_t
+n64_hist_encode(uint8_t *out, const n64_hist_t *h) {
+  return hist_encode(out, h);
+}
+
+size_t
+n64_hist_decode_layout(n64_hist_t *h, const uint8_t *data, size_t len) {
+  uint64_t lowest, highest, min, max;
+  size_t pos = 1;
+
+  if (len < 1)
+    return 0;
+
+  if (!varint_read(&lowest, data, len, &pos)
+      || !varint_read(&highest, data, len, &pos)
+      || !varint_read(&min, data, len, &pos)
+      || !varint_read(&max, data, len, &pos)) {
+    return 0;
+  }
+
+  if (!n64_hist_layout(h, lowest, highest, data[0]))
+    return 0;
+
+  h->min = min;
+  h->max = max;
+
+  return pos;
+}
+
+int
+n64_hist_decode_counts(n64_hist_t *h, const uint8_t *data, size_t len) {
+  uint64_t end, count, run;
+  uint64_t total = 0;
+  size_t pos = 0;
+  size_t i = 0;
+
+  if (!varint_read(&end, data, len, &pos) || end > h->len)
+    return 0;
+
+  memset(h->counts, 0, h->len * sizeof(uint64_t));
+
+  while (i < end) {
+    if (!varint_read(&count, data, len, &pos))
+      return 0;
+
+    if (count != 0) {
+      h->counts[i++] = count;
+      total += count;
+      continue;
+    }
+
+    if (!varint_read(&run, data, len, &pos))
+      return 0;
+
+    if (run == 0 || run > end - i)
+      return 0;
+
+    i += run;
+  }
+
+  if (pos != len)
+    return 0;
+
+  h->total = total;
+
+  return 1;
+}
+
+/*
+ * Records
+ */
+
+// Host order loads and stores of 1, 2, 4 or 8 bytes.
+
+static inline uint64_t
+column_load(const uint8_t *p, uint32_t width) {
+  switch (width) {
+    case 1:
+      return p[0];
+    case 2: {
+      uint16_t x;
+      memcpy(&x, p, 2);
+      return x;
+    }
+    case 4: {
+      uint32_t x;
+      memcpy(&x, p, 4);
+      return x;
+    }
+    default: {
+      uint64_t x;
+      memcpy(&x, p, 8);
+      return x;
+    }
+  }
+}
+
+static inline void
+column_store(uint8_t *p, uint32_t width, uint64_t x) {
+  switch (width) {
+    case 1:
+      p[0] = (uint8_t)x;
+      break;
+    case 2: {
+      uint16_t y = (uint16_t)x;
+      memcpy(p, &y, 2);
+      break;
+    }
+    case 4: {
+      uint32_t y = (uint32_t)x;
+      memcpy(p, &y, 4);
+      break;
+    }
+    default: {
+      memcpy(p, &x, 8);
+      break;
+    }
+  }
+}
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+static inline uint64_t
+field_load(const uint8_t *p, uint32_t width, int be) {
+  uint64_t x = column_load(p, width);
+
+  if (be)
+    x = bswap64(x) >> (64 - width * 8);
+
+  return x;
+}
+
+static inline void
+field_store(uint8_t *p, uint32_t width, int be, uint64_t x) {
+  if (be)
+    x = bswap64(x) >> (64 - width * 8);
+
+  column_store(p, width, x);
+}
+#else
+static inline uint64_t
+field_load(const uint8_t *p, uint32_t width, int be) {
+  uint64_t x = 0;
+
+  if (be) {
+    for (uint32_t i = 0; i < width; i++)
+      x = (x << 8) | p[i];
+  } else {
+    for (uint32_t i = width; i-- > 0;)
+      x = (x << 8) | p[i];
+  }
+
+  return x;
+}
+
+static inline void
+field_store(uint8_t *p, uint32_t width, int be, uint64_t x) {
+  if (be) {
+    for (uint32_t i = width; i-- > 0;) {
+      p[i] = (uint8_t)x;
+      x >>= 8;
+    }
+  } else {
+    for (uint32_t i = 0; i < width; i++) {
+      p[i] = (uint8_t)x;
+      x >>= 8;
+    }
+  }
+}
+#endif
+
+uint64_t
+n64_field_read(const uint8_t *rec, const n64_field_t *f) {
+  uint64_t x = field_load(rec + f->offset, f->width, f->be);
+
+  if (f->sign && f->width < 8) {
+    int bits = 64 - (int)f->width * 8;
+    x = (uint64_t)((int64_t)(x << bits) >> bits);
+  }
+
+  return x;
+}
+
+void
+n64_field_write(uint8_t *rec, const n64_field_t *f, uint64_t value) {
+  field_store(rec + f->offset, f->width, f->be, value);
+}
+
+// Called with constant widths so that each case
+// compiles to a plain strided copy.
+
+static inline void
+gather_loop(uint8_t *dst, const uint8_t *src, size_t stride,
+            size_t count, uint32_t width, int be) {
+  for (size_t i = 0; i < count; i++) {
+    uint64_t x = field_load(src + i * stride, width, be);
+    column_store(dst + i * width, width, x);
+  }
+}
+
+static inline void
+scatter_loop(uint8_t *dst, size_t stride, const uint8_t *src,
+             size_t count, uint32_t width, int be) {
+  for (size_t i = 0; i < count; i++) {
+    uint64_t x = column_load(src + i * width, width);
+    field_store(dst + i * stride, width, be, x);
+  }
+}
+
+void
+n64_field_gather(uint8_t *dst, const uint8_t *src, size_t stride,
+                 size_t count, const n64_field_t *f) {
+  src += f->offset;
+
+  switch (f->width) {
+    case 1:
+      gather_loop(dst, src, stride, count, 1, 0);
+      break;
+    case 2:
+      if (f->be)
+        gather_loop(dst, src, stride, count, 2, 1);
+      else
+        gather_loop(dst, src, stride, count, 2, 0);
+      break;
+    case 4:
+      if (f->be)
+        gather_loop(dst, src, stride, count, 4, 1);
+      else
+        gather_loop(dst, src, stride, count, 4, 0);
+      break;
+    default:
+      if (f->be)
+        gather_loop(dst, src, stride, count, 8, 1);
+      else
+        gather_loop(dst, src, stride, count, 8, 0);
+      break;
+  }
+}
+
+void
+n64_field_scatter(uint8_t *dst, size_t stride, const uint8_t *src,
+                  size_t count, const n64_field_t *f) {
+  dst += f->offset;
+
+  switch (f->width) {
+    case 1:
+      scatter_loop(dst, stride, src, count, 1, 0);
+      break;
+    case 2:
+      if (f->be)
+        scatter_loop(dst, stride, src, count, 2, 1);
+      else
+        scatter_loop(dst, stride, src, count, 2, 0);
+      break;
+    case 4:
+      if (f->be)
+        scatter_loop(dst, stride, src, count, 4, 1);
+      else
+        scatter_loop(dst, stride, src, count, 4, 0);
+      break;
+    default:
+      if (f->be)
+        scatter_loop(dst, stride, src, count, 8, 1);
+      else
+        scatter_loop(dst, stride, src, count, 8, 0);
+      break;
+  }
+}
+
+/*
+ * Predicates
+ */
+
+// Words are tested in blocks of this many when
+// only a count or selection is wanted.
+#define WHERE_BLOCK 4096
+
+// Sets this small are scanned rather than searched.
+#define WHERE_SCAN 32
+
+static inline int
+popcount64(uint64_t x) {
+#if defined(__GNUC__)
+  return __builtin_popcountll(x);
+#else
+  x = x - ((x >> 1) & 0x5555555555555555ull);
+  x = (x & 0x3333333333333333ull) + ((x >> 2) & 0x3333333333333333ull);
+  x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0full;
+  return (int)((x * 0x0101010101010101ull) >> 56);
+#endif
+}
+
+static int
+where_cmp(const void *a, const void *b) {
+  uint64_t x = *(const uint64_t *)a;
+  uint64_t y = *(const uint64_t *)b;
+  return (x > y) - (x < y);
+}
+
+// Branch free, as lookups from a column
+// are about as predictable as coin flips.
+static inline int
+where_has(const uint64_t *set, size_t len, uint64_t x) {
+  const uint64_t *base = set;
+
+  while (len > 1) {
+    size_t half = len >> 1;
+
+    base = base[half] <= x ? base + half : base;
+    len -= half;
+  }
+
+  return *base == x;
+}
+
+int
+n64_where_init(n64_where_t *w, int op, uint64_t a, uint64_t b, int sign) {
+  uint64_t bias = sign ? 0x8000000000000000ull : 0;
+  uint64_t lo = 0;
+  uint64_t hi = UINT64_MAX;
+  int invert = 0;
+  int none = 0;
+
+  a ^= bias;
+  b ^= bias;
+
+  switch (op) {
+    case N64_WHERE_EQ:
+      lo = a;
+      hi = a;
+      break;
+    case N64_WHERE_NE:
+      lo = a;
+      hi = a;
+      invert = 1;
+      break;
+    case N64_WHERE_LT:
+      none = a == 0;
+      hi = a - 1;
+      break;
+    case N64_WHERE_LTE:
+      hi = a;
+      break;
+    case N64_WHERE_GT:
+      none = a == UINT64_MAX;
+      lo = a + 1;
+      break;
+    case N64_WHERE_GTE:
+      lo = a;
+      break;
+    case N64_WHERE_BETWEEN:
+      none = a > b;
+      lo = a;
+      hi = b;
+      break;
+    default:
+      return 0;
+  }
+
+  w->bias = bias;
+  w->lo = lo;
+  w->span = hi - lo;
+  w->invert = invert;
+  w->none = none;
+  w->set = NULL;
+  w->len = 0;
+
+  return 1;
+}
+
+void
+n64_where_set(n64_where_t *w, uint64_t *set, size_t len, int sign) {
+  uint64_t bias = sign ? 0x8000000000000000ull : 0;
+
+  for (size_t i = 0; i < len; i++)
+    set[i] ^= bias;
+
+  qsort(set, len, sizeof(uint64_t), where_cmp);
+
+  w->bias = bias;
+  w->lo = 0;
+  w->span = 0;
+  w->invert = 0;
+  w->none = len == 0;
+  w->set = set;
+  w->len = len;
+}
+
+// Whole bytes at a time from word `i`, which
+// is a multiple of 8, to the end.
+static inline void
+where_tail(uint8_t *bits, const uint8_t *src, size_t i, size_t count,
+           uint64_t bias, uint64_t lo, uint64_t span) {
+  for (; i < count; i += 8) {
+    size_t n = count - i < 8 ? count - i : 8;
+    unsigned byte = 0;
+
+    for (size_t j = 0; j < n; j++) {
+      uint64_t x = read64le(src + (i + j) * 8);
+      byte |= (unsigned)(((x ^ bias) - lo) <= span) << j;
+    }
+
+    bits[i >> 3] = (uint8_t)byte;
+  }
+}
+
+void
+n64_where_scalar(uint8_t *bits, const uint8_t *src, size_t count,
+                 uint64_t bias, uint64_t lo, uint64_t span) {
+  where_tail(bits, src, 0, count, bias, lo, span);
+}
+
+#if defined(N64_HAVE_AVX2)
+N64_TARGET("avx2") void
+n64_where_avx2(uint8_t *bits, const uint8_t *src, size_t count,
+               uint64_t bias, uint64_t lo, uint64_t span) {
+  // AVX2 only compares signed words, so both
+  // sides of `x > span` get their top bit flipped.
+  const __m256i b = _mm256_set1_epi64x((long long)bias);
+  const __m256i l = _mm256_set1_epi64x((long long)lo);
+  const __m256i top = _mm256_set1_epi64x(LLONG_MIN);
+  const __m256i s = _mm256_set1_epi64x((long long)(span ^ (uint64_t)LLONG_MIN));
+  size_t i = 0;
+
+  for (; i + 8 <= count; i += 8) {
+    __m256i x0 = _mm256_loadu_si256((const __m256i *)(src + i * 8));
+    __m256i x1 = _mm256_loadu_si256((const __m256i *)(src + i * 8 + 32));
+
+    x0 = _mm256_xor_si256(_mm256_sub_epi64(_mm256_xor_si256(x0, b), l), top);
+    x1 = _mm256_xor_si256(_mm256_sub_epi64(_mm256_xor_si256(x1, b), l), top);
+
+    int m0 = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(x0, s)));
+    int m1 = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(x1, s)));
+
+    bits[i >> 3] = (uint8_t)~(m0 | (m1 << 4));
+  }
+
+  where_tail(bits, src, i, count, bias, lo, span);
+}
+#endif
+
+#if defined(N64_HAVE_AVX512)
+N64_TARGET("avx512f") void
+n64_where_avx512(uint8_t *bits, const uint8_t *src, size_t count,
+                 uint64_t bias, uint64_t lo, uint64_t span) {
+  const __m512i b = _mm512_set1_epi64((long long)bias);
+  const __m512i l = _mm512_set1_epi64((long long)lo);
+  const __m512i s = _mm512_set1_epi64((long long)span);
+  size_t i = 0;
+
+  // One mask register is one byte of the bitmap.
+  for (; i + 8 <= count; i += 8) {
+    __m512i x = _mm512_loadu_si512((const void *)(src + i * 8));
+
+    x = _mm512_sub_epi64(_mm512_xor_si512(x, b), l);
+
+    bits[i >> 3] = (uint8_t)_mm512_cmple_epu64_mask(x, s);
+  }
+
+  where_tail(bits, src, i, count, bias, lo, span);
+}
+#endif
+
+// Small sets take one vector pass per value,
+// larger ones a search per word.
+static void
+where_set_bits(uint8_t *bits, const uint8_t *src, size_t count,
+               const n64_where_t *w) {
+  const uint64_t *set = w->set;
+  const uint64_t bias = w->bias;
+  const size_t len = w->len;
+
+  if (len <= WHERE_SCAN) {
+    uint8_t tmp[WHERE_BLOCK / 8];
+
+    for (size_t i = 0; i < count; i += WHERE_BLOCK) {
+      size_t n = count - i < WHERE_BLOCK ? count - i : WHERE_BLOCK;
+      uint8_t *out = bits + i / 8;
+
+      n64_kernels.where(out, src + i * 8, n, bias, set[0], 0);
+
+      for (size_t k = 1; k < len; k++) {
+        n64_kernels.where(tmp, src + i * 8, n, bias, set[k], 0);
+
+        for (size_t j = 0; j < (n + 7) / 8; j++)
+          out[j] |= tmp[j];
+      }
+    }
+
+    return;
+  }
+
+  for (size_t i = 0; i < count; i += 8) {
+    size_t n = count - i < 8 ? count - i : 8;
+    unsigned byte = 0;
+
+    for (size_t j = 0; j < n; j++) {
+      uint64_t x = read64le(src + (i + j) * 8) ^ bias;
+      byte |= (unsigned)where_has(set, len, x) << j;
+    }
+
+    bits[i >> 3] = (uint8_t)byte;
+  }
+}
+
+void
+n64_where_bits(uint8_t *bits, const uint8_t *src, size_t count,
+               const n64_where_t *w) {
+  size_t size = (count + 7) / 8;
+
+  if (w->none) {
+    memset(bits, 0, size);
+    return;
+  }
+
+  if (w->set != NULL)
+    where_set_bits(bits, src, count, w);
+  else
+    n64_kernels.where(bits, src, count, w->bias, w->lo, w->span);
+
+  if (w->invert) {
+    for (size_t i = 0; i < size; i++)
+      bits[i] = (uint8_t)~bits[i];
+
+    if (count & 7)
+      bits[size - 1] &= (uint8_t)((1 << (count & 7)) - 1);
+  }
+}
+
+static size_t
+bits_select(uint32_t *sel, const uint8_t *bits, size_t count, size_t base) {
+  size_t size = (count + 7) / 8;
+  size_t n = 0;
+  size_t j = 0;
+
+  for (; j + 8 <= size; j += 8) {
+    uint64_t m = read64le(bits + j);
+
+    while (m != 0) {
+      sel[n++] = (uint32_t)(base + j * 8 + ctz64(m));
+      m &= m - 1;
+    }
+  }
+
+  for (; j < size; j++) {
+    uint64_t m = bits[j];
+
+    if (j == size - 1 && (count & 7))
+      m &= (1u << (count & 7)) - 1;
+
+    while (m != 0) {
+      sel[n++] = (uint32_t)(base + j * 8 + ctz64(m));
+      m &= m - 1;
+    }
+  }
+
+  return n;
+}
+
+size_t
+n64_where_count(const uint8_t *src, size_t count, const n64_where_t *w) {
+  uint8_t bits[WHERE_BLOCK / 8];
+  size_t total = 0;
+
+  for (size_t i = 0; i < count; i += WHERE_BLOCK) {
+    size_t n = count - i < WHERE_BLOCK ? count - i : WHERE_BLOCK;
+
+    n64_where_bits(bits, src + i * 8, n, w);
+
+    total += n64_bits_count(bits, n);
+  }
+
+  return total;
+}
+
+size_t
+n64_where_select(uint32_t *sel, const uint8_t *src, size_t count,
+                 const n64_where_t *w) {
+  uint8_t bits[WHERE_BLOCK / 8];
+  size_t total = 0;
+
+  for (size_t i = 0; i < count; i += WHERE_BLOCK) {
+    size_t n = count - i < WHERE_BLOCK ? count - i : WHERE_BLOCK;
+
+    n64_where_bits(bits, src + i * 8, n, w);
+
+    total += bits_select(sel + total, bits, n, i);
+  }
+
+  return total;
+}
+
+size_t
+n64_bits_count(const uint8_t *bits, size_t count) {
+  size_t size = count / 8;
+  size_t total = 0;
+  size_t j = 0;
+
+  for (; j + 8 <= size; j += 8)
+    total += popcount64(read64le(bits + j));
+
+  for (; j < size; j++)
+    total += popcount64(bits[j]);
+
+  if (count & 7)
+    total += popcount64(bits[size] & ((1u << (count & 7)) - 1));
+
+  return total;
+}
+
+size_t
+n64_compact_bits(uint8_t *dst, const uint8_t *src, size_t count,
+                 const uint8_t *bits) {
+  size_t size = (count + 7) / 8;
+  size_t n = 0;
+
+  for (size_t j = 0; j < size; j++) {
+    unsigned m = bits[j];
+
+    if (j == size - 1 && (count & 7))
+      m &= (1u << (count & 7)) - 1;
+
+    // Words only move toward the front, so
+    // compacting in place is safe.
+    while (m != 0) {
+      size_t i = j * 8 + ctz64(m);
+
+      memmove(dst + n * 8, src + i * 8, 8);
+
+      n += 1;
+      m &= m - 1;
+    }
+  }
+
+  return n;
+}
+
+int
+n64_compact_select(uint8_t *dst, const uint8_t *src, size_t count,
+                   const uint32_t *sel, size_t len) {
+  for (size_t i = 0; i < len; i++) {
+    if (sel[i] >= count)
+      return 0;
+  }
+
+  for (size_t i = 0; i < len; i++)
+    memcpy(dst + i * 8, src + (size_t)sel[i] * 8, 8);
+
+  return 1;
+}
+
+/*
+ * JSON
+ */
+
+// Characters between values.
+static inline int
+json_space(int ch) {
+  return ch == ' ' || ch == '\t' || ch == '\n' || ch == '\r';
+}
+
+size_t
+n64_json_size(size_t count, uint32_t base, uint32_t pad) {
+  size_t width = base == 2 ? 64 : base == 8 ? 22 : base == 10 ? 20 : 16;
+
+  if (pad > width)
+    width = pad;
+
+  // A sign, two quotes and a comma per value, the
+  // brackets and the NUL which n64_write leaves.
+  return count * (width + 4) + 3;
+}
+
+size_t
+n64_json_write(char *out, const uint8_t *src, size_t count,
+               int sign, uint32_t base, uint32_t pad, int quoted) {
+  char *p = out;
+
+  *p++ = '[';
+
+  for (size_t i = 0; i < count; i++) {
+    if (i > 0)
+      *p++ = ',';
+
+    if (quoted)
+      *p++ = '"';
+
+    p += n64_write(p, read64le(src + i * 8), sign, base, pad);
+
+    if (quoted)
+      *p++ = '"';
+  }
+
+  *p++ = ']';
+
+  return p - out;
+}
+
+void
+n64_json_init(n64_json_t *p, uint32_t base) {
+  p->state = N64_JSON_OPEN;
+  p->base = base;
+  p->len = 0;
+}
+
+// Parses the token held in the state.
+static inline int
+json_value(n64_json_t *p, uint64_t *r, uint32_t base) {
+  int ret = n64_read(r, p->str, p->len, base);
+
+  p->len = 0;
+
+  return ret;
+}
+
+static inline int
+json_digit(int ch) {
+  return ch >= '0' && ch <= '9';
+}
+
+// Bare numbers follow the JSON grammar, which
+// allows no leading zeros (the digits and the
+// sign are checked as they are read).
+static inline int
+json_number(const char *str, size_t len) {
+  if (len > 0 && str[0] == '-') {
+    str += 1;
+    len -= 1;
+  }
+
+  return len > 0 && (str[0] != '0' || len == 1);
+}
+
+int
+n64_json_parse(n64_json_t *p, uint64_t *out, size_t cap, size_t *count,
+               const char *str, size_t len, size_t *used) {
+  // Kept out of `p` in the loop, since
+  // writes to p->str may alias it.
+  int state = p->state;
+  size_t n = 0;
+  size_t i = 0;
+  int ret = N64_OK;
+
+  while (i < len) {
+    int ch = (uint8_t)str[i];
+
+    switch (state) {
+      case N64_JSON_OPEN:
+        if (ch == '[')
+          state = N64_JSON_FIRST;
+        else if (!json_space(ch))
+          goto fail;
+        i += 1;
+        break;
+
+      case N64_JSON_FIRST:
+        if (ch == ']') {
+          state = N64_JSON_DONE;
+          i += 1;
+          break;
+        }
+
+        // Fall through.
+
+      case N64_JSON_VALUE: {
+        if (json_space(ch)) {
+          i += 1;
+          break;
+        }
+
+        if (ch == '"') {
+          const char *start = str + i + 1;
+          const char *end = (const char *)memchr(start, '"', len - i - 1);
+
+          // Values within the chunk are parsed in place.
+          if (end != NULL) {
+            if (n == cap)
+              goto done;
+
+            ret = n64_read(&out[n], start, end - start, p->base);
+
+            if (ret != N64_OK)
+              goto fail;
+
+            n += 1;
+            i += (end - start) + 2;
+            state = N64_JSON_NEXT;
+
+            break;
+          }
+
+          state = N64_JSON_STRING;
+          i += 1;
+
+          break;
+        }
+
+        if (ch != '-' && !json_digit(ch))
+          goto fail;
+
+        size_t j = i + 1;
+
+        while (j < len && json_digit(str[j]))
+          j += 1;
+
+        if (j < len) {
+          // A sign and 20 digits at most.
+          if (j - i > 21)
+            goto fail;
+
+          ch = (uint8_t)str[j];
+
+          if (ch != ',' && ch != ']' && !json_space(ch))
+            goto fail;
+
+          if (n == cap)
+            goto done;
+
+          if (!json_number(str + i, j - i))
+            goto fail;
+
+          // Bare numbers are always decimal.
+          if ((ret = n64_read(&out[n], str + i, j - i, 10)) != N64_OK)
+            goto fail;
+
+          n += 1;
+          i = j;
+          state = N64_JSON_NEXT;
+
+          break;
+        }
+
+        p->str[p->len++] = (char)ch;
+        state = N64_JSON_NUMBER;
+        i += 1;
+
+        break;
+      }
+
+      case N64_JSON_STRING:
+        if (ch != '"') {
+          // A sign and 64 binary digits at most.
+          if (p->len == 65)
+            goto fail;
+
+          p->str[p->len++] = (char)ch;
+          i += 1;
+
+          break;
+        }
+
+        if (n == cap)
+          goto done;
+
+        if ((ret = json_value(p, &out[n], p->base)) != N64_OK)
+          goto fail;
+
+        n += 1;
+        i += 1;
+        state = N64_JSON_NEXT;
+
+        break;
+
+      case N64_JSON_NUMBER:
+        if (json_digit(ch)) {
+          if (p->len == 21)
+            goto fail;
+
+          p->str[p->len++] = (char)ch;
+          i += 1;
+
+          break;
+        }
+
+        if (ch != ',' && ch != ']' && !json_space(ch))
+          goto fail;
+
+        if (!json_number(p->str, p->len))
+          goto fail;
+
+        if (n == cap)
+          goto done;
+
+        if ((ret = json_value(p, &out[n], 10)) != N64_OK)
+          goto fail;
+
+        n += 1;
+        state = N64_JSON_NEXT;
+
+        break;
+
+      case N64_JSON_NEXT:
+        if (ch == ',')
+          state = N64_JSON_VALUE;
+        else if (ch == ']')
+          state = N64_JSON_DONE;
+        else if (!json_space(ch))
+          goto fail;
+        i += 1;
+        break;
+
+      case N64_JSON_DONE:
+        if (!json_space(ch))
+          goto fail;
+        i += 1;
+        break;
+
+      default:
+        goto fail;
+    }
+  }
+
+done:
+  p->state = state;
+  *count = n;
+  *used = i;
+  return N64_OK;
+
+fail:
+  p->state = N64_JSON_ERROR;
+  *count = n;
+  *used = i;
+  return ret != N64_OK ? ret : N64_ERR_PARSE;
+}
+
+int
+n64_json_end(const n64_json_t *p) {
+  return p->state == N64_JSON_DONE ? N64_OK : N64_ERR_PARSE;
+}
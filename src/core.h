@@ -0,0 +1,829 @@
+/**
+ * core.h - int64 kernels for n64.
+ * Copyright (c) 2017, Christopher Jeffrey (MIT License)
+ *
+ * Everything in here is free of V8 and Nan so that it
+ * can be linked into the standalone kernel benchmark.
+ */
+
+#ifndef _N64_CORE_H
+#define _N64_CORE_H
+
+#include <inttypes.h>
+#include <limits.h>
+#include <stddef.h>
+
+/*
+ * N64
+ */
+
+#define N64_MAX_SAFE_INTEGER 0x1fffffffffffffll
+
+// Sign, 64 binary digits and a null terminator.
+#define N64_STR_SIZE 67
+
+#define N64_OK 0
+#define N64_ERR_LENGTH 1
+#define N64_ERR_BASE 2
+#define N64_ERR_OVERFLOW 3
+#define N64_ERR_PARSE 4
+#define N64_ERR_DIGITS 5
+
+static inline int
+n64_is_base(uint32_t base) {
+  return base == 2 || base == 8 || base == 10 || base == 16;
+}
+
+// Sign-dependent helpers are inline so that a
+// constant sign folds away in the bindings.
+
+static inline uint64_t
+n64_div(uint64_t a, uint64_t b, int sign) {
+  if (sign) {
+    if ((int64_t)a == LLONG_MIN && (int64_t)b == -1)
+      return a;
+    return (uint64_t)((int64_t)a / (int64_t)b);
+  }
+
+  return a / b;
+}
+
+static inline uint64_t
+n64_mod(uint64_t a, uint64_t b, int sign) {
+  if (sign) {
+    if ((int64_t)a == LLONG_MIN && (int64_t)b == -1)
+      return 0;
+    return (uint64_t)((int64_t)a % (int64_t)b);
+  }
+
+  return a % b;
+}
+
+static inline int
+n64_cmp(uint64_t a, uint64_t b, int sign) {
+  if (sign) {
+    if ((int64_t)a < (int64_t)b)
+      return -1;
+
+    if ((int64_t)a > (int64_t)b)
+      return 1;
+
+    return 0;
+  }
+
+  if (a < b)
+    return -1;
+
+  if (a > b)
+    return 1;
+
+  return 0;
+}
+
+static inline int
+n64_bitlen(uint64_t n, int sign) {
+  if (sign && (int64_t)n < 0)
+    n = ~n + 1;
+
+#if defined(__GNUC__)
+  return n == 0 ? 0 : 64 - __builtin_clzll(n);
+#else
+  int bit;
+
+  for (bit = 63; bit >= 0; bit--) {
+    if ((n & (1ull << bit)) != 0)
+      break;
+  }
+
+  return bit + 1;
+#endif
+}
+
+static inline int
+n64_is_safe(uint64_t n, int sign) {
+  if (sign) {
+    return (int64_t)n <= N64_MAX_SAFE_INTEGER
+        && (int64_t)n >= -N64_MAX_SAFE_INTEGER;
+  }
+
+  return n <= (uint64_t)N64_MAX_SAFE_INTEGER;
+}
+
+uint64_t
+n64_pow(uint64_t x, uint32_t y);
+
+// Integer roots and logarithms round toward zero.
+// These return 0 when the result is undefined (the
+// square root of a negative, the logarithm of a
+// non-positive) or does not fit in the type.
+
+int
+n64_sqrt(uint64_t *r, uint64_t x, int sign);
+
+int
+n64_cbrt(uint64_t *r, uint64_t x, int sign);
+
+int
+n64_log2(int *r, uint64_t x, int sign);
+
+int
+n64_log10(int *r, uint64_t x, int sign);
+
+int
+n64_gcd(uint64_t *r, uint64_t a, uint64_t b, int sign);
+
+int
+n64_lcm(uint64_t *r, uint64_t a, uint64_t b, int sign);
+
+int
+n64_next_pow2(uint64_t *r, uint64_t x, int sign);
+
+static inline int
+n64_is_pow2(uint64_t x, int sign) {
+  if (sign && (int64_t)x < 0)
+    return 0;
+
+  return x != 0 && (x & (x - 1)) == 0;
+}
+
+size_t
+n64_write(char *str, uint64_t n, int sign, uint32_t base, uint32_t pad);
+
+int
+n64_read(uint64_t *r, const char *str, size_t len, uint32_t base);
+
+int64_t
+n64_read_lines(uint64_t *out, uint8_t *valid, size_t count,
+               const char *str, size_t len, uint32_t base);
+
+size_t
+n64_count_records(const char *str, size_t len);
+
+const char *
+n64_skip_records(const char *str, const char *end, size_t *count);
+
+int64_t
+n64_read_column(uint64_t *out, uint8_t *valid, size_t count,
+                const char *str, size_t len, int delim,
+                uint32_t column, uint32_t base);
+
+/*
+ * N128
+ */
+
+// Kept as two halves so that the layout is the same
+// everywhere. Where the compiler has __int128 (GCC and
+// Clang on 64 bit targets) the helpers below compile
+// down to it; elsewhere they fall back to 64 bit math.
+typedef struct n128_s {
+  uint64_t lo;
+  uint64_t hi;
+} n128_t;
+
+// Sign, 128 binary digits and a null terminator.
+#define N128_STR_SIZE 131
+
+#ifdef __SIZEOF_INT128__
+static inline unsigned __int128
+n128_unpack(n128_t x) {
+  return ((unsigned __int128)x.hi << 64) | x.lo;
+}
+
+static inline n128_t
+n128_pack(unsigned __int128 x) {
+  n128_t r;
+  r.lo = (uint64_t)x;
+  r.hi = (uint64_t)(x >> 64);
+  return r;
+}
+#endif
+
+static inline n128_t
+n128_make(uint64_t hi, uint64_t lo) {
+  n128_t r;
+  r.lo = lo;
+  r.hi = hi;
+  return r;
+}
+
+static inline n128_t
+n128_extend(uint64_t x, int sign) {
+  // Widens a 64 bit word, sign-extending it for I64.
+  return n128_make(sign && (int64_t)x < 0 ? UINT64_MAX : 0, x);
+}
+
+static inline int
+n128_is_zero(n128_t a) {
+  return (a.hi | a.lo) == 0;
+}
+
+static inline int
+n128_is_neg(n128_t a, int sign) {
+  return sign && (int64_t)a.hi < 0;
+}
+
+static inline int
+n128_eq(n128_t a, n128_t b) {
+  return a.hi == b.hi && a.lo == b.lo;
+}
+
+static inline n128_t
+n128_add(n128_t a, n128_t b) {
+#ifdef __SIZEOF_INT128__
+  return n128_pack(n128_unpack(a) + n128_unpack(b));
+#else
+  n128_t r;
+  r.lo = a.lo + b.lo;
+  r.hi = a.hi + b.hi + (r.lo < a.lo);
+  return r;
+#endif
+}
+
+static inline n128_t
+n128_sub(n128_t a, n128_t b) {
+#ifdef __SIZEOF_INT128__
+  return n128_pack(n128_unpack(a) - n128_unpack(b));
+#else
+  n128_t r;
+  r.lo = a.lo - b.lo;
+  r.hi = a.hi - b.hi - (a.lo < b.lo);
+  return r;
+#endif
+}
+
+static inline n128_t
+n128_not(n128_t a) {
+  return n128_make(~a.hi, ~a.lo);
+}
+
+static inline n128_t
+n128_neg(n128_t a) {
+  return n128_add(n128_not(a), n128_make(0, 1));
+}
+
+static inline n128_t
+n128_shl(n128_t a, uint32_t bits) {
+  if (bits == 0)
+    return a;
+
+  if (bits >= 64)
+    return n128_make(a.lo << (bits - 64), 0);
+
+  return n128_make((a.hi << bits) | (a.lo >> (64 - bits)), a.lo << bits);
+}
+
+static inline n128_t
+n128_shr(n128_t a, uint32_t bits, int sign) {
+  // Arithmetic for I128, logical otherwise.
+  uint64_t fill = n128_is_neg(a, sign) ? UINT64_MAX : 0;
+
+  if (bits == 0)
+    return a;
+
+  if (bits >= 64) {
+    bits -= 64;
+
+    if (bits == 0)
+      return n128_make(fill, a.hi);
+
+    return n128_make(fill, (a.hi >> bits) | (fill << (64 - bits)));
+  }
+
+  return n128_make((a.hi >> bits) | (fill << (64 - bits)),
+                   (a.lo >> bits) | (a.hi << (64 - bits)));
+}
+
+static inline int
+n128_cmp(n128_t a, n128_t b, int sign) {
+  if (a.hi != b.hi) {
+    if (sign)
+      return (int64_t)a.hi < (int64_t)b.hi ? -1 : 1;
+
+    return a.hi < b.hi ? -1 : 1;
+  }
+
+  if (a.lo != b.lo)
+    return a.lo < b.lo ? -1 : 1;
+
+  return 0;
+}
+
+static inline n128_t
+n128_abs(n128_t a, int sign) {
+  return n128_is_neg(a, sign) ? n128_neg(a) : a;
+}
+
+static inline int
+n128_bitlen(n128_t n, int sign) {
+  n = n128_abs(n, sign);
+
+  if (n.hi != 0)
+    return 64 + n64_bitlen(n.hi, 0);
+
+  return n64_bitlen(n.lo, 0);
+}
+
+static inline int
+n128_is_safe(n128_t n, int sign) {
+  n = n128_abs(n, sign);
+  return n.hi == 0 && n.lo <= (uint64_t)N64_MAX_SAFE_INTEGER;
+}
+
+static inline int
+n128_fits64(n128_t n, int from, int to) {
+  // Whether a 128 bit value narrows to a
+  // U64 (to = 0) or I64 (to = 1) as is.
+  if (n128_is_neg(n, from))
+    return to && n.hi == UINT64_MAX && (int64_t)n.lo < 0;
+
+  return n.hi == 0 && (!to || (int64_t)n.lo >= 0);
+}
+
+n128_t
+n128_mul(n128_t a, n128_t b);
+
+n128_t
+n128_div(n128_t a, n128_t b, int sign);
+
+n128_t
+n128_mod(n128_t a, n128_t b, int sign);
+
+n128_t
+n128_pow(n128_t x, uint32_t y);
+
+double
+n128_to_double(n128_t n, int sign);
+
+size_t
+n128_write(char *str, n128_t n, int sign, uint32_t base, uint32_t pad);
+
+int
+n128_read(n128_t *r, const char *str, size_t len, uint32_t base);
+
+/*
+ * Atomics
+ */
+
+// Sequentially consistent, like JS Atomics. The
+// pointer must be 8 byte aligned.
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+
+static inline uint64_t
+n64_atomic_load(uint64_t *p) {
+  return (uint64_t)_InterlockedCompareExchange64((volatile __int64 *)p, 0, 0);
+}
+
+static inline void
+n64_atomic_store(uint64_t *p, uint64_t v) {
+  _InterlockedExchange64((volatile __int64 *)p, (__int64)v);
+}
+
+static inline uint64_t
+n64_atomic_add(uint64_t *p, uint64_t v) {
+  return (uint64_t)_InterlockedExchangeAdd64((volatile __int64 *)p, (__int64)v);
+}
+
+static inline uint64_t
+n64_atomic_and(uint64_t *p, uint64_t v) {
+  return (uint64_t)_InterlockedAnd64((volatile __int64 *)p, (__int64)v);
+}
+
+static inline uint64_t
+n64_atomic_or(uint64_t *p, uint64_t v) {
+  return (uint64_t)_InterlockedOr64((volatile __int64 *)p, (__int64)v);
+}
+
+static inline uint64_t
+n64_atomic_xor(uint64_t *p, uint64_t v) {
+  return (uint64_t)_InterlockedXor64((volatile __int64 *)p, (__int64)v);
+}
+
+static inline uint64_t
+n64_atomic_exchange(uint64_t *p, uint64_t v) {
+  return (uint64_t)_InterlockedExchange64((volatile __int64 *)p, (__int64)v);
+}
+
+static inline int
+n64_atomic_cas(uint64_t *p, uint64_t *expected, uint64_t v) {
+  uint64_t prev = (uint64_t)_InterlockedCompareExchange64(
+    (volatile __int64 *)p, (__int64)v, (__int64)*expected);
+
+  if (prev == *expected)
+    return 1;
+
+  *expected = prev;
+
+  return 0;
+}
+#else
+static inline uint64_t
+n64_atomic_load(uint64_t *p) {
+  return __atomic_load_n(p, __ATOMIC_SEQ_CST);
+}
+
+static inline void
+n64_atomic_store(uint64_t *p, uint64_t v) {
+  __atomic_store_n(p, v, __ATOMIC_SEQ_CST);
+}
+
+static inline uint64_t
+n64_atomic_add(uint64_t *p, uint64_t v) {
+  return __atomic_fetch_add(p, v, __ATOMIC_SEQ_CST);
+}
+
+static inline uint64_t
+n64_atomic_and(uint64_t *p, uint64_t v) {
+  return __atomic_fetch_and(p, v, __ATOMIC_SEQ_CST);
+}
+
+static inline uint64_t
+n64_atomic_or(uint64_t *p, uint64_t v) {
+  return __atomic_fetch_or(p, v, __ATOMIC_SEQ_CST);
+}
+
+static inline uint64_t
+n64_atomic_xor(uint64_t *p, uint64_t v) {
+  return __atomic_fetch_xor(p, v, __ATOMIC_SEQ_CST);
+}
+
+static inline uint64_t
+n64_atomic_exchange(uint64_t *p, uint64_t v) {
+  return __atomic_exchange_n(p, v, __ATOMIC_SEQ_CST);
+}
+
+static inline int
+n64_atomic_cas(uint64_t *p, uint64_t *expected, uint64_t v) {
+  return __atomic_compare_exchange_n(p, expected, v, 0,
+                                     __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+#endif
+
+/*
+ * Bulk
+ */
+
+// Elements are 8 byte little endian words at any
+// alignment. Outputs must not overlap inputs, but
+// n64_bswap64 may run in place.
+
+void
+n64_bswap64(uint8_t *dst, const uint8_t *src, size_t count);
+
+void
+n64_split(int32_t *hi, int32_t *lo, const uint8_t *src, size_t count);
+
+void
+n64_join(uint8_t *dst, const int32_t *hi, const int32_t *lo, size_t count);
+
+// Passed instead of a rounding mode, converts only
+// safe integers and reports everything else.
+#define N64_STRICT (-1)
+
+size_t
+n64_to_float64(double *dst, const uint8_t *src, size_t count,
+               int sign, int mode, uint32_t *bad);
+
+size_t
+n64_from_float64(uint8_t *dst, const double *src, size_t count,
+                 int sign, int mode, uint32_t *bad);
+
+/*
+ * Linear algebra
+ */
+
+// Products are accumulated in 128 bits plus a carry
+// word, so sums are exact for any count. The dot
+// product returns 0 if the sum does not fit in 128
+// bits. The others store the low 64 bits of each
+// result and report those which do not fit in 64.
+
+int
+n64_dot(n128_t *r, const uint8_t *a, const uint8_t *b,
+        size_t count, int sign);
+
+size_t
+n64_axpy(uint8_t *dst, uint64_t alpha, const uint8_t *x,
+         size_t count, int sign, uint32_t *bad);
+
+size_t
+n64_matvec(uint8_t *dst, const uint8_t *m, const uint8_t *x,
+           size_t rows, size_t cols, int sign, uint32_t *bad);
+
+/*
+ * Integer math
+ */
+
+// The batch forms of the functions above. Failed
+// elements are written as 0 (or -1 for logarithms)
+// and their indexes reported. Division by zero
+// fails in n64_divmod_many.
+
+#define N64_MATH_SQRT 0
+#define N64_MATH_CBRT 1
+#define N64_MATH_NEXT_POW2 2
+#define N64_MATH_LOG2 3
+#define N64_MATH_LOG10 4
+#define N64_MATH_GCD 5
+#define N64_MATH_LCM 6
+
+size_t
+n64_math_unary(int op, uint8_t *dst, const uint8_t *src,
+               size_t count, int sign, uint32_t *bad);
+
+size_t
+n64_math_log(int op, int32_t *dst, const uint8_t *src,
+             size_t count, int sign, uint32_t *bad);
+
+size_t
+n64_math_binary(int op, uint8_t *dst, const uint8_t *a, const uint8_t *b,
+                size_t count, int sign, uint32_t *bad);
+
+size_t
+n64_divmod_many(uint8_t *q, uint8_t *r, const uint8_t *a, const uint8_t *b,
+                size_t count, int sign, uint32_t *bad);
+
+/*
+ * Histogram
+ */
+
+// A log-linear (HDR) histogram. Values are grouped into
+// power of two buckets, each split into enough linear
+// sub-buckets to keep `digits` significant decimal
+// digits. The caller owns `counts`, which must hold
+// `len` zeroed words once the layout is known.
+
+#define N64_HIST_MAX_DIGITS 5
+
+typedef struct n64_hist_s {
+  uint64_t lowest;
+  uint64_t highest;
+  int digits;
+  // log2 of the unit, and of half the sub-buckets.
+  int unit;
+  int shift;
+  uint64_t mask;
+  size_t len;
+  uint64_t total;
+  uint64_t min;
+  uint64_t max;
+  uint64_t *counts;
+} n64_hist_t;
+
+// Computes the layout. Returns 0 if the range
+// or precision cannot be represented.
+int
+n64_hist_layout(n64_hist_t *h, uint64_t lowest, uint64_t highest, int digits);
+
+void
+n64_hist_reset(n64_hist_t *h);
+
+// Values are rejected if negative (when signed)
+// or beyond the last bucket.
+int
+n64_hist_record(n64_hist_t *h, uint64_t value, uint64_t count, int sign);
+
+size_t
+n64_hist_record_many(n64_hist_t *h, const uint8_t *data, size_t count,
+                     int sign, uint32_t *bad);
+
+// The highest value equivalent to the one at `p`
+// percent, capped at the largest value recorded.
+uint64_t
+n64_hist_percentile(const n64_hist_t *h, double p);
+
+double
+n64_hist_mean(const n64_hist_t *h);
+
+// Fails without modifying `h` if any value in
+// `other` falls outside of it.
+int
+n64_hist_merge(n64_hist_t *h, const n64_hist_t *other, int sign);
+
+// Layout, bounds and run-length coded varints.
+size_t
+n64_hist_encode_size(const n64_hist_t *h);
+
+size_t
+n64_hist_encode(uint8_t *out, const n64_hist_t *h);
+
+// Decoding happens in two steps so that the caller
+// can allocate counts in between. The first returns
+// the bytes consumed, or 0 on malformed input.
+size_t
+n64_hist_decode_layout(n64_hist_t *h, const uint8_t *data, size_t len);
+
+int
+n64_hist_decode_counts(n64_hist_t *h, const uint8_t *data, size_t len);
+
+/*
+ * Records
+ */
+
+// One integer field of a fixed layout record.
+typedef struct n64_field_s {
+  uint32_t offset;
+  uint32_t width;
+  int sign;
+  int be;
+} n64_field_t;
+
+// Sign extended when the field is signed.
+uint64_t
+n64_field_read(const uint8_t *rec, const n64_field_t *f);
+
+void
+n64_field_write(uint8_t *rec, const n64_field_t *f, uint64_t value);
+
+// Moves one field of `count` records, `stride` bytes
+// apart, to or from a column of host order integers
+// of the field's width.
+
+void
+n64_field_gather(uint8_t *dst, const uint8_t *src, size_t stride,
+                 size_t count, const n64_field_t *f);
+
+void
+n64_field_scatter(uint8_t *dst, size_t stride, const uint8_t *src,
+                  size_t count, const n64_field_t *f);
+
+/*
+ * Predicates
+ */
+
+#define N64_WHERE_EQ 0
+#define N64_WHERE_NE 1
+#define N64_WHERE_LT 2
+#define N64_WHERE_LTE 3
+#define N64_WHERE_GT 4
+#define N64_WHERE_GTE 5
+#define N64_WHERE_BETWEEN 6
+#define N64_WHERE_IN 7
+
+// Every comparison but IN is a test of whether
+// `(x ^ bias) - lo <= span` as unsigned, where the
+// bias maps signed order onto unsigned order.
+typedef struct n64_where_s {
+  uint64_t bias;
+  uint64_t lo;
+  uint64_t span;
+  int invert;
+  int none;
+  // For IN, biased and sorted.
+  const uint64_t *set;
+  size_t len;
+} n64_where_t;
+
+// BETWEEN is inclusive at both ends.
+int
+n64_where_init(n64_where_t *w, int op, uint64_t a, uint64_t b, int sign);
+
+// Sorts `set` in place and keeps a pointer to it.
+void
+n64_where_set(n64_where_t *w, uint64_t *set, size_t len, int sign);
+
+// Bit i of the bitmap is bits[i / 8] >> (i % 8) & 1.
+// The bits past `count` in the last byte are cleared.
+void
+n64_where_bits(uint8_t *bits, const uint8_t *src, size_t count,
+               const n64_where_t *w);
+
+size_t
+n64_where_count(const uint8_t *src, size_t count, const n64_where_t *w);
+
+size_t
+n64_where_select(uint32_t *sel, const uint8_t *src, size_t count,
+                 const n64_where_t *w);
+
+size_t
+n64_bits_count(const uint8_t *bits, size_t count);
+
+// Copies the words whose bit is set to the front of `dst`,
+// which may be `src` itself.
+size_t
+n64_compact_bits(uint8_t *dst, const uint8_t *src, size_t count,
+                 const uint8_t *bits);
+
+// Copies src[sel[i]] to dst[i]. Returns 0 if an index is
+// out of range, in which case nothing is written.
+int
+n64_compact_select(uint8_t *dst, const uint8_t *src, size_t count,
+                   const uint32_t *sel, size_t len);
+
+/*
+ * JSON
+ */
+
+#define N64_JSON_OPEN 0
+#define N64_JSON_FIRST 1
+#define N64_JSON_VALUE 2
+#define N64_JSON_STRING 3
+#define N64_JSON_NUMBER 4
+#define N64_JSON_NEXT 5
+#define N64_JSON_DONE 6
+#define N64_JSON_ERROR 7
+
+// Where a parse left off, so that input
+// may arrive in chunks split anywhere.
+typedef struct n64_json_s {
+  int state;
+  uint32_t base;
+  size_t len;
+  char str[N64_STR_SIZE];
+} n64_json_t;
+
+// An upper bound on what n64_json_write writes.
+size_t
+n64_json_size(size_t count, uint32_t base, uint32_t pad);
+
+// Writes the words of `src` as a JSON array, of strings
+// when `quoted`. Returns the size, without a NUL.
+size_t
+n64_json_write(char *out, const uint8_t *src, size_t count,
+               int sign, uint32_t base, uint32_t pad, int quoted);
+
+void
+n64_json_init(n64_json_t *p, uint32_t base);
+
+// Parses the next `len` bytes of an array of strings in
+// `base` or of decimal numbers, writing up to `cap` values
+// to `out`. Stops early once `out` is full; `*used` is how
+// far it got. A failed parse cannot be resumed.
+int
+n64_json_parse(n64_json_t *p, uint64_t *out, size_t cap, size_t *count,
+               const char *str, size_t len, size_t *used);
+
+// Whether the array was closed.
+int
+n64_json_end(const n64_json_t *p);
+
+/*
+ * RNG
+ */
+
+typedef struct rng_s {
+  uint64_t s[4];
+} rng_t;
+
+void
+rng_seed(rng_t *r, uint64_t seed);
+
+uint64_t
+rng_next(rng_t *r);
+
+uint64_t
+rng_below(rng_t *r, uint64_t bound);
+
+void
+rng_jump(rng_t *r);
+
+void
+rng_fill(rng_t *r, uint8_t *data, size_t len);
+
+/*
+ * Dec64
+ */
+
+#define DEC64_MAX_SCALE 18
+
+// Sign, 19 digits, point, padding zeros and a null terminator.
+#define DEC64_STR_SIZE 48
+
+enum {
+  ROUND_DOWN = 0,
+  ROUND_UP = 1,
+  ROUND_FLOOR = 2,
+  ROUND_CEIL = 3,
+  ROUND_HALF_UP = 4,
+  ROUND_HALF_DOWN = 5,
+  ROUND_HALF_EVEN = 6
+};
+
+int
+dec_rescale(int64_t x, uint32_t from, uint32_t to, int mode, int64_t *out);
+
+int
+dec_add(int64_t a, uint32_t sa, int64_t b, uint32_t sb, int sub,
+        int64_t *out, uint32_t *so);
+
+int
+dec_mul(int64_t a, int64_t b, uint32_t sb, int mode, int64_t *out);
+
+int
+dec_div(int64_t a, int64_t b, uint32_t sb, int mode, int64_t *out);
+
+int
+dec_cmp(int64_t a, uint32_t sa, int64_t b, uint32_t sb);
+
+double
+dec_to_double(int64_t n, uint32_t scale);
+
+size_t
+dec_format(char *str, int64_t n, uint32_t scale);
+
+int
+dec_parse(const char *str, size_t len, int32_t *scale,
+          int mode, int64_t *out);
+
+#endif
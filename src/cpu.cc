@@ -0,0 +1,280 @@
+/**
+ * cpu.cc - runtime kernel selection for n64.
+ * Copyright (c) 2017, Christopher Jeffrey (MIT License)
+ */
+
+#include <inttypes.h>
+#include <stddef.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+#include "cpu.h"
+
+/*
+ * Baseline
+ */
+
+// What the compiler flags allow, so that the standalone
+// benchmark and anything else which never calls
+// n64_cpu_init() behave as before.
+
+#if defined(N64_SSSE3)
+#define BASE_BSWAP64 n64_bswap64_ssse3
+#define BASE_BSWAP64_NAME "ssse3"
+#elif defined(N64_SSE2)
+#define BASE_BSWAP64 n64_bswap64_sse2
+#define BASE_BSWAP64_NAME "sse2"
+#elif defined(N64_NEON)
+#define BASE_BSWAP64 n64_bswap64_neon
+#define BASE_BSWAP64_NAME "neon"
+#else
+#define BASE_BSWAP64 n64_bswap64_scalar
+#define BASE_BSWAP64_NAME "scalar"
+#endif
+
+// The compiler vectorizes the plain loops.
+#define BASE_SPLIT n64_split_scalar
+#define BASE_JOIN n64_join_scalar
+#define BASE_PAIRS_NAME "scalar"
+
+#if defined(N64_SSE2)
+#define BASE_TO_FLOAT64 n64_to_float64_sse2
+#define BASE_TO_FLOAT64_NAME "sse2"
+#else
+#define BASE_TO_FLOAT64 n64_to_float64_scalar
+#define BASE_TO_FLOAT64_NAME "scalar"
+#endif
+
+// There is no 64 bit compare before SSE4.2.
+#define BASE_WHERE n64_where_scalar
+#define BASE_WHERE_NAME "scalar"
+
+#if defined(__BMI2__) && defined(__x86_64__)
+#define BASE_HEX16 n64_hex16_bmi2
+#define BASE_BIN64 n64_bin64_bmi2
+#define BASE_FORMAT_NAME "bmi2"
+#else
+#define BASE_HEX16 n64_hex16_scalar
+#define BASE_BIN64 n64_bin64_scalar
+#define BASE_FORMAT_NAME "scalar"
+#endif
+
+n64_kernels_t n64_kernels = {
+  BASE_BSWAP64,
+  BASE_SPLIT,
+  BASE_JOIN,
+  BASE_TO_FLOAT64,
+  BASE_HEX16,
+  BASE_BIN64,
+  BASE_WHERE
+};
+
+static n64_cpu_t cpu = {
+  0,
+  0,
+  BASE_BSWAP64_NAME,
+  BASE_BSWAP64_NAME,
+  BASE_PAIRS_NAME,
+  BASE_PAIRS_NAME,
+  BASE_TO_FLOAT64_NAME,
+  BASE_FORMAT_NAME,
+  BASE_WHERE_NAME
+};
+
+/*
+ * Detection
+ */
+
+#if defined(N64_DISPATCH)
+static uint64_t
+xgetbv0(void) {
+  uint32_t lo, hi;
+  __asm__ __volatile__ ("xgetbv" : "=a" (lo), "=d" (hi) : "c" (0));
+  return ((uint64_t)hi << 32) | lo;
+}
+
+static unsigned
+cpu_detect(void) {
+  unsigned max, a, b, c, d;
+  unsigned features = 0;
+  uint64_t xcr0 = 0;
+
+  if (!__get_cpuid(0, &max, &b, &c, &d) || max < 1)
+    return 0;
+
+  __cpuid(1, a, b, c, d);
+
+  if (d & (1u << 26))
+    features |= N64_CPU_SSE2;
+
+  if (c & (1u << 9))
+    features |= N64_CPU_SSSE3;
+
+  if (c & (1u << 19))
+    features |= N64_CPU_SSE41;
+
+  if (c & (1u << 23))
+    features |= N64_CPU_POPCNT;
+
+  // The OS must save the vector registers
+  // across context switches (OSXSAVE).
+  if (c & (1u << 27))
+    xcr0 = xgetbv0();
+
+  if (max < 7)
+    return features;
+
+  bool avx = (c & (1u << 28)) != 0 && (xcr0 & 0x06) == 0x06;
+  bool zmm = avx && (xcr0 & 0xe0) == 0xe0;
+
+  __cpuid_count(7, 0, a, b, c, d);
+
+  if (avx && (b & (1u << 5)))
+    features |= N64_CPU_AVX2;
+
+  if (b & (1u << 8))
+    features |= N64_CPU_BMI2;
+
+  // F (16), DQ (17), BW (30) and VL (31).
+  if (zmm && (b & 0xc0030000u) == 0xc0030000u)
+    features |= N64_CPU_AVX512;
+
+  return features;
+}
+
+// PDEP is microcoded on AMD before Zen 3 (family 19h),
+// at hundreds of cycles per instruction, which makes
+// the BMI2 formatters far slower than the scalar ones.
+// Hygon's parts are Zen 1.
+static bool
+cpu_slow_pdep(void) {
+  unsigned max, a, b, c, d;
+
+  if (!__get_cpuid(0, &max, &b, &c, &d) || max < 1)
+    return false;
+
+  // "AuthenticAMD" and "HygonGenuine" (EBX, EDX, ECX).
+  bool amd = b == 0x68747541 && d == 0x69746e65 && c == 0x444d4163;
+  bool hygon = b == 0x6f677948 && d == 0x6e65476e && c == 0x656e6975;
+
+  if (!amd && !hygon)
+    return false;
+
+  __cpuid(1, a, b, c, d);
+
+  unsigned family = (a >> 8) & 0x0f;
+
+  if (family == 0x0f)
+    family += (a >> 20) & 0xff;
+
+  return family < 0x19;
+}
+#else
+static unsigned
+cpu_detect(void) {
+  unsigned features = 0;
+
+#if defined(N64_SSE2)
+  features |= N64_CPU_SSE2;
+#endif
+
+#if defined(N64_SSSE3)
+  features |= N64_CPU_SSSE3;
+#endif
+
+#if defined(N64_NEON)
+  features |= N64_CPU_NEON;
+#endif
+
+  return features;
+}
+#endif
+
+/*
+ * Selection
+ */
+
+static void
+select_scalar(void) {
+  n64_kernels.bswap64 = n64_bswap64_scalar;
+  n64_kernels.split = n64_split_scalar;
+  n64_kernels.join = n64_join_scalar;
+  n64_kernels.to_float64 = n64_to_float64_scalar;
+  n64_kernels.hex16 = n64_hex16_scalar;
+  n64_kernels.bin64 = n64_bin64_scalar;
+  n64_kernels.where = n64_where_scalar;
+
+  cpu.path = "scalar";
+  cpu.bswap64 = "scalar";
+  cpu.split = "scalar";
+  cpu.join = "scalar";
+  cpu.to_float64 = "scalar";
+  cpu.format = "scalar";
+  cpu.where = "scalar";
+}
+
+#if defined(N64_DISPATCH)
+static void
+select_best(unsigned features) {
+  // The baseline already covers SSE2. Split and join
+  // stay scalar: the vectorized loops beat the AVX2
+  // and AVX-512 shuffles in n64_bench.
+  if (features & N64_CPU_SSSE3) {
+    n64_kernels.bswap64 = n64_bswap64_ssse3;
+    cpu.path = "ssse3";
+    cpu.bswap64 = "ssse3";
+  }
+
+  if (features & N64_CPU_AVX2) {
+    n64_kernels.bswap64 = n64_bswap64_avx2;
+    n64_kernels.to_float64 = n64_to_float64_avx2;
+    n64_kernels.where = n64_where_avx2;
+
+    cpu.path = "avx2";
+    cpu.bswap64 = "avx2";
+    cpu.to_float64 = "avx2";
+    cpu.where = "avx2";
+  }
+
+  if (features & N64_CPU_AVX512) {
+    n64_kernels.bswap64 = n64_bswap64_avx512;
+    n64_kernels.to_float64 = n64_to_float64_avx512;
+    n64_kernels.where = n64_where_avx512;
+
+    cpu.path = "avx512";
+    cpu.bswap64 = "avx512";
+    cpu.to_float64 = "avx512";
+    cpu.where = "avx512";
+  }
+
+#if defined(N64_HAVE_BMI2)
+  if ((features & N64_CPU_BMI2) && !cpu_slow_pdep()) {
+    n64_kernels.hex16 = n64_hex16_bmi2;
+    n64_kernels.bin64 = n64_bin64_bmi2;
+    cpu.format = "bmi2";
+  }
+#endif
+}
+#endif
+
+void
+n64_cpu_init(int scalar) {
+  cpu.features = cpu_detect();
+  cpu.scalar = scalar;
+
+  if (scalar) {
+    select_scalar();
+    return;
+  }
+
+#if defined(N64_DISPATCH)
+  select_best(cpu.features);
+#endif
+}
+
+const n64_cpu_t *
+n64_cpu(void) {
+  return &cpu;
+}
@@ -0,0 +1,205 @@
+/**
+ * cpu.h - runtime kernel selection for n64.
+ * Copyright (c) 2017, Christopher Jeffrey (MIT License)
+ *
+ * The addon is built once, without ISA flags, and run on
+ * whatever machine loads it. Kernels which benefit from
+ * wider vectors or BMI2 are compiled several times with
+ * per-function target attributes, and n64_cpu_init()
+ * points the table below at the best ones the CPU and OS
+ * support. Like core.h, this is free of V8 and Nan.
+ */
+
+#ifndef _N64_CPU_H
+#define _N64_CPU_H
+
+#include <inttypes.h>
+#include <stddef.h>
+
+/*
+ * Targets
+ */
+
+// Baseline vector paths, chosen at compile time.
+#if defined(__SSE2__) || defined(_M_X64) \
+    || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define N64_SSE2
+#endif
+
+#if defined(__SSSE3__)
+#define N64_SSSE3
+#endif
+
+#if (defined(__ARM_NEON) || defined(__ARM_NEON__)) \
+    && defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define N64_NEON
+#endif
+
+// GCC 5 and clang accept intrinsics inside functions
+// whose target attribute enables them. Elsewhere only
+// the paths enabled by the compiler flags are built.
+#if (defined(__x86_64__) || defined(__i386__)) \
+    && (defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 5))
+#define N64_DISPATCH
+#define N64_TARGET(isa) __attribute__((target(isa)))
+#else
+#define N64_TARGET(isa)
+#endif
+
+#if defined(N64_DISPATCH) || defined(N64_SSSE3)
+#define N64_HAVE_SSSE3
+#endif
+
+#if defined(N64_DISPATCH) || defined(__AVX2__)
+#define N64_HAVE_AVX2
+#endif
+
+#if defined(N64_DISPATCH) \
+    || (defined(__AVX512F__) && defined(__AVX512BW__) \
+        && defined(__AVX512DQ__) && defined(__AVX512VL__))
+#define N64_HAVE_AVX512
+#endif
+
+// _pdep_u64 only exists in 64 bit mode.
+#if (defined(N64_DISPATCH) || defined(__BMI2__)) && defined(__x86_64__)
+#define N64_HAVE_BMI2
+#endif
+
+/*
+ * Features
+ */
+
+#define N64_CPU_SSE2 (1 << 0)
+#define N64_CPU_SSSE3 (1 << 1)
+#define N64_CPU_SSE41 (1 << 2)
+#define N64_CPU_POPCNT (1 << 3)
+#define N64_CPU_AVX2 (1 << 4)
+#define N64_CPU_BMI2 (1 << 5)
+// AVX-512 F, BW, DQ and VL, as on every AVX-512 server part.
+#define N64_CPU_AVX512 (1 << 6)
+#define N64_CPU_NEON (1 << 7)
+
+typedef struct n64_cpu_s {
+  // Detected, whether or not anything uses them.
+  unsigned features;
+  // Set when the scalar kernels were forced.
+  int scalar;
+  // The widest vector path in use.
+  const char *path;
+  // The path each dispatched kernel took.
+  const char *bswap64;
+  const char *split;
+  const char *join;
+  const char *to_float64;
+  const char *format;
+  const char *where;
+} n64_cpu_t;
+
+// Selects the kernels once per process. Until it is
+// called, the baseline compile-time paths are used.
+void
+n64_cpu_init(int scalar);
+
+const n64_cpu_t *
+n64_cpu(void);
+
+/*
+ * Kernels
+ */
+
+typedef struct n64_kernels_s {
+  void (*bswap64)(uint8_t *dst, const uint8_t *src, size_t count);
+  void (*split)(int32_t *hi, int32_t *lo, const uint8_t *src, size_t count);
+  void (*join)(uint8_t *dst, const int32_t *hi, const int32_t *lo,
+               size_t count);
+  // Rounds half to even; see n64_to_float64.
+  void (*to_float64)(double *dst, const uint8_t *src, size_t count, int sign);
+  // Fixed width digits, most significant first.
+  void (*hex16)(char *out, uint64_t n);
+  void (*bin64)(char *out, uint64_t n);
+  // Sets bit i when `(x[i] ^ bias) - lo <= span`, as in
+  // n64_where_t, clearing the rest of the last byte.
+  void (*where)(uint8_t *bits, const uint8_t *src, size_t count,
+                uint64_t bias, uint64_t lo, uint64_t span);
+} n64_kernels_t;
+
+extern n64_kernels_t n64_kernels;
+
+// Variants, defined in core.cc.
+
+void
+n64_bswap64_scalar(uint8_t *dst, const uint8_t *src, size_t count);
+
+void
+n64_split_scalar(int32_t *hi, int32_t *lo, const uint8_t *src, size_t count);
+
+void
+n64_join_scalar(uint8_t *dst, const int32_t *hi, const int32_t *lo,
+                size_t count);
+
+void
+n64_to_float64_scalar(double *dst, const uint8_t *src,
+                      size_t count, int sign);
+
+void
+n64_hex16_scalar(char *out, uint64_t n);
+
+void
+n64_bin64_scalar(char *out, uint64_t n);
+
+void
+n64_where_scalar(uint8_t *bits, const uint8_t *src, size_t count,
+                 uint64_t bias, uint64_t lo, uint64_t span);
+
+#if defined(N64_SSE2)
+void
+n64_bswap64_sse2(uint8_t *dst, const uint8_t *src, size_t count);
+
+void
+n64_to_float64_sse2(double *dst, const uint8_t *src, size_t count, int sign);
+#endif
+
+#if defined(N64_HAVE_SSSE3)
+void
+n64_bswap64_ssse3(uint8_t *dst, const uint8_t *src, size_t count);
+#endif
+
+#if defined(N64_HAVE_AVX2)
+void
+n64_bswap64_avx2(uint8_t *dst, const uint8_t *src, size_t count);
+
+void
+n64_to_float64_avx2(double *dst, const uint8_t *src, size_t count, int sign);
+
+void
+n64_where_avx2(uint8_t *bits, const uint8_t *src, size_t count,
+               uint64_t bias, uint64_t lo, uint64_t span);
+#endif
+
+#if defined(N64_HAVE_AVX512)
+void
+n64_bswap64_avx512(uint8_t *dst, const uint8_t *src, size_t count);
+
+void
+n64_to_float64_avx512(double *dst, const uint8_t *src,
+                      size_t count, int sign);
+
+void
+n64_where_avx512(uint8_t *bits, const uint8_t *src, size_t count,
+                 uint64_t bias, uint64_t lo, uint64_t span);
+#endif
+
+#if defined(N64_HAVE_BMI2)
+void
+n64_hex16_bmi2(char *out, uint64_t n);
+
+void
+n64_bin64_bmi2(char *out, uint64_t n);
+#endif
+
+#if defined(N64_NEON)
+void
+n64_bswap64_neon(uint8_t *dst, const uint8_t *src, size_t count);
+#endif
+
+#endif
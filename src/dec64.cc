@@ -0,0 +1,393 @@
+/**
+ * dec64.cc - native fixed-point decimal object for node.js.
+ * Copyright (c) 2017, Christopher Jeffrey (MIT License)
+ */
+
+#include <node.h>
+#include <nan.h>
+
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "core.h"
+#include "env.h"
+#include "stats.h"
+#include "n64.h"
+#include "dec64.h"
+
+#define ARG_ERROR(name, len) ("Dec64#" #name " requires " #len " argument(s).")
+#define TYPE_ERROR(name, type) ("'" #name "' must be a(n) " #type ".")
+
+/*
+ * Arguments
+ */
+
+static bool
+get_mode(v8::Local<v8::Value> val, int *mode) {
+  if (val->IsNull() || val->IsUndefined()) {
+    *mode = ROUND_HALF_EVEN;
+    return true;
+  }
+
+  if (!val->IsNumber())
+    return false;
+
+  uint32_t m = Nan::To<uint32_t>(val).FromJust();
+
+  if (Nan::To<double>(val).FromJust() != (double)m || m > ROUND_HALF_EVEN)
+    return false;
+
+  *mode = (int)m;
+
+  return true;
+}
+
+static bool
+get_scale(v8::Local<v8::Value> val, uint32_t *scale) {
+  if (!val->IsNumber())
+    return false;
+
+  uint32_t s = Nan::To<uint32_t>(val).FromJust();
+
+  if (Nan::To<double>(val).FromJust() != (double)s || s > DEC64_MAX_SCALE)
+    return false;
+
+  *scale = s;
+
+  return true;
+}
+
+/*
+ * Dec64
+ */
+
+Dec64::Dec64() {
+  n = 0;
+  scale = 0;
+}
+
+Dec64::~Dec64() {}
+
+void
+Dec64::Init(v8::Local<v8::Object> &target) {
+  Nan::HandleScope scope;
+
+  n64_env_t *env = env_get();
+
+  if (env->dec64.IsEmpty()) {
+    v8::Local<v8::FunctionTemplate> tpl =
+      stats_template("Dec64", Dec64::New);
+
+    tpl->SetClassName(Nan::New("Dec64").ToLocalChecked());
+    tpl->InstanceTemplate()->SetInternalFieldCount(1);
+
+    stats_method(tpl, "Dec64", "getScale", Dec64::GetScale);
+    stats_method(tpl, "Dec64", "getRaw", Dec64::GetRaw);
+    stats_method(tpl, "Dec64", "setRaw", Dec64::SetRaw);
+    stats_method(tpl, "Dec64", "iadd", Dec64::Iadd);
+    stats_method(tpl, "Dec64", "isub", Dec64::Isub);
+    stats_method(tpl, "Dec64", "imul", Dec64::Imul);
+    stats_method(tpl, "Dec64", "idiv", Dec64::Idiv);
+    stats_method(tpl, "Dec64", "rescale", Dec64::Rescale);
+    stats_method(tpl, "Dec64", "ineg", Dec64::Ineg);
+    stats_method(tpl, "Dec64", "cmp", Dec64::Cmp);
+    stats_method(tpl, "Dec64", "isZero", Dec64::IsZero);
+    stats_method(tpl, "Dec64", "isNeg", Dec64::IsNeg);
+    stats_method(tpl, "Dec64", "inject", Dec64::Inject);
+    stats_method(tpl, "Dec64", "toDouble", Dec64::ToDouble);
+    stats_method(tpl, "Dec64", "toString", Dec64::ToString);
+    stats_method(tpl, "Dec64", "fromString", Dec64::FromString);
+
+    env->dec64.Reset(tpl);
+  }
+
+  v8::Local<v8::FunctionTemplate> ctor = Nan::New(env->dec64);
+
+  Nan::Set(target, Nan::New("Dec64").ToLocalChecked(),
+    Nan::GetFunction(ctor).ToLocalChecked());
+}
+
+bool Dec64::HasInstance(v8::Local<v8::Value> val) {
+  Nan::HandleScope scope;
+  return Nan::New(env_get()->dec64)->HasInstance(val);
+}
+
+NAN_METHOD(Dec64::New) {
+  if (!info.IsConstructCall())
+    return Nan::ThrowError("Dec64 must be called with `new`.");
+
+  uint32_t scale = 0;
+
+  if (info.Length() > 0 && !get_scale(info[0], &scale))
+    return Nan::ThrowTypeError(TYPE_ERROR(scale, scale));
+
+  Dec64 *obj = new Dec64();
+  obj->scale = scale;
+  obj->Wrap(info.This());
+
+  info.GetReturnValue().Set(info.This());
+}
+
+NAN_METHOD(Dec64::GetScale) {
+  Dec64 *a = ObjectWrap::Unwrap<Dec64>(info.Holder());
+  info.GetReturnValue().Set(Nan::New<v8::Uint32>(a->scale));
+}
+
+NAN_METHOD(Dec64::GetRaw) {
+  Dec64 *a = ObjectWrap::Unwrap<Dec64>(info.Holder());
+
+  if (info.Length() < 1)
+    return Nan::ThrowError(ARG_ERROR(getRaw, 1));
+
+  if (!N64::HasInstance(info[0]))
+    return Nan::ThrowTypeError(TYPE_ERROR(out, int64));
+
+  N64 *b = ObjectWrap::Unwrap<N64>(info[0].As<v8::Object>());
+
+  *b->n = (uint64_t)a->n;
+
+  info.GetReturnValue().Set(info[0]);
+}
+
+NAN_METHOD(Dec64::SetRaw) {
+  Dec64 *a = ObjectWrap::Unwrap<Dec64>(info.Holder());
+
+  if (info.Length() < 2)
+    return Nan::ThrowError(ARG_ERROR(setRaw, 2));
+
+  if (!N64::HasInstance(info[0]))
+    return Nan::ThrowTypeError(TYPE_ERROR(value, int64));
+
+  uint32_t scale;
+
+  if (!get_scale(info[1], &scale))
+    return Nan::ThrowTypeError(TYPE_ERROR(scale, scale));
+
+  N64 *b = ObjectWrap::Unwrap<N64>(info[0].As<v8::Object>());
+
+  a->n = (int64_t)*b->n;
+  a->scale = scale;
+
+  info.GetReturnValue().Set(info.Holder());
+}
+
+NAN_METHOD(Dec64::Iadd) {
+  Dec64 *a = ObjectWrap::Unwrap<Dec64>(info.Holder());
+
+  if (info.Length() < 1)
+    return Nan::ThrowError(ARG_ERROR(iadd, 1));
+
+  if (!Dec64::HasInstance(info[0]))
+    return Nan::ThrowTypeError(TYPE_ERROR(operand, decimal));
+
+  Dec64 *b = ObjectWrap::Unwrap<Dec64>(info[0].As<v8::Object>());
+
+  if (!dec_add(a->n, a->scale, b->n, b->scale, 0, &a->n, &a->scale))
+    return stats_throw(THROW_OVERFLOW, "Decimal overflow.");
+
+  info.GetReturnValue().Set(info.Holder());
+}
+
+NAN_METHOD(Dec64::Isub) {
+  Dec64 *a = ObjectWrap::Unwrap<Dec64>(info.Holder());
+
+  if (info.Length() < 1)
+    return Nan::ThrowError(ARG_ERROR(isub, 1));
+
+  if (!Dec64::HasInstance(info[0]))
+    return Nan::ThrowTypeError(TYPE_ERROR(operand, decimal));
+
+  Dec64 *b = ObjectWrap::Unwrap<Dec64>(info[0].As<v8::Object>());
+
+  if (!dec_add(a->n, a->scale, b->n, b->scale, 1, &a->n, &a->scale))
+    return stats_throw(THROW_OVERFLOW, "Decimal overflow.");
+
+  info.GetReturnValue().Set(info.Holder());
+}
+
+NAN_METHOD(Dec64::Imul) {
+  Dec64 *a = ObjectWrap::Unwrap<Dec64>(info.Holder());
+
+  if (info.Length() < 1)
+    return Nan::ThrowError(ARG_ERROR(imul, 1));
+
+  if (!Dec64::HasInstance(info[0]))
+    return Nan::ThrowTypeError(TYPE_ERROR(multiplicand, decimal));
+
+  int mode;
+
+  if (!get_mode(info[1], &mode))
+    return Nan::ThrowTypeError(TYPE_ERROR(mode, rounding mode));
+
+  Dec64 *b = ObjectWrap::Unwrap<Dec64>(info[0].As<v8::Object>());
+
+  if (!dec_mul(a->n, b->n, b->scale, mode, &a->n))
+    return stats_throw(THROW_OVERFLOW, "Decimal overflow.");
+
+  info.GetReturnValue().Set(info.Holder());
+}
+
+NAN_METHOD(Dec64::Idiv) {
+  Dec64 *a = ObjectWrap::Unwrap<Dec64>(info.Holder());
+
+  if (info.Length() < 1)
+    return Nan::ThrowError(ARG_ERROR(idiv, 1));
+
+  if (!Dec64::HasInstance(info[0]))
+    return Nan::ThrowTypeError(TYPE_ERROR(divisor, decimal));
+
+  int mode;
+
+  if (!get_mode(info[1], &mode))
+    return Nan::ThrowTypeError(TYPE_ERROR(mode, rounding mode));
+
+  Dec64 *b = ObjectWrap::Unwrap<Dec64>(info[0].As<v8::Object>());
+
+  if (b->n == 0)
+    return stats_throw(THROW_DIVZERO, "Cannot divide by zero.");
+
+  if (!dec_div(a->n, b->n, b->scale, mode, &a->n))
+    return stats_throw(THROW_OVERFLOW, "Decimal overflow.");
+
+  info.GetReturnValue().Set(info.Holder());
+}
+
+NAN_METHOD(Dec64::Rescale) {
+  Dec64 *a = ObjectWrap::Unwrap<Dec64>(info.Holder());
+
+  if (info.Length() < 1)
+    return Nan::ThrowError(ARG_ERROR(rescale, 1));
+
+  uint32_t scale;
+
+  if (!get_scale(info[0], &scale))
+    return Nan::ThrowTypeError(TYPE_ERROR(scale, scale));
+
+  int mode;
+
+  if (!get_mode(info[1], &mode))
+    return Nan::ThrowTypeError(TYPE_ERROR(mode, rounding mode));
+
+  if (!dec_rescale(a->n, a->scale, scale, mode, &a->n))
+    return stats_throw(THROW_OVERFLOW, "Decimal overflow.");
+
+  a->scale = scale;
+
+  info.GetReturnValue().Set(info.Holder());
+}
+
+NAN_METHOD(Dec64::Ineg) {
+  Dec64 *a = ObjectWrap::Unwrap<Dec64>(info.Holder());
+
+  if (a->n == INT64_MIN)
+    return stats_throw(THROW_OVERFLOW, "Decimal overflow.");
+
+  a->n = -a->n;
+
+  info.GetReturnValue().Set(info.Holder());
+}
+
+NAN_METHOD(Dec64::Cmp) {
+  Dec64 *a = ObjectWrap::Unwrap<Dec64>(info.Holder());
+
+  if (info.Length() < 1)
+    return Nan::ThrowError(ARG_ERROR(cmp, 1));
+
+  if (!Dec64::HasInstance(info[0]))
+    return Nan::ThrowTypeError(TYPE_ERROR(value, decimal));
+
+  Dec64 *b = ObjectWrap::Unwrap<Dec64>(info[0].As<v8::Object>());
+
+  int32_t r = dec_cmp(a->n, a->scale, b->n, b->scale);
+
+  info.GetReturnValue().Set(Nan::New<v8::Int32>(r));
+}
+
+NAN_METHOD(Dec64::IsZero) {
+  Dec64 *a = ObjectWrap::Unwrap<Dec64>(info.Holder());
+  info.GetReturnValue().Set(Nan::New<v8::Boolean>(a->n == 0));
+}
+
+NAN_METHOD(Dec64::IsNeg) {
+  Dec64 *a = ObjectWrap::Unwrap<Dec64>(info.Holder());
+  info.GetReturnValue().Set(Nan::New<v8::Boolean>(a->n < 0));
+}
+
+NAN_METHOD(Dec64::Inject) {
+  Dec64 *a = ObjectWrap::Unwrap<Dec64>(info.Holder());
+
+  if (info.Length() < 1)
+    return Nan::ThrowError(ARG_ERROR(inject, 1));
+
+  if (!Dec64::HasInstance(info[0]))
+    return Nan::ThrowTypeError(TYPE_ERROR(value, decimal));
+
+  Dec64 *b = ObjectWrap::Unwrap<Dec64>(info[0].As<v8::Object>());
+
+  a->n = b->n;
+  a->scale = b->scale;
+
+  info.GetReturnValue().Set(info.Holder());
+}
+
+NAN_METHOD(Dec64::ToDouble) {
+  Dec64 *a = ObjectWrap::Unwrap<Dec64>(info.Holder());
+  double r = dec_to_double(a->n, a->scale);
+  info.GetReturnValue().Set(Nan::New<v8::Number>(r));
+}
+
+NAN_METHOD(Dec64::ToString) {
+  Dec64 *a = ObjectWrap::Unwrap<Dec64>(info.Holder());
+
+  char str[DEC64_STR_SIZE];
+  size_t size = dec_format(str, a->n, a->scale);
+
+  info.GetReturnValue().Set(
+    Nan::New<v8::String>(str, size).ToLocalChecked());
+}
+
+NAN_METHOD(Dec64::FromString) {
+  Dec64 *a = ObjectWrap::Unwrap<Dec64>(info.Holder());
+
+  if (info.Length() < 1)
+    return Nan::ThrowError(ARG_ERROR(fromString, 1));
+
+  if (!info[0]->IsString())
+    return Nan::ThrowTypeError(TYPE_ERROR(string, string));
+
+  int32_t scale = -1;
+
+  if (info.Length() > 1 && !info[1]->IsNull() && !info[1]->IsUndefined()) {
+    uint32_t s;
+
+    if (!get_scale(info[1], &s))
+      return Nan::ThrowTypeError(TYPE_ERROR(scale, scale));
+
+    scale = (int32_t)s;
+  }
+
+  int mode;
+
+  if (!get_mode(info[2], &mode))
+    return Nan::ThrowTypeError(TYPE_ERROR(mode, rounding mode));
+
+  Nan::Utf8String nstr(info[0]);
+
+  int64_t n;
+  int r = dec_parse(*nstr, nstr.length(), &scale, mode, &n);
+
+  if (r == -1)
+    return stats_throw(THROW_PARSE, "Invalid decimal string.");
+
+  if (r == -2)
+    return Nan::ThrowError("Scale ranges between 0 and 18.");
+
+  if (r == 0)
+    return stats_throw(THROW_OVERFLOW, "Decimal overflow.");
+
+  a->n = n;
+  a->scale = (uint32_t)scale;
+
+  info.GetReturnValue().Set(info.Holder());
+}
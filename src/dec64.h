@@ -0,0 +1,44 @@
+/**
+ * dec64.h - native fixed-point decimal object for node.js.
+ * Copyright (c) 2017, Christopher Jeffrey (MIT License)
+ */
+
+#ifndef _N64_DEC64_H
+#define _N64_DEC64_H
+
+#include <node.h>
+#include <nan.h>
+#include <inttypes.h>
+
+class Dec64 : public Nan::ObjectWrap {
+public:
+  static void Init(v8::Local<v8::Object> &target);
+  static bool HasInstance(v8::Local<v8::Value> val);
+  static NAN_METHOD(New);
+
+  Dec64();
+  ~Dec64();
+
+  int64_t n;
+  uint32_t scale;
+
+private:
+  static NAN_METHOD(GetScale);
+  static NAN_METHOD(GetRaw);
+  static NAN_METHOD(SetRaw);
+  static NAN_METHOD(Iadd);
+  static NAN_METHOD(Isub);
+  static NAN_METHOD(Imul);
+  static NAN_METHOD(Idiv);
+  static NAN_METHOD(Rescale);
+  static NAN_METHOD(Ineg);
+  static NAN_METHOD(Cmp);
+  static NAN_METHOD(IsZero);
+  static NAN_METHOD(IsNeg);
+  static NAN_METHOD(Inject);
+  static NAN_METHOD(ToDouble);
+  static NAN_METHOD(ToString);
+  static NAN_METHOD(FromString);
+};
+
+#endif
@@ -0,0 +1,53 @@
+/**
+ * env.cc - per-isolate state for n64.
+ * Copyright (c) 2017, Christopher Jeffrey (MIT License)
+ */
+
+#include <node.h>
+#include <nan.h>
+
+#include "env.h"
+
+thread_local n64_env_t *n64_env = NULL;
+
+#if NODE_MAJOR_VERSION >= 10
+static void
+env_cleanup(void *arg) {
+  n64_env_t *env = (n64_env_t *)arg;
+
+  env->int64.Reset();
+  env->u64.Reset();
+  env->i64.Reset();
+  env->rng.Reset();
+  env->dec64.Reset();
+  env->array.Reset();
+  env->int128.Reset();
+  env->u128.Reset();
+  env->i128.Reset();
+  env->histogram.Reset();
+  env->structure.Reset();
+  env->json.Reset();
+
+  if (n64_env == env)
+    n64_env = NULL;
+
+  delete env;
+}
+#endif
+
+n64_env_t *
+env_init(void) {
+  // Loading into another context of the same
+  // isolate reuses the existing templates.
+  if (n64_env != NULL)
+    return n64_env;
+
+  n64_env = new n64_env_t();
+
+#if NODE_MAJOR_VERSION >= 10
+  node::AddEnvironmentCleanupHook(v8::Isolate::GetCurrent(),
+                                  env_cleanup, n64_env);
+#endif
+
+  return n64_env;
+}
@@ -0,0 +1,42 @@
+/**
+ * env.h - per-isolate state for n64.
+ * Copyright (c) 2017, Christopher Jeffrey (MIT License)
+ */
+
+#ifndef _N64_ENV_H
+#define _N64_ENV_H
+
+#include <node.h>
+#include <nan.h>
+
+// Templates belong to an isolate, so every isolate
+// which loads the module (the main thread and each
+// worker) gets its own set. Node runs an isolate on
+// a single thread, which makes the lookup a plain
+// thread local read.
+typedef struct n64_env_s {
+  Nan::Persistent<v8::FunctionTemplate> int64;
+  Nan::Persistent<v8::FunctionTemplate> u64;
+  Nan::Persistent<v8::FunctionTemplate> i64;
+  Nan::Persistent<v8::FunctionTemplate> rng;
+  Nan::Persistent<v8::FunctionTemplate> dec64;
+  Nan::Persistent<v8::FunctionTemplate> array;
+  Nan::Persistent<v8::FunctionTemplate> int128;
+  Nan::Persistent<v8::FunctionTemplate> u128;
+  Nan::Persistent<v8::FunctionTemplate> i128;
+  Nan::Persistent<v8::FunctionTemplate> histogram;
+  Nan::Persistent<v8::FunctionTemplate> structure;
+  Nan::Persistent<v8::FunctionTemplate> json;
+} n64_env_t;
+
+extern thread_local n64_env_t *n64_env;
+
+n64_env_t *
+env_init(void);
+
+static inline n64_env_t *
+env_get(void) {
+  return n64_env;
+}
+
+#endif
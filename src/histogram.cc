@@ -0,0 +1,405 @@
+/**
+ * histogram.cc - native int64 histogram for node.js.
+ * Copyright (c) 2017, Christopher Jeffrey (MIT License)
+ */
+
+#include <node.h>
+#include <nan.h>
+
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "core.h"
+#include "env.h"
+#include "stats.h"
+#include "n64.h"
+#include "array.h"
+#include "bulk.h"
+#include "histogram.h"
+
+#define ARG_ERROR(name, len) ("Histogram#" #name " requires " #len " argument(s).")
+#define TYPE_ERROR(name, type) ("'" #name "' must be a(n) " #type ".")
+
+static bool
+get_value(v8::Local<v8::Value> val, uint64_t *r) {
+  if (val->IsNumber()) {
+    double num = val.As<v8::Number>()->Value();
+
+    if (!(num >= -9223372036854775808.0 && num < 9223372036854775808.0))
+      return false;
+
+    *r = (uint64_t)(int64_t)num;
+
+    return true;
+  }
+
+  if (N64::HasInstance(val)) {
+    *r = *Nan::ObjectWrap::Unwrap<N64>(val.As<v8::Object>())->n;
+    return true;
+  }
+
+  return false;
+}
+
+static N64 *
+get_out(v8::Local<v8::Value> val) {
+  if (!N64::HasInstance(val))
+    return NULL;
+
+  return Nan::ObjectWrap::Unwrap<N64>(val.As<v8::Object>());
+}
+
+Histogram::Histogram() {
+  memset(&ctx, 0, sizeof(ctx));
+  sign = 0;
+}
+
+Histogram::~Histogram() {
+  if (ctx.counts != NULL) {
+    Nan::AdjustExternalMemory(-(int)(ctx.len * sizeof(uint64_t)));
+    free(ctx.counts);
+  }
+}
+
+// Swaps in a new layout with zeroed counts.
+bool
+Histogram::Replace(const n64_hist_t *layout) {
+  uint64_t *counts = (uint64_t *)calloc(layout->len, sizeof(uint64_t));
+
+  if (counts == NULL)
+    return false;
+
+  if (ctx.counts != NULL) {
+    Nan::AdjustExternalMemory(-(int)(ctx.len * sizeof(uint64_t)));
+    free(ctx.counts);
+  }
+
+  ctx = *layout;
+  ctx.counts = counts;
+
+  Nan::AdjustExternalMemory((int)(ctx.len * sizeof(uint64_t)));
+
+  return true;
+}
+
+void
+Histogram::Init(v8::Local<v8::Object> &target) {
+  Nan::HandleScope scope;
+
+  n64_env_t *env = env_get();
+
+  if (env->histogram.IsEmpty()) {
+    v8::Local<v8::FunctionTemplate> tpl =
+      stats_template("Histogram", Histogram::New);
+
+    tpl->SetClassName(Nan::New("Histogram").ToLocalChecked());
+    tpl->InstanceTemplate()->SetInternalFieldCount(1);
+
+    stats_method(tpl, "Histogram", "record", Histogram::Record);
+    stats_method(tpl, "Histogram", "recordMany", Histogram::RecordMany);
+    stats_method(tpl, "Histogram", "percentile", Histogram::Percentile);
+    stats_method(tpl, "Histogram", "mean", Histogram::Mean);
+    stats_method(tpl, "Histogram", "count", Histogram::Count);
+    stats_method(tpl, "Histogram", "min", Histogram::Min);
+    stats_method(tpl, "Histogram", "max", Histogram::Max);
+    stats_method(tpl, "Histogram", "merge", Histogram::Merge);
+    stats_method(tpl, "Histogram", "reset", Histogram::Reset);
+    stats_method(tpl, "Histogram", "encode", Histogram::Encode);
+    stats_method(tpl, "Histogram", "decode", Histogram::Decode);
+    stats_method(tpl, "Histogram", "inject", Histogram::Inject);
+
+    env->histogram.Reset(tpl);
+  }
+
+  v8::Local<v8::FunctionTemplate> ctor = Nan::New(env->histogram);
+
+  Nan::Set(target, Nan::New("Histogram").ToLocalChecked(),
+    Nan::GetFunction(ctor).ToLocalChecked());
+}
+
+// Without arguments, a minimal layout is used
+// until a later decode() or inject().
+NAN_METHOD(Histogram::New) {
+  if (!info.IsConstructCall())
+    return Nan::ThrowError("Histogram must be called with `new`.");
+
+  Histogram *obj = new Histogram();
+  obj->Wrap(info.This());
+
+  n64_hist_t layout;
+
+  if (info.Length() == 0) {
+    n64_hist_layout(&layout, 1, 2, 1);
+
+    if (!obj->Replace(&layout))
+      return Nan::ThrowError("Allocation failed.");
+
+    info.GetReturnValue().Set(info.This());
+
+    return;
+  }
+
+  if (info.Length() < 4)
+    return Nan::ThrowError("Histogram requires 4 argument(s).");
+
+  uint64_t lowest = 0;
+  uint64_t highest = 0;
+
+  if (!get_value(info[0], &lowest))
+    return Nan::ThrowTypeError(TYPE_ERROR(lowest, int64));
+
+  if (!get_value(info[1], &highest))
+    return Nan::ThrowTypeError(TYPE_ERROR(highest, int64));
+
+  if (!info[2]->IsUint32())
+    return Nan::ThrowTypeError(TYPE_ERROR(significantDigits, integer));
+
+  int digits = (int)Nan::To<uint32_t>(info[2]).FromJust();
+
+  if (digits > N64_HIST_MAX_DIGITS
+      || !n64_hist_layout(&layout, lowest, highest, digits)) {
+    return Nan::ThrowError("Invalid histogram range.");
+  }
+
+  if (!obj->Replace(&layout))
+    return Nan::ThrowError("Allocation failed.");
+
+  obj->sign = (int)Nan::To<bool>(info[3]).FromJust();
+
+  info.GetReturnValue().Set(info.This());
+}
+
+NAN_METHOD(Histogram::Record) {
+  Histogram *h = ObjectWrap::Unwrap<Histogram>(info.Holder());
+
+  if (info.Length() < 2)
+    return Nan::ThrowError(ARG_ERROR(record, 2));
+
+  uint64_t value = 0;
+  uint64_t count = 0;
+
+  if (!get_value(info[0], &value))
+    return Nan::ThrowTypeError(TYPE_ERROR(value, int64));
+
+  if (!get_value(info[1], &count))
+    return Nan::ThrowTypeError(TYPE_ERROR(count, int64));
+
+  int ok = n64_hist_record(&h->ctx, value, count, h->sign);
+
+  info.GetReturnValue().Set(Nan::New<v8::Boolean>(ok != 0));
+}
+
+NAN_METHOD(Histogram::RecordMany) {
+  Histogram *h = ObjectWrap::Unwrap<Histogram>(info.Holder());
+
+  if (info.Length() < 1)
+    return Nan::ThrowError(ARG_ERROR(recordMany, 1));
+
+  if (!is_buffer(info[0]))
+    return Nan::ThrowTypeError(TYPE_ERROR(data, buffer));
+
+  size_t len = 0;
+  const uint8_t *data = get_buffer(info[0], &len);
+  size_t count = len / 8;
+
+  if ((len & 7) != 0)
+    return Nan::ThrowError("Invalid buffer length.");
+
+  if (count > 0xffffffff)
+    return Nan::ThrowError("Array length exceeds limit.");
+
+  uint32_t *bad = (uint32_t *)malloc(count * 4 + 1);
+
+  if (bad == NULL)
+    return Nan::ThrowError("Allocation failed.");
+
+  size_t fails = n64_hist_record_many(&h->ctx, data, count, h->sign, bad);
+
+  v8::Local<v8::Uint32Array> ret = indexes(bad, fails);
+
+  free(bad);
+
+  info.GetReturnValue().Set(ret);
+}
+
+NAN_METHOD(Histogram::Percentile) {
+  Histogram *h = ObjectWrap::Unwrap<Histogram>(info.Holder());
+
+  if (info.Length() < 2)
+    return Nan::ThrowError(ARG_ERROR(percentile, 2));
+
+  if (!info[0]->IsNumber())
+    return Nan::ThrowTypeError(TYPE_ERROR(p, number));
+
+  N64 *out = get_out(info[1]);
+
+  if (out == NULL)
+    return Nan::ThrowTypeError(TYPE_ERROR(out, int64));
+
+  double p = info[0].As<v8::Number>()->Value();
+
+  *out->n = n64_hist_percentile(&h->ctx, p);
+
+  info.GetReturnValue().Set(info[1]);
+}
+
+NAN_METHOD(Histogram::Mean) {
+  Histogram *h = ObjectWrap::Unwrap<Histogram>(info.Holder());
+  info.GetReturnValue().Set(Nan::New<v8::Number>(n64_hist_mean(&h->ctx)));
+}
+
+NAN_METHOD(Histogram::Count) {
+  Histogram *h = ObjectWrap::Unwrap<Histogram>(info.Holder());
+
+  if (info.Length() < 1)
+    return Nan::ThrowError(ARG_ERROR(count, 1));
+
+  N64 *out = get_out(info[0]);
+
+  if (out == NULL)
+    return Nan::ThrowTypeError(TYPE_ERROR(out, int64));
+
+  *out->n = h->ctx.total;
+
+  info.GetReturnValue().Set(info[0]);
+}
+
+NAN_METHOD(Histogram::Min) {
+  Histogram *h = ObjectWrap::Unwrap<Histogram>(info.Holder());
+
+  if (info.Length() < 1)
+    return Nan::ThrowError(ARG_ERROR(min, 1));
+
+  N64 *out = get_out(info[0]);
+
+  if (out == NULL)
+    return Nan::ThrowTypeError(TYPE_ERROR(out, int64));
+
+  *out->n = h->ctx.total != 0 ? h->ctx.min : 0;
+
+  info.GetReturnValue().Set(info[0]);
+}
+
+NAN_METHOD(Histogram::Max) {
+  Histogram *h = ObjectWrap::Unwrap<Histogram>(info.Holder());
+
+  if (info.Length() < 1)
+    return Nan::ThrowError(ARG_ERROR(max, 1));
+
+  N64 *out = get_out(info[0]);
+
+  if (out == NULL)
+    return Nan::ThrowTypeError(TYPE_ERROR(out, int64));
+
+  *out->n = h->ctx.total != 0 ? h->ctx.max : 0;
+
+  info.GetReturnValue().Set(info[0]);
+}
+
+NAN_METHOD(Histogram::Merge) {
+  Histogram *h = ObjectWrap::Unwrap<Histogram>(info.Holder());
+
+  if (info.Length() < 1)
+    return Nan::ThrowError(ARG_ERROR(merge, 1));
+
+  if (!Nan::New(env_get()->histogram)->HasInstance(info[0]))
+    return Nan::ThrowTypeError(TYPE_ERROR(other, histogram));
+
+  Histogram *b = ObjectWrap::Unwrap<Histogram>(info[0].As<v8::Object>());
+
+  int ok = n64_hist_merge(&h->ctx, &b->ctx, h->sign);
+
+  info.GetReturnValue().Set(Nan::New<v8::Boolean>(ok != 0));
+}
+
+NAN_METHOD(Histogram::Reset) {
+  Histogram *h = ObjectWrap::Unwrap<Histogram>(info.Holder());
+
+  n64_hist_reset(&h->ctx);
+
+  info.GetReturnValue().Set(info.Holder());
+}
+
+// Leaves `reserve` bytes in front for a header.
+NAN_METHOD(Histogram::Encode) {
+  Histogram *h = ObjectWrap::Unwrap<Histogram>(info.Holder());
+
+  uint32_t reserve = 0;
+
+  if (info.Length() > 0 && !info[0]->IsUndefined()) {
+    if (!info[0]->IsUint32())
+      return Nan::ThrowTypeError(TYPE_ERROR(reserve, integer));
+
+    reserve = Nan::To<uint32_t>(info[0]).FromJust();
+  }
+
+  size_t size = reserve + n64_hist_encode_size(&h->ctx);
+  v8::Isolate *isolate = v8::Isolate::GetCurrent();
+  v8::Local<v8::ArrayBuffer> buf = v8::ArrayBuffer::New(isolate, size);
+  size_t len = 0;
+  uint8_t *data = get_buffer(buf, &len);
+
+  memset(data, 0, reserve);
+
+  n64_hist_encode(data + reserve, &h->ctx);
+
+  info.GetReturnValue().Set(v8::Uint8Array::New(buf, 0, size));
+}
+
+NAN_METHOD(Histogram::Decode) {
+  Histogram *h = ObjectWrap::Unwrap<Histogram>(info.Holder());
+
+  if (info.Length() < 2)
+    return Nan::ThrowError(ARG_ERROR(decode, 2));
+
+  if (!is_buffer(info[0]))
+    return Nan::ThrowTypeError(TYPE_ERROR(data, buffer));
+
+  size_t len = 0;
+  const uint8_t *data = get_buffer(info[0], &len);
+
+  n64_hist_t layout;
+  size_t pos = n64_hist_decode_layout(&layout, data, len);
+
+  if (pos == 0)
+    return Nan::ThrowError("Invalid message.");
+
+  if (!h->Replace(&layout))
+    return Nan::ThrowError("Allocation failed.");
+
+  if (!n64_hist_decode_counts(&h->ctx, data + pos, len - pos)) {
+    n64_hist_reset(&h->ctx);
+    return Nan::ThrowError("Invalid message.");
+  }
+
+  h->sign = (int)Nan::To<bool>(info[1]).FromJust();
+
+  info.GetReturnValue().Set(info.Holder());
+}
+
+NAN_METHOD(Histogram::Inject) {
+  Histogram *h = ObjectWrap::Unwrap<Histogram>(info.Holder());
+
+  if (info.Length() < 1)
+    return Nan::ThrowError(ARG_ERROR(inject, 1));
+
+  if (!Nan::New(env_get()->histogram)->HasInstance(info[0]))
+    return Nan::ThrowTypeError(TYPE_ERROR(histogram, Histogram));
+
+  Histogram *b = ObjectWrap::Unwrap<Histogram>(info[0].As<v8::Object>());
+
+  if (h == b) {
+    info.GetReturnValue().Set(info.Holder());
+    return;
+  }
+
+  if (!h->Replace(&b->ctx))
+    return Nan::ThrowError("Allocation failed.");
+
+  memcpy(h->ctx.counts, b->ctx.counts, h->ctx.len * sizeof(uint64_t));
+
+  h->sign = b->sign;
+
+  info.GetReturnValue().Set(info.Holder());
+}
@@ -0,0 +1,43 @@
+/**
+ * histogram.h - native int64 histogram for node.js.
+ * Copyright (c) 2017, Christopher Jeffrey (MIT License)
+ */
+
+#ifndef _N64_HISTOGRAM_H
+#define _N64_HISTOGRAM_H
+
+#include <node.h>
+#include <nan.h>
+#include <inttypes.h>
+
+#include "core.h"
+
+class Histogram : public Nan::ObjectWrap {
+public:
+  static void Init(v8::Local<v8::Object> &target);
+  static NAN_METHOD(New);
+
+  Histogram();
+  ~Histogram();
+
+  bool Replace(const n64_hist_t *layout);
+
+  n64_hist_t ctx;
+  int sign;
+
+private:
+  static NAN_METHOD(Record);
+  static NAN_METHOD(RecordMany);
+  static NAN_METHOD(Percentile);
+  static NAN_METHOD(Mean);
+  static NAN_METHOD(Count);
+  static NAN_METHOD(Min);
+  static NAN_METHOD(Max);
+  static NAN_METHOD(Merge);
+  static NAN_METHOD(Reset);
+  static NAN_METHOD(Encode);
+  static NAN_METHOD(Decode);
+  static NAN_METHOD(Inject);
+};
+
+#endif
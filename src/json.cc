@@ -0,0 +1,177 @@
+/**
+ * json.cc - streaming JSON array parser for node.js.
+ * Copyright (c) 2017, Christopher Jeffrey (MIT License)
+ */
+
+#include <node.h>
+#include <node_buffer.h>
+#include <nan.h>
+
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "core.h"
+#include "env.h"
+#include "stats.h"
+#include "array.h"
+#include "json.h"
+
+#define ARG_ERROR(name, len) ("JSONParser#" #name " requires " #len " argument(s).")
+#define TYPE_ERROR(name, type) ("'" #name "' must be a(n) " #type ".")
+
+#define JSON_MIN_CAP 64
+
+JSONParser::JSONParser() {
+  n64_json_init(&state, 10);
+  out = NULL;
+  len = 0;
+  cap = 0;
+}
+
+JSONParser::~JSONParser() {
+  free(out);
+}
+
+bool
+JSONParser::Grow() {
+  size_t size = cap < JSON_MIN_CAP ? JSON_MIN_CAP : cap * 2;
+
+  // The words end up in a single buffer.
+  if (size > node::Buffer::kMaxLength / sizeof(uint64_t))
+    size = node::Buffer::kMaxLength / sizeof(uint64_t);
+
+  if (size <= cap)
+    return false;
+
+  uint64_t *data = (uint64_t *)realloc(out, size * sizeof(uint64_t));
+
+  if (data == NULL)
+    return false;
+
+  out = data;
+  cap = size;
+
+  return true;
+}
+
+void
+JSONParser::Init(v8::Local<v8::Object> &target) {
+  Nan::HandleScope scope;
+
+  n64_env_t *env = env_get();
+
+  if (env->json.IsEmpty()) {
+    v8::Local<v8::FunctionTemplate> tpl =
+      stats_template("JSONParser", JSONParser::New);
+
+    tpl->SetClassName(Nan::New("JSONParser").ToLocalChecked());
+    tpl->InstanceTemplate()->SetInternalFieldCount(1);
+
+    stats_method(tpl, "JSONParser", "write", JSONParser::Write);
+    stats_method(tpl, "JSONParser", "end", JSONParser::End);
+
+    env->json.Reset(tpl);
+  }
+
+  v8::Local<v8::FunctionTemplate> ctor = Nan::New(env->json);
+
+  Nan::Set(target, Nan::New("JSONParser").ToLocalChecked(),
+    Nan::GetFunction(ctor).ToLocalChecked());
+}
+
+// The base applies to quoted values
+// and is checked in JS.
+NAN_METHOD(JSONParser::New) {
+  if (!info.IsConstructCall())
+    return Nan::ThrowError("JSONParser must be called with `new`.");
+
+  if (info.Length() < 1)
+    return Nan::ThrowError("JSONParser requires 1 argument(s).");
+
+  if (!info[0]->IsUint32())
+    return Nan::ThrowTypeError(TYPE_ERROR(base, integer));
+
+  uint32_t base = Nan::To<uint32_t>(info[0]).FromJust();
+
+  if (!n64_is_base(base))
+    return Nan::ThrowError("Base ranges between 2 and 16.");
+
+  JSONParser *obj = new JSONParser();
+  obj->Wrap(info.This());
+
+  n64_json_init(&obj->state, base);
+
+  info.GetReturnValue().Set(info.This());
+}
+
+// Parses as much as fits, growing the
+// output until the chunk is consumed.
+NAN_METHOD(JSONParser::Write) {
+  JSONParser *p = ObjectWrap::Unwrap<JSONParser>(info.Holder());
+
+  if (info.Length() < 1)
+    return Nan::ThrowError(ARG_ERROR(write, 1));
+
+  if (!info[0]->IsUint8Array())
+    return Nan::ThrowTypeError(TYPE_ERROR(data, buffer));
+
+  size_t size = 0;
+  const char *data = (const char *)get_buffer(info[0], &size);
+  size_t pos = 0;
+
+  for (;;) {
+    size_t count = 0;
+    size_t used = 0;
+
+    int ret = n64_json_parse(&p->state, p->out + p->len, p->cap - p->len,
+                             &count, data + pos, size - pos, &used);
+
+    p->len += count;
+    pos += used;
+
+    if (ret != N64_OK)
+      return stats_throw(THROW_PARSE, "Invalid JSON.");
+
+    if (pos == size)
+      break;
+
+    if (!p->Grow())
+      return Nan::ThrowError("Array length exceeds limit.");
+  }
+
+  info.GetReturnValue().Set(info.This());
+}
+
+NAN_METHOD(JSONParser::End) {
+  JSONParser *p = ObjectWrap::Unwrap<JSONParser>(info.Holder());
+
+  if (n64_json_end(&p->state) != N64_OK)
+    return stats_throw(THROW_PARSE, "Invalid JSON.");
+
+  // The parser is spent.
+  p->state.state = N64_JSON_ERROR;
+
+  if (p->len == 0) {
+    info.GetReturnValue().Set(Nan::NewBuffer(0).ToLocalChecked());
+    return;
+  }
+
+  uint64_t *data = p->out;
+  size_t size = p->len * sizeof(uint64_t);
+
+  if (p->len < p->cap) {
+    uint64_t *shrunk = (uint64_t *)realloc(data, size);
+
+    if (shrunk != NULL)
+      data = shrunk;
+  }
+
+  p->out = NULL;
+  p->len = 0;
+  p->cap = 0;
+
+  // The buffer takes ownership and frees it.
+  info.GetReturnValue().Set(
+    Nan::NewBuffer((char *)data, size).ToLocalChecked());
+}
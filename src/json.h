@@ -0,0 +1,39 @@
+/**
+ * json.h - streaming JSON array parser for node.js.
+ * Copyright (c) 2017, Christopher Jeffrey (MIT License)
+ */
+
+#ifndef _N64_JSON_H
+#define _N64_JSON_H
+
+#include <node.h>
+#include <nan.h>
+#include <inttypes.h>
+#include <stddef.h>
+
+#include "core.h"
+
+class JSONParser : public Nan::ObjectWrap {
+public:
+  static void Init(v8::Local<v8::Object> &target);
+  static NAN_METHOD(New);
+
+  JSONParser();
+  ~JSONParser();
+
+  n64_json_t state;
+
+  // Parsed words, handed to the buffer
+  // returned by end().
+  uint64_t *out;
+  size_t len;
+  size_t cap;
+
+  bool Grow();
+
+private:
+  static NAN_METHOD(Write);
+  static NAN_METHOD(End);
+};
+
+#endif
@@ -0,0 +1,1219 @@
+/**
+ * n128.cc - native int128 object for node.js.
+ * Copyright (c) 2017, Christopher Jeffrey (MIT License)
+ */
+
+#include <node.h>
+#include <nan.h>
+
+#include <inttypes.h>
+#include <stdlib.h>
+
+#include "core.h"
+#include "env.h"
+#include "stats.h"
+#include "n64.h"
+#include "n128.h"
+
+#define ARG_ERROR(name, len) ("N128#" #name " requires " #len " argument(s).")
+#define TYPE_ERROR(name, type) ("'" #name "' must be a(n) " #type ".")
+
+/*
+ * Helpers
+ */
+
+template <int S>
+static inline n128_t
+extend(uint32_t num) {
+  // Small operands are sign-extended for I128.
+  if (S)
+    return n128_extend((uint64_t)(int64_t)(int32_t)num, 1);
+
+  return n128_make(0, num);
+}
+
+static inline uint32_t
+get_word(n128_t n, uint32_t i) {
+  uint64_t w = i & 2 ? n.hi : n.lo;
+  return (uint32_t)(i & 1 ? w >> 32 : w);
+}
+
+static inline n128_t
+set_word(n128_t n, uint32_t i, uint32_t v) {
+  uint64_t *w = i & 2 ? &n.hi : &n.lo;
+  uint32_t s = i & 1 ? 32 : 0;
+
+  *w &= ~(0xffffffffull << s);
+  *w |= (uint64_t)v << s;
+
+  return n;
+}
+
+static int
+read_string(v8::Local<v8::Value> val, uint32_t base, n128_t *r) {
+  if (!val->IsString())
+    return N64_ERR_PARSE;
+
+  v8::Local<v8::String> str = val.As<v8::String>();
+  int len = str->Length();
+
+  // A sign and 128 binary digits at most.
+  if (len > 129)
+    return n128_read(r, "", 0, base);
+
+  uint16_t wide[129];
+  uint8_t buf[129];
+
+#if NODE_MAJOR_VERSION >= 12
+  v8::Isolate *isolate = v8::Isolate::GetCurrent();
+
+  if (str->IsOneByte()) {
+    str->WriteOneByte(isolate, buf, 0, len, v8::String::NO_NULL_TERMINATION);
+    return n128_read(r, (const char *)buf, (size_t)len, base);
+  }
+
+  str->Write(isolate, wide, 0, len, v8::String::NO_NULL_TERMINATION);
+#else
+  str->Write(wide, 0, len, v8::String::NO_NULL_TERMINATION);
+#endif
+
+  for (int i = 0; i < len; i++)
+    buf[i] = wide[i] < 0x80 ? (uint8_t)wide[i] : 0x7f;
+
+  return n128_read(r, (const char *)buf, (size_t)len, base);
+}
+
+/*
+ * N128
+ */
+
+N128::N128() {
+  n = n128_make(0, 0);
+}
+
+N128::~N128() {}
+
+void
+N128::Init(v8::Local<v8::Object> &target) {
+  Nan::HandleScope scope;
+
+  n64_env_t *env = env_get();
+
+  if (env->int128.IsEmpty()) {
+    v8::Local<v8::FunctionTemplate> tpl = Nan::New<v8::FunctionTemplate>();
+
+    tpl->SetClassName(Nan::New("N128").ToLocalChecked());
+
+    stats_method(tpl, "N128", "getWord", N128::GetWord);
+    stats_method(tpl, "N128", "setWord", N128::SetWord);
+    stats_method(tpl, "N128", "iadd", N128::Iadd);
+    stats_method(tpl, "N128", "isub", N128::Isub);
+    stats_method(tpl, "N128", "imul", N128::Imul);
+    stats_method(tpl, "N128", "ipown", N128::Ipown);
+    stats_method(tpl, "N128", "iand", N128::Iand);
+    stats_method(tpl, "N128", "ior", N128::Ior);
+    stats_method(tpl, "N128", "ixor", N128::Ixor);
+    stats_method(tpl, "N128", "inot", N128::Inot);
+    stats_method(tpl, "N128", "ishln", N128::Ishln);
+    stats_method(tpl, "N128", "iushrn", N128::Iushrn);
+    stats_method(tpl, "N128", "setn", N128::Setn);
+    stats_method(tpl, "N128", "testn", N128::Testn);
+    stats_method(tpl, "N128", "setb", N128::Setb);
+    stats_method(tpl, "N128", "orb", N128::Orb);
+    stats_method(tpl, "N128", "getb", N128::Getb);
+    stats_method(tpl, "N128", "imaskn", N128::Imaskn);
+    stats_method(tpl, "N128", "andln", N128::Andln);
+    stats_method(tpl, "N128", "ineg", N128::Ineg);
+    stats_method(tpl, "N128", "eq", N128::Eq);
+    stats_method(tpl, "N128", "isZero", N128::IsZero);
+    stats_method(tpl, "N128", "isOdd", N128::IsOdd);
+    stats_method(tpl, "N128", "isEven", N128::IsEven);
+    stats_method(tpl, "N128", "inject", N128::Inject);
+    stats_method(tpl, "N128", "set", N128::Set);
+    stats_method(tpl, "N128", "join", N128::Join);
+    stats_method(tpl, "N128", "toBool", N128::ToBool);
+    stats_method(tpl, "N128", "fromNumber", N128::FromNumber);
+    stats_method(tpl, "N128", "fromBool", N128::FromBool);
+    stats_method(tpl, "N128", "fromN64", N128::FromN64);
+    stats_method(tpl, "N128", "tryFromNumber", N128::TryFromNumber);
+
+    env->int128.Reset(tpl);
+  }
+
+  v8::Local<v8::FunctionTemplate> base = Nan::New(env->int128);
+
+  U128::Init(target, base);
+  I128::Init(target, base);
+}
+
+bool N128::HasInstance(v8::Local<v8::Value> val) {
+  Nan::HandleScope scope;
+  return Nan::New(env_get()->int128)->HasInstance(val);
+}
+
+/*
+ * Int128
+ */
+
+template <int S>
+void
+Int128<S>::Init(v8::Local<v8::Object> &target,
+                v8::Local<v8::FunctionTemplate> base) {
+  const char *name = S ? "I128" : "U128";
+  n64_env_t *env = env_get();
+  Nan::Persistent<v8::FunctionTemplate> &ctor = S ? env->i128 : env->u128;
+
+  if (ctor.IsEmpty()) {
+    v8::Local<v8::FunctionTemplate> tpl =
+      stats_template(name, Int128<S>::New);
+
+    tpl->Inherit(base);
+    tpl->SetClassName(Nan::New(name).ToLocalChecked());
+    tpl->InstanceTemplate()->SetInternalFieldCount(1);
+
+    stats_method(tpl, name, "getSign", Int128<S>::GetSign);
+    stats_method(tpl, name, "iaddn", Int128<S>::Iaddn);
+    stats_method(tpl, name, "isubn", Int128<S>::Isubn);
+    stats_method(tpl, name, "imuln", Int128<S>::Imuln);
+    stats_method(tpl, name, "idiv", Int128<S>::Idiv);
+    stats_method(tpl, name, "idivn", Int128<S>::Idivn);
+    stats_method(tpl, name, "imod", Int128<S>::Imod);
+    stats_method(tpl, name, "imodn", Int128<S>::Imodn);
+    stats_method(tpl, name, "iandn", Int128<S>::Iandn);
+    stats_method(tpl, name, "iorn", Int128<S>::Iorn);
+    stats_method(tpl, name, "ixorn", Int128<S>::Ixorn);
+    stats_method(tpl, name, "ishrn", Int128<S>::Ishrn);
+    stats_method(tpl, name, "cmp", Int128<S>::Cmp);
+    stats_method(tpl, name, "cmpn", Int128<S>::Cmpn);
+    stats_method(tpl, name, "eqn", Int128<S>::Eqn);
+    stats_method(tpl, name, "isNeg", Int128<S>::IsNeg);
+    stats_method(tpl, name, "bitLength", Int128<S>::BitLength);
+    stats_method(tpl, name, "isSafe", Int128<S>::IsSafe);
+    stats_method(tpl, name, "toNumber", Int128<S>::ToNumber);
+    stats_method(tpl, name, "toDouble", Int128<S>::ToDouble);
+    stats_method(tpl, name, "toInt", Int128<S>::ToInt);
+    stats_method(tpl, name, "toString", Int128<S>::ToString);
+    stats_method(tpl, name, "toN64", Int128<S>::ToN64);
+    stats_method(tpl, name, "fromInt", Int128<S>::FromInt);
+    stats_method(tpl, name, "fromString", Int128<S>::FromString);
+    stats_method(tpl, name, "tryIdiv", Int128<S>::TryIdiv);
+    stats_method(tpl, name, "tryImod", Int128<S>::TryImod);
+    stats_method(tpl, name, "tryToNumber", Int128<S>::TryToNumber);
+    stats_method(tpl, name, "tryFromString", Int128<S>::TryFromString);
+
+    ctor.Reset(tpl);
+  }
+
+  Nan::Set(target, Nan::New(name).ToLocalChecked(),
+    Nan::GetFunction(Nan::New(ctor)).ToLocalChecked());
+}
+
+template <int S>
+NAN_METHOD(Int128<S>::New) {
+  if (!info.IsConstructCall())
+    return Nan::ThrowError(S ? "I128 must be called with `new`."
+                             : "U128 must be called with `new`.");
+
+  Int128<S> *obj = new Int128<S>();
+  obj->Wrap(info.This());
+
+  stats_alloc();
+
+  info.GetReturnValue().Set(info.This());
+}
+
+NAN_METHOD(N128::GetWord) {
+  N128 *a = ObjectWrap::Unwrap<N128>(info.Holder());
+
+  if (info.Length() < 1)
+    return Nan::ThrowError(ARG_ERROR(getWord, 1));
+
+  if (!info[0]->IsNumber())
+    return Nan::ThrowTypeError(TYPE_ERROR(index, number));
+
+  uint32_t i = Nan::To<uint32_t>(info[0]).FromJust() & 3;
+  int32_t w = (int32_t)get_word(a->n, i);
+
+  info.GetReturnValue().Set(Nan::New<v8::Int32>(w));
+}
+
+NAN_METHOD(N128::SetWord) {
+  N128 *a = ObjectWrap::Unwrap<N128>(info.Holder());
+
+  if (info.Length() < 2)
+    return Nan::ThrowError(ARG_ERROR(setWord, 2));
+
+  if (!info[0]->IsNumber())
+    return Nan::ThrowTypeError(TYPE_ERROR(index, number));
+
+  if (!info[1]->IsNumber())
+    return Nan::ThrowTypeError(TYPE_ERROR(word, number));
+
+  uint32_t i = Nan::To<uint32_t>(info[0]).FromJust() & 3;
+  uint32_t w = Nan::To<uint32_t>(info[1]).FromJust();
+
+  a->n = set_word(a->n, i, w);
+
+  info.GetReturnValue().Set(info.Holder());
+}
+
+template <int S>
+NAN_METHOD(Int128<S>::GetSign) {
+  info.GetReturnValue().Set(Nan::New<v8::Uint32>((uint32_t)S));
+}
+
+NAN_METHOD(N128::Iadd) {
+  N128 *a = ObjectWrap::Unwrap<N128>(info.Holder());
+
+  if (info.Length() < 1)
+    return Nan::ThrowError(ARG_ERROR(iadd, 1));
+
+  if (!N128::HasInstance(info[0]))
+    return Nan::ThrowTypeError(TYPE_ERROR(operand, int128));
+
+  N128 *b = ObjectWrap::Unwrap<N128>(info[0].As<v8::Object>());
+
+  a->n = n128_add(a->n, b->n);
+
+  info.GetReturnValue().Set(info.Holder());
+}
+
+template <int S>
+NAN_METHOD(Int128<S>::Iaddn) {
+  N128 *a = ObjectWrap::Unwrap<N128>(info.Holder());
+
+  if (info.Length() < 1)
+    return Nan::ThrowError(ARG_ERROR(iaddn, 1));
+
+  if (!info[0]->IsNumber())
+    return Nan::ThrowTypeError(TYPE_ERROR(operand, number));
+
+  uint32_t num = Nan::To<uint32_t>(info[0]).FromJust();
+
+  a->n = n128_add(a->n, extend<S>(num));
+
+  info.GetReturnValue().Set(info.Holder());
+}
+
+NAN_METHOD(N128::Isub) {
+  N128 *a = ObjectWrap::Unwrap<N128>(info.Holder());
+
+  if (info.Length() < 1)
+    return Nan::ThrowError(ARG_ERROR(isub, 1));
+
+  if (!N128::HasInstance(info[0]))
+    return Nan::ThrowTypeError(TYPE_ERROR(operand, int128));
+
+  N128 *b = ObjectWrap::Unwrap<N128>(info[0].As<v8::Object>());
+
+  a->n = n128_sub(a->n, b->n);
+
+  info.GetReturnValue().Set(info.Holder());
+}
+
+template <int S>
+NAN_METHOD(Int128<S>::Isubn) {
+  N128 *a = ObjectWrap::Unwrap<N128>(info.Holder());
+
+  if (info.Length() < 1)
+    return Nan::ThrowError(ARG_ERROR(isubn, 1));
+
+  if (!info[0]->IsNumber())
+    return Nan::ThrowTypeError(TYPE_ERROR(operand, number));
+
+  uint32_t num = Nan::To<uint32_t>(info[0]).FromJust();
+
+  a->n = n128_sub(a->n, extend<S>(num));
+
+  info.GetReturnValue().Set(info.Holder());
+}
+
+NAN_METHOD(N128::Imul) {
+  N128 *a = ObjectWrap::Unwrap<N128>(info.Holder());
+
+  if (info.Length() < 1)
+    return Nan::ThrowError(ARG_ERROR(imul, 1));
+
+  if (!N128::HasInstance(info[0]))
+    return Nan::ThrowTypeError(TYPE_ERROR(multiplicand, int128));
+
+  N128 *b = ObjectWrap::Unwrap<N128>(info[0].As<v8::Object>());
+
+  a->n = n128_mul(a->n, b->n);
+
+  info.GetReturnValue().Set(info.Holder());
+}
+
+template <int S>
+NAN_METHOD(Int128<S>::Imuln) {
+  N128 *a = ObjectWrap::Unwrap<N128>(info.Holder());
+
+  if (info.Length() < 1)
+    return Nan::ThrowError(ARG_ERROR(imuln, 1));
+
+  if (!info[0]->IsNumber())
+    return Nan::ThrowTypeError(TYPE_ERROR(multiplicand, number));
+
+  uint32_t num = Nan::To<uint32_t>(info[0]).FromJust();
+
+  a->n = n128_mul(a->n, extend<S>(num));
+
+  info.GetReturnValue().Set(info.Holder());
+}
+
+template <int S>
+NAN_METHOD(Int128<S>::Idiv) {
+  N128 *a = ObjectWrap::Unwrap<N128>(info.Holder());
+
+  if (info.Length() < 1)
+    return Nan::ThrowError(ARG_ERROR(idiv, 1));
+
+  if (!N128::HasInstance(info[0]))
+    return Nan::ThrowTypeError(TYPE_ERROR(divisor, int128));
+
+  N128 *b = ObjectWrap::Unwrap<N128>(info[0].As<v8::Object>());
+
+  if (n128_is_zero(b->n))
+    return stats_throw(THROW_DIVZERO, "Cannot divide by zero.");
+
+  a->n = n128_div(a->n, b->n, S);
+
+  info.GetReturnValue().Set(info.Holder());
+}
+
+template <int S>
+NAN_METHOD(Int128<S>::Idivn) {
+  N128 *a = ObjectWrap::Unwrap<N128>(info.Holder());
+
+  if (info.Length() < 1)
+    return Nan::ThrowError(ARG_ERROR(idivn, 1));
+
+  if (!info[0]->IsNumber())
+    return Nan::ThrowTypeError(TYPE_ERROR(divisor, number));
+
+  uint32_t num = Nan::To<uint32_t>(info[0]).FromJust();
+
+  if (num == 0)
+    return stats_throw(THROW_DIVZERO, "Cannot divide by zero.");
+
+  a->n = n128_div(a->n, extend<S>(num), S);
+
+  info.GetReturnValue().Set(info.Holder());
+}
+
+template <int S>
+NAN_METHOD(Int128<S>::Imod) {
+  N128 *a = ObjectWrap::Unwrap<N128>(info.Holder());
+
+  if (info.Length() < 1)
+    return Nan::ThrowError(ARG_ERROR(imod, 1));
+
+  if (!N128::HasInstance(info[0]))
+    return Nan::ThrowTypeError(TYPE_ERROR(divisor, int128));
+
+  N128 *b = ObjectWrap::Unwrap<N128>(info[0].As<v8::Object>());
+
+  if (n128_is_zero(b->n))
+    return stats_throw(THROW_DIVZERO, "Cannot divide by zero.");
+
+  a->n = n128_mod(a->n, b->n, S);
+
+  info.GetReturnValue().Set(info.Holder());
+}
+
+template <int S>
+NAN_METHOD(Int128<S>::Imodn) {
+  N128 *a = ObjectWrap::Unwrap<N128>(info.Holder());
+
+  if (info.Length() < 1)
+    return Nan::ThrowError(ARG_ERROR(imodn, 1));
+
+  if (!info[0]->IsNumber())
+    return Nan::ThrowTypeError(TYPE_ERROR(divisor, number));
+
+  uint32_t num = Nan::To<uint32_t>(info[0]).FromJust();
+
+  if (num == 0)
+    return stats_throw(THROW_DIVZERO, "Cannot divide by zero.");
+
+  a->n = n128_mod(a->n, extend<S>(num), S);
+
+  info.GetReturnValue().Set(info.Holder());
+}
+
+NAN_METHOD(N128::Ipown) {
+  N128 *a = ObjectWrap::Unwrap<N128>(info.Holder());
+
+  if (info.Length() < 1)
+    return Nan::ThrowError(ARG_ERROR(ipown, 1));
+
+  if (!info[0]->IsNumber())
+    return Nan::ThrowTypeError(TYPE_ERROR(exponent, number));
+
+  uint32_t y = Nan::To<uint32_t>(info[0]).FromJust();
+
+  a->n = n128_pow(a->n, y);
+
+  info.GetReturnValue().Set(info.Holder());
+}
+
+NAN_METHOD(N128::Iand) {
+  N128 *a = ObjectWrap::Unwrap<N128>(info.Holder());
+
+  if (info.Length() < 1)
+    return Nan::ThrowError(ARG_ERROR(iand, 1));
+
+  if (!N128::HasInstance(info[0]))
+    return Nan::ThrowTypeError(TYPE_ERROR(operand, int128));
+
+  N128 *b = ObjectWrap::Unwrap<N128>(info[0].As<v8::Object>());
+
+  a->n.hi &= b->n.hi;
+  a->n.lo &= b->n.lo;
+
+  info.GetReturnValue().Set(info.Holder());
+}
+
+template <int S>
+NAN_METHOD(Int128<S>::Iandn) {
+  N128 *a = ObjectWrap::Unwrap<N128>(info.Holder());
+
+  if (info.Length() < 1)
+    return Nan::ThrowError(ARG_ERROR(iandn, 1));
+
+  if (!info[0]->IsNumber())
+    return Nan::ThrowTypeError(TYPE_ERROR(operand, number));
+
+  uint32_t num = Nan::To<uint32_t>(info[0]).FromJust();
+  n128_t b = extend<S>(num);
+
+  a->n.hi &= b.hi;
+  a->n.lo &= b.lo;
+
+  info.GetReturnValue().Set(info.Holder());
+}
+
+NAN_METHOD(N128::Ior) {
+  N128 *a = ObjectWrap::Unwrap<N128>(info.Holder());
+
+  if (info.Length() < 1)
+    return Nan::ThrowError(ARG_ERROR(ior, 1));
+
+  if (!N128::HasInstance(info[0]))
+    return Nan::ThrowTypeError(TYPE_ERROR(operand, int128));
+
+  N128 *b = ObjectWrap::Unwrap<N128>(info[0].As<v8::Object>());
+
+  a->n.hi |= b->n.hi;
+  a->n.lo |= b->n.lo;
+
+  info.GetReturnValue().Set(info.Holder());
+}
+
+template <int S>
+NAN_METHOD(Int128<S>::Iorn) {
+  N128 *a = ObjectWrap::Unwrap<N128>(info.Holder());
+
+  if (info.Length() < 1)
+    return Nan::ThrowError(ARG_ERROR(iorn, 1));
+
+  if (!info[0]->IsNumber())
+    return Nan::ThrowTypeError(TYPE_ERROR(operand, number));
+
+  uint32_t num = Nan::To<uint32_t>(info[0]).FromJust();
+  n128_t b = extend<S>(num);
+
+  a->n.hi |= b.hi;
+  a->n.lo |= b.lo;
+
+  info.GetReturnValue().Set(info.Holder());
+}
+
+NAN_METHOD(N128::Ixor) {
+  N128 *a = ObjectWrap::Unwrap<N128>(info.Holder());
+
+  if (info.Length() < 1)
+    return Nan::ThrowError(ARG_ERROR(ixor, 1));
+
+  if (!N128::HasInstance(info[0]))
+    return Nan::ThrowTypeError(TYPE_ERROR(operand, int128));
+
+  N128 *b = ObjectWrap::Unwrap<N128>(info[0].As<v8::Object>());
+
+  a->n.hi ^= b->n.hi;
+  a->n.lo ^= b->n.lo;
+
+  info.GetReturnValue().Set(info.Holder());
+}
+
+template <int S>
+NAN_METHOD(Int128<S>::Ixorn) {
+  N128 *a = ObjectWrap::Unwrap<N128>(info.Holder());
+
+  if (info.Length() < 1)
+    return Nan::ThrowError(ARG_ERROR(ixorn, 1));
+
+  if (!info[0]->IsNumber())
+    return Nan::ThrowTypeError(TYPE_ERROR(operand, number));
+
+  uint32_t num = Nan::To<uint32_t>(info[0]).FromJust();
+  n128_t b = extend<S>(num);
+
+  a->n.hi ^= b.hi;
+  a->n.lo ^= b.lo;
+
+  info.GetReturnValue().Set(info.Holder());
+}
+
+NAN_METHOD(N128::Inot) {
+  N128 *a = ObjectWrap::Unwrap<N128>(info.Holder());
+
+  a->n = n128_not(a->n);
+
+  info.GetReturnValue().Set(info.Holder());
+}
+
+NAN_METHOD(N128::Ishln) {
+  N128 *a = ObjectWrap::Unwrap<N128>(info.Holder());
+
+  if (info.Length() < 1)
+    return Nan::ThrowError(ARG_ERROR(ishln, 1));
+
+  if (!info[0]->IsNumber())
+    return Nan::ThrowTypeError(TYPE_ERROR(bits, number));
+
+  uint32_t bits = Nan::To<uint32_t>(info[0]).FromJust() & 127;
+
+  a->n = n128_shl(a->n, bits);
+
+  info.GetReturnValue().Set(info.Holder());
+}
+
+template <int S>
+NAN_METHOD(Int128<S>::Ishrn) {
+  N128 *a = ObjectWrap::Unwrap<N128>(info.Holder());
+
+  if (info.Length() < 1)
+    return Nan::ThrowError(ARG_ERROR(ishrn, 1));
+
+  if (!info[0]->IsNumber())
+    return Nan::ThrowTypeError(TYPE_ERROR(bits, number));
+
+  uint32_t bits = Nan::To<uint32_t>(info[0]).FromJust() & 127;
+
+  a->n = n128_shr(a->n, bits, S);
+
+  info.GetReturnValue().Set(info.Holder());
+}
+
+NAN_METHOD(N128::Iushrn) {
+  N128 *a = ObjectWrap::Unwrap<N128>(info.Holder());
+
+  if (info.Length() < 1)
+    return Nan::ThrowError(ARG_ERROR(ushrn, 1));
+
+  if (!info[0]->IsNumber())
+    return Nan::ThrowTypeError(TYPE_ERROR(bits, number));
+
+  uint32_t bits = Nan::To<uint32_t>(info[0]).FromJust() & 127;
+
+  a->n = n128_shr(a->n, bits, 0);
+
+  info.GetReturnValue().Set(info.Holder());
+}
+
+NAN_METHOD(N128::Setn) {
+  N128 *a = ObjectWrap::Unwrap<N128>(info.Holder());
+
+  if (info.Length() < 2)
+    return Nan::ThrowError(ARG_ERROR(setn, 2));
+
+  if (!info[0]->IsNumber())
+    return Nan::ThrowTypeError(TYPE_ERROR(bit, number));
+
+  if (!info[1]->IsNumber() && !info[1]->IsBoolean())
+    return Nan::ThrowTypeError(TYPE_ERROR(val, number));
+
+  uint32_t bit = Nan::To<uint32_t>(info[0]).FromJust() & 127;
+  bool val = Nan::To<bool>(info[1]).FromJust();
+  uint64_t *w = bit >= 64 ? &a->n.hi : &a->n.lo;
+
+  if (val)
+    *w |= (1ull << (bit & 63));
+  else
+    *w &= ~(1ull << (bit & 63));
+
+  info.GetReturnValue().Set(info.Holder());
+}
+
+NAN_METHOD(N128::Testn) {
+  N128 *a = ObjectWrap::Unwrap<N128>(info.Holder());
+
+  if (info.Length() < 1)
+    return Nan::ThrowError(ARG_ERROR(testn, 1));
+
+  if (!info[0]->IsNumber())
+    return Nan::ThrowTypeError(TYPE_ERROR(bit, number));
+
+  uint32_t bit = Nan::To<uint32_t>(info[0]).FromJust() & 127;
+  uint64_t w = bit >= 64 ? a->n.hi : a->n.lo;
+  int32_t r = (int32_t)((w >> (bit & 63)) & 1);
+
+  info.GetReturnValue().Set(Nan::New<v8::Int32>(r));
+}
+
+NAN_METHOD(N128::Setb) {
+  N128 *a = ObjectWrap::Unwrap<N128>(info.Holder());
+
+  if (info.Length() < 2)
+    return Nan::ThrowError(ARG_ERROR(setb, 2));
+
+  if (!info[0]->IsNumber())
+    return Nan::ThrowTypeError(TYPE_ERROR(pos, number));
+
+  if (!info[1]->IsNumber())
+    return Nan::ThrowTypeError(TYPE_ERROR(ch, number));
+
+  uint32_t pos = Nan::To<uint32_t>(info[0]).FromJust() & 15;
+  uint64_t ch = Nan::To<int64_t>(info[1]).FromJust() & 0xff;
+  uint64_t *w = pos >= 8 ? &a->n.hi : &a->n.lo;
+
+  *w &= ~(0xffull << ((pos & 7) * 8));
+  *w |= ch << ((pos & 7) * 8);
+
+  info.GetReturnValue().Set(info.Holder());
+}
+
+NAN_METHOD(N128::Orb) {
+  N128 *a = ObjectWrap::Unwrap<N128>(info.Holder());
+
+  if (info.Length() < 2)
+    return Nan::ThrowError(ARG_ERROR(orb, 2));
+
+  if (!info[0]->IsNumber())
+    return Nan::ThrowTypeError(TYPE_ERROR(pos, number));
+
+  if (!info[1]->IsNumber())
+    return Nan::ThrowTypeError(TYPE_ERROR(ch, number));
+
+  uint32_t pos = Nan::To<uint32_t>(info[0]).FromJust() & 15;
+  uint64_t ch = Nan::To<int64_t>(info[1]).FromJust() & 0xff;
+  uint64_t *w = pos >= 8 ? &a->n.hi : &a->n.lo;
+
+  *w |= ch << ((pos & 7) * 8);
+
+  info.GetReturnValue().Set(info.Holder());
+}
+
+NAN_METHOD(N128::Getb) {
+  N128 *a = ObjectWrap::Unwrap<N128>(info.Holder());
+
+  if (info.Length() < 1)
+    return Nan::ThrowError(ARG_ERROR(getb, 1));
+
+  if (!info[0]->IsNumber())
+    return Nan::ThrowTypeError(TYPE_ERROR(pos, number));
+
+  uint32_t pos = Nan::To<uint32_t>(info[0]).FromJust() & 15;
+  uint64_t w = pos >= 8 ? a->n.hi : a->n.lo;
+  int32_t ch = (w >> ((pos & 7) * 8)) & 0xff;
+
+  info.GetReturnValue().Set(Nan::New<v8::Int32>(ch));
+}
+
+NAN_METHOD(N128::Imaskn) {
+  N128 *a = ObjectWrap::Unwrap<N128>(info.Holder());
+
+  if (info.Length() < 1)
+    return Nan::ThrowError(ARG_ERROR(imaskn, 1));
+
+  if (!info[0]->IsNumber())
+    return Nan::ThrowTypeError(TYPE_ERROR(bit, number));
+
+  uint32_t bit = Nan::To<uint32_t>(info[0]).FromJust() & 127;
+
+  if (bit >= 64) {
+    a->n.hi &= (1ull << (bit - 64)) - 1;
+  } else {
+    a->n.hi = 0;
+    a->n.lo &= (1ull << bit) - 1;
+  }
+
+  info.GetReturnValue().Set(info.Holder());
+}
+
+NAN_METHOD(N128::Andln) {
+  N128 *a = ObjectWrap::Unwrap<N128>(info.Holder());
+
+  if (info.Length() < 1)
+    return Nan::ThrowError(ARG_ERROR(andln, 1));
+
+  if (!info[0]->IsNumber())
+    return Nan::ThrowTypeError(TYPE_ERROR(operand, number));
+
+  uint32_t num = Nan::To<uint32_t>(info[0]).FromJust();
+  uint32_t r = (uint32_t)a->n.lo & num;
+
+  info.GetReturnValue().Set(Nan::New<v8::Int32>(r));
+}
+
+NAN_METHOD(N128::Ineg) {
+  N128 *a = ObjectWrap::Unwrap<N128>(info.Holder());
+
+  a->n = n128_neg(a->n);
+
+  info.GetReturnValue().Set(info.Holder());
+}
+
+template <int S>
+NAN_METHOD(Int128<S>::Cmp) {
+  N128 *a = ObjectWrap::Unwrap<N128>(info.Holder());
+
+  if (info.Length() < 1)
+    return Nan::ThrowError(ARG_ERROR(cmp, 1));
+
+  if (!N128::HasInstance(info[0]))
+    return Nan::ThrowTypeError(TYPE_ERROR(value, int128));
+
+  N128 *b = ObjectWrap::Unwrap<N128>(info[0].As<v8::Object>());
+  int32_t r = n128_cmp(a->n, b->n, S);
+
+  info.GetReturnValue().Set(Nan::New<v8::Int32>(r));
+}
+
+template <int S>
+NAN_METHOD(Int128<S>::Cmpn) {
+  N128 *a = ObjectWrap::Unwrap<N128>(info.Holder());
+
+  if (info.Length() < 1)
+    return Nan::ThrowError(ARG_ERROR(cmpn, 1));
+
+  if (!info[0]->IsNumber())
+    return Nan::ThrowTypeError(TYPE_ERROR(value, number));
+
+  uint32_t num = Nan::To<uint32_t>(info[0]).FromJust();
+  int32_t r = n128_cmp(a->n, extend<S>(num), S);
+
+  info.GetReturnValue().Set(Nan::New<v8::Int32>(r));
+}
+
+NAN_METHOD(N128::Eq) {
+  N128 *a = ObjectWrap::Unwrap<N128>(info.Holder());
+
+  if (info.Length() < 1)
+    return Nan::ThrowError(ARG_ERROR(eq, 1));
+
+  if (!N128::HasInstance(info[0]))
+    return Nan::ThrowTypeError(TYPE_ERROR(value, int128));
+
+  N128 *b = ObjectWrap::Unwrap<N128>(info[0].As<v8::Object>());
+  bool r = n128_eq(a->n, b->n) != 0;
+
+  info.GetReturnValue().Set(Nan::New<v8::Boolean>(r));
+}
+
+template <int S>
+NAN_METHOD(Int128<S>::Eqn) {
+  N128 *a = ObjectWrap::Unwrap<N128>(info.Holder());
+
+  if (info.Length() < 1)
+    return Nan::ThrowError(ARG_ERROR(eqn, 1));
+
+  if (!info[0]->IsNumber())
+    return Nan::ThrowTypeError(TYPE_ERROR(value, number));
+
+  uint32_t num = Nan::To<uint32_t>(info[0]).FromJust();
+  bool r = n128_eq(a->n, extend<S>(num)) != 0;
+
+  info.GetReturnValue().Set(Nan::New<v8::Boolean>(r));
+}
+
+NAN_METHOD(N128::IsZero) {
+  N128 *a = ObjectWrap::Unwrap<N128>(info.Holder());
+  bool r = n128_is_zero(a->n) != 0;
+
+  info.GetReturnValue().Set(Nan::New<v8::Boolean>(r));
+}
+
+template <int S>
+NAN_METHOD(Int128<S>::IsNeg) {
+  N128 *a = ObjectWrap::Unwrap<N128>(info.Holder());
+  bool r = n128_is_neg(a->n, S) != 0;
+
+  info.GetReturnValue().Set(Nan::New<v8::Boolean>(r));
+}
+
+NAN_METHOD(N128::IsOdd) {
+  N128 *a = ObjectWrap::Unwrap<N128>(info.Holder());
+  bool r = (a->n.lo & 1) == 1;
+
+  info.GetReturnValue().Set(Nan::New<v8::Boolean>(r));
+}
+
+NAN_METHOD(N128::IsEven) {
+  N128 *a = ObjectWrap::Unwrap<N128>(info.Holder());
+  bool r = (a->n.lo & 1) == 0;
+
+  info.GetReturnValue().Set(Nan::New<v8::Boolean>(r));
+}
+
+NAN_METHOD(N128::Inject) {
+  N128 *a = ObjectWrap::Unwrap<N128>(info.Holder());
+
+  if (info.Length() < 1)
+    return Nan::ThrowError(ARG_ERROR(inject, 1));
+
+  if (!N128::HasInstance(info[0]))
+    return Nan::ThrowTypeError(TYPE_ERROR(value, int128));
+
+  N128 *b = ObjectWrap::Unwrap<N128>(info[0].As<v8::Object>());
+
+  a->n = b->n;
+}
+
+NAN_METHOD(N128::Set) {
+  N128 *a = ObjectWrap::Unwrap<N128>(info.Holder());
+
+  if (info.Length() < 1)
+    return Nan::ThrowError(ARG_ERROR(set, 1));
+
+  if (!info[0]->IsNumber())
+    return Nan::ThrowTypeError(TYPE_ERROR(number, integer));
+
+  int64_t n = Nan::To<int64_t>(info[0]).FromJust();
+
+  if (Nan::To<double>(info[0]).FromJust() != (double)n)
+    return Nan::ThrowTypeError(TYPE_ERROR(number, integer));
+
+  if (n < -N64_MAX_SAFE_INTEGER || n > N64_MAX_SAFE_INTEGER)
+    return stats_throw(THROW_OVERFLOW, "Number exceeds 53 bits.");
+
+  // Negative numbers wrap for U128, as with U64.
+  a->n = n128_extend((uint64_t)n, 1);
+
+  info.GetReturnValue().Set(info.Holder());
+}
+
+NAN_METHOD(N128::Join) {
+  N128 *a = ObjectWrap::Unwrap<N128>(info.Holder());
+
+  if (info.Length() < 4)
+    return Nan::ThrowError(ARG_ERROR(join, 4));
+
+  for (int i = 0; i < 4; i++) {
+    if (!info[i]->IsNumber())
+      return Nan::ThrowTypeError(TYPE_ERROR(word, number));
+  }
+
+  uint64_t w3 = Nan::To<uint32_t>(info[0]).FromJust();
+  uint64_t w2 = Nan::To<uint32_t>(info[1]).FromJust();
+  uint64_t w1 = Nan::To<uint32_t>(info[2]).FromJust();
+  uint64_t w0 = Nan::To<uint32_t>(info[3]).FromJust();
+
+  a->n = n128_make((w3 << 32) | w2, (w1 << 32) | w0);
+
+  info.GetReturnValue().Set(info.Holder());
+}
+
+template <int S>
+NAN_METHOD(Int128<S>::BitLength) {
+  N128 *a = ObjectWrap::Unwrap<N128>(info.Holder());
+  int32_t r = n128_bitlen(a->n, S);
+
+  info.GetReturnValue().Set(Nan::New<v8::Int32>(r));
+}
+
+template <int S>
+NAN_METHOD(Int128<S>::IsSafe) {
+  N128 *a = ObjectWrap::Unwrap<N128>(info.Holder());
+  bool r = n128_is_safe(a->n, S) != 0;
+
+  info.GetReturnValue().Set(Nan::New<v8::Boolean>(r));
+}
+
+template <int S>
+NAN_METHOD(Int128<S>::ToNumber) {
+  N128 *a = ObjectWrap::Unwrap<N128>(info.Holder());
+
+  if (!n128_is_safe(a->n, S))
+    return stats_throw(THROW_OVERFLOW, "Number exceeds 53 bits.");
+
+  double r = n128_to_double(a->n, S);
+
+  info.GetReturnValue().Set(Nan::New<v8::Number>(r));
+}
+
+template <int S>
+NAN_METHOD(Int128<S>::ToDouble) {
+  N128 *a = ObjectWrap::Unwrap<N128>(info.Holder());
+  double r = n128_to_double(a->n, S);
+
+  info.GetReturnValue().Set(Nan::New<v8::Number>(r));
+}
+
+template <int S>
+NAN_METHOD(Int128<S>::ToInt) {
+  N128 *a = ObjectWrap::Unwrap<N128>(info.Holder());
+  double r = S ? (double)((int32_t)a->n.lo) : (double)((uint32_t)a->n.lo);
+
+  info.GetReturnValue().Set(Nan::New<v8::Number>(r));
+}
+
+NAN_METHOD(N128::ToBool) {
+  N128 *a = ObjectWrap::Unwrap<N128>(info.Holder());
+  bool r = !n128_is_zero(a->n);
+
+  info.GetReturnValue().Set(Nan::New<v8::Boolean>(r));
+}
+
+template <int S>
+NAN_METHOD(Int128<S>::ToString) {
+  N128 *a = ObjectWrap::Unwrap<N128>(info.Holder());
+
+  uint32_t base = 10;
+
+  if (info.Length() > 0 && !read_base(info[0], &base))
+    return Nan::ThrowTypeError(TYPE_ERROR(base, integer));
+
+  uint32_t pad = 0;
+
+  if (info.Length() > 1
+      && !info[1]->IsNull() && !info[1]->IsUndefined()) {
+    if (!info[1]->IsNumber())
+      return Nan::ThrowTypeError(TYPE_ERROR(pad, integer));
+
+    pad = Nan::To<uint32_t>(info[1]).FromJust();
+
+    if (Nan::To<double>(info[1]).FromJust() != (double)pad)
+      return Nan::ThrowTypeError(TYPE_ERROR(pad, integer));
+
+    if (pad > 128)
+      return Nan::ThrowError("Maximum padding is 128 characters.");
+  }
+
+  char str[N128_STR_SIZE];
+  size_t size = n128_write(str, a->n, S, base, pad);
+
+  if (size == 0)
+    return Nan::ThrowError("Base ranges between 2 and 16.");
+
+  info.GetReturnValue().Set(
+    Nan::New<v8::String>(str, size).ToLocalChecked());
+}
+
+template <int S>
+NAN_METHOD(Int128<S>::ToN64) {
+  N128 *a = ObjectWrap::Unwrap<N128>(info.Holder());
+
+  if (info.Length() < 1)
+    return Nan::ThrowError(ARG_ERROR(toN64, 1));
+
+  if (!N64::HasInstance(info[0]))
+    return Nan::ThrowTypeError(TYPE_ERROR(target, int64));
+
+  // Narrowing never truncates: the
+  // caller decides what a miss means.
+  N64 *b = ObjectWrap::Unwrap<N64>(info[0].As<v8::Object>());
+  int to = Nan::New(env_get()->i64)->HasInstance(info[0]);
+  bool ok = n128_fits64(a->n, S, to) != 0;
+
+  if (ok)
+    *b->n = a->n.lo;
+
+  info.GetReturnValue().Set(Nan::New<v8::Boolean>(ok));
+}
+
+NAN_METHOD(N128::FromNumber) {
+  N128 *a = ObjectWrap::Unwrap<N128>(info.Holder());
+
+  if (info.Length() < 1)
+    return Nan::ThrowError(ARG_ERROR(fromNumber, 1));
+
+  if (!info[0]->IsNumber())
+    return Nan::ThrowTypeError(TYPE_ERROR(number, integer));
+
+  int64_t n = Nan::To<int64_t>(info[0]).FromJust();
+
+  if (Nan::To<double>(info[0]).FromJust() != (double)n)
+    return Nan::ThrowTypeError(TYPE_ERROR(number, integer));
+
+  if (n < -N64_MAX_SAFE_INTEGER || n > N64_MAX_SAFE_INTEGER)
+    return stats_throw(THROW_OVERFLOW, "Number exceeds 53 bits.");
+
+  a->n = n128_extend((uint64_t)n, 1);
+
+  info.GetReturnValue().Set(info.Holder());
+}
+
+template <int S>
+NAN_METHOD(Int128<S>::FromInt) {
+  N128 *a = ObjectWrap::Unwrap<N128>(info.Holder());
+
+  if (info.Length() < 1)
+    return Nan::ThrowError(ARG_ERROR(fromInt, 1));
+
+  if (!info[0]->IsNumber())
+    return Nan::ThrowTypeError(TYPE_ERROR(integer, number));
+
+  uint32_t num = Nan::To<uint32_t>(info[0]).FromJust();
+
+  a->n = extend<S>(num);
+
+  info.GetReturnValue().Set(info.Holder());
+}
+
+NAN_METHOD(N128::FromBool) {
+  N128 *a = ObjectWrap::Unwrap<N128>(info.Holder());
+
+  if (info.Length() < 1)
+    return Nan::ThrowError(ARG_ERROR(fromBool, 1));
+
+  if (!info[0]->IsBoolean())
+    return Nan::ThrowTypeError(TYPE_ERROR(value, boolean));
+
+  a->n = n128_make(0, (uint64_t)Nan::To<bool>(info[0]).FromJust());
+
+  info.GetReturnValue().Set(info.Holder());
+}
+
+NAN_METHOD(N128::FromN64) {
+  N128 *a = ObjectWrap::Unwrap<N128>(info.Holder());
+
+  if (info.Length() < 1)
+    return Nan::ThrowError(ARG_ERROR(fromN64, 1));
+
+  if (!N64::HasInstance(info[0]))
+    return Nan::ThrowTypeError(TYPE_ERROR(value, int64));
+
+  // Widening is exact: I64 sign-extends, U64 zero-extends.
+  N64 *b = ObjectWrap::Unwrap<N64>(info[0].As<v8::Object>());
+  int sign = Nan::New(env_get()->i64)->HasInstance(info[0]);
+
+  a->n = n128_extend(*b->n, sign);
+
+  info.GetReturnValue().Set(info.Holder());
+}
+
+template <int S>
+NAN_METHOD(Int128<S>::FromString) {
+  N128 *a = ObjectWrap::Unwrap<N128>(info.Holder());
+
+  if (info.Length() < 1)
+    return Nan::ThrowError(ARG_ERROR(fromString, 1));
+
+  if (!info[0]->IsString())
+    return Nan::ThrowTypeError(TYPE_ERROR(string, string));
+
+  uint32_t base = 10;
+
+  if (info.Length() > 1 && !read_base(info[1], &base))
+    return Nan::ThrowTypeError(TYPE_ERROR(base, integer));
+
+  n128_t n;
+
+  switch (read_string(info[0], base, &n)) {
+    case N64_ERR_LENGTH:
+      return stats_throw(THROW_PARSE, "Invalid string (bad length).");
+    case N64_ERR_BASE:
+      return Nan::ThrowError("Base ranges between 2 and 16.");
+    case N64_ERR_OVERFLOW:
+      return stats_throw(THROW_OVERFLOW, "Invalid string (overflow).");
+    case N64_ERR_PARSE:
+      return stats_throw(THROW_PARSE, "Invalid string (parse error).");
+  }
+
+  a->n = n;
+
+  info.GetReturnValue().Set(info.Holder());
+}
+
+NAN_METHOD(N128::TryFromNumber) {
+  N128 *a = ObjectWrap::Unwrap<N128>(info.Holder());
+
+  if (info.Length() < 1)
+    return Nan::ThrowError(ARG_ERROR(tryFromNumber, 1));
+
+  uint64_t n = 0;
+  bool ok = read_number(info[0], &n);
+
+  if (ok)
+    a->n = n128_extend(n, 1);
+
+  info.GetReturnValue().Set(Nan::New<v8::Boolean>(ok));
+}
+
+template <int S>
+NAN_METHOD(Int128<S>::TryIdiv) {
+  N128 *a = ObjectWrap::Unwrap<N128>(info.Holder());
+
+  if (info.Length() < 1)
+    return Nan::ThrowError(ARG_ERROR(tryIdiv, 1));
+
+  if (!N128::HasInstance(info[0]))
+    return Nan::ThrowTypeError(TYPE_ERROR(divisor, int128));
+
+  N128 *b = ObjectWrap::Unwrap<N128>(info[0].As<v8::Object>());
+  bool ok = !n128_is_zero(b->n);
+
+  if (ok)
+    a->n = n128_div(a->n, b->n, S);
+
+  info.GetReturnValue().Set(Nan::New<v8::Boolean>(ok));
+}
+
+template <int S>
+NAN_METHOD(Int128<S>::TryImod) {
+  N128 *a = ObjectWrap::Unwrap<N128>(info.Holder());
+
+  if (info.Length() < 1)
+    return Nan::ThrowError(ARG_ERROR(tryImod, 1));
+
+  if (!N128::HasInstance(info[0]))
+    return Nan::ThrowTypeError(TYPE_ERROR(divisor, int128));
+
+  N128 *b = ObjectWrap::Unwrap<N128>(info[0].As<v8::Object>());
+  bool ok = !n128_is_zero(b->n);
+
+  if (ok)
+    a->n = n128_mod(a->n, b->n, S);
+
+  info.GetReturnValue().Set(Nan::New<v8::Boolean>(ok));
+}
+
+template <int S>
+NAN_METHOD(Int128<S>::TryToNumber) {
+  N128 *a = ObjectWrap::Unwrap<N128>(info.Holder());
+  double r = NAN;
+
+  if (n128_is_safe(a->n, S))
+    r = n128_to_double(a->n, S);
+
+  info.GetReturnValue().Set(Nan::New<v8::Number>(r));
+}
+
+template <int S>
+NAN_METHOD(Int128<S>::TryFromString) {
+  N128 *a = ObjectWrap::Unwrap<N128>(info.Holder());
+
+  if (info.Length() < 1)
+    return Nan::ThrowError(ARG_ERROR(tryFromString, 1));
+
+  uint32_t base = 10;
+
+  if (info.Length() > 1 && !read_base(info[1], &base))
+    return Nan::ThrowTypeError(TYPE_ERROR(base, integer));
+
+  n128_t n;
+  int r = read_string(info[0], base, &n);
+
+  if (r == N64_ERR_BASE)
+    return Nan::ThrowError("Base ranges between 2 and 16.");
+
+  if (r == N64_OK)
+    a->n = n;
+
+  info.GetReturnValue().Set(Nan::New<v8::Boolean>(r == N64_OK));
+}
+
+template class Int128<0>;
+template class Int128<1>;
@@ -0,0 +1,107 @@
+/**
+ * n128.h - native int128 object for node.js.
+ * Copyright (c) 2017, Christopher Jeffrey (MIT License)
+ */
+
+#ifndef _N64_N128_H
+#define _N64_N128_H
+
+#include <node.h>
+#include <nan.h>
+#include <inttypes.h>
+
+#include "core.h"
+
+class N128 : public Nan::ObjectWrap {
+public:
+  static void Init(v8::Local<v8::Object> &target);
+  static bool HasInstance(v8::Local<v8::Value> val);
+
+  N128();
+  ~N128();
+
+  n128_t n;
+
+private:
+  static NAN_METHOD(GetWord);
+  static NAN_METHOD(SetWord);
+  static NAN_METHOD(Iadd);
+  static NAN_METHOD(Isub);
+  static NAN_METHOD(Imul);
+  static NAN_METHOD(Ipown);
+  static NAN_METHOD(Iand);
+  static NAN_METHOD(Ior);
+  static NAN_METHOD(Ixor);
+  static NAN_METHOD(Inot);
+  static NAN_METHOD(Ishln);
+  static NAN_METHOD(Iushrn);
+  static NAN_METHOD(Setn);
+  static NAN_METHOD(Testn);
+  static NAN_METHOD(Setb);
+  static NAN_METHOD(Orb);
+  static NAN_METHOD(Getb);
+  static NAN_METHOD(Imaskn);
+  static NAN_METHOD(Andln);
+  static NAN_METHOD(Ineg);
+  static NAN_METHOD(Eq);
+  static NAN_METHOD(IsZero);
+  static NAN_METHOD(IsOdd);
+  static NAN_METHOD(IsEven);
+  static NAN_METHOD(Inject);
+  static NAN_METHOD(Set);
+  static NAN_METHOD(Join);
+  static NAN_METHOD(ToBool);
+  static NAN_METHOD(FromNumber);
+  static NAN_METHOD(FromBool);
+  static NAN_METHOD(FromN64);
+  static NAN_METHOD(TryFromNumber);
+};
+
+/*
+ * Int128 - the U128 and I128 bindings, split
+ * by sign the same way as Int64.
+ */
+
+template <int S>
+class Int128 : public N128 {
+public:
+  static void Init(v8::Local<v8::Object> &target,
+                   v8::Local<v8::FunctionTemplate> base);
+  static NAN_METHOD(New);
+
+private:
+  static NAN_METHOD(GetSign);
+  static NAN_METHOD(Iaddn);
+  static NAN_METHOD(Isubn);
+  static NAN_METHOD(Imuln);
+  static NAN_METHOD(Idiv);
+  static NAN_METHOD(Idivn);
+  static NAN_METHOD(Imod);
+  static NAN_METHOD(Imodn);
+  static NAN_METHOD(Iandn);
+  static NAN_METHOD(Iorn);
+  static NAN_METHOD(Ixorn);
+  static NAN_METHOD(Ishrn);
+  static NAN_METHOD(Cmp);
+  static NAN_METHOD(Cmpn);
+  static NAN_METHOD(Eqn);
+  static NAN_METHOD(IsNeg);
+  static NAN_METHOD(BitLength);
+  static NAN_METHOD(IsSafe);
+  static NAN_METHOD(ToNumber);
+  static NAN_METHOD(ToDouble);
+  static NAN_METHOD(ToInt);
+  static NAN_METHOD(ToString);
+  static NAN_METHOD(ToN64);
+  static NAN_METHOD(FromInt);
+  static NAN_METHOD(FromString);
+  static NAN_METHOD(TryIdiv);
+  static NAN_METHOD(TryImod);
+  static NAN_METHOD(TryToNumber);
+  static NAN_METHOD(TryFromString);
+};
+
+typedef Int128<0> U128;
+typedef Int128<1> I128;
+
+#endif
@@ -9,138 +9,313 @@
 #include <cmath>
 #include <inttypes.h>
 #include <stdlib.h>
+#include <string.h>
 
+#include "core.h"
+#include "env.h"
+#include "stats.h"
 #include "n64.h"
+#include "n128.h"
+#include "rng.h"
+#include "histogram.h"
+#include "struct.h"
+#include "json.h"
+#include "dec64.h"
+#include "array.h"
+#include "atomic.h"
+#include "bulk.h"
 
 #define ARG_ERROR(name, len) ("N64#" #name " requires " #len " argument(s).")
 #define TYPE_ERROR(name, type) ("'" #name "' must be a(n) " #type ".")
 
-static Nan::Persistent<v8::FunctionTemplate> int64_constructor;
-
 NAN_INLINE static bool IsNull(v8::Local<v8::Value> options);
 static uint32_t get_base(const char *name);
 
-static int64_t MAX_SAFE_INTEGER = 0x1fffffffffffff;
+/*
+ * Helpers
+ */
+
+template <int S>
+static inline uint64_t
+extend(uint32_t num) {
+  // Small operands are sign-extended for I64.
+  return S ? (uint64_t)((int64_t)((int32_t)num)) : (uint64_t)num;
+}
+
+template <int S>
+static inline uint64_t
+shr(uint64_t n, uint32_t bits) {
+  return S ? (uint64_t)((int64_t)n >> bits) : n >> bits;
+}
+
+/*
+ * N64
+ */
 
 N64::N64() {
-  n = 0;
-  sign = 0;
+  slot = 0;
+  n = &slot;
+  base = NULL;
+  len = 0;
 }
 
-N64::~N64() {}
+N64::~N64() {
+#if NODE_MAJOR_VERSION >= 14
+  store.reset();
+#else
+  store.Reset();
+#endif
+}
 
 void
 N64::Init(v8::Local<v8::Object> &target) {
   Nan::HandleScope scope;
 
-  v8::Local<v8::FunctionTemplate> tpl =
-    Nan::New<v8::FunctionTemplate>(N64::New);
-
-  int64_constructor.Reset(tpl);
-
-  tpl->SetClassName(Nan::New("N64").ToLocalChecked());
-  tpl->InstanceTemplate()->SetInternalFieldCount(1);
-
-  Nan::SetPrototypeMethod(tpl, "getHi", N64::GetHi);
-  Nan::SetPrototypeMethod(tpl, "setHi", N64::SetHi);
-  Nan::SetPrototypeMethod(tpl, "getLo", N64::GetLo);
-  Nan::SetPrototypeMethod(tpl, "setLo", N64::SetLo);
-  Nan::SetPrototypeMethod(tpl, "getSign", N64::GetSign);
-  Nan::SetPrototypeMethod(tpl, "setSign", N64::SetSign);
-  Nan::SetPrototypeMethod(tpl, "iadd", N64::Iadd);
-  Nan::SetPrototypeMethod(tpl, "iaddn", N64::Iaddn);
-  Nan::SetPrototypeMethod(tpl, "isub", N64::Isub);
-  Nan::SetPrototypeMethod(tpl, "isubn", N64::Isubn);
-  Nan::SetPrototypeMethod(tpl, "imul", N64::Imul);
-  Nan::SetPrototypeMethod(tpl, "imuln", N64::Imuln);
-  Nan::SetPrototypeMethod(tpl, "idiv", N64::Idiv);
-  Nan::SetPrototypeMethod(tpl, "idivn", N64::Idivn);
-  Nan::SetPrototypeMethod(tpl, "imod", N64::Imod);
-  Nan::SetPrototypeMethod(tpl, "imodn", N64::Imodn);
-  Nan::SetPrototypeMethod(tpl, "ipown", N64::Ipown);
-  Nan::SetPrototypeMethod(tpl, "iand", N64::Iand);
-  Nan::SetPrototypeMethod(tpl, "iandn", N64::Iandn);
-  Nan::SetPrototypeMethod(tpl, "ior", N64::Ior);
-  Nan::SetPrototypeMethod(tpl, "iorn", N64::Iorn);
-  Nan::SetPrototypeMethod(tpl, "ixor", N64::Ixor);
-  Nan::SetPrototypeMethod(tpl, "inot", N64::Inot);
-  Nan::SetPrototypeMethod(tpl, "ixorn", N64::Ixorn);
-  Nan::SetPrototypeMethod(tpl, "ishln", N64::Ishln);
-  Nan::SetPrototypeMethod(tpl, "ishrn", N64::Ishrn);
-  Nan::SetPrototypeMethod(tpl, "iushrn", N64::Iushrn);
-  Nan::SetPrototypeMethod(tpl, "setn", N64::Setn);
-  Nan::SetPrototypeMethod(tpl, "testn", N64::Testn);
-  Nan::SetPrototypeMethod(tpl, "setb", N64::Setb);
-  Nan::SetPrototypeMethod(tpl, "orb", N64::Orb);
-  Nan::SetPrototypeMethod(tpl, "getb", N64::Getb);
-  Nan::SetPrototypeMethod(tpl, "imaskn", N64::Imaskn);
-  Nan::SetPrototypeMethod(tpl, "andln", N64::Andln);
-  Nan::SetPrototypeMethod(tpl, "ineg", N64::Ineg);
-  Nan::SetPrototypeMethod(tpl, "cmp", N64::Cmp);
-  Nan::SetPrototypeMethod(tpl, "cmpn", N64::Cmpn);
-  Nan::SetPrototypeMethod(tpl, "eq", N64::Eq);
-  Nan::SetPrototypeMethod(tpl, "eqn", N64::Eqn);
-  Nan::SetPrototypeMethod(tpl, "isZero", N64::IsZero);
-  Nan::SetPrototypeMethod(tpl, "isNeg", N64::IsNeg);
-  Nan::SetPrototypeMethod(tpl, "isOdd", N64::IsOdd);
-  Nan::SetPrototypeMethod(tpl, "isEven", N64::IsEven);
-  Nan::SetPrototypeMethod(tpl, "inject", N64::Inject);
-  Nan::SetPrototypeMethod(tpl, "set", N64::Set);
-  Nan::SetPrototypeMethod(tpl, "join", N64::Join);
-  Nan::SetPrototypeMethod(tpl, "bitLength", N64::BitLength);
-  Nan::SetPrototypeMethod(tpl, "isSafe", N64::IsSafe);
-  Nan::SetPrototypeMethod(tpl, "toNumber", N64::ToNumber);
-  Nan::SetPrototypeMethod(tpl, "toDouble", N64::ToDouble);
-  Nan::SetPrototypeMethod(tpl, "toInt", N64::ToInt);
-  Nan::SetPrototypeMethod(tpl, "toBool", N64::ToBool);
-  Nan::SetPrototypeMethod(tpl, "toString", N64::ToString);
-  Nan::SetPrototypeMethod(tpl, "fromNumber", N64::FromNumber);
-  Nan::SetPrototypeMethod(tpl, "fromInt", N64::FromInt);
-  Nan::SetPrototypeMethod(tpl, "fromBool", N64::FromBool);
-  Nan::SetPrototypeMethod(tpl, "fromBits", N64::FromBits);
-  Nan::SetPrototypeMethod(tpl, "fromString", N64::FromString);
-
-  v8::Local<v8::FunctionTemplate> ctor =
-    Nan::New<v8::FunctionTemplate>(int64_constructor);
-
-  Nan::Set(target, Nan::New("N64").ToLocalChecked(),
-    Nan::GetFunction(ctor).ToLocalChecked());
+  n64_env_t *env = env_get();
+
+  if (env->int64.IsEmpty()) {
+    // Abstract base. Methods which do not depend on the
+    // sign live here so that JS call sites see the same
+    // function for both U64 and I64 and stay monomorphic.
+    v8::Local<v8::FunctionTemplate> tpl = Nan::New<v8::FunctionTemplate>();
+
+    tpl->SetClassName(Nan::New("N64").ToLocalChecked());
+
+    stats_method(tpl, "N64", "attach", N64::Attach);
+    stats_method(tpl, "N64", "seek", N64::Seek);
+    stats_method(tpl, "N64", "share", N64::Share);
+    stats_method(tpl, "N64", "getHi", N64::GetHi);
+    stats_method(tpl, "N64", "setHi", N64::SetHi);
+    stats_method(tpl, "N64", "getLo", N64::GetLo);
+    stats_method(tpl, "N64", "setLo", N64::SetLo);
+    stats_method(tpl, "N64", "iadd", N64::Iadd);
+    stats_method(tpl, "N64", "isub", N64::Isub);
+    stats_method(tpl, "N64", "imul", N64::Imul);
+    stats_method(tpl, "N64", "ipown", N64::Ipown);
+    stats_method(tpl, "N64", "iand", N64::Iand);
+    stats_method(tpl, "N64", "ior", N64::Ior);
+    stats_method(tpl, "N64", "ixor", N64::Ixor);
+    stats_method(tpl, "N64", "inot", N64::Inot);
+    stats_method(tpl, "N64", "ishln", N64::Ishln);
+    stats_method(tpl, "N64", "iushrn", N64::Iushrn);
+    stats_method(tpl, "N64", "setn", N64::Setn);
+    stats_method(tpl, "N64", "testn", N64::Testn);
+    stats_method(tpl, "N64", "setb", N64::Setb);
+    stats_method(tpl, "N64", "orb", N64::Orb);
+    stats_method(tpl, "N64", "getb", N64::Getb);
+    stats_method(tpl, "N64", "imaskn", N64::Imaskn);
+    stats_method(tpl, "N64", "andln", N64::Andln);
+    stats_method(tpl, "N64", "ineg", N64::Ineg);
+    stats_method(tpl, "N64", "eq", N64::Eq);
+    stats_method(tpl, "N64", "isZero", N64::IsZero);
+    stats_method(tpl, "N64", "isOdd", N64::IsOdd);
+    stats_method(tpl, "N64", "isEven", N64::IsEven);
+    stats_method(tpl, "N64", "inject", N64::Inject);
+    stats_method(tpl, "N64", "set", N64::Set);
+    stats_method(tpl, "N64", "join", N64::Join);
+    stats_method(tpl, "N64", "toBool", N64::ToBool);
+    stats_method(tpl, "N64", "fromNumber", N64::FromNumber);
+    stats_method(tpl, "N64", "fromBool", N64::FromBool);
+    stats_method(tpl, "N64", "fromBits", N64::FromBits);
+    stats_method(tpl, "N64", "tryFromNumber", N64::TryFromNumber);
+
+    env->int64.Reset(tpl);
+  }
+
+  v8::Local<v8::FunctionTemplate> base = Nan::New(env->int64);
+
+  U64::Init(target, base);
+  I64::Init(target, base);
 }
 
 bool N64::HasInstance(v8::Local<v8::Value> val) {
   Nan::HandleScope scope;
-  return Nan::New(int64_constructor)->HasInstance(val);
+  return Nan::New(env_get()->int64)->HasInstance(val);
 }
 
-NAN_METHOD(N64::New) {
+/*
+ * Int64
+ */
+
+template <int S>
+void
+Int64<S>::Init(v8::Local<v8::Object> &target,
+               v8::Local<v8::FunctionTemplate> base) {
+  const char *name = S ? "I64" : "U64";
+  n64_env_t *env = env_get();
+  Nan::Persistent<v8::FunctionTemplate> &ctor = S ? env->i64 : env->u64;
+
+  if (ctor.IsEmpty()) {
+    v8::Local<v8::FunctionTemplate> tpl =
+      stats_template(name, Int64<S>::New);
+
+    tpl->Inherit(base);
+    tpl->SetClassName(Nan::New(name).ToLocalChecked());
+    tpl->InstanceTemplate()->SetInternalFieldCount(1);
+
+    stats_method(tpl, name, "getSign", Int64<S>::GetSign);
+    stats_method(tpl, name, "iaddn", Int64<S>::Iaddn);
+    stats_method(tpl, name, "isubn", Int64<S>::Isubn);
+    stats_method(tpl, name, "imuln", Int64<S>::Imuln);
+    stats_method(tpl, name, "idiv", Int64<S>::Idiv);
+    stats_method(tpl, name, "idivn", Int64<S>::Idivn);
+    stats_method(tpl, name, "imod", Int64<S>::Imod);
+    stats_method(tpl, name, "imodn", Int64<S>::Imodn);
+    stats_method(tpl, name, "iandn", Int64<S>::Iandn);
+    stats_method(tpl, name, "iorn", Int64<S>::Iorn);
+    stats_method(tpl, name, "ixorn", Int64<S>::Ixorn);
+    stats_method(tpl, name, "ishrn", Int64<S>::Ishrn);
+    stats_method(tpl, name, "cmp", Int64<S>::Cmp);
+    stats_method(tpl, name, "cmpn", Int64<S>::Cmpn);
+    stats_method(tpl, name, "eqn", Int64<S>::Eqn);
+    stats_method(tpl, name, "isNeg", Int64<S>::IsNeg);
+    stats_method(tpl, name, "bitLength", Int64<S>::BitLength);
+    stats_method(tpl, name, "isSafe", Int64<S>::IsSafe);
+    stats_method(tpl, name, "toNumber", Int64<S>::ToNumber);
+    stats_method(tpl, name, "toDouble", Int64<S>::ToDouble);
+    stats_method(tpl, name, "toInt", Int64<S>::ToInt);
+    stats_method(tpl, name, "toString", Int64<S>::ToString);
+    stats_method(tpl, name, "writeString", Int64<S>::WriteString);
+    stats_method(tpl, name, "fromInt", Int64<S>::FromInt);
+    stats_method(tpl, name, "fromString", Int64<S>::FromString);
+    stats_method(tpl, name, "tryIdiv", Int64<S>::TryIdiv);
+    stats_method(tpl, name, "tryImod", Int64<S>::TryImod);
+    stats_method(tpl, name, "tryToNumber", Int64<S>::TryToNumber);
+    stats_method(tpl, name, "tryFromString", Int64<S>::TryFromString);
+    stats_method(tpl, name, "isqrt", Int64<S>::Isqrt);
+    stats_method(tpl, name, "icbrt", Int64<S>::Icbrt);
+    stats_method(tpl, name, "log2", Int64<S>::Log2);
+    stats_method(tpl, name, "log10", Int64<S>::Log10);
+    stats_method(tpl, name, "igcd", Int64<S>::Igcd);
+    stats_method(tpl, name, "ilcm", Int64<S>::Ilcm);
+    stats_method(tpl, name, "isPowerOfTwo", Int64<S>::IsPowerOfTwo);
+    stats_method(tpl, name, "inextPowerOfTwo", Int64<S>::InextPowerOfTwo);
+    stats_method(tpl, name, "idivmod", Int64<S>::Idivmod);
+
+    ctor.Reset(tpl);
+  }
+
+  Nan::Set(target, Nan::New(name).ToLocalChecked(),
+    Nan::GetFunction(Nan::New(ctor)).ToLocalChecked());
+}
+
+template <int S>
+NAN_METHOD(Int64<S>::New) {
   if (!info.IsConstructCall())
-    return Nan::ThrowError("N64 must be called with `new`.");
+    return Nan::ThrowError(S ? "I64 must be called with `new`."
+                             : "U64 must be called with `new`.");
+
+  Int64<S> *obj = new Int64<S>();
+  obj->Wrap(info.This());
+
+  stats_alloc();
+
+  info.GetReturnValue().Set(info.This());
+}
+
+NAN_METHOD(N64::Attach) {
+  N64 *a = ObjectWrap::Unwrap<N64>(info.Holder());
+
+  if (info.Length() < 2)
+    return Nan::ThrowError(ARG_ERROR(attach, 2));
+
+  if (!info[0]->IsArrayBufferView())
+    return Nan::ThrowTypeError(TYPE_ERROR(data, buffer));
+
+  if (!info[1]->IsUint32())
+    return Nan::ThrowTypeError(TYPE_ERROR(offset, integer));
+
+  v8::Local<v8::ArrayBufferView> view = info[0].As<v8::ArrayBufferView>();
+  v8::Local<v8::ArrayBuffer> buf = view->Buffer();
+  uint32_t off = Nan::To<uint32_t>(info[1]).FromJust();
+  size_t len = view->ByteLength();
+
+  if ((size_t)off + 8 > len)
+    return Nan::ThrowError("Invalid offset.");
+
+#if NODE_MAJOR_VERSION >= 14
+  std::shared_ptr<v8::BackingStore> store = buf->GetBackingStore();
+  uint8_t *data = (uint8_t *)store->Data() + view->ByteOffset();
+#else
+  uint8_t *data = (uint8_t *)buf->GetContents().Data() + view->ByteOffset();
+#endif
+
+  if (((uintptr_t)(data + off) & 7) != 0)
+    return Nan::ThrowError("Unaligned offset.");
+
+  // Hold the memory for as long as we point into it.
+#if NODE_MAJOR_VERSION >= 14
+  a->store = store;
+#else
+  a->store.Reset(view);
+#endif
+  a->base = data;
+  a->len = len;
+  a->n = (uint64_t *)(a->base + off);
+
+  info.GetReturnValue().Set(info.Holder());
+}
+
+NAN_METHOD(N64::Seek) {
+  N64 *a = ObjectWrap::Unwrap<N64>(info.Holder());
 
   if (info.Length() < 1)
-    return Nan::ThrowError(ARG_ERROR(new, 1));
+    return Nan::ThrowError(ARG_ERROR(seek, 1));
 
-  if (!info[0]->IsNumber())
-    return Nan::ThrowTypeError(TYPE_ERROR(sign, bit));
+  if (!info[0]->IsUint32())
+    return Nan::ThrowTypeError(TYPE_ERROR(offset, integer));
 
-  uint8_t sign = (uint8_t)Nan::To<uint32_t>(info[0]).FromJust();
+  if (a->base == NULL)
+    return Nan::ThrowError("Object is not a view.");
 
-  if (Nan::To<double>(info[0]).FromJust() != (double)sign)
-    return Nan::ThrowTypeError(TYPE_ERROR(sign, bit));
+  uint32_t off = Nan::To<uint32_t>(info[0]).FromJust();
 
-  if (sign > 1)
-    return Nan::ThrowTypeError(TYPE_ERROR(sign, bit));
+  if ((size_t)off + 8 > a->len)
+    return Nan::ThrowError("Invalid offset.");
 
-  N64 *obj = new N64();
-  obj->sign = sign;
-  obj->Wrap(info.This());
+  if (((uintptr_t)(a->base + off) & 7) != 0)
+    return Nan::ThrowError("Unaligned offset.");
 
-  info.GetReturnValue().Set(info.This());
+  a->n = (uint64_t *)(a->base + off);
+
+  info.GetReturnValue().Set(info.Holder());
+}
+
+// Takes on the value of another object. A view's
+// slot is shared rather than copied, so that a view
+// rewrapped with a new sign still writes through.
+NAN_METHOD(N64::Share) {
+  N64 *a = ObjectWrap::Unwrap<N64>(info.Holder());
+
+  if (info.Length() < 1)
+    return Nan::ThrowError(ARG_ERROR(share, 1));
+
+  if (!N64::HasInstance(info[0]))
+    return Nan::ThrowTypeError(TYPE_ERROR(operand, int64));
+
+  N64 *b = ObjectWrap::Unwrap<N64>(info[0].As<v8::Object>());
+
+  if (b->base == NULL) {
+    *a->n = *b->n;
+    return info.GetReturnValue().Set(info.Holder());
+  }
+
+#if NODE_MAJOR_VERSION >= 14
+  a->store = b->store;
+#else
+  a->store.Reset(Nan::New(b->store));
+#endif
+  a->base = b->base;
+  a->len = b->len;
+  a->n = b->n;
+
+  info.GetReturnValue().Set(info.Holder());
 }
 
 NAN_METHOD(N64::GetHi) {
   N64 *a = ObjectWrap::Unwrap<N64>(info.Holder());
 
-  int32_t hi = (int32_t)(a->n >> 32);
+  int32_t hi = (int32_t)(*a->n >> 32);
 
   info.GetReturnValue().Set(Nan::New<v8::Int32>(hi));
 }
@@ -156,7 +331,7 @@ NAN_METHOD(N64::SetHi) {
 
   uint32_t hi = Nan::To<uint32_t>(info[0]).FromJust();
 
-  a->n = ((uint64_t)hi << 32) | (a->n & 0xffffffffull);
+  *a->n = ((uint64_t)hi << 32) | (*a->n & 0xffffffffull);
 
   info.GetReturnValue().Set(info.Holder());
 }
@@ -164,7 +339,7 @@ NAN_METHOD(N64::SetHi) {
 NAN_METHOD(N64::GetLo) {
   N64 *a = ObjectWrap::Unwrap<N64>(info.Holder());
 
-  int32_t lo = (int32_t)(a->n & 0xffffffffull);
+  int32_t lo = (int32_t)(*a->n & 0xffffffffull);
 
   info.GetReturnValue().Set(Nan::New<v8::Int32>(lo));
 }
@@ -180,37 +355,15 @@ NAN_METHOD(N64::SetLo) {
 
   uint32_t lo = Nan::To<uint32_t>(info[0]).FromJust();
 
-  a->n &= ~0xffffffffull;
-  a->n |= lo;
+  *a->n &= ~0xffffffffull;
+  *a->n |= lo;
 
   info.GetReturnValue().Set(info.Holder());
 }
 
-NAN_METHOD(N64::GetSign) {
-  N64 *a = ObjectWrap::Unwrap<N64>(info.Holder());
-  info.GetReturnValue().Set(Nan::New<v8::Uint32>((int32_t)a->sign));
-}
-
-NAN_METHOD(N64::SetSign) {
-  N64 *a = ObjectWrap::Unwrap<N64>(info.Holder());
-
-  if (info.Length() < 1)
-    return Nan::ThrowError(ARG_ERROR(setSign, 1));
-
-  if (!info[0]->IsNumber())
-    return Nan::ThrowTypeError(TYPE_ERROR(sign, number));
-
-  uint8_t sign = (uint8_t)Nan::To<uint32_t>(info[0]).FromJust();
-
-  if (Nan::To<double>(info[0]).FromJust() != (double)sign)
-    return Nan::ThrowTypeError(TYPE_ERROR(sign, bit));
-
-  if (sign > 1)
-    return Nan::ThrowTypeError(TYPE_ERROR(sign, bit));
-
-  a->sign = sign;
-
-  info.GetReturnValue().Set(info.Holder());
+template <int S>
+NAN_METHOD(Int64<S>::GetSign) {
+  info.GetReturnValue().Set(Nan::New<v8::Uint32>((uint32_t)S));
 }
 
 NAN_METHOD(N64::Iadd) {
@@ -224,15 +377,13 @@ NAN_METHOD(N64::Iadd) {
 
   N64 *b = ObjectWrap::Unwrap<N64>(info[0].As<v8::Object>());
 
-  if (a->sign)
-    a->n = (int64_t)a->n + (int64_t)b->n;
-  else
-    a->n += b->n;
+  *a->n += *b->n;
 
   info.GetReturnValue().Set(info.Holder());
 }
 
-NAN_METHOD(N64::Iaddn) {
+template <int S>
+NAN_METHOD(Int64<S>::Iaddn) {
   N64 *a = ObjectWrap::Unwrap<N64>(info.Holder());
 
   if (info.Length() < 1)
@@ -243,10 +394,7 @@ NAN_METHOD(N64::Iaddn) {
 
   uint32_t num = Nan::To<uint32_t>(info[0]).FromJust();
 
-  if (a->sign)
-    a->n = (int64_t)a->n + (int64_t)((int32_t)num);
-  else
-    a->n += num;
+  *a->n += extend<S>(num);
 
   info.GetReturnValue().Set(info.Holder());
 }
@@ -262,15 +410,13 @@ NAN_METHOD(N64::Isub) {
 
   N64 *b = ObjectWrap::Unwrap<N64>(info[0].As<v8::Object>());
 
-  if (a->sign)
-    a->n = (int64_t)a->n - (int64_t)b->n;
-  else
-    a->n -= b->n;
+  *a->n -= *b->n;
 
   info.GetReturnValue().Set(info.Holder());
 }
 
-NAN_METHOD(N64::Isubn) {
+template <int S>
+NAN_METHOD(Int64<S>::Isubn) {
   N64 *a = ObjectWrap::Unwrap<N64>(info.Holder());
 
   if (info.Length() < 1)
@@ -281,10 +427,7 @@ NAN_METHOD(N64::Isubn) {
 
   uint32_t num = Nan::To<uint32_t>(info[0]).FromJust();
 
-  if (a->sign)
-    a->n = (int64_t)a->n - (int64_t)((int32_t)num);
-  else
-    a->n -= num;
+  *a->n -= extend<S>(num);
 
   info.GetReturnValue().Set(info.Holder());
 }
@@ -300,15 +443,13 @@ NAN_METHOD(N64::Imul) {
 
   N64 *b = ObjectWrap::Unwrap<N64>(info[0].As<v8::Object>());
 
-  if (a->sign)
-    a->n = (int64_t)a->n * (int64_t)b->n;
-  else
-    a->n *= b->n;
+  *a->n *= *b->n;
 
   info.GetReturnValue().Set(info.Holder());
 }
 
-NAN_METHOD(N64::Imuln) {
+template <int S>
+NAN_METHOD(Int64<S>::Imuln) {
   N64 *a = ObjectWrap::Unwrap<N64>(info.Holder());
 
   if (info.Length() < 1)
@@ -319,15 +460,13 @@ NAN_METHOD(N64::Imuln) {
 
   uint32_t num = Nan::To<uint32_t>(info[0]).FromJust();
 
-  if (a->sign)
-    a->n = (int64_t)a->n * (int64_t)((int32_t)num);
-  else
-    a->n *= num;
+  *a->n *= extend<S>(num);
 
   info.GetReturnValue().Set(info.Holder());
 }
 
-NAN_METHOD(N64::Idiv) {
+template <int S>
+NAN_METHOD(Int64<S>::Idiv) {
   N64 *a = ObjectWrap::Unwrap<N64>(info.Holder());
 
   if (info.Length() < 1)
@@ -338,22 +477,16 @@ NAN_METHOD(N64::Idiv) {
 
   N64 *b = ObjectWrap::Unwrap<N64>(info[0].As<v8::Object>());
 
-  if (b->n == 0)
-    return Nan::ThrowError("Cannot divide by zero.");
+  if (*b->n == 0)
+    return stats_throw(THROW_DIVZERO, "Cannot divide by zero.");
 
-  if (a->sign) {
-    if ((int64_t)a->n == LLONG_MIN && (int64_t)b->n == -1)
-      ;
-    else
-      a->n = (int64_t)a->n / (int64_t)b->n;
-  } else {
-    a->n /= b->n;
-  }
+  *a->n = n64_div(*a->n, *b->n, S);
 
   info.GetReturnValue().Set(info.Holder());
 }
 
-NAN_METHOD(N64::Idivn) {
+template <int S>
+NAN_METHOD(Int64<S>::Idivn) {
   N64 *a = ObjectWrap::Unwrap<N64>(info.Holder());
 
   if (info.Length() < 1)
@@ -365,21 +498,15 @@ NAN_METHOD(N64::Idivn) {
   uint32_t num = Nan::To<uint32_t>(info[0]).FromJust();
 
   if (num == 0)
-    return Nan::ThrowError("Cannot divide by zero.");
-
-  if (a->sign) {
-    if ((int64_t)a->n == LLONG_MIN && (int32_t)num == -1)
-      ;
-    else
-      a->n = (int64_t)a->n / (int64_t)((int32_t)num);
-  } else {
-    a->n /= num;
-  }
+    return stats_throw(THROW_DIVZERO, "Cannot divide by zero.");
+
+  *a->n = n64_div(*a->n, extend<S>(num), S);
 
   info.GetReturnValue().Set(info.Holder());
 }
 
-NAN_METHOD(N64::Imod) {
+template <int S>
+NAN_METHOD(Int64<S>::Imod) {
   N64 *a = ObjectWrap::Unwrap<N64>(info.Holder());
 
   if (info.Length() < 1)
@@ -390,21 +517,16 @@ NAN_METHOD(N64::Imod) {
 
   N64 *b = ObjectWrap::Unwrap<N64>(info[0].As<v8::Object>());
 
-  if (b->n == 0)
-    return Nan::ThrowError("Cannot divide by zero.");
+  if (*b->n == 0)
+    return stats_throw(THROW_DIVZERO, "Cannot divide by zero.");
 
-  if (a->sign)
-    if ((int64_t)a->n == LLONG_MIN && (int64_t)b->n == -1)
-      a->n = 0;
-    else
-      a->n = (int64_t)a->n % (int64_t)b->n;
-  else
-    a->n %= b->n;
+  *a->n = n64_mod(*a->n, *b->n, S);
 
   info.GetReturnValue().Set(info.Holder());
 }
 
-NAN_METHOD(N64::Imodn) {
+template <int S>
+NAN_METHOD(Int64<S>::Imodn) {
   N64 *a = ObjectWrap::Unwrap<N64>(info.Holder());
 
   if (info.Length() < 1)
@@ -416,15 +538,9 @@ NAN_METHOD(N64::Imodn) {
   uint32_t num = Nan::To<uint32_t>(info[0]).FromJust();
 
   if (num == 0)
-    return Nan::ThrowError("Cannot divide by zero.");
+    return stats_throw(THROW_DIVZERO, "Cannot divide by zero.");
 
-  if (a->sign)
-    if ((int64_t)a->n == LLONG_MIN && (int32_t)num == -1)
-      a->n = 0;
-    else
-      a->n = (int64_t)a->n % (int64_t)((int32_t)num);
-  else
-    a->n %= num;
+  *a->n = n64_mod(*a->n, extend<S>(num), S);
 
   info.GetReturnValue().Set(info.Holder());
 }
@@ -438,19 +554,9 @@ NAN_METHOD(N64::Ipown) {
   if (!info[0]->IsNumber())
     return Nan::ThrowTypeError(TYPE_ERROR(exponent, number));
 
-  uint64_t x = a->n;
   uint32_t y = Nan::To<uint32_t>(info[0]).FromJust();
 
-  if (a->n != 0) {
-    a->n = 1;
-
-    while (y > 0) {
-      if (y & 1)
-        a->n *= x;
-      y >>= 1;
-      x *= x;
-    }
-  }
+  *a->n = n64_pow(*a->n, y);
 
   info.GetReturnValue().Set(info.Holder());
 }
@@ -466,15 +572,13 @@ NAN_METHOD(N64::Iand) {
 
   N64 *b = ObjectWrap::Unwrap<N64>(info[0].As<v8::Object>());
 
-  if (a->sign)
-    a->n = (int64_t)a->n & (int64_t)b->n;
-  else
-    a->n &= b->n;
+  *a->n &= *b->n;
 
   info.GetReturnValue().Set(info.Holder());
 }
 
-NAN_METHOD(N64::Iandn) {
+template <int S>
+NAN_METHOD(Int64<S>::Iandn) {
   N64 *a = ObjectWrap::Unwrap<N64>(info.Holder());
 
   if (info.Length() < 1)
@@ -485,10 +589,7 @@ NAN_METHOD(N64::Iandn) {
 
   uint32_t num = Nan::To<uint32_t>(info[0]).FromJust();
 
-  if (a->sign)
-    a->n = (int64_t)a->n & (int64_t)((int32_t)num);
-  else
-    a->n &= num;
+  *a->n &= extend<S>(num);
 
   info.GetReturnValue().Set(info.Holder());
 }
@@ -504,15 +605,13 @@ NAN_METHOD(N64::Ior) {
 
   N64 *b = ObjectWrap::Unwrap<N64>(info[0].As<v8::Object>());
 
-  if (a->sign)
-    a->n = (int64_t)a->n | (int64_t)b->n;
-  else
-    a->n |= b->n;
+  *a->n |= *b->n;
 
   info.GetReturnValue().Set(info.Holder());
 }
 
-NAN_METHOD(N64::Iorn) {
+template <int S>
+NAN_METHOD(Int64<S>::Iorn) {
   N64 *a = ObjectWrap::Unwrap<N64>(info.Holder());
 
   if (info.Length() < 1)
@@ -523,10 +622,7 @@ NAN_METHOD(N64::Iorn) {
 
   uint32_t num = Nan::To<uint32_t>(info[0]).FromJust();
 
-  if (a->sign)
-    a->n = (int64_t)a->n | (int64_t)((int32_t)num);
-  else
-    a->n |= num;
+  *a->n |= extend<S>(num);
 
   info.GetReturnValue().Set(info.Holder());
 }
@@ -542,15 +638,13 @@ NAN_METHOD(N64::Ixor) {
 
   N64 *b = ObjectWrap::Unwrap<N64>(info[0].As<v8::Object>());
 
-  if (a->sign)
-    a->n = (int64_t)a->n ^ (int64_t)b->n;
-  else
-    a->n ^= b->n;
+  *a->n ^= *b->n;
 
   info.GetReturnValue().Set(info.Holder());
 }
 
-NAN_METHOD(N64::Ixorn) {
+template <int S>
+NAN_METHOD(Int64<S>::Ixorn) {
   N64 *a = ObjectWrap::Unwrap<N64>(info.Holder());
 
   if (info.Length() < 1)
@@ -561,10 +655,7 @@ NAN_METHOD(N64::Ixorn) {
 
   uint32_t num = Nan::To<uint32_t>(info[0]).FromJust();
 
-  if (a->sign)
-    a->n = (int64_t)a->n ^ (int64_t)((int32_t)num);
-  else
-    a->n ^= num;
+  *a->n ^= extend<S>(num);
 
   info.GetReturnValue().Set(info.Holder());
 }
@@ -572,7 +663,7 @@ NAN_METHOD(N64::Ixorn) {
 NAN_METHOD(N64::Inot) {
   N64 *a = ObjectWrap::Unwrap<N64>(info.Holder());
 
-  a->n = ~a->n;
+  *a->n = ~*a->n;
 
   info.GetReturnValue().Set(info.Holder());
 }
@@ -588,15 +679,13 @@ NAN_METHOD(N64::Ishln) {
 
   uint32_t bits = Nan::To<uint32_t>(info[0]).FromJust() & 63;
 
-  if (a->sign)
-    a->n = (int64_t)a->n << bits;
-  else
-    a->n <<= bits;
+  *a->n <<= bits;
 
   info.GetReturnValue().Set(info.Holder());
 }
 
-NAN_METHOD(N64::Ishrn) {
+template <int S>
+NAN_METHOD(Int64<S>::Ishrn) {
   N64 *a = ObjectWrap::Unwrap<N64>(info.Holder());
 
   if (info.Length() < 1)
@@ -607,10 +696,7 @@ NAN_METHOD(N64::Ishrn) {
 
   uint32_t bits = Nan::To<uint32_t>(info[0]).FromJust() & 63;
 
-  if (a->sign)
-    a->n = (int64_t)a->n >> bits;
-  else
-    a->n >>= bits;
+  *a->n = shr<S>(*a->n, bits);
 
   info.GetReturnValue().Set(info.Holder());
 }
@@ -626,7 +712,7 @@ NAN_METHOD(N64::Iushrn) {
 
   uint32_t bits = Nan::To<uint32_t>(info[0]).FromJust() & 63;
 
-  a->n >>= bits;
+  *a->n >>= bits;
 
   info.GetReturnValue().Set(info.Holder());
 }
@@ -647,9 +733,9 @@ NAN_METHOD(N64::Setn) {
   bool val = Nan::To<bool>(info[1]).FromJust();
 
   if (val)
-    a->n |= (1ull << bit);
+    *a->n |= (1ull << bit);
   else
-    a->n &= ~(1ull << bit);
+    *a->n &= ~(1ull << bit);
 
   info.GetReturnValue().Set(info.Holder());
 }
@@ -666,7 +752,7 @@ NAN_METHOD(N64::Testn) {
   uint32_t bit = Nan::To<uint32_t>(info[0]).FromJust() & 63;
   int32_t r = 0;
 
-  if ((a->n & (1ull << bit)) != 0)
+  if ((*a->n & (1ull << bit)) != 0)
     r = 1;
 
   info.GetReturnValue().Set(Nan::New<v8::Int32>(r));
@@ -687,8 +773,8 @@ NAN_METHOD(N64::Setb) {
   uint32_t pos = Nan::To<uint32_t>(info[0]).FromJust() & 7;
   uint64_t ch = Nan::To<int64_t>(info[1]).FromJust() & 0xff;
 
-  a->n &= ~(0xffull << (pos * 8));
-  a->n |= ch << (pos * 8);
+  *a->n &= ~(0xffull << (pos * 8));
+  *a->n |= ch << (pos * 8);
 
   info.GetReturnValue().Set(info.Holder());
 }
@@ -708,7 +794,7 @@ NAN_METHOD(N64::Orb) {
   uint32_t pos = Nan::To<uint32_t>(info[0]).FromJust() & 7;
   uint64_t ch = Nan::To<int64_t>(info[1]).FromJust() & 0xff;
 
-  a->n |= ch << (pos * 8);
+  *a->n |= ch << (pos * 8);
 
   info.GetReturnValue().Set(info.Holder());
 }
@@ -723,7 +809,7 @@ NAN_METHOD(N64::Getb) {
     return Nan::ThrowTypeError(TYPE_ERROR(pos, number));
 
   uint32_t pos = Nan::To<uint32_t>(info[0]).FromJust() & 7;
-  int32_t ch = (a->n >> (pos * 8)) & 0xff;
+  int32_t ch = (*a->n >> (pos * 8)) & 0xff;
 
   info.GetReturnValue().Set(Nan::New<v8::Int32>(ch));
 }
@@ -739,7 +825,7 @@ NAN_METHOD(N64::Imaskn) {
 
   uint32_t bit = Nan::To<uint32_t>(info[0]).FromJust() & 63;
 
-  a->n &= (1ull << bit) - 1;
+  *a->n &= (1ull << bit) - 1;
 
   info.GetReturnValue().Set(info.Holder());
 }
@@ -754,7 +840,7 @@ NAN_METHOD(N64::Andln) {
     return Nan::ThrowTypeError(TYPE_ERROR(operand, number));
 
   uint32_t num = Nan::To<uint32_t>(info[0]).FromJust();
-  uint32_t r = (uint32_t)a->n & num;
+  uint32_t r = (uint32_t)*a->n & num;
 
   info.GetReturnValue().Set(Nan::New<v8::Int32>(r));
 }
@@ -762,12 +848,13 @@ NAN_METHOD(N64::Andln) {
 NAN_METHOD(N64::Ineg) {
   N64 *a = ObjectWrap::Unwrap<N64>(info.Holder());
 
-  a->n = ~a->n + 1;
+  *a->n = ~*a->n + 1;
 
   info.GetReturnValue().Set(info.Holder());
 }
 
-NAN_METHOD(N64::Cmp) {
+template <int S>
+NAN_METHOD(Int64<S>::Cmp) {
   N64 *a = ObjectWrap::Unwrap<N64>(info.Holder());
 
   if (info.Length() < 1)
@@ -777,24 +864,13 @@ NAN_METHOD(N64::Cmp) {
     return Nan::ThrowTypeError(TYPE_ERROR(value, int64));
 
   N64 *b = ObjectWrap::Unwrap<N64>(info[0].As<v8::Object>());
-  int32_t r = 0;
-
-  if (a->sign) {
-    if ((int64_t)a->n < (int64_t)b->n)
-      r = -1;
-    else if ((int64_t)a->n > (int64_t)b->n)
-      r = 1;
-  } else {
-    if (a->n < b->n)
-      r = -1;
-    else if (a->n > b->n)
-      r = 1;
-  }
+  int32_t r = n64_cmp(*a->n, *b->n, S);
 
   info.GetReturnValue().Set(Nan::New<v8::Int32>(r));
 }
 
-NAN_METHOD(N64::Cmpn) {
+template <int S>
+NAN_METHOD(Int64<S>::Cmpn) {
   N64 *a = ObjectWrap::Unwrap<N64>(info.Holder());
 
   if (info.Length() < 1)
@@ -804,19 +880,7 @@ NAN_METHOD(N64::Cmpn) {
     return Nan::ThrowTypeError(TYPE_ERROR(value, number));
 
   uint32_t num = Nan::To<uint32_t>(info[0]).FromJust();
-  int32_t r = 0;
-
-  if (a->sign) {
-    if ((int64_t)a->n < (int64_t)((int32_t)num))
-      r = -1;
-    else if ((int64_t)a->n > (int64_t)((int32_t)num))
-      r = 1;
-  } else {
-    if (a->n < (uint64_t)num)
-      r = -1;
-    else if (a->n > (uint64_t)num)
-      r = 1;
-  }
+  int32_t r = n64_cmp(*a->n, extend<S>(num), S);
 
   info.GetReturnValue().Set(Nan::New<v8::Int32>(r));
 }
@@ -833,13 +897,14 @@ NAN_METHOD(N64::Eq) {
   N64 *b = ObjectWrap::Unwrap<N64>(info[0].As<v8::Object>());
   bool r = false;
 
-  if (a->n == b->n)
+  if (*a->n == *b->n)
     r = true;
 
   info.GetReturnValue().Set(Nan::New<v8::Boolean>(r));
 }
 
-NAN_METHOD(N64::Eqn) {
+template <int S>
+NAN_METHOD(Int64<S>::Eqn) {
   N64 *a = ObjectWrap::Unwrap<N64>(info.Holder());
 
   if (info.Length() < 1)
@@ -851,13 +916,8 @@ NAN_METHOD(N64::Eqn) {
   uint32_t num = Nan::To<uint32_t>(info[0]).FromJust();
   bool r = false;
 
-  if (a->sign) {
-    if ((int64_t)a->n == (int64_t)((int32_t)num))
-      r = true;
-  } else {
-    if (a->n == (uint64_t)num)
-      r = true;
-  }
+  if (*a->n == extend<S>(num))
+    r = true;
 
   info.GetReturnValue().Set(Nan::New<v8::Boolean>(r));
 }
@@ -866,17 +926,18 @@ NAN_METHOD(N64::IsZero) {
   N64 *a = ObjectWrap::Unwrap<N64>(info.Holder());
   bool r = false;
 
-  if (a->n == 0)
+  if (*a->n == 0)
     r = true;
 
   info.GetReturnValue().Set(Nan::New<v8::Boolean>(r));
 }
 
-NAN_METHOD(N64::IsNeg) {
+template <int S>
+NAN_METHOD(Int64<S>::IsNeg) {
   N64 *a = ObjectWrap::Unwrap<N64>(info.Holder());
   bool r = false;
 
-  if (a->sign && (int64_t)a->n < 0)
+  if (S && (int64_t)*a->n < 0)
     r = true;
 
   info.GetReturnValue().Set(Nan::New<v8::Boolean>(r));
@@ -886,7 +947,7 @@ NAN_METHOD(N64::IsOdd) {
   N64 *a = ObjectWrap::Unwrap<N64>(info.Holder());
   bool r = false;
 
-  if ((a->n & 1) == 1)
+  if ((*a->n & 1) == 1)
     r = true;
 
   info.GetReturnValue().Set(Nan::New<v8::Boolean>(r));
@@ -896,7 +957,7 @@ NAN_METHOD(N64::IsEven) {
   N64 *a = ObjectWrap::Unwrap<N64>(info.Holder());
   bool r = false;
 
-  if ((a->n & 1) == 0)
+  if ((*a->n & 1) == 0)
     r = true;
 
   info.GetReturnValue().Set(Nan::New<v8::Boolean>(r));
@@ -913,7 +974,7 @@ NAN_METHOD(N64::Inject) {
 
   N64 *b = ObjectWrap::Unwrap<N64>(info[0].As<v8::Object>());
 
-  a->n = b->n;
+  *a->n = *b->n;
 }
 
 NAN_METHOD(N64::Set) {
@@ -930,10 +991,10 @@ NAN_METHOD(N64::Set) {
   if (Nan::To<double>(info[0]).FromJust() != (double)n)
     return Nan::ThrowTypeError(TYPE_ERROR(number, integer));
 
-  if (n < -MAX_SAFE_INTEGER || n > MAX_SAFE_INTEGER)
-    return Nan::ThrowError("Number exceeds 53 bits.");
+  if (n < -N64_MAX_SAFE_INTEGER || n > N64_MAX_SAFE_INTEGER)
+    return stats_throw(THROW_OVERFLOW, "Number exceeds 53 bits.");
 
-  a->n = (uint64_t)n;
+  *a->n = (uint64_t)n;
 
   info.GetReturnValue().Set(info.Holder());
 }
@@ -953,83 +1014,51 @@ NAN_METHOD(N64::Join) {
   uint32_t hi = Nan::To<uint32_t>(info[0]).FromJust();
   uint32_t lo = Nan::To<uint32_t>(info[1]).FromJust();
 
-  a->n = ((uint64_t)hi << 32) | lo;
+  *a->n = ((uint64_t)hi << 32) | lo;
 
   info.GetReturnValue().Set(info.Holder());
 }
 
-NAN_METHOD(N64::BitLength) {
+template <int S>
+NAN_METHOD(Int64<S>::BitLength) {
   N64 *a = ObjectWrap::Unwrap<N64>(info.Holder());
-  int32_t bit;
-  uint64_t n = a->n;
-
-  if (a->sign && (int64_t)a->n < 0)
-    n = ~n + 1;
-
-  for (bit = 63; bit >= 0; bit--) {
-    if ((n & (1ull << bit)) != 0)
-      break;
-  }
+  int32_t r = n64_bitlen(*a->n, S);
 
-  info.GetReturnValue().Set(Nan::New<v8::Int32>(bit + 1));
+  info.GetReturnValue().Set(Nan::New<v8::Int32>(r));
 }
 
-NAN_METHOD(N64::IsSafe) {
+template <int S>
+NAN_METHOD(Int64<S>::IsSafe) {
   N64 *a = ObjectWrap::Unwrap<N64>(info.Holder());
-  bool r = true;
-
-  if (a->sign) {
-    if ((int64_t)a->n > MAX_SAFE_INTEGER
-        || (int64_t)a->n < -MAX_SAFE_INTEGER) {
-      r = false;
-    }
-  } else {
-    if (a->n > (uint64_t)MAX_SAFE_INTEGER)
-      r = false;
-  }
+  bool r = n64_is_safe(*a->n, S) != 0;
 
   info.GetReturnValue().Set(Nan::New<v8::Boolean>(r));
 }
 
-NAN_METHOD(N64::ToNumber) {
+template <int S>
+NAN_METHOD(Int64<S>::ToNumber) {
   N64 *a = ObjectWrap::Unwrap<N64>(info.Holder());
-  double r = 0;
 
-  if (a->sign) {
-    if ((int64_t)a->n > MAX_SAFE_INTEGER
-        || (int64_t)a->n < -MAX_SAFE_INTEGER) {
-      return Nan::ThrowError("Number exceeds 53 bits.");
-    }
-    r = (double)((int64_t)a->n);
-  } else {
-    if (a->n > (uint64_t)MAX_SAFE_INTEGER)
-      return Nan::ThrowError("Number exceeds 53 bits.");
-    r = (double)a->n;
-  }
+  if (!n64_is_safe(*a->n, S))
+    return stats_throw(THROW_OVERFLOW, "Number exceeds 53 bits.");
+
+  double r = S ? (double)((int64_t)*a->n) : (double)*a->n;
 
   info.GetReturnValue().Set(Nan::New<v8::Number>(r));
 }
 
-NAN_METHOD(N64::ToDouble) {
+template <int S>
+NAN_METHOD(Int64<S>::ToDouble) {
   N64 *a = ObjectWrap::Unwrap<N64>(info.Holder());
-  double r = 0;
-
-  if (a->sign)
-    r = (double)((int64_t)a->n);
-  else
-    r = (double)a->n;
+  double r = S ? (double)((int64_t)*a->n) : (double)*a->n;
 
   info.GetReturnValue().Set(Nan::New<v8::Number>(r));
 }
 
-NAN_METHOD(N64::ToInt) {
+template <int S>
+NAN_METHOD(Int64<S>::ToInt) {
   N64 *a = ObjectWrap::Unwrap<N64>(info.Holder());
-  double r = 0;
-
-  if (a->sign)
-    r = (double)((int32_t)a->n);
-  else
-    r = (double)((uint32_t)a->n);
+  double r = S ? (double)((int32_t)*a->n) : (double)((uint32_t)*a->n);
 
   info.GetReturnValue().Set(Nan::New<v8::Number>(r));
 }
@@ -1038,129 +1067,105 @@ NAN_METHOD(N64::ToBool) {
   N64 *a = ObjectWrap::Unwrap<N64>(info.Holder());
   bool r = false;
 
-  if (a->n != 0)
+  if (*a->n != 0)
     r = true;
 
   info.GetReturnValue().Set(Nan::New<v8::Boolean>(r));
 }
 
-NAN_METHOD(N64::ToString) {
-  N64 *a = ObjectWrap::Unwrap<N64>(info.Holder());
+// Throws and returns false on failure.
+static bool
+read_pad(v8::Local<v8::Value> val, uint32_t *pad) {
+  *pad = 0;
 
-  uint32_t base = 10;
+  if (IsNull(val))
+    return true;
 
-  if (info.Length() > 0 && !IsNull(info[0])) {
-    if (info[0]->IsString()) {
-      Nan::Utf8String name(info[0]);
-      base = get_base(*name);
-    } else {
-      if (!info[0]->IsNumber())
-        return Nan::ThrowTypeError(TYPE_ERROR(base, integer));
+  if (!val->IsNumber()) {
+    Nan::ThrowTypeError(TYPE_ERROR(pad, integer));
+    return false;
+  }
 
-      base = Nan::To<uint32_t>(info[0]).FromJust();
+  *pad = Nan::To<uint32_t>(val).FromJust();
 
-      if (Nan::To<double>(info[0]).FromJust() != (double)base)
-        return Nan::ThrowTypeError(TYPE_ERROR(base, integer));
-    }
+  if (Nan::To<double>(val).FromJust() != (double)*pad) {
+    Nan::ThrowTypeError(TYPE_ERROR(pad, integer));
+    return false;
   }
 
+  if (*pad > 64) {
+    Nan::ThrowError("Maximum padding is 64 characters.");
+    return false;
+  }
+
+  return true;
+}
+
+template <int S>
+NAN_METHOD(Int64<S>::ToString) {
+  N64 *a = ObjectWrap::Unwrap<N64>(info.Holder());
+
+  uint32_t base = 10;
+
+  if (info.Length() > 0 && !read_base(info[0], &base))
+    return Nan::ThrowTypeError(TYPE_ERROR(base, integer));
+
   uint32_t pad = 0;
 
-  if (info.Length() > 1 && !IsNull(info[1])) {
-    if (!info[1]->IsNumber())
-      return Nan::ThrowTypeError(TYPE_ERROR(pad, integer));
+  if (info.Length() > 1 && !read_pad(info[1], &pad))
+    return;
 
-    pad = Nan::To<uint32_t>(info[1]).FromJust();
+  char str[N64_STR_SIZE];
+  size_t size = n64_write(str, *a->n, S, base, pad);
 
-    if (Nan::To<double>(info[1]).FromJust() != (double)pad)
-      return Nan::ThrowTypeError(TYPE_ERROR(pad, integer));
+  if (size == 0)
+    return Nan::ThrowError("Base ranges between 2 and 16.");
 
-    if (pad > 64)
-      return Nan::ThrowError("Maximum padding is 64 characters.");
-  }
+  info.GetReturnValue().Set(
+    Nan::New<v8::String>(str, size).ToLocalChecked());
+}
 
-  uint64_t n = a->n;
-  bool neg = false;
+// Formats straight into a buffer, so that
+// no string is made. Returns the new offset.
+template <int S>
+NAN_METHOD(Int64<S>::WriteString) {
+  N64 *a = ObjectWrap::Unwrap<N64>(info.Holder());
 
-  if (a->sign && (int64_t)a->n < 0) {
-    neg = true;
-    n = ~n + 1;
-  }
+  if (info.Length() < 4)
+    return Nan::ThrowError(ARG_ERROR(writeString, 4));
 
-  char buf[66];
-  char *str = (char *)buf + 1;
-  size_t size = 64;
-
-  if (base == 2) {
-    int32_t bit;
-    int32_t i = 0;
-    int32_t s = -1;
-
-    for (bit = 63; bit >= 0; bit--) {
-      if ((n & (1ull << bit)) != 0) {
-        if (s == -1)
-          s = i;
-        str[i++] = '1';
-      } else {
-        str[i++] = '0';
-      }
-    }
-
-    str[i] = '\0';
-
-    if (s == -1)
-      s = 63;
-
-    str += s;
-    size -= s;
-
-    if (size < pad) {
-      str -= pad - size;
-      size = pad;
-    }
-  } else {
-    char *fmt = NULL;
-
-    switch (base) {
-      case 8:
-        fmt = "%" PRIo64;
-        break;
-      case 10:
-        fmt = "%" PRIu64;
-        break;
-      case 16:
-        fmt = "%" PRIx64;
-        break;
-      default:
-        return Nan::ThrowError("Base ranges between 2 and 16.");
-    }
-
-    size = snprintf(NULL, 0, (const char *)fmt, n);
-
-    assert(size > 0 && size < 23);
-
-    size_t fill = 0;
-
-    if (size < pad) {
-      fill = pad - size;
-      memset(str, '0', fill);
-    }
-
-    snprintf(str + fill, size + 1, (const char *)fmt, n);
-
-    if (size < pad)
-      size = pad;
-  }
+  if (!info[0]->IsUint8Array())
+    return Nan::ThrowTypeError(TYPE_ERROR(data, buffer));
 
-  assert(size > 0);
+  if (!info[1]->IsUint32())
+    return Nan::ThrowTypeError(TYPE_ERROR(offset, integer));
 
-  if (neg) {
-    *(--str) = '-';
-    size++;
-  }
+  uint32_t base = 10;
 
-  info.GetReturnValue().Set(
-    Nan::New<v8::String>((char *)str, size).ToLocalChecked());
+  if (!read_base(info[2], &base))
+    return Nan::ThrowTypeError(TYPE_ERROR(base, integer));
+
+  uint32_t pad = 0;
+
+  if (!read_pad(info[3], &pad))
+    return;
+
+  char str[N64_STR_SIZE];
+  size_t size = n64_write(str, *a->n, S, base, pad);
+
+  if (size == 0)
+    return Nan::ThrowError("Base ranges between 2 and 16.");
+
+  size_t len = 0;
+  uint8_t *data = get_buffer(info[0], &len);
+  uint32_t off = info[1].As<v8::Uint32>()->Value();
+
+  if ((size_t)off + size > len)
+    return Nan::ThrowError("Invalid offset.");
+
+  memcpy(data + off, str, size);
+
+  info.GetReturnValue().Set(Nan::New<v8::Uint32>((uint32_t)(off + size)));
 }
 
 NAN_METHOD(N64::FromNumber) {
@@ -1177,15 +1182,16 @@ NAN_METHOD(N64::FromNumber) {
   if (Nan::To<double>(info[0]).FromJust() != (double)n)
     return Nan::ThrowTypeError(TYPE_ERROR(number, integer));
 
-  if (n < -MAX_SAFE_INTEGER || n > MAX_SAFE_INTEGER)
-    return Nan::ThrowError("Number exceeds 53 bits.");
+  if (n < -N64_MAX_SAFE_INTEGER || n > N64_MAX_SAFE_INTEGER)
+    return stats_throw(THROW_OVERFLOW, "Number exceeds 53 bits.");
 
-  a->n = (uint64_t)n;
+  *a->n = (uint64_t)n;
 
   info.GetReturnValue().Set(info.Holder());
 }
 
-NAN_METHOD(N64::FromInt) {
+template <int S>
+NAN_METHOD(Int64<S>::FromInt) {
   N64 *a = ObjectWrap::Unwrap<N64>(info.Holder());
 
   if (info.Length() < 1)
@@ -1196,10 +1202,7 @@ NAN_METHOD(N64::FromInt) {
 
   uint32_t num = Nan::To<uint32_t>(info[0]).FromJust();
 
-  if (a->sign)
-    a->n = (uint64_t)((int64_t)((int32_t)num));
-  else
-    a->n = (uint64_t)num;
+  *a->n = extend<S>(num);
 
   info.GetReturnValue().Set(info.Holder());
 }
@@ -1213,7 +1216,7 @@ NAN_METHOD(N64::FromBool) {
   if (!info[0]->IsBoolean())
     return Nan::ThrowTypeError(TYPE_ERROR(value, boolean));
 
-  a->n = (uint64_t)Nan::To<bool>(info[0]).FromJust();
+  *a->n = (uint64_t)Nan::To<bool>(info[0]).FromJust();
 
   info.GetReturnValue().Set(info.Holder());
 }
@@ -1233,12 +1236,13 @@ NAN_METHOD(N64::FromBits) {
   uint32_t hi = Nan::To<uint32_t>(info[0]).FromJust();
   uint32_t lo = Nan::To<uint32_t>(info[1]).FromJust();
 
-  a->n = ((uint64_t)hi << 32) | lo;
+  *a->n = ((uint64_t)hi << 32) | lo;
 
   info.GetReturnValue().Set(info.Holder());
 }
 
-NAN_METHOD(N64::FromString) {
+template <int S>
+NAN_METHOD(Int64<S>::FromString) {
   N64 *a = ObjectWrap::Unwrap<N64>(info.Holder());
 
   if (info.Length() < 1)
@@ -1247,69 +1251,339 @@ NAN_METHOD(N64::FromString) {
   if (!info[0]->IsString())
     return Nan::ThrowTypeError(TYPE_ERROR(string, string));
 
-  Nan::Utf8String nstr(info[0]);
+  uint32_t base = 10;
 
-  char *start = *nstr;
-  size_t len = nstr.length();
+  if (info.Length() > 1 && !read_base(info[1], &base))
+    return Nan::ThrowTypeError(TYPE_ERROR(base, integer));
 
-  bool neg = false;
+  uint64_t n = 0;
 
-  if (*start == '-') {
-    neg = true;
-    start++;
-    len--;
+  switch (read_string(info[0], base, &n)) {
+    case N64_ERR_LENGTH:
+      return stats_throw(THROW_PARSE, "Invalid string (bad length).");
+    case N64_ERR_BASE:
+      return Nan::ThrowError("Base ranges between 2 and 16.");
+    case N64_ERR_OVERFLOW:
+      return stats_throw(THROW_OVERFLOW, "Invalid string (overflow).");
+    case N64_ERR_PARSE:
+      return stats_throw(THROW_PARSE, "Invalid string (parse error).");
+    case N64_ERR_DIGITS:
+      return stats_throw(THROW_PARSE, "Invalid string (no digits).");
   }
 
-  if (len == 0 || len > 64)
-    return Nan::ThrowError("Invalid string (bad length).");
+  *a->n = n;
+
+  info.GetReturnValue().Set(info.Holder());
+}
+
+NAN_METHOD(N64::TryFromNumber) {
+  N64 *a = ObjectWrap::Unwrap<N64>(info.Holder());
+
+  if (info.Length() < 1)
+    return Nan::ThrowError(ARG_ERROR(tryFromNumber, 1));
+
+  uint64_t n = 0;
+  bool ok = read_number(info[0], &n);
+
+  if (ok)
+    *a->n = n;
+
+  info.GetReturnValue().Set(Nan::New<v8::Boolean>(ok));
+}
+
+template <int S>
+NAN_METHOD(Int64<S>::TryIdiv) {
+  N64 *a = ObjectWrap::Unwrap<N64>(info.Holder());
+
+  if (info.Length() < 1)
+    return Nan::ThrowError(ARG_ERROR(tryIdiv, 1));
+
+  if (!N64::HasInstance(info[0]))
+    return Nan::ThrowTypeError(TYPE_ERROR(divisor, int64));
+
+  N64 *b = ObjectWrap::Unwrap<N64>(info[0].As<v8::Object>());
+  bool ok = *b->n != 0;
+
+  if (ok)
+    *a->n = n64_div(*a->n, *b->n, S);
+
+  info.GetReturnValue().Set(Nan::New<v8::Boolean>(ok));
+}
+
+template <int S>
+NAN_METHOD(Int64<S>::TryImod) {
+  N64 *a = ObjectWrap::Unwrap<N64>(info.Holder());
+
+  if (info.Length() < 1)
+    return Nan::ThrowError(ARG_ERROR(tryImod, 1));
+
+  if (!N64::HasInstance(info[0]))
+    return Nan::ThrowTypeError(TYPE_ERROR(divisor, int64));
+
+  N64 *b = ObjectWrap::Unwrap<N64>(info[0].As<v8::Object>());
+  bool ok = *b->n != 0;
+
+  if (ok)
+    *a->n = n64_mod(*a->n, *b->n, S);
+
+  info.GetReturnValue().Set(Nan::New<v8::Boolean>(ok));
+}
+
+template <int S>
+NAN_METHOD(Int64<S>::TryToNumber) {
+  N64 *a = ObjectWrap::Unwrap<N64>(info.Holder());
+  double r = NAN;
+
+  // NaN is never a valid result, so it marks failure
+  // without making the return type polymorphic.
+  if (n64_is_safe(*a->n, S))
+    r = S ? (double)((int64_t)*a->n) : (double)*a->n;
+
+  info.GetReturnValue().Set(Nan::New<v8::Number>(r));
+}
+
+template <int S>
+NAN_METHOD(Int64<S>::TryFromString) {
+  N64 *a = ObjectWrap::Unwrap<N64>(info.Holder());
+
+  if (info.Length() < 1)
+    return Nan::ThrowError(ARG_ERROR(tryFromString, 1));
 
   uint32_t base = 10;
 
-  if (info.Length() > 1 && !IsNull(info[1])) {
-    if (info[1]->IsString()) {
-      Nan::Utf8String name(info[1]);
-      base = get_base(*name);
-    } else {
-      if (!info[1]->IsNumber())
-        return Nan::ThrowTypeError(TYPE_ERROR(base, integer));
+  if (info.Length() > 1 && !read_base(info[1], &base))
+    return Nan::ThrowTypeError(TYPE_ERROR(base, integer));
 
-      base = Nan::To<uint32_t>(info[1]).FromJust();
+  uint64_t n = 0;
+  int r = read_string(info[0], base, &n);
 
-      if (Nan::To<double>(info[1]).FromJust() != (double)base)
-        return Nan::ThrowTypeError(TYPE_ERROR(base, integer));
-    }
+  // A bad base is a bug in the caller, not bad input.
+  if (r == N64_ERR_BASE)
+    return Nan::ThrowError("Base ranges between 2 and 16.");
+
+  if (r == N64_OK)
+    *a->n = n;
+
+  info.GetReturnValue().Set(Nan::New<v8::Boolean>(r == N64_OK));
+}
+
+/*
+ * Integer math
+ */
+
+template <int S>
+NAN_METHOD(Int64<S>::Isqrt) {
+  N64 *a = ObjectWrap::Unwrap<N64>(info.Holder());
+
+  if (!n64_sqrt(a->n, *a->n, S))
+    return Nan::ThrowError("Square root of negative number.");
+
+  info.GetReturnValue().Set(info.Holder());
+}
+
+template <int S>
+NAN_METHOD(Int64<S>::Icbrt) {
+  N64 *a = ObjectWrap::Unwrap<N64>(info.Holder());
+
+  n64_cbrt(a->n, *a->n, S);
+
+  info.GetReturnValue().Set(info.Holder());
+}
+
+template <int S>
+NAN_METHOD(Int64<S>::Log2) {
+  N64 *a = ObjectWrap::Unwrap<N64>(info.Holder());
+  int r = 0;
+
+  if (!n64_log2(&r, *a->n, S))
+    return Nan::ThrowError("Logarithm of non-positive number.");
+
+  info.GetReturnValue().Set(Nan::New<v8::Int32>(r));
+}
+
+template <int S>
+NAN_METHOD(Int64<S>::Log10) {
+  N64 *a = ObjectWrap::Unwrap<N64>(info.Holder());
+  int r = 0;
+
+  if (!n64_log10(&r, *a->n, S))
+    return Nan::ThrowError("Logarithm of non-positive number.");
+
+  info.GetReturnValue().Set(Nan::New<v8::Int32>(r));
+}
+
+template <int S>
+NAN_METHOD(Int64<S>::Igcd) {
+  N64 *a = ObjectWrap::Unwrap<N64>(info.Holder());
+
+  if (info.Length() < 1)
+    return Nan::ThrowError(ARG_ERROR(igcd, 1));
+
+  if (!N64::HasInstance(info[0]))
+    return Nan::ThrowTypeError(TYPE_ERROR(operand, int64));
+
+  N64 *b = ObjectWrap::Unwrap<N64>(info[0].As<v8::Object>());
+
+  if (!n64_gcd(a->n, *a->n, *b->n, S))
+    return stats_throw(THROW_OVERFLOW, "Number out of range.");
+
+  info.GetReturnValue().Set(info.Holder());
+}
+
+template <int S>
+NAN_METHOD(Int64<S>::Ilcm) {
+  N64 *a = ObjectWrap::Unwrap<N64>(info.Holder());
+
+  if (info.Length() < 1)
+    return Nan::ThrowError(ARG_ERROR(ilcm, 1));
+
+  if (!N64::HasInstance(info[0]))
+    return Nan::ThrowTypeError(TYPE_ERROR(operand, int64));
+
+  N64 *b = ObjectWrap::Unwrap<N64>(info[0].As<v8::Object>());
+
+  if (!n64_lcm(a->n, *a->n, *b->n, S))
+    return stats_throw(THROW_OVERFLOW, "Number out of range.");
+
+  info.GetReturnValue().Set(info.Holder());
+}
+
+template <int S>
+NAN_METHOD(Int64<S>::IsPowerOfTwo) {
+  N64 *a = ObjectWrap::Unwrap<N64>(info.Holder());
+  bool r = n64_is_pow2(*a->n, S) != 0;
+  info.GetReturnValue().Set(Nan::New<v8::Boolean>(r));
+}
+
+template <int S>
+NAN_METHOD(Int64<S>::InextPowerOfTwo) {
+  N64 *a = ObjectWrap::Unwrap<N64>(info.Holder());
+
+  if (!n64_next_pow2(a->n, *a->n, S))
+    return stats_throw(THROW_OVERFLOW, "Number out of range.");
+
+  info.GetReturnValue().Set(info.Holder());
+}
+
+// Leaves the quotient in the receiver and
+// writes the remainder to the second argument.
+template <int S>
+NAN_METHOD(Int64<S>::Idivmod) {
+  N64 *a = ObjectWrap::Unwrap<N64>(info.Holder());
+
+  if (info.Length() < 2)
+    return Nan::ThrowError(ARG_ERROR(idivmod, 2));
+
+  if (!N64::HasInstance(info[0]))
+    return Nan::ThrowTypeError(TYPE_ERROR(divisor, int64));
+
+  if (!N64::HasInstance(info[1]))
+    return Nan::ThrowTypeError(TYPE_ERROR(remainder, int64));
+
+  N64 *b = ObjectWrap::Unwrap<N64>(info[0].As<v8::Object>());
+  N64 *r = ObjectWrap::Unwrap<N64>(info[1].As<v8::Object>());
+  uint64_t x = *a->n;
+  uint64_t y = *b->n;
+
+  if (y == 0)
+    return stats_throw(THROW_DIVZERO, "Cannot divide by zero.");
+
+  *a->n = n64_div(x, y, S);
+  *r->n = n64_mod(x, y, S);
+
+  info.GetReturnValue().Set(info.Holder());
+}
+
+/*
+ * Parsing
+ */
+
+bool
+read_base(v8::Local<v8::Value> val, uint32_t *base) {
+  if (IsNull(val)) {
+    *base = 10;
+    return true;
   }
 
-  switch (base) {
-    case 2:
-    case 8:
-    case 10:
-    case 16:
-      break;
-    default:
-      return Nan::ThrowError("Base ranges between 2 and 16.");
+  if (val->IsString()) {
+    Nan::Utf8String name(val);
+    *base = get_base(*name);
+    return true;
   }
 
-  errno = 0;
+  if (!val->IsNumber())
+    return false;
 
-  char *end = NULL;
-  uint64_t n = strtoull((const char *)start, &end, base);
+  double num = val.As<v8::Number>()->Value();
 
-  if (errno == ERANGE && n == ULLONG_MAX)
-    return Nan::ThrowError("Invalid string (overflow).");
+  if (!(num >= 0 && num <= 0xffffffff) || num != std::floor(num))
+    return false;
 
-  if (errno != 0 && n == 0)
-    return Nan::ThrowError("Invalid string (parse error).");
+  *base = (uint32_t)num;
 
-  if (end == start)
-    return Nan::ThrowError("Invalid string (no digits).");
+  return true;
+}
 
-  a->n = n;
+bool
+read_number(v8::Local<v8::Value> val, uint64_t *r) {
+  if (val->IsInt32()) {
+    *r = (uint64_t)(int64_t)val.As<v8::Int32>()->Value();
+    return true;
+  }
 
-  if (neg)
-    a->n = ~n + 1;
+  if (!val->IsNumber())
+    return false;
 
-  info.GetReturnValue().Set(info.Holder());
+  double num = val.As<v8::Number>()->Value();
+
+  if (!(num >= -(double)N64_MAX_SAFE_INTEGER
+        && num <= (double)N64_MAX_SAFE_INTEGER)) {
+    return false;
+  }
+
+  if (num != std::floor(num))
+    return false;
+
+  *r = (uint64_t)(int64_t)num;
+
+  return true;
+}
+
+int
+read_string(v8::Local<v8::Value> val, uint32_t base, uint64_t *r) {
+  if (!val->IsString())
+    return N64_ERR_PARSE;
+
+  v8::Local<v8::String> str = val.As<v8::String>();
+  int len = str->Length();
+
+  // A sign and 64 binary digits at most. Let the
+  // parser pick the error for anything longer.
+  if (len > 65)
+    return n64_read(r, "", 0, base);
+
+  uint16_t wide[65];
+  uint8_t buf[65];
+
+#if NODE_MAJOR_VERSION >= 12
+  v8::Isolate *isolate = v8::Isolate::GetCurrent();
+
+  // Latin-1 bytes above ASCII fail to parse as they are.
+  if (str->IsOneByte()) {
+    str->WriteOneByte(isolate, buf, 0, len, v8::String::NO_NULL_TERMINATION);
+    return n64_read(r, (const char *)buf, (size_t)len, base);
+  }
+
+  str->Write(isolate, wide, 0, len, v8::String::NO_NULL_TERMINATION);
+#else
+  str->Write(wide, 0, len, v8::String::NO_NULL_TERMINATION);
+#endif
+
+  // Anything outside of ASCII is a parse error.
+  for (int i = 0; i < len; i++)
+    buf[i] = wide[i] < 0x80 ? (uint8_t)wide[i] : 0x7f;
+
+  return n64_read(r, (const char *)buf, (size_t)len, base);
 }
 
 NAN_INLINE static bool IsNull(v8::Local<v8::Value> obj) {
@@ -1333,8 +1607,22 @@ static uint32_t get_base(const char *name) {
   return 0;
 }
 
+template class Int64<0>;
+template class Int64<1>;
+
 NAN_MODULE_INIT(init) {
+  env_init();
+  stats_init(target);
   N64::Init(target);
+  N128::Init(target);
+  RNG::Init(target);
+  Histogram::Init(target);
+  Struct::Init(target);
+  JSONParser::Init(target);
+  Dec64::Init(target);
+  N64Array::Init(target);
+  atomic_init(target);
+  bulk_init(target);
 }
 
 #if NODE_MAJOR_VERSION >= 10
@@ -9,46 +9,48 @@
 #include <node.h>
 #include <nan.h>
 #include <inttypes.h>
+#include <memory>
 
 class N64 : public Nan::ObjectWrap {
 public:
   static void Init(v8::Local<v8::Object> &target);
   static bool HasInstance(v8::Local<v8::Value> val);
-  static NAN_METHOD(New);
 
   N64();
   ~N64();
 
-  uint64_t n;
-  uint8_t sign;
+  // Points at `slot`, or into a buffer for views.
+  uint64_t *n;
+  uint64_t slot;
+
+  // View state. The backing store is held rather
+  // than the buffer object, so that a detach of the
+  // buffer cannot free the memory under us.
+  uint8_t *base;
+  size_t len;
+#if NODE_MAJOR_VERSION >= 14
+  std::shared_ptr<v8::BackingStore> store;
+#else
+  Nan::Persistent<v8::Object> store;
+#endif
 
 private:
+  static NAN_METHOD(Attach);
+  static NAN_METHOD(Seek);
+  static NAN_METHOD(Share);
   static NAN_METHOD(GetHi);
   static NAN_METHOD(SetHi);
   static NAN_METHOD(GetLo);
   static NAN_METHOD(SetLo);
-  static NAN_METHOD(GetSign);
-  static NAN_METHOD(SetSign);
   static NAN_METHOD(Iadd);
-  static NAN_METHOD(Iaddn);
   static NAN_METHOD(Isub);
-  static NAN_METHOD(Isubn);
   static NAN_METHOD(Imul);
-  static NAN_METHOD(Imuln);
-  static NAN_METHOD(Idiv);
-  static NAN_METHOD(Idivn);
-  static NAN_METHOD(Imod);
-  static NAN_METHOD(Imodn);
   static NAN_METHOD(Ipown);
   static NAN_METHOD(Iand);
-  static NAN_METHOD(Iandn);
   static NAN_METHOD(Ior);
-  static NAN_METHOD(Iorn);
   static NAN_METHOD(Ixor);
-  static NAN_METHOD(Ixorn);
   static NAN_METHOD(Inot);
   static NAN_METHOD(Ishln);
-  static NAN_METHOD(Ishrn);
   static NAN_METHOD(Iushrn);
   static NAN_METHOD(Setn);
   static NAN_METHOD(Testn);
@@ -58,29 +60,90 @@ private:
   static NAN_METHOD(Imaskn);
   static NAN_METHOD(Andln);
   static NAN_METHOD(Ineg);
-  static NAN_METHOD(Cmp);
-  static NAN_METHOD(Cmpn);
   static NAN_METHOD(Eq);
-  static NAN_METHOD(Eqn);
   static NAN_METHOD(IsZero);
-  static NAN_METHOD(IsNeg);
   static NAN_METHOD(IsOdd);
   static NAN_METHOD(IsEven);
   static NAN_METHOD(Inject);
   static NAN_METHOD(Set);
   static NAN_METHOD(Join);
+  static NAN_METHOD(ToBool);
+  static NAN_METHOD(FromNumber);
+  static NAN_METHOD(FromBool);
+  static NAN_METHOD(FromBits);
+  static NAN_METHOD(TryFromNumber);
+};
+
+/*
+ * Int64 - the U64 and I64 bindings. The sign is a
+ * template parameter so that the sign-dependent
+ * methods are written once but compiled without
+ * sign branches.
+ */
+
+template <int S>
+class Int64 : public N64 {
+public:
+  static void Init(v8::Local<v8::Object> &target,
+                   v8::Local<v8::FunctionTemplate> base);
+  static NAN_METHOD(New);
+
+private:
+  static NAN_METHOD(GetSign);
+  static NAN_METHOD(Iaddn);
+  static NAN_METHOD(Isubn);
+  static NAN_METHOD(Imuln);
+  static NAN_METHOD(Idiv);
+  static NAN_METHOD(Idivn);
+  static NAN_METHOD(Imod);
+  static NAN_METHOD(Imodn);
+  static NAN_METHOD(Iandn);
+  static NAN_METHOD(Iorn);
+  static NAN_METHOD(Ixorn);
+  static NAN_METHOD(Ishrn);
+  static NAN_METHOD(Cmp);
+  static NAN_METHOD(Cmpn);
+  static NAN_METHOD(Eqn);
+  static NAN_METHOD(IsNeg);
   static NAN_METHOD(BitLength);
   static NAN_METHOD(IsSafe);
   static NAN_METHOD(ToNumber);
   static NAN_METHOD(ToDouble);
   static NAN_METHOD(ToInt);
-  static NAN_METHOD(ToBool);
   static NAN_METHOD(ToString);
-  static NAN_METHOD(FromNumber);
+  static NAN_METHOD(WriteString);
   static NAN_METHOD(FromInt);
-  static NAN_METHOD(FromBool);
-  static NAN_METHOD(FromBits);
   static NAN_METHOD(FromString);
+  static NAN_METHOD(TryIdiv);
+  static NAN_METHOD(TryImod);
+  static NAN_METHOD(TryToNumber);
+  static NAN_METHOD(TryFromString);
+  static NAN_METHOD(Isqrt);
+  static NAN_METHOD(Icbrt);
+  static NAN_METHOD(Log2);
+  static NAN_METHOD(Log10);
+  static NAN_METHOD(Igcd);
+  static NAN_METHOD(Ilcm);
+  static NAN_METHOD(IsPowerOfTwo);
+  static NAN_METHOD(InextPowerOfTwo);
+  static NAN_METHOD(Idivmod);
 };
 
+typedef Int64<0> U64;
+typedef Int64<1> I64;
+
+/*
+ * Parsing - shared with the batch parsers. Neither
+ * function throws; both return false on bad input.
+ */
+
+bool
+read_base(v8::Local<v8::Value> val, uint32_t *base);
+
+bool
+read_number(v8::Local<v8::Value> val, uint64_t *r);
+
+int
+read_string(v8::Local<v8::Value> val, uint32_t base, uint64_t *r);
+
 #endif
@@ -0,0 +1,175 @@
+/**
+ * rng.cc - native int64 random number generator for node.js.
+ * Copyright (c) 2017, Christopher Jeffrey (MIT License)
+ */
+
+#include <node.h>
+#include <nan.h>
+
+#include <inttypes.h>
+#include <string.h>
+
+#include "core.h"
+#include "env.h"
+#include "stats.h"
+#include "n64.h"
+#include "rng.h"
+#include "array.h"
+
+#define ARG_ERROR(name, len) ("RNG#" #name " requires " #len " argument(s).")
+#define TYPE_ERROR(name, type) ("'" #name "' must be a(n) " #type ".")
+
+RNG::RNG() {
+  rng_seed(&ctx, 0);
+}
+
+RNG::~RNG() {}
+
+void
+RNG::Init(v8::Local<v8::Object> &target) {
+  Nan::HandleScope scope;
+
+  n64_env_t *env = env_get();
+
+  if (env->rng.IsEmpty()) {
+    v8::Local<v8::FunctionTemplate> tpl =
+      stats_template("RNG", RNG::New);
+
+    tpl->SetClassName(Nan::New("RNG").ToLocalChecked());
+    tpl->InstanceTemplate()->SetInternalFieldCount(1);
+
+    stats_method(tpl, "RNG", "seed", RNG::Seed);
+    stats_method(tpl, "RNG", "next", RNG::Next);
+    stats_method(tpl, "RNG", "nextBelow", RNG::NextBelow);
+    stats_method(tpl, "RNG", "jump", RNG::Jump);
+    stats_method(tpl, "RNG", "inject", RNG::Inject);
+    stats_method(tpl, "RNG", "fill", RNG::Fill);
+
+    env->rng.Reset(tpl);
+  }
+
+  v8::Local<v8::FunctionTemplate> ctor = Nan::New(env->rng);
+
+  Nan::Set(target, Nan::New("RNG").ToLocalChecked(),
+    Nan::GetFunction(ctor).ToLocalChecked());
+}
+
+NAN_METHOD(RNG::New) {
+  if (!info.IsConstructCall())
+    return Nan::ThrowError("RNG must be called with `new`.");
+
+  RNG *obj = new RNG();
+  obj->Wrap(info.This());
+
+  info.GetReturnValue().Set(info.This());
+}
+
+NAN_METHOD(RNG::Seed) {
+  RNG *r = ObjectWrap::Unwrap<RNG>(info.Holder());
+
+  if (info.Length() < 1)
+    return Nan::ThrowError(ARG_ERROR(seed, 1));
+
+  if (!N64::HasInstance(info[0]))
+    return Nan::ThrowTypeError(TYPE_ERROR(seed, int64));
+
+  N64 *a = ObjectWrap::Unwrap<N64>(info[0].As<v8::Object>());
+
+  rng_seed(&r->ctx, *a->n);
+
+  info.GetReturnValue().Set(info.Holder());
+}
+
+NAN_METHOD(RNG::Next) {
+  RNG *r = ObjectWrap::Unwrap<RNG>(info.Holder());
+
+  if (info.Length() < 1)
+    return Nan::ThrowError(ARG_ERROR(next, 1));
+
+  if (!N64::HasInstance(info[0]))
+    return Nan::ThrowTypeError(TYPE_ERROR(out, int64));
+
+  N64 *a = ObjectWrap::Unwrap<N64>(info[0].As<v8::Object>());
+
+  *a->n = rng_next(&r->ctx);
+
+  info.GetReturnValue().Set(info[0]);
+}
+
+NAN_METHOD(RNG::NextBelow) {
+  RNG *r = ObjectWrap::Unwrap<RNG>(info.Holder());
+
+  if (info.Length() < 2)
+    return Nan::ThrowError(ARG_ERROR(nextBelow, 2));
+
+  if (!N64::HasInstance(info[0]))
+    return Nan::ThrowTypeError(TYPE_ERROR(out, int64));
+
+  if (!N64::HasInstance(info[1]))
+    return Nan::ThrowTypeError(TYPE_ERROR(bound, int64));
+
+  N64 *a = ObjectWrap::Unwrap<N64>(info[0].As<v8::Object>());
+  N64 *b = ObjectWrap::Unwrap<N64>(info[1].As<v8::Object>());
+
+  // A negative I64 would wrap to a huge unsigned bound.
+  bool neg = (int64_t)*b->n < 0
+          && Nan::New(env_get()->i64)->HasInstance(info[1]);
+
+  if (*b->n == 0 || neg)
+    return Nan::ThrowRangeError("Bound must be positive.");
+
+  *a->n = rng_below(&r->ctx, *b->n);
+
+  info.GetReturnValue().Set(info[0]);
+}
+
+NAN_METHOD(RNG::Jump) {
+  RNG *r = ObjectWrap::Unwrap<RNG>(info.Holder());
+
+  rng_jump(&r->ctx);
+
+  info.GetReturnValue().Set(info.Holder());
+}
+
+NAN_METHOD(RNG::Inject) {
+  RNG *r = ObjectWrap::Unwrap<RNG>(info.Holder());
+
+  if (info.Length() < 1)
+    return Nan::ThrowError(ARG_ERROR(inject, 1));
+
+  if (!Nan::New(env_get()->rng)->HasInstance(info[0]))
+    return Nan::ThrowTypeError(TYPE_ERROR(rng, RNG));
+
+  RNG *b = ObjectWrap::Unwrap<RNG>(info[0].As<v8::Object>());
+
+  r->ctx = b->ctx;
+
+  info.GetReturnValue().Set(info.Holder());
+}
+
+NAN_METHOD(RNG::Fill) {
+  RNG *r = ObjectWrap::Unwrap<RNG>(info.Holder());
+
+  if (info.Length() < 1)
+    return Nan::ThrowError(ARG_ERROR(fill, 1));
+
+  // Arrays are filled in place without exposing a buffer.
+  if (N64Array::HasInstance(info[0])) {
+    N64Array *a = ObjectWrap::Unwrap<N64Array>(info[0].As<v8::Object>());
+
+    rng_fill(&r->ctx, (uint8_t *)a->data(), a->len * sizeof(uint64_t));
+
+    info.GetReturnValue().Set(info[0]);
+
+    return;
+  }
+
+  if (!info[0]->IsArrayBufferView())
+    return Nan::ThrowTypeError(TYPE_ERROR(data, typed array));
+
+  Nan::TypedArrayContents<uint8_t> contents(info[0]);
+
+  rng_fill(&r->ctx, *contents, contents.length());
+
+  info.GetReturnValue().Set(info[0]);
+}
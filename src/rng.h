@@ -0,0 +1,34 @@
+/**
+ * rng.h - native int64 random number generator for node.js.
+ * Copyright (c) 2017, Christopher Jeffrey (MIT License)
+ */
+
+#ifndef _N64_RNG_H
+#define _N64_RNG_H
+
+#include <node.h>
+#include <nan.h>
+#include <inttypes.h>
+
+#include "core.h"
+
+class RNG : public Nan::ObjectWrap {
+public:
+  static void Init(v8::Local<v8::Object> &target);
+  static NAN_METHOD(New);
+
+  RNG();
+  ~RNG();
+
+  rng_t ctx;
+
+private:
+  static NAN_METHOD(Seed);
+  static NAN_METHOD(Next);
+  static NAN_METHOD(NextBelow);
+  static NAN_METHOD(Jump);
+  static NAN_METHOD(Inject);
+  static NAN_METHOD(Fill);
+};
+
+#endif
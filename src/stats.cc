@@ -0,0 +1,299 @@
+/**
+ * stats.cc - opt-in call instrumentation for n64.
+ * Copyright (c) 2017, Christopher Jeffrey (MIT License)
+ *
+ * Enabled with N64_STATS=1 in the environment (or by
+ * building with -Dn64_stats=true). When disabled, methods
+ * are registered directly and the only cost left is one
+ * branch per allocation. When enabled, every method is
+ * registered through a trampoline which counts calls and
+ * throws and times one in every N64_STATS_SAMPLE calls.
+ * Throw sites which use stats_throw() record their kind;
+ * any other TypeError counts as "type".
+ */
+
+#include <node.h>
+#include <nan.h>
+#include <uv.h>
+
+#include <atomic>
+#include <inttypes.h>
+#include <mutex>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "stats.h"
+
+#define STATS_MAX_METHODS 512
+#define STATS_DEFAULT_SAMPLE 64
+
+typedef struct stats_method_s {
+  char name[64];
+  Nan::FunctionCallback fn;
+  std::atomic<uint64_t> calls;
+  std::atomic<uint64_t> samples;
+  std::atomic<uint64_t> time;
+  std::atomic<uint64_t> throws[THROW_MAX];
+} stats_method_t;
+
+bool stats_enabled = false;
+std::atomic<uint64_t> stats_allocs(0);
+thread_local int stats_kind = -1;
+
+static uint64_t stats_sample = STATS_DEFAULT_SAMPLE;
+static stats_method_t stats_methods[STATS_MAX_METHODS];
+static std::atomic<size_t> stats_count(0);
+static std::mutex stats_lock;
+static std::once_flag stats_once;
+
+static NAN_METHOD(stats_get);
+static NAN_METHOD(stats_reset);
+
+/*
+ * Setup
+ */
+
+static void
+stats_configure(void) {
+#ifdef N64_STATS
+  stats_enabled = true;
+#else
+  const char *env = getenv("N64_STATS");
+  stats_enabled = env != NULL && env[0] != '\0' && strcmp(env, "0") != 0;
+#endif
+
+  const char *sample = getenv("N64_STATS_SAMPLE");
+
+  if (sample != NULL) {
+    long n = strtol(sample, NULL, 10);
+    if (n > 0)
+      stats_sample = (uint64_t)n;
+  }
+}
+
+void
+stats_init(v8::Local<v8::Object> &target) {
+  // Workers load the module again; the
+  // counters are shared process-wide.
+  std::call_once(stats_once, stats_configure);
+
+  Nan::SetMethod(target, "stats", stats_get);
+  Nan::SetMethod(target, "resetStats", stats_reset);
+}
+
+static stats_method_t *
+stats_lookup(const char *cls, char sep, const char *name) {
+  std::lock_guard<std::mutex> guard(stats_lock);
+  char key[64];
+
+  snprintf(key, sizeof(key), "%s%c%s", cls, sep, name);
+
+  size_t count = stats_count.load(std::memory_order_relaxed);
+
+  for (size_t i = 0; i < count; i++) {
+    if (strcmp(stats_methods[i].name, key) == 0)
+      return &stats_methods[i];
+  }
+
+  if (count == STATS_MAX_METHODS)
+    return NULL;
+
+  stats_method_t *m = &stats_methods[count];
+
+  memcpy(m->name, key, sizeof(key));
+
+  stats_count.store(count + 1, std::memory_order_release);
+
+  return m;
+}
+
+/*
+ * Trampoline
+ */
+
+static int
+stats_classify(v8::Local<v8::Value> err) {
+  int kind = stats_kind;
+
+  stats_kind = -1;
+
+  if (kind >= 0)
+    return kind;
+
+  if (err->IsNativeError()) {
+    v8::Local<v8::String> name = err.As<v8::Object>()->GetConstructorName();
+
+    if (name->StrictEquals(Nan::New("TypeError").ToLocalChecked()))
+      return THROW_TYPE;
+  }
+
+  return THROW_OTHER;
+}
+
+static NAN_METHOD(stats_call) {
+  stats_method_t *m = (stats_method_t *)info.Data().As<v8::External>()->Value();
+  uint64_t n = m->calls.fetch_add(1, std::memory_order_relaxed);
+  Nan::TryCatch tc;
+
+  stats_kind = -1;
+
+  if (n % stats_sample == 0) {
+    uint64_t start = uv_hrtime();
+
+    m->fn(info);
+
+    m->time.fetch_add(uv_hrtime() - start, std::memory_order_relaxed);
+    m->samples.fetch_add(1, std::memory_order_relaxed);
+  } else {
+    m->fn(info);
+  }
+
+  if (tc.HasCaught()) {
+    int kind = stats_classify(tc.Exception());
+    m->throws[kind].fetch_add(1, std::memory_order_relaxed);
+    tc.ReThrow();
+  }
+}
+
+v8::Local<v8::FunctionTemplate>
+stats_template(const char *cls, Nan::FunctionCallback fn) {
+  if (!stats_enabled)
+    return Nan::New<v8::FunctionTemplate>(fn);
+
+  stats_method_t *m = stats_lookup(cls, '#', "new");
+
+  if (m == NULL)
+    return Nan::New<v8::FunctionTemplate>(fn);
+
+  m->fn = fn;
+
+  return Nan::New<v8::FunctionTemplate>(stats_call, Nan::New<v8::External>(m));
+}
+
+void
+stats_method(v8::Local<v8::FunctionTemplate> tpl,
+             const char *cls,
+             const char *name,
+             Nan::FunctionCallback fn) {
+  if (!stats_enabled) {
+    Nan::SetPrototypeMethod(tpl, name, fn);
+    return;
+  }
+
+  stats_method_t *m = stats_lookup(cls, '#', name);
+
+  if (m == NULL) {
+    Nan::SetPrototypeMethod(tpl, name, fn);
+    return;
+  }
+
+  m->fn = fn;
+
+  Nan::SetPrototypeMethod(tpl, name, stats_call, Nan::New<v8::External>(m));
+}
+
+void
+stats_function(v8::Local<v8::Object> target,
+               const char *ns,
+               const char *name,
+               Nan::FunctionCallback fn) {
+  if (!stats_enabled) {
+    Nan::SetMethod(target, name, fn);
+    return;
+  }
+
+  stats_method_t *m = stats_lookup(ns, '.', name);
+
+  if (m == NULL) {
+    Nan::SetMethod(target, name, fn);
+    return;
+  }
+
+  m->fn = fn;
+
+  Nan::SetMethod(target, name, stats_call, Nan::New<v8::External>(m));
+}
+
+/*
+ * API
+ */
+
+static void
+stats_set(v8::Local<v8::Object> obj, const char *key, double value) {
+  Nan::Set(obj, Nan::New(key).ToLocalChecked(), Nan::New<v8::Number>(value));
+}
+
+static NAN_METHOD(stats_get) {
+  v8::Local<v8::Object> ret = Nan::New<v8::Object>();
+  v8::Local<v8::Object> methods = Nan::New<v8::Object>();
+  v8::Local<v8::Object> throws = Nan::New<v8::Object>();
+  size_t count = stats_count.load(std::memory_order_acquire);
+  uint64_t calls = 0;
+  uint64_t total[THROW_MAX] = {0, 0, 0, 0, 0};
+
+  for (size_t i = 0; i < count; i++) {
+    stats_method_t *m = &stats_methods[i];
+    uint64_t c = m->calls.load(std::memory_order_relaxed);
+
+    if (c == 0)
+      continue;
+
+    v8::Local<v8::Object> item = Nan::New<v8::Object>();
+    uint64_t samples = m->samples.load(std::memory_order_relaxed);
+    uint64_t time = m->time.load(std::memory_order_relaxed);
+    uint64_t errors = 0;
+
+    for (int j = 0; j < THROW_MAX; j++) {
+      uint64_t t = m->throws[j].load(std::memory_order_relaxed);
+      total[j] += t;
+      errors += t;
+    }
+
+    calls += c;
+
+    stats_set(item, "calls", (double)c);
+    stats_set(item, "throws", (double)errors);
+    stats_set(item, "samples", (double)samples);
+    stats_set(item, "time", (double)time);
+    stats_set(item, "mean", samples ? (double)time / (double)samples : 0);
+
+    Nan::Set(methods, Nan::New(m->name).ToLocalChecked(), item);
+  }
+
+  stats_set(throws, "type", (double)total[THROW_TYPE]);
+  stats_set(throws, "divzero", (double)total[THROW_DIVZERO]);
+  stats_set(throws, "overflow", (double)total[THROW_OVERFLOW]);
+  stats_set(throws, "parse", (double)total[THROW_PARSE]);
+  stats_set(throws, "other", (double)total[THROW_OTHER]);
+
+  Nan::Set(ret, Nan::New("enabled").ToLocalChecked(),
+    Nan::New<v8::Boolean>(stats_enabled));
+
+  stats_set(ret, "sampleRate", stats_enabled ? (double)stats_sample : 0);
+  stats_set(ret, "allocations",
+            (double)stats_allocs.load(std::memory_order_relaxed));
+  stats_set(ret, "calls", (double)calls);
+
+  Nan::Set(ret, Nan::New("throws").ToLocalChecked(), throws);
+  Nan::Set(ret, Nan::New("methods").ToLocalChecked(), methods);
+
+  info.GetReturnValue().Set(ret);
+}
+
+static NAN_METHOD(stats_reset) {
+  size_t count = stats_count.load(std::memory_order_acquire);
+
+  for (size_t i = 0; i < count; i++) {
+    stats_method_t *m = &stats_methods[i];
+
+    m->calls.store(0, std::memory_order_relaxed);
+    m->samples.store(0, std::memory_order_relaxed);
+    m->time.store(0, std::memory_order_relaxed);
+
+    for (int j = 0; j < THROW_MAX; j++)
+      m->throws[j].store(0, std::memory_order_relaxed);
+  }
+
+  stats_allocs.store(0, std::memory_order_relaxed);
+}
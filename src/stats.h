@@ -0,0 +1,61 @@
+/**
+ * stats.h - opt-in call instrumentation for n64.
+ * Copyright (c) 2017, Christopher Jeffrey (MIT License)
+ */
+
+#ifndef _N64_STATS_H
+#define _N64_STATS_H
+
+#include <node.h>
+#include <nan.h>
+
+#include <atomic>
+#include <inttypes.h>
+
+enum {
+  THROW_TYPE = 0,
+  THROW_DIVZERO = 1,
+  THROW_OVERFLOW = 2,
+  THROW_PARSE = 3,
+  THROW_OTHER = 4,
+  THROW_MAX = 5
+};
+
+extern bool stats_enabled;
+extern std::atomic<uint64_t> stats_allocs;
+extern thread_local int stats_kind;
+
+void
+stats_init(v8::Local<v8::Object> &target);
+
+v8::Local<v8::FunctionTemplate>
+stats_template(const char *cls, Nan::FunctionCallback fn);
+
+void
+stats_method(v8::Local<v8::FunctionTemplate> tpl,
+             const char *cls,
+             const char *name,
+             Nan::FunctionCallback fn);
+
+void
+stats_function(v8::Local<v8::Object> target,
+               const char *ns,
+               const char *name,
+               Nan::FunctionCallback fn);
+
+static inline void
+stats_throw(int kind, const char *msg) {
+  // Read back by the trampoline.
+  if (stats_enabled)
+    stats_kind = kind;
+
+  Nan::ThrowError(msg);
+}
+
+static inline void
+stats_alloc(void) {
+  if (stats_enabled)
+    stats_allocs.fetch_add(1, std::memory_order_relaxed);
+}
+
+#endif
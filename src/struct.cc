@@ -0,0 +1,376 @@
+/**
+ * struct.cc - native fixed layout records for node.js.
+ * Copyright (c) 2017, Christopher Jeffrey (MIT License)
+ */
+
+#include <node.h>
+#include <nan.h>
+
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "core.h"
+#include "env.h"
+#include "stats.h"
+#include "n64.h"
+#include "array.h"
+#include "bulk.h"
+#include "struct.h"
+
+#define ARG_ERROR(name, len) ("Struct#" #name " requires " #len " argument(s).")
+#define TYPE_ERROR(name, type) ("'" #name "' must be a(n) " #type ".")
+
+static bool
+get_value(v8::Local<v8::Value> val, uint64_t *r) {
+  if (val->IsNumber()) {
+    double num = val.As<v8::Number>()->Value();
+
+    if (!(num >= -9007199254740991.0 && num <= 9007199254740991.0)
+        || num != (double)(int64_t)num) {
+      return false;
+    }
+
+    *r = (uint64_t)(int64_t)num;
+
+    return true;
+  }
+
+  if (N64::HasInstance(val)) {
+    *r = *Nan::ObjectWrap::Unwrap<N64>(val.As<v8::Object>())->n;
+    return true;
+  }
+
+  return false;
+}
+
+// Checks that `count` records starting at
+// `off` fit in `len` bytes.
+static bool
+check_range(size_t len, uint32_t off, uint32_t count, uint32_t size) {
+  uint64_t need = (uint64_t)count * size;
+  return off <= len && need <= (uint64_t)(len - off);
+}
+
+Struct::Struct() {
+  fields = NULL;
+  len = 0;
+  size = 0;
+  wide = 0;
+  values = NULL;
+}
+
+Struct::~Struct() {
+  free(fields);
+  store.Reset();
+}
+
+void
+Struct::Init(v8::Local<v8::Object> &target) {
+  Nan::HandleScope scope;
+
+  n64_env_t *env = env_get();
+
+  if (env->structure.IsEmpty()) {
+    v8::Local<v8::FunctionTemplate> tpl =
+      stats_template("Struct", Struct::New);
+
+    tpl->SetClassName(Nan::New("Struct").ToLocalChecked());
+    tpl->InstanceTemplate()->SetInternalFieldCount(1);
+
+    stats_method(tpl, "Struct", "decode", Struct::Decode);
+    stats_method(tpl, "Struct", "decodeMany", Struct::DecodeMany);
+    stats_method(tpl, "Struct", "encode", Struct::Encode);
+    stats_method(tpl, "Struct", "encodeMany", Struct::EncodeMany);
+
+    env->structure.Reset(tpl);
+  }
+
+  v8::Local<v8::FunctionTemplate> ctor = Nan::New(env->structure);
+
+  Nan::Set(target, Nan::New("Struct").ToLocalChecked(),
+    Nan::GetFunction(ctor).ToLocalChecked());
+}
+
+// The layout is checked in JS and arrives as
+// [offset, width, sign, be] for each field.
+NAN_METHOD(Struct::New) {
+  if (!info.IsConstructCall())
+    return Nan::ThrowError("Struct must be called with `new`.");
+
+  if (info.Length() < 3)
+    return Nan::ThrowError("Struct requires 3 argument(s).");
+
+  if (!info[0]->IsUint32Array())
+    return Nan::ThrowTypeError(TYPE_ERROR(layout, Uint32Array));
+
+  if (!info[1]->IsUint32())
+    return Nan::ThrowTypeError(TYPE_ERROR(size, integer));
+
+  if (!info[2]->IsFloat64Array())
+    return Nan::ThrowTypeError(TYPE_ERROR(values, Float64Array));
+
+  size_t bytes = 0;
+  const uint32_t *layout = (const uint32_t *)get_buffer(info[0], &bytes);
+  uint32_t len = (uint32_t)(bytes / 16);
+  uint32_t size = Nan::To<uint32_t>(info[1]).FromJust();
+
+  if (len == 0 || (bytes & 15) != 0)
+    return Nan::ThrowError("Invalid layout.");
+
+  uint32_t wide = 0;
+
+  for (uint32_t i = 0; i < len; i++) {
+    const uint32_t *f = &layout[i * 4];
+
+    if (f[1] == 8)
+      wide += 1;
+
+    if ((f[1] != 1 && f[1] != 2 && f[1] != 4 && f[1] != 8)
+        || f[0] > size || size - f[0] < f[1]) {
+      return Nan::ThrowError("Invalid layout.");
+    }
+  }
+
+  // Fetching the values on every call would cost as
+  // much as the decode. Data() stays put once the
+  // array has been moved off the heap.
+  size_t need = 0;
+  double *values = (double *)get_buffer(info[2], &need);
+
+  if (values == NULL || need < (size_t)(len - wide) * sizeof(double))
+    return Nan::ThrowError("Invalid layout.");
+
+  n64_field_t *fields = (n64_field_t *)malloc(len * sizeof(n64_field_t));
+
+  if (fields == NULL)
+    return Nan::ThrowError("Allocation failed.");
+
+  Struct *obj = new Struct();
+  obj->Wrap(info.This());
+
+  obj->fields = fields;
+  obj->len = len;
+  obj->size = size;
+  obj->wide = wide;
+  obj->values = values;
+  obj->store.Reset(info[2].As<v8::Object>());
+
+  for (uint32_t i = 0; i < len; i++) {
+    const uint32_t *f = &layout[i * 4];
+
+    fields[i].offset = f[0];
+    fields[i].width = f[1];
+    fields[i].sign = f[2] != 0;
+    fields[i].be = f[3] != 0;
+  }
+
+  info.GetReturnValue().Set(info.This());
+}
+
+// Setting properties from here costs far more than
+// reading the record, so small fields go out through
+// `values` (in field order) for JS to assign, and 64
+// bit fields are written into the N64s passed after
+// the offset (also in field order).
+NAN_METHOD(Struct::Decode) {
+  Struct *s = ObjectWrap::Unwrap<Struct>(info.Holder());
+
+  if (info.Length() < 2 + (int)s->wide)
+    return Nan::ThrowError(ARG_ERROR(decode, 2));
+
+  if (!is_buffer(info[0]))
+    return Nan::ThrowTypeError(TYPE_ERROR(data, buffer));
+
+  if (!info[1]->IsUint32())
+    return Nan::ThrowTypeError(TYPE_ERROR(offset, integer));
+
+  size_t len = 0;
+  const uint8_t *data = get_buffer(info[0], &len);
+  uint32_t off = Nan::To<uint32_t>(info[1]).FromJust();
+  double *values = s->values;
+  int arg = 2;
+
+  if (!check_range(len, off, 1, s->size))
+    return Nan::ThrowError("Invalid range.");
+
+  const uint8_t *rec = data + off;
+
+  for (uint32_t i = 0; i < s->len; i++) {
+    const n64_field_t *f = &s->fields[i];
+    uint64_t x = n64_field_read(rec, f);
+
+    if (f->width != 8) {
+      if (f->sign)
+        *values++ = (double)(int64_t)x;
+      else
+        *values++ = (double)x;
+      continue;
+    }
+
+    if (!N64::HasInstance(info[arg]))
+      return Nan::ThrowTypeError(TYPE_ERROR(out, int64));
+
+    N64 *n = ObjectWrap::Unwrap<N64>(info[arg].As<v8::Object>());
+
+    *n->n = x;
+
+    arg += 1;
+  }
+}
+
+// One host order column per field, in field order.
+NAN_METHOD(Struct::DecodeMany) {
+  Struct *s = ObjectWrap::Unwrap<Struct>(info.Holder());
+
+  if (info.Length() < 4)
+    return Nan::ThrowError(ARG_ERROR(decodeMany, 4));
+
+  if (!is_buffer(info[0]))
+    return Nan::ThrowTypeError(TYPE_ERROR(data, buffer));
+
+  if (!info[1]->IsUint32())
+    return Nan::ThrowTypeError(TYPE_ERROR(offset, integer));
+
+  if (!info[2]->IsUint32())
+    return Nan::ThrowTypeError(TYPE_ERROR(count, integer));
+
+  if (!info[3]->IsArray())
+    return Nan::ThrowTypeError(TYPE_ERROR(columns, array));
+
+  size_t len = 0;
+  const uint8_t *data = get_buffer(info[0], &len);
+  uint32_t off = Nan::To<uint32_t>(info[1]).FromJust();
+  uint32_t count = Nan::To<uint32_t>(info[2]).FromJust();
+  v8::Local<v8::Array> columns = info[3].As<v8::Array>();
+
+  if (!check_range(len, off, count, s->size))
+    return Nan::ThrowError("Invalid range.");
+
+  if (columns->Length() != s->len)
+    return Nan::ThrowError("Invalid columns.");
+
+  for (uint32_t i = 0; i < s->len; i++) {
+    const n64_field_t *f = &s->fields[i];
+    v8::Local<v8::Value> column = Nan::Get(columns, i).ToLocalChecked();
+
+    if (!is_buffer(column))
+      return Nan::ThrowTypeError(TYPE_ERROR(column, buffer));
+
+    size_t size = 0;
+    uint8_t *dst = get_buffer(column, &size);
+
+    if (size < (size_t)count * f->width)
+      return Nan::ThrowError("Invalid columns.");
+
+    if (count > 0)
+      n64_field_gather(dst, data + off, s->size, count, f);
+  }
+
+  info.GetReturnValue().Set(Nan::New<v8::Uint32>(count));
+}
+
+// The inverse of decode(). Small fields come in
+// through `values`, already wrapped to 32 bits, and
+// 64 bit fields as N64s or safe integers.
+NAN_METHOD(Struct::Encode) {
+  Struct *s = ObjectWrap::Unwrap<Struct>(info.Holder());
+
+  if (info.Length() < 2 + (int)s->wide)
+    return Nan::ThrowError(ARG_ERROR(encode, 2));
+
+  if (!is_buffer(info[0]))
+    return Nan::ThrowTypeError(TYPE_ERROR(data, buffer));
+
+  if (!info[1]->IsUint32())
+    return Nan::ThrowTypeError(TYPE_ERROR(offset, integer));
+
+  size_t len = 0;
+  uint8_t *data = get_buffer(info[0], &len);
+  uint32_t off = Nan::To<uint32_t>(info[1]).FromJust();
+  const double *values = s->values;
+  int arg = 2;
+
+  if (!check_range(len, off, 1, s->size))
+    return Nan::ThrowError("Invalid range.");
+
+  uint8_t *rec = data + off;
+
+  for (uint32_t i = 0; i < s->len; i++) {
+    const n64_field_t *f = &s->fields[i];
+    uint64_t x = 0;
+
+    if (f->width != 8) {
+      double num = *values++;
+
+      // Anything JS did not wrap is written as zero.
+      if (num >= -2147483648.0 && num < 4294967296.0)
+        x = (uint64_t)(int64_t)num;
+    } else {
+      if (!get_value(info[arg], &x))
+        return Nan::ThrowTypeError(TYPE_ERROR(value, int64));
+
+      arg += 1;
+    }
+
+    n64_field_write(rec, f, x);
+  }
+}
+
+NAN_METHOD(Struct::EncodeMany) {
+  Struct *s = ObjectWrap::Unwrap<Struct>(info.Holder());
+
+  if (info.Length() < 4)
+    return Nan::ThrowError(ARG_ERROR(encodeMany, 4));
+
+  if (!info[0]->IsArray())
+    return Nan::ThrowTypeError(TYPE_ERROR(columns, array));
+
+  if (!is_buffer(info[1]))
+    return Nan::ThrowTypeError(TYPE_ERROR(data, buffer));
+
+  if (!info[2]->IsUint32())
+    return Nan::ThrowTypeError(TYPE_ERROR(offset, integer));
+
+  if (!info[3]->IsUint32())
+    return Nan::ThrowTypeError(TYPE_ERROR(count, integer));
+
+  v8::Local<v8::Array> columns = info[0].As<v8::Array>();
+  size_t len = 0;
+  uint8_t *data = get_buffer(info[1], &len);
+  uint32_t off = Nan::To<uint32_t>(info[2]).FromJust();
+  uint32_t count = Nan::To<uint32_t>(info[3]).FromJust();
+
+  if (!check_range(len, off, count, s->size))
+    return Nan::ThrowError("Invalid range.");
+
+  if (columns->Length() != s->len)
+    return Nan::ThrowError("Invalid columns.");
+
+  // Checked up front so that a bad column
+  // leaves the records untouched.
+  for (uint32_t i = 0; i < s->len; i++) {
+    const n64_field_t *f = &s->fields[i];
+    v8::Local<v8::Value> column = Nan::Get(columns, i).ToLocalChecked();
+
+    if (!is_buffer(column))
+      return Nan::ThrowTypeError(TYPE_ERROR(column, buffer));
+
+    size_t size = 0;
+
+    get_buffer(column, &size);
+
+    if (size < (size_t)count * f->width)
+      return Nan::ThrowError("Invalid columns.");
+  }
+
+  for (uint32_t i = 0; i < s->len && count > 0; i++) {
+    v8::Local<v8::Value> column = Nan::Get(columns, i).ToLocalChecked();
+    size_t size = 0;
+    const uint8_t *src = get_buffer(column, &size);
+
+    n64_field_scatter(data + off, s->size, src, count, &s->fields[i]);
+  }
+
+  info.GetReturnValue().Set(Nan::New<v8::Uint32>(count));
+}
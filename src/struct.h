@@ -0,0 +1,39 @@
+/**
+ * struct.h - native fixed layout records for node.js.
+ * Copyright (c) 2017, Christopher Jeffrey (MIT License)
+ */
+
+#ifndef _N64_STRUCT_H
+#define _N64_STRUCT_H
+
+#include <node.h>
+#include <nan.h>
+#include <inttypes.h>
+
+#include "core.h"
+
+class Struct : public Nan::ObjectWrap {
+public:
+  static void Init(v8::Local<v8::Object> &target);
+  static NAN_METHOD(New);
+
+  Struct();
+  ~Struct();
+
+  n64_field_t *fields;
+  uint32_t len;
+  uint32_t size;
+  uint32_t wide;
+
+  // Small fields pass through here (see Decode).
+  double *values;
+  Nan::Persistent<v8::Object> store;
+
+private:
+  static NAN_METHOD(Decode);
+  static NAN_METHOD(DecodeMany);
+  static NAN_METHOD(Encode);
+  static NAN_METHOD(EncodeMany);
+};
+
+#endif
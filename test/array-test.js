@@ -0,0 +1,154 @@
+/* eslint-env mocha */
+/* eslint prefer-arrow-callback: "off" */
+
+'use strict';
+
+const assert = require('assert');
+const n64 = require('../lib/n64');
+const native = require('../lib/native');
+
+function run(n64, name) {
+  const {U64, I64, N64Array, U64Array, I64Array} = n64;
+
+  describe(name, function() {
+    it('should push and get', () => {
+      const arr = new U64Array();
+      const nums = [];
+
+      for (let i = 0; i < 100; i++) {
+        const num = U64.random();
+        nums.push(num);
+        assert.strictEqual(arr.push(num), i + 1);
+      }
+
+      assert.strictEqual(arr.length, 100);
+
+      const out = new U64();
+
+      for (let i = 0; i < 100; i++) {
+        assert.strictEqual(arr.get(i, out), out);
+        assert(out.eq(nums[i]));
+        assert(U64.isU64(arr.get(i)));
+      }
+    });
+
+    it('should cast small numbers by sign', () => {
+      const u = new U64Array();
+      const s = new I64Array();
+
+      u.pushn(-1);
+      s.pushn(-1);
+
+      assert.strictEqual(u.get(0).toString(16), 'ffffffff');
+      assert.strictEqual(s.get(0).toString(), '-1');
+
+      u.setn(0, 0x80000000);
+      s.setn(0, 0x80000000);
+
+      assert.strictEqual(u.get(0).toString(16), '80000000');
+      assert.strictEqual(s.get(0).toString(), '-2147483648');
+    });
+
+    it('should set', () => {
+      const arr = new I64Array(4);
+
+      assert.strictEqual(arr.length, 4);
+      assert(arr.get(3).isZero());
+
+      arr.set(2, I64.INT64_MIN);
+
+      assert(arr.get(2).eq(I64.INT64_MIN));
+      assert(arr.get(1).isZero());
+    });
+
+    it('should share memory with subarrays', () => {
+      const arr = U64Array.from([0, 1, 2, 3, 4, 5, 6, 7]);
+      const sub = arr.subarray(2, -2);
+
+      assert.strictEqual(sub.length, 4);
+      assert.strictEqual(sub.get(0).toNumber(), 2);
+
+      sub.setn(1, 100);
+
+      assert.strictEqual(arr.get(3).toNumber(), 100);
+      assert.strictEqual(arr.slice(-1).get(0).toNumber(), 7);
+      assert.strictEqual(arr.subarray(6, 2).length, 0);
+
+      // Pushing must not clobber the parent.
+      sub.pushn(200);
+
+      assert.strictEqual(arr.get(6).toNumber(), 6);
+      assert.strictEqual(sub.get(4).toNumber(), 200);
+
+      // Nor may the parent be seen after growing.
+      sub.setn(0, 300);
+
+      assert.strictEqual(arr.get(2).toNumber(), 2);
+    });
+
+    it('should expose the backing store', () => {
+      const arr = U64Array.from([U64(0x01020304, 0x05060708), 2]);
+      const buf = arr.toBuffer();
+
+      assert.strictEqual(buf.length, 16);
+      assert.strictEqual(buf.toString('hex', 0, 8), '0807060504030201');
+
+      arr.setn(1, 3);
+
+      assert.strictEqual(buf[8], 3);
+
+      for (let i = 0; i < 64; i++)
+        arr.pushn(i);
+
+      arr.setn(1, 4);
+
+      assert.strictEqual(buf[8], 3);
+      assert.strictEqual(arr.toBuffer().length, 66 * 8);
+      assert.strictEqual(new U64Array().toBuffer().length, 0);
+    });
+
+    it('should iterate', () => {
+      const arr = I64Array.from([-1, 0, 1]);
+      const strs = [];
+
+      for (const num of arr)
+        strs.push(num.toString());
+
+      assert.deepStrictEqual(strs, ['-1', '0', '1']);
+      assert.deepStrictEqual(arr.toArray().map(n => n.toNumber()), [-1, 0, 1]);
+      assert(N64Array.isN64Array(arr));
+    });
+
+    it('should work with views and rng', () => {
+      const arr = new U64Array(8);
+      const view = U64.view(arr, 24);
+
+      view.iaddn(5);
+
+      assert.strictEqual(arr.get(3).toNumber(), 5);
+
+      const a = new U64Array(16);
+      const b = new Uint8Array(128);
+
+      U64.rng(1).fill(a);
+      U64.rng(1).fill(b);
+
+      assert(a.toBuffer().equals(b));
+    });
+
+    it('should reject bad arguments', () => {
+      const arr = new U64Array(2);
+
+      assert.throws(() => arr.get(2), /Invalid index/);
+      assert.throws(() => arr.get(-1), TypeError);
+      assert.throws(() => arr.set(0, 1), TypeError);
+      assert.throws(() => arr.push('1'), TypeError);
+      assert.throws(() => arr.get(0, {}), TypeError);
+      assert.throws(() => arr.subarray(0.5), TypeError);
+      assert.throws(() => new U64Array(-1), TypeError);
+    });
+  });
+}
+
+run(n64, 'Array (JS)');
+run(native, 'Array (Native)');
@@ -0,0 +1,151 @@
+/* eslint-env mocha */
+/* eslint prefer-arrow-callback: "off" */
+
+'use strict';
+
+const assert = require('assert');
+const path = require('path');
+const n64 = require('../lib/n64');
+const native = require('../lib/native');
+
+function run(n64, name) {
+  const {U64, I64, U64Array} = n64;
+
+  describe(name, function() {
+    it('should add and subtract', () => {
+      const sab = new SharedArrayBuffer(16);
+      const words = new BigUint64Array(sab);
+      const prev = new U64();
+
+      U64.atomic.add(sab, 1, 5);
+      U64.atomic.add(sab, 1, U64(0xffffffff, 0xffffffff), prev);
+
+      assert.strictEqual(prev.toNumber(), 5);
+      assert.strictEqual(words[1], BigInt(4));
+
+      U64.atomic.sub(sab, 1, { hi: 0, lo: 6 });
+
+      assert.strictEqual(words[1].toString(16), 'fffffffffffffffe');
+      assert.strictEqual(I64.atomic.load(sab, 1).toString(), '-2');
+      assert.strictEqual(words[0], BigInt(0));
+
+      I64.atomic.add(sab, 0, -1);
+
+      assert.strictEqual(U64.atomic.load(sab, 0).toString(16),
+                         'ffffffffffffffff');
+    });
+
+    it('should apply bitwise operations', () => {
+      const sab = new SharedArrayBuffer(8);
+      const prev = new U64();
+      const num = U64.atomic.load(sab, 0);
+
+      U64.atomic.or(sab, 0, U64(0xf0f0f0f0, 0x0000ffff));
+      U64.atomic.and(sab, 0, U64(0xff00ff00, 0xffff0000), prev);
+
+      assert.strictEqual(prev.toString(16), 'f0f0f0f00000ffff');
+
+      U64.atomic.xor(sab, 0, U64(0x00000001, 0x00000000));
+      U64.atomic.load(sab, 0, num);
+
+      assert.strictEqual(num.toString(16), 'f000f00100000000');
+
+      U64.atomic.exchange(sab, 0, 7, prev);
+
+      assert.strictEqual(prev.toString(16), 'f000f00100000000');
+      assert.strictEqual(U64.atomic.load(sab, 0).toNumber(), 7);
+    });
+
+    it('should compare and exchange', () => {
+      const sab = new SharedArrayBuffer(8);
+      const prev = new U64();
+
+      U64.atomic.store(sab, 0, U64.UINT64_MAX);
+
+      assert.strictEqual(U64.atomic.compareExchange(sab, 0, 0, 1, prev), false);
+      assert(prev.eq(U64.UINT64_MAX));
+
+      assert.strictEqual(
+        U64.atomic.compareExchange(sab, 0, U64.UINT64_MAX, 1, prev), true);
+
+      assert(prev.eq(U64.UINT64_MAX));
+      assert.strictEqual(U64.atomic.load(sab, 0).toNumber(), 1);
+    });
+
+    it('should accept views and arrays', () => {
+      const buf = new BigUint64Array(4);
+      const arr = new U64Array(4);
+
+      U64.atomic.add(buf, 2, 3);
+      U64.atomic.add(buf.subarray(2), 0, 3);
+      U64.atomic.add(arr, 3, 9);
+
+      assert.strictEqual(buf[2], BigInt(6));
+      assert.strictEqual(arr.get(3).toNumber(), 9);
+      assert.strictEqual(U64.atomic.load(buf.buffer, 2).toNumber(), 6);
+    });
+
+    it('should count across stripes', () => {
+      const counter = U64.atomic.counter(4);
+      const other = U64.atomic.counter(counter.buffer);
+
+      // Simulate threads landing on different stripes.
+      other.index = (counter.index + 8) % 32;
+
+      for (let i = 0; i < 100; i++) {
+        counter.add(1);
+        other.add(2);
+      }
+
+      other.sub(U64(50));
+
+      assert.strictEqual(counter.stripes, 4);
+      assert.strictEqual(counter.value().toNumber(), 250);
+      assert.strictEqual(other.value().toNumber(), 250);
+
+      counter.reset();
+
+      assert(counter.value().isZero());
+    });
+
+    it('should reject bad arguments', () => {
+      const sab = new SharedArrayBuffer(16);
+
+      assert.throws(() => U64.atomic.add(sab, 2, 1), /Invalid index/);
+      assert.throws(() => U64.atomic.add(sab, -1, 1), TypeError);
+      assert.throws(() => U64.atomic.add(sab, 0, '1'), TypeError);
+      assert.throws(() => U64.atomic.add(sab, 0, 1.5), TypeError);
+      assert.throws(() => U64.atomic.add([], 0, 1), TypeError);
+      assert.throws(() => U64.atomic.add(sab, 0, 1, {}), TypeError);
+      assert.throws(() => U64.atomic.load(new Uint8Array(sab, 4), 0),
+                    /Unaligned offset/);
+      assert.throws(() => U64.atomic.counter(new SharedArrayBuffer(32)),
+                    /Invalid counter buffer/);
+
+      assert(U64.atomic.load(sab, 0).isZero());
+    });
+  });
+}
+
+run(n64, 'Atomic (JS)');
+run(native, 'Atomic (Native)');
+
+describe('Atomic (Binding)', function() {
+  // The wrappers check numbers before the binding
+  // sees them, so call it directly.
+  const binding = require('loady')('n64', path.resolve(__dirname, '../lib'));
+
+  it('should reject non-integral numbers', () => {
+    const sab = new SharedArrayBuffer(16);
+
+    for (const value of [1.5, -0.5, 2 ** 51 + 0.5, NaN, Infinity])
+      assert.throws(() => binding.atomic.add(sab, 0, value),
+                    /^TypeError: 'value' must be a\(n\) integer\.$/);
+
+    binding.atomic.add(sab, 0, 2 ** 52);
+    binding.atomic.store(sab, 1, -3);
+
+    assert.strictEqual(native.U64.atomic.load(sab, 0).toNumber(), 2 ** 52);
+    assert.strictEqual(native.I64.atomic.load(sab, 1).toNumber(), -3);
+  });
+});
@@ -0,0 +1,128 @@
+/* eslint-env mocha */
+/* eslint prefer-arrow-callback: "off" */
+
+'use strict';
+
+const assert = require('assert');
+const cp = require('child_process');
+const path = require('path');
+const backend = require('../lib/backend');
+
+// The selection is cached per process,
+// so `auto` is checked in a child.
+function spawn(code, name) {
+  const env = Object.assign({}, process.env);
+
+  delete env.N64_BACKEND;
+
+  if (name)
+    env.N64_BACKEND = name;
+
+  const script = `
+    const backend = require(${JSON.stringify(
+      path.resolve(__dirname, '../lib/backend'))});
+    ${code}
+  `;
+
+  // Calibration must not need eval either.
+  const out = cp.execFileSync(process.execPath,
+    ['--disallow-code-generation-from-strings', '-e', script], { env });
+
+  return JSON.parse(out.toString('utf8'));
+}
+
+describe('Backend', function() {
+  this.timeout(10000);
+
+  it('should load backends by name', () => {
+    assert.strictEqual(backend.load('native'), require('../lib/native'));
+    assert.strictEqual(backend.load('js'), require('../lib/n64'));
+    assert.strictEqual(backend.load('bigint'), require('../lib/bigint'));
+    assert.deepStrictEqual(backend.available(), ['native', 'js', 'bigint']);
+
+    assert.throws(() => backend.load('wasm'), /Unknown backend/);
+    assert.throws(() => backend.load(1), /'name' must be a\(n\) string/);
+  });
+
+  it('should calibrate every backend', () => {
+    const timings = backend.calibrate(1);
+
+    assert.deepStrictEqual(Object.keys(timings), backend.available());
+
+    for (const name of Object.keys(timings))
+      assert(timings[name] > 0 && isFinite(timings[name]), name);
+
+    assert.throws(() => backend.calibrate(0), /'budget'/);
+  });
+
+  it('should select once', () => {
+    const out = spawn(`
+      const name = backend.select(1);
+      const lib = backend.load('auto');
+      process.stdout.write(JSON.stringify({
+        name: name,
+        same: lib === backend.load(name) && backend.select() === name,
+        api: Object.keys(lib)
+      }));
+    `);
+
+    assert(backend.available().includes(out.name));
+    assert.strictEqual(out.same, true);
+    assert.deepStrictEqual(out.api, Object.keys(require('../lib/n64')));
+  });
+
+  it('should not calibrate by default', () => {
+    const out = spawn(`
+      const path = require('path');
+      const lib = backend.load();
+      process.stdout.write(JSON.stringify({
+        js: lib === backend.load('js'),
+        loaded: Object.keys(require.cache).map(f => path.basename(f))
+      }));
+    `);
+
+    // Calibration would have loaded the other backends.
+    assert.strictEqual(out.js, true);
+    assert(!out.loaded.includes('native.js'));
+    assert(!out.loaded.includes('bigint.js'));
+  });
+
+  it('should borrow the rest of the API for bigint', () => {
+    const js = require('../lib/n64');
+    const big = backend.load('bigint');
+    const {U64, I64} = big;
+
+    assert.deepStrictEqual(Object.keys(big), Object.keys(js));
+
+    const a = U64(5);
+    const arr = big.U64Array.from([a, U64(7)]);
+    const b = arr.get(1);
+
+    assert(U64.isU64(b));
+    assert.strictEqual(a.add(b).toString(), '12');
+    assert.strictEqual(b.mul(a).toString(), '35');
+    assert.strictEqual(a.toU128().toString(), '5');
+    assert.strictEqual(I64(-3).toI128().toString(), '-3');
+
+    const data = new Uint8Array(16);
+    const view = U64.view(data, 8);
+
+    view.iadd(U64.UINT64_MAX);
+
+    assert.strictEqual(view.add(a).toString(), '4');
+    assert.strictEqual(data[15], 0xff);
+    assert(U64.isU64(U64.rng(1).next()));
+    assert(I64.isI64(js.I64(1)));
+    assert.strictEqual(I64(10).div(js.I64(-3)).toString(), '-3');
+  });
+
+  it('should honor N64_BACKEND', () => {
+    const out = spawn(`
+      const {U64} = backend.load();
+      const n = U64(1);
+      process.stdout.write(JSON.stringify(typeof n.n));
+    `, 'bigint');
+
+    assert.strictEqual(out, 'bigint');
+  });
+});
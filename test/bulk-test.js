@@ -0,0 +1,171 @@
+/* eslint-env mocha */
+/* eslint prefer-arrow-callback: "off" */
+
+'use strict';
+
+const assert = require('assert');
+const n64 = require('../lib/n64');
+const native = require('../lib/native');
+
+// Odd counts leave a tail after the vector loops.
+function random(count, off) {
+  const data = Buffer.alloc(off + count * 8);
+  n64.U64.rng(count).fill(data);
+  return data.subarray(off);
+}
+
+function run(n64, name) {
+  const {N64, U64, U64Array} = n64;
+
+  describe(name, function() {
+    it('should swap byte order', () => {
+      for (const count of [0, 1, 2, 3, 7, 37]) {
+        for (const off of [0, 3]) {
+          const src = random(count, off);
+          const dst = Buffer.alloc(src.length);
+          const copy = Buffer.from(src);
+
+          assert.strictEqual(N64.bswap64(dst, src), dst);
+          assert(src.equals(copy));
+
+          for (let i = 0; i < count; i++) {
+            const num = U64.readLE(src, i * 8);
+            assert(U64.readBE(dst, i * 8).eq(num));
+          }
+
+          // In place, twice, is the identity.
+          N64.bswap64(dst);
+          assert(dst.equals(src));
+        }
+      }
+    });
+
+    it('should swap overlapping views', () => {
+      const data = random(9, 0);
+      const copy = Buffer.from(data);
+      const expect = Buffer.alloc(64);
+
+      for (let i = 0; i < 8; i++)
+        U64.readLE(copy, i * 8).writeBE(expect, i * 8);
+
+      N64.bswap64(data.subarray(8), data.subarray(0, 64));
+
+      assert(data.subarray(0, 8).equals(copy.subarray(0, 8)));
+      assert(data.subarray(8).equals(expect));
+
+      N64.bswap64(data.subarray(0, 64), data.subarray(8));
+      assert(data.subarray(0, 64).equals(copy.subarray(0, 64)));
+    });
+
+    it('should split and join hi/lo words', () => {
+      for (const count of [0, 1, 4, 5, 37]) {
+        const src = random(count, 1);
+        const hi = new Int32Array(count);
+        const lo = new Uint32Array(count + 1);
+
+        assert.strictEqual(N64.split(hi, lo, src), count);
+
+        for (let i = 0; i < count; i++) {
+          const num = U64.readLE(src, i * 8);
+          assert.strictEqual(hi[i], num.hi | 0);
+          assert.strictEqual(lo[i], num.lo >>> 0);
+        }
+
+        const out = Buffer.alloc(count * 8 + 8, 0xff);
+
+        assert.strictEqual(N64.join(out, hi, lo.subarray(0, count)), out);
+        assert(out.subarray(0, count * 8).equals(src));
+        assert.strictEqual(out.readUInt32LE(count * 8), 0xffffffff);
+      }
+    });
+
+    it('should split and join arrays', () => {
+      const arr = new U64Array();
+      const rng = U64.rng(3);
+
+      for (let i = 0; i < 11; i++)
+        arr.push(rng.next());
+
+      const hi = new Int32Array(11);
+      const lo = new Int32Array(11);
+
+      N64.split(hi, lo, arr);
+
+      const out = new U64Array(11);
+
+      N64.join(out, hi, lo);
+
+      for (let i = 0; i < 11; i++) {
+        assert(out.get(i).eq(arr.get(i)));
+        assert.strictEqual(arr.get(i).hi | 0, hi[i]);
+      }
+
+      N64.bswap64(out);
+      N64.bswap64(out, out.toBuffer());
+
+      assert(out.get(10).eq(arr.get(10)));
+
+      // Words may alias their own source.
+      const words = new Int32Array(8);
+      words.set([1, 2, 3, 4, 5, 6, 7, 8]);
+
+      N64.split(words.subarray(4, 8), words.subarray(0, 4),
+                new Uint8Array(words.buffer, 0, 32));
+
+      assert.deepStrictEqual(Array.from(words), [1, 3, 5, 7, 2, 4, 6, 8]);
+
+      N64.join(new Uint8Array(words.buffer), words.subarray(4, 8),
+               words.subarray(0, 4));
+
+      assert.deepStrictEqual(Array.from(words), [1, 2, 3, 4, 5, 6, 7, 8]);
+    });
+
+    it('should reject bad buffers', () => {
+      const hi = new Int32Array(2);
+      const lo = new Int32Array(2);
+
+      assert.throws(() => N64.bswap64([1, 2]), TypeError);
+      assert.throws(() => N64.bswap64(Buffer.alloc(7)), /Invalid buffer length/);
+      assert.throws(() => N64.bswap64(Buffer.alloc(8), Buffer.alloc(16)),
+                    /Invalid range/);
+      assert.throws(() => N64.split([], lo, Buffer.alloc(16)), TypeError);
+      assert.throws(() => N64.split(hi, new Float64Array(2), Buffer.alloc(16)),
+                    TypeError);
+      assert.throws(() => N64.split(hi, lo, Buffer.alloc(12)),
+                    /Invalid buffer length/);
+      assert.throws(() => N64.split(hi, lo, Buffer.alloc(24)), /Invalid range/);
+      assert.throws(() => N64.split(hi, hi, Buffer.alloc(16)), /Invalid range/);
+      assert.throws(() => N64.join(Buffer.alloc(8), hi, lo), /Invalid range/);
+      assert.throws(() => N64.join(Buffer.alloc(16), hi, new Int32Array(1)),
+                    /Invalid range/);
+      assert.throws(() => N64.join(null, hi, lo), TypeError);
+    });
+  });
+}
+
+describe('Bulk (parity)', function() {
+  it('should match the other backend', () => {
+    const src = random(1001, 5);
+    const a = Buffer.alloc(src.length);
+    const b = Buffer.alloc(src.length);
+
+    n64.N64.bswap64(a, src);
+    native.N64.bswap64(b, src);
+
+    assert(a.equals(b));
+
+    const ha = new Int32Array(1001);
+    const la = new Int32Array(1001);
+    const hb = new Int32Array(1001);
+    const lb = new Int32Array(1001);
+
+    n64.N64.split(ha, la, src);
+    native.N64.split(hb, lb, src);
+
+    assert.deepStrictEqual(ha, hb);
+    assert.deepStrictEqual(la, lb);
+  });
+});
+
+run(n64, 'Bulk (JS)');
+run(native, 'Bulk (Native)');
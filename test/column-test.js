@@ -0,0 +1,186 @@
+/* eslint-env mocha */
+/* eslint prefer-arrow-callback: "off" */
+
+'use strict';
+
+const assert = require('assert');
+const n64 = require('../lib/n64');
+const native = require('../lib/native');
+
+function text(str) {
+  return Buffer.from(str, 'binary');
+}
+
+function bits(valid, length) {
+  const out = [];
+
+  for (let i = 0; i < length; i++)
+    out.push((valid[i >>> 3] >>> (i & 7)) & 1);
+
+  return out;
+}
+
+// Roughly 2mb of records of varying widths, so
+// that thread boundaries land everywhere.
+function sheet(rows) {
+  const rng = n64.U64.rng(7);
+  const lines = [];
+
+  for (let i = 0; i < rows; i++) {
+    const num = rng.next();
+    const pad = 'x'.repeat(i % 37);
+    const cell = i % 13 === 0 ? num.toString(16) + 'g' : num.toString(16);
+
+    lines.push(`${i}\t${pad}\t${cell}\t${num.toString()}`);
+  }
+
+  // One record much longer than a chunk.
+  lines[rows >>> 1] = `0\t${'y'.repeat(600 * 1024)}\t10\t16`;
+
+  return text(lines.join('\n'));
+}
+
+function run(n64, name) {
+  const {U64, I64, U64Array} = n64;
+
+  describe(name, function() {
+    it('should parse a column', () => {
+      const data = text('id,value,name\n'
+                      + '1,10,a\n'
+                      + '2,-1,b\r\n'
+                      + '3,,c\n'
+                      + '4\n'
+                      + '\n'
+                      + '5,18446744073709551616,d\n'
+                      + '6,42\r\n');
+
+      const {array, valid, invalid} = U64.parseColumn(data, {
+        column: 1,
+        header: true
+      });
+
+      assert.strictEqual(array.length, 7);
+      assert.strictEqual(invalid, 4);
+      assert.deepStrictEqual(bits(valid, 7), [1, 1, 0, 0, 0, 0, 1]);
+      assert.deepStrictEqual(array.toArray().map(String),
+        ['10', '18446744073709551615', '0', '0', '0', '0', '42']);
+
+      const ids = I64.parseColumn(data);
+
+      assert.strictEqual(ids.invalid, 2);
+      assert.deepStrictEqual(bits(ids.valid, 8), [0, 1, 1, 1, 1, 0, 1, 1]);
+      assert.strictEqual(ids.array.get(7).toNumber(), 6);
+    });
+
+    it('should handle delimiters and bases', () => {
+      const data = text('a\tff\n'
+                      + 'b\t-10\n'
+                      + 'c\t0x10\n'
+                      + 'd\tFF\n'
+                      + 'e\t\xff');
+
+      const {array, valid, invalid} = I64.parseColumn(data, {
+        delimiter: '\t',
+        column: 1,
+        base: 'hex'
+      });
+
+      assert.strictEqual(array.length, 5);
+      assert.strictEqual(invalid, 2);
+      assert.deepStrictEqual(bits(valid, 5), [1, 1, 0, 1, 0]);
+      assert.deepStrictEqual(array.toArray().map(Number),
+        [255, -16, 0, 255, 0]);
+
+      for (const str of ['', '\n', 'a,b\n']) {
+        const res = U64.parseColumn(text(str), { header: true });
+        assert.strictEqual(res.array.length, 0);
+        assert.strictEqual(res.valid.length, 0);
+        assert.strictEqual(res.invalid, 0);
+      }
+
+      const empty = U64.parseColumn(new Uint8Array(0));
+      assert.strictEqual(empty.array.length, 0);
+
+      const sub = U64.parseColumn(text('9\n1\n2\n').subarray(2, 5));
+      assert.deepStrictEqual(sub.array.toArray().map(Number), [1, 2]);
+    });
+
+    it('should split large inputs across threads', function() {
+      this.timeout(20000);
+
+      const data = sheet(40000);
+      const one = U64Array.parseColumn(data, { column: 2, base: 16 });
+
+      for (const threads of [2, 3, 8, 64, 100]) {
+        const many = U64Array.parseColumn(data, {
+          delimiter: '\t',
+          column: 2,
+          base: 16,
+          threads
+        });
+
+        const dec = U64Array.parseColumn(data, {
+          delimiter: '\t',
+          column: 3,
+          threads
+        });
+
+        assert.strictEqual(many.array.length, 40000);
+        assert.strictEqual(many.invalid, 3077);
+        assert.deepStrictEqual(many.valid, bitsFor(40000));
+        assert.strictEqual(dec.invalid, 0);
+
+        for (let i = 0; i < 40000; i++) {
+          if (i % 13 !== 0)
+            assert(many.array.get(i).eq(dec.array.get(i)), String(i));
+        }
+      }
+
+      // No tabs with the default delimiter.
+      assert.strictEqual(one.invalid, 40000);
+    });
+
+    it('should match the other backend', () => {
+      const data = sheet(5000);
+      const opts = { delimiter: '\t', column: 2, base: 16, threads: 4 };
+      const a = n64.U64.parseColumn(data, opts);
+      const b = native.U64.parseColumn(data, opts);
+
+      assert.strictEqual(a.invalid, b.invalid);
+      assert.deepStrictEqual(a.valid, b.valid);
+      assert.deepStrictEqual(a.array.toBuffer(), b.array.toBuffer());
+    });
+
+    it('should reject bad options', () => {
+      const data = text('1\n');
+
+      assert.throws(() => U64.parseColumn('1\n'), TypeError);
+      assert.throws(() => U64.parseColumn(data, 1), TypeError);
+      assert.throws(() => U64.parseColumn(data, { delimiter: ',,' }),
+                    TypeError);
+      assert.throws(() => U64.parseColumn(data, { delimiter: '\n' }),
+                    /Invalid delimiter/);
+      assert.throws(() => U64.parseColumn(data, { delimiter: 'é' }),
+                    /Invalid delimiter/);
+      assert.throws(() => U64.parseColumn(data, { column: -1 }), TypeError);
+      assert.throws(() => U64.parseColumn(data, { threads: 1.5 }), TypeError);
+      assert.throws(() => U64.parseColumn(data, { header: 1 }), TypeError);
+      assert.throws(() => U64.parseColumn(data, { base: 17 }), /Base ranges/);
+    });
+  });
+}
+
+// Every 13th row of sheet() holds a bad hex field.
+function bitsFor(rows) {
+  const valid = new Uint8Array((rows + 7) >>> 3);
+
+  for (let i = 0; i < rows; i++) {
+    if (i % 13 !== 0)
+      valid[i >>> 3] |= 1 << (i & 7);
+  }
+
+  return valid;
+}
+
+run(n64, 'Column (JS)');
+run(native, 'Column (Native)');
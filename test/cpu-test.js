@@ -0,0 +1,161 @@
+/* eslint-env mocha */
+/* eslint prefer-arrow-callback: "off" */
+
+'use strict';
+
+const assert = require('assert');
+const cp = require('child_process');
+const path = require('path');
+const n64 = require('../lib/n64');
+const native = require('../lib/native');
+
+const PATHS = ['scalar', 'sse2', 'ssse3', 'avx2', 'avx512', 'neon'];
+
+// Kernels are selected once at load time,
+// so forced runs happen in a child process.
+function spawn(code, force) {
+  const env = Object.assign({}, process.env);
+
+  delete env.N64_FORCE_SCALAR;
+
+  if (force)
+    env.N64_FORCE_SCALAR = '1';
+
+  const script = `
+    const n64 = require(${JSON.stringify(
+      path.resolve(__dirname, '../lib/native'))});
+    ${code}
+  `;
+
+  const out = cp.execFileSync(process.execPath, ['-e', script], { env });
+
+  return JSON.parse(out.toString('utf8'));
+}
+
+// Runs every dispatched kernel over
+// lengths and offsets which leave tails.
+const workload = `
+  const {N64, U64, I64, Dec64} = n64;
+  const rng = U64.rng(1);
+  const data = Buffer.alloc(8 * 67 + 1);
+  const out = {};
+
+  rng.fill(data);
+
+  for (const n of [0, 1, 3, 7, 16, 33, 67]) {
+    const src = data.subarray(1, 1 + n * 8);
+    const dst = Buffer.alloc(n * 8);
+    const hi = new Int32Array(n);
+    const lo = new Int32Array(n);
+    const u = new Float64Array(n);
+    const i = new Float64Array(n);
+
+    N64.bswap64(dst, src);
+    N64.split(hi, lo, src);
+    U64.toFloat64(u, src, Dec64.ROUND_HALF_EVEN);
+    I64.toFloat64(i, src, Dec64.ROUND_HALF_EVEN);
+
+    const joined = Buffer.alloc(n * 8);
+    const bits = Buffer.alloc((n + 7) >>> 3);
+    const ops = [];
+
+    N64.join(joined, hi, lo);
+
+    for (const op of ['lt', 'ne', 'between']) {
+      const a = n > 0 ? U64.readLE(src, (n >>> 1) * 8) : 0;
+
+      ops.push(U64.where(bits, src, op, a, U64.UINT64_MAX),
+               bits.toString('hex'),
+               I64.countWhere(src, op, a, I64.INT64_MAX));
+    }
+
+    const set = n > 0 ? [I64.readLE(src, 0), -1] : [-1];
+
+    ops.push(I64.where(bits, src, 'in', set), bits.toString('hex'));
+
+    out[n] = [
+      dst.toString('hex'),
+      Array.from(hi),
+      Array.from(lo),
+      Array.from(u),
+      Array.from(i),
+      joined.equals(src),
+      ops
+    ];
+  }
+
+  out.format = [];
+
+  for (let j = 0; j < 64; j++) {
+    const x = rng.next().ishrn(j);
+    const y = I64.fromBits(x.hi, x.lo);
+
+    out.format.push(x.toString(16), x.toString(2), x.toString(16, 20),
+                    y.toString(16), y.toString(2, 64));
+  }
+
+  out.cpu = N64.cpuFeatures();
+
+  process.stdout.write(JSON.stringify(out));
+`;
+
+describe('CPU', function() {
+  this.timeout(10000);
+
+  it('should report the selected kernels', () => {
+    for (const {N64} of [n64, native]) {
+      const cpu = N64.cpuFeatures();
+
+      assert(Array.isArray(cpu.features));
+      assert.strictEqual(typeof cpu.scalar, 'boolean');
+      assert.deepStrictEqual(Object.keys(cpu.kernels),
+                             ['bswap64', 'split', 'join', 'toFloat64',
+                              'format', 'where']);
+    }
+
+    assert.strictEqual(n64.N64.cpuFeatures().path, 'js');
+
+    const cpu = native.N64.cpuFeatures();
+
+    assert(PATHS.includes(cpu.path));
+    assert.strictEqual(cpu.kernels.bswap64, cpu.path);
+
+    for (const name of Object.keys(cpu.kernels)) {
+      const kernel = cpu.kernels[name];
+
+      assert(kernel === 'scalar' || kernel === 'bmi2' || PATHS.includes(kernel));
+
+      // Only paths the CPU supports are chosen, other
+      // than the compile-time baseline.
+      if (kernel !== 'scalar' && kernel !== 'sse2' && kernel !== 'neon')
+        assert(cpu.features.includes(kernel));
+    }
+  });
+
+  it('should force the scalar kernels', () => {
+    const out = spawn(workload, true);
+
+    assert.strictEqual(out.cpu.path, 'scalar');
+    assert.strictEqual(out.cpu.scalar, true);
+
+    for (const name of Object.keys(out.cpu.kernels))
+      assert.strictEqual(out.cpu.kernels[name], 'scalar');
+  });
+
+  it('should match the scalar kernels', () => {
+    const fast = spawn(workload, false);
+    const slow = spawn(workload, true);
+
+    assert.strictEqual(fast.cpu.scalar, false);
+
+    delete fast.cpu;
+    delete slow.cpu;
+
+    assert.deepStrictEqual(fast, slow);
+
+    for (const n of Object.keys(fast)) {
+      if (n !== 'format')
+        assert.strictEqual(fast[n][5], true);
+    }
+  });
+});
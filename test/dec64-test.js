@@ -0,0 +1,172 @@
+/* eslint-env mocha */
+/* eslint prefer-arrow-callback: "off" */
+
+'use strict';
+
+const assert = require('assert');
+const n64 = require('../lib/n64');
+const native = require('../lib/native');
+
+function run(n64, name) {
+  const {I64, Dec64} = n64;
+  const D = (str, scale) => Dec64.fromString(str, scale);
+
+  describe(name, function() {
+    it('should parse and serialize', () => {
+      assert.strictEqual(D('0').toString(), '0');
+      assert.strictEqual(D('-0.00').toString(), '0.00');
+      assert.strictEqual(D('1.5').toString(), '1.5');
+      assert.strictEqual(D('-.05').toString(), '-0.05');
+      assert.strictEqual(D('+12.').toString(), '12');
+      assert.strictEqual(D('12', 3).toString(), '12.000');
+      assert.strictEqual(D('12', 3).scale, 3);
+      assert.strictEqual(D('-9223372036854775808').toString(),
+                         '-9223372036854775808');
+      assert.strictEqual(D('9.223372036854775807').toString(),
+                         '9.223372036854775807');
+      assert.strictEqual(D('0.000000000000000001').scale, 18);
+      assert.strictEqual(JSON.stringify({a: D('1.10')}), '{"a":"1.10"}');
+
+      assert.throws(() => D(''), /Invalid/);
+      assert.throws(() => D('.'), /Invalid/);
+      assert.throws(() => D('1e5'), /Invalid/);
+      assert.throws(() => D('1.2.3'), /Invalid/);
+      assert.throws(() => D('9223372036854775808'), /overflow/);
+      assert.throws(() => D('0.0000000000000000001'), /Scale/);
+      assert.throws(() => D('1', 19));
+      assert.throws(() => D('1', 1.5));
+    });
+
+    it('should round when parsing', () => {
+      const cases = [
+        // value, DOWN, UP, FLOOR, CEIL, HALF_UP, HALF_DOWN, HALF_EVEN
+        ['1.25', '1.2', '1.3', '1.2', '1.3', '1.3', '1.2', '1.2'],
+        ['1.35', '1.3', '1.4', '1.3', '1.4', '1.4', '1.3', '1.4'],
+        ['1.251', '1.2', '1.3', '1.2', '1.3', '1.3', '1.3', '1.3'],
+        ['-1.25', '-1.2', '-1.3', '-1.3', '-1.2', '-1.3', '-1.2', '-1.2'],
+        ['-1.24', '-1.2', '-1.3', '-1.3', '-1.2', '-1.2', '-1.2', '-1.2'],
+        ['1.20', '1.2', '1.2', '1.2', '1.2', '1.2', '1.2', '1.2']
+      ];
+
+      for (const [str, ...expect] of cases) {
+        for (let mode = 0; mode < 7; mode++) {
+          const num = Dec64.fromString(str, 1, mode);
+          assert.strictEqual(num.toString(), expect[mode], `${str} ${mode}`);
+        }
+      }
+
+      assert.strictEqual(Dec64.fromString('-0.01', 1, Dec64.ROUND_DOWN)
+                              .toString(), '0.0');
+      assert.throws(() => Dec64.fromString('1', 0, 7));
+    });
+
+    it('should add and subtract', () => {
+      assert.strictEqual(D('1.5').add(D('2.25')).toString(), '3.75');
+      assert.strictEqual(D('1.5').sub(D('2.25')).toString(), '-0.75');
+      assert.strictEqual(D('-1').isub(D('-1')).toString(), '0');
+
+      const num = D('1.5');
+      assert.strictEqual(num.iadd(D('0.001')), num);
+      assert.strictEqual(num.toString(), '1.501');
+
+      const min = Dec64.fromI64(I64.INT64_MIN);
+      const max = Dec64.fromI64(I64.INT64_MAX);
+
+      assert.strictEqual(D('-1').sub(min).toString(), '9223372036854775807');
+      assert.throws(() => max.add(D('1')), /overflow/);
+      assert.throws(() => min.sub(D('1')), /overflow/);
+      assert.throws(() => D('0').sub(min), /overflow/);
+      assert.throws(() => D('1').add(D('9.223372036854775807')), /overflow/);
+    });
+
+    it('should multiply with 128 bit intermediates', () => {
+      assert.strictEqual(D('1.5').mul(D('2.25')).toString(), '3.4');
+      assert.strictEqual(D('1.50').mul(D('-2')).toString(), '-3.00');
+      assert.strictEqual(D('0.05').mul(D('0.5')).toString(), '0.02');
+      assert.strictEqual(D('0.05').mul(D('0.5'), Dec64.ROUND_HALF_UP)
+                                  .toString(), '0.03');
+      assert.strictEqual(D('-0.01').mul(D('0.1'), Dec64.ROUND_FLOOR)
+                                   .toString(), '-0.01');
+
+      // Raw product is ~8.5e37 but the result fits.
+      const big = D('9223372036.854775807');
+      assert.strictEqual(big.mul(D('0.000000001')).toString(),
+                         '9.223372037');
+      assert.strictEqual(big.mul(D('0.000000001'), Dec64.ROUND_DOWN)
+                            .toString(), '9.223372036');
+      assert.strictEqual(big.mul(D('1.000000000')).toString(),
+                         big.toString());
+
+      assert.throws(() => big.mul(D('2')), /overflow/);
+    });
+
+    it('should divide with 128 bit intermediates', () => {
+      assert.strictEqual(D('1.00').div(D('3')).toString(), '0.33');
+      assert.strictEqual(D('2.00').div(D('3')).toString(), '0.67');
+      assert.strictEqual(D('2.00').div(D('3'), Dec64.ROUND_DOWN).toString(),
+                         '0.66');
+      assert.strictEqual(D('-1.00').div(D('8')).toString(), '-0.12');
+      assert.strictEqual(D('-1.00').div(D('8'), Dec64.ROUND_HALF_UP)
+                                   .toString(), '-0.13');
+      assert.strictEqual(D('1').div(D('0.001')).toString(), '1000');
+      assert.strictEqual(D('9.223372036854775807').div(D('3.000000000'))
+                                                  .toString(),
+                         '3.074457345618258602');
+
+      assert.throws(() => D('1').div(D('0.00')), /divide by zero/);
+      assert.throws(() => D('9223372036854775807').div(D('0.5')), /overflow/);
+    });
+
+    it('should rescale', () => {
+      assert.strictEqual(D('1.005').rescale(2).toString(), '1.00');
+      assert.strictEqual(D('1.015').rescale(2).toString(), '1.02');
+      assert.strictEqual(D('1.005').rescale(2, Dec64.ROUND_UP).toString(),
+                         '1.01');
+      assert.strictEqual(D('1.5').rescale(4).toString(), '1.5000');
+      assert.strictEqual(D('-1.5').rescale(0).toString(), '-2');
+      assert.strictEqual(D('-2.5').rescale(0).toString(), '-2');
+
+      const num = D('1.5');
+      assert.strictEqual(num.irescale(3), num);
+      assert.strictEqual(num.scale, 3);
+
+      assert.throws(() => D('9223372036').rescale(10), /overflow/);
+    });
+
+    it('should compare', () => {
+      assert.strictEqual(D('1.5').cmp(D('1.50')), 0);
+      assert(D('1.5').eq(D('1.500')));
+      assert(D('1.49').lt(D('1.5')));
+      assert(D('-1.49').gt(D('-1.5')));
+      assert(D('-0.001').lt(D('0')));
+      assert(D('0.00').lte(D('0')));
+      assert(D('0.001').gte(D('0')));
+      assert(D('9.223372036854775807').lt(D('10')));
+      assert(D('-9.223372036854775808').gt(D('-10')));
+      assert(D('0').isZero());
+      assert(D('-0.1').isNeg());
+      assert(!D('0.1').isNeg());
+    });
+
+    it('should negate and convert', () => {
+      assert.strictEqual(D('1.5').neg().toString(), '-1.5');
+      assert.strictEqual(D('-1.5').abs().toString(), '1.5');
+      assert.throws(() => Dec64.fromI64(I64.INT64_MIN).neg(), /overflow/);
+
+      const num = Dec64.fromI64(I64.fromNumber(-12345), 2);
+      assert.strictEqual(num.toString(), '-123.45');
+      assert.strictEqual(num.toI64().toString(), '-12345');
+      assert.strictEqual(num.toDouble(), -123.45);
+      assert.strictEqual(Dec64.fromI64(7, 1).toString(), '0.7');
+
+      const copy = num.clone();
+      copy.iadd(D('1'));
+      assert.strictEqual(num.toString(), '-123.45');
+      assert.strictEqual(copy.toString(), '-122.45');
+      assert.strictEqual(Dec64.fromJSON('1.25').toJSON(), '1.25');
+    });
+  });
+}
+
+run(n64, 'Dec64 (JS)');
+run(native, 'Dec64 (Native)');
@@ -0,0 +1,306 @@
+/* eslint-env mocha */
+/* eslint prefer-arrow-callback: "off" */
+
+'use strict';
+
+const assert = require('assert');
+const n64 = require('../lib/n64');
+const native = require('../lib/native');
+const {words, read} = require('./util/words');
+
+const {
+  ROUND_DOWN,
+  ROUND_UP,
+  ROUND_FLOOR,
+  ROUND_CEIL,
+  ROUND_HALF_UP,
+  ROUND_HALF_DOWN,
+  ROUND_HALF_EVEN
+} = n64.Dec64;
+
+const MODES = [
+  ROUND_DOWN,
+  ROUND_UP,
+  ROUND_FLOOR,
+  ROUND_CEIL,
+  ROUND_HALF_UP,
+  ROUND_HALF_DOWN,
+  ROUND_HALF_EVEN
+];
+
+// 2^53 + 1 and friends sit halfway between doubles;
+// 2^53 + 3 sits halfway the other way.
+const EDGES = [
+  ['9007199254740991', 9007199254740991],
+  ['9007199254740993', [
+    9007199254740992, // down
+    9007199254740994, // up
+    9007199254740992, // floor
+    9007199254740994, // ceil
+    9007199254740994, // half up
+    9007199254740992, // half down
+    9007199254740992  // half even
+  ]],
+  ['9007199254740995', [
+    9007199254740994,
+    9007199254740996,
+    9007199254740994,
+    9007199254740996,
+    9007199254740996,
+    9007199254740994,
+    9007199254740996
+  ]],
+  ['-9007199254740993', [
+    -9007199254740992,
+    -9007199254740994,
+    -9007199254740994,
+    -9007199254740992,
+    -9007199254740994,
+    -9007199254740992,
+    -9007199254740992
+  ]],
+  ['9223372036854775807', [
+    9223372036854774784,
+    9223372036854775808,
+    9223372036854774784,
+    9223372036854775808,
+    9223372036854775808,
+    9223372036854775808,
+    9223372036854775808
+  ]],
+  ['-9223372036854775808', -9223372036854775808]
+];
+
+function run(n64, name) {
+  const {U64, I64, I64Array} = n64;
+
+  describe(name, function() {
+    it('should convert safe integers', () => {
+      const values = ['0', '1', '-1', '9007199254740991', '-9007199254740991'];
+      const src = words(I64, values);
+      const dst = new Float64Array(values.length + 1);
+
+      const bad = I64.toFloat64(dst, src);
+
+      assert(bad instanceof Uint32Array);
+      assert.strictEqual(bad.length, 0);
+      assert.deepStrictEqual(Array.from(dst), [0, 1, -1,
+        9007199254740991, -9007199254740991, 0]);
+
+      const out = Buffer.alloc(src.length);
+
+      assert.strictEqual(I64.fromFloat64(out, dst.subarray(0, 5)).length, 0);
+      assert(out.equals(src));
+
+      // Unsigned, negative words are unsafe.
+      assert.deepStrictEqual(Array.from(U64.toFloat64(dst, src)), [2, 4]);
+      assert(Number.isNaN(dst[2]));
+      assert.strictEqual(dst[3], 9007199254740991);
+
+      // And writes it back wrapped.
+      assert.strictEqual(U64.fromFloat64(out, new Float64Array([-1])).length, 0);
+      assert.strictEqual(U64.readLE(out, 0).toString(), '18446744073709551615');
+    });
+
+    it('should report unsafe values in strict mode', () => {
+      const src = words(I64, EDGES.map(([str]) => str));
+      const dst = new Float64Array(EDGES.length);
+
+      assert.deepStrictEqual(Array.from(I64.toFloat64(dst, src)),
+                             [1, 2, 3, 4, 5]);
+
+      assert.strictEqual(dst[0], 9007199254740991);
+
+      for (let i = 1; i < EDGES.length; i++)
+        assert(Number.isNaN(dst[i]));
+
+      const doubles = new Float64Array([
+        1, 0.5, -2, NaN, Infinity, 2 ** 53, -(2 ** 53), 2 ** 53 - 1
+      ]);
+
+      const out = Buffer.alloc(64, 0xff);
+
+      assert.deepStrictEqual(Array.from(I64.fromFloat64(out, doubles)),
+                             [1, 3, 4, 5, 6]);
+      assert.deepStrictEqual(read(I64, out),
+        ['1', '0', '-2', '0', '0', '0', '0', '9007199254740991']);
+    });
+
+    it('should round in lossy mode', () => {
+      const src = words(I64, EDGES.map(([str]) => str));
+      const dst = new Float64Array(EDGES.length);
+
+      for (let m = 0; m < MODES.length; m++) {
+        assert.strictEqual(I64.toFloat64(dst, src, MODES[m]).length, 0);
+
+        for (let i = 0; i < EDGES.length; i++) {
+          const expect = EDGES[i][1];
+          const value = Array.isArray(expect) ? expect[m] : expect;
+
+          assert.strictEqual(dst[i], value, `${EDGES[i][0]} (${m})`);
+        }
+      }
+
+      // The top of the unsigned range rounds to 2^64.
+      const max = words(U64, ['18446744073709551615']);
+
+      U64.toFloat64(dst, max, ROUND_DOWN);
+      assert.strictEqual(dst[0], 18446744073709549568);
+
+      U64.toFloat64(dst, max, ROUND_HALF_UP);
+      assert.strictEqual(dst[0], 18446744073709551616);
+    });
+
+    it('should round and saturate doubles', () => {
+      const doubles = new Float64Array([
+        2.5, -2.5, 3.5, 0.5, -0.5, 1.25, -1.75
+      ]);
+
+      const expect = [
+        ['2', '-2', '3', '0', '0', '1', '-1'],
+        ['3', '-3', '4', '1', '-1', '2', '-2'],
+        ['2', '-3', '3', '0', '-1', '1', '-2'],
+        ['3', '-2', '4', '1', '0', '2', '-1'],
+        ['3', '-3', '4', '1', '-1', '1', '-2'],
+        ['2', '-2', '3', '0', '0', '1', '-2'],
+        ['2', '-2', '4', '0', '0', '1', '-2']
+      ];
+
+      const out = Buffer.alloc(doubles.length * 8);
+
+      for (let m = 0; m < MODES.length; m++) {
+        assert.strictEqual(I64.fromFloat64(out, doubles, MODES[m]).length, 0);
+        assert.deepStrictEqual(read(I64, out), expect[m]);
+      }
+
+      const wide = new Float64Array([
+        NaN, Infinity, -Infinity, 2 ** 63, -(2 ** 63), 2 ** 64, -0.25, 2 ** 60
+      ]);
+
+      const buf = Buffer.alloc(wide.length * 8);
+
+      assert.deepStrictEqual(Array.from(I64.fromFloat64(buf, wide, ROUND_DOWN)),
+                             [0, 1, 2, 3, 5]);
+      assert.deepStrictEqual(read(I64, buf), [
+        '0',
+        '9223372036854775807',
+        '-9223372036854775808',
+        '9223372036854775807',
+        '-9223372036854775808',
+        '9223372036854775807',
+        '0',
+        '1152921504606846976'
+      ]);
+
+      assert.deepStrictEqual(Array.from(U64.fromFloat64(buf, wide, ROUND_DOWN)),
+                             [0, 1, 2, 4, 5]);
+      assert.deepStrictEqual(read(U64, buf), [
+        '0',
+        '18446744073709551615',
+        '0',
+        '9223372036854775808',
+        '0',
+        '18446744073709551615',
+        '0',
+        '1152921504606846976'
+      ]);
+
+      // -0.25 floors to -1, below zero.
+      assert.deepStrictEqual(
+        Array.from(U64.fromFloat64(buf, wide.subarray(6), ROUND_FLOOR)), [0]);
+    });
+
+    it('should convert in place', () => {
+      for (const count of [3, 64, 150]) {
+        const rng = I64.rng(count);
+        const arr = new I64Array(count);
+        const values = [];
+
+        for (let i = 0; i < count; i++) {
+          const num = rng.next().ishrn(i % 20);
+          arr.set(i, num);
+          values.push(num.toDouble());
+        }
+
+        const buf = arr.toBuffer();
+        const view = new Float64Array(buf.buffer, buf.byteOffset, count);
+
+        I64.toFloat64(view, arr, ROUND_HALF_EVEN);
+
+        assert.deepStrictEqual(Array.from(view), values);
+
+        I64.fromFloat64(arr, view, ROUND_DOWN);
+
+        for (let i = 0; i < count; i++)
+          assert.strictEqual(arr.get(i).toDouble(), values[i]);
+      }
+
+      // Partial overlaps behave like a copy.
+      const data = new Float64Array([1, 2, 3, 4, 5]);
+      const bytes = new Uint8Array(data.buffer, 8, 32);
+
+      I64.fromFloat64(bytes, data.subarray(0, 4));
+
+      assert.deepStrictEqual(read(I64, Buffer.from(bytes)), ['1', '2', '3', '4']);
+    });
+
+    it('should reject bad arguments', () => {
+      const dst = new Float64Array(2);
+
+      assert.throws(() => U64.toFloat64([], Buffer.alloc(16)), TypeError);
+      assert.throws(() => U64.toFloat64(dst, []), TypeError);
+      assert.throws(() => U64.toFloat64(dst, Buffer.alloc(12)),
+                    /Invalid buffer length/);
+      assert.throws(() => U64.toFloat64(dst, Buffer.alloc(24)),
+                    /Invalid range/);
+      assert.throws(() => U64.toFloat64(dst, Buffer.alloc(16), 7), TypeError);
+      assert.throws(() => U64.toFloat64(dst, Buffer.alloc(16), 'up'),
+                    TypeError);
+      assert.throws(() => U64.fromFloat64(Buffer.alloc(16), [1, 2]),
+                    TypeError);
+      assert.throws(() => U64.fromFloat64(null, dst), TypeError);
+      assert.throws(() => U64.fromFloat64(Buffer.alloc(8), dst),
+                    /Invalid range/);
+      assert.throws(() => I64.fromFloat64(Buffer.alloc(16), dst, -1),
+                    TypeError);
+    });
+  });
+}
+
+describe('Float64 (parity)', function() {
+  it('should match the other backend', () => {
+    const rng = n64.U64.rng(11);
+    const src = Buffer.alloc(1001 * 8);
+    const doubles = new Float64Array(1001);
+
+    for (let i = 0; i < 1001; i++) {
+      const num = rng.next().ishrn(i % 64);
+      num.writeLE(src, i * 8);
+      doubles[i] = (i & 1 ? -1 : 1) * num.toDouble() / (1 + (i % 5));
+    }
+
+    doubles[7] = NaN;
+    doubles[8] = -0;
+
+    for (const mode of [null, ...MODES]) {
+      for (const Num of ['U64', 'I64']) {
+        const a = new Float64Array(1001);
+        const b = new Float64Array(1001);
+
+        assert.deepStrictEqual(n64[Num].toFloat64(a, src, mode),
+                               native[Num].toFloat64(b, src, mode));
+        assert.deepStrictEqual(a, b);
+
+        const x = Buffer.alloc(src.length);
+        const y = Buffer.alloc(src.length);
+
+        assert.deepStrictEqual(n64[Num].fromFloat64(x, doubles, mode),
+                               native[Num].fromFloat64(y, doubles, mode));
+        assert(x.equals(y));
+      }
+    }
+  });
+});
+
+run(n64, 'Float64 (JS)');
+run(native, 'Float64 (Native)');
@@ -4,6 +4,19 @@ const assert = require('assert');
 const n64 = require('../lib/n64');
 const native = require('../lib/native');
 
+// Each backend is checked against native.
+const backends = [['js', n64]];
+
+if (typeof BigInt === 'function')
+  backends.push(['bigint', require('../lib/bigint')]);
+
+const targets = [];
+
+for (const [name, lib] of backends) {
+  for (const type of ['U64', 'I64'])
+    targets.push([type, name, lib]);
+}
+
 const singleOps = [
   'sqr',
   'not',
@@ -70,6 +83,14 @@ const numberOps = [
   'set'
 ];
 
+const decimalOps = [
+  'add',
+  'sub',
+  'mul',
+  'div',
+  'cmp'
+];
+
 const numberOpsRes = [
   'cmpn',
   'eqn',
@@ -82,6 +103,18 @@ const numberOpsRes = [
   'andln'
 ];
 
+const mathOps = [
+  'sqrt',
+  'cbrt',
+  'log2',
+  'log10',
+  'gcd',
+  'lcm',
+  'isPowerOfTwo',
+  'nextPowerOfTwo',
+  'divmod'
+];
+
 function random32() {
   // Throw a zero in every so often.
   if (((Math.random() * 10000) | 0) === 0)
@@ -117,11 +150,11 @@ for (const low of [false, true]) {
   console.log('Fuzzing with %s values.', low ? 'low' : 'high');
 
   // Single param ops
-  for (const type of ['U64', 'I64']) {
-    const A = n64[type];
+  for (const [type, name, lib] of targets) {
+    const A = lib[type];
     const B = native[type];
 
-    console.log('Fuzzing single param ops (%s).', type);
+    console.log('Fuzzing single param ops (%s, %s).', type, name);
 
     for (let i = 0; i < iterations; i++) {
       const n1 = random64(low);
@@ -139,6 +172,7 @@ for (const low of [false, true]) {
           console.error({
             number: a1.toString(),
             type: type,
+            backend: name,
             operation: op,
             result: a.toString(),
             expect: b.toString()
@@ -149,11 +183,12 @@ for (const low of [false, true]) {
   }
 
   // Single param ops with primitive result
-  for (const type of ['U64', 'I64']) {
-    const A = n64[type];
+  for (const [type, name, lib] of targets) {
+    const A = lib[type];
     const B = native[type];
 
-    console.log('Fuzzing single param ops w/ primitive result (%s).', type);
+    console.log('Fuzzing single param ops w/ primitive result (%s, %s).',
+                type, name);
 
     for (let i = 0; i < iterations; i++) {
       const n1 = random64(low);
@@ -171,6 +206,7 @@ for (const low of [false, true]) {
           console.error({
             number: a1.toString(),
             type: type,
+            backend: name,
             operation: op,
             result: a,
             expect: b
@@ -181,11 +217,11 @@ for (const low of [false, true]) {
   }
 
   // Double param ops
-  for (const type of ['U64', 'I64']) {
-    const A = n64[type];
+  for (const [type, name, lib] of targets) {
+    const A = lib[type];
     const B = native[type];
 
-    console.log('Fuzzing double param ops (%s).', type);
+    console.log('Fuzzing double param ops (%s, %s).', type, name);
 
     for (let i = 0; i < iterations; i++) {
       const n1 = random64(low);
@@ -212,6 +248,7 @@ for (const low of [false, true]) {
             number: a1.toString(),
             operand: a2.toString(),
             type: type,
+            backend: name,
             operation: op,
             result: a.toString(),
             expect: b.toString()
@@ -222,11 +259,12 @@ for (const low of [false, true]) {
   }
 
   // Double param ops with primitive result
-  for (const type of ['U64', 'I64']) {
-    const A = n64[type];
+  for (const [type, name, lib] of targets) {
+    const A = lib[type];
     const B = native[type];
 
-    console.log('Fuzzing double param ops w/ primitive result (%s).', type);
+    console.log('Fuzzing double param ops w/ primitive result (%s, %s).',
+                type, name);
 
     for (let i = 0; i < iterations; i++) {
       const n1 = random64(low);
@@ -250,6 +288,7 @@ for (const low of [false, true]) {
             number: a1.toString(),
             operand: a2.toString(),
             type: type,
+            backend: name,
             operation: op,
             result: a,
             expect: b
@@ -260,11 +299,11 @@ for (const low of [false, true]) {
   }
 
   // Number ops
-  for (const type of ['U64', 'I64']) {
-    const A = n64[type];
+  for (const [type, name, lib] of targets) {
+    const A = lib[type];
     const B = native[type];
 
-    console.log('Fuzzing number ops (%s).', type);
+    console.log('Fuzzing number ops (%s, %s).', type, name);
 
     for (let i = 0; i < iterations; i++) {
       const n1 = random64(low);
@@ -290,6 +329,7 @@ for (const low of [false, true]) {
             number: a1.toString(),
             operand: num,
             type: type,
+            backend: name,
             operation: op,
             result: a.toString(),
             expect: b.toString()
@@ -300,11 +340,11 @@ for (const low of [false, true]) {
   }
 
   // Number ops with primitive result
-  for (const type of ['U64', 'I64']) {
-    const A = n64[type];
+  for (const [type, name, lib] of targets) {
+    const A = lib[type];
     const B = native[type];
 
-    console.log('Fuzzing number ops w/ primitive result (%s).', type);
+    console.log('Fuzzing number ops w/ primitive result (%s, %s).', type, name);
 
     for (let i = 0; i < iterations; i++) {
       const n1 = random64(low);
@@ -324,6 +364,7 @@ for (const low of [false, true]) {
             number: a1.toString(),
             operand: num,
             type: type,
+            backend: name,
             operation: op,
             result: a.toString(),
             expect: b.toString()
@@ -332,6 +373,190 @@ for (const low of [false, true]) {
       }
     }
   }
+
+  // Integer math ops
+  for (const [type, name, lib] of targets) {
+    const A = lib[type];
+    const B = native[type];
+
+    console.log('Fuzzing integer math ops (%s, %s).', type, name);
+
+    const attempt = (func) => {
+      try {
+        const r = func();
+        return Array.isArray(r) ? r.join(',') : String(r);
+      } catch (e) {
+        return e.message;
+      }
+    };
+
+    for (let i = 0; i < iterations; i++) {
+      const n1 = random64(low);
+      const n2 = random64(low || random2());
+      const a1 = A.fromObject(n1);
+      const a2 = A.fromObject(n2);
+      const b1 = B.fromObject(n1);
+      const b2 = B.fromObject(n2);
+
+      for (const op of mathOps) {
+        const a = attempt(() => a1[op](a2));
+        const b = attempt(() => b1[op](b2));
+
+        if (a !== b) {
+          console.error('Integer math operation failed!');
+          console.error({
+            number: a1.toString(),
+            operand: a2.toString(),
+            type: type,
+            backend: name,
+            operation: op,
+            result: a,
+            expect: b
+          });
+        }
+      }
+    }
+  }
+
+  // 128 bit ops
+  for (const type of ['U128', 'I128']) {
+    const A = n64[type];
+    const B = native[type];
+
+    console.log('Fuzzing 128 bit ops (%s).', type);
+
+    const attempt = (func) => {
+      try {
+        const r = func();
+        return typeof r === 'object' ? r.toString(16) : String(r);
+      } catch (e) {
+        return e.message;
+      }
+    };
+
+    const random128 = () => {
+      const n1 = random64(low);
+      const n2 = random64(low || random2());
+      return [n2.hi, n2.lo, n1.hi, n1.lo];
+    };
+
+    for (let i = 0; i < iterations; i++) {
+      const w1 = random128();
+      const w2 = random128();
+      const a1 = A.fromBits(...w1);
+      const a2 = A.fromBits(...w2);
+      const b1 = B.fromBits(...w1);
+      const b2 = B.fromBits(...w2);
+      const num = random32() >>> 0;
+
+      for (const op of doubleOps.concat(doubleOpsRes)) {
+        const a = attempt(() => a1[op](a2));
+        const b = attempt(() => b1[op](b2));
+
+        if (a !== b) {
+          console.error('128 bit operation failed!');
+          console.error({
+            number: a1.toString(),
+            operand: a2.toString(),
+            type: type,
+            operation: op,
+            result: a,
+            expect: b
+          });
+        }
+      }
+
+      for (const op of numberOps.concat(numberOpsRes)) {
+        if (op === 'set')
+          continue;
+
+        const a = attempt(() => a1[op](num, 1));
+        const b = attempt(() => b1[op](num, 1));
+
+        if (a !== b) {
+          console.error('128 bit number operation failed!');
+          console.error({
+            number: a1.toString(),
+            operand: num,
+            type: type,
+            operation: op,
+            result: a,
+            expect: b
+          });
+        }
+      }
+
+      for (const op of singleOpsRes.concat('toU64', 'toI64')) {
+        const a = attempt(() => a1[op]());
+        const b = attempt(() => b1[op]());
+
+        if (a !== b) {
+          console.error('128 bit operation failed!');
+          console.error({
+            number: a1.toString(),
+            type: type,
+            operation: op,
+            result: a,
+            expect: b
+          });
+        }
+      }
+    }
+  }
+
+  // Decimal ops
+  {
+    console.log('Fuzzing decimal ops.');
+
+    const attempt = (func) => {
+      try {
+        return String(func());
+      } catch (e) {
+        return e.message;
+      }
+    };
+
+    for (let i = 0; i < iterations; i++) {
+      const n1 = random64(low);
+      const n2 = random64(low);
+      const s1 = (Math.random() * 19) | 0;
+      const s2 = (Math.random() * 19) | 0;
+      const mode = (Math.random() * 7) | 0;
+      const a1 = n64.Dec64.fromI64(n64.I64.fromObject(n1), s1);
+      const a2 = n64.Dec64.fromI64(n64.I64.fromObject(n2), s2);
+      const b1 = native.Dec64.fromI64(native.I64.fromObject(n1), s1);
+      const b2 = native.Dec64.fromI64(native.I64.fromObject(n2), s2);
+
+      assert.strictEqual(a1.toString(), b1.toString());
+
+      for (const op of decimalOps.concat('rescale', 'fromString')) {
+        let a, b;
+
+        if (op === 'rescale') {
+          a = attempt(() => a1.rescale(s2, mode));
+          b = attempt(() => b1.rescale(s2, mode));
+        } else if (op === 'fromString') {
+          a = attempt(() => n64.Dec64.fromString(a1.toString(), s2, mode));
+          b = attempt(() => native.Dec64.fromString(b1.toString(), s2, mode));
+        } else {
+          a = attempt(() => a1[op](a2, mode));
+          b = attempt(() => b1[op](b2, mode));
+        }
+
+        if (a !== b) {
+          console.error('Decimal operation failed!');
+          console.error({
+            number: a1.toString(),
+            operand: a2.toString(),
+            operation: op,
+            mode: mode,
+            result: a,
+            expect: b
+          });
+        }
+      }
+    }
+  }
 }
 
 console.log('Fuzzing complete.');
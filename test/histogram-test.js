@@ -0,0 +1,383 @@
+/* eslint-env mocha */
+/* eslint prefer-arrow-callback: "off" */
+
+'use strict';
+
+const assert = require('assert');
+const n64 = require('../lib/n64');
+const native = require('../lib/native');
+const {words} = require('./util/words');
+
+const U64_MAX = '18446744073709551615';
+
+// The value at `p` percent of a sorted list,
+// counting as the histogram does.
+function rank(sorted, p) {
+  const want = Math.max(1, Math.floor((p / 100) * sorted.length + 0.5));
+  return sorted[Math.min(want, sorted.length) - 1];
+}
+
+function run(n64, name) {
+  const {U64, I64, U64Array, Histogram, serialize, deserialize} = n64;
+
+  describe(name, function() {
+    it('should compute percentiles within precision', () => {
+      const h = U64.histogram({ highest: 3600e9, significantDigits: 3 });
+      const rng = U64.rng(1);
+      const values = [];
+
+      for (let i = 0; i < 20000; i++) {
+        const v = rng.nextBelow(1e9).toNumber();
+        values.push(v);
+        h.record(U64(v));
+      }
+
+      values.sort((a, b) => a - b);
+
+      assert.strictEqual(h.count().toNumber(), values.length);
+      assert.strictEqual(h.min().toNumber(), values[0]);
+      assert.strictEqual(h.max().toNumber(), values[values.length - 1]);
+
+      for (const p of [0, 1, 10, 50, 90, 99, 99.9, 99.99, 100]) {
+        const want = rank(values, p);
+        const got = h.percentile(p).toNumber();
+
+        assert(got >= want, `p${p}: ${got} < ${want}`);
+        assert(got - want <= want / 1000, `p${p}: ${got} - ${want}`);
+      }
+
+      assert.strictEqual(h.percentile(100).toNumber(),
+                         values[values.length - 1]);
+
+      const mean = values.reduce((a, b) => a + b, 0) / values.length;
+
+      assert(Math.abs(h.mean() - mean) <= mean / 1000);
+    });
+
+    it('should keep unit resolution for small values', () => {
+      const h = U64.histogram({ highest: 1e6, significantDigits: 2 });
+
+      for (let i = 0; i < 200; i++)
+        h.record(i);
+
+      assert.strictEqual(h.percentile(50).toNumber(), 99);
+      assert.strictEqual(h.percentile(0.5).toNumber(), 0);
+      assert.strictEqual(h.percentile(100).toNumber(), 199);
+      assert.strictEqual(h.mean(), 99.5);
+    });
+
+    it('should record counts and other operands', () => {
+      const h = I64.histogram({ lowest: 1000, highest: 1e12 });
+
+      h.record(5000, 3);
+      h.record(I64(7000), U64(2));
+      h.record({ hi: 0, lo: 9000 });
+      h.record(I64(1), 0);
+
+      assert.strictEqual(h.count().toNumber(), 6);
+      assert(U64.isU64(h.count()));
+      assert(I64.isI64(h.min()));
+      assert(I64.isI64(h.percentile(50)));
+      assert.strictEqual(h.min().toNumber(), 5000);
+      assert.strictEqual(h.max().toNumber(), 9000);
+      assert.strictEqual(h.percentile(50).toNumber(), 5119);
+
+      const out = I64(0);
+
+      assert.strictEqual(h.percentile(100, out), out);
+      assert.strictEqual(out.toNumber(), 9000);
+
+      // Values below the unit share its first slot.
+      h.record(1);
+
+      assert.strictEqual(h.min().toNumber(), 1);
+      assert.strictEqual(h.percentile(0).toNumber(), 511);
+    });
+
+    it('should reject values out of range', () => {
+      const u = U64.histogram({ highest: 1000 });
+      const i = I64.histogram({ highest: 1000 });
+
+      assert.throws(() => u.record(1e6), /out of range/);
+      assert.throws(() => u.record(U64.UINT64_MAX), /out of range/);
+      assert.throws(() => i.record(-1), /out of range/);
+      assert.throws(() => i.record(I64.INT64_MIN), /out of range/);
+
+      // The last bucket extends past `highest`.
+      u.record(1023);
+
+      assert.strictEqual(u.count().toNumber(), 1);
+      assert.strictEqual(i.count().toNumber(), 0);
+
+      // The same bits are in range unsigned.
+      const w = U64.histogram({ highest: U64.UINT64_MAX });
+
+      w.record(I64(-1));
+
+      assert.strictEqual(w.max().toString(), U64_MAX);
+      assert.strictEqual(w.percentile(100).toString(), U64_MAX);
+      assert.strictEqual(w.percentile(50).toString(), U64_MAX);
+    });
+
+    it('should validate options', () => {
+      assert.throws(() => U64.histogram({ lowest: 0 }), /range/);
+      assert.throws(() => U64.histogram({ lowest: 10, highest: 19 }), /range/);
+      assert.throws(() => U64.histogram({
+        lowest: 2 ** 50,
+        significantDigits: 5
+      }), /range/);
+      assert.throws(() => U64.histogram({ significantDigits: 0 }), /digits/);
+      assert.throws(() => U64.histogram({ significantDigits: 6 }), /digits/);
+      assert.throws(() => U64.histogram({ significantDigits: 1.5 }), /integer/);
+      assert.throws(() => U64.histogram().percentile(101), /percentage/);
+      assert.throws(() => U64.histogram().percentile(NaN), /percentage/);
+      assert.throws(() => U64.histogram().merge({}), /histogram/);
+
+      U64.histogram({ lowest: 10, highest: 20 });
+      U64.histogram({ lowest: U64(2 ** 20), highest: U64.UINT64_MAX });
+    });
+
+    it('should record many values', () => {
+      const h = I64.histogram({ highest: 1e9 });
+      const data = words(I64, [5, -1, 10, 2e9, 10, 0]);
+      const bad = h.recordMany(data);
+
+      assert(bad instanceof Uint32Array);
+      assert.deepStrictEqual(Array.from(bad), [1, 3]);
+      assert.strictEqual(h.count().toNumber(), 4);
+      assert.strictEqual(h.min().toNumber(), 0);
+      assert.strictEqual(h.max().toNumber(), 10);
+
+      const arr = U64Array.from([7, 8, 9]);
+
+      assert.strictEqual(h.recordMany(arr).length, 0);
+      assert.strictEqual(h.recordMany(new BigUint64Array([3n])).length, 0);
+      assert.strictEqual(h.count().toNumber(), 8);
+      assert.strictEqual(h.recordMany(Buffer.alloc(0)).length, 0);
+      assert.throws(() => h.recordMany(Buffer.alloc(9)), /buffer length/);
+    });
+
+    it('should report an empty histogram', () => {
+      const h = U64.histogram();
+
+      assert.strictEqual(h.count().toNumber(), 0);
+      assert.strictEqual(h.min().toNumber(), 0);
+      assert.strictEqual(h.max().toNumber(), 0);
+      assert.strictEqual(h.percentile(99).toNumber(), 0);
+      assert.strictEqual(h.mean(), 0);
+
+      h.record(5).reset();
+
+      assert.strictEqual(h.count().toNumber(), 0);
+      assert.strictEqual(h.max().toNumber(), 0);
+    });
+
+    it('should merge histograms', () => {
+      const a = U64.histogram({ highest: 1e9 });
+      const b = U64.histogram({ highest: 1e9 });
+      const c = U64.histogram({
+        lowest: 1000,
+        highest: 1e12,
+        significantDigits: 2
+      });
+
+      for (let i = 1; i <= 1000; i++) {
+        a.record(i * 1000);
+        b.record(i * 1000 + 500000);
+        c.record(i * 10000);
+      }
+
+      const ab = a.clone().merge(b);
+
+      assert.strictEqual(ab.count().toNumber(), 2000);
+      assert.strictEqual(ab.min().toNumber(), 1000);
+      assert.strictEqual(ab.max().toNumber(), 1500000);
+      assert.strictEqual(a.count().toNumber(), 1000);
+
+      // Different layouts are folded in by value.
+      const ac = a.clone().merge(c);
+
+      assert.strictEqual(ac.count().toNumber(), 2000);
+      assert.strictEqual(ac.max().toNumber(), 10000000);
+      assert(Math.abs(ac.percentile(75).toNumber() - 5e6) <= 5e6 / 50);
+
+      const self = b.clone();
+
+      self.merge(self);
+
+      assert.strictEqual(self.count().toNumber(), 2000);
+      assert.strictEqual(self.percentile(50).toString(),
+                         b.percentile(50).toString());
+
+      // Nothing is merged if anything is out of range.
+      const small = U64.histogram({ highest: 1e6 });
+
+      small.record(1);
+
+      assert.throws(() => small.merge(c), /out of range/);
+      assert.strictEqual(small.count().toNumber(), 1);
+
+      const signed = I64.histogram({ highest: U64.UINT64_MAX });
+      const big = U64.histogram({ highest: U64.UINT64_MAX });
+
+      big.record(U64.UINT64_MAX);
+
+      assert.throws(() => signed.merge(big), /out of range/);
+      assert.strictEqual(signed.merge(U64.histogram()).count().toNumber(), 0);
+    });
+
+    it('should serialize histograms', () => {
+      const h = I64.histogram({
+        lowest: 10,
+        highest: 1e12,
+        significantDigits: 4
+      });
+      const rng = U64.rng(2);
+
+      for (let i = 0; i < 1000; i++)
+        h.record(rng.nextBelow(1e9), 1 + (i & 3));
+
+      const data = serialize(h);
+      const out = deserialize(data);
+
+      assert(data instanceof Uint8Array);
+      assert(out instanceof Histogram);
+      assert.strictEqual(data[0], 7);
+      assert.strictEqual(Buffer.from(data).readUInt32LE(4), data.length - 8);
+
+      // Far smaller than the counters themselves.
+      assert(data.length < 1000 * 6);
+
+      assert.strictEqual(out.count().toString(), h.count().toString());
+      assert(I64.isI64(out.min()));
+
+      for (const p of [0, 25, 50, 99, 99.9, 100])
+        assert.strictEqual(out.percentile(p).toString(),
+                           h.percentile(p).toString());
+
+      assert.strictEqual(out.mean(), h.mean());
+      assert.deepStrictEqual(serialize(out), data);
+
+      const empty = deserialize(serialize(U64.histogram()));
+
+      assert.strictEqual(empty.count().toNumber(), 0);
+      assert(U64.isU64(empty.max()));
+      assert.strictEqual(deserialize(serialize(empty)).count().toNumber(), 0);
+
+      // Recording continues after a round trip.
+      out.record(5);
+
+      assert.strictEqual(out.min().toNumber(), 5);
+    });
+
+    it('should reject malformed messages', () => {
+      const h = U64.histogram({ highest: 1e6 });
+
+      h.record(1).record(100000);
+
+      const data = serialize(h);
+
+      for (let i = 8; i < data.length; i++) {
+        const copy = new Uint8Array(data.slice(0, i));
+
+        copy[4] = i - 8;
+
+        assert.throws(() => deserialize(copy), /Invalid message/);
+      }
+
+      const long = new Uint8Array(data.length + 1);
+
+      long.set(data);
+      long[4] += 1;
+
+      assert.throws(() => deserialize(long), /Invalid message/);
+
+      const digits = new Uint8Array(data);
+
+      digits[8] = 9;
+
+      assert.throws(() => deserialize(digits), /Invalid message/);
+
+      const short = new Uint8Array(data);
+
+      short[4] += 1;
+
+      assert.throws(() => deserialize(short), /Invalid message/);
+    });
+
+    it('should clone histograms', () => {
+      const h = U64.histogram({ highest: 1e6 });
+
+      h.record(10);
+
+      const c = h.clone();
+
+      c.record(20);
+
+      assert.strictEqual(h.count().toNumber(), 1);
+      assert.strictEqual(c.count().toNumber(), 2);
+      assert.strictEqual(c.max().toNumber(), 20);
+      assert(U64.isU64(c.max()));
+    });
+  });
+}
+
+run(n64, 'Histogram (JS)');
+run(native, 'Histogram (Native)');
+
+describe('Histogram (parity)', function() {
+  it('should match between backends', () => {
+    const rng = n64.U64.rng(3);
+    const data = Buffer.alloc(8 * 2000);
+
+    rng.fill(data);
+
+    // Spread the values over every bucket.
+    for (let i = 0; i < 2000; i++)
+      data[i * 8 + 7] >>>= i % 64;
+
+    const max = n64.U64.UINT64_MAX;
+
+    for (const Num of ['U64', 'I64']) {
+      const layouts = [
+        { highest: max, significantDigits: 1 },
+        { lowest: 1000, highest: max },
+        { lowest: 3, highest: 1e15, significantDigits: 4 }
+      ];
+
+      for (const options of layouts) {
+        const x = n64[Num].histogram(options);
+        const y = native[Num].histogram(options);
+
+        assert.deepStrictEqual(x.recordMany(data), y.recordMany(data));
+
+        x.record(12345, n64.U64.UINT64_MAX);
+        y.record(12345, native.U64.UINT64_MAX);
+
+        for (const p of [0, 0.1, 1, 33.3, 50, 90, 99, 99.99, 100]) {
+          assert.strictEqual(x.percentile(p).toString(),
+                             y.percentile(p).toString());
+        }
+
+        assert.strictEqual(x.count().toString(), y.count().toString());
+        assert.strictEqual(x.min().toString(), y.min().toString());
+        assert.strictEqual(x.max().toString(), y.max().toString());
+        assert.strictEqual(x.mean(), y.mean());
+
+        const a = n64.serialize(x);
+        const b = native.serialize(y);
+
+        assert.deepStrictEqual(Buffer.from(a), Buffer.from(b));
+        assert.deepStrictEqual(native.serialize(native.deserialize(a)), b);
+        assert.deepStrictEqual(n64.serialize(n64.deserialize(b)), a);
+
+        const other = { lowest: 7, highest: max, significantDigits: 2 };
+        const mx = n64[Num].histogram(other).merge(x);
+        const my = native[Num].histogram(other).merge(y);
+
+        assert.deepStrictEqual(Buffer.from(n64.serialize(mx)),
+                               Buffer.from(native.serialize(my)));
+      }
+    }
+  });
+});
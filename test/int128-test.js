@@ -0,0 +1,383 @@
+/* eslint-env mocha */
+/* eslint prefer-arrow-callback: "off" */
+
+'use strict';
+
+const assert = require('assert');
+const BN = require('../vendor/bn.js');
+const n64 = require('../lib/n64');
+const native = require('../lib/native');
+
+const MOD = new BN(1).iushln(128);
+
+function wrap(num, sign) {
+  const r = num.umod(MOD);
+
+  if (sign && r.testn(127))
+    return r.isub(MOD);
+
+  return r;
+}
+
+function run(n64, name) {
+  const {N128, U128, I128, U64, I64} = n64;
+  const MAX_U128 = '340282366920938463463374607431768211455';
+  const MIN_I128 = '-170141183460469231731687303715884105728';
+  const MAX_I128 = '170141183460469231731687303715884105727';
+
+  describe(name, function() {
+    it('should instantiate and serialize', () => {
+      const num = U128.UINT128_MAX;
+
+      assert.strictEqual(num.toString(), MAX_U128);
+      assert.strictEqual(num.toString(16), 'f'.repeat(32));
+      assert.strictEqual(num.toString(2), '1'.repeat(128));
+      assert.strictEqual(I128.INT128_MIN.toString(), MIN_I128);
+      assert.strictEqual(I128.INT128_MAX.toString(), MAX_I128);
+      assert.strictEqual(I128.INT128_MIN.toString(16),
+                         '-8' + '0'.repeat(31));
+      assert.strictEqual(U128.fromInt(255).toString(16, 8), '000000ff');
+      assert.strictEqual(U128.fromInt(1).toJSON(), '0'.repeat(31) + '1');
+      assert.strictEqual(I128.fromJSON(I128.fromInt(-2).toJSON()).toString(),
+                         '-2');
+      assert.strictEqual(U128.fromInt(7).inspect(), '<U128: 7>');
+      assert.strictEqual(I128(MIN_I128).toString(), MIN_I128);
+      assert.strictEqual(U128(MAX_U128).toString(), MAX_U128);
+      assert.strictEqual(U128('1f', 16).toString(), '31');
+    });
+
+    it('should have instance', () => {
+      const num = I128.fromInt(1);
+
+      assert.strictEqual(N128.isN128(num), true);
+      assert.strictEqual(I128.isI128(num), true);
+      assert.strictEqual(U128.isU128(num), false);
+      assert.strictEqual(N128.isN128(I64.fromInt(1)), false);
+      assert.strictEqual(num.sign, 1);
+      assert.strictEqual(U128.fromInt(1).sign, 0);
+    });
+
+    it('should deserialize strings', () => {
+      assert.strictEqual(U128.fromString('f'.repeat(32), 16).toString(),
+                         MAX_U128);
+      assert.strictEqual(I128.fromString('-1').toString(16), '-1');
+      assert.strictEqual(U128.fromString('-1').toString(), MAX_U128);
+
+      assert.throws(() => U128.fromString('1'.repeat(129), 2),
+                    /bad length/);
+      assert.throws(() => U128.fromString('1' + '0'.repeat(128), 2),
+                    /bad length/);
+      assert.throws(() => U128.fromString(MAX_U128 + '0'), /overflow/);
+      assert.throws(() => U128.fromString('340282366920938463463374607431768211456'),
+                    /overflow/);
+      assert.throws(() => U128.fromString('12a'), /parse error/);
+      assert.throws(() => U128.fromString(''), /bad length/);
+      assert.throws(() => U128.fromString('1', 17), /Base/);
+
+      assert.strictEqual(U128.tryFromString('12a'), null);
+      assert.strictEqual(U128.tryFromString({}), null);
+      assert.strictEqual(U128.tryFromString('12').toString(), '12');
+    });
+
+    it('should do arithmetic', () => {
+      const a = U128.fromString('123456789abcdef0123456789abcdef', 16);
+      const b = U128.fromString('fedcba9876543210', 16);
+
+      assert.strictEqual(a.add(b).toString(16),
+                         '123456789abcdefffffffffffffffff');
+      assert.strictEqual(a.sub(b).toString(16),
+                         '123456789abcdee02468acf13579bdf');
+      assert.strictEqual(a.mul(b).toString(16),
+                         '2358d29092d964322236d88fe5618cf0');
+      assert.strictEqual(a.div(b).toString(16), '124924924924923');
+      assert.strictEqual(a.mod(b).toString(16), '7f598f328cc265bf');
+      assert.strictEqual(U128.UINT128_MAX.addn(1).toString(), '0');
+      assert.strictEqual(U128.UINT128_MIN.subn(1).toString(), MAX_U128);
+      assert.strictEqual(U128.pow(10, 38).toString(), '1' + '0'.repeat(38));
+      assert.strictEqual(U128.pow(2, 128).toString(), '0');
+      assert.strictEqual(U128.fromInt(0).pown(0).toString(), '0');
+      assert.strictEqual(I128.pow(-3, 3).toString(), '-27');
+    });
+
+    it('should divide with int128 min edge cases', () => {
+      const min = I128.INT128_MIN;
+
+      assert.strictEqual(min.divn(-1).toString(), MIN_I128);
+      assert.strictEqual(min.modn(-1).toString(), '0');
+      assert.strictEqual(min.divn(2).toString(),
+                         '-85070591730234615865843651857942052864');
+      assert.strictEqual(min.div(min).toString(), '1');
+      assert.strictEqual(I128.fromInt(-7).divn(2).toString(), '-3');
+      assert.strictEqual(I128.fromInt(-7).modn(2).toString(), '-1');
+      assert.strictEqual(I128.fromInt(7).divn(-2).toString(), '-3');
+      assert.strictEqual(I128.fromInt(7).modn(-2).toString(), '1');
+
+      // Unsigned, -2 is a huge divisor.
+      assert.strictEqual(U128.fromInt(7).divn(-2).toString(), '0');
+
+      assert.throws(() => min.divn(0), /divide by zero/);
+      assert.throws(() => min.mod(I128.fromInt(0)), /divide by zero/);
+      assert.strictEqual(min.tryDiv(I128.fromInt(0)), null);
+      assert.strictEqual(min.clone().tryIdiv(I128.fromInt(0)), false);
+    });
+
+    it('should do bit operations', () => {
+      const num = U128.fromInt(1).ishln(127);
+
+      assert.strictEqual(num.testn(127), 1);
+      assert.strictEqual(num.bitLength(), 128);
+      assert.strictEqual(num.byteLength(), 16);
+      assert.strictEqual(num.ushrn(127).toString(), '1');
+      assert.strictEqual(num.toI128().shrn(127).toString(), '-1');
+      assert.strictEqual(num.toI128().ushrn(127).toString(), '1');
+      assert.strictEqual(num.shln(1).toString(), '0');
+      assert.strictEqual(num.shln(128).eq(num), true);
+      assert.strictEqual(U128.fromInt(1).setn(100, 1).toString(16),
+                         '1' + '0'.repeat(24) + '1');
+      assert.strictEqual(U128.UINT128_MAX.maskn(65).toString(16),
+                         '1' + 'f'.repeat(16));
+      assert.strictEqual(U128.UINT128_MAX.maskn(64).toString(16),
+                         'f'.repeat(16));
+      assert.strictEqual(U128.fromInt(0).setb(15, 0xab).getb(15), 0xab);
+      assert.strictEqual(U128.fromInt(0).orb(8, 1).toString(16),
+                         '1' + '0'.repeat(16));
+      assert.strictEqual(I128.fromInt(-1).andn(0xff).toString(), '255');
+      assert.strictEqual(I128.fromInt(0).orn(-1).toString(), '-1');
+      assert.strictEqual(U128.fromInt(0).orn(-1).toString(), '4294967295');
+      assert.strictEqual(U128.UINT128_MAX.not().isZero(), true);
+      assert.strictEqual(I128.fromInt(-5).neg().toString(), '5');
+      assert.strictEqual(I128.fromInt(-5).abs().toString(), '5');
+      assert.strictEqual(I128.fromInt(-1).bitLength(), 1);
+      assert.strictEqual(I128.INT128_MIN.bitLength(), 128);
+    });
+
+    it('should do comparisons', () => {
+      const neg = I128.fromInt(-1);
+      const big = I128.INT128_MAX;
+
+      assert.strictEqual(neg.cmp(big), -1);
+      assert.strictEqual(neg.toU128().cmp(big.toU128()), 1);
+      assert.strictEqual(neg.ltn(0), true);
+      assert.strictEqual(neg.toU128().gtn(0), true);
+      assert.strictEqual(neg.eqn(-1), true);
+      assert.strictEqual(neg.toU128().eqn(-1), false);
+      assert.strictEqual(U128.fromInt(5).cmpn(5), 0);
+      assert.strictEqual(N128.max(neg, big), big);
+      assert.strictEqual(N128.min(neg, big), neg);
+      assert.strictEqual(neg.isNeg(), true);
+      assert.strictEqual(neg.toU128().isNeg(), false);
+      assert.strictEqual(neg.isOdd(), true);
+      assert.strictEqual(neg.isEven(), false);
+    });
+
+    it('should convert to numbers', () => {
+      const safe = I128.fromNumber(-Number.MAX_SAFE_INTEGER);
+
+      assert.strictEqual(safe.toNumber(), -Number.MAX_SAFE_INTEGER);
+      assert.strictEqual(safe.isSafe(), true);
+      assert.strictEqual(safe.subn(1).isSafe(), false);
+      assert.throws(() => safe.subn(1).toNumber(), /53 bits/);
+      assert(Number.isNaN(safe.subn(1).tryToNumber()));
+      assert.throws(() => U128.fromNumber(2 ** 53));
+      assert.strictEqual(U128.tryFromNumber(0.5), null);
+      assert.strictEqual(U128.fromNumber(-1).toString(), MAX_U128);
+
+      // Rounded once, half to even.
+      assert.strictEqual(U128.UINT128_MAX.toDouble(), 2 ** 128);
+      assert.strictEqual(I128.INT128_MIN.toDouble(), -(2 ** 127));
+      assert.strictEqual(U128.fromString('9007199254740993').toDouble(),
+                         9007199254740992);
+      assert.strictEqual(U128.fromString('9007199254740995').toDouble(),
+                         9007199254740996);
+      assert.strictEqual(U128.fromString('20000000000001', 16).ishln(64)
+                                                              .iaddn(1)
+                                                              .toDouble(),
+                         (2 ** 53 + 2) * 2 ** 64);
+
+      assert.strictEqual(I128.fromInt(-2).toInt(), -2);
+      assert.strictEqual(U128.fromInt(-2).toInt(), 0xfffffffe);
+      assert.strictEqual(U128.fromInt(0).toBool(), false);
+      assert.strictEqual(U128.fromBool(true).toNumber(), 1);
+    });
+
+    it('should encode and decode', () => {
+      const num = I128.fromString('-123456789012345678901234567890');
+      const le = num.toLE(Buffer);
+      const be = num.toBE(Buffer);
+
+      assert.strictEqual(le.length, 16);
+      assert.strictEqual(le.toString('hex'),
+        Buffer.from(be).reverse().toString('hex'));
+      assert.strictEqual(be.toString('hex'),
+                         'fffffffe7116f0093c8c1f11b1c0f52e');
+      assert(I128.fromLE(le).eq(num));
+      assert(I128.fromBE(be).eq(num));
+      assert(I128.readRaw(num.toRaw(Buffer), 0).eq(num));
+
+      const bits = num.toBits();
+
+      assert.deepStrictEqual(bits, [-2, 0x7116f009, 0x3c8c1f11, -0x4e3f0ad2]);
+      assert(I128.fromBits(...bits).eq(num));
+
+      const obj = num.toObject();
+
+      assert(I64.isI64(obj.hi));
+      assert(U64.isU64(obj.lo));
+      assert.strictEqual(obj.hi.toString(), '-6692605943');
+      assert(I128.fromObject(obj).eq(num));
+      assert(I128.from(obj).eq(num));
+      assert(I128.from(le).eq(num));
+      assert(I128.from(num).eq(num));
+
+      assert.throws(() => num.writeLE(Buffer.alloc(16), 1), TypeError);
+      assert.throws(() => I128.readBE(Buffer.alloc(15), 0), TypeError);
+    });
+
+    it('should convert to and from bn.js', () => {
+      const num = I128.INT128_MIN;
+
+      assert.strictEqual(num.toBN(BN).toString(), MIN_I128);
+      assert.strictEqual(I128.fromBN(num.toBN(BN).iaddn(1)).toString(),
+                         num.addn(1).toString());
+      assert.strictEqual(U128.fromBN(new BN(MAX_U128)).toString(), MAX_U128);
+      assert.throws(() => U128.fromBN(new BN(MAX_U128).iaddn(1)),
+                    /Big number overflow/);
+      assert.throws(() => I128.fromBN(new BN(MAX_I128).iaddn(1)),
+                    /Big number overflow/);
+    });
+
+    it('should widen from 64 bits', () => {
+      const max = U64.UINT64_MAX;
+      const min = I64.INT64_MIN;
+
+      assert.strictEqual(max.toU128().toString(), '18446744073709551615');
+      assert.strictEqual(max.toI128().toString(), '18446744073709551615');
+      assert.strictEqual(min.toI128().toString(), '-9223372036854775808');
+      assert.strictEqual(I64.fromInt(5).toU128().toString(), '5');
+      assert.throws(() => min.toU128(), /out of range/);
+      assert.throws(() => U128.fromN64(I64.fromInt(-1)), /out of range/);
+      assert.strictEqual(I128.fromN64(I64.fromInt(-1)).toString(), '-1');
+      assert.strictEqual(I128.from(min).toString(), '-9223372036854775808');
+      assert.throws(() => I128.fromN64(I128.fromInt(1)), TypeError);
+    });
+
+    it('should narrow to 64 bits', () => {
+      const cases = [
+        // value, fits U64, fits I64
+        ['0', true, true],
+        ['-1', false, true],
+        ['9223372036854775807', true, true],
+        ['9223372036854775808', true, false],
+        ['18446744073709551615', true, false],
+        ['18446744073709551616', false, false],
+        ['-9223372036854775808', false, true],
+        ['-9223372036854775809', false, false],
+        [MIN_I128, false, false]
+      ];
+
+      for (const [str, u, i] of cases) {
+        const num = I128.fromString(str);
+
+        assert.strictEqual(num.tryToU64() !== null, u, str);
+        assert.strictEqual(num.tryToI64() !== null, i, str);
+
+        if (u)
+          assert.strictEqual(num.toU64().toString(), str);
+        else
+          assert.throws(() => num.toU64(), /out of range/);
+
+        if (i)
+          assert.strictEqual(num.toI64().toString(), str);
+        else
+          assert.throws(() => num.toI64(), /out of range/);
+      }
+
+      // An unsigned value is never negative.
+      assert.strictEqual(U128.UINT128_MAX.tryToI64(), null);
+      assert.strictEqual(U128.UINT128_MAX.ushrn(64).toU64().toString(),
+                         '18446744073709551615');
+    });
+
+    it('should match bn.js', () => {
+      const rng = U64.rng(128);
+
+      for (const Num of [U128, I128]) {
+        for (let i = 0; i < 500; i++) {
+          const a = Num.fromObject({ hi: rng.next(), lo: rng.next() })
+                       .iushrn(i % 128);
+          const b = Num.fromObject({ hi: rng.next(), lo: rng.next() })
+                       .iushrn((i * 7) % 128);
+          const x = a.toBN(BN);
+          const y = b.toBN(BN);
+          const sign = a.sign;
+
+          assert.strictEqual(a.add(b).toString(),
+                             wrap(x.add(y), sign).toString());
+          assert.strictEqual(a.sub(b).toString(),
+                             wrap(x.sub(y), sign).toString());
+          assert.strictEqual(a.mul(b).toString(),
+                             wrap(x.mul(y), sign).toString());
+          assert.strictEqual(a.shln(i % 128).toString(),
+                             wrap(x.ushln(i % 128), sign).toString());
+
+          if (!b.isZero()) {
+            const q = x.div(y);
+
+            assert.strictEqual(a.div(b).toString(), wrap(q, sign).toString());
+            assert.strictEqual(a.mod(b).toString(),
+                               wrap(x.sub(q.mul(y)), sign).toString());
+          }
+
+          assert.strictEqual(a.toString(7), x.toString(7));
+          assert.strictEqual(Num.fromString(x.toString(3), 3).eq(a), true);
+          assert.strictEqual(a.cmp(b), x.cmp(y));
+        }
+      }
+    });
+
+    it('should reject bad arguments', () => {
+      const num = U128.fromInt(1);
+
+      assert.throws(() => num.iadd(U64.fromInt(1)), TypeError);
+      assert.throws(() => num.cmp(1), TypeError);
+      assert.throws(() => num.toString(17), /Base/);
+      assert.throws(() => num.toString(10, 129), /Maximum padding/);
+      assert.throws(() => U128.fromObject({ hi: 1, lo: 2 }), TypeError);
+      assert.throws(() => U128.from(Symbol('x')), TypeError);
+    });
+  });
+}
+
+describe('Int128 (parity)', function() {
+  it('should match the other backend', () => {
+    const rng = n64.U64.rng(1280);
+
+    for (const Num of ['U128', 'I128']) {
+      for (let i = 0; i < 1000; i++) {
+        const hi = rng.next();
+        const lo = rng.next();
+        const d = rng.next().iushrn(i % 64);
+        const a = n64[Num].fromObject({ hi, lo }).iushrn(i % 100);
+        const b = native[Num].fromObject({
+          hi: native.U64.fromBits(hi.hi, hi.lo),
+          lo: native.U64.fromBits(lo.hi, lo.lo)
+        }).iushrn(i % 100);
+
+        assert.strictEqual(a.toString(16), b.toString(16));
+        assert.strictEqual(a.toDouble(), b.toDouble());
+        assert.strictEqual(a.toString(10), b.toString(10));
+
+        const x = n64[Num].fromN64(d);
+        const y = native[Num].fromN64(native.U64.fromBits(d.hi, d.lo));
+
+        if (!x.isZero()) {
+          assert.strictEqual(a.div(x).toString(), b.div(y).toString());
+          assert.strictEqual(a.mod(x).toString(), b.mod(y).toString());
+        }
+      }
+    }
+  });
+});
+
+run(n64, 'Int128 (JS)');
+run(native, 'Int128 (Native)');
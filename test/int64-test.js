@@ -4,9 +4,12 @@
 'use strict';
 
 const assert = require('assert');
+const cp = require('child_process');
+const path = require('path');
 const BN = require('../vendor/bn.js');
 const n64 = require('../lib/n64');
 const native = require('../lib/native');
+const bigint = require('../lib/bigint');
 
 function run(n64, name) {
   const {N64, U64, I64} = n64;
@@ -200,6 +203,19 @@ function run(n64, name) {
       assert.strictEqual(num.toString(), '18446744073709551615');
     });
 
+    it('should change sign in place', () => {
+      const num = U64.fromString('ffffffffffffffff', 16);
+      num.sign = 1;
+      assert.strictEqual(num.sign, 1);
+      assert.strictEqual(num.isNeg(), true);
+      assert.strictEqual(num.toString(), '-1');
+      assert.strictEqual(num.addn(2).toString(), '1');
+      num.sign = 0;
+      assert.strictEqual(num.sign, 0);
+      assert.strictEqual(num.toString(), '18446744073709551615');
+      assert.strictEqual(num.isNeg(), false);
+    });
+
     it('should handle uint64 max as string', () => {
       const num = U64.fromString('ffffffffffffffff', 16);
       assert.strictEqual(num.lo, -1);
@@ -872,6 +888,46 @@ function run(n64, name) {
       assert.strictEqual(a.toString(), '429496729600');
     });
 
+    it('should divide by wide divisors', () => {
+      const cases = [
+        ['ffffffffffffffff', '100000001', 'ffffffff', '0'],
+        ['ffffffffffffffff', '100000000', 'ffffffff', 'ffffffff'],
+        ['fffffffffffffffe', 'ffffffff', '100000000', 'fffffffe'],
+        ['fedcba9876543210', '123456789', 'e0000000', '96543210'],
+        ['ffffffffffffffff', '8000000000000001', '1', '7ffffffffffffffe'],
+        ['8000000000000000', '7fffffffffffffff', '1', '1']
+      ];
+
+      for (const [x, y, q, r] of cases) {
+        const a = U64.fromString(x, 16);
+        const b = U64.fromString(y, 16);
+
+        assert.strictEqual(a.div(b).toString(16), q);
+        assert.strictEqual(a.mod(b).toString(16), r);
+      }
+
+      const a = I64.fromString('-7edcba9876543210', 16);
+      const b = I64.fromString('123456789', 16);
+
+      assert.strictEqual(a.div(b).toString(), '-1870659584');
+      assert.strictEqual(a.mod(b).toString(), '-1255420432');
+      assert.strictEqual(a.div(b.neg()).toString(), '1870659584');
+      assert.strictEqual(a.mod(b.neg()).toString(), '-1255420432');
+    });
+
+    it('should serialize strings across chunks', () => {
+      const a = U64.fromString('1000000000000000000');
+
+      assert.strictEqual(a.toString(16), 'de0b6b3a7640000');
+      assert.strictEqual(a.toString(8), '67405553164731000000');
+      assert.strictEqual(U64.fromString('9007199254740992').toString(2),
+                         '1' + '0'.repeat(53));
+      assert.strictEqual(U64.fromString('9007199254740991').toString(16),
+                         '1fffffffffffff');
+      assert.strictEqual(I64.fromString('-1000000000000000001').toString(),
+                         '-1000000000000000001');
+    });
+
     it('should do small pow (unsigned)', () => {
       let a = U64.fromNumber(123);
       let b = U64.fromNumber(6);
@@ -1817,8 +1873,95 @@ function run(n64, name) {
       const result = number.pown(operand);
       assert.strictEqual(result.toString(10), '3719928238591852881');
     });
+
+    // The BigInt backend has no RNG.
+    if (n64.RNG) {
+      it('should generate seeded random numbers', () => {
+        const rng = U64.rng(42);
+        const out = new U64();
+
+        assert.strictEqual(rng.next().toString(16), '15780b2e0c2ec716');
+        assert.strictEqual(rng.next(out), out);
+        assert.strictEqual(out.toString(16), '6104d9866d113a7e');
+        assert.strictEqual(rng.next().toString(16), 'ae17533239e499a1');
+
+        assert(I64.rng(42).next() instanceof I64);
+        assert.strictEqual(I64.rng(42).next().toString(16), '15780b2e0c2ec716');
+        assert.strictEqual(U64.rng(I64(42)).next().toString(16),
+                           '15780b2e0c2ec716');
+
+        const jumped = U64.rng(42).jump();
+        assert.strictEqual(jumped.next().toString(16), '50086ef83cbf4f4a');
+
+        const a = U64.rng(1337);
+        const b = a.clone();
+        assert(a.next().eq(b.next()));
+      });
+
+      it('should generate bounded random numbers', () => {
+        const rng = U64.rng(1);
+        const bound = U64.fromString('fffffffffffffff0', 16);
+
+        for (let i = 0; i < 1000; i++) {
+          assert(rng.nextBelow(10).ltn(10));
+          assert(rng.nextBelow(bound).lt(bound));
+        }
+
+        assert.strictEqual(rng.nextBelow(1).toString(), '0');
+        assert.throws(() => rng.nextBelow(0));
+      });
+
+      it('should reject bounds below one', () => {
+        const rng = I64.rng(7);
+
+        for (const bound of [0, -5, I64(-5), I64.INT64_MIN, U64(0)]) {
+          assert.throws(() => rng.nextBelow(bound),
+                        /^RangeError: Bound must be positive\.$/);
+        }
+
+        // Unsigned bounds are never negative.
+        const bound = U64.fromString('8000000000000000', 16);
+
+        assert(rng.nextBelow(bound).toU64().lt(bound));
+        assert(I64.rng(7).nextBelow(5).gten(0));
+      });
+
+      it('should fill buffers with random numbers', () => {
+        const data = Buffer.alloc(19);
+
+        U64.rng(42).fill(data);
+
+        assert.strictEqual(data.toString('hex'),
+          '16c72e0c2e0b78157e3a116d86d90461a199e4');
+
+        const words = new Uint32Array(4);
+
+        assert.strictEqual(U64.rng(42).fill(words), words);
+        assert.strictEqual(words[0], 0x0c2ec716);
+        assert.strictEqual(words[1], 0x15780b2e);
+      });
+    }
   });
 }
 
 run(n64, 'n64 (JS)');
 run(native, 'n64 (Native)');
+run(bigint, 'n64 (BigInt)');
+
+describe('n64 (Native, without eval)', function() {
+  this.timeout(10000);
+
+  it('should load without code generation', () => {
+    const script = `
+      const {U64, I64} = require(${JSON.stringify(
+        path.resolve(__dirname, '../lib/native'))});
+      const [q, r] = I64(-9).divmod(I64(2));
+      process.stdout.write([q, r, U64(81).isqrt()].join(' '));
+    `;
+
+    const out = cp.execFileSync(process.execPath,
+      ['--disallow-code-generation-from-strings', '-e', script]);
+
+    assert.strictEqual(out.toString('utf8'), '-4 -1 9');
+  });
+});
@@ -0,0 +1,227 @@
+/* eslint-env mocha */
+/* eslint prefer-arrow-callback: "off" */
+
+'use strict';
+
+const assert = require('assert');
+const n64 = require('../lib/n64');
+const native = require('../lib/native');
+const {words} = require('./util/words');
+
+function read(arr) {
+  return arr.toArray().map(num => num.toString());
+}
+
+function run(n64, name) {
+  const {U64, I64, U64Array, I64Array} = n64;
+
+  describe(name, function() {
+    describe('writeDecimal/writeHex', function() {
+      it('should format into a buffer', () => {
+        const data = Buffer.alloc(48, 0x20);
+
+        let off = 0;
+
+        off = I64.fromString('-9223372036854775808').writeDecimal(data, off);
+        assert.strictEqual(off, 20);
+
+        off = U64.UINT64_MAX.writeDecimal(data, off);
+        assert.strictEqual(off, 40);
+
+        off = U64(255).writeHex(data, off, 4);
+        assert.strictEqual(off, 44);
+
+        assert.strictEqual(data.toString('latin1'),
+          '-922337203685477580818446744073709551615' + '00ff    ');
+      });
+
+      it('should match toString', () => {
+        const data = Buffer.alloc(70);
+        const nums = [U64(0), U64(1), I64(-1), U64(1e15), I64(-123456789),
+                      U64.fromString('12345678901234567890'), I64.INT64_MAX];
+
+        for (const num of nums) {
+          for (const pad of [0, 1, 20, 64]) {
+            let n = num.writeDecimal(data, 1, pad);
+            assert.strictEqual(data.toString('latin1', 1, n),
+                               num.toString(10, pad));
+
+            n = num.writeHex(data, 3, pad);
+            assert.strictEqual(data.toString('latin1', 3, n),
+                               num.toString(16, pad));
+          }
+        }
+      });
+
+      it('should reject bad arguments', () => {
+        const num = U64(12345);
+
+        assert.throws(() => num.writeDecimal([], 0),
+                      /'data' must be a\(n\) buffer/);
+        assert.throws(() => num.writeDecimal(Buffer.alloc(8), -1),
+                      /'offset' must be a\(n\) integer/);
+        assert.throws(() => num.writeDecimal(Buffer.alloc(8), 4),
+                      /^Error: Invalid offset\.$/);
+        assert.throws(() => num.writeHex(Buffer.alloc(8), 5),
+                      /^Error: Invalid offset\.$/);
+        assert.throws(() => num.writeHex(Buffer.alloc(8), 0, 1.5),
+                      /'pad' must be a\(n\) integer/);
+        assert.throws(() => num.writeHex(Buffer.alloc(80), 0, 65),
+                      /Maximum padding/);
+      });
+    });
+
+    describe('serializeJSON', function() {
+      it('should match JSON.stringify', () => {
+        const arr = I64Array.from([-1, 0, 5, I64.INT64_MIN, I64.INT64_MAX]);
+        const json = I64.serializeJSON(arr);
+
+        assert(json instanceof Uint8Array);
+        assert.strictEqual(json.toString(), JSON.stringify(arr.toArray()));
+        assert.strictEqual(U64.serializeJSON(Buffer.alloc(0)).toString(),
+                           '[]');
+      });
+
+      it('should write numbers and other bases', () => {
+        const data = words(I64, [-12, 0, '9223372036854775807']);
+
+        assert.strictEqual(I64.serializeJSON(data, { base: 10, quoted: false })
+                             .toString(),
+                           '[-12,0,9223372036854775807]');
+        assert.strictEqual(U64.serializeJSON(data, { base: 10 }).toString(),
+                           '["18446744073709551604","0",'
+                           + '"9223372036854775807"]');
+        assert.strictEqual(U64.serializeJSON(data.subarray(8, 16),
+                                             { base: 'bin', pad: 4 })
+                             .toString(),
+                           '["0000"]');
+      });
+
+      it('should reject bad arguments', () => {
+        assert.throws(() => U64.serializeJSON(Buffer.alloc(9)),
+                      /Invalid buffer length/);
+        assert.throws(() => U64.serializeJSON([]),
+                      /'data' must be a\(n\) buffer/);
+        assert.throws(() => U64.serializeJSON(Buffer.alloc(8),
+                                              { quoted: false }),
+                      /Unquoted values must be decimal/);
+        assert.throws(() => U64.serializeJSON(Buffer.alloc(8), { base: 17 }),
+                      /Base ranges between 2 and 16/);
+      });
+    });
+
+    describe('parseJSON', function() {
+      it('should parse strings and numbers', () => {
+        const arr = I64.parseJSON(' [ "-0000000000000001", 255 ,"ff",-3 ]\n');
+
+        assert(arr instanceof I64Array);
+        assert.deepStrictEqual(read(arr), ['-1', '255', '255', '-3']);
+        assert.deepStrictEqual(read(U64.parseJSON('[]')), []);
+        assert.deepStrictEqual(read(U64.parseJSON(Buffer.from('["10"]'),
+                                                  { base: 10 })), ['10']);
+      });
+
+      it('should round trip', () => {
+        const values = [0, 1, -1, '-9223372036854775808',
+                        '9223372036854775807', 1e15, -77];
+        const arr = I64Array.from(values.map(v => I64.fromString(String(v))));
+
+        for (const options of [undefined, { base: 10, quoted: false },
+                               { base: 2 }, { base: 8 }]) {
+          const json = I64.serializeJSON(arr, options);
+          assert.deepStrictEqual(read(I64.parseJSON(json, options)),
+                                 read(arr));
+        }
+      });
+
+      it('should parse in chunks split anywhere', () => {
+        const json = '[ "7fffffffffffffff",-12, 0,"-00000000000000a1" ]';
+        const expect = read(I64.parseJSON(json));
+
+        for (let i = 0; i <= json.length; i++) {
+          for (let j = i; j <= json.length; j++) {
+            const p = I64.jsonParser();
+
+            p.write(json.slice(0, i));
+            p.write(Buffer.from(json.slice(i, j)));
+
+            assert.deepStrictEqual(read(p.end(json.slice(j))), expect);
+          }
+        }
+
+        // Leading zeros, wherever the chunks split.
+        for (let i = 0; i <= 6; i++) {
+          const p = I64.jsonParser();
+
+          assert.throws(() => {
+            p.write(Buffer.from('[1,-01]'.slice(0, i)));
+            p.end('[1,-01]'.slice(i));
+          }, /Invalid JSON/);
+        }
+
+        assert.deepStrictEqual(read(I64.parseJSON('[0,-0,10]')),
+                               ['0', '0', '10']);
+      });
+
+      it('should parse long arrays', () => {
+        const data = Buffer.alloc(1000 * 8);
+
+        U64.rng(1).fill(data);
+
+        const arr = U64.parseJSON(U64.serializeJSON(data));
+
+        assert(arr instanceof U64Array);
+        assert(arr.toBuffer().equals(data));
+      });
+
+      it('should reject invalid JSON', () => {
+        const bad = ['', '[', '[1', '[1,]', '[,1]', '[1 2]', '["1" "2"]',
+                     '[1.5]', '[1e3]', '["zz"]', '[true]', '{}', '[1]]',
+                     '[1] x', '["18446744073709551616"]',
+                     '[18446744073709551616]', '[0000000000000000000001]',
+                     '[01]', '[-01]', '[00]', '[1,-00]',
+                     '["10000000000000000000000000000000000000000000000000'
+                     + '000000000000000000"]', '[-]', '[""]'];
+
+        for (const json of bad)
+          assert.throws(() => U64.parseJSON(json, { base: 10 }),
+                        /Invalid JSON/, json);
+
+        const p = U64.jsonParser();
+
+        assert.throws(() => p.write('[x'), /Invalid JSON/);
+        assert.throws(() => p.write(']'), /Invalid JSON/);
+        assert.throws(() => U64.jsonParser().write(1),
+                      /'data' must be a\(n\) buffer/);
+      });
+    });
+  });
+}
+
+describe('JSON (parity)', function() {
+  it('should match between backends', () => {
+    const rng = n64.U64.rng(9);
+
+    for (const Num of ['U64', 'I64']) {
+      for (let n = 0; n < 100; n += 11) {
+        const data = Buffer.alloc(n * 8);
+
+        rng.fill(data);
+
+        for (const options of [undefined, { base: 10 },
+                               { base: 10, quoted: false },
+                               { base: 16, pad: 0 }, { base: 2, pad: 64 }]) {
+          const a = n64[Num].serializeJSON(data, options);
+          const b = native[Num].serializeJSON(data, options);
+
+          assert(Buffer.from(a).equals(b));
+          assert(n64[Num].parseJSON(b, options).toBuffer().equals(data));
+          assert(native[Num].parseJSON(a, options).toBuffer().equals(data));
+        }
+      }
+    }
+  });
+});
+
+run(n64, 'JSON (JS)');
+run(native, 'JSON (Native)');
@@ -0,0 +1,302 @@
+/* eslint-env mocha */
+/* eslint prefer-arrow-callback: "off" */
+
+'use strict';
+
+const assert = require('assert');
+const BN = require('../vendor/bn.js');
+const n64 = require('../lib/n64');
+const native = require('../lib/native');
+const {words, read} = require('./util/words');
+
+function toBN(Num, data, i) {
+  return Num.readLE(data, i * 8).toBN(BN);
+}
+
+function fits(num, bits, sign) {
+  if (sign)
+    return num.bitLength() < bits || num.eq(new BN(1).iushln(bits - 1).ineg());
+
+  return !num.isNeg() && num.bitLength() <= bits;
+}
+
+function run(n64, name) {
+  const {U64, I64} = n64;
+
+  describe(name, function() {
+    describe('dot', function() {
+      it('should compute small dot products', () => {
+        const a = words(I64, [1, -2, 3]);
+        const b = words(I64, [4, 5, -6]);
+
+        assert.strictEqual(I64.dot(a, b).toString(), '-24');
+        assert(n64.I128.isI128(I64.dot(a, b)));
+        assert(n64.U128.isU128(U64.dot(a, a)));
+        assert.strictEqual(U64.dot(Buffer.alloc(0), Buffer.alloc(0))
+                              .toString(), '0');
+      });
+
+      it('should accumulate past 64 bits', () => {
+        const max = U64.UINT64_MAX.toString();
+        const a = words(U64, [max, max]);
+        const b = words(U64, [max, 2]);
+        const r = U64.dot(a, b);
+
+        // (2^64 - 1)^2 + 2 * (2^64 - 1)
+        assert.strictEqual(r.toString(16), 'f'.repeat(32));
+        assert.throws(() => r.toU64(), /out of range/);
+        assert.strictEqual(r.tryToU64(), null);
+        assert.strictEqual(r.toObject().hi.toString(16), 'f'.repeat(16));
+        assert.strictEqual(U64.tryDot(a, a), null);
+      });
+
+      it('should return a checked int64', () => {
+        const a = words(I64, [3000000000, -3000000000]);
+        const b = words(I64, [3000000000, 2999999999]);
+
+        assert.strictEqual(I64.dot(a, b).toI64().toString(), '3000000000');
+        assert.throws(() => I64.dot(a, a).toI64(), /out of range/);
+      });
+
+      it('should handle signed extremes', () => {
+        const min = I64.INT64_MIN.toString();
+        const a = words(I64, [min, min]);
+
+        // 2 * 2^126 = 2^127 does not fit.
+        assert.strictEqual(I64.tryDot(a, a), null);
+        assert.throws(() => I64.dot(a, a), /Dot product overflow/);
+
+        // 2^126 - 2^126 does.
+        const b = words(I64, [min, I64.INT64_MAX.toString()]);
+        const c = words(I64, [min, min]);
+
+        assert.strictEqual(I64.dot(b, c).toString(),
+                           new BN(2).pow(new BN(63)).toString());
+      });
+
+      it('should stay exact through overflow and back', () => {
+        const max = U64.UINT64_MAX.toString();
+        const a = words(I64, [max, max, max, max]);
+
+        // As I64, every word is -1.
+        assert.strictEqual(I64.dot(a, a).toString(), '4');
+
+        // The running sum passes 2^127 before
+        // coming back into range.
+        const min = I64.INT64_MIN.toString();
+        const x = words(I64, [min, min, min, min, min]);
+        const y = words(I64, [min, min, min, '9223372036854775807',
+                              '9223372036854775807']);
+        const p = new BN(2).pow(new BN(126));
+
+        assert.strictEqual(I64.dot(x, y).toString(),
+                           p.muln(3).sub(p.muln(2)).iadd(new BN(2).pow(new BN(64)))
+                                                   .toString());
+      });
+
+      it('should match bn.js', () => {
+        const rng = U64.rng(1);
+
+        for (const Num of [U64, I64]) {
+          for (let n = 0; n < 64; n++) {
+            const a = Buffer.alloc(n * 8);
+            const b = Buffer.alloc(n * 8);
+
+            rng.fill(a);
+            rng.fill(b);
+
+            let sum = new BN(0);
+
+            for (let i = 0; i < n; i++)
+              sum = sum.add(toBN(Num, a, i).mul(toBN(Num, b, i)));
+
+            const r = Num.tryDot(a, b);
+
+            if (fits(sum, 128, Num.prototype === I64.prototype))
+              assert.strictEqual(r.toString(), sum.toString());
+            else
+              assert.strictEqual(r, null);
+          }
+        }
+      });
+
+      it('should reject bad arguments', () => {
+        assert.throws(() => U64.dot(Buffer.alloc(8), Buffer.alloc(16)),
+                      /Invalid range/);
+        assert.throws(() => U64.dot(Buffer.alloc(7), Buffer.alloc(7)),
+                      /Invalid buffer length/);
+        assert.throws(() => U64.dot(null, Buffer.alloc(8)), TypeError);
+      });
+    });
+
+    describe('axpy', function() {
+      it('should add a scaled vector', () => {
+        const dst = words(I64, [1, 2, 3]);
+        const x = words(I64, [10, -20, 30]);
+        const bad = I64.axpy(dst, -3, x);
+
+        assert.deepStrictEqual(read(I64, dst), ['-29', '62', '-87']);
+        assert.strictEqual(bad.length, 0);
+
+        I64.axpy(dst, I64.fromInt(2), x);
+
+        assert.deepStrictEqual(read(I64, dst), ['-9', '22', '-27']);
+      });
+
+      it('should report and wrap overflows', () => {
+        const dst = words(U64, ['1', '18446744073709551615', '0']);
+        const x = words(U64, ['9223372036854775808', '1', '0']);
+        const bad = U64.axpy(dst, 2, x);
+
+        assert.deepStrictEqual(Array.from(bad), [0, 1]);
+        assert.deepStrictEqual(read(U64, dst), ['1', '1', '0']);
+
+        const y = words(I64, [I64.INT64_MIN.toString(), '-1']);
+        const z = words(I64, ['1', '1']);
+
+        assert.deepStrictEqual(Array.from(I64.axpy(y, -1, z)), [0]);
+        assert.deepStrictEqual(read(I64, y),
+                               [I64.INT64_MAX.toString(), '-2']);
+      });
+
+      it('should handle an intermediate overflow', () => {
+        // -2^63 * -1 + -1 fits, even though
+        // the product alone does not.
+        const dst = words(I64, ['-1']);
+        const x = words(I64, [I64.INT64_MIN.toString()]);
+
+        assert.strictEqual(I64.axpy(dst, -1, x).length, 0);
+        assert.deepStrictEqual(read(I64, dst), [I64.INT64_MAX.toString()]);
+      });
+
+      it('should run in place', () => {
+        const dst = words(U64, [1, 2, 3]);
+
+        U64.axpy(dst, 4, dst);
+
+        assert.deepStrictEqual(read(U64, dst), ['5', '10', '15']);
+      });
+
+      it('should reject bad arguments', () => {
+        assert.throws(() => U64.axpy(Buffer.alloc(8), 1, Buffer.alloc(16)),
+                      /Invalid range/);
+        assert.throws(() => U64.axpy(Buffer.alloc(8), 0.5, Buffer.alloc(8)),
+                      TypeError);
+        assert.throws(() => U64.axpy(Buffer.alloc(8), null, Buffer.alloc(8)),
+                      TypeError);
+      });
+    });
+
+    describe('matvec', function() {
+      it('should multiply a matrix by a vector', () => {
+        const m = words(I64, [
+          1, 2, 3,
+          -4, 5, -6
+        ]);
+
+        const x = words(I64, [7, 8, 9]);
+        const dst = Buffer.alloc(16);
+        const bad = I64.matvec(dst, m, x);
+
+        assert.strictEqual(bad.length, 0);
+        assert.deepStrictEqual(read(I64, dst), ['50', '-42']);
+      });
+
+      it('should report rows which overflow', () => {
+        const max = I64.INT64_MAX.toString();
+        const m = words(I64, [
+          max, max,
+          max, '-' + max,
+          1, 1
+        ]);
+
+        const x = words(I64, [1, 1]);
+        const dst = Buffer.alloc(24);
+        const bad = I64.matvec(dst, m, x);
+
+        assert.deepStrictEqual(Array.from(bad), [0]);
+        assert.deepStrictEqual(read(I64, dst), ['-2', '0', '2']);
+      });
+
+      it('should match dot', () => {
+        const rng = U64.rng(2);
+        const m = Buffer.alloc(8 * 8 * 5);
+        const x = Buffer.alloc(8 * 5);
+        const dst = Buffer.alloc(8 * 8);
+
+        rng.fill(m);
+        rng.fill(x);
+
+        for (const Num of [U64, I64]) {
+          const bad = Array.from(Num.matvec(dst, m, x));
+
+          for (let i = 0; i < 8; i++) {
+            const row = m.subarray(i * 40, i * 40 + 40);
+            const r = Num.tryDot(row, x);
+            const fit = Num === U64 ? r && r.tryToU64() : r && r.tryToI64();
+
+            assert.strictEqual(bad.includes(i), !fit);
+
+            if (fit)
+              assert.strictEqual(Num.readLE(dst, i * 8).toString(),
+                                 fit.toString());
+          }
+        }
+      });
+
+      it('should handle overlapping output', () => {
+        const data = words(U64, [1, 2, 3, 4, 5, 6]);
+        const m = data.subarray(0, 32);
+        const x = data.subarray(32);
+
+        U64.matvec(data, m, x);
+
+        assert.deepStrictEqual(read(U64, data.subarray(0, 16)), ['17', '39']);
+      });
+
+      it('should reject bad arguments', () => {
+        assert.throws(() => U64.matvec(Buffer.alloc(8), Buffer.alloc(24),
+                                       Buffer.alloc(16)),
+                      /Invalid buffer length/);
+        assert.throws(() => U64.matvec(Buffer.alloc(8), Buffer.alloc(32),
+                                       Buffer.alloc(16)),
+                      /Invalid range/);
+        assert.throws(() => U64.matvec(Buffer.alloc(8), Buffer.alloc(0),
+                                       Buffer.alloc(0)),
+                      /Invalid buffer length/);
+      });
+    });
+  });
+}
+
+describe('Linear (parity)', function() {
+  it('should match between backends', () => {
+    const rng = n64.U64.rng(3);
+
+    for (const Num of ['U64', 'I64']) {
+      for (let n = 1; n < 100; n += 7) {
+        const a = Buffer.alloc(n * 8);
+        const b = Buffer.alloc(n * 8);
+
+        rng.fill(a);
+        rng.fill(b);
+
+        const x = n64[Num].tryDot(a, b);
+        const y = native[Num].tryDot(a, b);
+
+        assert.strictEqual(x && x.toString(), y && y.toString());
+
+        const d1 = Buffer.from(b);
+        const d2 = Buffer.from(b);
+        const k = n64[Num].readLE(a, 0).ishrn(n);
+
+        assert.deepStrictEqual(n64[Num].axpy(d1, k, a),
+                               native[Num].axpy(d2, k.toObject(), a));
+        assert(d1.equals(d2));
+      }
+    }
+  });
+});
+
+run(n64, 'Linear (JS)');
+run(native, 'Linear (Native)');
@@ -0,0 +1,429 @@
+/* eslint-env mocha */
+/* eslint prefer-arrow-callback: "off" */
+
+'use strict';
+
+const assert = require('assert');
+const BN = require('../vendor/bn.js');
+const n64 = require('../lib/n64');
+const native = require('../lib/native');
+const {words, read} = require('./util/words');
+
+const U64_MAX = '18446744073709551615';
+const I64_MIN = '-9223372036854775808';
+
+function root(num, k) {
+  // Checks r^k <= |num| < (r + 1)^k.
+  const r = num.abs();
+  return [r.pow(new BN(k)), r.addn(1).pow(new BN(k))];
+}
+
+function run(n64, name) {
+  const {U64, I64} = n64;
+
+  describe(name, function() {
+    describe('roots', function() {
+      it('should take square roots', () => {
+        assert.strictEqual(U64.fromInt(0).sqrt().toString(), '0');
+        assert.strictEqual(U64.fromInt(1).sqrt().toString(), '1');
+        assert.strictEqual(U64.fromInt(15).sqrt().toString(), '3');
+        assert.strictEqual(U64.fromInt(16).sqrt().toString(), '4');
+        assert.strictEqual(U64.fromString(U64_MAX).sqrt().toString(),
+                           '4294967295');
+        assert.strictEqual(U64.fromString('18446744065119617025').sqrt()
+                              .toString(), '4294967295');
+        assert.strictEqual(U64.fromString('18446744065119617024').sqrt()
+                              .toString(), '4294967294');
+        assert.strictEqual(I64.INT64_MAX.sqrt().toString(), '3037000499');
+
+        const n = U64.fromInt(99);
+
+        assert.strictEqual(n.isqrt(), n);
+        assert.strictEqual(n.toString(), '9');
+      });
+
+      it('should reject negative square roots', () => {
+        assert.throws(() => I64.fromInt(-1).sqrt(), /negative number/);
+        assert.throws(() => I64.INT64_MIN.isqrt(), /negative number/);
+        assert.strictEqual(U64.fromInt(-1).sqrt().toString(), '65535');
+      });
+
+      it('should take cube roots', () => {
+        assert.strictEqual(U64.fromInt(26).cbrt().toString(), '2');
+        assert.strictEqual(U64.fromInt(27).cbrt().toString(), '3');
+        assert.strictEqual(U64.fromString(U64_MAX).cbrt().toString(),
+                           '2642245');
+        assert.strictEqual(I64.fromInt(-28).cbrt().toString(), '-3');
+        assert.strictEqual(I64.fromString(I64_MIN).cbrt().toString(),
+                           '-2097152');
+      });
+
+      it('should match bn.js', () => {
+        const rng = U64.rng(1);
+
+        for (const Num of [U64, I64]) {
+          for (let i = 0; i < 200; i++) {
+            const n = rng.next().ishrn(i & 63);
+
+            if (Num === I64)
+              n.ineg();
+
+            const x = Num.fromString(n.toString());
+            const b = new BN(x.toString());
+            const c = x.cbrt().toBN(BN);
+            const [lo, hi] = root(c, 3);
+
+            assert(lo.lte(b.abs()) && hi.gt(b.abs()));
+            assert.strictEqual(c.isNeg(), b.isNeg() && !c.isZero());
+
+            if (x.isNeg())
+              continue;
+
+            const [slo, shi] = root(x.sqrt().toBN(BN), 2);
+
+            assert(slo.lte(b) && shi.gt(b));
+          }
+        }
+      });
+    });
+
+    describe('logarithms', function() {
+      it('should take logarithms', () => {
+        assert.strictEqual(U64.fromInt(1).log2(), 0);
+        assert.strictEqual(U64.fromInt(1023).log2(), 9);
+        assert.strictEqual(U64.fromInt(1024).log2(), 10);
+        assert.strictEqual(U64.fromString(U64_MAX).log2(), 63);
+        assert.strictEqual(I64.INT64_MAX.log2(), 62);
+
+        assert.strictEqual(U64.fromInt(1).log10(), 0);
+        assert.strictEqual(U64.fromInt(9).log10(), 0);
+        assert.strictEqual(U64.fromInt(10).log10(), 1);
+        assert.strictEqual(U64.fromString('9999999999999999999').log10(), 18);
+        assert.strictEqual(U64.fromString('10000000000000000000').log10(), 19);
+        assert.strictEqual(U64.fromString(U64_MAX).log10(), 19);
+        assert.strictEqual(I64.INT64_MAX.log10(), 18);
+      });
+
+      it('should match the decimal length', () => {
+        let n = U64.fromInt(1);
+
+        for (let i = 0; i < 20; i++) {
+          assert.strictEqual(n.log10(), i);
+
+          if (i > 0)
+            assert.strictEqual(n.subn(1).log10(), i - 1);
+
+          n = n.muln(10);
+        }
+      });
+
+      it('should reject non-positive numbers', () => {
+        assert.throws(() => U64.fromInt(0).log2(), /non-positive/);
+        assert.throws(() => I64.fromInt(-1).log10(), /non-positive/);
+      });
+    });
+
+    describe('gcd/lcm', function() {
+      it('should compute gcd', () => {
+        assert.strictEqual(U64.fromInt(0).gcd(U64.fromInt(0)).toString(), '0');
+        assert.strictEqual(U64.fromInt(0).gcd(U64.fromInt(7)).toString(), '7');
+        assert.strictEqual(U64.fromInt(48).gcd(U64.fromInt(180)).toString(),
+                           '12');
+        assert.strictEqual(I64.fromInt(-48).gcd(I64.fromInt(180)).toString(),
+                           '12');
+        assert.strictEqual(U64.fromString(U64_MAX)
+                              .gcd(U64.fromString('12297829382473034410'))
+                              .toString(), '6148914691236517205');
+        assert.strictEqual(I64.fromString(I64_MIN)
+                              .gcd(I64.fromInt(6)).toString(), '2');
+      });
+
+      it('should compute lcm', () => {
+        assert.strictEqual(U64.fromInt(4).lcm(U64.fromInt(6)).toString(), '12');
+        assert.strictEqual(I64.fromInt(-4).lcm(I64.fromInt(6)).toString(),
+                           '12');
+        assert.strictEqual(U64.fromInt(0).lcm(U64.fromInt(6)).toString(), '0');
+        assert.strictEqual(U64.fromString('4294967296')
+                              .lcm(U64.fromString('4294967295')).toString(),
+                           '18446744069414584320');
+
+        const n = U64.fromInt(3);
+
+        assert.strictEqual(n.ilcm(U64.fromInt(5)), n);
+        assert.strictEqual(n.toString(), '15');
+      });
+
+      it('should detect overflow', () => {
+        assert.throws(() => I64.fromString(I64_MIN).gcd(I64.fromInt(0)),
+                      /out of range/);
+        assert.throws(() => U64.fromString('4294967296')
+                               .lcm(U64.fromString('4294967297')),
+                      /out of range/);
+        assert.throws(() => I64.fromString('4294967296')
+                               .lcm(I64.fromString('2147483649')),
+                      /out of range/);
+        assert.strictEqual(U64.fromString('4294967296')
+                              .lcm(U64.fromString('2147483649')).toString(),
+                           '9223372041149743104');
+      });
+
+      it('should match bn.js', () => {
+        const rng = U64.rng(2);
+
+        for (let i = 0; i < 200; i++) {
+          const a = rng.next().ishrn(i & 31);
+          const b = rng.next().ishrn((i >>> 5) & 31);
+          const x = a.toBN(BN);
+          const y = b.toBN(BN);
+          const g = x.gcd(y);
+
+          assert.strictEqual(a.gcd(b).toString(), g.toString());
+
+          if (!g.isZero()) {
+            const l = x.div(g).mul(y);
+
+            if (l.bitLength() <= 64)
+              assert.strictEqual(a.lcm(b).toString(), l.toString());
+            else
+              assert.throws(() => a.lcm(b), /out of range/);
+          }
+        }
+      });
+    });
+
+    describe('powers of two', function() {
+      it('should test powers of two', () => {
+        assert.strictEqual(U64.fromInt(0).isPowerOfTwo(), false);
+        assert.strictEqual(U64.fromInt(1).isPowerOfTwo(), true);
+        assert.strictEqual(U64.fromInt(6).isPowerOfTwo(), false);
+        assert.strictEqual(U64.fromString('2147483648').isPowerOfTwo(), true);
+        assert.strictEqual(U64.fromString('4294967296').isPowerOfTwo(), true);
+        assert.strictEqual(U64.fromString('4294967297').isPowerOfTwo(), false);
+        assert.strictEqual(U64.fromString('9223372036854775808')
+                              .isPowerOfTwo(), true);
+        assert.strictEqual(I64.fromString(I64_MIN).isPowerOfTwo(), false);
+        assert.strictEqual(I64.fromInt(-2).isPowerOfTwo(), false);
+      });
+
+      it('should round up to a power of two', () => {
+        assert.strictEqual(U64.fromInt(0).nextPowerOfTwo().toString(), '1');
+        assert.strictEqual(U64.fromInt(1).nextPowerOfTwo().toString(), '1');
+        assert.strictEqual(U64.fromInt(5).nextPowerOfTwo().toString(), '8');
+        assert.strictEqual(U64.fromInt(8).nextPowerOfTwo().toString(), '8');
+        assert.strictEqual(I64.fromInt(-5).nextPowerOfTwo().toString(), '1');
+        assert.strictEqual(U64.fromString('4294967295').nextPowerOfTwo()
+                              .toString(), '4294967296');
+        assert.strictEqual(U64.fromString('9223372036854775807')
+                              .nextPowerOfTwo().toString(),
+                           '9223372036854775808');
+        assert.strictEqual(I64.fromString('4611686018427387904')
+                              .nextPowerOfTwo().toString(),
+                           '4611686018427387904');
+      });
+
+      it('should detect overflow', () => {
+        assert.throws(() => U64.fromString('9223372036854775809')
+                               .nextPowerOfTwo(), /out of range/);
+        assert.throws(() => I64.fromString('4611686018427387905')
+                               .inextPowerOfTwo(), /out of range/);
+      });
+    });
+
+    describe('divmod', function() {
+      it('should return the quotient and remainder', () => {
+        const [q, r] = I64.fromInt(-7).divmod(I64.fromInt(2));
+
+        assert.strictEqual(q.toString(), '-3');
+        assert.strictEqual(r.toString(), '-1');
+        assert(I64.isI64(q) && I64.isI64(r));
+
+        const [s, t] = U64.fromString(U64_MAX).divmodn(10);
+
+        assert.strictEqual(s.toString(), '1844674407370955161');
+        assert.strictEqual(t.toString(), '5');
+
+        const [u, v] = I64.fromString(I64_MIN).divmod(I64.fromInt(-1));
+
+        assert.strictEqual(u.toString(), I64_MIN);
+        assert.strictEqual(v.toString(), '0');
+      });
+
+      it('should match div and mod', () => {
+        const rng = U64.rng(3);
+
+        for (const Num of [U64, I64]) {
+          for (let i = 0; i < 100; i++) {
+            const a = Num.fromBits(rng.next().hi, rng.next().lo);
+            const b = Num.fromBits(rng.next().hi, rng.next().lo).ishrn(i & 63);
+
+            if (b.isZero())
+              continue;
+
+            const [q, r] = a.divmod(b);
+
+            assert.strictEqual(q.toString(), a.div(b).toString());
+            assert.strictEqual(r.toString(), a.mod(b).toString());
+          }
+        }
+      });
+
+      it('should reject division by zero', () => {
+        assert.throws(() => U64.fromInt(1).divmod(U64.fromInt(0)),
+                      /divide by zero/);
+        assert.throws(() => U64.fromInt(1).divmodn(0), /divide by zero/);
+      });
+    });
+
+    describe('batch', function() {
+      it('should map unary routines', () => {
+        const src = words(I64, [16, -1, 17, -8]);
+        const dst = Buffer.alloc(32);
+
+        assert.deepStrictEqual(Array.from(I64.math.sqrt(dst, src)), [1, 3]);
+        assert.deepStrictEqual(read(I64, dst), ['4', '0', '4', '0']);
+
+        assert.strictEqual(I64.math.cbrt(dst, src).length, 0);
+        assert.deepStrictEqual(read(I64, dst), ['2', '-1', '2', '-2']);
+
+        assert.strictEqual(I64.math.nextPowerOfTwo(dst, src).length, 0);
+        assert.deepStrictEqual(read(I64, dst), ['16', '1', '32', '1']);
+
+        const big = words(U64, [U64_MAX, 3]);
+
+        assert.deepStrictEqual(Array.from(U64.math.nextPowerOfTwo(big, big)),
+                               [0]);
+        assert.deepStrictEqual(read(U64, big), ['0', '4']);
+      });
+
+      it('should map logarithms', () => {
+        const src = words(U64, [1, 0, 1000, U64_MAX]);
+        const dst = new Int32Array(4);
+
+        assert.deepStrictEqual(Array.from(U64.math.log2(dst, src)), [1]);
+        assert.deepStrictEqual(Array.from(dst), [0, -1, 9, 63]);
+
+        assert.deepStrictEqual(Array.from(U64.math.log10(dst, src)), [1]);
+        assert.deepStrictEqual(Array.from(dst), [0, -1, 3, 19]);
+
+        // Writing into the input's own memory.
+        const data = words(U64, [8, 1024]);
+        const out = new Int32Array(data.buffer, data.byteOffset, 2);
+
+        U64.math.log2(out, data);
+
+        assert.deepStrictEqual(Array.from(out), [3, 10]);
+      });
+
+      it('should map binary routines', () => {
+        const a = words(I64, [12, I64_MIN, 0, -4]);
+        const b = words(I64, [18, 0, 5, 6]);
+        const dst = Buffer.alloc(32);
+
+        assert.deepStrictEqual(Array.from(I64.math.gcd(dst, a, b)), [1]);
+        assert.deepStrictEqual(read(I64, dst), ['6', '0', '5', '2']);
+
+        assert.strictEqual(I64.math.lcm(a, a, b).length, 0);
+        assert.deepStrictEqual(read(I64, a), ['36', '0', '0', '12']);
+      });
+
+      it('should divide in batches', () => {
+        const a = words(I64, [7, -7, 1, I64_MIN]);
+        const b = words(I64, [2, 2, 0, -1]);
+        const q = Buffer.alloc(32);
+        const r = Buffer.alloc(32);
+
+        assert.deepStrictEqual(Array.from(I64.math.divmod(q, r, a, b)), [2]);
+        assert.deepStrictEqual(read(I64, q), ['3', '-3', '0', I64_MIN]);
+        assert.deepStrictEqual(read(I64, r), ['1', '-1', '0', '0']);
+
+        // In place.
+        I64.math.divmod(a, b, a, b);
+
+        assert.deepStrictEqual(read(I64, a), ['3', '-3', '0', I64_MIN]);
+        assert.deepStrictEqual(read(I64, b), ['1', '-1', '0', '0']);
+      });
+
+      it('should handle partial overlaps', () => {
+        const data = words(U64, [4, 9, 16, 25, 36]);
+
+        U64.math.sqrt(data.subarray(0, 32), data.subarray(8));
+
+        assert.deepStrictEqual(read(U64, data), ['3', '4', '5', '6', '36']);
+      });
+
+      it('should reject bad arguments', () => {
+        assert.throws(() => U64.math.sqrt(Buffer.alloc(8), Buffer.alloc(16)),
+                      /Invalid range/);
+        assert.throws(() => U64.math.sqrt(Buffer.alloc(8), Buffer.alloc(7)),
+                      /Invalid buffer length/);
+        assert.throws(() => U64.math.log2(Buffer.alloc(8), Buffer.alloc(8)),
+                      TypeError);
+        assert.throws(() => U64.math.gcd(Buffer.alloc(16), Buffer.alloc(16),
+                                         Buffer.alloc(8)),
+                      /Invalid range/);
+
+        const q = Buffer.alloc(16);
+
+        assert.throws(() => U64.math.divmod(q, q, Buffer.alloc(16),
+                                            Buffer.alloc(16)),
+                      /Invalid range/);
+      });
+    });
+  });
+}
+
+describe('Math (parity)', function() {
+  it('should match between backends', () => {
+    const rng = n64.U64.rng(4);
+    const src = Buffer.alloc(8 * 64);
+    const div = Buffer.alloc(8 * 64);
+
+    rng.fill(src);
+    rng.fill(div);
+
+    for (let i = 0; i < 64; i++)
+      div[i * 8 + 7 - (i & 7)] = 0;
+
+    for (const Num of ['U64', 'I64']) {
+      const x = n64[Num].math;
+      const y = native[Num].math;
+
+      for (const op of ['sqrt', 'cbrt', 'nextPowerOfTwo']) {
+        const d1 = Buffer.alloc(src.length);
+        const d2 = Buffer.alloc(src.length);
+
+        assert.deepStrictEqual(x[op](d1, src), y[op](d2, src));
+        assert(d1.equals(d2));
+      }
+
+      for (const op of ['log2', 'log10']) {
+        const d1 = new Int32Array(64);
+        const d2 = new Int32Array(64);
+
+        assert.deepStrictEqual(x[op](d1, src), y[op](d2, src));
+        assert.deepStrictEqual(d1, d2);
+      }
+
+      for (const op of ['gcd', 'lcm']) {
+        const d1 = Buffer.alloc(src.length);
+        const d2 = Buffer.alloc(src.length);
+
+        assert.deepStrictEqual(x[op](d1, src, div), y[op](d2, src, div));
+        assert(d1.equals(d2));
+      }
+
+      const q1 = Buffer.alloc(src.length);
+      const r1 = Buffer.alloc(src.length);
+      const q2 = Buffer.alloc(src.length);
+      const r2 = Buffer.alloc(src.length);
+
+      assert.deepStrictEqual(x.divmod(q1, r1, src, div),
+                             y.divmod(q2, r2, src, div));
+      assert(q1.equals(q2));
+      assert(r1.equals(r2));
+    }
+  });
+});
+
+run(n64, 'Math (JS)');
+run(native, 'Math (Native)');
@@ -0,0 +1,173 @@
+/* eslint-env mocha */
+/* eslint prefer-arrow-callback: "off" */
+
+'use strict';
+
+const assert = require('assert');
+const path = require('path');
+const n64 = require('../lib/n64');
+const native = require('../lib/native');
+
+let threads = null;
+
+try {
+  threads = require('worker_threads');
+} catch (e) {
+  ;
+}
+
+function run(n64, name, other) {
+  const {U64, I64, U64Array, I64Array, serialize, deserialize} = n64;
+
+  describe(name, function() {
+    it('should serialize values', () => {
+      const a = U64.UINT64_MAX;
+      const b = I64(-2);
+
+      const x = deserialize(serialize(a));
+      const y = deserialize(serialize(b).buffer);
+
+      assert.strictEqual(serialize(a).length, 16);
+      assert(U64.isU64(x) && x.eq(a));
+      assert(I64.isI64(y) && y.eq(b));
+
+      const list = deserialize(serialize([a, b, U64(7)]));
+
+      assert.strictEqual(list.length, 3);
+      assert(U64.isU64(list[0]) && list[0].eq(a));
+      assert(I64.isI64(list[1]) && list[1].eq(b));
+      assert.strictEqual(list[2].toNumber(), 7);
+      assert.deepStrictEqual(deserialize(serialize([])), []);
+    });
+
+    it('should serialize arrays', () => {
+      const arr = I64Array.from([-1, 0, I64.INT64_MIN]);
+      const data = serialize(arr);
+      const out = deserialize(data);
+
+      assert(out instanceof I64Array);
+      assert.deepStrictEqual(out.toArray().map(String),
+                             arr.toArray().map(String));
+
+      // The result reads the message in place.
+      out.setn(0, 5);
+
+      assert.strictEqual(data[8], 5);
+
+      // Unaligned payloads are copied instead.
+      const copy = Buffer.alloc(data.length + 1);
+
+      data.forEach((ch, i) => { copy[i + 1] = ch; });
+
+      assert(deserialize(copy.subarray(1)).get(2).eq(I64.INT64_MIN));
+    });
+
+    it('should match the other backend', () => {
+      const arr = other.U64Array.from([1, 2, 3]);
+      const out = deserialize(other.serialize(arr));
+
+      assert(out instanceof U64Array);
+      assert.strictEqual(out.get(2).toNumber(), 3);
+      assert(deserialize(other.serialize(other.I64(-3))).eqn(-3));
+    });
+
+    it('should transfer and attach buffers', () => {
+      const arr = new U64Array();
+
+      for (let i = 0; i < 1000; i++)
+        arr.pushn(i);
+
+      const buffer = arr.transfer();
+
+      assert(buffer instanceof ArrayBuffer);
+      assert.strictEqual(buffer.byteLength, 8000);
+      assert.strictEqual(arr.length, 0);
+
+      arr.pushn(1);
+
+      assert.strictEqual(arr.get(0).toNumber(), 1);
+
+      const out = U64Array.fromBuffer(buffer);
+
+      assert.strictEqual(out.length, 1000);
+      assert.strictEqual(out.get(999).toNumber(), 999);
+
+      // Attached memory is shared until the array grows.
+      out.setn(0, 42);
+
+      assert.strictEqual(new Uint8Array(buffer)[0], 42);
+
+      out.pushn(1000);
+      out.setn(0, 43);
+
+      assert.strictEqual(new Uint8Array(buffer)[0], 42);
+      assert.strictEqual(out.get(1000).toNumber(), 1000);
+
+      // Shared stores are copied out.
+      const sub = out.subarray(1, 3);
+      const copy = new BigUint64Array(sub.transfer());
+
+      assert.deepStrictEqual(Array.from(copy, String), ['1', '2']);
+      assert.strictEqual(out.get(1).toNumber(), 1);
+    });
+
+    it('should post through workers', async function() {
+      if (!threads)
+        this.skip();
+
+      const arr = I64Array.from([-1, 2, -3]);
+      const buffer = arr.transfer();
+      const msg = serialize([U64(1), I64(-1)]);
+
+      const worker = new threads.Worker(`
+        const {parentPort, workerData} = require('worker_threads');
+        const {I64Array, serialize, deserialize} = require(workerData);
+
+        parentPort.once('message', ({buffer, msg}) => {
+          const arr = I64Array.fromBuffer(buffer);
+          const [a, b] = deserialize(msg);
+
+          arr.get(0).iadd(a).iadd(b);
+          arr.set(1, arr.get(1).imuln(10));
+
+          const out = serialize(arr);
+
+          parentPort.postMessage(out, [out.buffer]);
+        });
+      `, { eval: true, workerData: path.resolve(__dirname, name.includes('JS')
+        ? '../lib/n64' : '../lib/native') });
+
+      const result = new Promise((resolve, reject) => {
+        worker.once('message', resolve);
+        worker.once('error', reject);
+      });
+
+      worker.postMessage({ buffer, msg }, [buffer, msg.buffer]);
+
+      assert.strictEqual(buffer.byteLength, 0);
+
+      const out = deserialize(await result);
+
+      await worker.terminate();
+
+      assert.deepStrictEqual(out.toArray().map(String), ['-1', '20', '-3']);
+    });
+
+    it('should reject bad messages', () => {
+      assert.throws(() => serialize({}), TypeError);
+      assert.throws(() => serialize([1]), TypeError);
+      assert.throws(() => deserialize(new Uint8Array(4)), /Invalid message/);
+      assert.throws(() => deserialize(new Uint8Array(8)), /Invalid message/);
+      assert.throws(() => deserialize(serialize(U64(1)).subarray(0, 12)),
+                    /Invalid message/);
+      assert.throws(() => U64Array.fromBuffer(new ArrayBuffer(12)),
+                    /Invalid buffer length/);
+      assert.throws(() => U64Array.fromBuffer(new Uint8Array(16).subarray(4, 12)),
+                    /Unaligned offset/);
+      assert.throws(() => U64Array.fromBuffer([]), TypeError);
+    });
+  });
+}
+
+run(n64, 'Message (JS)', native);
+run(native, 'Message (Native)', n64);
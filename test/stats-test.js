@@ -0,0 +1,116 @@
+/* eslint-env mocha */
+/* eslint prefer-arrow-callback: "off" */
+
+'use strict';
+
+const assert = require('assert');
+const cp = require('child_process');
+const path = require('path');
+const n64 = require('../lib/n64');
+const native = require('../lib/native');
+
+// The native module reads its settings once at load
+// time, so enabled runs happen in a child process.
+function collect(code) {
+  const env = Object.assign({}, process.env, {
+    N64_STATS: '1',
+    N64_STATS_SAMPLE: '1'
+  });
+
+  const script = `
+    const {N64, U64, I64} = require(${JSON.stringify(
+      path.resolve(__dirname, '../lib/native'))});
+    N64.resetStats();
+    ${code}
+    process.stdout.write(JSON.stringify(N64.stats()));
+  `;
+
+  const out = cp.execFileSync(process.execPath, ['-e', script], { env });
+
+  return JSON.parse(out.toString('utf8'));
+}
+
+describe('Stats', function() {
+  this.timeout(10000);
+
+  it('should be disabled by default', function() {
+    for (const {N64} of [n64, native]) {
+      const stats = N64.stats();
+
+      if (stats.enabled)
+        this.skip();
+
+      assert.strictEqual(stats.calls, 0);
+      assert.strictEqual(stats.allocations, 0);
+      assert.deepStrictEqual(stats.methods, {});
+
+      N64.resetStats();
+    }
+  });
+
+  it('should count calls and allocations', () => {
+    const stats = collect(`
+      const a = U64(10);
+      for (let i = 0; i < 100; i++)
+        a.iaddn(1);
+      a.toString(16);
+    `);
+
+    assert.strictEqual(stats.enabled, true);
+    assert.strictEqual(stats.sampleRate, 1);
+    assert.strictEqual(stats.allocations, 1);
+    assert.strictEqual(stats.methods['U64#new'].calls, 1);
+    assert.strictEqual(stats.methods['U64#iaddn'].calls, 100);
+    assert.strictEqual(stats.methods['U64#iaddn'].samples, 100);
+    assert.strictEqual(stats.methods['U64#toString'].calls, 1);
+    assert(stats.methods['U64#iaddn'].time > 0);
+    assert(stats.methods['U64#iaddn'].mean > 0);
+    assert(stats.calls >= 102);
+  });
+
+  it('should classify throws', () => {
+    const stats = collect(`
+      const a = U64(10);
+      const attempt = fn => { try { fn(); } catch (e) {} };
+      attempt(() => a.idivn(0));
+      attempt(() => a.imodn(0));
+      attempt(() => a.n.iaddn('1'));
+      attempt(() => U64(1).ishln(63).toNumber());
+      attempt(() => a.n.fromString('z', 10));
+    `);
+
+    assert.strictEqual(stats.throws.divzero, 2);
+    assert.strictEqual(stats.throws.type, 1);
+    assert.strictEqual(stats.throws.overflow, 1);
+    assert.strictEqual(stats.throws.parse, 1);
+    assert.strictEqual(stats.throws.other, 0);
+    assert.strictEqual(stats.methods['U64#idivn'].throws, 1);
+    assert.strictEqual(stats.methods['U64#toNumber'].throws, 1);
+  });
+
+  it('should count static kernels', () => {
+    const stats = collect(`
+      const data = new Uint8Array(new SharedArrayBuffer(16));
+      const bits = Buffer.alloc(1);
+      U64.atomic.add(data, 0, 1);
+      U64.where(bits, data, 'eq', 0);
+      N64.compact(Buffer.alloc(16), data, bits);
+    `);
+
+    assert.strictEqual(stats.methods['atomic.add'].calls, 1);
+    assert.strictEqual(stats.methods['bulk.where'].calls, 1);
+    assert.strictEqual(stats.methods['bulk.compact'].calls, 1);
+  });
+
+  it('should reset', () => {
+    const stats = collect(`
+      U64(1).iaddn(1);
+      N64.resetStats();
+      U64(1).isubn(1);
+    `);
+
+    assert.strictEqual(stats.allocations, 1);
+    assert.strictEqual(stats.methods['U64#iaddn'], undefined);
+    assert.strictEqual(stats.methods['U64#isubn'].calls, 1);
+  });
+});
@@ -0,0 +1,270 @@
+/* eslint-env mocha */
+/* eslint prefer-arrow-callback: "off" */
+
+'use strict';
+
+const assert = require('assert');
+const cp = require('child_process');
+const path = require('path');
+const n64 = require('../lib/n64');
+const native = require('../lib/native');
+
+const FIELDS = [
+  { name: 'ts', type: 'i64be' },
+  { name: 'id', type: 'u64' },
+  { name: 'kind', type: 'u8' },
+  { name: 'flag', type: 'i8' },
+  { type: 'pad', size: 2 },
+  { name: 'qty', type: 'i16be' },
+  { name: 'port', type: 'u16le' },
+  { name: 'price', type: 'i32' },
+  { name: 'seq', type: 'u32be' }
+];
+
+function run(n64, name) {
+  const {U64, I64, U64Array, I64Array, Struct, struct} = n64;
+
+  describe(name, function() {
+    it('should compile a layout', () => {
+      const s = struct(FIELDS);
+
+      assert(s instanceof Struct);
+      assert.strictEqual(s.size, 32);
+
+      assert.deepStrictEqual(s.fields.map(f => [f.name, f.type, f.offset]), [
+        ['ts', 'i64be', 0],
+        ['id', 'u64le', 8],
+        ['kind', 'u8', 16],
+        ['flag', 'i8', 17],
+        ['qty', 'i16be', 20],
+        ['port', 'u16le', 22],
+        ['price', 'i32le', 24],
+        ['seq', 'u32be', 28]
+      ]);
+    });
+
+    it('should reject bad layouts', () => {
+      assert.throws(() => struct([]), /no fields/);
+      assert.throws(() => struct([{ name: 'a', type: 'i24' }]), /type/);
+      assert.throws(() => struct([{ name: 'a', type: 'f64' }]), /type/);
+      assert.throws(() => struct([{ name: '', type: 'i8' }]), TypeError);
+      assert.throws(() => struct([{ name: '__proto__', type: 'i8' }]), /name/);
+      assert.throws(() => struct([{ name: 'a', type: 'i8' },
+                                  { name: 'a', type: 'u8' }]), /name/);
+      assert.throws(() => struct([{ type: 'pad', size: -1 }]), TypeError);
+      assert.throws(() => struct({}), TypeError);
+    });
+
+    it('should decode a record', () => {
+      const s = struct(FIELDS);
+      const data = Buffer.from('00'
+        + 'fffffffffffffffe'
+        + '0100000000000080'
+        + 'ff' + '80' + '0000'
+        + 'fffe' + 'ffff'
+        + 'feffffff'
+        + '80000001', 'hex');
+
+      const r = s.decode(data, 1);
+
+      assert(I64.isI64(r.ts));
+      assert(U64.isU64(r.id));
+      assert.strictEqual(r.ts.toString(), '-2');
+      assert.strictEqual(r.id.toString(16), '8000000000000001');
+      assert.strictEqual(r.kind, 255);
+      assert.strictEqual(r.flag, -128);
+      assert.strictEqual(r.qty, -2);
+      assert.strictEqual(r.port, 0xffff);
+      assert.strictEqual(r.price, -2);
+      assert.strictEqual(r.seq, 0x80000001);
+
+      const out = Buffer.alloc(33);
+
+      s.encode(r, out, 1);
+
+      assert.strictEqual(out.toString('hex'), data.toString('hex'));
+    });
+
+    it('should decode into the same object', () => {
+      const s = struct(FIELDS);
+      const a = s.create();
+      const b = s.create();
+
+      a.ts.iaddn(-100);
+      a.id.iaddn(7);
+      a.qty = 1234;
+
+      const data = s.encode(a);
+      const {ts, id} = b;
+
+      assert.strictEqual(s.decode(data, 0, b), b);
+      assert.strictEqual(b.ts, ts);
+      assert.strictEqual(b.id, id);
+      assert.strictEqual(b.ts.toNumber(), -100);
+      assert.strictEqual(b.id.toNumber(), 7);
+      assert.strictEqual(b.qty, 1234);
+
+      // Missing wrappers are created.
+      const c = s.decode(data, 0, {});
+
+      assert(I64.isI64(c.ts));
+      assert.strictEqual(c.ts.toNumber(), -100);
+    });
+
+    it('should wrap small fields and take numbers', () => {
+      const s = struct([
+        { name: 'a', type: 'u8' },
+        { name: 'b', type: 'i16' },
+        { name: 'c', type: 'u32' },
+        { name: 'd', type: 'i64' },
+        { name: 'e', type: 'u64be' }
+      ]);
+
+      const data = s.encode({ a: 257, b: 0x18000, c: -1, d: -3, e: 2 ** 40 });
+
+      assert(data instanceof Uint8Array);
+      assert.strictEqual(Buffer.from(data).toString('hex'),
+                         '01' + '0080' + 'ffffffff'
+                         + 'fdffffffffffffff' + '0000010000000000');
+
+      const r = s.decode(data);
+
+      assert.strictEqual(r.a, 1);
+      assert.strictEqual(r.b, -32768);
+      assert.strictEqual(r.c, 0xffffffff);
+      assert.strictEqual(r.d.toNumber(), -3);
+      assert.strictEqual(r.e.toNumber(), 2 ** 40);
+    });
+
+    it('should decode many records into columns', () => {
+      const s = struct(FIELDS);
+      const count = 37;
+      const data = Buffer.alloc(3 + count * s.size);
+      const rng = U64.rng(3);
+
+      rng.fill(data);
+
+      // Padding is not kept.
+      for (let i = 0; i < count; i++)
+        data.fill(0, 3 + i * s.size + 18, 3 + i * s.size + 20);
+
+      const cols = s.decodeMany(data, 3);
+
+      assert(cols.ts instanceof I64Array);
+      assert(cols.id instanceof U64Array);
+      assert(cols.kind instanceof Uint8Array);
+      assert(cols.flag instanceof Int8Array);
+      assert(cols.qty instanceof Int16Array);
+      assert(cols.port instanceof Uint16Array);
+      assert(cols.price instanceof Int32Array);
+      assert(cols.seq instanceof Uint32Array);
+      assert.strictEqual(cols.ts.length, count);
+
+      const r = s.create();
+
+      for (let i = 0; i < count; i++) {
+        s.decode(data, 3 + i * s.size, r);
+
+        assert(cols.ts.get(i).eq(r.ts));
+        assert(cols.id.get(i).eq(r.id));
+
+        for (const key of ['kind', 'flag', 'qty', 'port', 'price', 'seq'])
+          assert.strictEqual(cols[key][i], r[key]);
+      }
+
+      const out = s.encodeMany(cols, null, 3);
+
+      assert.strictEqual(out.length, data.length);
+      assert(Buffer.from(out).subarray(3).equals(data.subarray(3)));
+
+      assert.strictEqual(s.decodeMany(data, 3, 2).ts.length, 2);
+      assert.strictEqual(s.decodeMany(data, data.length).ts.length, 0);
+    });
+
+    it('should check ranges and columns', () => {
+      const s = struct(FIELDS);
+      const data = Buffer.alloc(s.size * 2);
+      const cols = s.decodeMany(data);
+
+      assert.throws(() => s.decode(data, s.size + 1), /Invalid range/);
+      assert.throws(() => s.decode(data, -1), TypeError);
+      assert.throws(() => s.decodeMany(data, 0, 3), /Invalid range/);
+      assert.throws(() => s.encode(s.create(), data, s.size + 1),
+                    /Invalid range/);
+      assert.throws(() => s.encode({}), TypeError);
+      assert.throws(() => s.encode(Object.assign(s.create(), { ts: 0.5 })),
+                    TypeError);
+      assert.throws(() => s.encode(Object.assign(s.create(), { kind: '1' })),
+                    TypeError);
+
+      assert.throws(() => s.encodeMany(cols, Buffer.alloc(s.size)),
+                    /Invalid range/);
+
+      cols.qty = new Int32Array(2);
+      assert.throws(() => s.encodeMany(cols), TypeError);
+
+      cols.qty = new Int16Array(1);
+      assert.throws(() => s.encodeMany(cols), /Invalid columns/);
+    });
+  });
+}
+
+run(n64, 'Struct (JS)');
+run(native, 'Struct (Native)');
+
+describe('Struct (parity)', function() {
+  it('should match between backends', () => {
+    const data = Buffer.alloc(5 + 100 * 32);
+
+    n64.U64.rng(9).fill(data);
+
+    const a = n64.struct(FIELDS);
+    const b = native.struct(FIELDS);
+
+    assert.deepStrictEqual(a.fields, b.fields);
+
+    const ca = a.decodeMany(data, 5);
+    const cb = b.decodeMany(data, 5);
+
+    for (const {name, width} of a.fields) {
+      if (width === 8)
+        assert.deepStrictEqual(ca[name].toArray().map(String),
+                               cb[name].toArray().map(String));
+      else
+        assert.deepStrictEqual(ca[name], cb[name]);
+    }
+
+    const ra = a.decode(data, 37);
+    const rb = b.decode(data, 37);
+
+    assert.strictEqual(ra.ts.toString(), rb.ts.toString());
+    assert.strictEqual(ra.id.toString(), rb.id.toString());
+
+    assert.deepStrictEqual(Buffer.from(a.encode(ra)),
+                           Buffer.from(b.encode(rb)));
+
+    assert.deepStrictEqual(Buffer.from(a.encodeMany(ca)),
+                           Buffer.from(b.encodeMany(cb)));
+  });
+});
+
+describe('Struct (Native, without eval)', function() {
+  this.timeout(10000);
+
+  it('should decode and encode without code generation', () => {
+    const script = `
+      const {struct} = require(${JSON.stringify(
+        path.resolve(__dirname, '../lib/native'))});
+      const s = struct(${JSON.stringify(FIELDS)});
+      const out = s.decode(s.encode(Object.assign(s.create(), {
+        ts: -2, id: 3, flag: -4, price: 5
+      })));
+      process.stdout.write([out.ts, out.id, out.flag, out.price].join(' '));
+    `;
+
+    const out = cp.execFileSync(process.execPath,
+      ['--disallow-code-generation-from-strings', '-e', script]);
+
+    assert.strictEqual(out.toString('utf8'), '-2 3 -4 5');
+  });
+});
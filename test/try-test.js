@@ -0,0 +1,110 @@
+/* eslint-env mocha */
+/* eslint prefer-arrow-callback: "off" */
+
+'use strict';
+
+const assert = require('assert');
+const n64 = require('../lib/n64');
+const native = require('../lib/native');
+
+function run(n64, name) {
+  const {U64, I64, U64Array, I64Array} = n64;
+
+  describe(name, function() {
+    it('should try to parse strings', () => {
+      const num = U64(7);
+
+      assert.strictEqual(num.tryFromString('ffffffffffffffff', 16), true);
+      assert(num.eq(U64.UINT64_MAX));
+
+      for (const str of ['', '-', '18446744073709551616', 'x', '1z', ' 1',
+                         '+1', '0x10', '1 ', '١', '1'.repeat(100)]) {
+        assert.strictEqual(num.tryFromString(str), false, str);
+        assert.throws(() => U64.fromString(str), /Invalid string/, str);
+      }
+
+      assert.strictEqual(num.tryFromString(null), false);
+      assert.strictEqual(num.tryFromString(1), false);
+
+      // Failures leave the number untouched.
+      assert(num.eq(U64.UINT64_MAX));
+
+      assert.strictEqual(I64.tryFromString('-ff', 'hex').toNumber(), -255);
+      assert.strictEqual(I64.tryFromString('abc'), null);
+      assert.throws(() => num.tryFromString('1', 17), /Base ranges/);
+      assert.throws(() => num.tryFromString('1', 1.5), TypeError);
+    });
+
+    it('should try to convert numbers', () => {
+      const num = I64(1);
+
+      assert.strictEqual(num.tryFromNumber(-0x1fffffffffffff), true);
+      assert.strictEqual(num.tryToNumber(), -0x1fffffffffffff);
+
+      for (const val of [0.5, NaN, Infinity, 2 ** 53, '1', null, {}])
+        assert.strictEqual(num.tryFromNumber(val), false);
+
+      assert.strictEqual(num.toNumber(), -0x1fffffffffffff);
+      assert.strictEqual(U64.tryFromNumber(-1).toString(16), 'ffffffffffffffff');
+      assert.strictEqual(U64.tryFromNumber(1.5), null);
+
+      assert(Number.isNaN(U64.UINT64_MAX.tryToNumber()));
+      assert(Number.isNaN(I64.INT64_MIN.tryToNumber()));
+    });
+
+    it('should try to divide', () => {
+      const a = I64(-7);
+
+      assert.strictEqual(a.tryIdiv(I64(0)), false);
+      assert.strictEqual(a.toNumber(), -7);
+      assert.strictEqual(a.tryIdiv(I64(2)), true);
+      assert.strictEqual(a.toNumber(), -3);
+
+      assert.strictEqual(a.tryImod(I64(0)), false);
+      assert.strictEqual(a.tryImod(I64(2)), true);
+      assert.strictEqual(a.toNumber(), -1);
+
+      assert.strictEqual(U64(10).tryDiv(U64(0)), null);
+      assert.strictEqual(U64(10).tryDiv(U64(3)).toNumber(), 3);
+      assert.strictEqual(U64(10).tryMod(U64(0)), null);
+      assert.strictEqual(U64(10).tryMod(U64(3)).toNumber(), 1);
+
+      assert.throws(() => a.tryIdiv(2), TypeError);
+    });
+
+    it('should parse in batches', () => {
+      const items = ['1', 'x', -1, '-1', 2.5, null, '18446744073709551615',
+                     '18446744073709551616', 'ff'];
+
+      const {array, valid, invalid} = U64Array.parse(items);
+
+      assert(array instanceof U64Array);
+      assert.strictEqual(array.length, items.length);
+      assert.strictEqual(invalid, 5);
+      assert.deepStrictEqual(Array.from(valid), [0b01001101, 0]);
+      assert.deepStrictEqual(array.toArray().map(n => n.toString(16)), [
+        '1', '0', 'ffffffffffffffff', 'ffffffffffffffff', '0', '0',
+        'ffffffffffffffff', '0', '0'
+      ]);
+
+      const hex = I64Array.parse(['ff', '-ff', 'g'], 16);
+
+      assert.strictEqual(hex.invalid, 1);
+      assert.deepStrictEqual(hex.array.toArray().map(String), ['255', '-255', '0']);
+      assert.strictEqual(U64Array.parse([]).array.length, 0);
+
+      // Separators and non-ASCII inside of fields.
+      const odd = U64Array.parse(['1\n2', '3', '\u0663', '4']);
+
+      assert.strictEqual(odd.invalid, 2);
+      assert.deepStrictEqual(Array.from(odd.valid), [0b1010]);
+      assert.strictEqual(odd.array.get(3).toNumber(), 4);
+
+      assert.throws(() => U64Array.parse('1'), TypeError);
+      assert.throws(() => U64Array.parse(['1'], 17), /Base ranges/);
+    });
+  });
+}
+
+run(n64, 'Try (JS)');
+run(native, 'Try (Native)');
@@ -0,0 +1,36 @@
+/*!
+ * words.js - int64 buffer helpers for n64 tests.
+ * Copyright (c) 2017, Christopher Jeffrey (MIT License).
+ * https://github.com/chjj/n64
+ */
+
+'use strict';
+
+// Packs decimal strings (or numbers) into
+// little endian 64 bit words.
+function words(Num, values) {
+  const data = Buffer.alloc(values.length * 8);
+
+  for (let i = 0; i < values.length; i++)
+    Num.fromString(String(values[i])).writeLE(data, i * 8);
+
+  return data;
+}
+
+// Unpacks little endian 64 bit words
+// into decimal strings.
+function read(Num, data) {
+  const out = [];
+
+  for (let i = 0; i < data.length; i += 8)
+    out.push(Num.readLE(data, i).toString());
+
+  return out;
+}
+
+/*
+ * Expose
+ */
+
+exports.words = words;
+exports.read = read;
@@ -0,0 +1,220 @@
+/* eslint-env mocha */
+/* eslint prefer-arrow-callback: "off" */
+
+'use strict';
+
+const assert = require('assert');
+const cp = require('child_process');
+const path = require('path');
+const n64 = require('../lib/n64');
+const native = require('../lib/native');
+
+function run(n64, name, file) {
+  const {U64, I64} = n64;
+
+  describe(name, function() {
+    it('should read and write through the buffer', () => {
+      const data = Buffer.alloc(24);
+
+      U64(0x01020304, 0x05060708).writeLE(data, 8);
+
+      const view = U64.view(data, 8);
+
+      assert.strictEqual(view.toString(16), '102030405060708');
+
+      view.iaddn(1);
+
+      assert.strictEqual(data.toString('hex', 8, 16), '0907060504030201');
+
+      view.imuln(2).setn(63, 1);
+
+      assert.strictEqual(U64.readLE(data, 8).toString(16),
+                         '820406080a0c0e12');
+
+      assert.strictEqual(data.toString('hex', 0, 8), '0000000000000000');
+      assert.strictEqual(data.toString('hex', 16, 24), '0000000000000000');
+    });
+
+    it('should share a slot between views', () => {
+      const data = new ArrayBuffer(16);
+      const a = U64.view(data, 8);
+      const b = I64.view(new Uint8Array(data), 8);
+
+      a.isubn(1);
+
+      assert.strictEqual(a.toString(), '18446744073709551615');
+      assert.strictEqual(b.toString(), '-1');
+
+      b.iadd(I64(3));
+
+      assert.strictEqual(a.toString(), '2');
+      assert.strictEqual(new Float64Array(data)[0], 0);
+    });
+
+    it('should accept typed arrays and data views', () => {
+      const words = new Uint32Array([1, 2, 3, 4]);
+      const view = U64.view(words, 8);
+
+      assert.strictEqual(view.hi, 4);
+      assert.strictEqual(view.lo, 3);
+
+      view.iaddn(1);
+
+      assert.strictEqual(words[2], 4);
+
+      const dv = new DataView(words.buffer, 8);
+
+      assert.strictEqual(U64.view(dv).toString(), view.toString());
+    });
+
+    it('should seek', () => {
+      const data = Buffer.alloc(8 * 16);
+      const view = U64.view(data);
+
+      for (let i = 0; i < 16; i++)
+        view.seek(i * 8).iaddn(i * i);
+
+      for (let i = 0; i < 16; i++)
+        assert.strictEqual(data.readUInt32LE(i * 8), i * i);
+
+      assert.strictEqual(view.seek(40).toNumber(), 25);
+    });
+
+    it('should match plain objects', () => {
+      const data = Buffer.alloc(16);
+      const view = I64.view(data, 8);
+      const num = I64(0);
+
+      for (let i = 0; i < 200; i++) {
+        const b = I64.random();
+        const n = (b.lo & 0x3f) | 1;
+
+        switch (i % 8) {
+          case 0:
+            view.iadd(b);
+            num.iadd(b);
+            break;
+          case 1:
+            view.imul(b);
+            num.imul(b);
+            break;
+          case 2:
+            view.idivn(n);
+            num.idivn(n);
+            break;
+          case 3:
+            view.ixor(b);
+            num.ixor(b);
+            break;
+          case 4:
+            view.ishrn(n);
+            num.ishrn(n);
+            break;
+          case 5:
+            view.isubn(b.lo);
+            num.isubn(b.lo);
+            break;
+          case 6:
+            view.ineg();
+            num.ineg();
+            break;
+          case 7:
+            view.inject(b);
+            num.inject(b);
+            break;
+        }
+
+        assert.strictEqual(view.toString(), num.toString());
+        assert(view.eq(num));
+        assert(num.eq(view));
+      }
+
+      assert(view.toLE(Buffer).equals(data.slice(8)));
+    });
+
+    it('should keep the slot across a sign change', () => {
+      const data = new BigUint64Array(2);
+      const view = U64.view(data, 8);
+
+      view.sign = 1;
+      view.fromInt(7);
+
+      assert.strictEqual(data[1], 7n);
+      assert.strictEqual(view.sign, 1);
+
+      view.isubn(8);
+
+      assert.strictEqual(data[1], 0xffffffffffffffffn);
+      assert.strictEqual(view.toString(), '-1');
+
+      view.sign = 0;
+      view.seek(0).iaddn(2);
+
+      assert.strictEqual(data[0], 2n);
+      assert.strictEqual(view.toString(), '2');
+    });
+
+    it('should copy on clone', () => {
+      const data = Buffer.alloc(8);
+      const view = U64.view(data);
+      const copy = view.clone();
+
+      copy.iaddn(1);
+
+      assert.strictEqual(view.toNumber(), 0);
+      assert.strictEqual(copy.toNumber(), 1);
+    });
+
+    it('should reject bad offsets', () => {
+      const data = Buffer.alloc(16);
+
+      assert.throws(() => U64.view(data, 9), /Invalid offset/);
+      assert.throws(() => U64.view(data, 4), /Unaligned offset/);
+      assert.throws(() => U64.view(data, -8), TypeError);
+      assert.throws(() => U64.view(data, 1.5), TypeError);
+      assert.throws(() => U64.view([0, 0, 0, 0, 0, 0, 0, 0]), TypeError);
+      assert.throws(() => U64.view(data.slice(1), 0), /Unaligned offset/);
+      assert.throws(() => U64.view(data).seek(16), /Invalid offset/);
+      assert.throws(() => U64.view(data).seek(2), /Unaligned offset/);
+      assert.throws(() => U64(1).seek(0), /not a view/);
+    });
+
+    it('should survive a detached buffer', function() {
+      this.timeout(10000);
+
+      if (typeof structuredClone !== 'function')
+        this.skip();
+
+      // The buffers are transferred away and dropped,
+      // so their memory is gone unless the view holds
+      // it. Run with a collectable heap in a child.
+      const script = `
+        const {U64} = require(${JSON.stringify(file)});
+        const views = [];
+
+        for (let i = 0; i < 100; i++) {
+          const data = new ArrayBuffer(1 << 16);
+          const view = U64.view(data, 8).iaddn(1);
+
+          structuredClone(data, { transfer: [data] });
+          views.push(view);
+        }
+
+        gc();
+
+        for (let i = 0; i < 50; i++)
+          new Uint8Array(1 << 16).fill(0xff);
+
+        gc();
+
+        for (const view of views)
+          view.iaddn(1).toString();
+      `;
+
+      cp.execFileSync(process.execPath, ['--expose-gc', '-e', script]);
+    });
+  });
+}
+
+run(n64, 'View (JS)', path.resolve(__dirname, '../lib/n64'));
+run(native, 'View (Native)', path.resolve(__dirname, '../lib/native'));
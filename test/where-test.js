@@ -0,0 +1,268 @@
+/* eslint-env mocha */
+/* eslint prefer-arrow-callback: "off" */
+
+'use strict';
+
+const assert = require('assert');
+const n64 = require('../lib/n64');
+const native = require('../lib/native');
+const {words, read} = require('./util/words');
+
+const OPS = ['eq', 'ne', 'lt', 'lte', 'gt', 'gte', 'between', 'in'];
+
+function bitsOf(bits, count) {
+  const out = [];
+
+  for (let i = 0; i < count; i++) {
+    if (bits[i >>> 3] & (1 << (i & 7)))
+      out.push(i);
+  }
+
+  return out;
+}
+
+function select(Num, data, op, a, b) {
+  const sel = new Uint32Array(data.length >>> 3);
+  const n = Num.where(sel, data, op, a, b);
+  return Array.from(sel.subarray(0, n));
+}
+
+function run(n64, name) {
+  const {N64, U64, I64, U64Array} = n64;
+
+  describe(name, function() {
+    describe('where', function() {
+      it('should compare signed words', () => {
+        const data = words(I64, [-5, 0, 3, -1, 7, 3, '-9223372036854775808']);
+
+        assert.deepStrictEqual(select(I64, data, 'eq', 3), [2, 5]);
+        assert.deepStrictEqual(select(I64, data, 'ne', 3), [0, 1, 3, 4, 6]);
+        assert.deepStrictEqual(select(I64, data, 'lt', 0), [0, 3, 6]);
+        assert.deepStrictEqual(select(I64, data, 'lte', 0), [0, 1, 3, 6]);
+        assert.deepStrictEqual(select(I64, data, 'gt', 0), [2, 4, 5]);
+        assert.deepStrictEqual(select(I64, data, 'gte', 3), [2, 4, 5]);
+        assert.deepStrictEqual(select(I64, data, 'between', -5, 3),
+                               [0, 1, 2, 3, 5]);
+        assert.deepStrictEqual(select(I64, data, 'in', [7, -1, 8]), [3, 4]);
+      });
+
+      it('should compare unsigned words', () => {
+        const data = words(U64, ['18446744073709551615', 0, 3,
+                                 '9223372036854775808', 7]);
+
+        assert.deepStrictEqual(select(U64, data, 'lt', 4), [1, 2]);
+        assert.deepStrictEqual(select(U64, data, 'gt', 7), [0, 3]);
+        assert.deepStrictEqual(select(U64, data, 'gte',
+                                      U64.fromString('9223372036854775808')),
+                               [0, 3]);
+        // Signed order differs.
+        assert.deepStrictEqual(select(I64, data, 'lt', 0), [0, 3]);
+      });
+
+      it('should handle empty ranges', () => {
+        const data = words(I64, [-1, 0, 1]);
+
+        assert.deepStrictEqual(select(U64, data, 'lt', 0), []);
+        assert.deepStrictEqual(select(I64, data, 'lt', I64.INT64_MIN), []);
+        assert.deepStrictEqual(select(U64, data, 'gt', U64.UINT64_MAX), []);
+        assert.deepStrictEqual(select(I64, data, 'gt', I64.INT64_MAX), []);
+        assert.deepStrictEqual(select(I64, data, 'between', 1, -1), []);
+        assert.deepStrictEqual(select(I64, data, 'in', []), []);
+        assert.deepStrictEqual(select(U64, data, 'gte', 0), [0, 1, 2]);
+        assert.deepStrictEqual(select(I64, data, 'between',
+                                      I64.INT64_MIN, I64.INT64_MAX),
+                               [0, 1, 2]);
+      });
+
+      it('should write a bitmap', () => {
+        const values = [];
+
+        for (let i = 0; i < 77; i++)
+          values.push(i % 3 === 0 ? -i : i);
+
+        const data = words(I64, values);
+        const bits = Buffer.alloc(11, 0xff);
+        const n = I64.where(bits, data, 'lt', 0);
+
+        assert.strictEqual(n, 25);
+        assert.deepStrictEqual(bitsOf(bits, 80),
+                               bitsOf(bits, 77));
+        assert.strictEqual(bits[9] & 0xe0, 0);
+        assert.strictEqual(bits[10], 0xff);
+        assert.deepStrictEqual(bitsOf(bits, 77),
+                               select(I64, data, 'lt', 0));
+
+        // `ne` inverts, but still clears the tail.
+        bits.fill(0xff);
+
+        assert.strictEqual(I64.where(bits, data, 'ne', 0), 76);
+        assert.strictEqual(bits[0], 0xfe);
+        assert.strictEqual(bits[9], 0x1f);
+      });
+
+      it('should take sets from buffers', () => {
+        const data = words(U64, [1, 2, 3, 4, 5, 6]);
+        const set = U64Array.from([6, 2, 2, 9]);
+
+        assert.deepStrictEqual(select(U64, data, 'in', set), [1, 5]);
+        assert.deepStrictEqual(select(U64, data, 'in', set.toBuffer()), [1, 5]);
+        assert.deepStrictEqual(select(U64, data, 'in', [U64(4), 5]),
+                               [3, 4]);
+      });
+
+      it('should count matches', () => {
+        const data = words(I64, [-3, -2, -1, 0, 1, 2, 3]);
+
+        assert.strictEqual(I64.countWhere(data, 'gte', -1), 5);
+        assert.strictEqual(I64.countWhere(data, 'between', -2, 2), 5);
+        assert.strictEqual(I64.countWhere(data, 'in', [0, 3, 4]), 2);
+        assert.strictEqual(U64.countWhere(data, 'gte', 1), 6);
+        assert.strictEqual(U64.countWhere(Buffer.alloc(0), 'ne', 1), 0);
+      });
+
+      it('should read shared arrays and unaligned views', () => {
+        const arr = U64Array.from([10, 20, 30, 40]);
+        const data = Buffer.alloc(33);
+
+        words(U64, [10, 20, 30, 40]).copy(data, 1);
+
+        assert.strictEqual(U64.countWhere(arr, 'gt', 15), 3);
+        assert.strictEqual(U64.countWhere(data.subarray(1), 'gt', 15), 3);
+      });
+
+      it('should reject bad arguments', () => {
+        const data = words(U64, [1, 2]);
+
+        assert.throws(() => U64.where(new Uint8Array(1), data, 'like', 1),
+                      /'op' must be a\(n\) operator/);
+        assert.throws(() => U64.where([], data, 'eq', 1),
+                      /'out' must be a\(n\) selection/);
+        assert.throws(() => U64.where(new Uint32Array(1), data, 'eq', 1),
+                      /Invalid range/);
+        assert.throws(() => U64.where(new Uint8Array(0), data, 'eq', 1),
+                      /Invalid range/);
+        assert.throws(() => U64.countWhere(Buffer.alloc(9), 'eq', 1),
+                      /Invalid buffer length/);
+        assert.throws(() => U64.countWhere(data, 'eq', 0.5),
+                      /'value' must be a\(n\) integer/);
+        assert.throws(() => U64.countWhere(data, 'between', 1),
+                      /'value' must be a\(n\) int64/);
+        assert.throws(() => U64.countWhere(data, 'in', 1),
+                      /'values' must be a\(n\) array/);
+      });
+    });
+
+    describe('compact', function() {
+      it('should compact by bitmap', () => {
+        const data = words(U64, [1, 2, 3, 4, 5, 6, 7, 8, 9]);
+        const bits = Buffer.alloc(2);
+
+        U64.where(bits, data, 'gt', 4);
+
+        const dst = Buffer.alloc(5 * 8);
+
+        assert.strictEqual(N64.compact(dst, data, bits), 5);
+        assert.deepStrictEqual(read(U64, dst), ['5', '6', '7', '8', '9']);
+
+        // Bits past the word count are ignored.
+        bits[1] = 0xff;
+
+        assert.strictEqual(N64.compact(dst, data, bits), 5);
+      });
+
+      it('should compact in place', () => {
+        const data = words(I64, [-1, 2, -3, 4, -5, 6]);
+        const bits = Buffer.alloc(1);
+
+        I64.where(bits, data, 'lt', 0);
+
+        assert.strictEqual(N64.compact(data, data, bits), 3);
+        assert.deepStrictEqual(read(I64, data.subarray(0, 24)),
+                               ['-1', '-3', '-5']);
+      });
+
+      it('should gather by selection', () => {
+        const data = words(U64, [10, 20, 30, 40]);
+        const dst = Buffer.alloc(32);
+
+        assert.strictEqual(N64.compact(dst, data, new Uint32Array([3, 0, 3])),
+                           3);
+        assert.deepStrictEqual(read(U64, dst), ['40', '10', '40', '0']);
+
+        // Overlapping gathers read the old words.
+        assert.strictEqual(N64.compact(data, data,
+                                       new Uint32Array([1, 0, 3, 2])), 4);
+        assert.deepStrictEqual(read(U64, data), ['20', '10', '40', '30']);
+      });
+
+      it('should reject bad arguments', () => {
+        const data = words(U64, [1, 2]);
+
+        assert.throws(() => N64.compact(Buffer.alloc(16), data, [0]),
+                      /'selection' must be a\(n\) selection/);
+        assert.throws(() => N64.compact(Buffer.alloc(16), data,
+                                        new Uint32Array([2])),
+                      /Invalid range/);
+        assert.throws(() => N64.compact(Buffer.alloc(8), data,
+                                        new Uint32Array([0, 1])),
+                      /Invalid range/);
+        assert.throws(() => N64.compact(Buffer.alloc(8), data,
+                                        Buffer.from([3])),
+                      /Invalid range/);
+        assert.throws(() => N64.compact(Buffer.alloc(16), Buffer.alloc(9),
+                                        Buffer.alloc(2)),
+                      /Invalid buffer length/);
+      });
+    });
+  });
+}
+
+describe('Where (parity)', function() {
+  it('should match between backends', () => {
+    const rng = n64.U64.rng(4);
+
+    for (const Num of ['U64', 'I64']) {
+      for (let n = 0; n < 150; n += 13) {
+        const data = Buffer.alloc(n * 8);
+
+        rng.fill(data);
+
+        // Narrow some words so that bounds hit.
+        for (let i = 0; i < n; i += 3)
+          data[i * 8 + 7] = i & 1 ? 0xff : 0;
+
+        const pick = () => n64[Num].readLE(data, (rng.next().lo >>> 0) % n * 8);
+
+        for (const op of OPS) {
+          const a = n > 0 ? pick() : n64[Num](0);
+          const b = n > 0 ? pick() : n64[Num](1);
+          const x = op === 'in' ? [a, b, 7] : a;
+          const bits1 = Buffer.alloc((n + 7) >>> 3);
+          const bits2 = Buffer.alloc((n + 7) >>> 3);
+          const sel1 = new Uint32Array(n);
+          const sel2 = new Uint32Array(n);
+
+          const c = n64[Num].where(bits1, data, op, x, b);
+
+          assert.strictEqual(native[Num].where(bits2, data, op, x, b), c);
+          assert(bits1.equals(bits2));
+          assert.strictEqual(n64[Num].where(sel1, data, op, x, b), c);
+          assert.strictEqual(native[Num].where(sel2, data, op, x, b), c);
+          assert.deepStrictEqual(sel1, sel2);
+          assert.strictEqual(native[Num].countWhere(data, op, x, b), c);
+
+          const d1 = Buffer.alloc(c * 8);
+          const d2 = Buffer.alloc(c * 8);
+
+          n64.N64.compact(d1, data, bits1);
+          native.N64.compact(d2, data, sel2.subarray(0, c));
+
+          assert(d1.equals(d2));
+        }
+      }
+    }
+  });
+});
+
+run(n64, 'Where (JS)');
+run(native, 'Where (Native)');
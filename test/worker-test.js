@@ -0,0 +1,139 @@
+/* eslint-env mocha */
+/* eslint prefer-arrow-callback: "off" */
+
+'use strict';
+
+const assert = require('assert');
+const path = require('path');
+const native = require('../lib/native');
+
+let threads = null;
+
+try {
+  threads = require('worker_threads');
+} catch (e) {
+  ;
+}
+
+// Each worker loads the native module into its own
+// isolate and mixes every class, so that instance
+// checks would fail if templates leaked between them.
+const script = `
+  const {workerData, parentPort} = require('worker_threads');
+  const {U64, I64, U64Array, Dec64} = require(workerData.lib);
+  const js = require(workerData.js);
+  const rng = U64.rng(workerData.seed);
+  const jrng = js.U64.rng(workerData.seed);
+  const arr = new U64Array();
+  const acc = I64(0);
+  const ref = js.I64(0);
+
+  for (let i = 0; i < workerData.ops; i++) {
+    const a = rng.next();
+    const b = jrng.next();
+
+    arr.push(a);
+    acc.iadd(a.toI64()).imuln(3).ixor(arr.get(i >>> 1).toI64());
+    ref.iadd(b.toI64()).imuln(3).ixor(js.U64.fromString(
+      arr.get(i >>> 1).toString(16), 16).toI64());
+  }
+
+  const d = Dec64.fromString('1.5').mul(Dec64.fromString('2'));
+
+  parentPort.postMessage({
+    acc: acc.toString(),
+    ref: ref.toString(),
+    dec: d.toString(),
+    length: arr.length
+  });
+`;
+
+function spawn(workerData) {
+  return new Promise((resolve, reject) => {
+    const worker = new threads.Worker(script, {
+      eval: true,
+      workerData: workerData
+    });
+
+    let result = null;
+
+    worker.on('message', (msg) => {
+      result = msg;
+    });
+
+    worker.on('error', reject);
+
+    worker.on('exit', (code) => {
+      if (code !== 0)
+        reject(new Error(`Worker exited with code ${code}.`));
+      else
+        resolve(result);
+    });
+  });
+}
+
+function data(seed, ops) {
+  return {
+    lib: path.resolve(__dirname, '../lib/native'),
+    js: path.resolve(__dirname, '../lib/n64'),
+    seed: seed,
+    ops: ops
+  };
+}
+
+describe('Workers', function() {
+  this.timeout(60000);
+
+  it('should run many workers concurrently', async function() {
+    if (!threads)
+      this.skip();
+
+    const jobs = [];
+
+    for (let i = 0; i < 16; i++)
+      jobs.push(spawn(data(i, 2000)));
+
+    // Keep using the main thread's classes meanwhile.
+    const a = native.U64(1);
+
+    for (let i = 0; i < 1000; i++)
+      a.iadd(native.U64(i)).imuln(7);
+
+    const results = await Promise.all(jobs);
+
+    for (const res of results) {
+      assert.strictEqual(res.acc, res.ref);
+      assert.strictEqual(res.dec, '3.0');
+      assert.strictEqual(res.length, 2000);
+    }
+
+    assert(native.N64.isN64(a));
+    assert(a.eq(native.U64(a.toString(), 10)));
+  });
+
+  it('should survive terminated workers', async function() {
+    if (!threads)
+      this.skip();
+
+    for (let round = 0; round < 3; round++) {
+      const workers = [];
+
+      for (let i = 0; i < 8; i++) {
+        workers.push(new threads.Worker(script, {
+          eval: true,
+          workerData: data(i, 1e9)
+        }));
+      }
+
+      await new Promise(resolve => setTimeout(resolve, 50));
+      await Promise.all(workers.map(w => w.terminate()));
+    }
+
+    const results = await Promise.all([spawn(data(1, 100)), spawn(data(2, 100))]);
+
+    for (const res of results)
+      assert.strictEqual(res.acc, res.ref);
+
+    assert.strictEqual(native.U64(5).iadd(native.U64(6)).toNumber(), 11);
+  });
+});